@@ -397,6 +397,7 @@ fi
 %files tests
 %{_bindir}/fts-unit-tests
 %{_libdir}/fts-tests
+%{_libdir}/libfts_db_memory.so.*
 
 %changelog
 * Thu Oct 19 2023 Mihai Patrascoiu <mihai.patrascoiu@cern.ch> - 3.12.11
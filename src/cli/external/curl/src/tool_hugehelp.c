@@ -0,0 +1,8324 @@
+#include "tool_setup.h"
+#ifndef HAVE_LIBZ
+/*
+ * NEVER EVER edit this manually, fix the mkhelp.pl script instead!
+ */
+#ifdef USE_MANUAL
+#include "tool_hugehelp.h"
+void hugehelp(void)
+{
+   fputs(
+"                                  _   _ ____  _\n"
+"  Project                     ___| | | |  _ \\| |\n"
+"                             / __| | | | |_) | |\n"
+"                            | (__| |_| |  _ <| |___\n"
+"                             \\___|\\___/|_| \\_\\_____|\n"
+"\n"
+"NAME\n"
+"       curl - transfer a URL\n"
+"\n"
+"SYNOPSIS\n"
+"       curl [options / URLs]\n"
+"\n"
+"DESCRIPTION\n"
+"       curl  is  a tool to transfer data from or to a server, using one of the\n"
+"       supported protocols (DICT, FILE, FTP, FTPS, GOPHER, HTTP, HTTPS,  IMAP,\n"
+, stdout);
+ fputs(
+"       IMAPS,  LDAP,  LDAPS,  POP3,  POP3S,  RTMP, RTSP, SCP, SFTP, SMB, SMBS,\n"
+"       SMTP, SMTPS, TELNET and TFTP). The command is designed to work  without\n"
+"       user interaction.\n"
+"\n"
+"       curl offers a busload of useful tricks like proxy support, user authen-\n"
+"       tication, FTP upload, HTTP post, SSL connections, cookies, file  trans-\n"
+"       fer  resume,  Metalink,  and more. As you will see below, the number of\n"
+"       features will make your head spin!\n"
+"\n"
+, stdout);
+ fputs(
+"       curl is powered by  libcurl  for  all  transfer-related  features.  See\n"
+"       libcurl(3) for details.\n"
+"\n"
+"URL\n"
+"       The  URL  syntax is protocol-dependent. You'll find a detailed descrip-\n"
+"       tion in RFC 3986.\n"
+"\n"
+"       You can specify multiple URLs or parts of URLs  by  writing  part  sets\n"
+"       within braces as in:\n"
+"\n"
+"         http://site.{one,two,three}.com\n"
+"\n"
+"       or you can get sequences of alphanumeric series by using [] as in:\n"
+"\n"
+"         ftp://ftp.example.com/file[1-100].txt\n"
+"\n"
+, stdout);
+ fputs(
+"         ftp://ftp.example.com/file[001-100].txt    (with leading zeros)\n"
+"\n"
+"         ftp://ftp.example.com/file[a-z].txt\n"
+"\n"
+"       Nested  sequences  are not supported, but you can use several ones next\n"
+"       to each other:\n"
+"\n"
+"         http://example.com/archive[1996-1999]/vol[1-4]/part{a,b,c}.html\n"
+"\n"
+"       You can specify any amount of URLs on the command line.  They  will  be\n"
+"       fetched  in a sequential manner in the specified order. You can specify\n"
+, stdout);
+ fputs(
+"       command line options and URLs mixed and in any  order  on  the  command\n"
+"       line.\n"
+"\n"
+"       You  can  specify a step counter for the ranges to get every Nth number\n"
+"       or letter:\n"
+"\n"
+"         http://example.com/file[1-100:10].txt\n"
+"\n"
+"         http://example.com/file[a-z:2].txt\n"
+"\n"
+"       When using [] or {} sequences when invoked from a command line  prompt,\n"
+"       you probably have to put the full URL within double quotes to avoid the\n"
+, stdout);
+ fputs(
+"       shell from interfering with it. This also  goes  for  other  characters\n"
+"       treated special, like for example '&', '?' and '*'.\n"
+"\n"
+"       Provide  the IPv6 zone index in the URL with an escaped percentage sign\n"
+"       and the interface name. Like in\n"
+"\n"
+"         http://[fe80::3%25eth0]/\n"
+"\n"
+"       If you specify URL without protocol:// prefix,  curl  will  attempt  to\n"
+"       guess  what  protocol  you might want. It will then default to HTTP but\n"
+, stdout);
+ fputs(
+"       try other protocols based on often-used host name prefixes.  For  exam-\n"
+"       ple,  for  host names starting with \"ftp.\" curl will assume you want to\n"
+"       speak FTP.\n"
+"\n"
+"       curl will do its best to use what you pass to it as a URL.  It  is  not\n"
+"       trying  to  validate it as a syntactically correct URL by any means but\n"
+"       is instead very liberal with what it accepts.\n"
+"\n"
+"       curl will attempt to re-use connections for multiple file transfers, so\n"
+, stdout);
+ fputs(
+"       that  getting many files from the same server will not do multiple con-\n"
+"       nects / handshakes. This improves speed. Of course this is only done on\n"
+"       files  specified  on  a  single command line and cannot be used between\n"
+"       separate curl invokes.\n"
+"\n"
+"PROGRESS METER\n"
+"       curl normally displays a progress meter during  operations,  indicating\n"
+"       the  amount  of  transferred  data,  transfer speeds and estimated time\n"
+, stdout);
+ fputs(
+"       left, etc. The progress meter displays number of bytes and  the  speeds\n"
+"       are  in  bytes per second. The suffixes (k, M, G, T, P) are 1024 based.\n"
+"       For example 1k is 1024 bytes. 1M is 1048576 bytes.\n"
+"\n"
+"       curl displays this data to the terminal by default, so  if  you  invoke\n"
+"       curl  to do an operation and it is about to write data to the terminal,\n"
+"       it disables the progress meter as otherwise it would mess up the output\n"
+, stdout);
+ fputs(
+"       mixing progress meter and response data.\n"
+"\n"
+"       If you want a progress meter for HTTP POST or PUT requests, you need to\n"
+"       redirect the response output to a file, using shell redirect  (>),  -o,\n"
+"       --output or similar.\n"
+"\n"
+"       It  is not the same case for FTP upload as that operation does not spit\n"
+"       out any response data to the terminal.\n"
+"\n"
+"       If you prefer a progress  \"bar\"  instead  of  the  regular  meter,  -#,\n"
+, stdout);
+ fputs(
+"       --progress-bar  is your friend. You can also disable the progress meter\n"
+"       completely with the -s, --silent option.\n"
+"\n"
+"OPTIONS\n"
+"       Options start with one or two dashes. Many of the  options  require  an\n"
+"       additional value next to them.\n"
+"\n"
+"       The  short  \"single-dash\"  form  of the options, -d for example, may be\n"
+"       used with or without a space between it and its value, although a space\n"
+"       is a recommended separator. The long \"double-dash\" form, -d, --data for\n"
+, stdout);
+ fputs(
+"       example, requires a space between it and its value.\n"
+"\n"
+"       Short version options that don't need any additional values can be used\n"
+"       immediately  next  to  each other, like for example you can specify all\n"
+"       the options -O, -L and -v at once as -OLv.\n"
+"\n"
+"       In general, all boolean options are enabled with --option and yet again\n"
+"       disabled  with --no-option. That is, you use the exact same option name\n"
+, stdout);
+ fputs(
+"       but prefix it with \"no-\". However, in this list we mostly only list and\n"
+"       show  the --option version of them. (This concept with --no options was\n"
+"       added in 7.19.0. Previously most options were  toggled  on/off  on  re-\n"
+"       peated use of the same command line option.)\n"
+"\n"
+"       --abstract-unix-socket <path>\n"
+"              (HTTP)  Connect  through an abstract Unix domain socket, instead\n"
+"              of using the network.  Note: netstat shows the path  of  an  ab-\n"
+, stdout);
+ fputs(
+"              stract  socket  prefixed  with  '@', however the <path> argument\n"
+"              should not have this leading character.\n"
+"\n"
+"              Added in 7.53.0.\n"
+"\n"
+"       --alt-svc <file name>\n"
+"              (HTTPS) WARNING: this option is experiemental.  Do  not  use  in\n"
+"              production.\n"
+"\n"
+"              This option enables the alt-svc parser in curl. If the file name\n"
+"              points to an existing alt-svc cache file, that will be used. Af-\n"
+, stdout);
+ fputs(
+"              ter  a  completed  transfer, the cache will be saved to the file\n"
+"              name again if it has been modified.\n"
+"\n"
+"              Specify a \"\" file name (zero length) to avoid loading/saving and\n"
+"              make curl just handle the cache in memory.\n"
+"\n"
+"              If  this  option  is used several times, curl will load contents\n"
+"              from all the files but the the last one will be used for saving.\n"
+"\n"
+"              Added in 7.64.1.\n"
+"\n"
+"       --anyauth\n"
+, stdout);
+ fputs(
+"              (HTTP) Tells curl to figure out authentication method by itself,\n"
+"              and  use  the most secure one the remote site claims to support.\n"
+"              This is done by first doing a request and checking the response-\n"
+"              headers,  thus  possibly  inducing  an extra network round-trip.\n"
+"              This is  used  instead  of  setting  a  specific  authentication\n"
+"              method,  which  you  can  do with --basic, --digest, --ntlm, and\n"
+, stdout);
+ fputs(
+"              --negotiate.\n"
+"\n"
+"              Using --anyauth is not recommended if you do uploads from stdin,\n"
+"              since  it  may require data to be sent twice and then the client\n"
+"              must be able to rewind. If the need should arise when  uploading\n"
+"              from stdin, the upload operation will fail.\n"
+"\n"
+"              Used together with -u, --user.\n"
+"\n"
+"              See also --proxy-anyauth and --basic and --digest.\n"
+"\n"
+"       -a, --append\n"
+, stdout);
+ fputs(
+"              (FTP SFTP) When used in an upload, this makes curl append to the\n"
+"              target file instead  of  overwriting  it.  If  the  remote  file\n"
+"              doesn't  exist,  it will be created.  Note that this flag is ig-\n"
+"              nored by some SFTP servers (including OpenSSH).\n"
+"\n"
+"       --basic\n"
+"              (HTTP) Tells curl to use HTTP Basic authentication with the  re-\n"
+"              mote host. This is the default and this option is usually point-\n"
+, stdout);
+ fputs(
+"              less, unless you use it to override a previously set option that\n"
+"              sets  a  different  authentication method (such as --ntlm, --di-\n"
+"              gest, or --negotiate).\n"
+"\n"
+"              Used together with -u, --user.\n"
+"\n"
+"              See also --proxy-basic.\n"
+"\n"
+"       --cacert <file>\n"
+"              (TLS) Tells curl to use the specified certificate file to verify\n"
+"              the  peer.  The  file  may contain multiple CA certificates. The\n"
+, stdout);
+ fputs(
+"              certificate(s) must be in PEM format. Normally curl is built  to\n"
+"              use a default file for this, so this option is typically used to\n"
+"              alter that default file.\n"
+"\n"
+"              curl recognizes the environment variable named  'CURL_CA_BUNDLE'\n"
+"              if  it  is  set,  and uses the given path as a path to a CA cert\n"
+"              bundle. This option overrides that variable.\n"
+"\n"
+"              The windows version of curl will automatically  look  for  a  CA\n"
+, stdout);
+ fputs(
+"              certs file named 'curl-ca-bundle.crt', either in the same direc-\n"
+"              tory as curl.exe, or in the Current Working Directory, or in any\n"
+"              folder along your PATH.\n"
+"\n"
+"              If  curl  is  built  against  the  NSS  SSL library, the NSS PEM\n"
+"              PKCS#11 module (libnsspem.so) needs to be available for this op-\n"
+"              tion to work properly.\n"
+"\n"
+"              (iOS  and macOS only) If curl is built against Secure Transport,\n"
+, stdout);
+ fputs(
+"              then this option is supported for  backward  compatibility  with\n"
+"              other  SSL  engines,  but it should not be set. If the option is\n"
+"              not set, then curl will use the certificates in the  system  and\n"
+"              user  Keychain to verify the peer, which is the preferred method\n"
+"              of verifying the peer's certificate chain.\n"
+"\n"
+"              (Schannel only) This option is supported for Schannel in Windows\n"
+, stdout);
+ fputs(
+"              7  or later with libcurl 7.60 or later. This option is supported\n"
+"              for backward compatibility with other SSL engines; instead it is\n"
+"              recommended  to use Windows' store of root certificates (the de-\n"
+"              fault for Schannel).\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       --capath <dir>\n"
+"              (TLS) Tells curl to use the specified certificate  directory  to\n"
+, stdout);
+ fputs(
+"              verify  the  peer.  Multiple paths can be provided by separating\n"
+"              them with \":\" (e.g.  \"path1:path2:path3\"). The certificates must\n"
+"              be  in PEM format, and if curl is built against OpenSSL, the di-\n"
+"              rectory must have been processed using the c_rehash utility sup-\n"
+"              plied  with  OpenSSL.  Using  --capath can allow OpenSSL-powered\n"
+"              curl to make SSL-connections much more  efficiently  than  using\n"
+, stdout);
+ fputs(
+"              --cacert if the --cacert file contains many CA certificates.\n"
+"\n"
+"              If this option is set, the default capath value will be ignored,\n"
+"              and if it is used several times, the last one will be used.\n"
+"\n"
+"       --cert-status\n"
+"              (TLS) Tells curl to verify the status of the server  certificate\n"
+"              by using the Certificate Status Request (aka. OCSP stapling) TLS\n"
+"              extension.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is enabled and the server sends an invalid  (e.g.\n"
+"              expired) response, if the response suggests that the server cer-\n"
+"              tificate has been revoked, or no response at  all  is  received,\n"
+"              the verification fails.\n"
+"\n"
+"              This  is  currently  only implemented in the OpenSSL, GnuTLS and\n"
+"              NSS backends.\n"
+"\n"
+"              Added in 7.41.0.\n"
+"\n"
+"       --cert-type <type>\n"
+, stdout);
+ fputs(
+"              (TLS) Tells curl what type the provided  client  certificate  is\n"
+"              using. PEM, DER, ENG and P12 are recognized types.  If not spec-\n"
+"              ified, PEM is assumed.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              See also -E, --cert and --key and --key-type.\n"
+"\n"
+"       -E, --cert <certificate[:password]>\n"
+"              (TLS) Tells curl to use the specified  client  certificate  file\n"
+, stdout);
+ fputs(
+"              when getting a file with HTTPS, FTPS or another SSL-based proto-\n"
+"              col. The certificate must be in PKCS#12 format if  using  Secure\n"
+"              Transport,  or PEM format if using any other engine.  If the op-\n"
+"              tional password isn't specified, it will be queried for  on  the\n"
+"              terminal.  Note  that  this  option assumes a \"certificate\" file\n"
+"              that is the private key and the client certificate concatenated!\n"
+, stdout);
+ fputs(
+"              See -E, --cert and --key to specify them independently.\n"
+"\n"
+"              If  curl  is  built against the NSS SSL library then this option\n"
+"              can tell curl the nickname of the certificate to use within  the\n"
+"              NSS  database defined by the environment variable SSL_DIR (or by\n"
+"              default /etc/pki/nssdb). If the NSS  PEM  PKCS#11  module  (lib-\n"
+"              nsspem.so)  is  available  then  PEM files may be loaded. If you\n"
+, stdout);
+ fputs(
+"              want to use a file from the current directory, please precede it\n"
+"              with  \"./\"  prefix, in order to avoid confusion with a nickname.\n"
+"              If the nickname contains \":\", it needs to be preceded by \"\\\"  so\n"
+"              that  it  is not recognized as password delimiter.  If the nick-\n"
+"              name contains \"\\\", it needs to be escaped as \"\\\\\" so that it  is\n"
+"              not recognized as an escape character.\n"
+"\n"
+, stdout);
+ fputs(
+"              If  curl is built against OpenSSL library, and the engine pkcs11\n"
+"              is available, then a PKCS#11 URI (RFC 7512) can be used to spec-\n"
+"              ify  a  certificate located in a PKCS#11 device. A string begin-\n"
+"              ning with \"pkcs11:\" will be interpreted as a PKCS#11 URI.  If  a\n"
+"              PKCS#11 URI is provided, then the --engine option will be set as\n"
+"              \"pkcs11\" if none was provided and the --cert-type option will be\n"
+, stdout);
+ fputs(
+"              set as \"ENG\" if none was provided.\n"
+"\n"
+"              (iOS  and macOS only) If curl is built against Secure Transport,\n"
+"              then the certificate string can either be the name of a certifi-\n"
+"              cate/private  key in the system or user keychain, or the path to\n"
+"              a PKCS#12-encoded certificate and private key. If  you  want  to\n"
+"              use  a  file  from the current directory, please precede it with\n"
+, stdout);
+ fputs(
+"              \"./\" prefix, in order to avoid confusion with a nickname.\n"
+"\n"
+"              (Schannel only) Client certificates must be specified by a  path\n"
+"              expression  to  a  certificate  store.  (Loading PFX is not sup-\n"
+"              ported; you can import it to a store first). You can use \"<store\n"
+"              location>\\<store  name>\\<thumbprint>\"  to refer to a certificate\n"
+"              in  the  system  certificates  store,  for   example,   \"Curren-\n"
+, stdout);
+ fputs(
+"              tUser\\MY\\934a7ac6f8a5d579285a74fa61e19f23ddfe8d7a\".   Thumbprint\n"
+"              is usually a SHA-1 hex string which you can see  in  certificate\n"
+"              details.  Following  store locations are supported: CurrentUser,\n"
+"              LocalMachine, CurrentService, Services,  CurrentUserGroupPolicy,\n"
+"              LocalMachineGroupPolicy, LocalMachineEnterprise.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+, stdout);
+ fputs(
+"              See also --cert-type and --key and --key-type.\n"
+"\n"
+"       --ciphers <list of ciphers>\n"
+"              (TLS) Specifies which ciphers to use in the connection. The list\n"
+"              of ciphers must specify valid ciphers. Read  up  on  SSL  cipher\n"
+"              list details on this URL:\n"
+"\n"
+"               https://curl.haxx.se/docs/ssl-ciphers.html\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       --compressed-ssh\n"
+, stdout);
+ fputs(
+"              (SCP SFTP) Enables built-in SSH compression.  This is a request,\n"
+"              not an order; the server may or may not do it.\n"
+"\n"
+"              Added in 7.56.0.\n"
+"\n"
+"       --compressed\n"
+"              (HTTP) Request a compressed response using one of the algorithms\n"
+"              curl  supports, and save the uncompressed document.  If this op-\n"
+"              tion is used and the server sends an unsupported encoding,  curl\n"
+"              will report an error.\n"
+"\n"
+"       -K, --config <file>\n"
+"\n"
+, stdout);
+ fputs(
+"              Specify  a  text  file  to read curl arguments from. The command\n"
+"              line arguments found in the text file will be used  as  if  they\n"
+"              were provided on the command line.\n"
+"\n"
+"              Options  and their parameters must be specified on the same line\n"
+"              in the file, separated by whitespace, colon, or the equals sign.\n"
+"              Long  option  names  can  optionally be given in the config file\n"
+, stdout);
+ fputs(
+"              without the initial double dashes and if so, the colon or equals\n"
+"              characters can be used as separators. If the option is specified\n"
+"              with one or two dashes, there can be no colon or equals  charac-\n"
+"              ter between the option and its parameter.\n"
+"\n"
+"              If  the  parameter  contains whitespace (or starts with : or =),\n"
+"              the parameter must be  enclosed  within  quotes.  Within  double\n"
+, stdout);
+ fputs(
+"              quotes,  the  following  escape sequences are available: \\\\, \\\",\n"
+"              \\t, \\n, \\r and \\v. A backslash preceding any other letter is ig-\n"
+"              nored.  If the first column of a config line is a '#' character,\n"
+"              the rest of the line will be treated as a  comment.  Only  write\n"
+"              one option per physical line in the config file.\n"
+"\n"
+"              Specify  the  filename  to -K, --config as '-' to make curl read\n"
+"              the file from stdin.\n"
+"\n"
+, stdout);
+ fputs(
+"              Note that to be able to specify a URL in the  config  file,  you\n"
+"              need  to  specify  it  using the --url option, and not by simply\n"
+"              writing the URL on its own line. So, it could  look  similar  to\n"
+"              this:\n"
+"\n"
+"              url = \"https://curl.haxx.se/docs/\"\n"
+"\n"
+"              When  curl  is invoked, it (unless -q, --disable is used) checks\n"
+"              for a default config file and uses it if found. The default con-\n"
+, stdout);
+ fputs(
+"              fig file is checked for in the following places in this order:\n"
+"\n"
+"              1)  curl  tries  to find the \"home dir\": It first checks for the\n"
+"              CURL_HOME and then the HOME environment variables. Failing that,\n"
+"              it  uses getpwuid() on Unix-like systems (which returns the home\n"
+"              dir given the current user in your system). On Windows, it  then\n"
+"              checks for the APPDATA variable, or as a last resort the '%USER-\n"
+, stdout);
+ fputs(
+"              PROFILE%\\Application Data'.\n"
+"\n"
+"              2) On windows, if there is no _curlrc file in the home  dir,  it\n"
+"              checks for one in the same dir the curl executable is placed. On\n"
+"              Unix-like systems, it will simply try to load .curlrc  from  the\n"
+"              determined home dir.\n"
+"\n"
+"              # --- Example file ---\n"
+"              # this is a comment\n"
+"              url = \"example.com\"\n"
+"              output = \"curlhere.html\"\n"
+, stdout);
+ fputs(
+"              user-agent = \"superagent/1.0\"\n"
+"\n"
+"              # and fetch another URL too\n"
+"              url = \"example.com/docs/manpage.html\"\n"
+"              -O\n"
+"              referer = \"http://nowhereatall.example.com/\"\n"
+"              # --- End of example file ---\n"
+"\n"
+"              This  option  can be used multiple times to load multiple config\n"
+"              files.\n"
+"\n"
+"       --connect-timeout <seconds>\n"
+"              Maximum time in seconds that  you  allow  curl's  connection  to\n"
+, stdout);
+ fputs(
+"              take.   This  only  limits the connection phase, so if curl con-\n"
+"              nects within the given period it will continue - if not it  will\n"
+"              exit.  Since version 7.32.0, this option accepts decimal values.\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              See also -m, --max-time.\n"
+"\n"
+"       --connect-to <HOST1:PORT1:HOST2:PORT2>\n"
+"\n"
+"              For  a  request  to  the  given  HOST1:PORT1  pair,  connect  to\n"
+, stdout);
+ fputs(
+"              HOST2:PORT2 instead.  This option is suitable to direct requests\n"
+"              at a specific server, e.g. at a specific cluster node in a clus-\n"
+"              ter of servers. This option is only used to establish  the  net-\n"
+"              work  connection.  It  does NOT affect the hostname/port that is\n"
+"              used for TLS/SSL (e.g. SNI, certificate verification) or for the\n"
+"              application  protocols.  \"HOST1\"  and  \"PORT1\"  may be the empty\n"
+, stdout);
+ fputs(
+"              string, meaning \"any host/port\". \"HOST2\" and \"PORT2\" may also be\n"
+"              the   empty   string,   meaning   \"use  the  request's  original\n"
+"              host/port\".\n"
+"\n"
+"              A \"host\" specified to this option is compared as a string, so it\n"
+"              needs  to  match  the name used in request URL. It can be either\n"
+"              numerical such as \"127.0.0.1\" or the full host name such as \"ex-\n"
+"              ample.org\".\n"
+"\n"
+, stdout);
+ fputs(
+"              This option can be used many times to add many connect rules.\n"
+"\n"
+"              See also --resolve and -H, --header. Added in 7.49.0.\n"
+"\n"
+"       -C, --continue-at <offset>\n"
+"              Continue/Resume  a  previous  file transfer at the given offset.\n"
+"              The given offset is the exact  number  of  bytes  that  will  be\n"
+"              skipped,  counting  from the beginning of the source file before\n"
+"              it is transferred to the destination.  If used with uploads, the\n"
+, stdout);
+ fputs(
+"              FTP server command SIZE will not be used by curl.\n"
+"\n"
+"              Use  \"-C  -\" to tell curl to automatically find out where/how to\n"
+"              resume the transfer. It then uses the given  output/input  files\n"
+"              to figure that out.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              See also -r, --range.\n"
+"\n"
+"       -c, --cookie-jar <filename>\n"
+"              (HTTP)  Specify to which file you want curl to write all cookies\n"
+, stdout);
+ fputs(
+"              after a completed operation. Curl writes all  cookies  from  its\n"
+"              in-memory  cookie storage to the given file at the end of opera-\n"
+"              tions. If no cookies are known, no data  will  be  written.  The\n"
+"              file  will  be written using the Netscape cookie file format. If\n"
+"              you set the file name to a single dash, \"-\", the cookies will be\n"
+"              written to stdout.\n"
+"\n"
+, stdout);
+ fputs(
+"              This  command  line  option will activate the cookie engine that\n"
+"              makes curl record and use cookies. Another way to activate it is\n"
+"              to use the -b, --cookie option.\n"
+"\n"
+"              If the cookie jar can't be created or written to, the whole curl\n"
+"              operation won't fail or even report an error clearly. Using  -v,\n"
+"              --verbose  will  get  a  warning displayed, but that is the only\n"
+, stdout);
+ fputs(
+"              visible feedback you get about this possibly lethal situation.\n"
+"\n"
+"              If this option is used several times, the  last  specified  file\n"
+"              name will be used.\n"
+"\n"
+"       -b, --cookie <data|filename>\n"
+"              (HTTP) Pass the data to the HTTP server in the Cookie header. It\n"
+"              is supposedly the data previously received from the server in  a\n"
+"              \"Set-Cookie:\"   line.    The   data  should  be  in  the  format\n"
+, stdout);
+ fputs(
+"              \"NAME1=VALUE1; NAME2=VALUE2\".\n"
+"\n"
+"              If no '=' symbol is used in the argument, it is instead  treated\n"
+"              as a filename to read previously stored cookie from. This option\n"
+"              also activates the cookie engine which will make curl record in-\n"
+"              coming  cookies, which may be handy if you're using this in com-\n"
+"              bination with the -L,  --location  option  or  do  multiple  URL\n"
+, stdout);
+ fputs(
+"              transfers  on the same invoke. If the file name is exactly a mi-\n"
+"              nus (\"-\"), curl will instead the contents from stdin.\n"
+"\n"
+"              The file format of the file to read cookies from should be plain\n"
+"              HTTP  headers  (Set-Cookie style) or the Netscape/Mozilla cookie\n"
+"              file format.\n"
+"\n"
+"              The file specified with -b, --cookie is only used as  input.  No\n"
+"              cookies  will  be written to the file. To store cookies, use the\n"
+, stdout);
+ fputs(
+"              -c, --cookie-jar option.\n"
+"\n"
+"              Exercise caution if you  are  using  this  option  and  multiple\n"
+"              transfers may occur.  If you use the NAME1=VALUE1; format, or in\n"
+"              a file use the Set-Cookie format and  don't  specify  a  domain,\n"
+"              then the cookie is sent for any domain (even after redirects are\n"
+"              followed) and cannot be modified by a server-set cookie. If  the\n"
+, stdout);
+ fputs(
+"              cookie  engine is enabled and a server sets a cookie of the same\n"
+"              name then both will be sent on a future transfer to that server,\n"
+"              likely not what you intended.  To address these issues set a do-\n"
+"              main in Set-Cookie (doing that will include sub domains) or  use\n"
+"              the Netscape format.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+, stdout);
+ fputs(
+"              Users very often want to both read cookies from a file and write\n"
+"              updated cookies back to a file, so using both -b,  --cookie  and\n"
+"              -c, --cookie-jar in the same command line is common.\n"
+"\n"
+"       --create-dirs\n"
+"              When used in conjunction with the -o, --output option, curl will\n"
+"              create the necessary local directory hierarchy as  needed.  This\n"
+"              option  creates the dirs mentioned with the -o, --output option,\n"
+, stdout);
+ fputs(
+"              nothing else. If the --output file name uses no dir  or  if  the\n"
+"              dirs it mentions already exist, no dir will be created.\n"
+"\n"
+"              To  create remote directories when using FTP or SFTP, try --ftp-\n"
+"              create-dirs.\n"
+"\n"
+"       --crlf (FTP SMTP)  Convert  LF  to  CRLF  in  upload.  Useful  for  MVS\n"
+"              (OS/390).\n"
+"\n"
+"              (SMTP added in 7.40.0)\n"
+"\n"
+"       --crlfile <file>\n"
+, stdout);
+ fputs(
+"              (TLS) Provide a file using PEM format with a Certificate Revoca-\n"
+"              tion List that may specify peer certificates that are to be con-\n"
+"              sidered revoked.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.19.7.\n"
+"\n"
+"       --data-ascii <data>\n"
+"              (HTTP) This is just an alias for -d, --data.\n"
+"\n"
+"       --data-binary <data>\n"
+"              (HTTP)  This  posts data exactly as specified with no extra pro-\n"
+, stdout);
+ fputs(
+"              cessing whatsoever.\n"
+"\n"
+"              If you start the data with the letter @, the rest  should  be  a\n"
+"              filename.   Data  is  posted  in  a similar manner as -d, --data\n"
+"              does, except that newlines and carriage  returns  are  preserved\n"
+"              and conversions are never done.\n"
+"\n"
+"              Like  -d,  --data the default content-type sent to the server is\n"
+"              application/x-www-form-urlencoded. If you want the  data  to  be\n"
+, stdout);
+ fputs(
+"              treated as arbitrary binary data by the server then set the con-\n"
+"              tent-type to octet-stream: -H \"Content-Type:  application/octet-\n"
+"              stream\".\n"
+"\n"
+"              If  this  option  is  used several times, the ones following the\n"
+"              first will append data as described in -d, --data.\n"
+"\n"
+"       --data-raw <data>\n"
+"              (HTTP) This posts data similarly to -d, --data but  without  the\n"
+"              special interpretation of the @ character.\n"
+"\n"
+, stdout);
+ fputs(
+"              See also -d, --data. Added in 7.43.0.\n"
+"\n"
+"       --data-urlencode <data>\n"
+"              (HTTP)  This posts data, similar to the other -d, --data options\n"
+"              with the exception that this performs URL-encoding.\n"
+"\n"
+"              To be CGI-compliant, the <data> part should begin  with  a  name\n"
+"              followed  by a separator and a content specification. The <data>\n"
+"              part can be passed to curl using one of the following syntaxes:\n"
+"\n"
+"              content\n"
+, stdout);
+ fputs(
+"                     This will make curl URL-encode the content and pass  that\n"
+"                     on.  Just  be careful so that the content doesn't contain\n"
+"                     any = or @ symbols, as that will  then  make  the  syntax\n"
+"                     match one of the other cases below!\n"
+"\n"
+"              =content\n"
+"                     This  will make curl URL-encode the content and pass that\n"
+"                     on. The preceding = symbol is not included in the data.\n"
+"\n"
+, stdout);
+ fputs(
+"              name=content\n"
+"                     This will make curl URL-encode the content part and  pass\n"
+"                     that  on.  Note that the name part is expected to be URL-\n"
+"                     encoded already.\n"
+"\n"
+"              @filename\n"
+"                     This will make curl load data from the  given  file  (in-\n"
+"                     cluding  any  newlines), URL-encode that data and pass it\n"
+"                     on in the POST.\n"
+"\n"
+"              name@filename\n"
+, stdout);
+ fputs(
+"                     This will make curl load data from the  given  file  (in-\n"
+"                     cluding  any  newlines), URL-encode that data and pass it\n"
+"                     on in the POST. The name part  gets  an  equal  sign  ap-\n"
+"                     pended,  resulting  in name=urlencoded-file-content. Note\n"
+"                     that the name is expected to be URL-encoded already.\n"
+"       See also -d, --data and --data-raw. Added in 7.18.0.\n"
+"\n"
+"       -d, --data <data>\n"
+, stdout);
+ fputs(
+"              (HTTP) Sends the specified data in a POST request  to  the  HTTP\n"
+"              server,  in  the  same  way  that a browser does when a user has\n"
+"              filled in an HTML form and presses the submit button. This  will\n"
+"              cause curl to pass the data to the server using the content-type\n"
+"              application/x-www-form-urlencoded.  Compare to -F, --form.\n"
+"\n"
+"              --data-raw is almost the same but does not have a special inter-\n"
+, stdout);
+ fputs(
+"              pretation  of  the  @ character. To post data purely binary, you\n"
+"              should instead use the --data-binary option.  To URL-encode  the\n"
+"              value of a form field you may use --data-urlencode.\n"
+"\n"
+"              If  any of these options is used more than once on the same com-\n"
+"              mand line, the data pieces specified  will  be  merged  together\n"
+"              with  a  separating  &-symbol.  Thus,  using  '-d name=daniel -d\n"
+, stdout);
+ fputs(
+"              skill=lousy'  would  generate  a  post  chunk  that  looks  like\n"
+"              'name=daniel&skill=lousy'.\n"
+"\n"
+"              If  you  start  the data with the letter @, the rest should be a\n"
+"              file name to read the data from, or - if you want curl  to  read\n"
+"              the data from stdin. Multiple files can also be specified. Post-\n"
+"              ing data from a file named 'foobar' would thus be done with  -d,\n"
+, stdout);
+ fputs(
+"              --data  @foobar.  When  --data  is told to read from a file like\n"
+"              that, carriage returns and newlines will be stripped out. If you\n"
+"              don't  want the @ character to have a special interpretation use\n"
+"              --data-raw instead.\n"
+"\n"
+"              See also --data-binary and --data-urlencode and --data-raw. This\n"
+"              option  overrides  -F,  --form  and -I, --head and -T, --upload-\n"
+"              file.\n"
+"\n"
+"       --delegation <LEVEL>\n"
+, stdout);
+ fputs(
+"              (GSS/kerberos) Set LEVEL to tell the server what it  is  allowed\n"
+"              to delegate when it comes to user credentials.\n"
+"\n"
+"              none   Don't allow any delegation.\n"
+"\n"
+"              policy Delegates  if  and only if the OK-AS-DELEGATE flag is set\n"
+"                     in the Kerberos service ticket,  which  is  a  matter  of\n"
+"                     realm policy.\n"
+"\n"
+"              always Unconditionally allow the server to delegate.\n"
+"\n"
+"       --digest\n"
+, stdout);
+ fputs(
+"              (HTTP)  Enables HTTP Digest authentication. This is an authenti-\n"
+"              cation scheme that prevents the password from  being  sent  over\n"
+"              the  wire in clear text. Use this in combination with the normal\n"
+"              -u, --user option to set user name and password.\n"
+"\n"
+"              If this option is used several times,  only  the  first  one  is\n"
+"              used.\n"
+"\n"
+"              See  also  -u, --user and --proxy-digest and --anyauth. This op-\n"
+, stdout);
+ fputs(
+"              tion overrides --basic and --ntlm and --negotiate.\n"
+"\n"
+"       --disable-eprt\n"
+"              (FTP) Tell curl to disable the use of the EPRT and LPRT commands\n"
+"              when doing active FTP transfers. Curl will normally always first\n"
+"              attempt to use EPRT, then LPRT before using PORT, but with  this\n"
+"              option,  it  will  use PORT right away. EPRT and LPRT are exten-\n"
+"              sions to the original FTP protocol, and  may  not  work  on  all\n"
+, stdout);
+ fputs(
+"              servers, but they enable more functionality in a better way than\n"
+"              the traditional PORT command.\n"
+"\n"
+"              --eprt can be used to explicitly enable EPRT again and --no-eprt\n"
+"              is an alias for --disable-eprt.\n"
+"\n"
+"              If  the  server is accessed using IPv6, this option will have no\n"
+"              effect as EPRT is necessary then.\n"
+"\n"
+"              Disabling EPRT only changes the active behavior. If you want  to\n"
+, stdout);
+ fputs(
+"              switch  to  passive  mode  you need to not use -P, --ftp-port or\n"
+"              force it with --ftp-pasv.\n"
+"\n"
+"       --disable-epsv\n"
+"              (FTP) (FTP) Tell curl to disable the use  of  the  EPSV  command\n"
+"              when  doing  passive  FTP  transfers.  Curl will normally always\n"
+"              first attempt to use EPSV before PASV, but with this option,  it\n"
+"              will not try using EPSV.\n"
+"\n"
+"              --epsv can be used to explicitly enable EPSV again and --no-epsv\n"
+, stdout);
+ fputs(
+"              is an alias for --disable-epsv.\n"
+"\n"
+"              If the server is an IPv6 host, this option will have  no  effect\n"
+"              as EPSV is necessary then.\n"
+"\n"
+"              Disabling EPSV only changes the passive behavior. If you want to\n"
+"              switch to active mode you need to use -P, --ftp-port.\n"
+"\n"
+"       -q, --disable\n"
+"              If used as the first parameter on the command line,  the  curlrc\n"
+"              config  file will not be read and used. See the -K, --config for\n"
+, stdout);
+ fputs(
+"              details on the default config file search path.\n"
+"\n"
+"       --disallow-username-in-url\n"
+"              (HTTP) This tells curl to exit if  passed  a  url  containing  a\n"
+"              username.\n"
+"\n"
+"              See also --proto. Added in 7.61.0.\n"
+"\n"
+"       --dns-interface <interface>\n"
+"              (DNS)  Tell  curl  to send outgoing DNS requests through <inter-\n"
+"              face>. This option is a counterpart to --interface  (which  does\n"
+, stdout);
+ fputs(
+"              not  affect  DNS). The supplied string must be an interface name\n"
+"              (not an address).\n"
+"\n"
+"              See also --dns-ipv4-addr  and  --dns-ipv6-addr.  --dns-interface\n"
+"              requires  that  the  underlying  libcurl was built to support c-\n"
+"              ares. Added in 7.33.0.\n"
+"\n"
+"       --dns-ipv4-addr <address>\n"
+"              (DNS) Tell curl to bind to <ip-address> when making IPv4 DNS re-\n"
+"              quests,  so  that  the DNS requests originate from this address.\n"
+, stdout);
+ fputs(
+"              The argument should be a single IPv4 address.\n"
+"\n"
+"              See also --dns-interface  and  --dns-ipv6-addr.  --dns-ipv4-addr\n"
+"              requires  that  the  underlying  libcurl was built to support c-\n"
+"              ares. Added in 7.33.0.\n"
+"\n"
+"       --dns-ipv6-addr <address>\n"
+"              (DNS) Tell curl to bind to <ip-address> when making IPv6 DNS re-\n"
+"              quests,  so  that  the DNS requests originate from this address.\n"
+, stdout);
+ fputs(
+"              The argument should be a single IPv6 address.\n"
+"\n"
+"              See also --dns-interface  and  --dns-ipv4-addr.  --dns-ipv6-addr\n"
+"              requires  that  the  underlying  libcurl was built to support c-\n"
+"              ares. Added in 7.33.0.\n"
+"\n"
+"       --dns-servers <addresses>\n"
+"              Set the list of DNS servers to be used instead of the system de-\n"
+"              fault.   The  list of IP addresses should be separated with com-\n"
+, stdout);
+ fputs(
+"              mas. Port numbers may also optionally be given as :<port-number>\n"
+"              after each IP address.\n"
+"\n"
+"              --dns-servers  requires that the underlying libcurl was built to\n"
+"              support c-ares. Added in 7.33.0.\n"
+"\n"
+"       --doh-url <URL>\n"
+"              (all) Specifies which DNS-over-HTTPS (DOH) server to use to  re-\n"
+"              solve  hostnames,  instead  of  using  the default name resolver\n"
+"              mechanism. The URL must be HTTPS.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.62.0.\n"
+"\n"
+"       -D, --dump-header <filename>\n"
+"              (HTTP FTP) Write the received protocol headers to the  specified\n"
+"              file.\n"
+"\n"
+"              This  option  is handy to use when you want to store the headers\n"
+"              that an HTTP site sends to you. Cookies from the  headers  could\n"
+"              then  be  read  in  a  second  curl  invocation by using the -b,\n"
+, stdout);
+ fputs(
+"              --cookie option! The -c, --cookie-jar option is a better way  to\n"
+"              store cookies.\n"
+"\n"
+"              If  no  headers are received, the use of this option will create\n"
+"              an empty file.\n"
+"\n"
+"              When used in FTP, the FTP server response lines  are  considered\n"
+"              being \"headers\" and thus are saved there.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              See also -o, --output.\n"
+"\n"
+"       --egd-file <file>\n"
+, stdout);
+ fputs(
+"              (TLS)  Specify  the  path  name  to the Entropy Gathering Daemon\n"
+"              socket. The socket is used to seed the  random  engine  for  SSL\n"
+"              connections.\n"
+"\n"
+"              See also --random-file.\n"
+"\n"
+"       --engine <name>\n"
+"              (TLS)  Select the OpenSSL crypto engine to use for cipher opera-\n"
+"              tions. Use --engine list to print a list of build-time supported\n"
+"              engines.  Note  that  not  all  (or  none) of the engines may be\n"
+, stdout);
+ fputs(
+"              available at run-time.\n"
+"\n"
+"       --expect100-timeout <seconds>\n"
+"              (HTTP) Maximum time in seconds that you allow curl to wait for a\n"
+"              100-continue  response  when curl emits an Expects: 100-continue\n"
+"              header in its request. By default curl  will  wait  one  second.\n"
+"              This  option accepts decimal values! When curl stops waiting, it\n"
+"              will continue as if the response has been received.\n"
+"\n"
+, stdout);
+ fputs(
+"              See also --connect-timeout. Added in 7.47.0.\n"
+"\n"
+"       --fail-early\n"
+"              Fail and exit on the first detected transfer error.\n"
+"\n"
+"              When curl is used to do multiple transfers on the command  line,\n"
+"              it will attempt to operate on each given URL, one by one. By de-\n"
+"              fault, it will ignore errors if there are more  URLs  given  and\n"
+"              the  last  URL's  success will determine the error code curl re-\n"
+, stdout);
+ fputs(
+"              turns. So early failures will be \"hidden\" by subsequent success-\n"
+"              ful transfers.\n"
+"\n"
+"              Using  this  option,  curl  will  instead return an error on the\n"
+"              first transfer that fails, independent of  the  amount  of  URLs\n"
+"              that  are given on the command line. This way, no transfer fail-\n"
+"              ures go undetected by scripts and similar.\n"
+"\n"
+"              This option is global and does not need to be specified for each\n"
+, stdout);
+ fputs(
+"              use of -:, --next.\n"
+"\n"
+"              This option does not imply -f, --fail, which causes transfers to\n"
+"              fail due to the server's HTTP status code. You can  combine  the\n"
+"              two options, however note -f, --fail is not global and is there-\n"
+"              fore contained by -:, --next.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       -f, --fail\n"
+"              (HTTP) Fail silently (no output at all) on server  errors.  This\n"
+, stdout);
+ fputs(
+"              is  mostly done to better enable scripts etc to better deal with\n"
+"              failed attempts. In normal cases when an HTTP  server  fails  to\n"
+"              deliver  a  document,  it  returns  an  HTML document stating so\n"
+"              (which often also describes why and more). This flag  will  pre-\n"
+"              vent curl from outputting that and return error 22.\n"
+"\n"
+"              This  method is not fail-safe and there are occasions where non-\n"
+, stdout);
+ fputs(
+"              successful response codes will slip through, especially when au-\n"
+"              thentication is involved (response codes 401 and 407).\n"
+"\n"
+"       --false-start\n"
+"              (TLS)  Tells  curl  to use false start during the TLS handshake.\n"
+"              False start is a mode where a TLS client will start sending  ap-\n"
+"              plication  data  before verifying the server's Finished message,\n"
+"              thus saving a round trip when performing a full handshake.\n"
+"\n"
+, stdout);
+ fputs(
+"              This is currently only implemented in the NSS and Secure  Trans-\n"
+"              port (on iOS 7.0 or later, or OS X 10.9 or later) backends.\n"
+"\n"
+"              Added in 7.42.0.\n"
+"\n"
+"       --form-string <name=string>\n"
+"              (HTTP  SMTP  IMAP)  Similar  to -F, --form except that the value\n"
+"              string for the named parameter is used  literally.  Leading  '@'\n"
+"              and '<' characters, and the ';type=' string in the value have no\n"
+, stdout);
+ fputs(
+"              special meaning. Use this in preference to -F, --form if there's\n"
+"              any  possibility  that the string value may accidentally trigger\n"
+"              the '@' or '<' features of -F, --form.\n"
+"\n"
+"              See also -F, --form.\n"
+"\n"
+"       -F, --form <name=content>\n"
+"              (HTTP SMTP IMAP) For HTTP protocol family, this lets  curl  emu-\n"
+"              late  a  filled-in  form  in which a user has pressed the submit\n"
+, stdout);
+ fputs(
+"              button. This causes curl to POST  data  using  the  Content-Type\n"
+"              multipart/form-data according to RFC 2388.\n"
+"\n"
+"              For  SMTP and IMAP protocols, this is the mean to compose a mul-\n"
+"              tipart mail message to transmit.\n"
+"\n"
+"              This enables uploading of binary files etc. To force  the  'con-\n"
+"              tent' part to be a file, prefix the file name with an @ sign. To\n"
+, stdout);
+ fputs(
+"              just get the content part from a file, prefix the file name with\n"
+"              the  symbol  <.  The  difference  between @ and < is then that @\n"
+"              makes a file get attached in the post as a  file  upload,  while\n"
+"              the < makes a text field and just get the contents for that text\n"
+"              field from a file.\n"
+"\n"
+"              Tell curl to read content from stdin instead of a file by  using\n"
+, stdout);
+ fputs(
+"              - as filename. This goes for both @ and < constructs. When stdin\n"
+"              is used, the contents is buffered in memory first by curl to de-\n"
+"              termine its size and allow a possible resend.  Defining a part's\n"
+"              data from a named non-regular file (such as a named pipe or sim-\n"
+"              ilar)  is unfortunately not subject to buffering and will be ef-\n"
+"              fectively read at transmission time; since the full size is  un-\n"
+, stdout);
+ fputs(
+"              known before the transfer starts, such data is sent as chunks by\n"
+"              HTTP and rejected by IMAP.\n"
+"\n"
+"              Example: send an image to an HTTP server, where 'profile' is the\n"
+"              name  of  the  form-field to which the file portrait.jpg will be\n"
+"              the input:\n"
+"\n"
+"               curl -F profile=@portrait.jpg https://example.com/upload.cgi\n"
+"\n"
+"              Example: send a your name and shoe size in two  text  fields  to\n"
+"              the server:\n"
+"\n"
+, stdout);
+ fputs(
+"               curl -F name=John -F shoesize=11 https://example.com/\n"
+"\n"
+"              Example:  send  a your essay in a text field to the server. Send\n"
+"              it as a plain text field, but get the contents for it from a lo-\n"
+"              cal file:\n"
+"\n"
+"               curl -F \"story=<hugefile.txt\" https://example.com/\n"
+"\n"
+"              You  can  also  tell  curl  what  Content-Type  to  use by using\n"
+"              'type=', in a manner similar to:\n"
+"\n"
+, stdout);
+ fputs(
+"               curl -F \"web=@index.html;type=text/html\" example.com\n"
+"\n"
+"              or\n"
+"\n"
+"               curl -F \"name=daniel;type=text/foo\" example.com\n"
+"\n"
+"              You can also explicitly change the name field of a  file  upload\n"
+"              part by setting filename=, like this:\n"
+"\n"
+"               curl -F \"file=@localfile;filename=nameinpost\" example.com\n"
+"\n"
+"              If  filename/path contains ',' or ';', it must be quoted by dou-\n"
+"              ble-quotes like:\n"
+"\n"
+, stdout);
+ fputs(
+"               curl  -F  \"file=@\\\"localfile\\\";filename=\\\"nameinpost\\\"\"   exam-\n"
+"              ple.com\n"
+"\n"
+"              or\n"
+"\n"
+"               curl -F 'file=@\"localfile\";filename=\"nameinpost\"' example.com\n"
+"\n"
+"              Note  that  if  a  filename/path is quoted by double-quotes, any\n"
+"              double-quote or backslash within the filename must be escaped by\n"
+"              backslash.\n"
+"\n"
+"              Quoting  must  also  be  applied to non-file data if it contains\n"
+, stdout);
+ fputs(
+"              semicolons, leading/trailing spaces or leading double quotes:\n"
+"\n"
+"               curl -F  'colors=\"red;  green;  blue\";type=text/x-myapp'  exam-\n"
+"              ple.com\n"
+"\n"
+"              You  can  add  custom  headers to the field by setting headers=,\n"
+"              like\n"
+"\n"
+"                curl -F \"submit=OK;headers=\\\"X-submit-type: OK\\\"\" example.com\n"
+"\n"
+"              or\n"
+"\n"
+"                curl -F \"submit=OK;headers=@headerfile\" example.com\n"
+"\n"
+, stdout);
+ fputs(
+"              The headers= keyword may appear more that once and  above  notes\n"
+"              about  quoting  apply.  When headers are read from a file, Empty\n"
+"              lines and lines starting with '#' are comments and ignored; each\n"
+"              header can be folded by splitting between two words and starting\n"
+"              the continuation line with a  space;  embedded  carriage-returns\n"
+"              and  trailing  spaces  are  stripped.   Here  is an example of a\n"
+, stdout);
+ fputs(
+"              header file contents:\n"
+"\n"
+"                # This file contain two headers.\n"
+"                X-header-1: this is a header\n"
+"\n"
+"                # The following header is folded.\n"
+"                X-header-2: this is\n"
+"                 another header\n"
+"\n"
+"              To support sending multipart mail messages, the  syntax  is  ex-\n"
+"              tended as follows:\n"
+"              -  name can be omitted: the equal sign is the first character of\n"
+"              the argument,\n"
+, stdout);
+ fputs(
+"              - if data starts with '(', this signals to start  a  new  multi-\n"
+"              part: it can be followed by a content type specification.\n"
+"              - a multipart can be terminated with a '=)' argument.\n"
+"\n"
+"              Example:  the  following  command sends an SMTP mime e-mail con-\n"
+"              sisting in an inline part in two alternative formats: plain text\n"
+"              and HTML. It attaches a text file:\n"
+"\n"
+"               curl -F '=(;type=multipart/alternative' \\\n"
+, stdout);
+ fputs(
+"                       -F '=plain text message' \\\n"
+"                       -F '= <body>HTML message</body>;type=text/html' \\\n"
+"                    -F '=)' -F '=@textfile.txt' ...  smtp://example.com\n"
+"\n"
+"              Data  can  be encoded for transfer using encoder=. Available en-\n"
+"              codings are binary and 8bit that do nothing else than adding the\n"
+"              corresponding  Content-Transfer-Encoding  header, 7bit that only\n"
+, stdout);
+ fputs(
+"              rejects 8-bit characters with a transfer error, quoted-printable\n"
+"              and  base64  that  encodes  data  according to the corresponding\n"
+"              schemes, limiting lines length to 76 characters.\n"
+"\n"
+"              Example: send multipart mail with a quoted-printable  text  mes-\n"
+"              sage and a base64 attached file:\n"
+"\n"
+"               curl -F '=text message;encoder=quoted-printable' \\\n"
+"                    -F '=@localfile;encoder=base64' ... smtp://example.com\n"
+"\n"
+, stdout);
+ fputs(
+"              See further examples and details in the MANUAL.\n"
+"\n"
+"              This option can be used multiple times.\n"
+"\n"
+"              This  option  overrides  -d, --data and -I, --head and -T, --up-\n"
+"              load-file.\n"
+"\n"
+"       --ftp-account <data>\n"
+"              (FTP) When an FTP server asks for \"account data\" after user name\n"
+"              and  password has been provided, this data is sent off using the\n"
+"              ACCT command.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.13.0.\n"
+"\n"
+"       --ftp-alternative-to-user <command>\n"
+"              (FTP) If authenticating with the USER and PASS  commands  fails,\n"
+"              send  this  command.   When  connecting  to  Tumbleweed's Secure\n"
+"              Transport server over FTPS using  a  client  certificate,  using\n"
+"              \"SITE  AUTH\"  will tell the server to retrieve the username from\n"
+, stdout);
+ fputs(
+"              the certificate.\n"
+"              Added in 7.15.5.\n"
+"\n"
+"       --ftp-create-dirs\n"
+"              (FTP SFTP) When an FTP or SFTP URL/operation uses  a  path  that\n"
+"              doesn't  currently exist on the server, the standard behavior of\n"
+"              curl is to fail. Using this option, curl will instead attempt to\n"
+"              create missing directories.\n"
+"\n"
+"              See also --create-dirs.\n"
+"\n"
+"       --ftp-method <method>\n"
+, stdout);
+ fputs(
+"              (FTP)  Control what method curl should use to reach a file on an\n"
+"              FTP(S) server. The method argument should be one of the  follow-\n"
+"              ing alternatives:\n"
+"\n"
+"              multicwd\n"
+"                     curl  does  a  single CWD operation for each path part in\n"
+"                     the given URL. For deep hierarchies this means very  many\n"
+"                     commands.  This  is  how RFC 1738 says it should be done.\n"
+, stdout);
+ fputs(
+"                     This is the default but the slowest behavior.\n"
+"\n"
+"              nocwd  curl does no CWD at all. curl will do  SIZE,  RETR,  STOR\n"
+"                     etc and give a full path to the server for all these com-\n"
+"                     mands. This is the fastest behavior.\n"
+"\n"
+"              singlecwd\n"
+"                     curl does one CWD with the full target directory and then\n"
+"                     operates  on  the  file  \"normally\" (like in the multicwd\n"
+, stdout);
+ fputs(
+"                     case). This is somewhat  more  standards  compliant  than\n"
+"                     'nocwd' but without the full penalty of 'multicwd'.\n"
+"\n"
+"       Added in 7.15.1.\n"
+"\n"
+"       --ftp-pasv\n"
+"              (FTP)  Use  passive mode for the data connection. Passive is the\n"
+"              internal default behavior, but using this option can be used  to\n"
+"              override a previous -P, --ftp-port option.\n"
+"\n"
+"              If  this  option  is  used  several times, only the first one is\n"
+, stdout);
+ fputs(
+"              used. Undoing an enforced passive really isn't  doable  but  you\n"
+"              must then instead enforce the correct -P, --ftp-port again.\n"
+"\n"
+"              Passive mode means that curl will try the EPSV command first and\n"
+"              then PASV, unless --disable-epsv is used.\n"
+"              See also --disable-epsv. Added in 7.11.0.\n"
+"\n"
+"       -P, --ftp-port <address>\n"
+"              (FTP) Reverses the default initiator/listener  roles  when  con-\n"
+, stdout);
+ fputs(
+"              necting  with  FTP. This option makes curl use active mode. curl\n"
+"              then tells the server to connect back to the client's  specified\n"
+"              address and port, while passive mode asks the server to setup an\n"
+"              IP address and port for it to connect to.  <address>  should  be\n"
+"              one of:\n"
+"\n"
+"              interface\n"
+"                     e.g.  \"eth0\"  to specify which interface's IP address you\n"
+"                     want to use (Unix only)\n"
+"\n"
+, stdout);
+ fputs(
+"              IP address\n"
+"                     e.g. \"192.168.10.1\" to specify the exact IP address\n"
+"\n"
+"              host name\n"
+"                     e.g. \"my.host.domain\" to specify the machine\n"
+"\n"
+"              -      make curl pick the same IP address that is  already  used\n"
+"                     for the control connection\n"
+"\n"
+"       If  this  option is used several times, the last one will be used. Dis-\n"
+"       able the use of PORT with --ftp-pasv. Disable the attempt  to  use  the\n"
+, stdout);
+ fputs(
+"       EPRT  command  instead  of PORT by using --disable-eprt. EPRT is really\n"
+"       PORT++.\n"
+"\n"
+"       Since 7.19.5, you can append \":[start]-[end]\" to the right of  the  ad-\n"
+"       dress,  to tell curl what TCP port range to use. That means you specify\n"
+"       a port range, from a lower to a higher number. A single number works as\n"
+"       well,  but do note that it increases the risk of failure since the port\n"
+"       may not be available.\n"
+"\n"
+"       See also --ftp-pasv and --disable-eprt.\n"
+"\n"
+, stdout);
+ fputs(
+"       --ftp-pret\n"
+"              (FTP) Tell curl to send a PRET command before PASV  (and  EPSV).\n"
+"              Certain  FTP  servers,  mainly drftpd, require this non-standard\n"
+"              command for directory listings as well as up  and  downloads  in\n"
+"              PASV mode.\n"
+"\n"
+"              Added in 7.20.0.\n"
+"\n"
+"       --ftp-skip-pasv-ip\n"
+"              (FTP) Tell curl to not use the IP address the server suggests in\n"
+"              its response to curl's PASV command when curl connects the  data\n"
+, stdout);
+ fputs(
+"              connection.  Instead curl will re-use the same IP address it al-\n"
+"              ready uses for the control connection.\n"
+"\n"
+"              This option has no effect if PORT, EPRT or EPSV is used  instead\n"
+"              of PASV.\n"
+"\n"
+"              See also --ftp-pasv. Added in 7.14.2.\n"
+"\n"
+"       --ftp-ssl-ccc-mode <active/passive>\n"
+"              (FTP)  Sets the CCC mode. The passive mode will not initiate the\n"
+"              shutdown, but instead wait for the server to do it, and will not\n"
+, stdout);
+ fputs(
+"              reply to the shutdown from the server. The active mode initiates\n"
+"              the shutdown and waits for a reply from the server.\n"
+"\n"
+"              See also --ftp-ssl-ccc. Added in 7.16.2.\n"
+"\n"
+"       --ftp-ssl-ccc\n"
+"              (FTP) Use CCC (Clear Command Channel)  Shuts  down  the  SSL/TLS\n"
+"              layer after authenticating. The rest of the control channel com-\n"
+"              munication will be unencrypted. This allows NAT routers to  fol-\n"
+, stdout);
+ fputs(
+"              low the FTP transaction. The default mode is passive.\n"
+"\n"
+"              See also --ssl and --ftp-ssl-ccc-mode. Added in 7.16.1.\n"
+"\n"
+"       --ftp-ssl-control\n"
+"              (FTP)  Require  SSL/TLS  for  the FTP login, clear for transfer.\n"
+"              Allows secure authentication, but non-encrypted  data  transfers\n"
+"              for  efficiency.   Fails the transfer if the server doesn't sup-\n"
+"              port SSL/TLS.\n"
+"\n"
+"              Added in 7.16.0.\n"
+"\n"
+"       -G, --get\n"
+, stdout);
+ fputs(
+"              When used, this option will make all  data  specified  with  -d,\n"
+"              --data,  --data-binary or --data-urlencode to be used in an HTTP\n"
+"              GET request instead of the POST request that otherwise would  be\n"
+"              used. The data will be appended to the URL with a '?' separator.\n"
+"              If  used  in combination with -I, --head, the POST data will in-\n"
+"              stead be appended to the URL with a HEAD request.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is used several times,  only  the  first  one  is\n"
+"              used.  This is because undoing a GET doesn't make sense, but you\n"
+"              should then instead enforce the alternative method you prefer.\n"
+"\n"
+"       -g, --globoff\n"
+"              This option switches off the \"URL globbing parser\". When you set\n"
+"              this  option, you can specify URLs that contain the letters {}[]\n"
+"              without having them being interpreted by curl itself. Note  that\n"
+, stdout);
+ fputs(
+"              these  letters are not normal legal URL contents but they should\n"
+"              be encoded according to the URI standard.\n"
+"\n"
+"       --happy-eyeballs-timeout-ms <milliseconds>\n"
+"              Happy eyeballs is an algorithm that attempts to connect to  both\n"
+"              IPv4  and  IPv6  addresses for dual-stack hosts, preferring IPv6\n"
+"              first for the number of milliseconds. If the IPv6 address cannot\n"
+, stdout);
+ fputs(
+"              be  connected  to  within that time then a connection attempt is\n"
+"              made to the IPv4 address in parallel. The first connection to be\n"
+"              established is the one that is used.\n"
+"\n"
+"              The  range of suggested useful values is limited. Happy Eyeballs\n"
+"              RFC 6555 says \"It is RECOMMENDED  that  connection  attempts  be\n"
+"              paced  150-250 ms apart to balance human factors against network\n"
+, stdout);
+ fputs(
+"              load.\" libcurl currently defaults to 200 ms. Firefox and  Chrome\n"
+"              currently default to 300 ms.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.59.0.\n"
+"\n"
+"       --haproxy-protocol\n"
+"              (HTTP)  Send a HAProxy PROXY protocol v1 header at the beginning\n"
+"              of the connection. This is used by some load balancers  and  re-\n"
+"              verse proxies to indicate the client's true IP address and port.\n"
+, stdout);
+ fputs(
+"              This  option is primarily useful when sending test requests to a\n"
+"              service that expects this header.\n"
+"\n"
+"              Added in 7.60.0.\n"
+"\n"
+"       -I, --head\n"
+"              (HTTP FTP FILE) Fetch the headers only! HTTP-servers feature the\n"
+"              command  HEAD which this uses to get nothing but the header of a\n"
+"              document. When used on an FTP or FILE file,  curl  displays  the\n"
+"              file size and last modification time only.\n"
+"\n"
+, stdout);
+ fputs(
+"       -H, --header <header/@file>\n"
+"              (HTTP)  Extra header to include in the request when sending HTTP\n"
+"              to a server. You may specify any number of extra  headers.  Note\n"
+"              that if you should add a custom header that has the same name as\n"
+"              one of the internal ones curl would  use,  your  externally  set\n"
+"              header will be used instead of the internal one. This allows you\n"
+, stdout);
+ fputs(
+"              to make even trickier stuff than curl  would  normally  do.  You\n"
+"              should  not  replace internally set headers without knowing per-\n"
+"              fectly well what you're doing. Remove an internal header by giv-\n"
+"              ing  a  replacement  without  content  on  the right side of the\n"
+"              colon, as in: -H \"Host:\". If you send the custom header with no-\n"
+"              value  then its header must be terminated with a semicolon, such\n"
+, stdout);
+ fputs(
+"              as -H \"X-Custom-Header;\" to send \"X-Custom-Header:\".\n"
+"\n"
+"              curl will make sure that each header  you  add/replace  is  sent\n"
+"              with the proper end-of-line marker, you should thus not add that\n"
+"              as a part of the header content: do not add newlines or carriage\n"
+"              returns, they will only mess things up for you.\n"
+"\n"
+"              Starting  in  7.55.0, this option can take an argument in @file-\n"
+, stdout);
+ fputs(
+"              name style, which then adds a header for each line in the  input\n"
+"              file. Using @- will make curl read the header file from stdin.\n"
+"\n"
+"              See also the -A, --user-agent and -e, --referer options.\n"
+"\n"
+"              Starting in 7.37.0, you need --proxy-header to send custom head-\n"
+"              ers intended for a proxy.\n"
+"\n"
+"              Example:\n"
+"\n"
+"               curl -H \"X-First-Name: Joe\" http://example.com/\n"
+"\n"
+, stdout);
+ fputs(
+"              WARNING: headers set with this option will be  set  in  all  re-\n"
+"              quests  - even after redirects are followed, like when told with\n"
+"              -L, --location. This can lead to the header being sent to  other\n"
+"              hosts  than  the  original  host, so sensitive headers should be\n"
+"              used with caution combined with following redirects.\n"
+"\n"
+"              This option can be used  multiple  times  to  add/replace/remove\n"
+"              multiple headers.\n"
+"\n"
+, stdout);
+ fputs(
+"       -h, --help\n"
+"              Usage  help.  This lists all current command line options with a\n"
+"              short description.\n"
+"       --hostpubmd5 <md5>\n"
+"              (SFTP SCP) Pass a string containing 32 hexadecimal  digits.  The\n"
+"              string  should  be the 128 bit MD5 checksum of the remote host's\n"
+"              public key, curl will refuse the connection with the host unless\n"
+"              the md5sums match.\n"
+"\n"
+"              Added in 7.17.1.\n"
+"\n"
+"       --http0.9\n"
+, stdout);
+ fputs(
+"              (HTTP) Tells curl to be fine with HTTP version 0.9 response.\n"
+"\n"
+"              HTTP/0.9  is  a completely headerless response and therefore you\n"
+"              can also connect with this to non-HTTP servers and still  get  a\n"
+"              response since curl will simply transparently downgrade - if al-\n"
+"              lowed.\n"
+"\n"
+"              A future curl version will deny continuing if the response isn't\n"
+"              at least HTTP/1.0 unless this option is used.\n"
+"\n"
+"       -0, --http1.0\n"
+, stdout);
+ fputs(
+"              (HTTP)  Tells  curl to use HTTP version 1.0 instead of using its\n"
+"              internally preferred HTTP version.\n"
+"\n"
+"              This option overrides --http1.1 and --http2.\n"
+"\n"
+"       --http1.1\n"
+"              (HTTP) Tells curl to use HTTP version 1.1.\n"
+"\n"
+"              This option  overrides  -0,  --http1.0  and  --http2.  Added  in\n"
+"              7.33.0.\n"
+"\n"
+"       --http2-prior-knowledge\n"
+"              (HTTP)  Tells  curl  to  issue  its  non-TLS HTTP requests using\n"
+, stdout);
+ fputs(
+"              HTTP/2 without HTTP/1.1 Upgrade.  It  requires  prior  knowledge\n"
+"              that  the  server  supports HTTP/2 straight away. HTTPS requests\n"
+"              will still do HTTP/2 the standard way with  negotiated  protocol\n"
+"              version in the TLS handshake.\n"
+"\n"
+"              --http2-prior-knowledge requires that the underlying libcurl was\n"
+"              built to support HTTP/2. This option overrides --http1.1 and -0,\n"
+"              --http1.0 and --http2. Added in 7.49.0.\n"
+"\n"
+, stdout);
+ fputs(
+"       --http2\n"
+"              (HTTP) Tells curl to use HTTP version 2.\n"
+"\n"
+"              See also --no-alpn. --http2 requires that the underlying libcurl\n"
+"              was built to support HTTP/2. This option overrides --http1.1 and\n"
+"              -0, --http1.0 and --http2-prior-knowledge. Added in 7.33.0.\n"
+"\n"
+"       --ignore-content-length\n"
+"              (FTP  HTTP)  For HTTP, Ignore the Content-Length header. This is\n"
+"              particularly useful for servers running Apache 1.x,  which  will\n"
+, stdout);
+ fputs(
+"              report  incorrect  Content-Length  for files larger than 2 giga-\n"
+"              bytes.\n"
+"\n"
+"              For FTP (since 7.46.0), skip the RETR command to figure out  the\n"
+"              size before downloading a file.\n"
+"\n"
+"       -i, --include\n"
+"              Include  the  HTTP  response headers in the output. The HTTP re-\n"
+"              sponse headers can include things  like  server  name,  cookies,\n"
+"              date of the document, HTTP version and more...\n"
+"\n"
+, stdout);
+ fputs(
+"              To view the request headers, consider the -v, --verbose option.\n"
+"\n"
+"              See also -v, --verbose.\n"
+"\n"
+"       -k, --insecure\n"
+"              (TLS) By default, every SSL connection curl makes is verified to\n"
+"              be secure. This option allows curl to proceed and  operate  even\n"
+"              for server connections otherwise considered insecure.\n"
+"\n"
+"              The  server  connection  is verified by making sure the server's\n"
+, stdout);
+ fputs(
+"              certificate contains the right name  and  verifies  successfully\n"
+"              using the cert store.\n"
+"\n"
+"              See this online resource for further details:\n"
+"               https://curl.haxx.se/docs/sslcerts.html\n"
+"              See also --proxy-insecure and --cacert.\n"
+"\n"
+"       --interface <name>\n"
+"\n"
+"              Perform  an operation using a specified interface. You can enter\n"
+"              interface name, IP address or host name. An example  could  look\n"
+"              like:\n"
+"\n"
+, stdout);
+ fputs(
+"               curl --interface eth0:1 https://www.example.com/\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"              On  Linux  it can be used to specify a VRF, but the binary needs\n"
+"              to either have CAP_NET_RAW or to be run as root.  More  informa-\n"
+"              tion   about  Linux  VRF:  https://www.kernel.org/doc/Documenta-\n"
+"              tion/networking/vrf.txt\n"
+"\n"
+"              See also --dns-interface.\n"
+"\n"
+"       -4, --ipv4\n"
+, stdout);
+ fputs(
+"              This option tells curl to resolve names to IPv4 addresses  only,\n"
+"              and not for example try IPv6.\n"
+"\n"
+"              See  also  --http1.1  and  --http2.  This  option  overrides -6,\n"
+"              --ipv6.\n"
+"\n"
+"       -6, --ipv6\n"
+"              This option tells curl to resolve names to IPv6 addresses  only,\n"
+"              and not for example try IPv4.\n"
+"\n"
+"              See  also  --http1.1  and  --http2.  This  option  overrides -4,\n"
+"              --ipv4.\n"
+"\n"
+, stdout);
+ fputs(
+"       -j, --junk-session-cookies\n"
+"              (HTTP) When curl is told to read cookies from a given file, this\n"
+"              option will make it discard all \"session cookies\". This will ba-\n"
+"              sically have the same effect as if a  new  session  is  started.\n"
+"              Typical  browsers  always  discard  session cookies when they're\n"
+"              closed down.\n"
+"\n"
+"              See also -b, --cookie and -c, --cookie-jar.\n"
+"\n"
+"       --keepalive-time <seconds>\n"
+, stdout);
+ fputs(
+"              This option sets the time a connection needs to remain idle  be-\n"
+"              fore  sending  keepalive  probes and the time between individual\n"
+"              keepalive probes. It is currently effective on operating systems\n"
+"              offering  the  TCP_KEEPIDLE  and  TCP_KEEPINTVL  socket  options\n"
+"              (meaning Linux, recent AIX, HP-UX and more). This option has  no\n"
+"              effect if --no-keepalive is used.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is used several times, the last one will be used.\n"
+"              If unspecified, the option defaults to 60 seconds.\n"
+"\n"
+"              Added in 7.18.0.\n"
+"\n"
+"       --key-type <type>\n"
+"              (TLS) Private key file type. Specify which type your --key  pro-\n"
+"              vided  private  key  is. DER, PEM, and ENG are supported. If not\n"
+"              specified, PEM is assumed.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+, stdout);
+ fputs(
+"       --key <key>\n"
+"              (TLS SSH) Private key file name. Allows you to provide your pri-\n"
+"              vate  key in this separate file. For SSH, if not specified, curl\n"
+"              tries  the  following  candidates  in  order:   '~/.ssh/id_rsa',\n"
+"              '~/.ssh/id_dsa', './id_rsa', './id_dsa'.\n"
+"\n"
+"              If  curl is built against OpenSSL library, and the engine pkcs11\n"
+"              is available, then a PKCS#11 URI (RFC 7512) can be used to spec-\n"
+, stdout);
+ fputs(
+"              ify  a  private key located in a PKCS#11 device. A string begin-\n"
+"              ning with \"pkcs11:\" will be interpreted as a PKCS#11 URI.  If  a\n"
+"              PKCS#11 URI is provided, then the --engine option will be set as\n"
+"              \"pkcs11\" if none was provided and the --key-type option will  be\n"
+"              set as \"ENG\" if none was provided.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       --krb <level>\n"
+, stdout);
+ fputs(
+"              (FTP)  Enable Kerberos authentication and use. The level must be\n"
+"              entered and should be one of 'clear', 'safe', 'confidential', or\n"
+"              'private'.  Should  you  use  a  level that is not one of these,\n"
+"              'private' will instead be used.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"              --krb requires that the underlying libcurl was built to  support\n"
+"              Kerberos.\n"
+"\n"
+"       --libcurl <file>\n"
+, stdout);
+ fputs(
+"              Append  this  option  to any ordinary curl command line, and you\n"
+"              will get a libcurl-using C source code written to the file  that\n"
+"              does the equivalent of what your command-line operation does!\n"
+"\n"
+"              If  this  option is used several times, the last given file name\n"
+"              will be used.\n"
+"\n"
+"              Added in 7.16.1.\n"
+"\n"
+"       --limit-rate <speed>\n"
+"              Specify the maximum transfer rate you want curl  to  use  -  for\n"
+, stdout);
+ fputs(
+"              both downloads and uploads. This feature is useful if you have a\n"
+"              limited pipe and you'd like your transfer not to use your entire\n"
+"              bandwidth. To make it slower than it otherwise would be.\n"
+"\n"
+"              The  given speed is measured in bytes/second, unless a suffix is\n"
+"              appended.  Appending 'k' or 'K' will count the number  as  kilo-\n"
+"              bytes,  'm' or 'M' makes it megabytes, while 'g' or 'G' makes it\n"
+, stdout);
+ fputs(
+"              gigabytes. Examples: 200K, 3m and 1G.\n"
+"\n"
+"              If you also use the -Y, --speed-limit option, that  option  will\n"
+"              take precedence and might cripple the rate-limiting slightly, to\n"
+"              help keeping the speed-limit logic working.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       -l, --list-only\n"
+"              (FTP POP3) (FTP) When listing  an  FTP  directory,  this  switch\n"
+, stdout);
+ fputs(
+"              forces  a  name-only view. This is especially useful if the user\n"
+"              wants to machine-parse the contents of an  FTP  directory  since\n"
+"              the normal directory view doesn't use a standard look or format.\n"
+"              When used like this, the option causes a NLST command to be sent\n"
+"              to the server instead of LIST.\n"
+"\n"
+"              Note:  Some  FTP  servers  list  only files in their response to\n"
+, stdout);
+ fputs(
+"              NLST; they do not include sub-directories and symbolic links.\n"
+"\n"
+"              (POP3) When retrieving a specific email from POP3,  this  switch\n"
+"              forces  a  LIST command to be performed instead of RETR. This is\n"
+"              particularly useful if the user wants to see if a specific  mes-\n"
+"              sage id exists on the server and what size it is.\n"
+"\n"
+"              Note:  When combined with -X, --request, this option can be used\n"
+, stdout);
+ fputs(
+"              to send an UIDL command instead, so the user may use the email's\n"
+"              unique  identifier  rather  than it's message id to make the re-\n"
+"              quest.\n"
+"\n"
+"              Added in 7.21.5.\n"
+"\n"
+"       --local-port <num/range>\n"
+"              Set a preferred single number or range (FROM-TO) of  local  port\n"
+"              numbers to use for the connection(s).  Note that port numbers by\n"
+"              nature are a scarce resource that will be busy at times so  set-\n"
+, stdout);
+ fputs(
+"              ting  this range to something too narrow might cause unnecessary\n"
+"              connection setup failures.\n"
+"\n"
+"              Added in 7.15.2.\n"
+"\n"
+"       --location-trusted\n"
+"              (HTTP) Like -L, --location, but will allow sending  the  name  +\n"
+"              password to all hosts that the site may redirect to. This may or\n"
+"              may not introduce a security breach if the site redirects you to\n"
+"              a  site  to which you'll send your authentication info (which is\n"
+, stdout);
+ fputs(
+"              plaintext in the case of HTTP Basic authentication).\n"
+"\n"
+"              See also -u, --user.\n"
+"\n"
+"       -L, --location\n"
+"              (HTTP) If the server reports that the requested page  has  moved\n"
+"              to a different location (indicated with a Location: header and a\n"
+"              3XX response code), this option will make curl redo the  request\n"
+"              on  the  new  place.  If used together with -i, --include or -I,\n"
+, stdout);
+ fputs(
+"              --head, headers from all requested pages will be shown. When au-\n"
+"              thentication  is  used,  curl  only sends its credentials to the\n"
+"              initial host. If a redirect takes curl to a different  host,  it\n"
+"              won't  be  able to intercept the user+password. See also --loca-\n"
+"              tion-trusted on how to change this. You can limit the amount  of\n"
+"              redirects to follow by using the --max-redirs option.\n"
+"\n"
+, stdout);
+ fputs(
+"              When  curl follows a redirect and the request is not a plain GET\n"
+"              (for example POST or PUT), it will do the following request with\n"
+"              a GET if the HTTP response was 301, 302, or 303. If the response\n"
+"              code was any other 3xx code, curl will re-send the following re-\n"
+"              quest using the same unmodified method.\n"
+"\n"
+"              You  can  tell  curl to not change the non-GET request method to\n"
+, stdout);
+ fputs(
+"              GET after a 30x response by  using  the  dedicated  options  for\n"
+"              that: --post301, --post302 and --post303.\n"
+"\n"
+"       --login-options <options>\n"
+"              (IMAP  POP3 SMTP) Specify the login options to use during server\n"
+"              authentication.\n"
+"\n"
+"              You can use the login options to specify protocol  specific  op-\n"
+"              tions  that  may  be used during authentication. At present only\n"
+, stdout);
+ fputs(
+"              IMAP, POP3 and SMTP support login options. For more  information\n"
+"              about  the  login options please see RFC 2384, RFC 5092 and IETF\n"
+"              draft draft-earhart-url-smtp-00.txt\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.34.0.\n"
+"\n"
+"       --mail-auth <address>\n"
+"              (SMTP) Specify a single address. This will be  used  to  specify\n"
+, stdout);
+ fputs(
+"              the  authentication  address  (identity)  of a submitted message\n"
+"              that is being relayed to another server.\n"
+"\n"
+"              See also --mail-rcpt and --mail-from. Added in 7.25.0.\n"
+"\n"
+"       --mail-from <address>\n"
+"              (SMTP) Specify a single address that the given mail  should  get\n"
+"              sent from.\n"
+"\n"
+"              See also --mail-rcpt and --mail-auth. Added in 7.20.0.\n"
+"\n"
+"       --mail-rcpt <address>\n"
+, stdout);
+ fputs(
+"              (SMTP) Specify a single address, user name or mailing list name.\n"
+"              Repeat this option several times to send to multiple recipients.\n"
+"              When performing a mail transfer, the recipient should specify  a\n"
+"              valid email address to send the mail to.\n"
+"\n"
+"              When  performing an address verification (VRFY command), the re-\n"
+"              cipient should be specified as the user name or  user  name  and\n"
+, stdout);
+ fputs(
+"              domain (as per Section 3.5 of RFC5321). (Added in 7.34.0)\n"
+"\n"
+"              When performing a mailing list expand (EXPN command), the recip-\n"
+"              ient should be specified using the mailing list  name,  such  as\n"
+"              \"Friends\" or \"London-Office\".  (Added in 7.34.0)\n"
+"\n"
+"              Added in 7.20.0.\n"
+"\n"
+"       -M, --manual\n"
+"              Manual. Display the huge help text.\n"
+"\n"
+"       --max-filesize <bytes>\n"
+, stdout);
+ fputs(
+"              Specify  the  maximum  size (in bytes) of a file to download. If\n"
+"              the file requested is larger than this value, the transfer  will\n"
+"              not start and curl will return with exit code 63.\n"
+"\n"
+"              A  size  modifier may be used. For example, Appending 'k' or 'K'\n"
+"              will count  the  number  as  kilobytes,  'm'  or  'M'  makes  it\n"
+"              megabytes,  while 'g' or 'G' makes it gigabytes. Examples: 200K,\n"
+, stdout);
+ fputs(
+"              3m and 1G. (Added in 7.58.0)\n"
+"\n"
+"              NOTE: The file size is not always known prior to  download,  and\n"
+"              for such files this option has no effect even if the file trans-\n"
+"              fer ends up being larger than this given  limit.  This  concerns\n"
+"              both FTP and HTTP transfers.\n"
+"\n"
+"              See also --limit-rate.\n"
+"\n"
+"       --max-redirs <num>\n"
+"              (HTTP)  Set  maximum  number  of redirection-followings allowed.\n"
+, stdout);
+ fputs(
+"              When -L, --location is used, is used to prevent curl  from  fol-\n"
+"              lowing redirections too much. By default, the limit is set to 50\n"
+"              redirections. Set this option to -1 to make it unlimited.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       -m, --max-time <seconds>\n"
+"              Maximum time in seconds that you allow the  whole  operation  to\n"
+, stdout);
+ fputs(
+"              take.   This is useful for preventing your batch jobs from hang-\n"
+"              ing for hours due to slow networks or links going  down.   Since\n"
+"              7.32.0, this option accepts decimal values, but the actual time-\n"
+"              out will decrease in accuracy as the specified timeout increases\n"
+"              in decimal precision.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              See also --connect-timeout.\n"
+"\n"
+"       --metalink\n"
+, stdout);
+ fputs(
+"              This  option  can  tell curl to parse and process a given URI as\n"
+"              Metalink file (both version 3 and 4 (RFC  5854)  are  supported)\n"
+"              and  make use of the mirrors listed within for failover if there\n"
+"              are errors (such as the file or server not being available).  It\n"
+"              will  also  verify  the hash of the file after the download com-\n"
+"              pletes. The Metalink file itself is downloaded and processed  in\n"
+, stdout);
+ fputs(
+"              memory and not stored in the local file system.\n"
+"\n"
+"              Example to use a remote Metalink file:\n"
+"\n"
+"               curl --metalink http://www.example.com/example.metalink\n"
+"\n"
+"              To use a Metalink file in the local file system, use FILE proto-\n"
+"              col (file://):\n"
+"\n"
+"               curl --metalink file://example.metalink\n"
+"\n"
+"              Please note that if FILE protocol is disabled, there is  no  way\n"
+, stdout);
+ fputs(
+"              to  use  a local Metalink file at the time of this writing. Also\n"
+"              note that if --metalink and -i,  --include  are  used  together,\n"
+"              --include  will be ignored. This is because including headers in\n"
+"              the response will break Metalink parser and if the  headers  are\n"
+"              included in the file described in Metalink file, hash check will\n"
+"              fail.\n"
+"\n"
+"              --metalink requires that the underlying  libcurl  was  built  to\n"
+, stdout);
+ fputs(
+"              support metalink. Added in 7.27.0.\n"
+"\n"
+"       --negotiate\n"
+"              (HTTP) Enables Negotiate (SPNEGO) authentication.\n"
+"\n"
+"              This  option  requires a library built with GSS-API or SSPI sup-\n"
+"              port. Use -V, --version  to  see  if  your  curl  supports  GSS-\n"
+"              API/SSPI or SPNEGO.\n"
+"\n"
+"              When  using this option, you must also provide a fake -u, --user\n"
+"              option to activate the authentication code properly.  Sending  a\n"
+, stdout);
+ fputs(
+"              '-u  :'  is  enough  as  the user name and password from the -u,\n"
+"              --user option aren't actually used.\n"
+"\n"
+"              If this option is used several times,  only  the  first  one  is\n"
+"              used.\n"
+"\n"
+"              See also --basic and --ntlm and --anyauth and --proxy-negotiate.\n"
+"\n"
+"       --netrc-file <filename>\n"
+"              This  option  is similar to -n, --netrc, except that you provide\n"
+"              the path (absolute or relative) to  the  netrc  file  that  curl\n"
+, stdout);
+ fputs(
+"              should use.  You can only specify one netrc file per invocation.\n"
+"              If several --netrc-file options are provided, the last one  will\n"
+"              be used.\n"
+"\n"
+"              It will abide by --netrc-optional if specified.\n"
+"\n"
+"              This option overrides -n, --netrc. Added in 7.21.5.\n"
+"\n"
+"       --netrc-optional\n"
+"              Very  similar  to  -n, --netrc, but this option makes the .netrc\n"
+"              usage optional and not mandatory as the -n, --netrc option does.\n"
+"\n"
+, stdout);
+ fputs(
+"              See also --netrc-file. This option overrides -n, --netrc.\n"
+"\n"
+"       -n, --netrc\n"
+"              Makes curl scan the .netrc  (_netrc  on  Windows)  file  in  the\n"
+"              user's home directory for login name and password. This is typi-\n"
+"              cally used for FTP on Unix. If used with HTTP, curl will  enable\n"
+"              user authentication. See netrc(5) ftp(1) for details on the file\n"
+"              format. Curl will not complain if that  file  doesn't  have  the\n"
+, stdout);
+ fputs(
+"              right permissions (it should not be either world- or group-read-\n"
+"              able). The environment variable \"HOME\" is used to find the  home\n"
+"              directory.\n"
+"\n"
+"              A  quick and very simple example of how to setup a .netrc to al-\n"
+"              low curl to FTP to the machine host.domain.com  with  user  name\n"
+"              'myself' and password 'secret' should look similar to:\n"
+"\n"
+"              machine host.domain.com login myself password secret\n"
+"\n"
+"       -:, --next\n"
+, stdout);
+ fputs(
+"              Tells curl to use a separate operation for the following URL and\n"
+"              associated options. This allows you  to  send  several  URL  re-\n"
+"              quests,  each with their own specific options, for example, such\n"
+"              as different user names or custom requests for each.\n"
+"\n"
+"              -:, --next will reset all local options  and  only  global  ones\n"
+"              will  have  their values survive over to the operation following\n"
+, stdout);
+ fputs(
+"              the -:, --next instruction. Global options  include  -v,  --ver-\n"
+"              bose, --trace, --trace-ascii and --fail-early.\n"
+"\n"
+"              For  example,  you can do both a GET and a POST in a single com-\n"
+"              mand line:\n"
+"\n"
+"               curl www1.example.com --next -d postthis www2.example.com\n"
+"\n"
+"              Added in 7.36.0.\n"
+"\n"
+"       --no-alpn\n"
+"              (HTTPS) Disable the ALPN TLS extension. ALPN is enabled  by  de-\n"
+, stdout);
+ fputs(
+"              fault  if  libcurl  was  built with an SSL library that supports\n"
+"              ALPN. ALPN is used by a libcurl that supports HTTP/2 to  negoti-\n"
+"              ate HTTP/2 support with the server during https sessions.\n"
+"\n"
+"              See  also  --no-npn and --http2. --no-alpn requires that the un-\n"
+"              derlying libcurl was built to support TLS. Added in 7.36.0.\n"
+"\n"
+"       -N, --no-buffer\n"
+"              Disables the buffering of the output stream. In normal work sit-\n"
+, stdout);
+ fputs(
+"              uations,  curl  will  use a standard buffered output stream that\n"
+"              will have the effect that it will output the data in chunks, not\n"
+"              necessarily  exactly  when  the data arrives.  Using this option\n"
+"              will disable that buffering.\n"
+"\n"
+"              Note that this is the negated option name  documented.  You  can\n"
+"              thus use --buffer to enforce the buffering.\n"
+"\n"
+"       --no-keepalive\n"
+, stdout);
+ fputs(
+"              Disables  the  use  of keepalive messages on the TCP connection.\n"
+"              curl otherwise enables them by default.\n"
+"\n"
+"              Note that this is the negated option name  documented.  You  can\n"
+"              thus use --keepalive to enforce keepalive.\n"
+"\n"
+"       --no-npn\n"
+"              (HTTPS) Disable the NPN TLS extension. NPN is enabled by default\n"
+"              if libcurl was built with an SSL library that supports NPN.  NPN\n"
+, stdout);
+ fputs(
+"              is  used  by  a libcurl that supports HTTP/2 to negotiate HTTP/2\n"
+"              support with the server during https sessions.\n"
+"\n"
+"              See also --no-alpn and --http2. --no-npn requires that  the  un-\n"
+"              derlying libcurl was built to support TLS. Added in 7.36.0.\n"
+"\n"
+"       --no-sessionid\n"
+"              (TLS)  Disable curl's use of SSL session-ID caching.  By default\n"
+"              all transfers are done using the cache. Note that while  nothing\n"
+, stdout);
+ fputs(
+"              should  ever  get  hurt  by attempting to reuse SSL session-IDs,\n"
+"              there seem to be broken SSL implementations in the wild that may\n"
+"              require you to disable this in order for you to succeed.\n"
+"\n"
+"              Note  that  this  is the negated option name documented. You can\n"
+"              thus use --sessionid to enforce session-ID caching.\n"
+"\n"
+"              Added in 7.16.0.\n"
+"\n"
+"       --noproxy <no-proxy-list>\n"
+, stdout);
+ fputs(
+"              Comma-separated list of hosts which do not use a proxy,  if  one\n"
+"              is  specified.  The only wildcard is a single * character, which\n"
+"              matches all hosts, and effectively disables the proxy. Each name\n"
+"              in  this  list  is matched as either a domain which contains the\n"
+"              hostname, or the hostname itself. For example,  local.com  would\n"
+"              match   local.com,  local.com:80,  and  www.local.com,  but  not\n"
+, stdout);
+ fputs(
+"              www.notlocal.com.\n"
+"\n"
+"              Since 7.53.0, This option overrides  the  environment  variables\n"
+"              that  disable the proxy. If there's an environment variable dis-\n"
+"              abling a proxy, you can set noproxy list to \"\" to override it.\n"
+"\n"
+"              Added in 7.19.4.\n"
+"\n"
+"       --ntlm-wb\n"
+"              (HTTP) Enables NTLM much in the style --ntlm does, but hand over\n"
+"              the  authentication  to the separate binary ntlmauth application\n"
+, stdout);
+ fputs(
+"              that is executed when needed.\n"
+"\n"
+"              See also --ntlm and --proxy-ntlm.\n"
+"\n"
+"       --ntlm (HTTP) Enables  NTLM  authentication.  The  NTLM  authentication\n"
+"              method was designed by Microsoft and is used by IIS web servers.\n"
+"              It is a proprietary protocol, reverse-engineered by clever  peo-\n"
+"              ple and implemented in curl based on their efforts. This kind of\n"
+"              behavior should not be endorsed, you should  encourage  everyone\n"
+, stdout);
+ fputs(
+"              who  uses  NTLM to switch to a public and documented authentica-\n"
+"              tion method instead, such as Digest.\n"
+"\n"
+"              If you want to enable NTLM for your proxy  authentication,  then\n"
+"              use --proxy-ntlm.\n"
+"\n"
+"              If  this  option  is  used  several times, only the first one is\n"
+"              used.\n"
+"\n"
+"              See also  --proxy-ntlm.  --ntlm  requires  that  the  underlying\n"
+, stdout);
+ fputs(
+"              libcurl  was built to support TLS. This option overrides --basic\n"
+"              and --negotiate and --digest and --anyauth.\n"
+"\n"
+"       --oauth2-bearer <token>\n"
+"              (IMAP POP3 SMTP) Specify the Bearer Token for OAUTH  2.0  server\n"
+"              authentication. The Bearer Token is used in conjunction with the\n"
+"              user name which can be specified as part of  the  --url  or  -u,\n"
+"              --user options.\n"
+"\n"
+, stdout);
+ fputs(
+"              The  Bearer  Token  and user name are formatted according to RFC\n"
+"              6750.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       -o, --output <file>\n"
+"              Write output to <file> instead of stdout. If you are using {} or\n"
+"              []  to  fetch  multiple documents, you can use '#' followed by a\n"
+"              number in the <file> specifier. That variable will  be  replaced\n"
+, stdout);
+ fputs(
+"              with the current string for the URL being fetched. Like in:\n"
+"\n"
+"               curl http://{one,two}.example.com -o \"file_#1.txt\"\n"
+"\n"
+"              or use several variables like:\n"
+"\n"
+"               curl http://{site,host}.host[1-5].com -o \"#1_#2\"\n"
+"\n"
+"              You  may use this option as many times as the number of URLs you\n"
+"              have. For example, if you specify two URLs on the  same  command\n"
+"              line, you can use it like this:\n"
+"\n"
+, stdout);
+ fputs(
+"                curl -o aa example.com -o bb example.net\n"
+"\n"
+"              and  the  order  of  the -o options and the URLs doesn't matter,\n"
+"              just that the first -o is for the first URL and so  on,  so  the\n"
+"              above command line can also be written as\n"
+"\n"
+"                curl example.com example.net -o aa -o bb\n"
+"\n"
+"              See  also  the --create-dirs option to create the local directo-\n"
+"              ries dynamically. Specifying the output as '-' (a  single  dash)\n"
+, stdout);
+ fputs(
+"              will force the output to be done to stdout.\n"
+"\n"
+"              See  also  -O, --remote-name and --remote-name-all and -J, --re-\n"
+"              mote-header-name.\n"
+"\n"
+"       --pass <phrase>\n"
+"              (SSH TLS) Passphrase for the private key\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       --path-as-is\n"
+"              Tell curl to not handle sequences of /../ or /./  in  the  given\n"
+, stdout);
+ fputs(
+"              URL  path.  Normally curl will squash or merge them according to\n"
+"              standards but with this option set you tell it not to do that.\n"
+"\n"
+"              Added in 7.42.0.\n"
+"\n"
+"       --pinnedpubkey <hashes>\n"
+"              (TLS) Tells curl to  use  the  specified  public  key  file  (or\n"
+"              hashes)  to  verify the peer. This can be a path to a file which\n"
+"              contains a single public key in PEM or DER format, or any number\n"
+, stdout);
+ fputs(
+"              of base64 encoded sha256 hashes preceded by 'sha256//' and sepa-\n"
+"              rated by ';'\n"
+"\n"
+"              When negotiating a TLS or SSL connection,  the  server  sends  a\n"
+"              certificate  indicating  its identity. A public key is extracted\n"
+"              from this certificate and if it does not exactly match the  pub-\n"
+"              lic  key provided to this option, curl will abort the connection\n"
+"              before sending or receiving any data.\n"
+"\n"
+, stdout);
+ fputs(
+"              PEM/DER support:\n"
+"                7.39.0: OpenSSL, GnuTLS and GSKit\n"
+"                7.43.0: NSS and wolfSSL\n"
+"                7.47.0: mbedtls sha256 support:\n"
+"                7.44.0: OpenSSL, GnuTLS, NSS and wolfSSL\n"
+"                7.47.0: mbedtls Other SSL backends not supported.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       --post301\n"
+"              (HTTP) Tells curl to respect RFC 7231/6.4.2 and not convert POST\n"
+, stdout);
+ fputs(
+"              requests into GET requests when following a 301 redirection. The\n"
+"              non-RFC behaviour is ubiquitous in web browsers,  so  curl  does\n"
+"              the  conversion  by  default to maintain consistency. However, a\n"
+"              server may require a POST to remain a POST after  such  a  redi-\n"
+"              rection.  This  option is meaningful only when using -L, --loca-\n"
+"              tion.\n"
+"\n"
+"              See also --post302 and --post303 and -L,  --location.  Added  in\n"
+, stdout);
+ fputs(
+"              7.17.1.\n"
+"\n"
+"       --post302\n"
+"              (HTTP) Tells curl to respect RFC 7231/6.4.3 and not convert POST\n"
+"              requests into GET requests when following a 302 redirection. The\n"
+"              non-RFC  behaviour  is  ubiquitous in web browsers, so curl does\n"
+"              the conversion by default to maintain  consistency.  However,  a\n"
+"              server  may  require  a POST to remain a POST after such a redi-\n"
+, stdout);
+ fputs(
+"              rection. This option is meaningful only when using  -L,  --loca-\n"
+"              tion.\n"
+"\n"
+"              See  also  --post301  and --post303 and -L, --location. Added in\n"
+"              7.19.1.\n"
+"\n"
+"       --post303\n"
+"              (HTTP) Tells curl to violate RFC 7231/6.4.4 and not convert POST\n"
+"              requests  into  GET  requests when following 303 redirections. A\n"
+"              server may require a POST to remain a POST after a 303 redirect-\n"
+, stdout);
+ fputs(
+"              ion. This option is meaningful only when using -L, --location.\n"
+"\n"
+"              See  also  --post302  and --post301 and -L, --location. Added in\n"
+"              7.26.0.\n"
+"\n"
+"       --preproxy [protocol://]host[:port]\n"
+"              Use the specified SOCKS proxy before connecting to  an  HTTP  or\n"
+"              HTTPS  -x,  --proxy.  In  such a case curl first connects to the\n"
+"              SOCKS proxy and then connects (through SOCKS)  to  the  HTTP  or\n"
+, stdout);
+ fputs(
+"              HTTPS proxy. Hence pre proxy.\n"
+"\n"
+"              The pre proxy string should be specified with a protocol:// pre-\n"
+"              fix to  specify  alternative  proxy  protocols.  Use  socks4://,\n"
+"              socks4a://,  socks5://  or  socks5h://  to  request the specific\n"
+"              SOCKS version to be used. No protocol specified will  make  curl\n"
+"              default to SOCKS4.\n"
+"\n"
+"              If  the  port number is not specified in the proxy string, it is\n"
+, stdout);
+ fputs(
+"              assumed to be 1080.\n"
+"\n"
+"              User and password that might be provided in the proxy string are\n"
+"              URL  decoded by curl. This allows you to pass in special charac-\n"
+"              ters such as @ by using %40 or pass in a colon with %3a.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       -#, --progress-bar\n"
+"              Make curl display transfer progress as a simple progress bar in-\n"
+, stdout);
+ fputs(
+"              stead of the standard, more informational, meter.\n"
+"\n"
+"              This  progress  bar draws a single line of '#' characters across\n"
+"              the screen and shows a percentage if the transfer size is known.\n"
+"              For  transfers  without  a  known size, there will be space ship\n"
+"              (-=o=-) that moves back and forth but only while data  is  being\n"
+"              transferred, with a set of flying hash sign symbols on top.\n"
+"\n"
+"       --proto-default <protocol>\n"
+, stdout);
+ fputs(
+"              Tells curl to use protocol for any URL missing a scheme name.\n"
+"\n"
+"              Example:\n"
+"\n"
+"               curl --proto-default https ftp.mozilla.org\n"
+"\n"
+"              An  unknown  or  unsupported  protocol causes error CURLE_UNSUP-\n"
+"              PORTED_PROTOCOL (1).\n"
+"\n"
+"              This option does not change the default proxy protocol (http).\n"
+"\n"
+"              Without this option curl would make a guess based on  the  host,\n"
+"              see --url for details.\n"
+"\n"
+, stdout);
+ fputs(
+"              Added in 7.45.0.\n"
+"\n"
+"       --proto-redir <protocols>\n"
+"              Tells  curl to limit what protocols it may use on redirect. Pro-\n"
+"              tocols denied by --proto are not overridden by this option.  See\n"
+"              --proto for how protocols are represented.\n"
+"\n"
+"              Example, allow only HTTP and HTTPS on redirect:\n"
+"\n"
+"               curl --proto-redir -all,http,https http://example.com\n"
+"\n"
+"              By default curl will allow HTTP, HTTPS, FTP and FTPS on redirect\n"
+, stdout);
+ fputs(
+"              (7.65.2).  Older versions of curl allowed all protocols on redi-\n"
+"              rect  except several disabled for security reasons: Since 7.19.4\n"
+"              FILE and SCP are disabled, and since 7.40.0  SMB  and  SMBS  are\n"
+"              also  disabled.  Specifying all or +all enables all protocols on\n"
+"              redirect, including those disabled for security.\n"
+"\n"
+"              Added in 7.20.2.\n"
+"\n"
+"       --proto <protocols>\n"
+, stdout);
+ fputs(
+"              Tells curl to limit what protocols it may use in  the  transfer.\n"
+"              Protocols  are evaluated left to right, are comma separated, and\n"
+"              are each a protocol name or 'all', optionally prefixed  by  zero\n"
+"              or more modifiers. Available modifiers are:\n"
+"\n"
+"              +  Permit this protocol in addition to protocols already permit-\n"
+"                 ted (this is the default if no modifier is used).\n"
+"\n"
+, stdout);
+ fputs(
+"              -  Deny this protocol, removing it from the  list  of  protocols\n"
+"                 already permitted.\n"
+"\n"
+"              =  Permit  only this protocol (ignoring the list already permit-\n"
+"                 ted), though subject to later modification by subsequent  en-\n"
+"                 tries in the comma separated list.\n"
+"\n"
+"              For example:\n"
+"\n"
+"              --proto -ftps  uses the default protocols, but disables ftps\n"
+"\n"
+"              --proto -all,https,+http\n"
+, stdout);
+ fputs(
+"                             only enables http and https\n"
+"\n"
+"              --proto =http,https\n"
+"                             also only enables http and https\n"
+"\n"
+"       Unknown protocols produce a warning. This allows scripts to safely rely\n"
+"       on being able to disable potentially dangerous protocols, without rely-\n"
+"       ing  upon  support  for that protocol being built into curl to avoid an\n"
+"       error.\n"
+"\n"
+"       This option can be used multiple times, in which case the effect is the\n"
+, stdout);
+ fputs(
+"       same as concatenating the protocols into one instance of the option.\n"
+"\n"
+"       See also --proto-redir and --proto-default. Added in 7.20.2.\n"
+"\n"
+"       --proxy-anyauth\n"
+"              Tells  curl to pick a suitable authentication method when commu-\n"
+"              nicating with the given HTTP proxy. This might  cause  an  extra\n"
+"              request/response round-trip.\n"
+"\n"
+"              See also -x, --proxy and --proxy-basic and --proxy-digest. Added\n"
+"              in 7.13.2.\n"
+"\n"
+"       --proxy-basic\n"
+, stdout);
+ fputs(
+"              Tells curl to use HTTP Basic authentication  when  communicating\n"
+"              with the given proxy. Use --basic for enabling HTTP Basic with a\n"
+"              remote host. Basic is the  default  authentication  method  curl\n"
+"              uses with proxies.\n"
+"\n"
+"              See also -x, --proxy and --proxy-anyauth and --proxy-digest.\n"
+"\n"
+"       --proxy-cacert <file>\n"
+"              Same as --cacert but used in HTTPS proxy context.\n"
+"\n"
+, stdout);
+ fputs(
+"              See  also  --proxy-capath  and  --cacert  and  --capath  and -x,\n"
+"              --proxy. Added in 7.52.0.\n"
+"\n"
+"       --proxy-capath <dir>\n"
+"              Same as --capath but used in HTTPS proxy context.\n"
+"\n"
+"              See also --proxy-cacert and -x, --proxy and --capath.  Added  in\n"
+"              7.52.0.\n"
+"\n"
+"       --proxy-cert-type <type>\n"
+"              Same as --cert-type but used in HTTPS proxy context.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       --proxy-cert <cert[:passwd]>\n"
+, stdout);
+ fputs(
+"              Same as -E, --cert but used in HTTPS proxy context.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       --proxy-ciphers <list>\n"
+"              Same as --ciphers but used in HTTPS proxy context.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       --proxy-crlfile <file>\n"
+"              Same as --crlfile but used in HTTPS proxy context.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       --proxy-digest\n"
+"              Tells  curl to use HTTP Digest authentication when communicating\n"
+, stdout);
+ fputs(
+"              with the given proxy. Use --digest for enabling HTTP Digest with\n"
+"              a remote host.\n"
+"\n"
+"              See also -x, --proxy and --proxy-anyauth and --proxy-basic.\n"
+"\n"
+"       --proxy-header <header/@file>\n"
+"              (HTTP)  Extra header to include in the request when sending HTTP\n"
+"              to a proxy. You may specify any number of extra headers. This is\n"
+"              the  equivalent option to -H, --header but is for proxy communi-\n"
+, stdout);
+ fputs(
+"              cation only like in CONNECT requests when you  want  a  separate\n"
+"              header  sent  to  the proxy to what is sent to the actual remote\n"
+"              host.\n"
+"\n"
+"              curl will make sure that each header  you  add/replace  is  sent\n"
+"              with the proper end-of-line marker, you should thus not add that\n"
+"              as a part of the header content: do not add newlines or carriage\n"
+"              returns, they will only mess things up for you.\n"
+"\n"
+, stdout);
+ fputs(
+"              Headers  specified  with this option will not be included in re-\n"
+"              quests that curl knows will not be sent to a proxy.\n"
+"\n"
+"              Starting in 7.55.0, this option can take an argument  in  @file-\n"
+"              name  style, which then adds a header for each line in the input\n"
+"              file. Using @- will make curl read the header file from stdin.\n"
+"\n"
+"              This option can be used  multiple  times  to  add/replace/remove\n"
+"              multiple headers.\n"
+"\n"
+, stdout);
+ fputs(
+"              Added in 7.37.0.\n"
+"       --proxy-insecure\n"
+"              Same as -k, --insecure but used in HTTPS proxy context.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       --proxy-key-type <type>\n"
+"              Same as --key-type but used in HTTPS proxy context.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       --proxy-key <key>\n"
+"              Same as --key but used in HTTPS proxy context.\n"
+"\n"
+"       --proxy-negotiate\n"
+"              Tells  curl  to  use HTTP Negotiate (SPNEGO) authentication when\n"
+, stdout);
+ fputs(
+"              communicating with the given proxy. Use --negotiate for enabling\n"
+"              HTTP Negotiate (SPNEGO) with a remote host.\n"
+"\n"
+"              See also --proxy-anyauth and --proxy-basic. Added in 7.17.1.\n"
+"\n"
+"       --proxy-ntlm\n"
+"              Tells  curl  to  use HTTP NTLM authentication when communicating\n"
+"              with the given proxy. Use --ntlm for enabling NTLM with a remote\n"
+"              host.\n"
+"\n"
+"              See also --proxy-negotiate and --proxy-anyauth.\n"
+"\n"
+, stdout);
+ fputs(
+"       --proxy-pass <phrase>\n"
+"              Same as --pass but used in HTTPS proxy context.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       --proxy-pinnedpubkey <hashes>\n"
+"              (TLS)  Tells  curl  to  use  the  specified  public key file (or\n"
+"              hashes) to verify the proxy. This can be a path to a file  which\n"
+"              contains a single public key in PEM or DER format, or any number\n"
+"              of base64 encoded sha256 hashes preceded by 'sha256//' and sepa-\n"
+, stdout);
+ fputs(
+"              rated by ';'\n"
+"\n"
+"              When  negotiating  a  TLS  or SSL connection, the server sends a\n"
+"              certificate indicating its identity. A public key  is  extracted\n"
+"              from  this certificate and if it does not exactly match the pub-\n"
+"              lic key provided to this option, curl will abort the  connection\n"
+"              before sending or receiving any data.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+, stdout);
+ fputs(
+"       --proxy-service-name <name>\n"
+"              This  option allows you to change the service name for proxy ne-\n"
+"              gotiation.\n"
+"\n"
+"              Added in 7.43.0.\n"
+"\n"
+"       --proxy-ssl-allow-beast\n"
+"              Same as --ssl-allow-beast but used in HTTPS proxy context.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       --proxy-tls13-ciphers <ciphersuite list>\n"
+"              (TLS) Specifies which cipher suites to use in the connection  to\n"
+, stdout);
+ fputs(
+"              your HTTPS proxy when it negotiates TLS 1.3. The list of ciphers\n"
+"              suites must specify valid ciphers. Read up  on  TLS  1.3  cipher\n"
+"              suite details on this URL:\n"
+"\n"
+"               https://curl.haxx.se/docs/ssl-ciphers.html\n"
+"\n"
+"              This  option  is  currently  used only when curl is built to use\n"
+"              OpenSSL 1.1.1 or later. If you are using a different SSL backend\n"
+"              you  can try setting TLS 1.3 cipher suites by using the --proxy-\n"
+, stdout);
+ fputs(
+"              ciphers option.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       --proxy-tlsauthtype <type>\n"
+"              Same as --tlsauthtype but used in HTTPS proxy context.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       --proxy-tlspassword <string>\n"
+"              Same as --tlspassword but used in HTTPS proxy context.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       --proxy-tlsuser <name>\n"
+"              Same as --tlsuser but used in HTTPS proxy context.\n"
+"\n"
+, stdout);
+ fputs(
+"              Added in 7.52.0.\n"
+"\n"
+"       --proxy-tlsv1\n"
+"              Same as -1, --tlsv1 but used in HTTPS proxy context.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       -U, --proxy-user <user:password>\n"
+"              Specify the user name and password to use for proxy  authentica-\n"
+"              tion.\n"
+"\n"
+"              If  you use a Windows SSPI-enabled curl binary and do either Ne-\n"
+"              gotiate or NTLM authentication then you can tell curl to  select\n"
+, stdout);
+ fputs(
+"              the user name and password from your environment by specifying a\n"
+"              single colon with this option: \"-U :\".\n"
+"\n"
+"              On systems where it works, curl will hide the given option argu-\n"
+"              ment  from  process listings. This is not enough to protect cre-\n"
+"              dentials from possibly getting seen by other users on  the  same\n"
+"              system  as  they will still be visible for a brief moment before\n"
+, stdout);
+ fputs(
+"              cleared. Such sensitive data should be retrieved from a file in-\n"
+"              stead or similar and never used in clear text in a command line.\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       -x, --proxy [protocol://]host[:port]\n"
+"              Use the specified proxy.\n"
+"\n"
+"              The  proxy string can be specified with a protocol:// prefix. No\n"
+"              protocol specified or http:// will be treated as HTTP proxy. Use\n"
+, stdout);
+ fputs(
+"              socks4://, socks4a://, socks5:// or socks5h:// to request a spe-\n"
+"              cific SOCKS version to be used.  (The protocol support was added\n"
+"              in curl 7.21.7)\n"
+"\n"
+"              HTTPS  proxy  support  via https:// protocol prefix was added in\n"
+"              7.52.0 for OpenSSL, GnuTLS and NSS.\n"
+"\n"
+"              Unrecognized and unsupported  proxy  protocols  cause  an  error\n"
+"              since  7.52.0.   Prior  versions may ignore the protocol and use\n"
+, stdout);
+ fputs(
+"              http:// instead.\n"
+"\n"
+"              If the port number is not specified in the proxy string,  it  is\n"
+"              assumed to be 1080.\n"
+"\n"
+"              This  option  overrides  existing environment variables that set\n"
+"              the proxy to use. If there's an environment variable  setting  a\n"
+"              proxy, you can set proxy to \"\" to override it.\n"
+"\n"
+"              All operations that are performed over an HTTP proxy will trans-\n"
+, stdout);
+ fputs(
+"              parently be converted to HTTP. It means  that  certain  protocol\n"
+"              specific operations might not be available. This is not the case\n"
+"              if you can tunnel through the proxy, as one with the -p, --prox-\n"
+"              ytunnel option.\n"
+"\n"
+"              User and password that might be provided in the proxy string are\n"
+"              URL decoded by curl. This allows you to pass in special  charac-\n"
+"              ters such as @ by using %40 or pass in a colon with %3a.\n"
+"\n"
+, stdout);
+ fputs(
+"              The  proxy host can be specified the exact same way as the proxy\n"
+"              environment variables, including the protocol  prefix  (http://)\n"
+"              and the embedded user + password.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       --proxy1.0 <host[:port]>\n"
+"              Use  the  specified  HTTP  1.0  proxy. If the port number is not\n"
+"              specified, it is assumed at port 1080.\n"
+"\n"
+, stdout);
+ fputs(
+"              The only difference between this and the HTTP proxy  option  -x,\n"
+"              --proxy,  is that attempts to use CONNECT through the proxy will\n"
+"              specify an HTTP 1.0 protocol instead of the default HTTP 1.1.\n"
+"\n"
+"       -p, --proxytunnel\n"
+"              When an HTTP proxy is used -x, --proxy, this  option  will  make\n"
+"              curl  tunnel through the proxy. The tunnel approach is made with\n"
+"              the HTTP proxy CONNECT request and requires that the  proxy  al-\n"
+, stdout);
+ fputs(
+"              lows direct connect to the remote port number curl wants to tun-\n"
+"              nel through to.\n"
+"\n"
+"              To suppress proxy CONNECT response headers when curl is  set  to\n"
+"              output headers use --suppress-connect-headers.\n"
+"\n"
+"              See also -x, --proxy.\n"
+"\n"
+"       --pubkey <key>\n"
+"              (SFTP SCP) Public key file name. Allows you to provide your pub-\n"
+"              lic key in this separate file.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is used several times, the last one will be used.\n"
+"              (As of 7.39.0, curl attempts to automatically extract the public\n"
+"              key  from the private key file, so passing this option is gener-\n"
+"              ally not required. Note that this public key extraction requires\n"
+"              libcurl  to  be linked against a copy of libssh2 1.2.8 or higher\n"
+"              that is itself linked against OpenSSL.)\n"
+"\n"
+"       -Q, --quote\n"
+, stdout);
+ fputs(
+"              (FTP SFTP) Send an arbitrary command to the remote FTP  or  SFTP\n"
+"              server.  Quote commands are sent BEFORE the transfer takes place\n"
+"              (just after the initial PWD command in an FTP  transfer,  to  be\n"
+"              exact). To make commands take place after a successful transfer,\n"
+"              prefix them with a dash '-'.  To make  commands  be  sent  after\n"
+"              curl has changed the working directory, just before the transfer\n"
+, stdout);
+ fputs(
+"              command(s), prefix the command with a '+'  (this  is  only  sup-\n"
+"              ported for FTP). You may specify any number of commands.\n"
+"\n"
+"              If  the  server returns failure for one of the commands, the en-\n"
+"              tire operation will be aborted. You must send syntactically cor-\n"
+"              rect  FTP  commands as RFC 959 defines to FTP servers, or one of\n"
+"              the commands listed below to SFTP servers.\n"
+"\n"
+, stdout);
+ fputs(
+"              Prefix the command with an asterisk (*) to  make  curl  continue\n"
+"              even  if the command fails as by default curl will stop at first\n"
+"              failure.\n"
+"\n"
+"              This option can be used multiple times.\n"
+"\n"
+"              SFTP is a binary protocol. Unlike for FTP, curl interprets  SFTP\n"
+"              quote  commands  itself before sending them to the server.  File\n"
+"              names may be quoted shell-style to embed spaces or special char-\n"
+, stdout);
+ fputs(
+"              acters.   Following is the list of all supported SFTP quote com-\n"
+"              mands:\n"
+"\n"
+"              chgrp group file\n"
+"                     The chgrp command sets the group ID of the file named  by\n"
+"                     the  file  operand to the group ID specified by the group\n"
+"                     operand. The group operand is a decimal integer group ID.\n"
+"\n"
+"              chmod mode file\n"
+"                     The chmod command modifies the  file  mode  bits  of  the\n"
+, stdout);
+ fputs(
+"                     specified file. The mode operand is an octal integer mode\n"
+"                     number.\n"
+"\n"
+"              chown user file\n"
+"                     The chown command sets the owner of the file named by the\n"
+"                     file  operand  to the user ID specified by the user oper-\n"
+"                     and. The user operand is a decimal integer user ID.\n"
+"\n"
+"              ln source_file target_file\n"
+"                     The ln and symlink commands create a symbolic link at the\n"
+, stdout);
+ fputs(
+"                     target_file  location  pointing  to the source_file loca-\n"
+"                     tion.\n"
+"\n"
+"              mkdir directory_name\n"
+"                     The mkdir command creates the directory named by the  di-\n"
+"                     rectory_name operand.\n"
+"\n"
+"              pwd    The pwd command returns the absolute pathname of the cur-\n"
+"                     rent working directory.\n"
+"\n"
+"              rename source target\n"
+, stdout);
+ fputs(
+"                     The rename command renames the file or directory named by\n"
+"                     the  source  operand to the destination path named by the\n"
+"                     target operand.\n"
+"\n"
+"              rm file\n"
+"                     The rm command removes the file specified by the file op-\n"
+"                     erand.\n"
+"\n"
+"              rmdir directory\n"
+"                     The  rmdir  command removes the directory entry specified\n"
+, stdout);
+ fputs(
+"                     by the directory operand, provided it is empty.\n"
+"\n"
+"              symlink source_file target_file\n"
+"                     See ln.\n"
+"\n"
+"       --random-file <file>\n"
+"              Specify the path name to file containing what will be considered\n"
+"              as  random  data. The data may be used to seed the random engine\n"
+"              for SSL connections.  See also the --egd-file option.\n"
+"\n"
+"       -r, --range <range>\n"
+, stdout);
+ fputs(
+"              (HTTP FTP SFTP FILE) Retrieve a byte range (i.e. a partial docu-\n"
+"              ment)  from  an  HTTP/1.1,  FTP  or SFTP server or a local FILE.\n"
+"              Ranges can be specified in a number of ways.\n"
+"\n"
+"              0-499     specifies the first 500 bytes\n"
+"\n"
+"              500-999   specifies the second 500 bytes\n"
+"\n"
+"              -500      specifies the last 500 bytes\n"
+"\n"
+"              9500-     specifies the bytes from offset 9500 and forward\n"
+"\n"
+, stdout);
+ fputs(
+"              0-0,-1    specifies the first and last byte only(*)(HTTP)\n"
+"\n"
+"              100-199,500-599\n"
+"                        specifies two separate 100-byte ranges(*) (HTTP)\n"
+"\n"
+"              (*) = NOTE that this will cause the server to reply with a  mul-\n"
+"              tipart response!\n"
+"\n"
+"              Only  digit characters (0-9) are valid in the 'start' and 'stop'\n"
+"              fields of the 'start-stop' range syntax. If a non-digit  charac-\n"
+, stdout);
+ fputs(
+"              ter is given in the range, the server's response will be unspec-\n"
+"              ified, depending on the server's configuration.\n"
+"\n"
+"              You should also be aware that many HTTP/1.1 servers do not  have\n"
+"              this  feature  enabled, so that when you attempt to get a range,\n"
+"              you'll instead get the whole document.\n"
+"\n"
+"              FTP and SFTP range downloads only  support  the  simple  'start-\n"
+, stdout);
+ fputs(
+"              stop'  syntax  (optionally with one of the numbers omitted). FTP\n"
+"              use depends on the extended FTP command SIZE.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       --raw  (HTTP) When used, it disables all internal HTTP decoding of con-\n"
+"              tent  or transfer encodings and instead makes them passed on un-\n"
+"              altered, raw.\n"
+"\n"
+"              Added in 7.16.2.\n"
+"\n"
+"       -e, --referer <URL>\n"
+, stdout);
+ fputs(
+"              (HTTP) Sends the \"Referrer Page\" information to the HTTP server.\n"
+"              This can also be set with the -H, --header flag of course.  When\n"
+"              used with -L, --location you  can  append  \";auto\"  to  the  -e,\n"
+"              --referer  URL  to  make curl automatically set the previous URL\n"
+"              when it follows a Location: header. The \";auto\"  string  can  be\n"
+"              used alone, even if you don't set an initial -e, --referer.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              See also -A, --user-agent and -H, --header.\n"
+"\n"
+"       -J, --remote-header-name\n"
+"              (HTTP) This option tells the -O, --remote-name option to use the\n"
+"              server-specified Content-Disposition  filename  instead  of  ex-\n"
+"              tracting a filename from the URL.\n"
+"\n"
+"              If  the  server  specifies a file name and a file with that name\n"
+, stdout);
+ fputs(
+"              already exists in the current working directory it will  not  be\n"
+"              overwritten and an error will occur. If the server doesn't spec-\n"
+"              ify a file name then this option has no effect.\n"
+"\n"
+"              There's no attempt to decode %-sequences (yet) in  the  provided\n"
+"              file name, so this option may provide you with rather unexpected\n"
+"              file names.\n"
+"\n"
+"              WARNING: Exercise judicious use of this  option,  especially  on\n"
+, stdout);
+ fputs(
+"              Windows.  A  rogue  server  could  send you the name of a DLL or\n"
+"              other file that could possibly be loaded automatically  by  Win-\n"
+"              dows or some third party software.\n"
+"\n"
+"       --remote-name-all\n"
+"              This  option changes the default action for all given URLs to be\n"
+"              dealt with as if -O, --remote-name were used for each one. So if\n"
+"              you want to disable that for a specific URL after --remote-name-\n"
+, stdout);
+ fputs(
+"              all has been used, you must use \"-o -\" or --no-remote-name.\n"
+"\n"
+"              Added in 7.19.0.\n"
+"\n"
+"       -O, --remote-name\n"
+"              Write output to a local file named like the remote file we  get.\n"
+"              (Only  the file part of the remote file is used, the path is cut\n"
+"              off.)\n"
+"\n"
+"              The file will be saved in the current working directory. If  you\n"
+"              want  the  file  saved  in  a different directory, make sure you\n"
+, stdout);
+ fputs(
+"              change the current working directory before invoking  curl  with\n"
+"              this option.\n"
+"\n"
+"              The  remote  file  name  to use for saving is extracted from the\n"
+"              given URL, nothing else, and if it already  exists  it  will  be\n"
+"              overwritten.  If  you  want  the server to be able to choose the\n"
+"              file name refer to -J, --remote-header-name which can be used in\n"
+, stdout);
+ fputs(
+"              addition  to  this option. If the server chooses a file name and\n"
+"              that name already exists it will not be overwritten.\n"
+"\n"
+"              There is no URL decoding done on the file name. If it has %20 or\n"
+"              other  URL  encoded parts of the name, they will end up as-is as\n"
+"              file name.\n"
+"\n"
+"              You may use this option as many times as the number of URLs  you\n"
+"              have.\n"
+"\n"
+"       -R, --remote-time\n"
+, stdout);
+ fputs(
+"              When  used,  this will make curl attempt to figure out the time-\n"
+"              stamp of the remote file, and if that is available make the  lo-\n"
+"              cal file get that same timestamp.\n"
+"\n"
+"       --request-target\n"
+"              (HTTP)  Tells curl to use an alternative \"target\" (path) instead\n"
+"              of using the path as provided in the  URL.  Particularly  useful\n"
+"              when  wanting  to  issue  HTTP requests without leading slash or\n"
+, stdout);
+ fputs(
+"              other data that doesn't follow the  regular  URL  pattern,  like\n"
+"              \"OPTIONS *\".\n"
+"\n"
+"              Added in 7.55.0.\n"
+"\n"
+"       -X, --request <command>\n"
+"              (HTTP) Specifies a custom request method to use when communicat-\n"
+"              ing with the HTTP server.  The specified request method will  be\n"
+"              used  instead  of  the  method otherwise used (which defaults to\n"
+"              GET). Read the HTTP 1.1 specification for details  and  explana-\n"
+, stdout);
+ fputs(
+"              tions.  Common  additional HTTP requests include PUT and DELETE,\n"
+"              but related technologies like WebDAV offers PROPFIND, COPY, MOVE\n"
+"              and more.\n"
+"\n"
+"              Normally  you  don't  need  this option. All sorts of GET, HEAD,\n"
+"              POST and PUT requests are rather invoked by using dedicated com-\n"
+"              mand line options.\n"
+"\n"
+"              This  option  only  changes the actual word used in the HTTP re-\n"
+, stdout);
+ fputs(
+"              quest, it does not alter the way curl behaves. So for example if\n"
+"              you  want  to make a proper HEAD request, using -X HEAD will not\n"
+"              suffice. You need to use the -I, --head option.\n"
+"\n"
+"              The method string you set with -X, --request will  be  used  for\n"
+"              all  requests,  which  if you for example use -L, --location may\n"
+"              cause unintended side-effects when curl doesn't  change  request\n"
+, stdout);
+ fputs(
+"              method according to the HTTP 30x response codes - and similar.\n"
+"\n"
+"              (FTP) Specifies a custom FTP command to use instead of LIST when\n"
+"              doing file lists with FTP.\n"
+"\n"
+"              (POP3) Specifies a custom POP3 command to use instead of LIST or\n"
+"              RETR. (Added in 7.26.0)\n"
+"\n"
+"              (IMAP)  Specifies  a custom IMAP command to use instead of LIST.\n"
+"              (Added in 7.30.0)\n"
+"\n"
+, stdout);
+ fputs(
+"              (SMTP) Specifies a custom SMTP command to use instead of HELP or\n"
+"              VRFY. (Added in 7.34.0)\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       --resolve <host:port:address[,address]...>\n"
+"              Provide  a custom address for a specific host and port pair. Us-\n"
+"              ing this, you can make the curl requests(s) use a specified  ad-\n"
+"              dress  and prevent the otherwise normally resolved address to be\n"
+, stdout);
+ fputs(
+"              used. Consider it a sort of /etc/hosts alternative  provided  on\n"
+"              the  command line. The port number should be the number used for\n"
+"              the specific protocol the host will be used for.  It  means  you\n"
+"              need several entries if you want to provide address for the same\n"
+"              host but different ports.\n"
+"\n"
+"              By specifying '*' as host you can tell curl to resolve any  host\n"
+, stdout);
+ fputs(
+"              and specific port pair to the specified address. Wildcard is re-\n"
+"              solved last so any --resolve with a specific host and port  will\n"
+"              be used first.\n"
+"\n"
+"              The provided address set by this option will be used even if -4,\n"
+"              --ipv4 or -6, --ipv6 is set to make curl use another IP version.\n"
+"              Support for providing the IP address within [brackets] was added\n"
+"              in 7.57.0.\n"
+"\n"
+, stdout);
+ fputs(
+"              Support  for providing multiple IP addresses per entry was added\n"
+"              in 7.59.0.\n"
+"\n"
+"              Support for resolving with wildcard was added in 7.64.0.\n"
+"\n"
+"              This option can be used many times to add many host names to re-\n"
+"              solve.\n"
+"\n"
+"              Added in 7.21.3.\n"
+"\n"
+"       --retry-connrefused\n"
+"              In  addition to the other conditions, consider ECONNREFUSED as a\n"
+"              transient error too for --retry. This option  is  used  together\n"
+, stdout);
+ fputs(
+"              with --retry.\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       --retry-delay <seconds>\n"
+"              Make  curl  sleep  this  amount of time before each retry when a\n"
+"              transfer has failed with a transient error (it changes  the  de-\n"
+"              fault  backoff  time  algorithm between retries). This option is\n"
+"              only interesting if --retry is also used. Setting this delay  to\n"
+"              zero will make curl use the default backoff time.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.12.3.\n"
+"\n"
+"       --retry-max-time <seconds>\n"
+"              The  retry timer is reset before the first transfer attempt. Re-\n"
+"              tries will be done as usual (see --retry) as long as  the  timer\n"
+"              hasn't reached this given limit. Notice that if the timer hasn't\n"
+"              reached the limit, the request will be made and  while  perform-\n"
+, stdout);
+ fputs(
+"              ing,  it may take longer than this given time period. To limit a\n"
+"              single request's maximum time, use -m, --max-time.  Set this op-\n"
+"              tion to zero to not timeout retries.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.12.3.\n"
+"\n"
+"       --retry <num>\n"
+"              If  a  transient  error is returned when curl tries to perform a\n"
+, stdout);
+ fputs(
+"              transfer, it will retry this number of times before  giving  up.\n"
+"              Setting  the  number to 0 makes curl do no retries (which is the\n"
+"              default). Transient error means either: a timeout,  an  FTP  4xx\n"
+"              response code or an HTTP 408 or 5xx response code.\n"
+"\n"
+"              When  curl  is about to retry a transfer, it will first wait one\n"
+"              second and then for all forthcoming retries it will  double  the\n"
+, stdout);
+ fputs(
+"              waiting  time until it reaches 10 minutes which then will be the\n"
+"              delay between the rest of the retries.  By  using  --retry-delay\n"
+"              you   disable  this  exponential  backoff  algorithm.  See  also\n"
+"              --retry-max-time to limit the total time allowed for retries.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.12.3.\n"
+"\n"
+"       --sasl-ir\n"
+, stdout);
+ fputs(
+"              Enable initial response in SASL authentication.\n"
+"\n"
+"              Added in 7.31.0.\n"
+"\n"
+"       --service-name <name>\n"
+"              This option allows you to change the service name for SPNEGO.\n"
+"\n"
+"              Examples:   --negotiate   --service-name   sockd    would    use\n"
+"              sockd/server-name.\n"
+"\n"
+"              Added in 7.43.0.\n"
+"       -S, --show-error\n"
+"              When used with -s, --silent, it makes curl show an error message\n"
+"              if it fails.\n"
+"       -s, --silent\n"
+, stdout);
+ fputs(
+"              Silent or quiet mode. Don't show progress meter  or  error  mes-\n"
+"              sages.   Makes  Curl mute. It will still output the data you ask\n"
+"              for, potentially even to the terminal/stdout unless you redirect\n"
+"              it.\n"
+"\n"
+"              Use  -S,  --show-error  in  addition  to  this option to disable\n"
+"              progress meter but still show error messages.\n"
+"\n"
+"              See also -v, --verbose and --stderr.\n"
+"\n"
+"       --socks4 <host[:port]>\n"
+, stdout);
+ fputs(
+"              Use the specified SOCKS4 proxy. If the port number is not speci-\n"
+"              fied, it is assumed at port 1080.\n"
+"\n"
+"              This  option  overrides any previous use of -x, --proxy, as they\n"
+"              are mutually exclusive.\n"
+"\n"
+"              Since 7.21.7, this option is superfluous since you can specify a\n"
+"              socks4 proxy with -x, --proxy using a socks4:// protocol prefix.\n"
+"              Since 7.52.0, --preproxy can be used to specify a SOCKS proxy at\n"
+, stdout);
+ fputs(
+"              the same time -x, --proxy is used with an HTTP/HTTPS  proxy.  In\n"
+"              such a case curl first connects to the SOCKS proxy and then con-\n"
+"              nects (through SOCKS) to the HTTP or HTTPS proxy.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.15.2.\n"
+"\n"
+"       --socks4a <host[:port]>\n"
+"              Use the specified SOCKS4a proxy. If the port number is not spec-\n"
+"              ified, it is assumed at port 1080.\n"
+"\n"
+, stdout);
+ fputs(
+"              This  option  overrides any previous use of -x, --proxy, as they\n"
+"              are mutually exclusive.\n"
+"\n"
+"              Since 7.21.7, this option is superfluous since you can specify a\n"
+"              socks4a  proxy with -x, --proxy using a socks4a:// protocol pre-\n"
+"              fix.\n"
+"\n"
+"              Since 7.52.0, --preproxy can be used to specify a SOCKS proxy at\n"
+"              the  same  time -x, --proxy is used with an HTTP/HTTPS proxy. In\n"
+, stdout);
+ fputs(
+"              such a case curl first connects to the SOCKS proxy and then con-\n"
+"              nects (through SOCKS) to the HTTP or HTTPS proxy.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.18.0.\n"
+"\n"
+"       --socks5-basic\n"
+"              Tells curl to use username/password authentication when connect-\n"
+"              ing to a SOCKS5 proxy.  The username/password authentication  is\n"
+, stdout);
+ fputs(
+"              enabled  by  default.   Use --socks5-gssapi to force GSS-API au-\n"
+"              thentication to SOCKS5 proxies.\n"
+"\n"
+"              Added in 7.55.0.\n"
+"\n"
+"       --socks5-gssapi-nec\n"
+"              As part of the GSS-API negotiation a protection mode is  negoti-\n"
+"              ated.  RFC  1961 says in section 4.3/4.4 it should be protected,\n"
+"              but the NEC  reference  implementation  does  not.   The  option\n"
+, stdout);
+ fputs(
+"              --socks5-gssapi-nec  allows the unprotected exchange of the pro-\n"
+"              tection mode negotiation.\n"
+"\n"
+"              Added in 7.19.4.\n"
+"\n"
+"       --socks5-gssapi-service <name>\n"
+"              The default service name for a socks server is rcmd/server-fqdn.\n"
+"              This option allows you to change it.\n"
+"\n"
+"              Examples:   --socks5  proxy-name  --socks5-gssapi-service  sockd\n"
+"              would use sockd/proxy-name --socks5 proxy-name  --socks5-gssapi-\n"
+, stdout);
+ fputs(
+"              service  sockd/real-name  would  use  sockd/real-name  for cases\n"
+"              where the proxy-name does not match the principal name.\n"
+"\n"
+"              Added in 7.19.4.\n"
+"\n"
+"       --socks5-gssapi\n"
+"              Tells curl to use GSS-API authentication when  connecting  to  a\n"
+"              SOCKS5  proxy.  The GSS-API authentication is enabled by default\n"
+"              (if curl is compiled with GSS-API support).  Use  --socks5-basic\n"
+, stdout);
+ fputs(
+"              to force username/password authentication to SOCKS5 proxies.\n"
+"\n"
+"              Added in 7.55.0.\n"
+"\n"
+"       --socks5-hostname <host[:port]>\n"
+"              Use  the  specified  SOCKS5 proxy (and let the proxy resolve the\n"
+"              host name). If the port number is not specified, it  is  assumed\n"
+"              at port 1080.\n"
+"\n"
+"              This  option  overrides any previous use of -x, --proxy, as they\n"
+"              are mutually exclusive.\n"
+"\n"
+, stdout);
+ fputs(
+"              Since 7.21.7, this option is superfluous since you can specify a\n"
+"              socks5 hostname proxy with -x, --proxy using a socks5h:// proto-\n"
+"              col prefix.\n"
+"\n"
+"              Since 7.52.0, --preproxy can be used to specify a SOCKS proxy at\n"
+"              the  same  time -x, --proxy is used with an HTTP/HTTPS proxy. In\n"
+"              such a case curl first connects to the SOCKS proxy and then con-\n"
+"              nects (through SOCKS) to the HTTP or HTTPS proxy.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.18.0.\n"
+"\n"
+"       --socks5 <host[:port]>\n"
+"              Use  the  specified SOCKS5 proxy - but resolve the host name lo-\n"
+"              cally. If the port number is not specified,  it  is  assumed  at\n"
+"              port 1080.\n"
+"\n"
+"              This  option  overrides any previous use of -x, --proxy, as they\n"
+"              are mutually exclusive.\n"
+"\n"
+, stdout);
+ fputs(
+"              Since 7.21.7, this option is superfluous since you can specify a\n"
+"              socks5 proxy with -x, --proxy using a socks5:// protocol prefix.\n"
+"              Since 7.52.0, --preproxy can be used to specify a SOCKS proxy at\n"
+"              the same time -x, --proxy is used with an HTTP/HTTPS  proxy.  In\n"
+"              such a case curl first connects to the SOCKS proxy and then con-\n"
+"              nects (through SOCKS) to the HTTP or HTTPS proxy.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is used several times, the last one will be used.\n"
+"              This option (as well as --socks4) does not work with IPV6,  FTPS\n"
+"              or LDAP.\n"
+"\n"
+"              Added in 7.18.0.\n"
+"\n"
+"       -Y, --speed-limit <speed>\n"
+"              If a download is slower than this given speed (in bytes per sec-\n"
+"              ond) for speed-time seconds it gets aborted. speed-time  is  set\n"
+"              with -y, --speed-time and is 30 if not set.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       -y, --speed-time <seconds>\n"
+"              If a download is slower than speed-limit bytes per second during\n"
+"              a speed-time period, the download gets aborted. If speed-time is\n"
+"              used,  the  default  speed-limit  will  be 1 unless set with -Y,\n"
+"              --speed-limit.\n"
+"\n"
+"              This option controls transfers and thus  will  not  affect  slow\n"
+, stdout);
+ fputs(
+"              connects  etc.  If this is a concern for you, try the --connect-\n"
+"              timeout option.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       --ssl-allow-beast\n"
+"              This option tells curl to not work around a security flaw in the\n"
+"              SSL3  and TLS1.0 protocols known as BEAST.  If this option isn't\n"
+"              used, the SSL layer may use workarounds known to cause  interop-\n"
+, stdout);
+ fputs(
+"              erability problems with some older SSL implementations. WARNING:\n"
+"              this option loosens the SSL security, and by using this flag you\n"
+"              ask for exactly that.\n"
+"\n"
+"              Added in 7.25.0.\n"
+"\n"
+"       --ssl-no-revoke\n"
+"              (Schannel) This option tells curl to disable certificate revoca-\n"
+"              tion checks.  WARNING: this option loosens the SSL security, and\n"
+"              by using this flag you ask for exactly that.\n"
+"\n"
+"              Added in 7.44.0.\n"
+"\n"
+, stdout);
+ fputs(
+"       --ssl-reqd\n"
+"              (FTP IMAP POP3 SMTP) Require SSL/TLS for the connection.  Termi-\n"
+"              nates the connection if the server doesn't support SSL/TLS.\n"
+"\n"
+"              This option was formerly known as --ftp-ssl-reqd.\n"
+"\n"
+"              Added in 7.20.0.\n"
+"\n"
+"       --ssl  (FTP IMAP POP3 SMTP) Try to use SSL/TLS for the connection.  Re-\n"
+"              verts  to  a non-secure connection if the server doesn't support\n"
+, stdout);
+ fputs(
+"              SSL/TLS.  See also --ftp-ssl-control and --ssl-reqd for  differ-\n"
+"              ent levels of encryption required.\n"
+"\n"
+"              This  option  was formerly known as --ftp-ssl (Added in 7.11.0).\n"
+"              That option name can still be used but will be removed in a  fu-\n"
+"              ture version.\n"
+"\n"
+"              Added in 7.20.0.\n"
+"\n"
+"       -2, --sslv2\n"
+"              (SSL)  Forces  curl to use SSL version 2 when negotiating with a\n"
+, stdout);
+ fputs(
+"              remote SSL server. Sometimes curl is built  without  SSLv2  sup-\n"
+"              port. SSLv2 is widely considered insecure (see RFC 6176).\n"
+"\n"
+"              See  also  --http1.1  and --http2. -2, --sslv2 requires that the\n"
+"              underlying libcurl was built to support TLS. This  option  over-\n"
+"              rides -3, --sslv3 and -1, --tlsv1 and --tlsv1.1 and --tlsv1.2.\n"
+"\n"
+"       -3, --sslv3\n"
+"              (SSL)  Forces  curl to use SSL version 3 when negotiating with a\n"
+, stdout);
+ fputs(
+"              remote SSL server. Sometimes curl is built  without  SSLv3  sup-\n"
+"              port. SSLv3 is widely considered insecure (see RFC 7568).\n"
+"\n"
+"              See  also  --http1.1  and --http2. -3, --sslv3 requires that the\n"
+"              underlying libcurl was built to support TLS. This  option  over-\n"
+"              rides -2, --sslv2 and -1, --tlsv1 and --tlsv1.1 and --tlsv1.2.\n"
+"\n"
+"       --stderr\n"
+"              Redirect  all writes to stderr to the specified file instead. If\n"
+, stdout);
+ fputs(
+"              the file name is a plain '-', it is instead written to stdout.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              See also -v, --verbose and -s, --silent.\n"
+"\n"
+"       --styled-output\n"
+"              Enables the automatic use of bold font styles when writing  HTTP\n"
+"              headers  to  the terminal. Use --no-styled-output to switch them\n"
+"              off.\n"
+"\n"
+"              Added in 7.61.0.\n"
+"\n"
+"       --suppress-connect-headers\n"
+, stdout);
+ fputs(
+"              When -p, --proxytunnel is used and a  CONNECT  request  is  made\n"
+"              don't  output  proxy  CONNECT  response  headers. This option is\n"
+"              meant to be used with -D, --dump-header or -i,  --include  which\n"
+"              are  used  to show protocol headers in the output. It has no ef-\n"
+"              fect on debug options such as -v, --verbose or --trace,  or  any\n"
+"              statistics.\n"
+"\n"
+, stdout);
+ fputs(
+"              See also -D, --dump-header and -i, --include and -p, --proxytun-\n"
+"              nel.\n"
+"\n"
+"       --tcp-fastopen\n"
+"              Enable use of TCP Fast Open (RFC7413).\n"
+"\n"
+"              Added in 7.49.0.\n"
+"\n"
+"       --tcp-nodelay\n"
+"              Turn on the TCP_NODELAY option. See the curl_easy_setopt(3)  man\n"
+"              page for details about this option.\n"
+"\n"
+"              Since  7.50.2,  curl sets this option by default and you need to\n"
+, stdout);
+ fputs(
+"              explicitly switch it off if you don't want it on.\n"
+"\n"
+"              Added in 7.11.2.\n"
+"\n"
+"       -t, --telnet-option <opt=val>\n"
+"              Pass options to the telnet protocol. Supported options are:\n"
+"\n"
+"              TTYPE=<term> Sets the terminal type.\n"
+"\n"
+"              XDISPLOC=<X display> Sets the X display location.\n"
+"\n"
+"              NEW_ENV=<var,val> Sets an environment variable.\n"
+"\n"
+"       --tftp-blksize <value>\n"
+"              (TFTP) Set TFTP BLKSIZE option (must be >512). This is the block\n"
+, stdout);
+ fputs(
+"              size that curl will try to use when transferring data to or from\n"
+"              a TFTP server. By default 512 bytes will be used.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              Added in 7.20.0.\n"
+"\n"
+"       --tftp-no-options\n"
+"              (TFTP) Tells curl not to send TFTP options requests.\n"
+"\n"
+"              This option improves interop with some legacy  servers  that  do\n"
+, stdout);
+ fputs(
+"              not  acknowledge  or  properly implement TFTP options. When this\n"
+"              option is used --tftp-blksize is ignored.\n"
+"\n"
+"              Added in 7.48.0.\n"
+"\n"
+"       -z, --time-cond <time>\n"
+"              (HTTP FTP) Request a file that has been modified later than  the\n"
+"              given  time  and date, or one that has been modified before that\n"
+"              time. The <date expression> can be all sorts of date strings  or\n"
+, stdout);
+ fputs(
+"              if it doesn't match any internal ones, it is taken as a filename\n"
+"              and tries to get the modification date (mtime) from  <file>  in-\n"
+"              stead. See the curl_getdate(3) man pages for date expression de-\n"
+"              tails.\n"
+"\n"
+"              Start the date expression with a dash (-) to make it request for\n"
+"              a  document that is older than the given date/time, default is a\n"
+"              document that is newer than the specified date/time.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       --tls-max <VERSION>\n"
+"              (SSL) VERSION defines maximum supported TLS version. The minimum\n"
+"              acceptable  version  is  set  by  tlsv1.0,  tlsv1.1,  tlsv1.2 or\n"
+"              tlsv1.3.\n"
+"\n"
+"              default\n"
+"                     Use up to recommended TLS version.\n"
+"\n"
+"              1.0    Use up to TLSv1.0.\n"
+"              1.1    Use up to TLSv1.1.\n"
+"              1.2    Use up to TLSv1.2.\n"
+, stdout);
+ fputs(
+"              1.3    Use up to TLSv1.3.\n"
+"\n"
+"       See also --tlsv1.0 and --tlsv1.1 and --tlsv1.2 and --tlsv1.3. --tls-max\n"
+"       requires that the underlying libcurl was built to support TLS. Added in\n"
+"       7.54.0.\n"
+"\n"
+"       --tls13-ciphers <list of TLS 1.3 ciphersuites>\n"
+"              (TLS) Specifies which cipher suites to use in the connection  if\n"
+"              it  negotiates  TLS 1.3. The list of ciphers suites must specify\n"
+, stdout);
+ fputs(
+"              valid ciphers. Read up on TLS 1.3 cipher suite details  on  this\n"
+"              URL:\n"
+"\n"
+"               https://curl.haxx.se/docs/ssl-ciphers.html\n"
+"\n"
+"              This  option  is  currently  used only when curl is built to use\n"
+"              OpenSSL 1.1.1 or later. If you are using a different SSL backend\n"
+"              you can try setting TLS 1.3 cipher suites by using the --ciphers\n"
+"              option.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+, stdout);
+ fputs(
+"       --tlsauthtype <type>\n"
+"              Set TLS authentication type. Currently, the only  supported  op-\n"
+"              tion  is  \"SRP\",  for  TLS-SRP  (RFC  5054).  If  --tlsuser  and\n"
+"              --tlspassword are specified but --tlsauthtype is not, then  this\n"
+"              option  defaults to \"SRP\".  This option works only if the under-\n"
+"              lying libcurl is built  with  TLS-SRP  support,  which  requires\n"
+"              OpenSSL or GnuTLS with TLS-SRP support.\n"
+"\n"
+, stdout);
+ fputs(
+"              Added in 7.21.4.\n"
+"\n"
+"       --tlspassword\n"
+"              Set  password  for use with the TLS authentication method speci-\n"
+"              fied with --tlsauthtype. Requires that --tlsuser also be set.\n"
+"\n"
+"              Added in 7.21.4.\n"
+"       --tlsuser <name>\n"
+"              Set username for use with the TLS authentication  method  speci-\n"
+"              fied  with  --tlsauthtype.  Requires  that --tlspassword also is\n"
+"              set.\n"
+"\n"
+"              Added in 7.21.4.\n"
+"\n"
+"       --tlsv1.0\n"
+, stdout);
+ fputs(
+"              (TLS) Forces curl to use TLS version 1.0 or later when  connect-\n"
+"              ing to a remote TLS server.\n"
+"\n"
+"              In  old  versions  of  curl  this option was documented to allow\n"
+"              _only_ TLS 1.0, but behavior was inconsistent depending  on  the\n"
+"              TLS library. Use --tls-max if you want to set a maximum TLS ver-\n"
+"              sion.\n"
+"\n"
+"              Added in 7.34.0.\n"
+"\n"
+"       --tlsv1.1\n"
+, stdout);
+ fputs(
+"              (TLS) Forces curl to use TLS version 1.1 or later when  connect-\n"
+"              ing to a remote TLS server.\n"
+"\n"
+"              In  old  versions  of  curl  this option was documented to allow\n"
+"              _only_ TLS 1.1, but behavior was inconsistent depending  on  the\n"
+"              TLS library. Use --tls-max if you want to set a maximum TLS ver-\n"
+"              sion.\n"
+"\n"
+"              Added in 7.34.0.\n"
+"\n"
+"       --tlsv1.2\n"
+, stdout);
+ fputs(
+"              (TLS) Forces curl to use TLS version 1.2 or later when  connect-\n"
+"              ing to a remote TLS server.\n"
+"\n"
+"              In  old  versions  of  curl  this option was documented to allow\n"
+"              _only_ TLS 1.2, but behavior was inconsistent depending  on  the\n"
+"              TLS library. Use --tls-max if you want to set a maximum TLS ver-\n"
+"              sion.\n"
+"\n"
+"              Added in 7.34.0.\n"
+"\n"
+"       --tlsv1.3\n"
+, stdout);
+ fputs(
+"              (TLS) Forces curl to use TLS version 1.3 or later when  connect-\n"
+"              ing to a remote TLS server.\n"
+"\n"
+"              Note that TLS 1.3 is only supported by a subset of TLS backends.\n"
+"              At the time of this writing, they are BoringSSL, NSS, and Secure\n"
+"              Transport (on iOS 11 or later, and macOS 10.13 or later).\n"
+"\n"
+"              Added in 7.52.0.\n"
+"\n"
+"       -1, --tlsv1\n"
+"              (SSL)  Tells curl to use at least TLS version 1.x when negotiat-\n"
+, stdout);
+ fputs(
+"              ing with a remote TLS server. That  means  TLS  version  1.0  or\n"
+"              higher\n"
+"\n"
+"              See  also  --http1.1  and --http2. -1, --tlsv1 requires that the\n"
+"              underlying libcurl was built to support TLS. This  option  over-\n"
+"              rides --tlsv1.1 and --tlsv1.2 and --tlsv1.3.\n"
+"\n"
+"       --tr-encoding\n"
+"              (HTTP) Request a compressed Transfer-Encoding response using one\n"
+"              of the algorithms curl supports, and uncompress the  data  while\n"
+, stdout);
+ fputs(
+"              receiving it.\n"
+"\n"
+"              Added in 7.21.6.\n"
+"\n"
+"       --trace-ascii <file>\n"
+"              Enables a full trace dump of all incoming and outgoing data, in-\n"
+"              cluding descriptive information, to the given output  file.  Use\n"
+"              \"-\" as filename to have the output sent to stdout.\n"
+"\n"
+"              This is very similar to --trace, but leaves out the hex part and\n"
+"              only shows the ASCII part of the dump. It makes  smaller  output\n"
+, stdout);
+ fputs(
+"              that might be easier to read for untrained humans.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              This option overrides --trace and -v, --verbose.\n"
+"\n"
+"       --trace-time\n"
+"              Prepends  a  time  stamp to each trace or verbose line that curl\n"
+"              displays.\n"
+"\n"
+"              Added in 7.14.0.\n"
+"\n"
+"       --trace <file>\n"
+"              Enables a full trace dump of all incoming and outgoing data, in-\n"
+, stdout);
+ fputs(
+"              cluding  descriptive  information, to the given output file. Use\n"
+"              \"-\" as filename to have the output sent to stdout.  Use  \"%\"  as\n"
+"              filename to have the output sent to stderr.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"              This option overrides -v, --verbose and --trace-ascii.\n"
+"\n"
+"       --unix-socket <path>\n"
+"              (HTTP) Connect through this Unix domain socket, instead of using\n"
+, stdout);
+ fputs(
+"              the network.\n"
+"\n"
+"              Added in 7.40.0.\n"
+"\n"
+"       -T, --upload-file <file>\n"
+"              This transfers the specified local file to the  remote  URL.  If\n"
+"              there is no file part in the specified URL, curl will append the\n"
+"              local file name. NOTE that you must use a trailing / on the last\n"
+"              directory  to really prove to Curl that there is no file name or\n"
+"              curl will think that your last directory name is the remote file\n"
+, stdout);
+ fputs(
+"              name to use. That will most likely cause the upload operation to\n"
+"              fail. If this is used on an HTTP(S) server, the PUT command will\n"
+"              be used.\n"
+"\n"
+"              Use  the file name \"-\" (a single dash) to use stdin instead of a\n"
+"              given file.  Alternately, the file name \".\"  (a  single  period)\n"
+"              may  be  specified  instead  of \"-\" to use stdin in non-blocking\n"
+"              mode to allow reading server output while  stdin  is  being  up-\n"
+, stdout);
+ fputs(
+"              loaded.\n"
+"\n"
+"              You  can  specify one -T, --upload-file for each URL on the com-\n"
+"              mand line. Each -T, --upload-file + URL pair specifies  what  to\n"
+"              upload  and  to  where. curl also supports \"globbing\" of the -T,\n"
+"              --upload-file argument, meaning that  you  can  upload  multiple\n"
+"              files  to a single URL by using the same URL globbing style sup-\n"
+"              ported in the URL, like this:\n"
+"\n"
+, stdout);
+ fputs(
+"               curl --upload-file \"{file1,file2}\" http://www.example.com\n"
+"\n"
+"              or even\n"
+"\n"
+"               curl -T \"img[1-1000].png\" ftp://ftp.example.com/upload/\n"
+"\n"
+"              When uploading to an SMTP server: the uploaded data  is  assumed\n"
+"              to be RFC 5322 formatted. It has to feature the necessary set of\n"
+"              headers and mail body formatted correctly by the  user  as  curl\n"
+"              will not transcode nor encode it further in any way.\n"
+"\n"
+"       --url <url>\n"
+, stdout);
+ fputs(
+"              Specify  a  URL  to  fetch. This option is mostly handy when you\n"
+"              want to specify URL(s) in a config file.\n"
+"\n"
+"              If the given URL is missing a scheme name (such as \"http://\"  or\n"
+"              \"ftp://\"  etc) then curl will make a guess based on the host. If\n"
+"              the outermost sub-domain name matches  DICT,  FTP,  IMAP,  LDAP,\n"
+"              POP3  or  SMTP  then  that protocol will be used, otherwise HTTP\n"
+, stdout);
+ fputs(
+"              will be used. Since 7.45.0 guessing can be disabled by setting a\n"
+"              default protocol, see --proto-default for details.\n"
+"\n"
+"              This  option  may  be used any number of times. To control where\n"
+"              this URL is written, use the -o, --output or the  -O,  --remote-\n"
+"              name options.\n"
+"\n"
+"       -B, --use-ascii\n"
+"              (FTP  LDAP) Enable ASCII transfer. For FTP, this can also be en-\n"
+, stdout);
+ fputs(
+"              forced by using a URL that  ends  with  \";type=A\".  This  option\n"
+"              causes data sent to stdout to be in text mode for win32 systems.\n"
+"\n"
+"       -A, --user-agent <name>\n"
+"              (HTTP) Specify the User-Agent string to send to the HTTP server.\n"
+"              To encode blanks in the string, surround the string with  single\n"
+"              quote  marks.  This header can also be set with the -H, --header\n"
+"              or the --proxy-header options.\n"
+"\n"
+, stdout);
+ fputs(
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       -u, --user <user:password>\n"
+"              Specify the user name and password to use for server authentica-\n"
+"              tion. Overrides -n, --netrc and --netrc-optional.\n"
+"\n"
+"              If  you  simply  specify  the  user name, curl will prompt for a\n"
+"              password.\n"
+"\n"
+"              The user name and passwords are split up  on  the  first  colon,\n"
+, stdout);
+ fputs(
+"              which  makes  it impossible to use a colon in the user name with\n"
+"              this option. The password can, still.\n"
+"\n"
+"              On systems where it works, curl will hide the given option argu-\n"
+"              ment  from  process listings. This is not enough to protect cre-\n"
+"              dentials from possibly getting seen by other users on  the  same\n"
+"              system  as  they will still be visible for a brief moment before\n"
+, stdout);
+ fputs(
+"              cleared. Such sensitive data should be retrieved from a file in-\n"
+"              stead or similar and never used in clear text in a command line.\n"
+"              When  using  Kerberos  V5 with a Windows based server you should\n"
+"              include the Windows domain name in the user name, in  order  for\n"
+"              the  server  to  successfully  obtain  a Kerberos Ticket. If you\n"
+"              don't then the initial authentication handshake may fail.\n"
+"\n"
+, stdout);
+ fputs(
+"              When using NTLM, the user name can be specified  simply  as  the\n"
+"              user  name,  without the domain, if there is a single domain and\n"
+"              forest in your setup for example.\n"
+"\n"
+"              To specify the domain name use either Down-Level Logon  Name  or\n"
+"              UPN (User Principal Name) formats. For example, EXAMPLE\\user and\n"
+"              user@example.com respectively.\n"
+"\n"
+"              If you use a Windows SSPI-enabled curl binary and  perform  Ker-\n"
+, stdout);
+ fputs(
+"              beros  V5, Negotiate, NTLM or Digest authentication then you can\n"
+"              tell curl to select the user name and password from  your  envi-\n"
+"              ronment by specifying a single colon with this option: \"-u :\".\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       -v, --verbose\n"
+"              Makes  curl  verbose  during the operation. Useful for debugging\n"
+"              and seeing what's going on \"under the  hood\".  A  line  starting\n"
+, stdout);
+ fputs(
+"              with  '>'  means  \"header  data\" sent by curl, '<' means \"header\n"
+"              data\" received by curl that is hidden in  normal  cases,  and  a\n"
+"              line starting with '*' means additional info provided by curl.\n"
+"\n"
+"              If you only want HTTP headers in the output, -i, --include might\n"
+"              be the option you're looking for.\n"
+"\n"
+"              If you think this option still doesn't give you enough  details,\n"
+, stdout);
+ fputs(
+"              consider using --trace or --trace-ascii instead.\n"
+"\n"
+"              Use -s, --silent to make curl really quiet.\n"
+"\n"
+"              See  also  -i,  --include.  This  option  overrides  --trace and\n"
+"              --trace-ascii.\n"
+"\n"
+"       -V, --version\n"
+"              Displays information about curl and the libcurl version it uses.\n"
+"              The first line includes the full version of  curl,  libcurl  and\n"
+"              other 3rd party libraries linked with the executable.\n"
+"\n"
+, stdout);
+ fputs(
+"              The  second  line (starts with \"Protocols:\") shows all protocols\n"
+"              that libcurl reports to support.\n"
+"\n"
+"              The third line (starts with \"Features:\") shows specific features\n"
+"              libcurl reports to offer. Available features include:\n"
+"\n"
+"              IPv6   You can use IPv6 with this.\n"
+"\n"
+"              krb4   Krb4 for FTP is supported.\n"
+"\n"
+"              SSL    SSL  versions of various protocols are supported, such as\n"
+, stdout);
+ fputs(
+"                     HTTPS, FTPS, POP3S and so on.\n"
+"\n"
+"              libz   Automatic decompression of compressed files over HTTP  is\n"
+"                     supported.\n"
+"\n"
+"              NTLM   NTLM authentication is supported.\n"
+"\n"
+"              Debug  This  curl  uses a libcurl built with Debug. This enables\n"
+"                     more error-tracking and memory debugging etc.  For  curl-\n"
+"                     developers only!\n"
+"\n"
+"              AsynchDNS\n"
+, stdout);
+ fputs(
+"                     This  curl  uses asynchronous name resolves. Asynchronous\n"
+"                     name resolves can be done using either the c-ares or  the\n"
+"                     threaded resolver backends.\n"
+"\n"
+"              SPNEGO SPNEGO authentication is supported.\n"
+"\n"
+"              Largefile\n"
+"                     This curl supports transfers of large files, files larger\n"
+"                     than 2GB.\n"
+"\n"
+"              IDN    This curl supports IDN - international domain names.\n"
+"\n"
+"              GSS-API\n"
+, stdout);
+ fputs(
+"                     GSS-API is supported.\n"
+"\n"
+"              SSPI   SSPI is supported.\n"
+"\n"
+"              TLS-SRP\n"
+"                     SRP (Secure Remote Password) authentication is  supported\n"
+"                     for TLS.\n"
+"\n"
+"              HTTP2  HTTP/2 support has been built-in.\n"
+"\n"
+"              UnixSockets\n"
+"                     Unix sockets support is provided.\n"
+"\n"
+"              HTTPS-proxy\n"
+"                     This curl is built to support HTTPS proxy.\n"
+"\n"
+"              Metalink\n"
+, stdout);
+ fputs(
+"                     This  curl  supports  Metalink (both version 3 and 4 (RFC\n"
+"                     5854)), which describes mirrors and  hashes.   curl  will\n"
+"                     use mirrors for failover if there are errors (such as the\n"
+"                     file or server not being available).\n"
+"\n"
+"              PSL    PSL is short for Public Suffix List and means  that  this\n"
+"                     curl  has  been  built  with knowledge about \"public suf-\n"
+"                     fixes\".\n"
+"\n"
+, stdout);
+ fputs(
+"              MultiSSL\n"
+"                     This curl supports multiple TLS backends.\n"
+"\n"
+"       -w, --write-out <format>\n"
+"              Make curl display information on stdout after a completed trans-\n"
+"              fer.  The  format  is a string that may contain plain text mixed\n"
+"              with any number of variables. The format can be specified  as  a\n"
+"              literal  \"string\",  or  you can have curl read the format from a\n"
+, stdout);
+ fputs(
+"              file with \"@filename\" and to tell curl to read the  format  from\n"
+"              stdin you write \"@-\".\n"
+"\n"
+"              The  variables  present in the output format will be substituted\n"
+"              by the value or text that curl thinks fit, as  described  below.\n"
+"              All  variables are specified as %{variable_name} and to output a\n"
+"              normal % you just write them as %%. You can output a newline  by\n"
+, stdout);
+ fputs(
+"              using \\n, a carriage return with \\r and a tab space with \\t.\n"
+"\n"
+"              The  output  will be written to standard output, but this can be\n"
+"              switched to standard error by using %{stderr}.\n"
+"\n"
+"              NOTE: The %-symbol is a special symbol in the win32-environment,\n"
+"              where  all  occurrences of % must be doubled when using this op-\n"
+"              tion.\n"
+"\n"
+"              The variables available are:\n"
+"\n"
+, stdout);
+ fputs(
+"              content_type   The Content-Type of the  requested  document,  if\n"
+"                             there was any.\n"
+"\n"
+"              filename_effective\n"
+"                             The  ultimate  filename  that curl writes out to.\n"
+"                             This is only meaningful if curl is told to  write\n"
+"                             to  a  file  with  the  -O,  --remote-name or -o,\n"
+"                             --output option. It's most useful in  combination\n"
+, stdout);
+ fputs(
+"                             with  the -J, --remote-header-name option. (Added\n"
+"                             in 7.26.0)\n"
+"\n"
+"              ftp_entry_path The initial path curl ended up in when logging on\n"
+"                             to the remote FTP server. (Added in 7.15.4)\n"
+"\n"
+"              http_code      The numerical response code that was found in the\n"
+"                             last retrieved HTTP(S)  or  FTP(s)  transfer.  In\n"
+, stdout);
+ fputs(
+"                             7.18.2  the alias response_code was added to show\n"
+"                             the same info.\n"
+"\n"
+"              http_connect   The numerical code that was found in the last re-\n"
+"                             sponse  (from a proxy) to a curl CONNECT request.\n"
+"                             (Added in 7.12.4)\n"
+"\n"
+"              http_version   The  http  version  that  was  effectively  used.\n"
+"                             (Added in 7.50.0)\n"
+"\n"
+, stdout);
+ fputs(
+"              local_ip       The  IP  address of the local end of the most re-\n"
+"                             cently done connection - can be  either  IPv4  or\n"
+"                             IPv6 (Added in 7.29.0)\n"
+"\n"
+"              local_port     The  local  port number of the most recently done\n"
+"                             connection (Added in 7.29.0)\n"
+"\n"
+"              num_connects   Number of new connects made in the recent  trans-\n"
+"                             fer. (Added in 7.12.3)\n"
+"\n"
+, stdout);
+ fputs(
+"              num_redirects  Number of redirects that were followed in the re-\n"
+"                             quest. (Added in 7.12.3)\n"
+"\n"
+"              proxy_ssl_verify_result\n"
+"                             The result of the HTTPS proxy's SSL peer certifi-\n"
+"                             cate verification that was requested. 0 means the\n"
+"                             verification was successful. (Added in 7.52.0)\n"
+"\n"
+"              redirect_url   When an HTTP request was made without -L, --loca-\n"
+, stdout);
+ fputs(
+"                             tion  to follow redirects (or when --max-redir is\n"
+"                             met), this variable will show the  actual  URL  a\n"
+"                             redirect would have gone to. (Added in 7.18.2)\n"
+"\n"
+"              remote_ip      The  remote  IP address of the most recently done\n"
+"                             connection - can be either IPv4 or IPv6 (Added in\n"
+"                             7.29.0)\n"
+"\n"
+, stdout);
+ fputs(
+"              remote_port    The  remote port number of the most recently done\n"
+"                             connection (Added in 7.29.0)\n"
+"\n"
+"              scheme         The URL scheme (sometimes called  protocol)  that\n"
+"                             was effectively used (Added in 7.52.0)\n"
+"\n"
+"              size_download  The total amount of bytes that were downloaded.\n"
+"\n"
+"              size_header    The total amount of bytes of the downloaded head-\n"
+"                             ers.\n"
+"\n"
+, stdout);
+ fputs(
+"              size_request   The total amount of bytes that were sent  in  the\n"
+"                             HTTP request.\n"
+"\n"
+"              size_upload    The total amount of bytes that were uploaded.\n"
+"\n"
+"              speed_download The average download speed that curl measured for\n"
+"                             the complete download. Bytes per second.\n"
+"\n"
+"              speed_upload   The average upload speed that curl  measured  for\n"
+"                             the complete upload. Bytes per second.\n"
+"\n"
+, stdout);
+ fputs(
+"              ssl_verify_result\n"
+"                             The  result of the SSL peer certificate verifica-\n"
+"                             tion that was requested. 0 means the verification\n"
+"                             was successful. (Added in 7.19.0)\n"
+"\n"
+"              stderr         From  this  point  on, the -w, --write-out output\n"
+"                             will be written  to  standard  error.  (Added  in\n"
+"                             7.63.0)\n"
+"\n"
+, stdout);
+ fputs(
+"              stdout         From  this  point  on, the -w, --write-out output\n"
+"                             will be written to standard output.  This is  the\n"
+"                             default,  but  can  be  used to switch back after\n"
+"                             switching to stderr.  (Added in 7.63.0)\n"
+"\n"
+"              time_appconnect\n"
+"                             The time, in seconds, it took from the start  un-\n"
+"                             til  the SSL/SSH/etc connect/handshake to the re-\n"
+, stdout);
+ fputs(
+"                             mote host was completed. (Added in 7.19.0)\n"
+"\n"
+"              time_connect   The time, in seconds, it took from the start  un-\n"
+"                             til the TCP connect to the remote host (or proxy)\n"
+"                             was completed.\n"
+"\n"
+"              time_namelookup\n"
+"                             The time, in seconds, it took from the start  un-\n"
+"                             til the name resolving was completed.\n"
+"\n"
+"              time_pretransfer\n"
+, stdout);
+ fputs(
+"                             The  time, in seconds, it took from the start un-\n"
+"                             til the file transfer was just  about  to  begin.\n"
+"                             This includes all pre-transfer commands and nego-\n"
+"                             tiations that are specific to the particular pro-\n"
+"                             tocol(s) involved.\n"
+"\n"
+"              time_redirect  The time, in seconds, it took for all redirection\n"
+, stdout);
+ fputs(
+"                             steps including name lookup, connect, pretransfer\n"
+"                             and  transfer  before  the  final transaction was\n"
+"                             started. time_redirect shows the complete  execu-\n"
+"                             tion  time  for  multiple redirections. (Added in\n"
+"                             7.12.3)\n"
+"\n"
+"              time_starttransfer\n"
+"                             The time, in seconds, it took from the start  un-\n"
+, stdout);
+ fputs(
+"                             til  the  first  byte was just about to be trans-\n"
+"                             ferred. This includes time_pretransfer  and  also\n"
+"                             the  time  the server needed to calculate the re-\n"
+"                             sult.\n"
+"\n"
+"              time_total     The total time, in seconds, that the full  opera-\n"
+"                             tion lasted.\n"
+"\n"
+"              url_effective  The URL that was fetched last. This is most mean-\n"
+, stdout);
+ fputs(
+"                             ingful if you've told curl  to  follow  location:\n"
+"                             headers.\n"
+"\n"
+"              If this option is used several times, the last one will be used.\n"
+"\n"
+"       --xattr\n"
+"              When  saving  output  to a file, this option tells curl to store\n"
+"              certain file metadata in extended  file  attributes.  Currently,\n"
+"              the URL is stored in the xdg.origin.url attribute and, for HTTP,\n"
+, stdout);
+ fputs(
+"              the content type is stored in the mime_type  attribute.  If  the\n"
+"              file  system  does not support extended attributes, a warning is\n"
+"              issued.\n"
+"\n"
+"FILES\n"
+"       ~/.curlrc\n"
+"              Default config file, see -K, --config for details.\n"
+"\n"
+"ENVIRONMENT\n"
+"       The environment variables can be specified in lower case or upper case.\n"
+"       The lower case version has precedence. http_proxy is an exception as it\n"
+"       is only available in lower case.\n"
+"\n"
+, stdout);
+ fputs(
+"       Using an environment variable to set the proxy has the same  effect  as\n"
+"       using the -x, --proxy option.\n"
+"\n"
+"       http_proxy [protocol://]<host>[:port]\n"
+"              Sets the proxy server to use for HTTP.\n"
+"       HTTPS_PROXY [protocol://]<host>[:port]\n"
+"              Sets the proxy server to use for HTTPS.\n"
+"\n"
+"       [url-protocol]_PROXY [protocol://]<host>[:port]\n"
+"              Sets  the proxy server to use for [url-protocol], where the pro-\n"
+, stdout);
+ fputs(
+"              tocol is a protocol that curl supports and  as  specified  in  a\n"
+"              URL. FTP, FTPS, POP3, IMAP, SMTP, LDAP etc.\n"
+"\n"
+"       ALL_PROXY [protocol://]<host>[:port]\n"
+"              Sets  the  proxy  server to use if no protocol-specific proxy is\n"
+"              set.\n"
+"\n"
+"       NO_PROXY <comma-separated list of hosts/domains>\n"
+"              list of host names that shouldn't go through any proxy.  If  set\n"
+"              to an asterisk '*' only, it matches all hosts. Each name in this\n"
+, stdout);
+ fputs(
+"              list is matched as either a domain name which contains the host-\n"
+"              name, or the hostname itself.\n"
+"\n"
+"              This  environment  variable  disables use of the proxy even when\n"
+"              specified with the -x,  --proxy  option.  That  is  NO_PROXY=di-\n"
+"              rect.example.com  curl  -x  http://proxy.example.com  http://di-\n"
+"              rect.example.com  accesses  the   target   URL   directly,   and\n"
+, stdout);
+ fputs(
+"              NO_PROXY=direct.example.com   curl  -x  http://proxy.example.com\n"
+"              http://somewhere.example.com accesses the target URL through the\n"
+"              proxy.\n"
+"\n"
+"              The  list  of  host  names  can also be include numerical IP ad-\n"
+"              dresses, and IPv6 versions should then be given without  enclos-\n"
+"              ing brackets.\n"
+"\n"
+"PROXY PROTOCOL PREFIXES\n"
+"       Since  curl  version  7.21.7,  the proxy string may be specified with a\n"
+, stdout);
+ fputs(
+"       protocol:// prefix to specify alternative proxy protocols.\n"
+"\n"
+"       If no protocol is specified in  the  proxy  string  or  if  the  string\n"
+"       doesn't  match  a  supported  one, the proxy will be treated as an HTTP\n"
+"       proxy.\n"
+"\n"
+"       The supported proxy protocol prefixes are as follows:\n"
+"\n"
+"       http://\n"
+"              Makes it use it as an HTTP proxy. The default if no scheme  pre-\n"
+"              fix is used.\n"
+"\n"
+"       https://\n"
+"              Makes it treated as an HTTPS proxy.\n"
+"\n"
+, stdout);
+ fputs(
+"       socks4://\n"
+"              Makes it the equivalent of --socks4\n"
+"\n"
+"       socks4a://\n"
+"              Makes it the equivalent of --socks4a\n"
+"\n"
+"       socks5://\n"
+"              Makes it the equivalent of --socks5\n"
+"\n"
+"       socks5h://\n"
+"              Makes it the equivalent of --socks5-hostname\n"
+"\n"
+"EXIT CODES\n"
+"       There  are a bunch of different error codes and their corresponding er-\n"
+"       ror messages that may appear during bad conditions. At the time of this\n"
+"       writing, the exit codes are:\n"
+"\n"
+, stdout);
+ fputs(
+"       1      Unsupported protocol. This build of curl has no support for this\n"
+"              protocol.\n"
+"\n"
+"       2      Failed to initialize.\n"
+"\n"
+"       3      URL malformed. The syntax was not correct.\n"
+"\n"
+"       4      A feature or option that was needed to perform the  desired  re-\n"
+"              quest  was not enabled or was explicitly disabled at build-time.\n"
+"              To make curl able to do this, you probably need another build of\n"
+"              libcurl!\n"
+"\n"
+, stdout);
+ fputs(
+"       5      Couldn't  resolve  proxy.  The given proxy host could not be re-\n"
+"              solved.\n"
+"\n"
+"       6      Couldn't resolve host. The given remote host was not resolved.\n"
+"\n"
+"       7      Failed to connect to host.\n"
+"\n"
+"       8      Weird server reply. The server sent data curl couldn't parse.\n"
+"\n"
+"       9      FTP access denied. The server denied login or denied  access  to\n"
+"              the  particular  resource or directory you wanted to reach. Most\n"
+, stdout);
+ fputs(
+"              often you tried to change to a directory that doesn't  exist  on\n"
+"              the server.\n"
+"\n"
+"       10     FTP  accept failed. While waiting for the server to connect back\n"
+"              when an active FTP session is used, an error code was sent  over\n"
+"              the control connection or similar.\n"
+"\n"
+"       11     FTP  weird PASS reply. Curl couldn't parse the reply sent to the\n"
+"              PASS request.\n"
+"\n"
+, stdout);
+ fputs(
+"       12     During an active FTP session while waiting  for  the  server  to\n"
+"              connect back to curl, the timeout expired.\n"
+"\n"
+"       13     FTP  weird PASV reply, Curl couldn't parse the reply sent to the\n"
+"              PASV request.\n"
+"\n"
+"       14     FTP weird 227 format.  Curl  couldn't  parse  the  227-line  the\n"
+"              server sent.\n"
+"\n"
+"       15     FTP  can't  get host. Couldn't resolve the host IP we got in the\n"
+"              227-line.\n"
+"\n"
+, stdout);
+ fputs(
+"       16     HTTP/2 error. A problem was detected in the HTTP2 framing layer.\n"
+"              This is somewhat generic and can be one out of several problems,\n"
+"              see the error message for details.\n"
+"\n"
+"       17     FTP couldn't set binary. Couldn't change transfer method to  bi-\n"
+"              nary.\n"
+"\n"
+"       18     Partial file. Only a part of the file was transferred.\n"
+"\n"
+"       19     FTP  couldn't download/access the given file, the RETR (or simi-\n"
+"              lar) command failed.\n"
+"\n"
+, stdout);
+ fputs(
+"       21     FTP quote error. A quote command returned error from the server.\n"
+"       22     HTTP page not retrieved. The requested url was not found or  re-\n"
+"              turned  another  error  with  the  HTTP  error code being 400 or\n"
+"              above. This return code only appears if -f, --fail is used.\n"
+"\n"
+"       23     Write error. Curl couldn't write data to a local  filesystem  or\n"
+"              similar.\n"
+"\n"
+"       25     FTP  couldn't  STOR  file. The server denied the STOR operation,\n"
+, stdout);
+ fputs(
+"              used for FTP uploading.\n"
+"\n"
+"       26     Read error. Various reading problems.\n"
+"\n"
+"       27     Out of memory. A memory allocation request failed.\n"
+"\n"
+"       28     Operation timeout. The specified time-out period was reached ac-\n"
+"              cording to the conditions.\n"
+"\n"
+"       30     FTP  PORT  failed.  The PORT command failed. Not all FTP servers\n"
+"              support the PORT command, try doing a transfer  using  PASV  in-\n"
+"              stead!\n"
+"\n"
+, stdout);
+ fputs(
+"       31     FTP  couldn't use REST. The REST command failed. This command is\n"
+"              used for resumed FTP transfers.\n"
+"\n"
+"       33     HTTP range error. The range \"command\" didn't work.\n"
+"\n"
+"       34     HTTP post error. Internal post-request generation error.\n"
+"\n"
+"       35     SSL connect error. The SSL handshaking failed.\n"
+"\n"
+"       36     Bad download resume. Couldn't continue an earlier aborted  down-\n"
+"              load.\n"
+"\n"
+, stdout);
+ fputs(
+"       37     FILE couldn't read file. Failed to open the file. Permissions?\n"
+"\n"
+"       38     LDAP cannot bind. LDAP bind operation failed.\n"
+"\n"
+"       39     LDAP search failed.\n"
+"\n"
+"       41     Function not found. A required LDAP function was not found.\n"
+"\n"
+"       42     Aborted by callback. An application told curl to abort the oper-\n"
+"              ation.\n"
+"\n"
+"       43     Internal error. A function was called with a bad parameter.\n"
+"\n"
+, stdout);
+ fputs(
+"       45     Interface error. A specified outgoing  interface  could  not  be\n"
+"              used.\n"
+"\n"
+"       47     Too many redirects. When following redirects, curl hit the maxi-\n"
+"              mum amount.\n"
+"\n"
+"       48     Unknown option specified to libcurl.  This  indicates  that  you\n"
+"              passed  a weird option to curl that was passed on to libcurl and\n"
+"              rejected. Read up in the manual!\n"
+"\n"
+"       49     Malformed telnet option.\n"
+"\n"
+, stdout);
+ fputs(
+"       51     The peer's SSL certificate or SSH MD5 fingerprint was not OK.\n"
+"\n"
+"       52     The server didn't reply anything, which here  is  considered  an\n"
+"              error.\n"
+"\n"
+"       53     SSL crypto engine not found.\n"
+"\n"
+"       54     Cannot set SSL crypto engine as default.\n"
+"\n"
+"       55     Failed sending network data.\n"
+"\n"
+"       56     Failure in receiving network data.\n"
+"\n"
+"       58     Problem with the local certificate.\n"
+"\n"
+"       59     Couldn't use specified SSL cipher.\n"
+"\n"
+, stdout);
+ fputs(
+"       60     Peer  certificate cannot be authenticated with known CA certifi-\n"
+"              cates.\n"
+"\n"
+"       61     Unrecognized transfer encoding.\n"
+"\n"
+"       62     Invalid LDAP URL.\n"
+"\n"
+"       63     Maximum file size exceeded.\n"
+"\n"
+"       64     Requested FTP SSL level failed.\n"
+"\n"
+"       65     Sending the data requires a rewind that failed.\n"
+"\n"
+"       66     Failed to initialise SSL Engine.\n"
+"\n"
+"       67     The user name, password, or similar was not  accepted  and  curl\n"
+"              failed to log in.\n"
+"\n"
+, stdout);
+ fputs(
+"       68     File not found on TFTP server.\n"
+"\n"
+"       69     Permission problem on TFTP server.\n"
+"\n"
+"       70     Out of disk space on TFTP server.\n"
+"\n"
+"       71     Illegal TFTP operation.\n"
+"\n"
+"       72     Unknown TFTP transfer ID.\n"
+"\n"
+"       73     File already exists (TFTP).\n"
+"\n"
+"       74     No such user (TFTP).\n"
+"\n"
+"       75     Character conversion failed.\n"
+"\n"
+"       76     Character conversion functions required.\n"
+"\n"
+"       77     Problem with reading the SSL CA cert (path? access rights?).\n"
+"\n"
+, stdout);
+ fputs(
+"       78     The resource referenced in the URL does not exist.\n"
+"\n"
+"       79     An unspecified error occurred during the SSH session.\n"
+"\n"
+"       80     Failed to shut down the SSL connection.\n"
+"\n"
+"       82     Could  not  load  CRL  file,  missing  or wrong format (added in\n"
+"              7.19.0).\n"
+"\n"
+"       83     Issuer check failed (added in 7.19.0).\n"
+"\n"
+"       84     The FTP PRET command failed\n"
+"\n"
+"       85     RTSP: mismatch of CSeq numbers\n"
+"\n"
+"       86     RTSP: mismatch of Session Identifiers\n"
+"\n"
+, stdout);
+ fputs(
+"       87     unable to parse FTP file list\n"
+"\n"
+"       88     FTP chunk callback reported error\n"
+"\n"
+"       89     No connection available, the session will be queued\n"
+"\n"
+"       90     SSL public key does not matched pinned public key\n"
+"\n"
+"       91     Invalid SSL certificate status.\n"
+"\n"
+"       92     Stream error in HTTP/2 framing layer.\n"
+"\n"
+"       XX     More error codes will appear here in future releases. The exist-\n"
+"              ing ones are meant to never change.\n"
+"\n"
+"AUTHORS / CONTRIBUTORS\n"
+, stdout);
+ fputs(
+"       Daniel  Stenberg is the main author, but the whole list of contributors\n"
+"       is found in the separate THANKS file.\n"
+"\n"
+"WWW\n"
+"       https://curl.haxx.se\n"
+"\n"
+"SEE ALSO\n"
+"       ftp(1), wget(1)\n"
+"\n"
+, stdout) ;
+}
+#else /* !USE_MANUAL */
+/* built-in manual is disabled, blank function */
+#include "tool_hugehelp.h"
+void hugehelp(void) {}
+#endif /* USE_MANUAL */
+#else
+/*
+ * NEVER EVER edit this manually, fix the mkhelp.pl script instead!
+ */
+#ifdef USE_MANUAL
+#include "tool_hugehelp.h"
+#include <zlib.h>
+#include "memdebug.h" /* keep this as LAST include */
+static const unsigned char hugehelpgz[] = {
+  /* This mumbo-jumbo is the huge help text compressed with gzip.
+     Thanks to this operation, the size of this data shrank from 167622
+     to 47001 bytes. You can disable the use of compressed help
+     texts by NOT passing -c to the mkhelp.pl tool. */
+  0x1f, 0x8b, 0x08, 0x01, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xed, 0xbd,
+  0x7b, 0x77, 0xdc, 0xc6, 0xb1, 0x2f, 0xfa, 0xbf, 0x3f, 0x05, 0x36, 0xb3,
+  0x72, 0x48, 0xee, 0xcc, 0x0c, 0x1f, 0x7a, 0x59, 0x8a, 0x9c, 0x6d, 0x45,
+  0xa2, 0x6c, 0x6e, 0x53, 0x22, 0x0f, 0x87, 0xb2, 0x9d, 0x1b, 0x7b, 0x69,
+  0x61, 0x66, 0x30, 0x24, 0xa2, 0x19, 0x60, 0x02, 0x60, 0xf8, 0xc8, 0x3e,
+  0xb9, 0x9f, 0xfd, 0x76, 0xfd, 0xaa, 0xaa, 0xbb, 0x81, 0x6e, 0x0c, 0x69,
+  0xc7, 0xf6, 0x79, 0xdd, 0xec, 0xb5, 0x2d, 0x89, 0x04, 0x1a, 0xfd, 0xa8,
+  0xae, 0x77, 0xfd, 0x2a, 0x49, 0xee, 0xfb, 0xdf, 0x47, 0xfc, 0xff, 0x47,
+  0xf3, 0x3f, 0xf3, 0xe7, 0x67, 0x49, 0x72, 0x56, 0x95, 0x7f, 0xcb, 0xa6,
+  0x4d, 0xfc, 0xd9, 0x8f, 0x1f, 0xff, 0x47, 0xc2, 0xff, 0x67, 0xde, 0xf9,
+  0xc1, 0xfc, 0xf9, 0xd9, 0xc6, 0xb1, 0xf7, 0x12, 0xf7, 0xc2, 0xff, 0xf8,
+  0xb8, 0x9b, 0xdc, 0xf7, 0xc2, 0xff, 0x48, 0x76, 0xf0, 0xc2, 0x47, 0xf9,
+  0xc2, 0x4b, 0xfa, 0xfb, 0xc7, 0x8f, 0x9b, 0x3f, 0xf2, 0x03, 0xcd, 0x8a,
+  0xfe, 0xb3, 0x47, 0xef, 0xfd, 0xf0, 0x91, 0xfe, 0x6a, 0x7e, 0xf2, 0xd9,
+  0x67, 0xef, 0x5f, 0xbd, 0x3b, 0xd2, 0x57, 0xa7, 0xeb, 0x6a, 0x91, 0x0c,
+  0x93, 0xa6, 0x4a, 0x8b, 0x7a, 0x9e, 0x55, 0x49, 0x9a, 0x7c, 0x38, 0x3f,
+  0xf9, 0xec, 0xb3, 0xf1, 0x5f, 0xde, 0x9f, 0x9e, 0x8d, 0x8f, 0xc7, 0xad,
+  0xc7, 0xfe, 0x5a, 0xae, 0x9a, 0xbc, 0x2c, 0x6a, 0x33, 0x7d, 0xf3, 0x50,
+  0xfd, 0xe3, 0x67, 0x9f, 0xbd, 0x39, 0x1a, 0xbf, 0x3e, 0x3f, 0x3e, 0xbb,
+  0x38, 0x3e, 0x7d, 0xdf, 0x7a, 0x32, 0xc9, 0xeb, 0xc4, 0x0c, 0xd5, 0x94,
+  0xe5, 0xc2, 0xfc, 0xc7, 0x8d, 0x3e, 0x4b, 0x9b, 0x34, 0x99, 0x57, 0xe5,
+  0x32, 0x29, 0x2b, 0xfa, 0x45, 0x9a, 0xd4, 0x59, 0x75, 0x9d, 0x55, 0x83,
+  0x64, 0x5d, 0xe7, 0xc5, 0x65, 0x52, 0x16, 0x59, 0x52, 0xce, 0x93, 0xe6,
+  0x2a, 0xd3, 0xe1, 0xea, 0xf5, 0x6a, 0x55, 0x56, 0x4d, 0x36, 0x4b, 0x56,
+  0x55, 0xd9, 0x94, 0xd3, 0x72, 0x51, 0x27, 0x3b, 0x6f, 0x8e, 0x5f, 0x5f,
+  0x0c, 0x92, 0xb7, 0xc7, 0x27, 0x47, 0xe6, 0xbf, 0x17, 0x67, 0xf8, 0xcf,
+  0x78, 0x90, 0x7c, 0x75, 0x7a, 0xf6, 0xf5, 0xd1, 0xf9, 0x20, 0xf9, 0xfa,
+  0x82, 0x7e, 0x46, 0xff, 0x35, 0x3f, 0x4c, 0x8e, 0xdf, 0xbd, 0x3a, 0x1b,
+  0xe8, 0x70, 0xf4, 0x0f, 0xfa, 0xe1, 0xc9, 0x1b, 0xf3, 0x43, 0xfe, 0x83,
+  0xfe, 0x79, 0x76, 0x7a, 0xf6, 0x48, 0xfe, 0xa0, 0x7f, 0x9e, 0x5f, 0xbc,
+  0x33, 0xbf, 0x3d, 0xbf, 0x18, 0x9b, 0xff, 0x8e, 0x5f, 0xd3, 0x7f, 0xf0,
+  0x95, 0xf1, 0xbb, 0x3f, 0xe3, 0x3f, 0x63, 0x3b, 0xdc, 0xf8, 0x1d, 0xff,
+  0x1c, 0x5f, 0xba, 0x38, 0x3a, 0x79, 0x7f, 0x74, 0x91, 0xa4, 0xc5, 0x2c,
+  0xb9, 0x30, 0xcf, 0xef, 0x8e, 0x92, 0x8b, 0xab, 0x2c, 0x99, 0x96, 0xcb,
+  0x25, 0xfd, 0xc8, 0xec, 0xc8, 0x2c, 0xab, 0xf3, 0xcb, 0xc2, 0x2c, 0xc5,
+  0xac, 0xfc, 0xa6, 0xac, 0x3e, 0x25, 0xc9, 0x4d, 0xde, 0x5c, 0x95, 0xeb,
+  0x46, 0x87, 0x5b, 0x9b, 0xdd, 0x48, 0xf2, 0xa2, 0xc9, 0xaa, 0x74, 0x4a,
+  0x3b, 0x3d, 0xfa, 0xac, 0xb5, 0xab, 0xe5, 0xdc, 0xec, 0x61, 0x6d, 0x36,
+  0x6d, 0xb2, 0xae, 0x17, 0x65, 0x3a, 0xa3, 0xad, 0x32, 0xaf, 0xcc, 0xd7,
+  0x66, 0x93, 0xab, 0x7c, 0xfa, 0xa9, 0x4e, 0x16, 0xf9, 0xa7, 0x8c, 0x36,
+  0xea, 0xf6, 0x4e, 0x37, 0x6e, 0xc0, 0x83, 0xa6, 0x6b, 0xb3, 0xa7, 0xc5,
+  0x50, 0x87, 0x6b, 0xf2, 0x69, 0x4a, 0x1f, 0xc0, 0xce, 0x25, 0xeb, 0x15,
+  0x8d, 0xc6, 0x3b, 0x96, 0xac, 0xca, 0xda, 0xbc, 0x34, 0x1e, 0x9f, 0x98,
+  0x99, 0x17, 0x45, 0x86, 0x79, 0xd4, 0x03, 0xf3, 0x8f, 0xf2, 0x53, 0x9e,
+  0x99, 0xbf, 0xcc, 0xf3, 0x45, 0x96, 0xf0, 0x89, 0xda, 0xe1, 0xe8, 0x68,
+  0x93, 0x2a, 0xab, 0xd7, 0xcb, 0xcc, 0xec, 0xde, 0xbb, 0xac, 0x49, 0x17,
+  0x79, 0xf1, 0xc9, 0xfc, 0x95, 0x16, 0xbe, 0x2c, 0xab, 0x6c, 0x94, 0xbc,
+  0xaa, 0x93, 0xbb, 0x72, 0x6d, 0x16, 0xbc, 0x58, 0x98, 0x33, 0xcf, 0x92,
+  0x49, 0xb6, 0x28, 0x6f, 0x06, 0x74, 0xd2, 0x49, 0xb1, 0x5e, 0x4e, 0xcc,
+  0x00, 0xe5, 0xdc, 0x0d, 0x97, 0x36, 0x6b, 0x33, 0x1c, 0x3f, 0xbd, 0x4c,
+  0xcd, 0x9a, 0xcc, 0xbb, 0x55, 0x72, 0x95, 0x99, 0x35, 0xd7, 0xab, 0xbc,
+  0xf8, 0xb7, 0xf6, 0xbe, 0x98, 0xad, 0x5d, 0x95, 0x37, 0x59, 0x65, 0x76,
+  0x76, 0x72, 0x97, 0x98, 0x4d, 0x98, 0x30, 0x11, 0xce, 0x0d, 0x91, 0x25,
+  0xa9, 0x19, 0xc2, 0x12, 0xe0, 0xb0, 0xca, 0x16, 0x29, 0x11, 0x93, 0xfd,
+  0xc6, 0xc8, 0x1c, 0x62, 0x66, 0xa9, 0x4d, 0x5e, 0xdd, 0x79, 0xb4, 0x8b,
+  0x97, 0x67, 0x66, 0x25, 0xf9, 0xa2, 0x36, 0xc7, 0x40, 0x97, 0x42, 0x9e,
+  0xa1, 0x43, 0x25, 0xfa, 0x37, 0xb4, 0x79, 0x57, 0x34, 0xe9, 0x2d, 0x3e,
+  0x2f, 0xb4, 0x39, 0x9c, 0x65, 0xab, 0xac, 0x98, 0x65, 0x45, 0x33, 0x4a,
+  0xfe, 0x52, 0xae, 0xb7, 0xcd, 0xb7, 0xe7, 0xb9, 0xd9, 0x83, 0x54, 0x86,
+  0x32, 0x5f, 0x36, 0x44, 0x30, 0xad, 0xf2, 0x95, 0x77, 0x14, 0x65, 0x61,
+  0xce, 0x3c, 0x39, 0x7f, 0xfb, 0x3a, 0x79, 0xf4, 0xfc, 0xf3, 0xa7, 0xee,
+  0xcc, 0xcd, 0x00, 0xc9, 0x34, 0x2d, 0xcc, 0x8a, 0xb3, 0x69, 0x3e, 0xbf,
+  0x4b, 0x96, 0xeb, 0x45, 0x93, 0xaf, 0xcc, 0xee, 0xd3, 0xe5, 0xa3, 0x0b,
+  0xb4, 0x4a, 0xab, 0xa6, 0x26, 0x22, 0xc0, 0x0f, 0xb0, 0xf6, 0x9b, 0x2a,
+  0x6f, 0xe8, 0x22, 0xe1, 0x77, 0x66, 0x86, 0x59, 0x53, 0xeb, 0x70, 0x44,
+  0x6b, 0xe6, 0x3b, 0x13, 0x43, 0x5b, 0x66, 0x6b, 0xd3, 0xda, 0x7c, 0xf4,
+  0xc5, 0x67, 0x8e, 0x83, 0x5c, 0x35, 0xcd, 0xea, 0xc5, 0xde, 0x5e, 0x9d,
+  0x37, 0xd9, 0xe8, 0xbf, 0xcc, 0x3d, 0x1c, 0x34, 0x37, 0xe5, 0xa0, 0xb9,
+  0xaa, 0xb2, 0xec, 0x9f, 0x23, 0x43, 0xc3, 0xf6, 0x49, 0xf3, 0xdd, 0x3b,
+  0x99, 0xd8, 0x65, 0xd6, 0x98, 0x2f, 0xfc, 0x7d, 0x9d, 0x15, 0x34, 0xa2,
+  0x99, 0x47, 0xba, 0x58, 0x5d, 0xa5, 0xe6, 0x38, 0x33, 0x43, 0x8d, 0x74,
+  0xb3, 0x0d, 0xc1, 0xd0, 0xac, 0xf8, 0x6e, 0xff, 0xf5, 0xc7, 0xf0, 0xa3,
+  0x73, 0x7c, 0xd3, 0xfc, 0x77, 0x94, 0xdd, 0xa6, 0x4b, 0xb3, 0x36, 0xfa,
+  0xd4, 0x1e, 0x91, 0xd8, 0x5f, 0x0f, 0x86, 0x07, 0xfb, 0xfb, 0x3f, 0x8e,
+  0x9a, 0xdb, 0xe6, 0x61, 0xcf, 0xef, 0xef, 0xbb, 0x37, 0xe8, 0xd1, 0x1d,
+  0x5a, 0x6f, 0xb2, 0x30, 0x24, 0x43, 0x1f, 0xff, 0x47, 0x56, 0x95, 0xf5,
+  0xee, 0xc3, 0x46, 0x4a, 0x87, 0xff, 0x68, 0x7f, 0xf7, 0x7d, 0x56, 0x83,
+  0x66, 0xdc, 0x5a, 0x93, 0xb4, 0x32, 0x74, 0x5b, 0x36, 0x8e, 0x3d, 0x0d,
+  0xcc, 0xa5, 0x6c, 0xec, 0xce, 0x98, 0x3b, 0x67, 0x9e, 0x36, 0x8c, 0x2d,
+  0x5d, 0x10, 0x4f, 0xab, 0x93, 0x22, 0xbb, 0xb5, 0xb7, 0xdc, 0xdc, 0xfe,
+  0x2c, 0x9d, 0x5e, 0x25, 0xa5, 0x21, 0xfe, 0x2a, 0x72, 0x04, 0xfe, 0x84,
+  0xd2, 0x6a, 0x7a, 0x95, 0x5f, 0x9b, 0xdd, 0x78, 0xfe, 0xfc, 0xe9, 0xd0,
+  0xfc, 0xe7, 0xf9, 0x8f, 0x7b, 0xd7, 0xe5, 0xc2, 0x6c, 0xce, 0xe3, 0x1f,
+  0xf7, 0xe8, 0x88, 0xff, 0x2b, 0x1d, 0x4c, 0x06, 0xd3, 0x7f, 0x8e, 0xae,
+  0x9a, 0xe5, 0xa2, 0x97, 0x70, 0xd2, 0xc2, 0xfc, 0xff, 0xb2, 0x5c, 0x17,
+  0x8d, 0x25, 0x16, 0x43, 0x73, 0x8d, 0xc7, 0x9c, 0xcc, 0x75, 0x35, 0x77,
+  0x94, 0x48, 0x9b, 0x68, 0x88, 0x6e, 0x9d, 0xb9, 0xa0, 0xee, 0x3a, 0x36,
+  0xd3, 0x2b, 0x5a, 0xbf, 0xa1, 0x9e, 0x54, 0x36, 0xa1, 0xc9, 0x53, 0xba,
+  0x99, 0x86, 0x41, 0x10, 0xc3, 0xc2, 0x58, 0xfc, 0xb5, 0xdc, 0x3c, 0x58,
+  0x56, 0xb3, 0xac, 0x1a, 0x75, 0xa7, 0x61, 0xaf, 0xac, 0xf7, 0xcd, 0x44,
+  0x25, 0x0a, 0xfd, 0x00, 0x13, 0x5b, 0xe6, 0xb7, 0x66, 0x04, 0x30, 0xcc,
+  0x02, 0x13, 0xe7, 0xd1, 0x12, 0x9a, 0x31, 0x3e, 0xa3, 0xef, 0xbb, 0x2b,
+  0x6b, 0xa6, 0xde, 0x5a, 0x3a, 0x3e, 0xea, 0x16, 0x9f, 0x98, 0xc3, 0x5b,
+  0x99, 0xb7, 0xd6, 0xc4, 0x57, 0x71, 0xad, 0x69, 0x18, 0xc3, 0x10, 0x2e,
+  0xcd, 0xb9, 0x98, 0xb3, 0x20, 0x2a, 0xa6, 0xa3, 0xba, 0x4b, 0xde, 0x1b,
+  0x82, 0x61, 0x66, 0xe4, 0x11, 0xfb, 0x22, 0x6b, 0x9a, 0x7b, 0x8f, 0xc9,
+  0x51, 0xec, 0x8b, 0x83, 0x80, 0x68, 0xfb, 0x9e, 0x37, 0x74, 0xf6, 0xe2,
+  0xb0, 0xfd, 0xf0, 0x77, 0x86, 0x49, 0xbb, 0xeb, 0x62, 0xbe, 0xfe, 0x5f,
+  0xff, 0xf4, 0xa8, 0xee, 0x86, 0x7e, 0x9b, 0x17, 0xd7, 0xe5, 0x27, 0xb3,
+  0x45, 0x90, 0xa2, 0x69, 0x7b, 0x37, 0x89, 0x0f, 0x2d, 0x57, 0x8d, 0x15,
+  0x4f, 0x44, 0x8e, 0xe6, 0x47, 0x93, 0x74, 0xb2, 0xb8, 0x4b, 0xae, 0xd2,
+  0xeb, 0x8c, 0xd6, 0xbb, 0x32, 0x74, 0x4a, 0x3b, 0x60, 0xc4, 0xc6, 0x02,
+  0x7c, 0x4c, 0x18, 0xc3, 0xac, 0x5c, 0x4f, 0x0c, 0x73, 0xf9, 0xfb, 0xba,
+  0x6c, 0x78, 0x63, 0xd2, 0xeb, 0x32, 0x9f, 0xb5, 0x64, 0xf1, 0x55, 0x46,
+  0x0c, 0x8d, 0x3e, 0x0c, 0x21, 0x65, 0x18, 0x2a, 0xcd, 0x14, 0x17, 0x2d,
+  0x6f, 0x48, 0xdc, 0x19, 0x56, 0x98, 0x2e, 0xea, 0x32, 0x49, 0x2e, 0x4b,
+  0xba, 0x25, 0x60, 0xc0, 0x20, 0x73, 0x73, 0x28, 0x57, 0x29, 0x49, 0x35,
+  0x23, 0xc0, 0xec, 0x3d, 0xa8, 0x32, 0xf0, 0x62, 0x9c, 0x54, 0xba, 0x18,
+  0xb0, 0xf4, 0xa2, 0x77, 0x64, 0xab, 0x92, 0xed, 0xff, 0xb6, 0x3d, 0x48,
+  0xb6, 0xff, 0x63, 0x1b, 0xf4, 0xb0, 0xfd, 0xef, 0xdb, 0xee, 0x9c, 0x8d,
+  0x32, 0x76, 0x9d, 0xcf, 0x32, 0x26, 0x89, 0xe3, 0xb3, 0xeb, 0xa7, 0xc9,
+  0x3f, 0x48, 0x77, 0x30, 0xbc, 0x36, 0xbb, 0x55, 0x82, 0xd4, 0xb5, 0x99,
+  0xb7, 0x13, 0xc3, 0x74, 0xd3, 0x15, 0x29, 0x11, 0x59, 0x35, 0x35, 0xd4,
+  0x9b, 0x5e, 0x1a, 0x7a, 0x35, 0xb2, 0x58, 0x87, 0xa3, 0xf1, 0xe9, 0x15,
+  0x5e, 0x96, 0x61, 0x90, 0x49, 0x91, 0x2e, 0xcd, 0x8d, 0x38, 0xa1, 0x19,
+  0xe5, 0x45, 0x78, 0x98, 0x7f, 0x9d, 0x67, 0x9f, 0xef, 0xbf, 0x78, 0xf1,
+  0xe8, 0xf7, 0x87, 0x4f, 0xb2, 0xe6, 0x6a, 0xff, 0xc7, 0x3d, 0xfb, 0xc8,
+  0xf1, 0x1c, 0xdb, 0xae, 0xe4, 0xa7, 0x93, 0x30, 0x52, 0xde, 0x4a, 0x09,
+  0xf3, 0xbe, 0xf9, 0x7b, 0x36, 0xcf, 0x6f, 0x07, 0xaa, 0x2f, 0xf1, 0x9d,
+  0x4b, 0x0d, 0xa9, 0x99, 0xf3, 0x23, 0x16, 0xa1, 0xc3, 0x5d, 0xae, 0xb3,
+  0xda, 0xec, 0xe4, 0xcd, 0x55, 0xda, 0x24, 0x76, 0x00, 0x3e, 0xd9, 0x65,
+  0x7e, 0x79, 0xd5, 0x24, 0x37, 0x29, 0x09, 0x9b, 0xe3, 0x86, 0x87, 0x20,
+  0x29, 0x6f, 0x44, 0xcc, 0x3c, 0x35, 0xb2, 0x82, 0xce, 0x10, 0x22, 0x7d,
+  0xe2, 0x34, 0x8c, 0xc6, 0x90, 0x39, 0x1f, 0x88, 0x53, 0xa7, 0x26, 0x69,
+  0x4d, 0x97, 0xb6, 0x30, 0xcc, 0xa1, 0x31, 0x3a, 0xc2, 0x9a, 0xfe, 0x75,
+  0x65, 0xb4, 0x00, 0xec, 0x81, 0x4c, 0x14, 0x82, 0xf2, 0x2d, 0x1d, 0x27,
+  0x9d, 0x8d, 0x15, 0x5e, 0xe6, 0x90, 0x06, 0x72, 0xcc, 0xf6, 0x8d, 0xda,
+  0x5c, 0x38, 0xc3, 0x99, 0x2c, 0x65, 0x6c, 0x11, 0x93, 0xdd, 0xe2, 0x75,
+  0x62, 0x8e, 0x69, 0x4d, 0x8a, 0x02, 0xab, 0x03, 0x66, 0xf2, 0xde, 0x62,
+  0xcd, 0xa6, 0xa5, 0x9f, 0x48, 0x25, 0xe9, 0x28, 0x3e, 0x78, 0x6d, 0x56,
+  0x1a, 0x22, 0x33, 0xb3, 0x35, 0xcc, 0x98, 0x56, 0x46, 0x2c, 0x16, 0xbb,
+  0x02, 0x22, 0x37, 0x63, 0xd2, 0x0f, 0xf3, 0x86, 0x64, 0x0c, 0x74, 0x58,
+  0x33, 0x5f, 0xb3, 0x29, 0x50, 0x44, 0x0d, 0xa3, 0xf6, 0xd6, 0x0f, 0xf1,
+  0x68, 0x9e, 0x4d, 0xae, 0x8d, 0x96, 0x62, 0x14, 0xd2, 0xcc, 0xbe, 0x05,
+  0x79, 0x3e, 0x25, 0xdd, 0x68, 0x61, 0xee, 0xcb, 0xb4, 0xac, 0x2a, 0xd2,
+  0xf7, 0xe9, 0x04, 0x27, 0xcc, 0x44, 0x97, 0x99, 0x51, 0x23, 0xfc, 0xed,
+  0xcc, 0x49, 0xa0, 0x19, 0xfe, 0x62, 0xf4, 0x12, 0x70, 0x10, 0xa3, 0x3f,
+  0x80, 0xe7, 0x63, 0xe1, 0x98, 0x1d, 0x8d, 0x3d, 0x9d, 0x66, 0xab, 0xa6,
+  0x8e, 0xad, 0x49, 0x0f, 0xdc, 0x4c, 0xa7, 0xca, 0x68, 0xe7, 0x7d, 0xa5,
+  0x0b, 0xfb, 0x6a, 0x85, 0x3e, 0xf4, 0x2e, 0xd5, 0x63, 0x8c, 0x1e, 0x56,
+  0xdb, 0x5d, 0x6b, 0x40, 0x1b, 0x86, 0x8d, 0x61, 0xcf, 0x97, 0x34, 0x51,
+  0x7a, 0xb8, 0xe6, 0x9b, 0x0a, 0xd6, 0x4c, 0x07, 0xc9, 0x9a, 0x36, 0x7f,
+  0x97, 0x44, 0x97, 0xd9, 0x4f, 0x3b, 0xb8, 0xf9, 0xaa, 0x3d, 0x53, 0xfa,
+  0x3c, 0xa9, 0xf8, 0x46, 0x92, 0xcf, 0xea, 0x2b, 0xa3, 0x7c, 0xd5, 0x72,
+  0xb3, 0xf3, 0xa5, 0xa1, 0x99, 0x6b, 0x3a, 0xdf, 0x55, 0x96, 0xcd, 0x46,
+  0xc9, 0xe9, 0x9c, 0xb8, 0x6a, 0x65, 0x26, 0xdd, 0xe0, 0xd7, 0x24, 0x55,
+  0xcc, 0xbe, 0xcd, 0xa0, 0xc4, 0xdb, 0xab, 0xc5, 0x53, 0xf1, 0xa4, 0x03,
+  0x38, 0x79, 0x6a, 0x7e, 0x62, 0x66, 0xbb, 0x68, 0x8b, 0x20, 0xdc, 0x43,
+  0xc3, 0xbd, 0x69, 0x7a, 0x93, 0x2c, 0x01, 0x25, 0x4e, 0xb2, 0xe6, 0x26,
+  0xcb, 0xec, 0x70, 0x75, 0x66, 0xc4, 0x1e, 0x1d, 0x1a, 0x6b, 0x7e, 0x60,
+  0x86, 0xb4, 0xb5, 0x67, 0xe7, 0xa7, 0x5f, 0x9d, 0x1f, 0x8d, 0xc7, 0xc9,
+  0xbb, 0xa3, 0x8b, 0xa3, 0xf3, 0xd6, 0x4e, 0x17, 0x65, 0xb5, 0xc4, 0x89,
+  0xce, 0xf2, 0x7a, 0xb5, 0x48, 0xef, 0xe8, 0xa8, 0xcd, 0x4a, 0x2e, 0x2b,
+  0xba, 0x59, 0xcb, 0x8c, 0xa4, 0xc2, 0x6c, 0x0d, 0x4e, 0x66, 0xc4, 0x91,
+  0x39, 0x3e, 0xd1, 0x78, 0x89, 0x99, 0x40, 0x4d, 0x2e, 0x2e, 0xdd, 0x4e,
+  0x1b, 0x8e, 0x23, 0x92, 0x94, 0x44, 0xa9, 0x3d, 0x0f, 0x52, 0x3d, 0x61,
+  0xdc, 0x0c, 0xdc, 0xcf, 0x78, 0x9b, 0x58, 0xb4, 0x19, 0x9a, 0xcd, 0x97,
+  0x60, 0x76, 0xe6, 0x4f, 0xa7, 0x6d, 0x66, 0x73, 0xa3, 0x6a, 0x1b, 0xe9,
+  0xca, 0x96, 0x42, 0x77, 0x4e, 0x3a, 0x5b, 0xab, 0x1f, 0x1b, 0x32, 0x24,
+  0xd6, 0x4c, 0x03, 0xf2, 0x54, 0xf8, 0x0b, 0x96, 0x89, 0x19, 0x9d, 0x84,
+  0x78, 0x9f, 0x3c, 0xb6, 0xa2, 0x29, 0x64, 0xe6, 0x64, 0x67, 0x3c, 0x7c,
+  0xbd, 0x9e, 0xe3, 0x22, 0x27, 0x3b, 0x46, 0x33, 0x7f, 0x67, 0xac, 0x25,
+  0x63, 0xb1, 0x0c, 0x92, 0xb3, 0x5d, 0xbc, 0x77, 0xb0, 0x7f, 0xf8, 0x98,
+  0x19, 0xc1, 0x48, 0x87, 0x7b, 0xeb, 0x31, 0xe2, 0x83, 0x4f, 0x74, 0xbc,
+  0xfc, 0x10, 0x0d, 0x3e, 0x4a, 0x0e, 0xde, 0xf1, 0x4f, 0x1e, 0x7f, 0xfe,
+  0xe4, 0xd9, 0x53, 0xf9, 0x61, 0x9b, 0xc0, 0xed, 0xfc, 0x41, 0x1d, 0xb0,
+  0xfc, 0xc8, 0x14, 0x34, 0x33, 0x31, 0xab, 0x5b, 0xe6, 0x85, 0xb9, 0x26,
+  0xe6, 0x5a, 0x09, 0xaf, 0x22, 0x7a, 0x36, 0x93, 0x9f, 0x33, 0x67, 0x93,
+  0x73, 0x6d, 0x9b, 0x94, 0xe6, 0x65, 0x43, 0xb2, 0x86, 0x97, 0xdb, 0x43,
+  0x62, 0x35, 0xa1, 0xa1, 0x89, 0xa4, 0x13, 0x62, 0xb0, 0x64, 0x57, 0x19,
+  0x05, 0x38, 0x8b, 0x7e, 0xcd, 0x4a, 0x45, 0xf3, 0x86, 0x99, 0x9b, 0x91,
+  0x89, 0x24, 0xe6, 0xc2, 0x7d, 0x37, 0xac, 0x00, 0x1c, 0xf2, 0x26, 0xaf,
+  0xc1, 0x1a, 0x6e, 0xca, 0xf5, 0xc2, 0x58, 0x31, 0xf4, 0xc0, 0x7a, 0x85,
+  0x17, 0xcc, 0xa7, 0x56, 0x8e, 0x07, 0x18, 0x8d, 0x85, 0x68, 0xa7, 0x3b,
+  0x8a, 0x99, 0x9a, 0xf9, 0xe7, 0xca, 0x90, 0x12, 0x4f, 0x67, 0xd4, 0x95,
+  0x10, 0xe0, 0x7d, 0x01, 0x25, 0xd2, 0x9d, 0x07, 0xd3, 0x3e, 0x3b, 0x1d,
+  0x5f, 0x90, 0x06, 0x70, 0xf6, 0xe1, 0xc2, 0x0c, 0x64, 0x54, 0x80, 0xba,
+  0x31, 0x44, 0x49, 0x2f, 0x16, 0x19, 0x4c, 0x48, 0x1d, 0xce, 0xd0, 0x5e,
+  0x0e, 0x46, 0x05, 0xb5, 0x46, 0x3f, 0xc9, 0x73, 0x64, 0x1b, 0x9b, 0xae,
+  0xa0, 0x5a, 0xd8, 0x2c, 0xc3, 0xed, 0x3b, 0xc9, 0xce, 0x9f, 0x76, 0x0d,
+  0xcd, 0x0e, 0x4b, 0xbb, 0x3b, 0xc3, 0xa1, 0xbc, 0x6a, 0xbe, 0x5d, 0xe7,
+  0xcb, 0x7c, 0x91, 0x56, 0xde, 0xd4, 0x99, 0xa3, 0xd2, 0xfd, 0xb4, 0x7c,
+  0x65, 0x6a, 0xa8, 0x06, 0xd3, 0x76, 0xa6, 0x24, 0xed, 0x21, 0xb8, 0x92,
+  0x3b, 0xaa, 0x19, 0x29, 0x04, 0xd0, 0x98, 0x57, 0xb9, 0xdd, 0x3a, 0x3a,
+  0x33, 0x62, 0x57, 0xad, 0x8d, 0xea, 0x9e, 0x5b, 0xb0, 0x71, 0x24, 0x91,
+  0xe0, 0xa9, 0xb0, 0x5b, 0x97, 0x6c, 0x4d, 0xd2, 0x6a, 0x2b, 0xb1, 0xbc,
+  0x98, 0xef, 0x26, 0xdd, 0x90, 0x2a, 0xbb, 0x5c, 0x9b, 0x15, 0x24, 0xbc,
+  0xbb, 0xb4, 0xd2, 0xdf, 0x79, 0x2b, 0xd5, 0x01, 0x86, 0x13, 0x7a, 0x24,
+  0xaf, 0xd9, 0xcc, 0x9c, 0x1b, 0xbb, 0x85, 0x2e, 0x8d, 0xea, 0xaf, 0xd0,
+  0x68, 0x84, 0x62, 0x22, 0x04, 0xe3, 0xe9, 0xb5, 0xe6, 0xaa, 0x34, 0x99,
+  0x61, 0x34, 0x60, 0xff, 0xf4, 0xe4, 0xd0, 0x1c, 0xd9, 0x70, 0x58, 0x9b,
+  0xfd, 0x27, 0xdd, 0x7b, 0x25, 0x36, 0xfd, 0x29, 0x1c, 0x26, 0xd6, 0xb7,
+  0x72, 0x2a, 0x3a, 0x30, 0xc4, 0x26, 0xbf, 0x0b, 0x16, 0x6a, 0x14, 0xd5,
+  0x1b, 0xf3, 0xe1, 0xd4, 0x1c, 0x99, 0xb9, 0x70, 0xef, 0x68, 0xa3, 0xd8,
+  0x37, 0x92, 0x58, 0xb5, 0x19, 0x94, 0x91, 0xd3, 0xbd, 0x4f, 0x9d, 0x2e,
+  0x33, 0x9b, 0xe5, 0xf4, 0x5b, 0x73, 0xbf, 0x8c, 0x84, 0x5b, 0x67, 0xb0,
+  0x3d, 0x64, 0x53, 0x97, 0x6e, 0x33, 0x61, 0xc6, 0xd6, 0x57, 0x25, 0x99,
+  0x89, 0x5b, 0xcc, 0x8b, 0x87, 0xf4, 0xad, 0x2d, 0xc8, 0xf3, 0x65, 0xa2,
+  0xdf, 0x92, 0x4f, 0x99, 0x75, 0xcc, 0x7c, 0xdd, 0x6c, 0x60, 0x04, 0xcd,
+  0x9d, 0x67, 0x24, 0x80, 0x57, 0xf3, 0xdc, 0x2b, 0xab, 0xf0, 0x18, 0x91,
+  0xba, 0x22, 0x65, 0x4a, 0x78, 0x38, 0x84, 0x21, 0xae, 0x6c, 0xcd, 0x53,
+  0x1b, 0x98, 0xbd, 0xa5, 0x27, 0x2f, 0xaf, 0xf4, 0x51, 0x4f, 0xb0, 0xa6,
+  0x66, 0x71, 0x24, 0x1c, 0xc8, 0x9e, 0x9e, 0x29, 0xdf, 0x2f, 0x2b, 0x66,
+  0x66, 0x8b, 0xd2, 0xd0, 0xf2, 0x16, 0xab, 0xac, 0x32, 0x6d, 0x9a, 0x35,
+  0xcd, 0x92, 0x76, 0x9c, 0xfd, 0x4c, 0xa5, 0x3d, 0x1b, 0x3b, 0x69, 0xd9,
+  0xaf, 0xfa, 0xde, 0xa9, 0xb9, 0x8d, 0x1a, 0x63, 0x8f, 0x8c, 0xe8, 0xac,
+  0x89, 0x8e, 0x75, 0xe7, 0x41, 0xde, 0x46, 0xd4, 0x6d, 0x37, 0x7c, 0x1f,
+  0x61, 0x63, 0x75, 0x76, 0xbe, 0x06, 0xf9, 0x88, 0x20, 0xb3, 0x2b, 0x33,
+  0x2b, 0x9a, 0xe5, 0x29, 0xe8, 0x84, 0x8f, 0x06, 0xca, 0x88, 0xb3, 0x08,
+  0x23, 0x7a, 0xf0, 0x5d, 0xd7, 0xa0, 0x5b, 0x2c, 0x7c, 0x91, 0xa4, 0x73,
+  0x1a, 0x9e, 0x9a, 0xb5, 0x9f, 0x60, 0x1d, 0xc3, 0xeb, 0x84, 0xae, 0x9f,
+  0x31, 0x1b, 0xe8, 0x2e, 0x0e, 0x4f, 0x4f, 0xae, 0xbd, 0x6b, 0x44, 0x96,
+  0x7b, 0x41, 0x7a, 0xca, 0x00, 0xde, 0x91, 0x49, 0x59, 0x1a, 0x33, 0xd9,
+  0x2d, 0x8d, 0xe4, 0x41, 0x56, 0x10, 0xb5, 0xcb, 0x89, 0x1a, 0x96, 0xb0,
+  0xb2, 0xfc, 0xf6, 0xce, 0x98, 0x4b, 0xe9, 0x65, 0x9a, 0x5b, 0x7a, 0x93,
+  0x9b, 0x31, 0x4b, 0xf4, 0xe1, 0xa2, 0x94, 0xe7, 0xe9, 0xa8, 0x48, 0x05,
+  0x12, 0xbe, 0xb5, 0xae, 0xf9, 0xfa, 0x98, 0x55, 0x19, 0xce, 0x03, 0xde,
+  0x21, 0xe3, 0x92, 0xda, 0xa8, 0xc3, 0x4d, 0xa0, 0x28, 0x93, 0xce, 0x09,
+  0xe6, 0x0b, 0x0d, 0xd2, 0x8c, 0xb8, 0x35, 0x4a, 0xbe, 0x2e, 0x6f, 0x32,
+  0xf8, 0x0a, 0xa1, 0xdf, 0xe7, 0xe4, 0xed, 0x32, 0xaa, 0xe0, 0x4d, 0x96,
+  0x2c, 0x8d, 0xea, 0x69, 0x76, 0x13, 0xda, 0x07, 0x7e, 0xe6, 0x99, 0x87,
+  0x86, 0xc2, 0x6f, 0x78, 0x97, 0xec, 0x2a, 0xec, 0x51, 0xce, 0xf9, 0x4a,
+  0x24, 0x3b, 0x50, 0x6f, 0xa6, 0xb4, 0x5b, 0xab, 0xc6, 0xad, 0xc2, 0x6e,
+  0xc8, 0x4d, 0x5a, 0x7b, 0x97, 0x2b, 0x83, 0x69, 0xfa, 0x6c, 0x74, 0xf0,
+  0x7c, 0xb4, 0x3f, 0x32, 0x86, 0x48, 0x76, 0x9d, 0x97, 0xeb, 0xda, 0x7c,
+  0x9a, 0xa6, 0xe1, 0xde, 0xc9, 0xe8, 0x56, 0x36, 0xe5, 0xe5, 0xe5, 0x82,
+  0x75, 0x9e, 0xbd, 0x72, 0x3e, 0x67, 0xdd, 0xc7, 0x68, 0x7a, 0x56, 0x7f,
+  0x66, 0x0b, 0x88, 0x76, 0x46, 0xae, 0x1b, 0xb3, 0xd4, 0xd0, 0x44, 0x1e,
+  0x39, 0xe7, 0xc5, 0x70, 0x98, 0x4e, 0xea, 0x86, 0x8c, 0xa9, 0xe1, 0xba,
+  0xc8, 0x6f, 0x87, 0x75, 0x39, 0xfd, 0x64, 0x0e, 0xe5, 0xe5, 0x2a, 0x6d,
+  0xae, 0xfe, 0xd4, 0x71, 0x09, 0xef, 0x90, 0x2c, 0xd9, 0x4d, 0x92, 0xd7,
+  0xac, 0x56, 0xd2, 0x4e, 0x54, 0x7c, 0xdf, 0xcc, 0x69, 0xca, 0x28, 0xc9,
+  0x07, 0x33, 0x8a, 0xa1, 0xe5, 0xa5, 0x39, 0xd4, 0x84, 0x07, 0x1b, 0x28,
+  0x2b, 0xed, 0x0c, 0x07, 0x87, 0x23, 0x89, 0x11, 0xf8, 0xed, 0xcc, 0xd5,
+  0x29, 0xab, 0x4f, 0x46, 0xd1, 0x7e, 0x6f, 0x4c, 0xc6, 0x17, 0xf4, 0x6f,
+  0xc3, 0xc2, 0x1a, 0x6c, 0xb9, 0x48, 0x56, 0x33, 0x23, 0x66, 0xc6, 0x64,
+  0x91, 0xa7, 0x93, 0x61, 0x67, 0x38, 0xf9, 0xbe, 0x7c, 0x34, 0x51, 0x5b,
+  0x43, 0x49, 0x29, 0xd9, 0xfe, 0xd2, 0xd8, 0x7f, 0x57, 0x7c, 0xec, 0x18,
+  0x90, 0xd7, 0x68, 0x28, 0xf4, 0xd2, 0x58, 0x10, 0x45, 0xd3, 0x1d, 0xee,
+  0x0a, 0xa2, 0x9a, 0xa4, 0x0c, 0x1b, 0xbb, 0x20, 0x12, 0xf1, 0x00, 0x59,
+  0xfb, 0x73, 0xf4, 0x59, 0xe7, 0xb5, 0x57, 0xee, 0x4c, 0x9f, 0x3c, 0x32,
+  0x67, 0xea, 0x6f, 0xf4, 0xa2, 0x19, 0xd6, 0xd7, 0xd3, 0xe4, 0x25, 0xb4,
+  0x6f, 0x22, 0xd3, 0xe8, 0x06, 0x8f, 0x77, 0x93, 0xef, 0x5e, 0x9d, 0xbf,
+  0x3f, 0x7e, 0xff, 0xd5, 0x0b, 0xfe, 0xa8, 0x50, 0x9a, 0xf9, 0x5b, 0x76,
+  0xbb, 0x22, 0x3f, 0x18, 0xcd, 0xd6, 0x88, 0xb2, 0x24, 0x79, 0x53, 0xc2,
+  0x1e, 0x01, 0xc3, 0x24, 0x81, 0xd5, 0x19, 0xce, 0x88, 0x96, 0xd9, 0xba,
+  0xe3, 0xfb, 0xb5, 0x0c, 0xdb, 0x0d, 0xcc, 0xd7, 0x93, 0x37, 0x59, 0xe7,
+  0x68, 0xf8, 0x23, 0xbb, 0x8f, 0xa1, 0x2f, 0x8d, 0x48, 0x5a, 0xc2, 0xcc,
+  0xd7, 0x99, 0x77, 0xbf, 0x54, 0x1a, 0x63, 0x97, 0xed, 0x7c, 0x33, 0xde,
+  0xad, 0xb9, 0x36, 0xb4, 0x4b, 0x3a, 0xd8, 0xd4, 0xb0, 0xa3, 0x4c, 0x14,
+  0x07, 0xb0, 0x3a, 0x98, 0x0d, 0xc2, 0xca, 0x46, 0xc9, 0xab, 0x79, 0xf7,
+  0x28, 0x49, 0x77, 0x21, 0xad, 0x5e, 0xa5, 0xe0, 0xcc, 0x29, 0xc2, 0xec,
+  0xe5, 0xe5, 0x11, 0x75, 0x98, 0xda, 0x9c, 0xcf, 0x4c, 0x25, 0x3d, 0x7d,
+  0xa6, 0x33, 0x1c, 0x4c, 0x4f, 0xb0, 0x19, 0x52, 0x0a, 0x73, 0x3a, 0x50,
+  0x32, 0xfd, 0x0c, 0xa3, 0x5e, 0x96, 0x33, 0xd8, 0x11, 0xc1, 0xfe, 0x8c,
+  0xad, 0xc3, 0x67, 0x6b, 0xcb, 0xad, 0x3a, 0xd9, 0x21, 0xd7, 0x9f, 0xa1,
+  0x82, 0xe2, 0xb2, 0xb9, 0xda, 0x75, 0x6e, 0x0d, 0x52, 0x53, 0xcc, 0x82,
+  0xf7, 0xcc, 0x44, 0xb0, 0xee, 0xa2, 0x4b, 0xea, 0x70, 0x3b, 0x43, 0xf3,
+  0xfc, 0xdb, 0xba, 0x6e, 0x60, 0x0d, 0x89, 0xf8, 0xe7, 0x95, 0x98, 0x99,
+  0x2d, 0xb3, 0x65, 0x59, 0xdd, 0x05, 0x13, 0x39, 0x86, 0xf2, 0x41, 0x86,
+  0xa7, 0x9c, 0x16, 0xd1, 0x01, 0xe4, 0xa3, 0xba, 0x04, 0xc9, 0x08, 0x20,
+  0x9f, 0xba, 0xb5, 0x03, 0xa1, 0x34, 0x19, 0x06, 0x64, 0xec, 0x6f, 0xe7,
+  0xb0, 0x55, 0x03, 0x0a, 0x8e, 0x1e, 0xb6, 0xed, 0xc5, 0x9a, 0x9a, 0x88,
+  0x0b, 0x87, 0xfe, 0x7f, 0x91, 0x12, 0xd7, 0x29, 0xb2, 0xd6, 0x09, 0x41,
+  0x7a, 0xf0, 0xd2, 0x36, 0x91, 0xfb, 0xd3, 0xc7, 0xa3, 0x83, 0x16, 0xb9,
+  0x17, 0x77, 0x14, 0x28, 0x88, 0xf3, 0x90, 0x0b, 0xa3, 0x38, 0xd6, 0x3c,
+  0x67, 0xb3, 0x8b, 0xf3, 0xfc, 0x72, 0x5d, 0x65, 0xac, 0xc1, 0x21, 0xb6,
+  0xa0, 0x21, 0x05, 0x52, 0x8a, 0xae, 0x4a, 0x78, 0xe2, 0x8d, 0x30, 0xcd,
+  0x16, 0xf3, 0x41, 0x67, 0x38, 0x98, 0x2f, 0xa0, 0x7e, 0x9a, 0x3e, 0x98,
+  0xa6, 0x31, 0x53, 0x30, 0x58, 0x91, 0x89, 0x12, 0xbb, 0x34, 0x0c, 0x25,
+  0x21, 0x57, 0x74, 0x32, 0x5d, 0xa4, 0xf9, 0x12, 0x64, 0x2a, 0xae, 0xd6,
+  0x51, 0xec, 0x5a, 0x90, 0x81, 0x41, 0x6f, 0x4f, 0xc8, 0xf4, 0xad, 0x6a,
+  0x92, 0xcc, 0x38, 0x55, 0xd5, 0x9c, 0xd9, 0xb0, 0xbc, 0xca, 0xa6, 0x9f,
+  0x94, 0x79, 0xa9, 0xca, 0xd9, 0xa5, 0x63, 0x8a, 0x31, 0xc0, 0xbe, 0x36,
+  0x4f, 0xad, 0x6b, 0xba, 0x26, 0x75, 0x9d, 0x93, 0xfb, 0x8c, 0xcc, 0xc1,
+  0xf5, 0x14, 0x56, 0x22, 0x2e, 0x8c, 0xa1, 0x6e, 0xe5, 0x80, 0x89, 0x61,
+  0xa9, 0xc5, 0x6c, 0xd8, 0x54, 0xf9, 0xaa, 0x6f, 0x76, 0x7c, 0x2a, 0x6d,
+  0x05, 0xb5, 0x16, 0x8b, 0x1d, 0xc6, 0x30, 0x9b, 0xc7, 0xd3, 0xa4, 0xb3,
+  0x9b, 0x5d, 0xa2, 0xc4, 0xde, 0x0e, 0xc8, 0x1f, 0x94, 0x1b, 0x7d, 0x81,
+  0x8d, 0x25, 0xb8, 0x3b, 0x8d, 0x69, 0x24, 0x82, 0xcb, 0x58, 0x71, 0xf9,
+  0x14, 0x4a, 0x50, 0x7e, 0x99, 0x51, 0x2c, 0xc7, 0xc8, 0xb2, 0x66, 0x61,
+  0x54, 0xa3, 0x90, 0xc6, 0xcd, 0x6f, 0xb2, 0xcb, 0xb2, 0x21, 0x6d, 0x24,
+  0x20, 0x93, 0x0f, 0xe0, 0xf3, 0x96, 0x26, 0x54, 0xed, 0xf7, 0x75, 0xb2,
+  0x9c, 0xf5, 0x71, 0xf3, 0x69, 0x56, 0xfb, 0xc5, 0xe3, 0x50, 0x37, 0xe6,
+  0x66, 0x75, 0x4f, 0xdd, 0x8c, 0x36, 0xcd, 0x60, 0x7b, 0x41, 0x71, 0x54,
+  0xbd, 0x55, 0x15, 0x7e, 0x62, 0x09, 0xa4, 0x23, 0x37, 0x37, 0xf9, 0x34,
+  0x53, 0x77, 0x9c, 0xf8, 0xa8, 0x17, 0x79, 0xc8, 0xea, 0x97, 0x74, 0x27,
+  0xcd, 0x4b, 0xac, 0x93, 0x93, 0xf7, 0xe4, 0x26, 0x27, 0x9d, 0x5d, 0x98,
+  0x1e, 0x54, 0x32, 0x11, 0x07, 0x69, 0x95, 0xc3, 0x55, 0x64, 0x86, 0x93,
+  0x79, 0x7a, 0x16, 0xbd, 0x7f, 0xc7, 0x78, 0xde, 0x78, 0x5f, 0xcc, 0x18,
+  0x67, 0xbe, 0xe0, 0x72, 0xcd, 0xd3, 0x7c, 0x11, 0xd9, 0x27, 0x30, 0xb2,
+  0xcb, 0x0c, 0x5e, 0x35, 0x3e, 0x83, 0x35, 0x6d, 0x3a, 0xc5, 0xdd, 0x42,
+  0x26, 0x95, 0x65, 0x6c, 0x4f, 0xc0, 0xf8, 0xb8, 0xbd, 0xb3, 0xdb, 0x0b,
+  0xa5, 0x8d, 0xcf, 0x4e, 0xfe, 0xce, 0xc7, 0xe7, 0x5d, 0xcf, 0x94, 0x46,
+  0x4d, 0x57, 0x14, 0x60, 0xea, 0xde, 0x50, 0x32, 0xbd, 0x28, 0x46, 0xb9,
+  0xab, 0x1e, 0xe4, 0x4c, 0xfc, 0xe7, 0x36, 0xb6, 0x07, 0x86, 0x44, 0x3c,
+  0x4d, 0xae, 0x30, 0x8f, 0x23, 0x1c, 0xb8, 0xcb, 0xcb, 0x8d, 0x7c, 0x35,
+  0xe2, 0x18, 0x3c, 0xb4, 0x45, 0xb1, 0xa5, 0x61, 0x5f, 0x36, 0xc2, 0x44,
+  0x1e, 0x5f, 0xe1, 0x75, 0x30, 0xb4, 0x70, 0x67, 0x63, 0xbc, 0x9c, 0x4c,
+  0x3f, 0xd2, 0x93, 0x59, 0xca, 0x0c, 0x12, 0xd6, 0xeb, 0x98, 0x59, 0x4d,
+  0xd9, 0x07, 0x2c, 0x3a, 0x04, 0x8b, 0x1a, 0x4c, 0x75, 0xbe, 0x48, 0x2f,
+  0xe1, 0x5e, 0xbb, 0xec, 0xde, 0xd0, 0xa2, 0x94, 0x40, 0x5f, 0x5d, 0x1a,
+  0xf6, 0x4e, 0xab, 0x16, 0xd7, 0x56, 0x9d, 0xec, 0x18, 0x22, 0x5b, 0xac,
+  0x21, 0xee, 0x4f, 0xcd, 0xf2, 0xc6, 0xe3, 0xaf, 0x77, 0x7d, 0xf6, 0x86,
+  0xdd, 0x7d, 0x08, 0x73, 0x23, 0xee, 0x04, 0x23, 0xfc, 0xcf, 0x7c, 0x1e,
+  0x6d, 0x06, 0x67, 0xad, 0x3b, 0x5f, 0x93, 0x53, 0xba, 0xa4, 0x55, 0x90,
+  0x2b, 0x74, 0x64, 0xaf, 0x3e, 0x3d, 0xa9, 0x1e, 0x59, 0x26, 0xec, 0x96,
+  0x82, 0xb0, 0xae, 0xd7, 0x70, 0x4e, 0x41, 0x1e, 0x77, 0x87, 0x33, 0xcc,
+  0xde, 0xb0, 0xa2, 0x75, 0x41, 0x7f, 0x5a, 0x1d, 0x3a, 0x87, 0x35, 0x47,
+  0x67, 0x51, 0x91, 0x0b, 0x9c, 0xec, 0x60, 0xab, 0x83, 0x1a, 0x9e, 0xa2,
+  0x63, 0xd3, 0x5e, 0x76, 0x2f, 0xa1, 0xd1, 0xd0, 0xc0, 0x6e, 0x8c, 0x08,
+  0x35, 0x82, 0x99, 0x2e, 0x5c, 0x0f, 0xf7, 0xde, 0xa9, 0xd7, 0x86, 0xbf,
+  0x90, 0xe9, 0x20, 0xcc, 0x83, 0xe8, 0xb1, 0x3b, 0x3b, 0x66, 0x2f, 0x46,
+  0xd2, 0x78, 0x7c, 0x64, 0xf7, 0x97, 0xbe, 0x20, 0x38, 0x34, 0xff, 0x14,
+  0x8d, 0xf8, 0xcd, 0x8c, 0x41, 0x06, 0x95, 0x2c, 0xd0, 0xc6, 0x2e, 0x4e,
+  0xc6, 0xb1, 0xc3, 0x6c, 0xc7, 0xa7, 0xe8, 0x7d, 0x62, 0xb6, 0xe4, 0x46,
+  0x64, 0xb7, 0x6a, 0x49, 0x46, 0x81, 0x17, 0xa3, 0xf2, 0xfd, 0x7d, 0xab,
+  0x8c, 0x82, 0x59, 0x6c, 0x2f, 0x73, 0xf0, 0x9b, 0x18, 0x18, 0x09, 0x6b,
+  0xd2, 0x4e, 0xac, 0x0b, 0xf5, 0xf5, 0x2b, 0x7f, 0x5c, 0xf8, 0x4c, 0xbb,
+  0x17, 0xc1, 0xfb, 0xfd, 0x4e, 0xbd, 0x6b, 0x79, 0x98, 0x19, 0xe5, 0xec,
+  0xe8, 0x1d, 0xec, 0xd7, 0xd4, 0xd0, 0xcd, 0x7b, 0x75, 0x57, 0x6a, 0x6c,
+  0x7b, 0xb2, 0xce, 0x17, 0xad, 0x98, 0x80, 0x33, 0xb9, 0x11, 0x58, 0x66,
+  0xd2, 0xc2, 0xd4, 0x38, 0xba, 0x95, 0xc3, 0x3d, 0xdc, 0x25, 0xb4, 0xe6,
+  0x6e, 0x25, 0x9e, 0xed, 0x75, 0xdd, 0x72, 0x20, 0xa9, 0x5c, 0x5e, 0x34,
+  0xd0, 0xb2, 0xc9, 0xae, 0xf5, 0xc6, 0x0c, 0x4e, 0x08, 0xd3, 0x22, 0x31,
+  0x70, 0x59, 0xe4, 0xff, 0x10, 0x1d, 0x34, 0x2b, 0xae, 0xf3, 0xaa, 0x2c,
+  0x48, 0xcb, 0x35, 0xa6, 0x6f, 0x95, 0x83, 0x2d, 0x93, 0xfa, 0x65, 0x18,
+  0xc7, 0xf6, 0xeb, 0x0f, 0xe7, 0x27, 0x1f, 0x5f, 0xbf, 0xfa, 0xf8, 0xe7,
+  0x0f, 0xef, 0xdf, 0x9c, 0x1c, 0x6d, 0x77, 0x86, 0x23, 0x9f, 0x5f, 0x2e,
+  0x8e, 0xfa, 0x9a, 0x2c, 0x0f, 0x5c, 0x12, 0x33, 0x45, 0x1e, 0xf9, 0x32,
+  0xbf, 0x36, 0x0c, 0x0d, 0x86, 0x04, 0x7c, 0xf4, 0xf8, 0x1b, 0xbc, 0x5a,
+  0xb2, 0xe1, 0x9d, 0xe1, 0x26, 0x6b, 0xd2, 0xd3, 0x46, 0x2d, 0x6d, 0x59,
+  0xaf, 0x8a, 0x58, 0xed, 0x3a, 0xc1, 0x88, 0x86, 0x4d, 0x5a, 0x54, 0x31,
+  0x23, 0xf3, 0xc5, 0x33, 0x12, 0x3d, 0x77, 0xfd, 0xba, 0x31, 0x56, 0x92,
+  0x06, 0x08, 0x8c, 0xd6, 0x56, 0x7e, 0xd2, 0x2c, 0x03, 0x63, 0x62, 0xbd,
+  0x8a, 0x1c, 0x77, 0xed, 0x34, 0xd1, 0x59, 0xb2, 0x4d, 0x23, 0x19, 0xfa,
+  0x1d, 0xca, 0x24, 0xa7, 0x55, 0x63, 0xec, 0x9b, 0x2c, 0xc7, 0xc5, 0xd0,
+  0x28, 0x2a, 0xe9, 0xac, 0x70, 0xce, 0x05, 0x1a, 0xb6, 0xd1, 0x35, 0x69,
+  0x0f, 0xa0, 0xdd, 0x67, 0xb7, 0x19, 0x6e, 0x9e, 0xbc, 0xf5, 0x7a, 0x5d,
+  0xe1, 0x36, 0x7f, 0x67, 0xb4, 0x11, 0xe2, 0x7e, 0x6f, 0xe0, 0xdd, 0x33,
+  0x2f, 0xe8, 0x43, 0x46, 0xcc, 0x74, 0x45, 0x5e, 0xb9, 0xa0, 0xb8, 0x6a,
+  0x0a, 0x4f, 0x0a, 0xfc, 0x5e, 0x67, 0xaf, 0x2e, 0xbe, 0x8e, 0x2a, 0xb3,
+  0x2e, 0xa5, 0x47, 0x48, 0x11, 0x8a, 0x79, 0xdd, 0xc8, 0x05, 0x79, 0x3f,
+  0x1e, 0x27, 0x48, 0x18, 0x59, 0xe4, 0x93, 0x2a, 0xa5, 0x6f, 0xd2, 0x8f,
+  0xe9, 0xa7, 0x86, 0xac, 0x3b, 0xc3, 0x9d, 0x7d, 0xf3, 0x7a, 0xfc, 0xbb,
+  0x83, 0x03, 0xd2, 0xe2, 0xd7, 0x66, 0x5f, 0x76, 0xcc, 0x2b, 0x45, 0x6d,
+  0x6e, 0xe6, 0x72, 0x54, 0x97, 0xbb, 0x10, 0xdb, 0xb5, 0xa8, 0x03, 0xe9,
+  0xb5, 0x91, 0xb6, 0xa0, 0x23, 0x25, 0x6a, 0x73, 0x9c, 0xc1, 0x9e, 0x80,
+  0xd1, 0x49, 0x36, 0x8d, 0xe1, 0x17, 0x46, 0x5e, 0x2f, 0x42, 0x85, 0x7c,
+  0x27, 0x3f, 0x1d, 0x4b, 0x2e, 0x4a, 0x3a, 0x35, 0x7f, 0x25, 0x47, 0xc1,
+  0x2e, 0xad, 0xac, 0x7d, 0xc3, 0x74, 0x55, 0x63, 0xd6, 0x46, 0x2f, 0xc8,
+  0x7c, 0x41, 0x0a, 0x4d, 0xc8, 0x15, 0x8a, 0xee, 0xe5, 0x72, 0x69, 0x4a,
+  0x20, 0x87, 0x49, 0x3a, 0xfd, 0x74, 0x93, 0x56, 0x33, 0xb6, 0x87, 0x0c,
+  0xc5, 0x4c, 0xf2, 0x45, 0xde, 0xdc, 0xb1, 0x5d, 0xdb, 0xb5, 0xa9, 0x39,
+  0x3e, 0x4a, 0x1b, 0x68, 0xee, 0xd1, 0xa5, 0x31, 0xf9, 0x49, 0xfb, 0x24,
+  0x15, 0x3f, 0x6f, 0x7c, 0x93, 0x16, 0x2a, 0x52, 0x63, 0x55, 0x1c, 0xfb,
+  0xed, 0x40, 0x3c, 0x36, 0x7c, 0x8f, 0x30, 0x4d, 0x47, 0xbb, 0xca, 0x06,
+  0x7d, 0x26, 0xa5, 0xe4, 0x93, 0xd4, 0x77, 0x46, 0xca, 0x2f, 0x93, 0x88,
+  0x8a, 0x88, 0xec, 0xa1, 0xe4, 0x9b, 0xec, 0xce, 0xd8, 0xcf, 0x79, 0xe1,
+  0x38, 0x25, 0xdb, 0xf7, 0x19, 0x59, 0x77, 0xac, 0x8b, 0xe6, 0xea, 0x4c,
+  0xcf, 0x24, 0x1e, 0xc2, 0x92, 0x24, 0x74, 0x20, 0xf0, 0xfb, 0xaa, 0x87,
+  0xd3, 0x10, 0xdb, 0x75, 0x8b, 0x25, 0xe3, 0x4b, 0xe1, 0x21, 0x8e, 0xcd,
+  0xcf, 0x8b, 0x22, 0x5b, 0xc8, 0xf1, 0x5d, 0x6c, 0x3a, 0x00, 0xfb, 0xac,
+  0x99, 0xf2, 0x77, 0x7c, 0xa3, 0x3b, 0xc3, 0x3d, 0xe3, 0xe0, 0x7e, 0xda,
+  0xa8, 0x4c, 0xd2, 0xac, 0x21, 0x63, 0x15, 0xed, 0xdb, 0x5f, 0x8d, 0x7a,
+  0x3f, 0x13, 0xdc, 0xa6, 0xca, 0x1d, 0x7a, 0xfb, 0xcc, 0xd9, 0x29, 0x8a,
+  0x43, 0xa6, 0x33, 0x96, 0x23, 0xfe, 0xa3, 0xd5, 0xac, 0x10, 0xc0, 0xe8,
+  0x0c, 0xe7, 0x6b, 0xd9, 0x2a, 0xc3, 0x64, 0x1d, 0xdb, 0x46, 0x4f, 0x2d,
+  0x2b, 0xf8, 0x8b, 0xaa, 0xd2, 0x9c, 0x75, 0xeb, 0x3c, 0x77, 0x58, 0xd9,
+  0xe8, 0x5e, 0x13, 0xe1, 0xe6, 0xde, 0xc6, 0xec, 0xc6, 0x2e, 0x7a, 0xa0,
+  0x99, 0x84, 0x26, 0x6b, 0xaf, 0xc5, 0xd9, 0x96, 0xd0, 0xe0, 0xd2, 0x2f,
+  0x0d, 0x1b, 0xfb, 0xd7, 0x05, 0x34, 0x33, 0x43, 0x30, 0xbf, 0x50, 0x66,
+  0x09, 0x2d, 0xb6, 0x04, 0xf5, 0x3b, 0x95, 0xc8, 0x34, 0x09, 0xeb, 0x82,
+  0x5d, 0x71, 0xc2, 0x00, 0x2b, 0x8e, 0xec, 0x4b, 0x0e, 0xcd, 0x00, 0x72,
+  0x07, 0x8a, 0xcb, 0xf1, 0xc5, 0x56, 0xb2, 0x93, 0x8d, 0x2e, 0xcd, 0x78,
+  0x5b, 0x34, 0xce, 0xc1, 0x0b, 0xfa, 0xef, 0x21, 0xfe, 0xfb, 0x68, 0x4b,
+  0x53, 0xfb, 0xfc, 0xad, 0x27, 0x69, 0xde, 0x95, 0x45, 0x1c, 0x8f, 0x73,
+  0xc2, 0x7d, 0xc0, 0x3e, 0xe6, 0x3e, 0xc6, 0xc3, 0x3a, 0xeb, 0x09, 0xef,
+  0x72, 0xa8, 0x6e, 0xe9, 0x36, 0x2c, 0xd9, 0x1f, 0x71, 0x9d, 0xb1, 0x43,
+  0xc4, 0xac, 0x6c, 0x6a, 0xd4, 0x43, 0xb8, 0x11, 0xf5, 0x56, 0x4d, 0x3f,
+  0x56, 0xd9, 0x55, 0x5a, 0x5f, 0x25, 0xeb, 0x86, 0x89, 0xd0, 0xd0, 0x6d,
+  0x77, 0xb8, 0xd5, 0x22, 0x77, 0x9e, 0x36, 0xf9, 0xf4, 0x48, 0xed, 0x3e,
+  0x77, 0x8a, 0x1c, 0x01, 0x59, 0x94, 0x37, 0xfa, 0xcc, 0x50, 0x72, 0xed,
+  0x62, 0x6a, 0x81, 0x39, 0x4d, 0xf8, 0x4d, 0xe8, 0x31, 0x3f, 0x92, 0xbd,
+  0x24, 0x6d, 0x92, 0x12, 0x01, 0x0d, 0x8b, 0x9b, 0x9b, 0x1d, 0x23, 0x8b,
+  0x6e, 0x81, 0x73, 0x23, 0xdb, 0x15, 0xf3, 0x0e, 0x4c, 0x53, 0xd1, 0xf3,
+  0xf2, 0xb9, 0x78, 0x6f, 0xe5, 0xdf, 0x90, 0xa7, 0xa2, 0x7d, 0xd5, 0x1c,
+  0xed, 0xee, 0xaa, 0x5e, 0xf7, 0x93, 0xb6, 0x32, 0x48, 0xab, 0xe9, 0xc8,
+  0x62, 0x39, 0x60, 0xa2, 0x74, 0x9d, 0x5f, 0xc2, 0xd6, 0x88, 0x39, 0x30,
+  0xd8, 0x29, 0xf5, 0x2f, 0x5d, 0x12, 0x33, 0xe3, 0x21, 0xf9, 0x4b, 0xd7,
+  0xf5, 0x03, 0xee, 0x88, 0xc7, 0x74, 0xf9, 0x1d, 0xeb, 0x2f, 0xe6, 0xa8,
+  0xbe, 0xbf, 0x01, 0x5d, 0x2a, 0xbc, 0xf3, 0x08, 0xe3, 0xb5, 0x77, 0xb3,
+  0xc6, 0x3c, 0xd0, 0xb9, 0xb8, 0x48, 0x76, 0xd2, 0x4f, 0xe9, 0x28, 0x39,
+  0x7d, 0x3d, 0x3e, 0xa3, 0x4f, 0x18, 0xea, 0x28, 0x2e, 0xcd, 0x2c, 0x4e,
+  0xc6, 0x9d, 0xe1, 0xb2, 0xdb, 0x26, 0x2b, 0xea, 0x98, 0x83, 0x32, 0xdc,
+  0x66, 0x8d, 0x22, 0x68, 0x7a, 0x8d, 0x4c, 0xd6, 0x58, 0xfa, 0x88, 0x8b,
+  0x53, 0x98, 0x97, 0x72, 0x30, 0x12, 0xbe, 0x6a, 0xc1, 0x87, 0x56, 0xe6,
+  0xe6, 0xcf, 0x76, 0xad, 0xab, 0x66, 0xa0, 0xb4, 0x60, 0xc3, 0x85, 0xf5,
+  0xfa, 0x92, 0x6c, 0x90, 0x5a, 0xed, 0x46, 0xfb, 0x05, 0xb3, 0x1b, 0xa1,
+  0xaa, 0x20, 0xcb, 0xb6, 0x9e, 0x44, 0x63, 0x35, 0x51, 0x26, 0x15, 0x54,
+  0xa4, 0xa2, 0x74, 0xa3, 0x52, 0x36, 0x05, 0xb2, 0x46, 0x73, 0x04, 0xd8,
+  0xa6, 0x99, 0x51, 0x41, 0x67, 0x11, 0x25, 0x80, 0x0f, 0x45, 0x0d, 0xa7,
+  0xb9, 0x64, 0x8a, 0x46, 0xfc, 0x3f, 0x18, 0x68, 0xca, 0x2a, 0x1a, 0x51,
+  0x3d, 0x02, 0x15, 0x39, 0xf9, 0x49, 0x49, 0x61, 0x66, 0x53, 0x9d, 0xc6,
+  0xb3, 0xf7, 0xff, 0xab, 0x62, 0x6d, 0x36, 0x3e, 0x22, 0x8d, 0x49, 0xa9,
+  0x22, 0x31, 0x43, 0x1b, 0xb8, 0xc9, 0xb1, 0xf7, 0xf8, 0xa0, 0xed, 0xc7,
+  0x06, 0xb1, 0x19, 0x03, 0x20, 0x4b, 0x5e, 0xd2, 0x7f, 0xef, 0xe5, 0xca,
+  0x48, 0x5d, 0xc1, 0xf3, 0x12, 0xef, 0x64, 0xde, 0x29, 0xbe, 0x98, 0xa4,
+  0xcd, 0xa0, 0x03, 0xe9, 0x05, 0x72, 0x1b, 0x11, 0xdf, 0x1b, 0x24, 0x6f,
+  0x28, 0x21, 0xfb, 0xe8, 0xfd, 0x57, 0xa0, 0x81, 0xb3, 0x83, 0x43, 0x44,
+  0x97, 0xac, 0xf5, 0x30, 0xc3, 0x47, 0x6a, 0x76, 0x24, 0x70, 0x74, 0x38,
+  0x54, 0x7c, 0x21, 0x13, 0x06, 0x60, 0xa3, 0x14, 0x16, 0x44, 0xf6, 0xd0,
+  0xec, 0xd7, 0x93, 0x5f, 0x81, 0x21, 0x7a, 0x34, 0x90, 0x1d, 0x14, 0xc7,
+  0xcc, 0xa7, 0xec, 0xce, 0xfd, 0x0d, 0xbb, 0xea, 0x6d, 0xb5, 0x7b, 0xf8,
+  0xa5, 0xb7, 0x49, 0x7f, 0x7d, 0x41, 0x19, 0x4a, 0x46, 0x4b, 0x9d, 0xfd,
+  0xf8, 0xf3, 0x24, 0x62, 0x7c, 0xe7, 0x23, 0xce, 0x16, 0xf8, 0xb9, 0x34,
+  0x17, 0x88, 0x43, 0xff, 0xcc, 0xe2, 0x25, 0x1d, 0x9e, 0x32, 0xe5, 0x89,
+  0xe0, 0xd3, 0xc2, 0xaa, 0x24, 0x43, 0x4e, 0x00, 0x43, 0x42, 0x58, 0x77,
+  0xef, 0xa7, 0xe5, 0x22, 0x90, 0x75, 0x2d, 0xc3, 0x15, 0xfa, 0xfc, 0xa1,
+  0xc8, 0x37, 0x18, 0x73, 0xcc, 0x6c, 0x44, 0x8b, 0xee, 0x5e, 0x07, 0xab,
+  0x53, 0x43, 0xfd, 0x72, 0x92, 0x91, 0xde, 0xe4, 0x17, 0x11, 0xe6, 0xc6,
+  0xd4, 0x58, 0x53, 0x1a, 0x25, 0x4e, 0xe3, 0x8d, 0xa9, 0xff, 0xe6, 0x6c,
+  0x75, 0x6f, 0xcd, 0xa1, 0x93, 0x9f, 0xc9, 0xee, 0xda, 0xc0, 0xf7, 0x34,
+  0x19, 0x26, 0x57, 0xe5, 0xaa, 0x9f, 0x4b, 0x32, 0x69, 0x18, 0xc3, 0xe0,
+  0x8c, 0x03, 0xf1, 0x46, 0x49, 0x66, 0x55, 0xcb, 0x97, 0xcf, 0xe4, 0x47,
+  0x96, 0xe8, 0x96, 0xb7, 0x25, 0x5b, 0xb1, 0xa3, 0x68, 0x38, 0xf8, 0x29,
+  0x57, 0x28, 0xbf, 0xa6, 0xad, 0x53, 0xda, 0x71, 0x8e, 0xcd, 0xb6, 0xea,
+  0x5b, 0x16, 0xf4, 0x67, 0x41, 0x3e, 0xb1, 0x7f, 0x8b, 0x10, 0x64, 0x94,
+  0x16, 0xc9, 0x37, 0x2e, 0xb1, 0x0f, 0x28, 0x30, 0x94, 0x04, 0x29, 0x59,
+  0xe8, 0x8b, 0xbb, 0x07, 0x19, 0x74, 0xaa, 0x80, 0xa8, 0xdd, 0xe6, 0x19,
+  0x73, 0x81, 0xb5, 0xd3, 0x25, 0x10, 0xc3, 0xc6, 0x1b, 0x4a, 0x29, 0x61,
+  0xda, 0x25, 0xdf, 0x6b, 0x3e, 0xfd, 0x84, 0xc8, 0x8b, 0x48, 0x28, 0x7f,
+  0x7d, 0x9a, 0xb7, 0xc7, 0x19, 0xa7, 0x91, 0x23, 0x80, 0x2d, 0x49, 0x4e,
+  0x61, 0xa2, 0x49, 0x92, 0xce, 0x79, 0xc1, 0x3a, 0x5b, 0xaf, 0x97, 0xc1,
+  0xcc, 0xf5, 0xe3, 0x9b, 0xe3, 0xf3, 0x64, 0x87, 0x34, 0xf0, 0xae, 0x91,
+  0xab, 0xe2, 0x7d, 0x2f, 0x6b, 0xa6, 0x7b, 0xab, 0x4f, 0xf9, 0x9e, 0x31,
+  0x36, 0x67, 0x93, 0x5d, 0x6b, 0x44, 0xe1, 0x73, 0x44, 0x85, 0xd6, 0x30,
+  0x55, 0xcb, 0x14, 0xa6, 0x69, 0xe0, 0x7a, 0x74, 0xa6, 0x2a, 0x57, 0xb8,
+  0x58, 0x1b, 0x95, 0xb7, 0x89, 0x09, 0x1a, 0x21, 0x1a, 0xce, 0x8e, 0x40,
+  0x60, 0x27, 0x63, 0xbf, 0xb4, 0xb1, 0xb1, 0xbb, 0x77, 0x95, 0xb3, 0x1f,
+  0xc5, 0x91, 0xc3, 0x0e, 0x1c, 0x4d, 0xd9, 0x13, 0x71, 0xe1, 0xb4, 0xdf,
+  0x01, 0x25, 0x5b, 0xd2, 0xa6, 0xac, 0x48, 0x24, 0xcd, 0xc8, 0x0d, 0xd8,
+  0x1d, 0x0e, 0x9a, 0xdc, 0xd6, 0x68, 0x6f, 0x2b, 0xb1, 0xe9, 0xa5, 0x66,
+  0x97, 0x39, 0x7f, 0xda, 0x06, 0xbe, 0x0c, 0x89, 0xcd, 0xd7, 0xb5, 0xf5,
+  0x63, 0xa6, 0xf6, 0xbc, 0x46, 0x31, 0x86, 0xea, 0x1d, 0xa7, 0xd5, 0xb9,
+  0x8c, 0x6e, 0x8c, 0x9b, 0xe5, 0x5b, 0xeb, 0x32, 0x29, 0x1c, 0xd5, 0xd6,
+  0x0f, 0x5b, 0x89, 0x97, 0x9e, 0xd8, 0xca, 0x52, 0xcc, 0x5d, 0x02, 0x91,
+  0x27, 0x04, 0x8c, 0x44, 0xb6, 0x77, 0x78, 0x96, 0x2d, 0xf2, 0x65, 0x0e,
+  0xdb, 0xcb, 0x9f, 0xc2, 0x30, 0x16, 0x20, 0x74, 0x53, 0xfa, 0x21, 0x9c,
+  0x92, 0xa6, 0xfc, 0xa6, 0xf4, 0x6b, 0x33, 0x25, 0x78, 0xc4, 0x38, 0x23,
+  0x33, 0x6e, 0x35, 0xb7, 0x27, 0x64, 0x93, 0x86, 0x37, 0x44, 0x8e, 0xed,
+  0x5d, 0xea, 0x53, 0xe5, 0x9d, 0x4b, 0x44, 0x2f, 0x3d, 0x33, 0xb5, 0x64,
+  0xf5, 0x69, 0x5a, 0x1f, 0x1c, 0x74, 0x05, 0x5d, 0xed, 0x28, 0x4a, 0xec,
+  0xf7, 0xd4, 0x12, 0xe6, 0x87, 0xf3, 0xe3, 0x64, 0x87, 0x8a, 0x44, 0x9e,
+  0x3d, 0x39, 0x38, 0xdc, 0xf5, 0x33, 0x4b, 0x94, 0x01, 0x84, 0x72, 0xf3,
+  0x8e, 0x43, 0xb2, 0xde, 0x05, 0x5c, 0x94, 0xd3, 0x54, 0x34, 0x0e, 0x37,
+  0xf4, 0x2c, 0xbb, 0xce, 0xa7, 0x54, 0xa3, 0x43, 0x01, 0x79, 0xe2, 0xc1,
+  0x93, 0xcc, 0x4c, 0x32, 0xd8, 0x71, 0x97, 0xd1, 0xcb, 0xb3, 0x37, 0x26,
+  0x92, 0xd5, 0x94, 0x29, 0x6f, 0xda, 0xd0, 0x40, 0x23, 0x7b, 0xe7, 0xcf,
+  0x5a, 0xa2, 0x04, 0x69, 0x8f, 0x27, 0x88, 0xd6, 0xc5, 0x15, 0x34, 0xd0,
+  0x31, 0x06, 0x2e, 0xf0, 0x33, 0x1c, 0xca, 0x66, 0x09, 0xeb, 0xb5, 0xb1,
+  0x63, 0xca, 0x40, 0xe9, 0x1e, 0xa0, 0xcc, 0x69, 0x8b, 0x04, 0x49, 0x01,
+  0xe1, 0x9e, 0xba, 0x41, 0xed, 0xee, 0xfb, 0x9a, 0x50, 0x7b, 0xd4, 0xd0,
+  0x53, 0x0e, 0xc2, 0x31, 0x9a, 0x4b, 0x7c, 0xc8, 0xdf, 0xc8, 0xc9, 0xd4,
+  0x66, 0x9f, 0x72, 0x3c, 0x74, 0xf6, 0xe2, 0x35, 0x9c, 0xb0, 0xa2, 0xa0,
+  0xfc, 0x36, 0xd5, 0xc7, 0x03, 0x39, 0x6e, 0x5e, 0xdf, 0x53, 0x21, 0x04,
+  0x29, 0xa4, 0xfe, 0x46, 0xf6, 0xfc, 0x18, 0xe6, 0x09, 0x4f, 0xcf, 0x27,
+  0x71, 0xf4, 0x40, 0x29, 0xb6, 0x29, 0x1c, 0xa1, 0xaf, 0x58, 0x05, 0xbf,
+  0x39, 0xa2, 0x69, 0x39, 0xeb, 0x98, 0xec, 0xb4, 0x09, 0x9e, 0xc0, 0x03,
+  0xf7, 0xe3, 0x50, 0x25, 0x38, 0x5e, 0xdc, 0x93, 0x4d, 0x94, 0xca, 0xee,
+  0xf5, 0x9f, 0xc4, 0x03, 0x63, 0x1e, 0x35, 0xb0, 0xc0, 0x9f, 0xc5, 0x01,
+  0xef, 0xf1, 0x39, 0xbd, 0x0e, 0x24, 0x76, 0x6d, 0x95, 0x21, 0xa7, 0xab,
+  0x51, 0xb2, 0x78, 0x82, 0x8d, 0x0b, 0x2d, 0x1a, 0x4a, 0x1b, 0x44, 0x4a,
+  0x00, 0xe5, 0x7c, 0x75, 0xee, 0x26, 0x3b, 0x76, 0xcc, 0x75, 0xd9, 0x39,
+  0xe1, 0x20, 0x65, 0x72, 0xf6, 0xf6, 0x7b, 0xe5, 0x96, 0x31, 0x03, 0x1e,
+  0x8e, 0xa8, 0x3f, 0xda, 0xec, 0x30, 0x63, 0x51, 0x50, 0xa6, 0x5a, 0x2e,
+  0x59, 0x9f, 0xec, 0x26, 0x42, 0x38, 0x7c, 0xd7, 0x25, 0x33, 0xd2, 0x56,
+  0x6f, 0xbd, 0xc4, 0xef, 0xba, 0xb1, 0xa6, 0x92, 0x2d, 0x99, 0x3f, 0xfd,
+  0xc0, 0xbf, 0x66, 0x1e, 0x6b, 0xfe, 0xd5, 0x5c, 0xad, 0x97, 0x13, 0x73,
+  0x9e, 0x45, 0xf3, 0xa7, 0xad, 0x84, 0x83, 0xad, 0x73, 0xd9, 0xcf, 0x0d,
+  0x66, 0x67, 0xae, 0xf5, 0x3a, 0xea, 0x5b, 0x6c, 0xed, 0x1a, 0xcf, 0x4e,
+  0x6b, 0x07, 0x5c, 0x7e, 0x9e, 0x39, 0x3c, 0xf6, 0x65, 0x07, 0xaa, 0xde,
+  0x07, 0x43, 0x9e, 0x3f, 0xbc, 0xfb, 0xcb, 0x0f, 0xcf, 0x1f, 0x3d, 0x4e,
+  0x9f, 0xa5, 0xd3, 0xa7, 0xf3, 0xcf, 0xd3, 0x27, 0xb3, 0x27, 0xcf, 0x9e,
+  0x1f, 0x7e, 0xfe, 0x24, 0x7d, 0xf6, 0x78, 0x9e, 0x3e, 0x3d, 0xc8, 0x0e,
+  0x9e, 0xcf, 0x0f, 0x1f, 0xcd, 0x66, 0xf3, 0xec, 0xf3, 0xd9, 0xb3, 0x74,
+  0x6b, 0x04, 0xf3, 0x4b, 0xa7, 0x1e, 0xb2, 0x5a, 0x0d, 0xbc, 0xa5, 0xc9,
+  0xf8, 0xeb, 0x57, 0xc3, 0x83, 0xe4, 0x2a, 0xbb, 0xd5, 0x0b, 0xc6, 0x1e,
+  0x4d, 0x9b, 0x75, 0x97, 0x49, 0x5e, 0x75, 0xff, 0x62, 0xb5, 0x50, 0x90,
+  0xb2, 0xa6, 0xc9, 0x57, 0x02, 0x0d, 0x98, 0x77, 0x51, 0xb7, 0x95, 0xf3,
+  0xea, 0xac, 0xff, 0xf0, 0x85, 0xfa, 0xec, 0x69, 0x5d, 0xdd, 0xcb, 0x7f,
+  0x62, 0xde, 0x59, 0xbc, 0x4b, 0xa7, 0x46, 0x49, 0x32, 0x7b, 0x22, 0x0f,
+  0x8e, 0x8d, 0x69, 0x6b, 0xd8, 0xf4, 0x20, 0x91, 0xbf, 0x90, 0x97, 0xd8,
+  0x1b, 0xe3, 0xab, 0xaa, 0x5c, 0xaf, 0xce, 0xca, 0x45, 0x3e, 0xbd, 0xdb,
+  0x34, 0x9c, 0xff, 0x58, 0xeb, 0x17, 0x47, 0xcc, 0xc2, 0xf3, 0x3a, 0xfb,
+  0x0d, 0x4d, 0x2b, 0x8f, 0x1d, 0x3f, 0xc0, 0xb6, 0x1a, 0x4e, 0xf3, 0xd5,
+  0x15, 0xc5, 0x79, 0x5f, 0x22, 0xcb, 0x8f, 0x42, 0x33, 0xfc, 0x83, 0xb8,
+  0x4d, 0x35, 0x96, 0x1b, 0x59, 0xcb, 0x79, 0xea, 0xdb, 0xa2, 0x71, 0xe5,
+  0x5a, 0x02, 0xa7, 0x6e, 0x2a, 0xc9, 0x2c, 0xcd, 0x03, 0x3f, 0x9e, 0xfb,
+  0x10, 0xdf, 0x76, 0xd5, 0xb6, 0xd9, 0x79, 0x21, 0xbf, 0x1a, 0x25, 0xe7,
+  0x88, 0x93, 0xaf, 0x57, 0x6c, 0x5e, 0xc0, 0x9f, 0xcf, 0xbf, 0xeb, 0x5e,
+  0x34, 0x9a, 0xbc, 0x50, 0x0c, 0x17, 0xe2, 0x99, 0x1d, 0xfd, 0x70, 0x7e,
+  0xf2, 0xa2, 0xbb, 0x4f, 0x28, 0x36, 0xaa, 0x5f, 0xec, 0xed, 0x21, 0xe4,
+  0x73, 0x95, 0xde, 0xde, 0x8e, 0xea, 0x6c, 0x6f, 0x56, 0x4e, 0xeb, 0xbd,
+  0xba, 0x5e, 0xe8, 0x6e, 0xb4, 0x6b, 0xff, 0x7e, 0x05, 0x6f, 0x6e, 0xb9,
+  0x04, 0xdb, 0xca, 0x66, 0xc3, 0xba, 0x0e, 0x72, 0x83, 0xc6, 0xaf, 0x35,
+  0xf3, 0xe0, 0x48, 0x72, 0xd2, 0x20, 0xe7, 0x86, 0x66, 0x77, 0xc7, 0xe3,
+  0xaf, 0x13, 0x7d, 0x19, 0xdb, 0x6b, 0x43, 0xe2, 0x36, 0x2f, 0x67, 0x10,
+  0x51, 0xc3, 0x52, 0x61, 0xd8, 0x7f, 0xf4, 0x1d, 0x3a, 0xa4, 0x4e, 0x97,
+  0xfc, 0x87, 0xd4, 0xae, 0xe4, 0xcd, 0xc6, 0x44, 0xbe, 0xa7, 0x1d, 0x07,
+  0x88, 0x5d, 0x44, 0x3c, 0xfe, 0xaf, 0x4e, 0xb0, 0x34, 0x71, 0x4f, 0x3a,
+  0x8f, 0x50, 0xb7, 0x38, 0xdd, 0x50, 0xef, 0x65, 0x59, 0x19, 0xe1, 0xb1,
+  0xac, 0x63, 0x5e, 0x50, 0xbd, 0xe5, 0x35, 0xab, 0x7d, 0x35, 0xe7, 0x22,
+  0x9a, 0x61, 0x0a, 0x6f, 0x70, 0x73, 0x8c, 0xc8, 0x61, 0x1c, 0xf9, 0x87,
+  0x15, 0x8d, 0x6f, 0xe9, 0xe1, 0xf5, 0x79, 0xd1, 0xd6, 0x85, 0x0b, 0x7e,
+  0x40, 0x1c, 0x9b, 0xc9, 0x4a, 0x61, 0x59, 0x60, 0x21, 0x20, 0xf7, 0x1f,
+  0x62, 0x82, 0x74, 0x88, 0xaa, 0x2a, 0x3d, 0xa5, 0x76, 0xf8, 0x0d, 0x8c,
+  0x4b, 0x23, 0x1d, 0xf3, 0x4b, 0x0d, 0xaf, 0xf7, 0xe4, 0xd8, 0x91, 0xe8,
+  0x6a, 0x90, 0xbb, 0x2c, 0xe5, 0xe0, 0x24, 0x14, 0x28, 0x85, 0x0d, 0xa9,
+  0x25, 0x92, 0x9d, 0xc9, 0xe9, 0x40, 0xad, 0x2a, 0xf8, 0xe0, 0x26, 0x50,
+  0xcd, 0x8f, 0x7b, 0x9c, 0xd2, 0xa8, 0xf4, 0x5e, 0x62, 0x78, 0x71, 0x5f,
+  0x78, 0x89, 0x6d, 0xa4, 0x95, 0xc1, 0xcd, 0x60, 0x9e, 0xe9, 0x5a, 0x7b,
+  0xc8, 0xb9, 0xb5, 0x3a, 0x5f, 0xac, 0xc4, 0xb5, 0xbb, 0x1e, 0x4d, 0xbd,
+  0xd7, 0xbd, 0xcd, 0x51, 0x54, 0x9d, 0x22, 0xaf, 0x3f, 0x26, 0xda, 0x4b,
+  0x2f, 0x48, 0x4b, 0x03, 0x86, 0x32, 0xaf, 0xb1, 0x69, 0x93, 0x5a, 0xa9,
+  0x04, 0x85, 0xc0, 0x70, 0x20, 0x23, 0xf6, 0x28, 0xe3, 0x9c, 0x4a, 0xe9,
+  0x17, 0xa5, 0x53, 0xb0, 0x0c, 0xe1, 0x19, 0x5e, 0x88, 0x6a, 0xc4, 0x51,
+  0xc0, 0xb7, 0xb9, 0x26, 0x89, 0x93, 0x08, 0xb9, 0xb6, 0x8e, 0xb3, 0xbd,
+  0xf8, 0x67, 0x10, 0x5f, 0x13, 0x8d, 0x91, 0x3b, 0x7e, 0x46, 0xe7, 0x17,
+  0x73, 0x0d, 0x49, 0x56, 0x3e, 0x17, 0x3a, 0xe6, 0x28, 0xe1, 0x95, 0xa2,
+  0x4f, 0x2e, 0x32, 0x50, 0xcf, 0x76, 0x5d, 0x4a, 0xca, 0x26, 0x4d, 0x94,
+  0xe6, 0xc9, 0x73, 0xec, 0x92, 0xba, 0x2d, 0xe8, 0x6c, 0x19, 0x23, 0x69,
+  0xed, 0x72, 0xf5, 0xeb, 0x30, 0x5a, 0xe9, 0x36, 0x33, 0x66, 0xbd, 0x06,
+  0x75, 0x0f, 0x98, 0x48, 0x95, 0xe9, 0x17, 0x8a, 0xb2, 0x3b, 0x29, 0x9d,
+  0x47, 0x2c, 0x1f, 0x55, 0x73, 0xfb, 0xbd, 0x09, 0x68, 0x8e, 0xbf, 0x3d,
+  0xe5, 0x9e, 0xec, 0xcd, 0x2c, 0x71, 0x8f, 0x24, 0xce, 0xce, 0x74, 0xc7,
+  0x08, 0x7f, 0x03, 0x2a, 0x36, 0x6a, 0x9e, 0xfa, 0x0b, 0x9a, 0xd3, 0x17,
+  0xbb, 0x31, 0x3f, 0xb1, 0x1b, 0x49, 0x29, 0x8a, 0xee, 0xe9, 0xa2, 0xac,
+  0x35, 0xfe, 0x42, 0xca, 0x05, 0xd7, 0xdd, 0x1a, 0x6e, 0xf0, 0x9d, 0xfc,
+  0x80, 0x8f, 0xa6, 0x33, 0x1c, 0x3f, 0x35, 0x90, 0x29, 0xce, 0x9d, 0xb2,
+  0x21, 0xb6, 0xaa, 0x2b, 0x16, 0x26, 0x6d, 0xc3, 0x5a, 0x93, 0x2f, 0x92,
+  0x1f, 0x7e, 0x18, 0x24, 0xc6, 0x48, 0xee, 0x0c, 0xf7, 0x43, 0x63, 0x7e,
+  0x6a, 0x68, 0xf1, 0x07, 0x2e, 0x58, 0xfa, 0xe1, 0x9a, 0x8c, 0x40, 0x72,
+  0x30, 0xd7, 0x0b, 0x8a, 0x1e, 0xb1, 0x9a, 0xdd, 0xf6, 0xca, 0x71, 0x3d,
+  0xf4, 0x86, 0xd4, 0x2c, 0x67, 0xb7, 0x73, 0x2a, 0xa6, 0x39, 0xb0, 0xf5,
+  0xb2, 0x10, 0xeb, 0x84, 0x89, 0x13, 0xf7, 0x1e, 0x72, 0x60, 0xfb, 0x77,
+  0xdb, 0x8e, 0x90, 0x62, 0x7b, 0x57, 0x65, 0x2c, 0xe9, 0x21, 0xaa, 0x72,
+  0x4f, 0x4c, 0x69, 0xf5, 0x30, 0xcc, 0xcd, 0x84, 0xc3, 0xa5, 0xc4, 0x4c,
+  0x4f, 0xc9, 0xb9, 0xce, 0x65, 0x60, 0x5d, 0x31, 0xee, 0x4c, 0x49, 0xaa,
+  0x8d, 0x5b, 0x5d, 0xdd, 0xd5, 0x94, 0xc9, 0x21, 0xb3, 0x09, 0x6e, 0x4f,
+  0x6f, 0x82, 0xb1, 0xec, 0x3d, 0x15, 0xf5, 0x10, 0x1f, 0x20, 0xe6, 0xd7,
+  0x62, 0x9d, 0x66, 0x46, 0xdb, 0xc3, 0x6d, 0x1b, 0x0b, 0x93, 0x7c, 0x99,
+  0x20, 0x97, 0xde, 0x26, 0x67, 0xbb, 0xe4, 0xc3, 0xe0, 0x93, 0x5e, 0x52,
+  0x5c, 0xe9, 0xa7, 0x3b, 0xba, 0xe2, 0x76, 0xaa, 0x4e, 0xd5, 0x28, 0xbe,
+  0x7c, 0x5f, 0xf8, 0x4f, 0xc4, 0xe1, 0x84, 0xb4, 0x48, 0x98, 0x1e, 0x3a,
+  0x00, 0xbc, 0x21, 0x2e, 0x3c, 0x34, 0x1c, 0x02, 0x67, 0x64, 0xc5, 0xd8,
+  0x20, 0x44, 0x12, 0xc8, 0x3c, 0xb8, 0xa3, 0x4a, 0xb0, 0xd5, 0x22, 0xe0,
+  0xb7, 0x92, 0x0a, 0xa8, 0xc5, 0xd6, 0x74, 0xc1, 0x09, 0x90, 0xe2, 0xa6,
+  0x10, 0x40, 0x81, 0x71, 0x09, 0xaf, 0xcc, 0x14, 0x39, 0x0c, 0x92, 0x2e,
+  0x23, 0x35, 0x65, 0x11, 0x2b, 0x90, 0x64, 0x60, 0xa0, 0x03, 0xd1, 0x7c,
+  0xbe, 0x48, 0xb6, 0xfa, 0x35, 0xa1, 0xad, 0xee, 0x1b, 0xc8, 0x80, 0x74,
+  0x2e, 0x4e, 0xa9, 0x97, 0xc7, 0x44, 0x76, 0x24, 0x93, 0x6e, 0xf8, 0x77,
+  0x4e, 0x68, 0xe3, 0x92, 0x2e, 0x91, 0xaf, 0xbb, 0x9c, 0x20, 0x5c, 0x47,
+  0x22, 0xfb, 0x2e, 0xcb, 0xca, 0xa3, 0x0f, 0x97, 0xa7, 0x94, 0xc3, 0x7d,
+  0x0d, 0xe9, 0xc5, 0xd2, 0xce, 0x7b, 0x3a, 0x08, 0xc5, 0xeb, 0xdb, 0x54,
+  0x71, 0x42, 0xdf, 0x13, 0x97, 0xb4, 0x8a, 0x0e, 0x7b, 0xa3, 0x57, 0x0b,
+  0xe0, 0x74, 0x68, 0xad, 0x0b, 0x54, 0xa2, 0x60, 0x77, 0x0e, 0x76, 0x6d,
+  0x75, 0x24, 0xc0, 0x36, 0x38, 0x33, 0x5b, 0xf4, 0x84, 0xad, 0xab, 0x92,
+  0x73, 0x89, 0xb6, 0x5e, 0x50, 0xe1, 0x9e, 0xdc, 0x46, 0xac, 0x51, 0x61,
+  0x10, 0x3a, 0xc3, 0x21, 0x53, 0xeb, 0xeb, 0xd3, 0x77, 0x47, 0xed, 0x0c,
+  0x5c, 0xfc, 0x24, 0xe6, 0x7c, 0x35, 0xec, 0xea, 0xad, 0xe1, 0x30, 0x4c,
+  0x03, 0x69, 0xa0, 0xcd, 0x31, 0x6d, 0x99, 0x69, 0x5d, 0x66, 0xcd, 0xea,
+  0x66, 0x9d, 0xcf, 0x76, 0x76, 0x89, 0x46, 0xa8, 0xdc, 0x64, 0x88, 0x1a,
+  0x27, 0x36, 0x0d, 0xeb, 0x64, 0x87, 0x15, 0xf4, 0x2a, 0x6b, 0xd6, 0x55,
+  0xc1, 0x0e, 0x73, 0x9a, 0x7b, 0xd7, 0xc8, 0x32, 0xd2, 0x99, 0x45, 0x9d,
+  0xef, 0x1c, 0x10, 0xcc, 0x1c, 0x4e, 0x61, 0xe2, 0x01, 0x8d, 0xb9, 0x7b,
+  0x6a, 0xf3, 0x3e, 0x70, 0xf0, 0x58, 0x4b, 0x20, 0xbf, 0xfc, 0x9d, 0x48,
+  0x5e, 0x9d, 0x9d, 0xbd, 0x79, 0x75, 0xf1, 0xca, 0xae, 0x0d, 0x02, 0x1a,
+  0xcc, 0x05, 0x1a, 0xb2, 0xe1, 0x43, 0xa4, 0x35, 0xd1, 0x93, 0xdb, 0xbf,
+  0xff, 0x30, 0x3e, 0x3a, 0xef, 0x1e, 0xec, 0xd9, 0xf9, 0x29, 0x01, 0x12,
+  0xfd, 0xfe, 0x87, 0x57, 0xab, 0xd5, 0x42, 0x83, 0x82, 0x6f, 0xd2, 0x26,
+  0xdd, 0x0e, 0x6e, 0xf5, 0xe1, 0x2e, 0xcd, 0xef, 0xc6, 0xce, 0x6f, 0x2e,
+  0x42, 0x0e, 0xa6, 0x7e, 0xf2, 0x91, 0x0e, 0xb4, 0x9a, 0x6a, 0xfa, 0xad,
+  0xdd, 0x0d, 0x6c, 0x00, 0xb2, 0x67, 0xfb, 0x17, 0x52, 0x3a, 0x4e, 0xa6,
+  0x89, 0x64, 0xba, 0x59, 0x0b, 0x63, 0x64, 0x67, 0xd3, 0x75, 0xa3, 0x24,
+  0x0f, 0xfa, 0xa2, 0x2a, 0xee, 0xee, 0xbe, 0x04, 0xc7, 0xe3, 0xc2, 0x28,
+  0xcc, 0x05, 0x00, 0x22, 0x60, 0x08, 0x0d, 0x29, 0xd2, 0x23, 0x99, 0x2d,
+  0x73, 0xb1, 0x08, 0x4d, 0xcd, 0x32, 0x0e, 0xab, 0x00, 0x54, 0x80, 0xa7,
+  0x14, 0x6c, 0xc8, 0xef, 0xcc, 0x6d, 0x1c, 0x26, 0x47, 0x52, 0xed, 0x86,
+  0x85, 0x9b, 0x1f, 0x04, 0x0f, 0x35, 0xd6, 0x7c, 0x10, 0x76, 0x1f, 0xe7,
+  0x15, 0x1e, 0xd0, 0xc6, 0x56, 0x57, 0x04, 0x70, 0x69, 0xab, 0x79, 0x88,
+  0xa6, 0x4d, 0x9b, 0x0e, 0xeb, 0x69, 0x2b, 0x92, 0xf4, 0x34, 0x4c, 0x2f,
+  0x89, 0xbc, 0xcc, 0xa3, 0x46, 0xbb, 0x36, 0x46, 0x13, 0xfd, 0x6b, 0xef,
+  0x60, 0xb4, 0xbf, 0x15, 0x4e, 0x9e, 0x2e, 0x0b, 0x40, 0x52, 0x6c, 0x54,
+  0x8d, 0xb8, 0x61, 0x53, 0x96, 0xf7, 0xce, 0x8f, 0x59, 0x98, 0xd1, 0x4f,
+  0x57, 0x66, 0xfc, 0xe8, 0x54, 0x86, 0xa7, 0x41, 0x16, 0x08, 0x65, 0xee,
+  0x56, 0xca, 0x14, 0x0d, 0x4f, 0x2c, 0xca, 0x1b, 0x5a, 0x89, 0x21, 0xb5,
+  0xc5, 0xa2, 0x85, 0x66, 0xb3, 0x15, 0xdf, 0xe6, 0x02, 0xc0, 0x51, 0x59,
+  0x77, 0xb7, 0xa3, 0x91, 0x6b, 0x55, 0x3e, 0x7d, 0x0d, 0xcf, 0xa6, 0xbc,
+  0xc2, 0x8a, 0xb4, 0x94, 0xe0, 0x83, 0x09, 0x18, 0x2e, 0x17, 0xf0, 0xbd,
+  0x85, 0x9f, 0x99, 0x31, 0xd4, 0xf4, 0x90, 0x21, 0x0d, 0x42, 0x5a, 0xe9,
+  0x4b, 0xae, 0x55, 0x0f, 0x6c, 0xf9, 0x77, 0xe9, 0x6d, 0xbe, 0x5c, 0x2f,
+  0xf1, 0x31, 0xa2, 0x6d, 0x79, 0x4c, 0xe2, 0x09, 0xf0, 0x2a, 0x72, 0x7a,
+  0x0a, 0x88, 0x7c, 0xbb, 0x4e, 0x3c, 0x8b, 0x3e, 0x26, 0x64, 0x8c, 0x48,
+  0x1e, 0xb9, 0xe5, 0x41, 0x59, 0x40, 0xc0, 0xa1, 0xee, 0x78, 0x03, 0x8c,
+  0x7e, 0x90, 0x52, 0xce, 0x41, 0x5d, 0xda, 0x84, 0x9d, 0x08, 0x3b, 0x67,
+  0xb0, 0x04, 0xd1, 0xe1, 0xbc, 0x7c, 0xd5, 0xac, 0xca, 0xcb, 0x99, 0xbd,
+  0x37, 0xa4, 0x3f, 0xe6, 0xc5, 0xda, 0xec, 0x33, 0xfb, 0x92, 0x39, 0x08,
+  0x41, 0xbf, 0x0a, 0x3c, 0x84, 0xc8, 0xaa, 0x1f, 0xa3, 0x58, 0x42, 0x53,
+  0x50, 0x9f, 0x8d, 0x1e, 0x1d, 0x8e, 0xf6, 0x07, 0x2d, 0x83, 0x5e, 0x30,
+  0x25, 0xcc, 0xed, 0x9a, 0xe6, 0x4b, 0x5b, 0x6f, 0x3a, 0xfa, 0xcd, 0x1c,
+  0x37, 0xc8, 0x08, 0x5f, 0xa6, 0xb7, 0x38, 0xbe, 0xe8, 0xb1, 0x96, 0xc9,
+  0xcb, 0xaf, 0x4f, 0xc7, 0x17, 0x07, 0x2f, 0xce, 0x4e, 0xcf, 0xcd, 0x7f,
+  0xe9, 0xef, 0x87, 0xf8, 0xfb, 0x61, 0x60, 0x55, 0xbe, 0x95, 0x0c, 0x5a,
+  0x2d, 0xd6, 0x81, 0x86, 0x02, 0x8d, 0x86, 0x77, 0x33, 0xf1, 0x06, 0x22,
+  0xbd, 0x1c, 0x6c, 0x70, 0x6a, 0x2b, 0x1a, 0xbb, 0x47, 0xec, 0x7d, 0x4a,
+  0x93, 0xec, 0x46, 0x49, 0x98, 0xc8, 0x97, 0x37, 0xaa, 0x4d, 0x49, 0x2d,
+  0xbc, 0x56, 0xd9, 0x77, 0x7d, 0xdd, 0x5c, 0xc7, 0x2c, 0xf5, 0x39, 0x8a,
+  0x57, 0x87, 0xdc, 0xb0, 0xf6, 0xaf, 0xa6, 0x0b, 0xa3, 0xdd, 0x67, 0x94,
+  0x4b, 0x32, 0xcb, 0x38, 0xc0, 0x42, 0x3f, 0x89, 0x19, 0x26, 0xe6, 0xfa,
+  0x49, 0xc9, 0x42, 0x90, 0x60, 0x08, 0x8a, 0xd4, 0xa8, 0x8e, 0x99, 0x8d,
+  0x99, 0x63, 0x6e, 0x34, 0x71, 0xde, 0x8e, 0x22, 0x0b, 0x2a, 0x04, 0x18,
+  0x47, 0xce, 0x77, 0x62, 0xa1, 0x48, 0x1f, 0xe5, 0xf6, 0xef, 0x4f, 0x2f,
+  0x92, 0x74, 0x3e, 0x57, 0x6c, 0x00, 0x2a, 0x4b, 0x20, 0x8d, 0x75, 0x6f,
+  0xc5, 0x92, 0x2c, 0x6d, 0x62, 0xa9, 0x1b, 0xa2, 0x8f, 0x5c, 0x9c, 0x8c,
+  0xf7, 0xc8, 0x85, 0xc5, 0x49, 0x70, 0xe3, 0xf7, 0xc7, 0x83, 0x96, 0xaf,
+  0xda, 0x4f, 0x7d, 0xd9, 0x25, 0x49, 0x19, 0x57, 0x28, 0x52, 0x4f, 0x16,
+  0x3a, 0xc4, 0x19, 0x4a, 0xaa, 0xc3, 0x91, 0x6e, 0x49, 0x35, 0xd8, 0x16,
+  0x8e, 0x76, 0x2b, 0xd1, 0xa8, 0x29, 0xec, 0xe2, 0xe5, 0xaa, 0xb9, 0x0b,
+  0xeb, 0x45, 0xe1, 0xdb, 0x20, 0x1c, 0x16, 0x52, 0x3a, 0xb6, 0xc8, 0x2c,
+  0xa1, 0x65, 0x61, 0x49, 0x5b, 0x23, 0x1e, 0xf6, 0x70, 0x0b, 0xa3, 0x62,
+  0x50, 0xf3, 0x77, 0x1a, 0x13, 0x44, 0x3b, 0xc9, 0x62, 0xe9, 0xfd, 0xfc,
+  0x21, 0x6f, 0xf0, 0xc4, 0x0e, 0x6f, 0x26, 0x66, 0xeb, 0xd4, 0x94, 0x3a,
+  0x88, 0xc1, 0x94, 0x55, 0x7e, 0x49, 0x79, 0x02, 0xdd, 0xd2, 0x31, 0x37,
+  0x91, 0xc0, 0x33, 0x45, 0xca, 0x58, 0xdd, 0x6c, 0x79, 0xae, 0x84, 0x26,
+  0x48, 0xd0, 0x47, 0xda, 0x68, 0xa5, 0x26, 0x8d, 0x4e, 0x87, 0xf8, 0x4f,
+  0x13, 0xd1, 0xe3, 0x59, 0xd9, 0x33, 0xab, 0x23, 0xb9, 0xe3, 0x82, 0x40,
+  0x5a, 0xfa, 0xa3, 0x77, 0x09, 0x48, 0x38, 0xc7, 0x8d, 0x32, 0x70, 0x0e,
+  0x1b, 0x75, 0x87, 0x63, 0xc4, 0x36, 0xc3, 0x11, 0xb4, 0xea, 0x63, 0xeb,
+  0xe0, 0xf0, 0xd9, 0x68, 0xdf, 0xfc, 0x9f, 0x39, 0x14, 0xd1, 0x8f, 0x00,
+  0x17, 0xe5, 0x60, 0x81, 0xec, 0x93, 0xd9, 0x6d, 0x97, 0x24, 0x59, 0x00,
+  0x95, 0xd5, 0xe5, 0xd6, 0xc6, 0x1a, 0xd6, 0x96, 0x48, 0xa1, 0x83, 0xb4,
+  0xe2, 0x24, 0x9d, 0xc9, 0x4f, 0xf4, 0x8e, 0x57, 0xeb, 0x45, 0x24, 0xad,
+  0xcf, 0x73, 0x23, 0x93, 0x76, 0xb6, 0xb8, 0x16, 0x27, 0xf2, 0xd7, 0xc4,
+  0x9b, 0xb8, 0x8e, 0x6f, 0xd4, 0x4a, 0x8a, 0x7a, 0xde, 0xf2, 0x09, 0xbe,
+  0x16, 0x93, 0x0d, 0x9c, 0x79, 0x68, 0x2e, 0xc3, 0xcb, 0x72, 0x3e, 0xaf,
+  0xb3, 0xa6, 0x2b, 0x80, 0x5e, 0xcb, 0x23, 0x7b, 0xe7, 0x00, 0x38, 0x04,
+  0xa7, 0xd2, 0x8a, 0x9b, 0xa4, 0x0d, 0xcb, 0x93, 0x48, 0x16, 0x1a, 0xb3,
+  0x2d, 0x1e, 0x6e, 0x14, 0x29, 0x32, 0xf0, 0x7f, 0xaf, 0x19, 0x22, 0x5c,
+  0x15, 0xaf, 0x60, 0x2f, 0x28, 0xb7, 0x62, 0x1c, 0x17, 0x91, 0x74, 0x5d,
+  0x54, 0x36, 0xbd, 0x12, 0x9f, 0xf2, 0xd5, 0x8a, 0xcc, 0x1b, 0x46, 0x38,
+  0x03, 0xd9, 0xda, 0x00, 0x1a, 0xe2, 0xb8, 0x20, 0x65, 0xcd, 0x16, 0x34,
+  0x4a, 0xf2, 0x54, 0x64, 0xfe, 0x24, 0x9b, 0x87, 0x41, 0x20, 0x4e, 0x6a,
+  0xf4, 0x61, 0x6d, 0xa4, 0x46, 0x77, 0x46, 0x10, 0x36, 0x45, 0xaa, 0x2c,
+  0x66, 0xee, 0x01, 0x3e, 0x48, 0xf1, 0xdf, 0x20, 0x72, 0xff, 0x5d, 0x71,
+  0x96, 0xf5, 0xc3, 0x8d, 0x8f, 0xff, 0x9f, 0x23, 0x07, 0x42, 0x64, 0x51,
+  0x7e, 0xb8, 0xdc, 0x25, 0x56, 0x3c, 0x64, 0x6e, 0xe1, 0xf0, 0xb5, 0x39,
+  0xaf, 0x2d, 0x4c, 0xc5, 0xa5, 0x9a, 0x94, 0x9d, 0x72, 0x0c, 0xd8, 0x3d,
+  0xa4, 0x49, 0x40, 0x1b, 0xda, 0xa3, 0xba, 0xff, 0x40, 0x34, 0x30, 0x46,
+  0x25, 0xfb, 0x17, 0x65, 0x8d, 0xb8, 0x1d, 0x8d, 0x54, 0xcd, 0xf9, 0x35,
+  0x27, 0xa2, 0x2c, 0xee, 0xe5, 0x05, 0xa9, 0x8c, 0xac, 0xc0, 0x04, 0x25,
+  0x19, 0x5a, 0x07, 0xcb, 0x68, 0x27, 0xeb, 0xe6, 0x37, 0x8c, 0x9d, 0x54,
+  0x44, 0xbf, 0x80, 0xb1, 0xf3, 0x88, 0x7a, 0xca, 0x44, 0x4d, 0x58, 0x9d,
+  0xc3, 0xbf, 0x19, 0x2b, 0xfb, 0xa5, 0xba, 0x29, 0xfa, 0x80, 0x01, 0xd4,
+  0xa9, 0x41, 0x45, 0x14, 0x30, 0xc2, 0x40, 0x1b, 0x16, 0x9f, 0x46, 0xb7,
+  0x9a, 0x61, 0x75, 0x52, 0xe8, 0x32, 0x00, 0x02, 0xed, 0xde, 0xf9, 0x39,
+  0x40, 0x6f, 0xbc, 0xf2, 0x6f, 0x5b, 0x3b, 0x39, 0xa2, 0x28, 0xd5, 0x82,
+  0x47, 0xa8, 0x39, 0xb1, 0x52, 0xc6, 0x50, 0xa3, 0x21, 0x0f, 0x64, 0x6e,
+  0x5e, 0x0c, 0xb9, 0xb8, 0x5a, 0x9f, 0x45, 0x30, 0x8d, 0x50, 0xdb, 0x84,
+  0x1c, 0xf9, 0x88, 0xd8, 0x0c, 0x6f, 0x24, 0xb1, 0x02, 0x6a, 0x2d, 0x3e,
+  0x1b, 0x73, 0xa3, 0xb3, 0x2f, 0x12, 0x0e, 0x44, 0xfe, 0x38, 0x39, 0xc8,
+  0x3e, 0x19, 0xdd, 0xb9, 0x18, 0xd0, 0x4f, 0x51, 0x88, 0x6a, 0x2f, 0x19,
+  0xfb, 0x36, 0x9a, 0x8c, 0x83, 0x16, 0x59, 0x44, 0x97, 0xf5, 0x9e, 0x95,
+  0x47, 0x3d, 0x37, 0xca, 0xfb, 0xac, 0x91, 0xd4, 0x11, 0x9e, 0xbc, 0xd6,
+  0x66, 0xa1, 0xbe, 0xeb, 0x78, 0xde, 0x19, 0x0e, 0x70, 0x71, 0x59, 0xd3,
+  0xae, 0xd6, 0x97, 0x18, 0x2e, 0x63, 0x64, 0x91, 0x2f, 0x74, 0x60, 0xae,
+  0xc1, 0x96, 0xfa, 0x65, 0x79, 0x05, 0xf1, 0xd4, 0x05, 0x9d, 0x0e, 0xb9,
+  0x89, 0x9a, 0x59, 0x8c, 0x26, 0x59, 0xf7, 0xd5, 0x0b, 0x29, 0xd0, 0x81,
+  0x7e, 0x3a, 0x04, 0x81, 0xa0, 0x21, 0x7a, 0xef, 0xbe, 0xa6, 0x89, 0x2b,
+  0x91, 0xaa, 0x42, 0xaf, 0xaa, 0x94, 0x52, 0x68, 0xaa, 0x99, 0x7a, 0x46,
+  0x74, 0xa2, 0x86, 0x0b, 0x8b, 0x5d, 0x74, 0x93, 0x82, 0xd2, 0xec, 0xf8,
+  0xb1, 0xda, 0x07, 0x2f, 0xff, 0x71, 0x38, 0x71, 0xe4, 0xec, 0xe0, 0x73,
+  0xa2, 0x69, 0x4a, 0xf2, 0x10, 0xd1, 0xbc, 0x11, 0x2c, 0xdb, 0x8d, 0x57,
+  0x5c, 0x0a, 0x44, 0x1a, 0xbb, 0x29, 0xbc, 0x85, 0x37, 0x57, 0xe5, 0x22,
+  0x8b, 0x85, 0x48, 0xbc, 0x92, 0x5f, 0x80, 0xbb, 0x50, 0x5a, 0x2f, 0xbc,
+  0xcd, 0xd7, 0xc8, 0x18, 0x6e, 0x85, 0x4e, 0x8c, 0x7e, 0x97, 0xa5, 0x54,
+  0x70, 0x64, 0x93, 0xe6, 0xaf, 0x07, 0x41, 0x1a, 0xbb, 0xb9, 0xe7, 0x93,
+  0xb2, 0xb6, 0xf4, 0x42, 0x85, 0xb5, 0x24, 0x41, 0x6e, 0xd2, 0x0a, 0x8c,
+  0x59, 0x50, 0xb2, 0x14, 0x40, 0xd4, 0xcf, 0x19, 0x24, 0x55, 0xb0, 0x5b,
+  0xef, 0x90, 0x53, 0x31, 0xba, 0x21, 0x13, 0xa3, 0x00, 0x90, 0x9b, 0x16,
+  0xb4, 0x43, 0x43, 0x0a, 0xfe, 0xd5, 0x15, 0xa0, 0x70, 0xa5, 0x62, 0xdd,
+  0xdc, 0xc3, 0x2b, 0x92, 0xe9, 0x79, 0xb3, 0x4e, 0x9b, 0x87, 0x25, 0x6c,
+  0xf7, 0xf1, 0x26, 0x66, 0x4e, 0x7e, 0x3e, 0x6a, 0x1f, 0x66, 0x43, 0x4f,
+  0x14, 0xd1, 0x3f, 0xc8, 0x97, 0x74, 0xd7, 0xfe, 0xc7, 0x3d, 0x8c, 0xe9,
+  0x0c, 0x88, 0x7e, 0x57, 0x6d, 0x48, 0x28, 0xd4, 0xe4, 0x8a, 0x3c, 0xd1,
+  0xca, 0x37, 0x1e, 0x53, 0xc5, 0xfd, 0x71, 0x24, 0xd0, 0x8f, 0xe8, 0x98,
+  0x99, 0xce, 0xe2, 0xce, 0x0d, 0xe8, 0x95, 0xcc, 0x6a, 0x86, 0xb7, 0x07,
+  0x97, 0x67, 0xbf, 0x10, 0x64, 0x2d, 0x6d, 0x8d, 0x8d, 0x0a, 0xce, 0xdf,
+  0x7c, 0xb1, 0xa5, 0xe8, 0xa3, 0x16, 0x4e, 0x49, 0xb8, 0x88, 0x14, 0x6d,
+  0x69, 0xfd, 0x87, 0xfa, 0xea, 0xe9, 0xfa, 0x77, 0x87, 0x23, 0x28, 0xee,
+  0x83, 0x2f, 0xbe, 0x7d, 0x75, 0xf2, 0xe1, 0xe8, 0xe0, 0x8f, 0x09, 0xfd,
+  0xeb, 0x90, 0xff, 0x75, 0xb8, 0x15, 0x3b, 0x2e, 0xc3, 0xa8, 0xb6, 0xbf,
+  0xd8, 0x4e, 0xea, 0xbb, 0xe5, 0xa4, 0x5c, 0xd8, 0x03, 0x93, 0xad, 0xd0,
+  0x40, 0xda, 0x40, 0xa4, 0xb8, 0x2d, 0xdd, 0x16, 0x57, 0x79, 0x97, 0x65,
+  0xd7, 0x92, 0x74, 0xa8, 0xec, 0x06, 0x11, 0x3c, 0xbf, 0x96, 0xb8, 0x41,
+  0xa5, 0xb5, 0xf2, 0x30, 0x89, 0xe5, 0xf5, 0x25, 0x82, 0x42, 0x28, 0xe9,
+  0xc5, 0xae, 0x23, 0x9c, 0x83, 0xc5, 0x8b, 0x83, 0x74, 0xf6, 0x19, 0x46,
+  0x98, 0x6d, 0x66, 0xb8, 0x13, 0xae, 0x94, 0xc5, 0x9d, 0xe6, 0xd7, 0xc5,
+  0x40, 0x20, 0x34, 0x8e, 0x3b, 0xc1, 0x1f, 0xd8, 0xae, 0x32, 0xcb, 0x7a,
+  0xb1, 0x6a, 0x7a, 0xb7, 0x3b, 0xdc, 0x44, 0x74, 0x17, 0x0f, 0x9a, 0xeb,
+  0x84, 0xd0, 0xc0, 0x86, 0x9a, 0x9e, 0xe1, 0x5c, 0x1d, 0x64, 0x8c, 0xce,
+  0x48, 0xb3, 0x56, 0x7f, 0x46, 0xe2, 0x81, 0x3f, 0x5b, 0x18, 0x49, 0xc1,
+  0x61, 0x4c, 0x5a, 0x21, 0x41, 0xf6, 0x35, 0x87, 0xd0, 0x2b, 0x0c, 0x04,
+  0x63, 0x36, 0x07, 0xe9, 0x26, 0xcb, 0x20, 0x3b, 0xab, 0x30, 0x9a, 0xe4,
+  0x8e, 0x61, 0xef, 0xbb, 0x3e, 0x26, 0x88, 0x1e, 0x9f, 0xb8, 0x25, 0x1a,
+  0x1b, 0x51, 0xed, 0x89, 0x15, 0x5c, 0x5c, 0xb5, 0x04, 0x8d, 0xaa, 0x7c,
+  0x5a, 0xe0, 0xcc, 0xf1, 0x59, 0x91, 0x1c, 0x3c, 0x0c, 0x93, 0x29, 0x65,
+  0x6f, 0x2e, 0xd2, 0x00, 0x89, 0x06, 0x77, 0x4d, 0xe1, 0x30, 0x28, 0xd0,
+  0x6f, 0x09, 0xdf, 0x7c, 0xff, 0x6e, 0x91, 0xed, 0xaa, 0x61, 0xa0, 0xc2,
+  0x6e, 0xef, 0x5d, 0xf9, 0x0f, 0x33, 0xef, 0x54, 0x3e, 0x12, 0x93, 0x99,
+  0x22, 0x02, 0x7b, 0x67, 0xee, 0xf8, 0x0b, 0x97, 0x89, 0xfb, 0x5c, 0xa3,
+  0x65, 0x1b, 0x23, 0x08, 0x4c, 0x7a, 0x19, 0x52, 0xb5, 0x03, 0xd2, 0x11,
+  0xed, 0x22, 0x90, 0xd0, 0x1e, 0xde, 0x8c, 0x21, 0xe5, 0x52, 0x32, 0x74,
+  0x2c, 0x89, 0x89, 0xd8, 0xe9, 0xb2, 0xf0, 0xae, 0x4e, 0xd5, 0x23, 0x88,
+  0x8e, 0x6e, 0xb3, 0x6a, 0x4a, 0x50, 0x13, 0x53, 0xa3, 0x97, 0x82, 0x9f,
+  0xce, 0xc5, 0x3d, 0x45, 0xb9, 0x54, 0x92, 0x15, 0xdf, 0xc6, 0x85, 0x81,
+  0xf8, 0x55, 0x3a, 0xeb, 0x25, 0x31, 0xe4, 0x3e, 0x4c, 0x0d, 0x61, 0x8c,
+  0x2c, 0x04, 0x9e, 0x0a, 0xc8, 0x36, 0xfb, 0xd0, 0x22, 0x33, 0x84, 0x13,
+  0x82, 0x8c, 0x3d, 0xec, 0xb0, 0xbe, 0xe8, 0x9d, 0xa6, 0x90, 0x0b, 0xe6,
+  0xc2, 0x80, 0x66, 0x2e, 0x3a, 0x44, 0x50, 0x01, 0xc0, 0x85, 0xea, 0x4f,
+  0x4f, 0xb4, 0xa7, 0x03, 0xfc, 0x0e, 0x44, 0x4b, 0x8a, 0x3b, 0x45, 0x93,
+  0xda, 0x81, 0xd8, 0x64, 0xe5, 0x50, 0x31, 0x07, 0xa1, 0x79, 0x85, 0xc5,
+  0xc8, 0x8b, 0xf2, 0x86, 0x62, 0x30, 0x6d, 0x04, 0x50, 0x05, 0xfb, 0xe1,
+  0x9c, 0x3a, 0xe6, 0xcb, 0x43, 0xd2, 0x95, 0xf8, 0xb3, 0x23, 0x8d, 0xd6,
+  0x46, 0x29, 0x40, 0xcb, 0x69, 0xbb, 0x95, 0x48, 0xa9, 0xcb, 0xa0, 0x68,
+  0xd8, 0x99, 0xcc, 0xfa, 0x85, 0x03, 0xe0, 0x8a, 0x09, 0x36, 0xac, 0x78,
+  0x52, 0x36, 0x57, 0x5e, 0x1e, 0x2a, 0x81, 0xfa, 0x91, 0x9f, 0x67, 0xbe,
+  0x6e, 0x60, 0x04, 0xa8, 0x19, 0xd8, 0x48, 0xaa, 0xb1, 0x38, 0x8b, 0x82,
+  0xac, 0x87, 0x4f, 0x04, 0xfe, 0x46, 0x4b, 0xb4, 0x00, 0xb6, 0x94, 0x40,
+  0x5b, 0x20, 0x53, 0x9c, 0xe8, 0xd2, 0x18, 0xc0, 0xc0, 0x17, 0x34, 0xdf,
+  0xa4, 0x44, 0xa5, 0xba, 0x26, 0x2c, 0x39, 0xa4, 0xa4, 0x9a, 0x8d, 0x0d,
+  0x20, 0x27, 0x00, 0x92, 0x54, 0xf8, 0x47, 0xba, 0xc3, 0xf0, 0x37, 0x0e,
+  0xb8, 0x89, 0x71, 0x31, 0xc8, 0x6a, 0x9f, 0xc8, 0xd1, 0xd4, 0xb8, 0xbf,
+  0x44, 0x0f, 0x11, 0xa7, 0x88, 0xd5, 0x5f, 0x7b, 0x2e, 0xec, 0xbf, 0x6c,
+  0xd4, 0x04, 0x46, 0x5e, 0x55, 0x33, 0x80, 0x2e, 0x20, 0x88, 0x6d, 0x62,
+  0x3c, 0xb6, 0x3b, 0x64, 0x5c, 0xa9, 0x8b, 0xbf, 0xc5, 0xe2, 0xbc, 0xeb,
+  0xd5, 0x0c, 0x6a, 0x9f, 0xbe, 0x03, 0x45, 0xc9, 0x03, 0xc2, 0xac, 0x4b,
+  0xb9, 0x8d, 0x18, 0x9e, 0x98, 0x8c, 0xe3, 0x32, 0x31, 0x90, 0x9c, 0xee,
+  0xfd, 0xf7, 0x03, 0x2c, 0x2d, 0xa4, 0x36, 0xf6, 0xe1, 0x2c, 0x7d, 0xde,
+  0x60, 0x5e, 0x84, 0xf0, 0x1d, 0x1a, 0xda, 0xaf, 0x63, 0x81, 0x4a, 0x15,
+  0xe0, 0x86, 0xc3, 0xff, 0x6d, 0x5d, 0x4c, 0x3b, 0x32, 0xaa, 0x1c, 0x78,
+  0x78, 0x9c, 0x12, 0x95, 0xb5, 0x12, 0xa2, 0x4b, 0xf4, 0xf8, 0x90, 0xc0,
+  0xdf, 0x50, 0x45, 0x28, 0x55, 0x6f, 0x90, 0x78, 0x5b, 0x78, 0x25, 0xb4,
+  0x57, 0xb9, 0x39, 0xa1, 0x6a, 0x7a, 0x05, 0x24, 0x01, 0xf8, 0x91, 0x32,
+  0x75, 0x8e, 0x06, 0x8a, 0xb0, 0x78, 0xfe, 0x31, 0xac, 0xe8, 0x62, 0x39,
+  0xb1, 0x23, 0x42, 0x0b, 0x29, 0x0b, 0x65, 0xd2, 0x7d, 0xf3, 0x0c, 0x33,
+  0xbb, 0xae, 0x68, 0xcf, 0xb3, 0x45, 0xed, 0x04, 0xa4, 0x7d, 0xc7, 0x49,
+  0x4a, 0x18, 0xe1, 0x05, 0x7c, 0xb2, 0x2c, 0x8a, 0xf3, 0xe8, 0x0d, 0xc7,
+  0x4c, 0x8c, 0x9a, 0x23, 0x93, 0x21, 0xbb, 0x92, 0xe8, 0xe4, 0x4e, 0x31,
+  0x66, 0x64, 0x84, 0x2e, 0xcc, 0x4c, 0x20, 0x79, 0x4a, 0xbb, 0x6f, 0x02,
+  0x60, 0xa3, 0x5b, 0x95, 0x2b, 0xde, 0x3a, 0x93, 0x0a, 0x39, 0x32, 0xa8,
+  0x7c, 0x1a, 0x7d, 0x40, 0x28, 0xfe, 0x35, 0x1c, 0xce, 0x9b, 0x20, 0x5d,
+  0xcb, 0x3b, 0xeb, 0x36, 0x09, 0x2c, 0xe6, 0x82, 0xd1, 0xf3, 0x4e, 0xd1,
+  0xf8, 0xae, 0xa9, 0x86, 0x27, 0x39, 0x79, 0xcb, 0x5e, 0xbc, 0xd7, 0xe7,
+  0xf4, 0xb7, 0xdc, 0x22, 0x14, 0xa1, 0x0e, 0x17, 0x8d, 0x3d, 0x38, 0x41,
+  0xf6, 0xdd, 0xb7, 0xdd, 0x32, 0xcc, 0x9d, 0xd3, 0xf1, 0xde, 0xa3, 0xe7,
+  0xfb, 0xbb, 0x91, 0x9c, 0x65, 0xf3, 0x0d, 0x1f, 0xa7, 0xf0, 0xf1, 0xfe,
+  0x68, 0x7f, 0xb7, 0x33, 0x1b, 0xda, 0xee, 0x0d, 0x00, 0x2a, 0x8a, 0xae,
+  0x6e, 0x85, 0x06, 0x92, 0x91, 0x5d, 0xb1, 0x96, 0xe4, 0x4d, 0xfb, 0xc5,
+  0xa4, 0xe7, 0xd9, 0xb5, 0x21, 0xb5, 0x68, 0xfe, 0xda, 0x49, 0x5e, 0x8b,
+  0x61, 0x43, 0x92, 0x4c, 0x65, 0x0b, 0x55, 0x6b, 0xb7, 0x73, 0x82, 0xf1,
+  0x08, 0x09, 0x4b, 0xce, 0x75, 0x88, 0x44, 0x5b, 0x6a, 0x33, 0xa9, 0x0a,
+  0x89, 0x79, 0x88, 0xe9, 0xff, 0xea, 0xce, 0x96, 0x57, 0x2d, 0xb4, 0xc7,
+  0x67, 0xfe, 0x99, 0x92, 0xa6, 0x3f, 0x4c, 0xeb, 0x69, 0x9e, 0xb3, 0x3d,
+  0xd3, 0x63, 0xc6, 0x68, 0xc6, 0x23, 0x30, 0xe4, 0x50, 0x49, 0x9d, 0xa7,
+  0x1c, 0xaa, 0x75, 0x40, 0xa5, 0xc1, 0xb0, 0xa4, 0xac, 0x1a, 0x12, 0xdb,
+  0x34, 0xae, 0xd8, 0xf0, 0xd4, 0xac, 0x45, 0xb0, 0x95, 0xad, 0x7e, 0x59,
+  0x77, 0xd5, 0x28, 0x73, 0x17, 0x18, 0xae, 0x6c, 0x55, 0x85, 0xf5, 0x7d,
+  0x94, 0x9b, 0x89, 0x8c, 0xe7, 0xb4, 0xa9, 0x4b, 0xda, 0xa7, 0xd8, 0xa6,
+  0xc2, 0x43, 0x01, 0x74, 0x5a, 0x6b, 0x40, 0xd9, 0xbb, 0x2f, 0xf9, 0x40,
+  0x5f, 0x0e, 0x5c, 0xba, 0x4e, 0xcb, 0x00, 0x4a, 0x23, 0x8a, 0x20, 0x83,
+  0xeb, 0x27, 0x08, 0x8f, 0x73, 0x25, 0x15, 0x2d, 0x44, 0x5a, 0x4c, 0xc0,
+  0xed, 0xc1, 0x39, 0x22, 0xd2, 0x60, 0x82, 0x60, 0x88, 0xec, 0x6e, 0x45,
+  0xc0, 0xa5, 0x06, 0x66, 0x7d, 0x80, 0xee, 0x04, 0x05, 0x15, 0xd9, 0x0d,
+  0x71, 0xe3, 0x5a, 0x54, 0x89, 0xaa, 0xca, 0xc9, 0x6f, 0x64, 0x93, 0x0b,
+  0x58, 0x1d, 0xa3, 0x2c, 0x4c, 0x12, 0xce, 0xb3, 0x48, 0x6d, 0xf7, 0x14,
+  0xb7, 0xb3, 0xb6, 0x39, 0xdb, 0x05, 0xe0, 0x27, 0x09, 0x5f, 0x2e, 0xd8,
+  0x1b, 0xf4, 0x07, 0xc0, 0xe4, 0x14, 0x74, 0xb6, 0x69, 0xa7, 0x7f, 0x90,
+  0xd6, 0xce, 0xf9, 0xcd, 0x0c, 0x6f, 0x56, 0xb6, 0x0c, 0xcc, 0xba, 0x3f,
+  0x5c, 0xb2, 0x77, 0x3b, 0xbc, 0xb9, 0xb9, 0x19, 0xd2, 0x85, 0xa3, 0x9c,
+  0x1c, 0x29, 0xb3, 0x18, 0xb5, 0xc0, 0xa3, 0x61, 0x57, 0xb2, 0xc9, 0x49,
+  0x4c, 0x24, 0x8c, 0x6f, 0x78, 0x29, 0x52, 0xd5, 0x24, 0x6f, 0x50, 0xcf,
+  0x27, 0xc4, 0x85, 0xd7, 0xa4, 0xae, 0x4e, 0xa6, 0x03, 0x0d, 0x47, 0x1d,
+  0x51, 0x91, 0xdb, 0xe7, 0xd6, 0x42, 0xf0, 0x53, 0xd3, 0x26, 0xa3, 0xfa,
+  0x75, 0xf3, 0x89, 0xe5, 0x8b, 0x64, 0xf8, 0x75, 0xb2, 0xf5, 0x5a, 0x56,
+  0x7b, 0x61, 0x9e, 0x78, 0xd1, 0x5e, 0x0b, 0x3f, 0x1c, 0x06, 0x73, 0xcc,
+  0xbb, 0x5b, 0x0f, 0x83, 0x4f, 0xec, 0xbd, 0xc8, 0xe8, 0xae, 0xe2, 0xb2,
+  0x66, 0x9a, 0x88, 0xb3, 0x8e, 0xd2, 0x5e, 0xd8, 0xad, 0xc5, 0x98, 0x67,
+  0x58, 0x7a, 0x5a, 0x4b, 0x27, 0x9e, 0x09, 0xdf, 0xf0, 0x0d, 0xd7, 0xb1,
+  0x4a, 0x6f, 0xee, 0xbf, 0xe3, 0xde, 0x4d, 0x14, 0xea, 0x5d, 0xc0, 0xd5,
+  0xe5, 0xe1, 0x11, 0x93, 0x7f, 0xc7, 0x26, 0x61, 0x46, 0x66, 0x2a, 0x7d,
+  0x30, 0x5c, 0x31, 0x15, 0x1b, 0xa6, 0xa2, 0x97, 0x7e, 0xb9, 0xa1, 0x0e,
+  0xcd, 0x39, 0x85, 0xdd, 0x2a, 0x5a, 0x91, 0x8f, 0x0e, 0xac, 0x29, 0x96,
+  0x65, 0xa9, 0xea, 0x01, 0x8c, 0xc6, 0xad, 0x6e, 0x60, 0x2f, 0xa7, 0xd0,
+  0x32, 0x3b, 0xf6, 0xbc, 0x65, 0x0a, 0x02, 0x6e, 0x2c, 0xbd, 0x93, 0xe3,
+  0x1c, 0x74, 0x55, 0x15, 0xa0, 0x4c, 0x5c, 0x56, 0x59, 0x45, 0x84, 0x8e,
+  0x2c, 0xf8, 0xa1, 0xa6, 0x30, 0xc7, 0x84, 0xb5, 0x61, 0x28, 0xaf, 0xbf,
+  0x3a, 0x46, 0x36, 0xb7, 0x61, 0xa4, 0x85, 0x80, 0x38, 0xf0, 0xfc, 0xb9,
+  0xe5, 0x91, 0x35, 0x6a, 0x2f, 0x89, 0x95, 0x70, 0x49, 0x64, 0x9a, 0xc4,
+  0x00, 0x50, 0xd5, 0xe6, 0x48, 0xd4, 0xb8, 0x90, 0xa4, 0x55, 0xb1, 0x11,
+  0xe4, 0xf2, 0xda, 0xf0, 0x6e, 0xea, 0x4a, 0x04, 0xa2, 0xfb, 0x85, 0xaf,
+  0x2b, 0xd8, 0x48, 0x5a, 0x4b, 0x04, 0x17, 0xca, 0x5a, 0x90, 0x3e, 0xee,
+  0xe8, 0x95, 0x5b, 0x48, 0x65, 0x61, 0xde, 0x9b, 0x7c, 0x3e, 0xde, 0xe1,
+  0x0d, 0x67, 0xd2, 0xf1, 0xa4, 0xd8, 0xad, 0xcb, 0x7c, 0x8f, 0x01, 0xd7,
+  0x62, 0x91, 0x2f, 0x2d, 0xe6, 0xb9, 0xb5, 0x89, 0x91, 0x86, 0x19, 0xff,
+  0x27, 0x49, 0x28, 0xc8, 0x5d, 0xc3, 0xf3, 0x48, 0xf3, 0xd0, 0x7a, 0x49,
+  0x7f, 0x34, 0x85, 0xf2, 0x93, 0x84, 0xd8, 0xf8, 0x70, 0x64, 0xff, 0x7d,
+  0x41, 0xda, 0xd2, 0x97, 0xe2, 0xa8, 0xa2, 0x3c, 0xf8, 0xda, 0xb3, 0x46,
+  0xa4, 0x58, 0x16, 0x73, 0xd7, 0x1a, 0x21, 0xda, 0x86, 0xf8, 0x70, 0x1c,
+  0xe1, 0xf4, 0x76, 0x8f, 0x29, 0x8e, 0x60, 0xe7, 0x6b, 0x6e, 0x23, 0xf6,
+  0x6f, 0xdd, 0xcd, 0xfb, 0xe2, 0xfe, 0xdd, 0xfb, 0xa9, 0xdb, 0xb7, 0x79,
+  0xf7, 0xb8, 0x7d, 0x83, 0x26, 0xcb, 0x7e, 0xe1, 0x39, 0xe8, 0x90, 0xec,
+  0xc1, 0xd6, 0x97, 0x75, 0xd4, 0xb5, 0xb9, 0x8c, 0x67, 0x64, 0x7e, 0xf1,
+  0x4b, 0x9d, 0x3a, 0x88, 0x11, 0x16, 0x3d, 0x4d, 0x3e, 0x3e, 0x1c, 0x87,
+  0x15, 0x71, 0xf6, 0x3e, 0xf6, 0xa2, 0xe8, 0xe1, 0x18, 0x41, 0xf0, 0x8b,
+  0xa7, 0x0d, 0x13, 0xf3, 0x04, 0x69, 0x9e, 0xc3, 0xf8, 0x70, 0x5a, 0x08,
+  0x28, 0x8a, 0x78, 0xb0, 0xbe, 0x2f, 0x55, 0xf0, 0x3f, 0x7c, 0x71, 0x48,
+  0x2b, 0x72, 0x2d, 0x03, 0xfd, 0x8c, 0x10, 0x0e, 0xc1, 0xec, 0x84, 0x7e,
+  0x43, 0xbd, 0x3e, 0x02, 0x03, 0xc9, 0x2d, 0xa4, 0x54, 0x25, 0xd8, 0x1d,
+  0xb4, 0x37, 0x8c, 0xa0, 0xee, 0x20, 0x0c, 0xf4, 0x94, 0xf3, 0xde, 0x33,
+  0xd6, 0xb3, 0xa3, 0xb6, 0x0c, 0xd1, 0xb3, 0xfb, 0x3f, 0x69, 0x7d, 0xa0,
+  0x67, 0x47, 0x06, 0x14, 0x61, 0xa8, 0x19, 0xc3, 0x1b, 0x49, 0xf7, 0x09,
+  0xaa, 0x15, 0x48, 0xc4, 0xf7, 0xcc, 0x0e, 0xe8, 0x03, 0xa4, 0x14, 0x51,
+  0xbc, 0x75, 0x21, 0x70, 0xa1, 0x0c, 0xf3, 0xfe, 0x85, 0x53, 0x66, 0x86,
+  0xb4, 0xc8, 0xa1, 0x90, 0xec, 0x08, 0x44, 0xb8, 0x81, 0x52, 0x2d, 0x65,
+  0xc6, 0x89, 0x32, 0x20, 0xbf, 0x7e, 0xd1, 0xa8, 0xf8, 0xaa, 0x22, 0xdb,
+  0x5b, 0x92, 0xf2, 0xe0, 0xf3, 0x96, 0xa4, 0x74, 0xef, 0x6c, 0x92, 0x91,
+  0xe3, 0x8c, 0x13, 0xd2, 0x7c, 0x07, 0x26, 0x5e, 0xe2, 0x2a, 0x6b, 0x6a,
+  0xe4, 0x11, 0xa6, 0x36, 0xd1, 0xab, 0x41, 0xd1, 0x31, 0xe7, 0x16, 0x79,
+  0xb5, 0x93, 0x48, 0x30, 0xa7, 0xa8, 0x99, 0x58, 0x47, 0xc9, 0xa4, 0x2a,
+  0x6f, 0x6a, 0xa8, 0xa3, 0x6a, 0xa0, 0xa6, 0x9c, 0x02, 0x7b, 0x15, 0x94,
+  0x44, 0x9b, 0xed, 0x5d, 0x58, 0x1c, 0xd8, 0xaf, 0x2f, 0xde, 0x9d, 0x70,
+  0x63, 0x07, 0xae, 0xce, 0xa5, 0x22, 0x24, 0x99, 0xf3, 0x7a, 0xb2, 0x34,
+  0x96, 0xb4, 0xd1, 0x4e, 0x1a, 0x66, 0x65, 0xca, 0x1d, 0x83, 0x12, 0x62,
+  0x84, 0xf4, 0x24, 0x20, 0xbc, 0x8a, 0xc5, 0x67, 0x44, 0x91, 0xf4, 0x70,
+  0xa8, 0x3c, 0x0d, 0xf8, 0xa7, 0xeb, 0xba, 0xc6, 0x4e, 0x46, 0x46, 0x0c,
+  0xf4, 0xa8, 0xb7, 0x74, 0x14, 0xf4, 0x48, 0x70, 0xfb, 0x3c, 0x35, 0x0d,
+  0xfd, 0xc7, 0x00, 0x29, 0x6d, 0x3d, 0x34, 0xa4, 0x75, 0xd9, 0xe6, 0x23,
+  0x40, 0xcd, 0x4a, 0xdb, 0x9a, 0x56, 0x50, 0x56, 0x6b, 0x35, 0x2f, 0xd7,
+  0x46, 0xc4, 0x57, 0xbe, 0x48, 0x0f, 0x21, 0x7d, 0x48, 0x02, 0x49, 0xeb,
+  0x8a, 0x9c, 0x79, 0xac, 0x55, 0x0f, 0x22, 0x39, 0xf7, 0xa2, 0x90, 0xa8,
+  0x37, 0xdf, 0x86, 0x36, 0x5b, 0xa6, 0x9e, 0xf6, 0x4b, 0xa0, 0xb1, 0xbd,
+  0x1b, 0x1c, 0x51, 0x12, 0x19, 0xa1, 0x0a, 0xc5, 0x14, 0x38, 0x4d, 0x43,
+  0x6c, 0x66, 0x74, 0xb4, 0x03, 0x4b, 0xe1, 0x1c, 0x0f, 0xd4, 0xbb, 0xa8,
+  0x82, 0xed, 0x9a, 0x89, 0xd4, 0xae, 0x7f, 0x84, 0xda, 0xcb, 0x00, 0xea,
+  0x02, 0x34, 0x17, 0x1a, 0x48, 0x94, 0x6d, 0x7f, 0x57, 0xe8, 0x7f, 0x14,
+  0xff, 0xd7, 0xc0, 0x0b, 0xaf, 0xe5, 0xe4, 0x81, 0xf2, 0xe3, 0x85, 0x2e,
+  0xb2, 0xbe, 0xcc, 0xaa, 0x4b, 0x2e, 0x43, 0x60, 0x48, 0xd8, 0x28, 0x8a,
+  0x45, 0x9a, 0x78, 0x28, 0x6d, 0x49, 0xf2, 0xdf, 0x86, 0x2c, 0x51, 0xe1,
+  0xaa, 0x5a, 0x53, 0xfd, 0x8b, 0xf8, 0xd3, 0xb7, 0x87, 0x33, 0x66, 0x2b,
+  0xb3, 0xb4, 0x30, 0x3b, 0x61, 0x6e, 0x6c, 0x98, 0x1f, 0xb3, 0x58, 0x7c,
+  0xb1, 0x28, 0xd7, 0xf5, 0xdd, 0x76, 0x22, 0xbd, 0x7c, 0xa4, 0xfd, 0x45,
+  0x23, 0xb9, 0x3c, 0x74, 0x96, 0xe6, 0x7c, 0xd7, 0xc5, 0x27, 0x15, 0x8a,
+  0x54, 0xa9, 0x50, 0xb3, 0xa3, 0xb6, 0x33, 0xdc, 0xb6, 0xf7, 0xb1, 0xff,
+  0xe6, 0x8f, 0x1d, 0xdd, 0x65, 0xb8, 0xff, 0xd9, 0x70, 0x7e, 0x98, 0xe5,
+  0xec, 0x42, 0x32, 0x31, 0xb3, 0x39, 0x69, 0x45, 0xea, 0xec, 0x80, 0x24,
+  0x3c, 0x18, 0x86, 0x57, 0x43, 0x0e, 0x2e, 0x75, 0x03, 0xfc, 0xa6, 0xa7,
+  0xf8, 0xc4, 0x49, 0x1e, 0x0e, 0x28, 0x39, 0xe4, 0x3c, 0x86, 0x30, 0xb1,
+  0xbd, 0x6f, 0xfc, 0x12, 0xb8, 0x51, 0x72, 0x66, 0xf6, 0x2b, 0x80, 0x9a,
+  0xa0, 0x48, 0xb6, 0x1d, 0x2e, 0x6d, 0x81, 0x9e, 0xce, 0xcb, 0x72, 0x92,
+  0x56, 0xdb, 0xb2, 0xf7, 0x40, 0x55, 0x37, 0x03, 0xce, 0xd8, 0xf9, 0x42,
+  0x67, 0x3d, 0x9c, 0x0d, 0xa2, 0x37, 0x9a, 0x74, 0x06, 0xbc, 0x3b, 0xd2,
+  0xa2, 0x0e, 0xfd, 0x39, 0x05, 0xc8, 0xcb, 0xc5, 0xcc, 0x6e, 0x85, 0xff,
+  0xd5, 0xc8, 0xa1, 0xa1, 0x36, 0xc1, 0xb9, 0x02, 0xd4, 0x13, 0x80, 0xf2,
+  0x16, 0x75, 0x16, 0x58, 0xa7, 0x3e, 0xa1, 0xb8, 0x13, 0x6c, 0x08, 0x25,
+  0x4e, 0xc4, 0x61, 0x5b, 0x24, 0x48, 0x62, 0x4d, 0x70, 0x8f, 0x39, 0xd0,
+  0x8c, 0x62, 0x3c, 0xc6, 0xf1, 0x94, 0xd0, 0xe1, 0xee, 0xb3, 0x2f, 0xc9,
+  0x56, 0xdd, 0x90, 0xe9, 0xe6, 0x73, 0x0d, 0x4f, 0x8e, 0x39, 0x63, 0xae,
+  0x2b, 0xdc, 0x36, 0xb8, 0x76, 0x1d, 0x2e, 0x2e, 0xd8, 0xab, 0xf0, 0x57,
+  0x76, 0x82, 0x0c, 0x8f, 0x35, 0x8b, 0x8e, 0xff, 0x79, 0x01, 0xc4, 0x66,
+  0x38, 0x27, 0x87, 0x11, 0xd2, 0x6c, 0x59, 0x97, 0xd9, 0x22, 0xbb, 0xe4,
+  0xd5, 0xbe, 0x3c, 0x39, 0xfa, 0xf6, 0xe8, 0x24, 0x10, 0x9b, 0x5f, 0x8d,
+  0xc7, 0x7b, 0x9f, 0xb2, 0x6a, 0x82, 0xa6, 0xac, 0x14, 0xb8, 0x48, 0xf0,
+  0x9c, 0x4d, 0xf0, 0xf2, 0x64, 0xc9, 0x8d, 0x83, 0x6c, 0x91, 0x44, 0xef,
+  0xc0, 0x67, 0x43, 0x19, 0xbc, 0xfc, 0x49, 0x81, 0x79, 0x47, 0xc9, 0x91,
+  0xe4, 0x12, 0x42, 0x36, 0x4e, 0xab, 0x6c, 0xc6, 0x3d, 0x4b, 0xc3, 0x2c,
+  0x42, 0x20, 0x7b, 0x50, 0x5f, 0x0e, 0x3a, 0x54, 0xce, 0x24, 0x47, 0x00,
+  0xcb, 0x2e, 0x22, 0x78, 0x63, 0x85, 0xea, 0xf9, 0xe4, 0x8d, 0x7c, 0x53,
+  0xea, 0x51, 0x69, 0x97, 0x18, 0xd8, 0x8d, 0xad, 0x94, 0xd3, 0x6f, 0x86,
+  0xaf, 0xc6, 0xc3, 0x37, 0x47, 0x27, 0x47, 0x5f, 0xbd, 0xba, 0x38, 0xb2,
+  0x78, 0xe6, 0x75, 0xd6, 0xa3, 0x82, 0x89, 0xfe, 0xf5, 0x8d, 0x6c, 0x0b,
+  0xd6, 0x4f, 0x58, 0xf8, 0x4d, 0xce, 0x0d, 0x59, 0x14, 0xf2, 0x9f, 0x3b,
+  0x6b, 0x93, 0x55, 0xd4, 0x70, 0x9e, 0x60, 0x7c, 0x38, 0x73, 0x2f, 0x16,
+  0x4b, 0x99, 0x6a, 0xb0, 0x82, 0x74, 0x71, 0x43, 0x8d, 0xd9, 0x3e, 0x14,
+  0x94, 0x4a, 0x9f, 0xdb, 0x52, 0x52, 0x5e, 0xbd, 0xef, 0x11, 0x72, 0x3b,
+  0xdb, 0x3a, 0x60, 0x20, 0xd3, 0xf7, 0xf8, 0x0b, 0xb4, 0x0c, 0x1c, 0xf1,
+  0xe3, 0x37, 0x78, 0xb2, 0x83, 0x31, 0xee, 0xa0, 0xd1, 0x89, 0xc1, 0xc8,
+  0xaf, 0x22, 0x80, 0x25, 0x44, 0x40, 0xf5, 0xf4, 0x2a, 0x5b, 0x8a, 0x2a,
+  0x4b, 0xa9, 0x09, 0x08, 0x82, 0x73, 0x4d, 0xa5, 0xe0, 0x05, 0x71, 0x0a,
+  0xd9, 0x24, 0x63, 0xc8, 0x05, 0x60, 0xa4, 0x11, 0x5d, 0xc7, 0x52, 0x7d,
+  0x6f, 0xa8, 0xe3, 0x00, 0xc5, 0x5a, 0x28, 0x6d, 0x07, 0x05, 0xc6, 0x23,
+  0x24, 0x18, 0x7a, 0x79, 0x03, 0x61, 0x9e, 0x00, 0x77, 0x0f, 0xec, 0xde,
+  0x59, 0x0b, 0x60, 0x6e, 0xd1, 0xd6, 0x4b, 0xb8, 0xce, 0xf0, 0x23, 0x6e,
+  0x5e, 0x22, 0x3a, 0x37, 0x4d, 0xf2, 0x67, 0x3a, 0xaa, 0xa5, 0x3c, 0x41,
+  0xca, 0x0d, 0xc9, 0x8d, 0x05, 0x33, 0x38, 0x9e, 0xb5, 0x1d, 0x65, 0x1a,
+  0xd2, 0x8d, 0xd5, 0x9b, 0x2e, 0xb3, 0x07, 0x86, 0x56, 0x9f, 0xc9, 0xe9,
+  0xe0, 0x47, 0xd2, 0x88, 0xc0, 0xa6, 0x78, 0x44, 0x5d, 0xf9, 0x8e, 0x63,
+  0xb4, 0x7b, 0x15, 0x10, 0x46, 0xbc, 0xfe, 0x35, 0xec, 0x28, 0x61, 0x4b,
+  0xed, 0x86, 0xd9, 0x2a, 0x00, 0xec, 0xde, 0x79, 0xab, 0xf8, 0xfb, 0x56,
+  0xb7, 0xf4, 0x7b, 0xad, 0x79, 0xad, 0x91, 0x8e, 0xce, 0xce, 0xb9, 0xbb,
+  0xfa, 0x09, 0xfd, 0x45, 0x22, 0x6f, 0x75, 0x0c, 0xff, 0x4e, 0xba, 0x7f,
+  0x50, 0x32, 0x4a, 0x86, 0xd0, 0x8d, 0x0d, 0xa6, 0x6b, 0x32, 0x22, 0xe7,
+  0x9f, 0x0a, 0xd0, 0xba, 0x5c, 0x07, 0x6c, 0x71, 0x90, 0xfc, 0x6f, 0x1b,
+  0x74, 0xd2, 0x4c, 0x68, 0x0a, 0x82, 0x50, 0x84, 0x49, 0x70, 0x0e, 0xad,
+  0x06, 0x48, 0x4e, 0xe9, 0x97, 0xa4, 0x6f, 0xb2, 0x5c, 0x6b, 0xfa, 0x38,
+  0x2f, 0xb7, 0x40, 0x10, 0x95, 0x88, 0x86, 0xa5, 0x37, 0x93, 0x0a, 0xed,
+  0x5c, 0x53, 0x33, 0x95, 0x51, 0x67, 0xa9, 0x68, 0xc8, 0x45, 0xb0, 0x9b,
+  0x61, 0x3c, 0x04, 0xad, 0xc8, 0xc4, 0x11, 0x27, 0x59, 0xe9, 0x58, 0xb0,
+  0xe6, 0xda, 0x0f, 0x24, 0xc7, 0x80, 0x2c, 0x08, 0xb4, 0x1d, 0xe2, 0x7a,
+  0x01, 0x24, 0x1f, 0x04, 0x1a, 0xbe, 0xd4, 0x24, 0x68, 0x26, 0x5a, 0x76,
+  0x27, 0x61, 0x73, 0x56, 0x08, 0xe7, 0x12, 0x9e, 0x4c, 0x01, 0x28, 0x0b,
+  0xd3, 0x66, 0xc2, 0x1a, 0x0c, 0xb2, 0xfa, 0xae, 0xd2, 0x22, 0x72, 0xe7,
+  0xcc, 0xc6, 0xdb, 0x9e, 0x68, 0x58, 0xa5, 0x1c, 0x5b, 0x44, 0x89, 0x27,
+  0xda, 0xe8, 0xc2, 0x5a, 0x19, 0x43, 0xcf, 0x30, 0xb0, 0x9c, 0xe2, 0x1a,
+  0x32, 0x15, 0xde, 0x19, 0x34, 0x06, 0x12, 0x7a, 0x2b, 0x63, 0x54, 0x25,
+  0xcc, 0xc5, 0x45, 0x5b, 0x5a, 0x24, 0xd8, 0x5f, 0xf4, 0x6d, 0x3d, 0xf3,
+  0xa8, 0xb0, 0xf1, 0x50, 0x75, 0xa9, 0xc7, 0x70, 0xbb, 0x04, 0x07, 0xc7,
+  0x07, 0x61, 0x5f, 0x74, 0x33, 0x50, 0x32, 0x2e, 0xba, 0x30, 0xdf, 0xc6,
+  0x74, 0xc9, 0x0d, 0x64, 0x23, 0xb2, 0x44, 0x3c, 0xc1, 0xf7, 0xdf, 0x60,
+  0x72, 0xf4, 0x1d, 0xbc, 0x80, 0x7b, 0x4f, 0xd0, 0x43, 0x97, 0xda, 0xe3,
+  0x89, 0x49, 0x79, 0x92, 0x99, 0xef, 0xe5, 0xd4, 0x03, 0xcf, 0x0f, 0x03,
+  0x84, 0x69, 0xce, 0xb5, 0x21, 0x40, 0x54, 0x05, 0x94, 0xec, 0x00, 0xa2,
+  0x77, 0x29, 0x97, 0x22, 0x4b, 0xfc, 0x06, 0x92, 0x20, 0x08, 0x58, 0x0c,
+  0x67, 0x03, 0x89, 0x67, 0x22, 0xbd, 0xb1, 0xac, 0xc2, 0x12, 0xd8, 0xa9,
+  0xc5, 0x5a, 0xd2, 0x27, 0xd3, 0xfa, 0x3a, 0x7e, 0xc3, 0xeb, 0xeb, 0xe8,
+  0x0d, 0x7f, 0xc0, 0x3d, 0x77, 0xf6, 0xd6, 0xd1, 0xd9, 0xf8, 0xdb, 0xa4,
+  0x07, 0x34, 0x82, 0x3b, 0xb9, 0xf0, 0x15, 0x77, 0xab, 0x23, 0xa2, 0xf7,
+  0xaf, 0x79, 0xff, 0x3d, 0x8f, 0xc6, 0x07, 0x82, 0x7b, 0x6e, 0xbe, 0x2f,
+  0x97, 0xfb, 0xec, 0xd5, 0xf8, 0x5b, 0xef, 0x5a, 0x7b, 0x24, 0x10, 0x2b,
+  0xc6, 0xb4, 0x99, 0xed, 0x14, 0x24, 0x66, 0xd2, 0xa1, 0xc1, 0xa2, 0xf4,
+  0x5e, 0x5f, 0x3f, 0x84, 0xde, 0xcd, 0x4c, 0x02, 0x7a, 0x0f, 0xf6, 0x78,
+  0x13, 0xbd, 0xfb, 0x07, 0xd5, 0x4e, 0x9a, 0xf5, 0xa8, 0xbd, 0xe0, 0x2e,
+  0xda, 0x54, 0xe0, 0xd1, 0x47, 0xe6, 0x14, 0x48, 0x14, 0xd2, 0x0e, 0x53,
+  0x09, 0x31, 0xcf, 0x9f, 0x46, 0xe8, 0xe6, 0x85, 0x80, 0xd0, 0xf5, 0x3c,
+  0xe3, 0x94, 0xde, 0x47, 0xe8, 0x9a, 0x52, 0x9c, 0x31, 0x91, 0xfb, 0x34,
+  0x1e, 0xd2, 0xb7, 0x47, 0xb5, 0x7e, 0x19, 0x78, 0xb8, 0x43, 0x9a, 0x69,
+  0xe6, 0xa0, 0x0c, 0x1c, 0x90, 0x43, 0x04, 0x5c, 0x44, 0x41, 0x19, 0xb8,
+  0x20, 0x36, 0x74, 0xe7, 0xdb, 0xd2, 0xfc, 0x56, 0xf5, 0x43, 0xa5, 0x1a,
+  0x36, 0x37, 0x56, 0x23, 0xa1, 0x0d, 0xf7, 0x80, 0x0f, 0x28, 0x30, 0x0f,
+  0x6e, 0x64, 0x0b, 0x3d, 0x28, 0x8b, 0x56, 0xa7, 0xd7, 0x19, 0xe5, 0x79,
+  0x00, 0x86, 0xac, 0x7b, 0x4f, 0x49, 0xcd, 0x83, 0x36, 0x40, 0x8a, 0xca,
+  0x30, 0x2f, 0x86, 0x61, 0x1a, 0xb4, 0x1f, 0xda, 0x6a, 0x5a, 0xd8, 0xb4,
+  0x54, 0xa2, 0x08, 0x85, 0x57, 0x82, 0x1c, 0xa4, 0x8c, 0xc2, 0xd2, 0x94,
+  0x98, 0x00, 0x7b, 0x25, 0x23, 0x05, 0xb5, 0x51, 0x84, 0xb5, 0x76, 0xbb,
+  0x97, 0xa6, 0x6c, 0x39, 0xe3, 0x9e, 0x76, 0x50, 0x8c, 0x67, 0x45, 0x3d,
+  0x74, 0x1d, 0xda, 0x5f, 0xda, 0xbf, 0x06, 0xf6, 0xc5, 0x9b, 0xf7, 0x63,
+  0x8a, 0x5c, 0x65, 0xa8, 0x35, 0x50, 0x33, 0xb8, 0xce, 0xb8, 0x3e, 0xe4,
+  0x12, 0x9c, 0xc3, 0x3c, 0x62, 0x0b, 0xfe, 0x6c, 0x53, 0xc4, 0x97, 0x51,
+  0x87, 0x10, 0x3e, 0x11, 0x14, 0xea, 0xa5, 0x5c, 0x70, 0x63, 0x6c, 0x3b,
+  0xc4, 0xc5, 0x69, 0x05, 0x6e, 0x6e, 0x5a, 0xd1, 0x0e, 0xcf, 0x53, 0x04,
+  0xe3, 0x48, 0xcb, 0xf2, 0x68, 0x1a, 0xbb, 0xda, 0x9e, 0x79, 0xc5, 0x88,
+  0xec, 0x82, 0x41, 0x66, 0x3b, 0x5c, 0x15, 0x9d, 0xae, 0xf4, 0xdd, 0xc5,
+  0x0a, 0x66, 0x92, 0xe4, 0x8c, 0xed, 0x6e, 0x34, 0x1e, 0x69, 0x03, 0x57,
+  0xd7, 0x8f, 0x87, 0xf4, 0xb0, 0xa4, 0x1f, 0xda, 0x9f, 0x3e, 0xc5, 0x4f,
+  0x47, 0xc1, 0x46, 0x07, 0x25, 0x34, 0xd2, 0x41, 0xd5, 0xa2, 0xe3, 0x52,
+  0x76, 0x63, 0x31, 0xa3, 0xce, 0x1b, 0x38, 0x7b, 0x6d, 0xa4, 0x40, 0x68,
+  0x89, 0x8c, 0x79, 0xe8, 0x9a, 0xb7, 0x25, 0x01, 0x4e, 0x8b, 0xd1, 0x6d,
+  0xea, 0xd6, 0xa1, 0x3f, 0x7a, 0x14, 0x39, 0x74, 0x3b, 0xe7, 0x97, 0xb2,
+  0xcc, 0xf8, 0x91, 0xb7, 0xa4, 0xcb, 0x24, 0xe7, 0xfe, 0x56, 0x2f, 0xf3,
+  0xd5, 0x50, 0xdf, 0x62, 0xe1, 0xb1, 0x4c, 0x3f, 0x89, 0x48, 0x7f, 0x2c,
+  0x74, 0x30, 0x0c, 0x60, 0x56, 0xb8, 0xdd, 0x32, 0xba, 0x52, 0xbb, 0x75,
+  0xb6, 0x88, 0x46, 0xf4, 0xad, 0xc6, 0x82, 0xb6, 0x12, 0x51, 0xf0, 0x77,
+  0x62, 0x35, 0x5f, 0x9a, 0x9d, 0xed, 0xfb, 0x78, 0xb4, 0xbe, 0x03, 0x33,
+  0xb1, 0xef, 0xde, 0x73, 0x7e, 0x8e, 0xc8, 0x36, 0x9f, 0x9f, 0xee, 0xd9,
+  0xff, 0x1a, 0xe7, 0xf7, 0xf4, 0x57, 0x39, 0xbf, 0xa7, 0xff, 0xcb, 0x9c,
+  0xdf, 0xd3, 0x7f, 0xf9, 0xfc, 0x1e, 0x07, 0xe7, 0xf7, 0xf4, 0x7f, 0x95,
+  0xf3, 0xd3, 0xfe, 0x6a, 0x7a, 0x7a, 0x59, 0x70, 0x7e, 0x63, 0x49, 0x1b,
+  0x51, 0x60, 0x3e, 0xda, 0x69, 0x7d, 0x8b, 0x83, 0x34, 0x92, 0xe8, 0xc8,
+  0x5e, 0x70, 0xcd, 0xb5, 0x65, 0x68, 0xc8, 0x9e, 0x86, 0x25, 0x23, 0x2d,
+  0xab, 0xd0, 0x41, 0x8f, 0xcf, 0x12, 0x3b, 0x01, 0xef, 0x18, 0x1c, 0xd0,
+  0x16, 0x14, 0xb4, 0xa8, 0x8b, 0xba, 0x26, 0xbf, 0xa5, 0x59, 0x3f, 0x97,
+  0x57, 0xd6, 0xae, 0x28, 0x38, 0x86, 0xa4, 0x65, 0x36, 0xee, 0xc5, 0x4b,
+  0xda, 0xae, 0x21, 0x3f, 0xfe, 0xa7, 0x68, 0xb1, 0x1b, 0x3a, 0x36, 0xbb,
+  0x29, 0xc5, 0xc2, 0x12, 0xde, 0xd6, 0xb9, 0x73, 0xb3, 0xd1, 0x2c, 0xef,
+  0xd0, 0x62, 0x67, 0xd6, 0x55, 0x75, 0xec, 0x09, 0xde, 0x7f, 0x64, 0xe5,
+  0x15, 0x70, 0x7c, 0x5e, 0x7e, 0x38, 0x0f, 0x7d, 0x6f, 0x66, 0xa9, 0x21,
+  0x34, 0xa2, 0x39, 0xae, 0x21, 0xd9, 0xf6, 0x43, 0xa0, 0xc4, 0x9b, 0xdb,
+  0x78, 0xfa, 0xf5, 0xae, 0xe7, 0x04, 0x42, 0xd0, 0xa2, 0x8c, 0xf5, 0xbb,
+  0xe3, 0xb2, 0x5b, 0x5b, 0x5a, 0x5e, 0x0f, 0x3a, 0x3d, 0x2e, 0x6d, 0xda,
+  0xbb, 0x53, 0x52, 0xe0, 0x1d, 0x91, 0x82, 0xdd, 0x2a, 0xe8, 0x6f, 0x49,
+  0xca, 0x60, 0x5e, 0x0b, 0x6a, 0x1c, 0xc1, 0x68, 0xa8, 0x1c, 0xc4, 0xcc,
+  0x7e, 0xcb, 0x8c, 0xbf, 0xa7, 0x87, 0xad, 0x5d, 0x7d, 0x03, 0x5d, 0x71,
+  0xbd, 0x5c, 0x49, 0x69, 0xf1, 0x3d, 0xa5, 0x95, 0x09, 0x77, 0x63, 0x44,
+  0xd9, 0x24, 0xbb, 0xf7, 0xa5, 0xca, 0x48, 0x2d, 0x73, 0x5b, 0x5a, 0x21,
+  0xe6, 0x7b, 0x2f, 0x30, 0x5a, 0x14, 0x8b, 0xea, 0xa2, 0x9b, 0x20, 0xc5,
+  0x15, 0x31, 0x8a, 0xaf, 0x4e, 0x5c, 0xd2, 0xd3, 0x9a, 0xa5, 0xd0, 0x01,
+  0x20, 0x00, 0xfc, 0xd5, 0x18, 0x38, 0x37, 0xa2, 0x84, 0x54, 0x60, 0x45,
+  0x73, 0x66, 0x74, 0x41, 0xf3, 0xaa, 0x19, 0x66, 0x24, 0x55, 0x56, 0xb5,
+  0x17, 0xa7, 0xb6, 0x85, 0x21, 0x00, 0x77, 0x8a, 0x55, 0x07, 0x20, 0xd8,
+  0x03, 0xf5, 0x56, 0xb2, 0xfa, 0x04, 0xba, 0xc3, 0x62, 0x33, 0x15, 0xd7,
+  0x5a, 0x7b, 0xd3, 0x6a, 0x51, 0x32, 0x9c, 0x84, 0xe1, 0x80, 0x56, 0x09,
+  0xe0, 0xbf, 0x81, 0x36, 0x7a, 0xca, 0x32, 0x58, 0x35, 0xf3, 0x1c, 0x13,
+  0x91, 0x9b, 0xe4, 0x57, 0x7d, 0x44, 0x5d, 0x01, 0x64, 0xe8, 0xe8, 0x02,
+  0xa5, 0x5f, 0x05, 0x37, 0x01, 0x69, 0xbb, 0xa4, 0x3a, 0x46, 0x12, 0x67,
+  0xff, 0x06, 0x09, 0x85, 0x02, 0x30, 0x10, 0x3d, 0xc6, 0x56, 0x0a, 0x38,
+  0xe7, 0x16, 0x5f, 0x65, 0x7e, 0xd5, 0xb4, 0x85, 0xa0, 0xe4, 0x28, 0x05,
+  0x27, 0x2f, 0x9a, 0x5d, 0x94, 0x4c, 0xd8, 0xa0, 0xe1, 0x10, 0x50, 0x11,
+  0x64, 0xea, 0x5b, 0x82, 0xe2, 0xb4, 0x16, 0xe8, 0x59, 0x6e, 0xb9, 0x0c,
+  0xd0, 0x9b, 0xdf, 0xae, 0x4a, 0xd9, 0xcb, 0x0c, 0xf7, 0x59, 0x54, 0x76,
+  0xc9, 0xe1, 0xff, 0x4d, 0x59, 0xc8, 0x1d, 0xc0, 0x35, 0x6e, 0x26, 0x6e,
+  0x21, 0xd7, 0xe0, 0x11, 0x2c, 0x9a, 0xaa, 0x5c, 0xdd, 0x25, 0x5f, 0xa5,
+  0xb4, 0x2c, 0xa8, 0xf5, 0x69, 0xb6, 0x0c, 0x4a, 0xd3, 0xb8, 0xbd, 0xb8,
+  0xa8, 0xd9, 0xdc, 0x6a, 0x5c, 0x57, 0x08, 0xbb, 0x80, 0xb7, 0xc5, 0x10,
+  0xab, 0xd9, 0x2f, 0x72, 0x26, 0x4b, 0xd9, 0x08, 0xa7, 0x5e, 0x8f, 0xc7,
+  0x27, 0xa1, 0x2d, 0xa7, 0x8d, 0x8d, 0x36, 0x62, 0x12, 0x60, 0xb4, 0x61,
+  0x37, 0x3a, 0x22, 0x83, 0xbf, 0x8c, 0x72, 0x0e, 0x59, 0x77, 0xb6, 0x50,
+  0xcc, 0x0e, 0xc5, 0x91, 0x9f, 0x56, 0x77, 0x2b, 0x32, 0xbe, 0xa4, 0x08,
+  0x97, 0xaf, 0x39, 0xcd, 0x8f, 0x41, 0x60, 0x37, 0x96, 0x3d, 0x7f, 0xa8,
+  0x3d, 0x2c, 0x75, 0xc8, 0x52, 0x8a, 0xdf, 0x13, 0x28, 0x32, 0x81, 0x5b,
+  0x89, 0x6c, 0x25, 0xa9, 0x33, 0x03, 0x9a, 0x4b, 0x6f, 0x8f, 0x33, 0xe9,
+  0x5c, 0xd6, 0xe9, 0x8e, 0xc1, 0xe6, 0x0c, 0x59, 0x5a, 0x84, 0x88, 0x88,
+  0x70, 0xca, 0xae, 0xca, 0x77, 0x79, 0x43, 0xaa, 0xf6, 0xba, 0x37, 0xc3,
+  0x36, 0x4f, 0x48, 0x09, 0xe1, 0xa1, 0x08, 0xa0, 0x64, 0x38, 0xcb, 0xe3,
+  0x60, 0x7f, 0xff, 0x5e, 0x8c, 0x20, 0xb1, 0x56, 0x37, 0x42, 0x05, 0x11,
+  0x3b, 0xe4, 0x00, 0x87, 0xad, 0x69, 0x4f, 0x73, 0x29, 0x58, 0xea, 0xa2,
+  0xaa, 0x99, 0x4f, 0x5a, 0xc8, 0x1e, 0x77, 0x05, 0x99, 0xad, 0x32, 0x94,
+  0x16, 0x00, 0x83, 0xcc, 0xdd, 0x3e, 0xc2, 0x1c, 0xeb, 0x17, 0xad, 0x77,
+  0xa2, 0x2d, 0xa5, 0x69, 0x42, 0xf4, 0x92, 0xe8, 0x9f, 0xa3, 0xe4, 0xcf,
+  0x77, 0xce, 0x6e, 0x07, 0x43, 0x64, 0x7f, 0x30, 0x66, 0xc5, 0x7e, 0x7e,
+  0x9e, 0xff, 0x68, 0x13, 0xeb, 0x8f, 0xe3, 0x00, 0xfd, 0x1b, 0x33, 0x16,
+  0x0c, 0x6b, 0xb8, 0xdd, 0xaa, 0xc6, 0xa8, 0x80, 0x13, 0x89, 0x3b, 0xac,
+  0xec, 0x6a, 0x8d, 0xfe, 0xd1, 0x6d, 0xb2, 0xe4, 0xf5, 0x4b, 0x62, 0x2e,
+  0xb8, 0x11, 0xcf, 0xb9, 0x8d, 0xea, 0xd4, 0xce, 0x42, 0x7d, 0xd6, 0x56,
+  0x53, 0xa8, 0xb4, 0x7a, 0x88, 0x02, 0xea, 0x2e, 0x6a, 0x04, 0xd5, 0x5c,
+  0x13, 0xef, 0x82, 0xaf, 0xa1, 0x2c, 0x3c, 0x0f, 0x0c, 0xa1, 0x89, 0x71,
+  0xe6, 0x8f, 0xd6, 0x5a, 0x75, 0x40, 0x6c, 0x7d, 0xc6, 0xaa, 0xc8, 0xfb,
+  0x7a, 0xd3, 0x67, 0xa5, 0x87, 0x5d, 0x65, 0xcb, 0xeb, 0x3a, 0xae, 0x1c,
+  0xf6, 0xe5, 0x84, 0xb0, 0x18, 0x9c, 0x41, 0xec, 0xdc, 0x84, 0x5c, 0x28,
+  0x8e, 0xec, 0x08, 0x68, 0x82, 0xac, 0x3a, 0x1a, 0x8d, 0x65, 0x90, 0x48,
+  0x27, 0x72, 0x4a, 0x18, 0xe7, 0x53, 0x8e, 0xaa, 0xb7, 0x0e, 0x56, 0x8d,
+  0xfb, 0x8c, 0xf1, 0x4a, 0x6a, 0x07, 0x07, 0x47, 0x4c, 0x9b, 0x7b, 0xa6,
+  0x99, 0x51, 0x6b, 0x9b, 0x1a, 0x16, 0x7a, 0x44, 0xbd, 0x0a, 0x6d, 0xf3,
+  0x24, 0x21, 0xd4, 0xd4, 0x6b, 0x78, 0xaf, 0x79, 0x78, 0x8b, 0xc0, 0xc6,
+  0x77, 0x92, 0x2b, 0xd7, 0xc9, 0x4f, 0x26, 0x15, 0xb8, 0x01, 0xdb, 0xa0,
+  0xe8, 0x38, 0x81, 0x37, 0x26, 0x38, 0x1c, 0x94, 0xc0, 0xaf, 0x2b, 0x2f,
+  0x46, 0xbe, 0x75, 0x95, 0x9b, 0x53, 0x2d, 0xb6, 0x00, 0x0c, 0xb9, 0x9e,
+  0x30, 0xe6, 0x68, 0xa3, 0x1f, 0x0d, 0x16, 0xbb, 0x5e, 0x78, 0x8e, 0xd9,
+  0x78, 0x9b, 0xf1, 0x56, 0xc2, 0xf7, 0x20, 0x69, 0x5d, 0x08, 0xd5, 0x27,
+  0x39, 0x6c, 0xef, 0x8a, 0xef, 0xf9, 0xdc, 0xa2, 0xde, 0x5c, 0x57, 0x88,
+  0x47, 0x37, 0x1f, 0x9d, 0xb9, 0x06, 0x7e, 0x5b, 0x1c, 0xe7, 0x68, 0x4e,
+  0x97, 0xe4, 0xc4, 0x61, 0x5d, 0x95, 0x76, 0x39, 0xda, 0xb4, 0x84, 0x0e,
+  0x42, 0x20, 0x5b, 0x22, 0x98, 0xc2, 0x92, 0xda, 0x97, 0xde, 0xa1, 0xea,
+  0xc8, 0x7e, 0x1a, 0xd4, 0x1d, 0x00, 0xc0, 0x11, 0x18, 0x62, 0x09, 0xcd,
+  0x5f, 0xe8, 0x98, 0xb6, 0x70, 0x5a, 0xe5, 0xab, 0x86, 0xf3, 0x11, 0x24,
+  0xb9, 0x7a, 0x23, 0x70, 0x8e, 0xf9, 0xdb, 0xe5, 0xa2, 0x9c, 0xa4, 0x7c,
+  0x47, 0x6c, 0x6e, 0x93, 0x7a, 0x3c, 0x5b, 0x80, 0xc5, 0xc4, 0xde, 0x88,
+  0x3c, 0x23, 0x0d, 0x17, 0xcc, 0x92, 0x87, 0x2f, 0xd0, 0x1d, 0x9e, 0x02,
+  0xa1, 0x9b, 0x3e, 0x68, 0x3f, 0xc1, 0xf0, 0x7f, 0xc3, 0xf9, 0x40, 0x6e,
+  0xaf, 0x56, 0x65, 0x23, 0x35, 0xac, 0xf6, 0xee, 0x54, 0xa0, 0x73, 0x01,
+  0x46, 0x61, 0xb6, 0xce, 0xda, 0x99, 0x62, 0xdb, 0x12, 0x26, 0x96, 0x96,
+  0x76, 0xc8, 0x56, 0xb2, 0x9d, 0x0a, 0x24, 0x1c, 0x1b, 0xcd, 0x82, 0x22,
+  0x80, 0x60, 0xc9, 0x5a, 0x1a, 0x18, 0xe3, 0xe3, 0x06, 0x15, 0x1a, 0x05,
+  0x49, 0x25, 0x37, 0x39, 0xcd, 0xbe, 0xf5, 0xf6, 0x8a, 0x81, 0x15, 0x42,
+  0x8a, 0x9f, 0xb3, 0x42, 0x08, 0xff, 0x25, 0x9f, 0xc9, 0x86, 0x9d, 0xf1,
+  0x51, 0xc6, 0xdb, 0x26, 0x82, 0xfd, 0x74, 0x5c, 0x3c, 0x81, 0xad, 0xd5,
+  0x64, 0x34, 0x90, 0x7f, 0x7f, 0xc7, 0x10, 0x8b, 0x54, 0xbf, 0xa5, 0x48,
+  0x3c, 0x00, 0x36, 0xa6, 0xb6, 0xf3, 0x63, 0x5e, 0x10, 0xaf, 0xcc, 0xa3,
+  0x9b, 0x42, 0x39, 0x6e, 0x8b, 0x3b, 0xce, 0xa2, 0xc1, 0x99, 0x43, 0xdf,
+  0x95, 0x98, 0x81, 0x12, 0x54, 0xd6, 0x4c, 0xbd, 0x5f, 0xce, 0xb2, 0x74,
+  0x11, 0xeb, 0x96, 0x41, 0x13, 0x26, 0x47, 0x37, 0xb3, 0x36, 0x82, 0x49,
+  0x29, 0x24, 0x64, 0x22, 0x39, 0xd6, 0x9c, 0x65, 0x28, 0xc6, 0x81, 0x9d,
+  0x21, 0x6e, 0x55, 0x44, 0xbb, 0xa6, 0xfe, 0x3d, 0x78, 0x00, 0xb5, 0xc3,
+  0x53, 0x41, 0x24, 0x40, 0xc0, 0xd3, 0x95, 0xe0, 0x10, 0xa6, 0x1b, 0x25,
+  0x24, 0xea, 0x03, 0xa0, 0x00, 0xe4, 0xc3, 0x77, 0x87, 0x13, 0x47, 0x2a,
+  0xd7, 0x85, 0x42, 0xc8, 0x68, 0xd9, 0x06, 0x4d, 0x8c, 0x73, 0x60, 0x88,
+  0x49, 0xee, 0xca, 0x3d, 0x44, 0x9e, 0x85, 0x70, 0x8e, 0x55, 0x78, 0xd2,
+  0xd7, 0x99, 0x66, 0x46, 0xc1, 0x94, 0xe1, 0x03, 0x68, 0x6c, 0xb1, 0x2c,
+  0x8d, 0x26, 0x7c, 0x86, 0x99, 0xcc, 0xe1, 0x61, 0x8f, 0xe9, 0x25, 0x7d,
+  0xd2, 0x85, 0xc6, 0x70, 0xd9, 0xeb, 0x74, 0x9e, 0x29, 0x70, 0xaa, 0xb0,
+  0xef, 0x72, 0x6a, 0xb6, 0x10, 0x41, 0x5a, 0x80, 0x12, 0x91, 0x76, 0x14,
+  0x58, 0xd0, 0xcc, 0x35, 0x89, 0x4b, 0x5a, 0x91, 0x4b, 0x17, 0x41, 0xd8,
+  0x6d, 0xbd, 0xc8, 0x57, 0xea, 0x9f, 0x1e, 0x24, 0x99, 0x64, 0x15, 0x2d,
+  0xee, 0xe4, 0x54, 0xd6, 0xc3, 0x88, 0xe9, 0x65, 0x9b, 0xb9, 0x0b, 0xfc,
+  0xed, 0x82, 0x14, 0xff, 0x9d, 0xce, 0xe8, 0x8f, 0xf7, 0x0f, 0x30, 0xd9,
+  0xc7, 0xfb, 0xcf, 0x76, 0xdb, 0x52, 0x79, 0x51, 0x67, 0x43, 0x24, 0xad,
+  0xc5, 0xb5, 0x53, 0x6e, 0x55, 0xe7, 0xfc, 0xea, 0xd0, 0x44, 0xe9, 0x25,
+  0xc9, 0x74, 0x9b, 0xad, 0x2b, 0x35, 0xe5, 0xa8, 0x89, 0x21, 0x19, 0xa6,
+  0xf5, 0x15, 0xa1, 0x2e, 0x06, 0x52, 0xde, 0xbd, 0x03, 0xa3, 0x0d, 0xb1,
+  0x1b, 0xde, 0xa7, 0x14, 0xaf, 0x4a, 0x83, 0x34, 0xde, 0x07, 0x3c, 0x47,
+  0x56, 0x29, 0x07, 0x18, 0x62, 0xed, 0x4c, 0x15, 0xc9, 0x81, 0x93, 0xc4,
+  0x24, 0x7c, 0xd7, 0x6e, 0x37, 0x6c, 0xf9, 0xce, 0xdb, 0xbc, 0xc8, 0xeb,
+  0x2b, 0xb4, 0x29, 0xae, 0xeb, 0xf4, 0x32, 0x0b, 0x0b, 0xdc, 0x0d, 0x43,
+  0x32, 0x26, 0x13, 0xb7, 0xd1, 0xab, 0x80, 0x4c, 0x4f, 0xa9, 0x61, 0xbc,
+  0xef, 0x52, 0xb0, 0x22, 0x3d, 0xf6, 0x80, 0x8c, 0xe6, 0x96, 0x19, 0xa3,
+  0x97, 0xbc, 0xf6, 0x1a, 0x40, 0xf6, 0xf5, 0x7f, 0xa4, 0x6e, 0x64, 0x80,
+  0xc8, 0xe2, 0xde, 0x40, 0xdc, 0x1c, 0x28, 0xd6, 0xf5, 0xc5, 0xa8, 0xda,
+  0xe6, 0x70, 0x4f, 0xc7, 0x86, 0x05, 0xb9, 0x5e, 0xc5, 0x48, 0x01, 0x34,
+  0x3f, 0xfb, 0xde, 0xe8, 0xa2, 0xa3, 0xe7, 0xf6, 0xc7, 0xbb, 0x0f, 0x6b,
+  0x18, 0x79, 0xd8, 0xd1, 0xcd, 0x28, 0x17, 0x57, 0x22, 0x11, 0x30, 0x55,
+  0xbe, 0xe0, 0x7f, 0xc4, 0x7d, 0x1d, 0xa8, 0x6b, 0x35, 0x56, 0xe4, 0xbb,
+  0x57, 0x80, 0x94, 0x72, 0x08, 0xcf, 0x5e, 0xda, 0x6e, 0xab, 0x46, 0x0f,
+  0xdd, 0x33, 0x49, 0x55, 0x8d, 0x02, 0xfc, 0x59, 0x4c, 0x5e, 0xce, 0x20,
+  0x74, 0x51, 0x37, 0xd5, 0xe5, 0x8c, 0xe0, 0x6d, 0xc8, 0x30, 0x25, 0xe8,
+  0x9d, 0xe4, 0x24, 0xe3, 0x66, 0x39, 0xc9, 0xf6, 0x97, 0xdb, 0x91, 0x6a,
+  0xbe, 0xed, 0x97, 0x1e, 0xc2, 0x78, 0xed, 0x1a, 0x71, 0x6d, 0xff, 0x91,
+  0x92, 0x92, 0x09, 0x4c, 0x85, 0xbf, 0x29, 0x67, 0xc0, 0xf9, 0xb5, 0xf1,
+  0xb0, 0xbe, 0xa6, 0xf4, 0x09, 0x3e, 0x60, 0x3b, 0x79, 0x88, 0x1b, 0x5f,
+  0x13, 0xf6, 0x7a, 0x67, 0xdd, 0xaa, 0xcf, 0x6d, 0x07, 0xd5, 0x7e, 0x94,
+  0xba, 0xcf, 0x68, 0x3d, 0xd2, 0x1d, 0xdc, 0xb5, 0x31, 0xe5, 0x39, 0xf1,
+  0x64, 0xe0, 0xab, 0x9c, 0x4e, 0x73, 0xd2, 0x5c, 0x70, 0xf5, 0xcd, 0x2f,
+  0x2f, 0x2f, 0xa3, 0x29, 0x4e, 0x66, 0x0b, 0xe8, 0xe0, 0x69, 0xcd, 0xf3,
+  0x2c, 0x6d, 0xa0, 0x6f, 0x90, 0x9c, 0xef, 0x4f, 0x9e, 0x76, 0xba, 0x7b,
+  0xe4, 0x19, 0x6f, 0x15, 0x2f, 0xfd, 0xfa, 0x94, 0x38, 0x15, 0x80, 0x08,
+  0x98, 0x06, 0x08, 0xd1, 0x13, 0x3f, 0xb3, 0xde, 0xae, 0x79, 0x6a, 0x88,
+  0xe2, 0x4e, 0x42, 0xcb, 0x0b, 0xd4, 0x13, 0x30, 0x07, 0xc9, 0x96, 0x01,
+  0x0f, 0x5b, 0x68, 0x6a, 0x2e, 0x67, 0xb0, 0x53, 0x2f, 0x11, 0x4e, 0x76,
+  0xa6, 0x7d, 0x66, 0x79, 0xe0, 0x92, 0xde, 0x13, 0x6d, 0xa8, 0xe1, 0x72,
+  0xd9, 0xbb, 0x5e, 0x11, 0x3f, 0xb3, 0x5d, 0x54, 0x15, 0xb5, 0x01, 0x91,
+  0x9c, 0x2f, 0x0c, 0xc3, 0xf3, 0x55, 0x26, 0x7e, 0x31, 0x63, 0xd7, 0x47,
+  0x09, 0x13, 0xc2, 0x70, 0xa3, 0x3d, 0x5c, 0x12, 0xae, 0x28, 0x98, 0x12,
+  0x8c, 0x0d, 0x98, 0x4c, 0x99, 0x50, 0x93, 0xb6, 0xc3, 0x47, 0x9f, 0x7f,
+  0x3e, 0x8a, 0xe2, 0x9c, 0x72, 0x79, 0xb6, 0x21, 0x42, 0xda, 0x29, 0x87,
+  0x89, 0x39, 0xb0, 0xe8, 0xc6, 0xf4, 0x7d, 0xa2, 0x30, 0x94, 0x8f, 0x95,
+  0x4b, 0x82, 0x2e, 0x22, 0xe6, 0xb8, 0x5e, 0x84, 0xe6, 0x3d, 0x42, 0x8f,
+  0x4b, 0x52, 0x2b, 0x84, 0x8b, 0x41, 0xbd, 0x22, 0xae, 0xb1, 0xcc, 0x7b,
+  0x54, 0xba, 0x4c, 0xd2, 0xf3, 0x38, 0x95, 0x53, 0xa0, 0x01, 0x25, 0x9f,
+  0x94, 0xd3, 0x7e, 0x8d, 0xd6, 0x80, 0x1c, 0x77, 0xce, 0xfa, 0xe0, 0xed,
+  0xd8, 0xee, 0x29, 0x07, 0xdd, 0x4e, 0x34, 0xfa, 0x39, 0xc9, 0x2c, 0xbe,
+  0x02, 0x77, 0xde, 0xea, 0x20, 0xe0, 0x70, 0xc9, 0x78, 0x41, 0x35, 0x61,
+  0xd4, 0xe9, 0xc2, 0x7c, 0xa0, 0x33, 0x1c, 0x2a, 0xa4, 0x2f, 0xb3, 0x26,
+  0xac, 0x63, 0xf2, 0xb2, 0x7b, 0x37, 0x0c, 0x1e, 0xb3, 0x89, 0xa4, 0x0c,
+  0x2b, 0x79, 0x39, 0x92, 0x48, 0xc2, 0x2c, 0x9f, 0xeb, 0x25, 0xb5, 0xdd,
+  0x21, 0xbe, 0xc4, 0x69, 0xbc, 0x94, 0xad, 0x97, 0xb2, 0xc4, 0x2f, 0xa3,
+  0x18, 0x67, 0x92, 0x62, 0x0c, 0xc0, 0xad, 0xa6, 0x31, 0x6a, 0xb5, 0xe3,
+  0xdd, 0xc8, 0x22, 0xe7, 0x5e, 0x04, 0x5c, 0xbb, 0xc3, 0x1b, 0xcc, 0x79,
+  0x9b, 0x8b, 0x18, 0xc8, 0xc6, 0x4b, 0x3b, 0xa8, 0xb4, 0x3a, 0xa1, 0x44,
+  0x7e, 0x9a, 0x4a, 0x6c, 0x27, 0x14, 0xa7, 0x9c, 0xf8, 0x83, 0x79, 0x3a,
+  0xb0, 0x7a, 0xe8, 0x5d, 0x6f, 0x9f, 0xc2, 0xb3, 0xf7, 0x23, 0x6b, 0x82,
+  0xa8, 0xc1, 0x5b, 0xec, 0x12, 0xc0, 0xfd, 0xe8, 0x8c, 0xac, 0xd4, 0x68,
+  0xc2, 0xf1, 0xee, 0xdc, 0xb4, 0x54, 0x57, 0xc9, 0x0d, 0xca, 0xba, 0x2c,
+  0x33, 0x9e, 0x25, 0x60, 0x35, 0x74, 0x57, 0xc9, 0x57, 0xd9, 0x54, 0xeb,
+  0x29, 0x29, 0x96, 0x30, 0xca, 0xf1, 0xa9, 0x58, 0x37, 0x2e, 0x75, 0xaf,
+  0xda, 0x15, 0xa3, 0x67, 0x1e, 0xce, 0x0b, 0xbb, 0x2c, 0x80, 0x80, 0x6c,
+  0xe1, 0x09, 0x5e, 0x24, 0x67, 0xa8, 0x0e, 0xa3, 0x7d, 0x5c, 0x33, 0xb8,
+  0x5b, 0xea, 0xfc, 0x1f, 0xac, 0x94, 0x49, 0x6a, 0xaf, 0xc2, 0xa3, 0xc1,
+  0xc1, 0x91, 0x11, 0x60, 0x7f, 0xf2, 0x86, 0xba, 0x8c, 0xb2, 0x28, 0x27,
+  0x7a, 0x0b, 0xf8, 0xb4, 0x9f, 0xd8, 0xce, 0x12, 0x89, 0xd4, 0xb8, 0x2a,
+  0xbb, 0x5c, 0x93, 0x94, 0xc3, 0x3e, 0xed, 0x28, 0x1c, 0xaa, 0x3e, 0xb1,
+  0xca, 0x57, 0xe8, 0x64, 0x62, 0xec, 0xb9, 0x20, 0x57, 0xde, 0xbc, 0xc5,
+  0xfd, 0x43, 0xd7, 0x85, 0xd9, 0xae, 0x66, 0x4d, 0x31, 0x48, 0xc1, 0x83,
+  0x31, 0xfc, 0xeb, 0x6f, 0x70, 0xfd, 0x95, 0xb2, 0x74, 0xee, 0xbd, 0x31,
+  0xb3, 0xa6, 0x77, 0x36, 0x0f, 0x6c, 0x97, 0x0c, 0x99, 0x2f, 0x00, 0x32,
+  0xa3, 0x54, 0x92, 0x46, 0x19, 0x00, 0x37, 0x9a, 0x23, 0x47, 0xcc, 0x1f,
+  0x29, 0x4e, 0x39, 0xcd, 0x1c, 0x8c, 0x2b, 0x36, 0x05, 0x55, 0xd5, 0xc1,
+  0xad, 0x06, 0x22, 0xa2, 0xea, 0x4e, 0x3e, 0x4e, 0xa6, 0x34, 0x3b, 0x19,
+  0x30, 0xf2, 0x2b, 0x97, 0x37, 0x09, 0xe8, 0x4f, 0x5a, 0x73, 0xf9, 0x44,
+  0x1d, 0x36, 0x60, 0x85, 0x10, 0x60, 0xad, 0xfa, 0x6f, 0xd6, 0xe0, 0x25,
+  0xce, 0x17, 0x81, 0x4f, 0x02, 0x6e, 0xec, 0x0b, 0xce, 0xd3, 0x40, 0x3b,
+  0x3b, 0x61, 0x68, 0x36, 0x2e, 0x21, 0xe5, 0x51, 0xac, 0x22, 0x6e, 0x1b,
+  0xd6, 0x49, 0x7b, 0xbf, 0x2d, 0x17, 0x37, 0x86, 0xd9, 0xe3, 0xec, 0x7c,
+  0xb0, 0x6a, 0xbe, 0x26, 0x16, 0xe9, 0xd2, 0xf2, 0x10, 0x52, 0xa9, 0xaa,
+  0xd4, 0x70, 0xcc, 0xbf, 0xad, 0x2e, 0x7b, 0x40, 0x15, 0xb9, 0x67, 0x8e,
+  0xb1, 0x15, 0xc2, 0x26, 0x5d, 0xa0, 0xc3, 0xe1, 0xdb, 0x44, 0xe6, 0xf3,
+  0xc5, 0x97, 0xad, 0xe1, 0xb4, 0x71, 0x85, 0x8f, 0xcb, 0x2e, 0x18, 0x1f,
+  0xd3, 0xcb, 0xfc, 0x9e, 0x4d, 0xe0, 0xa6, 0x06, 0x36, 0x9d, 0xb8, 0xbe,
+  0x2a, 0x33, 0x39, 0xbb, 0x02, 0x26, 0xb0, 0xed, 0xc1, 0x64, 0xd6, 0x55,
+  0x47, 0x3b, 0x6a, 0xa8, 0xc6, 0xdb, 0x3f, 0x6d, 0xc8, 0xf5, 0xff, 0x2c,
+  0xaf, 0x0a, 0xfa, 0x07, 0x7d, 0x81, 0x3e, 0xf0, 0xc5, 0xc1, 0x41, 0x74,
+  0xe6, 0xbd, 0xf3, 0xe5, 0x09, 0xeb, 0x8c, 0x49, 0x18, 0x49, 0x8a, 0xa8,
+  0xc7, 0xdb, 0x5a, 0xa6, 0xff, 0x08, 0x55, 0x73, 0xa1, 0x9b, 0x0d, 0x77,
+  0x08, 0x78, 0x64, 0xde, 0xab, 0x9c, 0x7e, 0x17, 0x65, 0x89, 0xb9, 0x95,
+  0x0f, 0x8b, 0x10, 0xdc, 0xc2, 0xe8, 0x6a, 0x74, 0x24, 0xfd, 0x8b, 0xdf,
+  0xa2, 0x58, 0xd0, 0xdd, 0x17, 0x2f, 0xaf, 0xd6, 0x97, 0x19, 0xf8, 0x66,
+  0x73, 0xdb, 0x6c, 0x3d, 0x68, 0xe5, 0xe4, 0xa5, 0x60, 0x37, 0x05, 0xa7,
+  0x58, 0x37, 0x5e, 0xb2, 0x11, 0x6a, 0x16, 0x5a, 0x2a, 0x04, 0xa7, 0x62,
+  0x92, 0xa5, 0xa4, 0xa1, 0xae, 0x6e, 0x5d, 0x11, 0x2b, 0xa3, 0x03, 0xde,
+  0x34, 0xc1, 0xbd, 0x70, 0x95, 0xf6, 0x1b, 0x56, 0x70, 0x93, 0x4d, 0xbe,
+  0xf8, 0x92, 0x7c, 0x5b, 0xb7, 0xe8, 0x1f, 0xc0, 0x5a, 0x2d, 0x6d, 0xdd,
+  0x1e, 0xda, 0x09, 0x24, 0xde, 0x22, 0xba, 0x83, 0x94, 0x55, 0xff, 0xb0,
+  0x5e, 0x9d, 0x93, 0x37, 0xe4, 0xbc, 0x2c, 0x37, 0x8e, 0xa8, 0xbe, 0x1b,
+  0xec, 0x89, 0x97, 0xcc, 0xc8, 0x29, 0x7e, 0xae, 0x86, 0x93, 0x09, 0x02,
+  0x72, 0xa6, 0x25, 0x2e, 0x63, 0x35, 0xf5, 0xe4, 0x21, 0x93, 0x7e, 0xe6,
+  0x2a, 0x71, 0xbe, 0x18, 0xa0, 0xcc, 0x27, 0xde, 0x31, 0xc6, 0xad, 0x81,
+  0xaf, 0x23, 0x20, 0x90, 0xe8, 0xaf, 0x7f, 0xb4, 0xaf, 0xd3, 0x7f, 0xcc,
+  0x6d, 0x06, 0x22, 0xf7, 0x86, 0xd5, 0x50, 0x28, 0x50, 0xdf, 0xd9, 0x43,
+  0xf8, 0xc9, 0x36, 0x82, 0xda, 0x1e, 0xb0, 0xa2, 0xfd, 0xc7, 0x6d, 0xb8,
+  0x71, 0x35, 0x48, 0x8d, 0xf6, 0x4c, 0xe0, 0x71, 0xb3, 0x32, 0x50, 0x6b,
+  0x29, 0x1b, 0x93, 0xfb, 0x37, 0x61, 0xf6, 0x3d, 0x13, 0xa7, 0x99, 0xeb,
+  0xd4, 0x7f, 0xd8, 0xb2, 0x93, 0xff, 0x61, 0xcb, 0x4d, 0xff, 0x87, 0x2d,
+  0xb7, 0x80, 0x1f, 0xb6, 0x08, 0x86, 0x92, 0x16, 0x11, 0x1a, 0xc4, 0x3f,
+  0xf5, 0xd0, 0xb7, 0xf9, 0xab, 0xee, 0xa3, 0xde, 0x37, 0xbd, 0x4f, 0x6e,
+  0x6d, 0x6f, 0xda, 0x34, 0x3f, 0x36, 0x84, 0xba, 0x98, 0xee, 0x1e, 0x1a,
+  0x76, 0xdd, 0xda, 0x26, 0xb7, 0x2d, 0x64, 0x9c, 0x05, 0x1d, 0xbc, 0xbd,
+  0x07, 0x68, 0xc7, 0x5d, 0x73, 0x2a, 0xaf, 0xe9, 0x82, 0x45, 0xb1, 0xd4,
+  0x73, 0xd0, 0xde, 0xcf, 0x81, 0x3c, 0xb2, 0xaf, 0x07, 0xf2, 0xe7, 0xbf,
+  0x9b, 0x2f, 0x40, 0xff, 0xc7, 0x18, 0x72, 0xab, 0x01, 0x60, 0x23, 0x79,
+  0x79, 0x48, 0x98, 0x2e, 0x38, 0x6a, 0xc9, 0xe2, 0x6f, 0xce, 0x95, 0x46,
+  0x4c, 0x12, 0x41, 0x2e, 0xfd, 0x32, 0x47, 0xab, 0x32, 0xb3, 0xaa, 0x05,
+  0x5b, 0xa8, 0x7b, 0x24, 0x15, 0x90, 0xfb, 0x8a, 0x0e, 0x62, 0x35, 0x4c,
+  0x74, 0x31, 0x5e, 0xa5, 0x0f, 0x1b, 0xef, 0x43, 0x3f, 0x49, 0x93, 0x22,
+  0xbe, 0x28, 0xab, 0xfa, 0x8b, 0xad, 0x8a, 0x3a, 0xbf, 0x26, 0x97, 0x95,
+  0xd1, 0x60, 0xff, 0x48, 0xa4, 0xb5, 0x36, 0x87, 0xe5, 0xee, 0xe9, 0xed,
+  0x70, 0x79, 0x67, 0xe6, 0xbd, 0xfd, 0x93, 0x28, 0xc3, 0x63, 0x69, 0x33,
+  0x44, 0xe9, 0x0d, 0x73, 0x5c, 0x26, 0xdd, 0x3c, 0x05, 0xbe, 0xba, 0xde,
+  0xa5, 0x94, 0xdf, 0x7f, 0x11, 0x83, 0xb9, 0x0b, 0x16, 0xe2, 0x71, 0x5e,
+  0x98, 0x6a, 0x5f, 0x9c, 0x7e, 0xf3, 0x47, 0x1d, 0xe0, 0x87, 0xad, 0xef,
+  0x87, 0xfc, 0x53, 0xd4, 0x0b, 0xbf, 0x48, 0x4e, 0xbf, 0x21, 0xea, 0xfe,
+  0x69, 0x0c, 0x6c, 0xd3, 0x07, 0xbe, 0xe4, 0xbf, 0x80, 0xb2, 0x37, 0x0d,
+  0x7b, 0xe1, 0xf2, 0x24, 0xbe, 0xa0, 0x06, 0xc6, 0xa8, 0x33, 0x82, 0x15,
+  0xbe, 0x5a, 0x51, 0xe5, 0x90, 0xd6, 0xc7, 0x36, 0x5c, 0x1f, 0x8b, 0xa8,
+  0x51, 0x3a, 0x29, 0x39, 0x45, 0xba, 0x09, 0xb1, 0xb1, 0x81, 0xcd, 0x8b,
+  0xb3, 0x15, 0xdf, 0xd5, 0x0a, 0x8e, 0x0b, 0xa8, 0xc3, 0xed, 0x34, 0x83,
+  0x76, 0x2d, 0xe3, 0x20, 0x39, 0x8a, 0x34, 0x41, 0x70, 0xe0, 0x46, 0xfc,
+  0x37, 0xe8, 0x65, 0xb6, 0x37, 0x37, 0x35, 0x54, 0x4b, 0xab, 0x4c, 0x3b,
+  0xe4, 0x48, 0x4f, 0x3f, 0x04, 0x98, 0x0c, 0xc1, 0x44, 0x42, 0x01, 0x12,
+  0x9d, 0x94, 0x44, 0xf4, 0x79, 0xb9, 0x90, 0x2e, 0xee, 0xb5, 0xa1, 0x7a,
+  0x3e, 0x60, 0xdb, 0x46, 0xcf, 0x68, 0x1c, 0xb4, 0x15, 0x12, 0xa9, 0x90,
+  0xcf, 0x46, 0x54, 0x0e, 0x89, 0x26, 0xb2, 0x37, 0x4e, 0x9a, 0xb6, 0x01,
+  0x30, 0x8c, 0x09, 0xff, 0x8f, 0x64, 0xf4, 0x4f, 0x32, 0x38, 0x9f, 0x6c,
+  0x55, 0xe6, 0x50, 0x9c, 0xc3, 0x11, 0x0f, 0x4e, 0x62, 0xef, 0x8d, 0x5e,
+  0x1c, 0x4e, 0x83, 0xd0, 0x52, 0x4d, 0xca, 0x13, 0xfb, 0x9a, 0x54, 0x42,
+  0x49, 0x64, 0xd7, 0xce, 0x36, 0x24, 0x5e, 0xe2, 0x8b, 0xc5, 0x1d, 0x56,
+  0x35, 0x22, 0xbc, 0x6d, 0xc9, 0xef, 0xc4, 0x97, 0xac, 0x8f, 0xa5, 0xa2,
+  0x6f, 0xc9, 0x61, 0x8d, 0x82, 0x17, 0xbe, 0x97, 0xa4, 0xa0, 0xe1, 0xc1,
+  0x0b, 0xaf, 0x4b, 0x11, 0xff, 0x2c, 0x3e, 0xbc, 0x0f, 0x02, 0xa3, 0x01,
+  0xe2, 0x5a, 0xb6, 0x7f, 0xc3, 0xf8, 0x87, 0x76, 0xfc, 0xcf, 0x22, 0xb8,
+  0x2b, 0x8c, 0x8c, 0x12, 0xff, 0xec, 0x85, 0x4b, 0x02, 0x54, 0x2f, 0xaa,
+  0xf5, 0x64, 0xb4, 0x7c, 0x08, 0x0a, 0xf9, 0xcc, 0x98, 0x2c, 0x1c, 0x6e,
+  0x08, 0x9b, 0x3c, 0x30, 0x5c, 0x25, 0xcc, 0x40, 0xac, 0xc3, 0x6c, 0x63,
+  0xd7, 0x44, 0x64, 0x51, 0x2f, 0x84, 0x55, 0x2e, 0x09, 0x82, 0x75, 0xf6,
+  0xc2, 0xf5, 0xbc, 0x64, 0x10, 0x89, 0xdc, 0xcf, 0xaf, 0x77, 0x75, 0xb4,
+  0x41, 0x59, 0x63, 0x0b, 0xe0, 0x38, 0xf8, 0x94, 0x61, 0xc5, 0x0c, 0xbd,
+  0xe4, 0x35, 0x64, 0xdc, 0xde, 0xd9, 0x16, 0xa7, 0x0a, 0x7d, 0x88, 0x5a,
+  0x45, 0x22, 0x11, 0x0a, 0xc5, 0xd8, 0x29, 0x30, 0x33, 0xc4, 0x97, 0x33,
+  0x8c, 0x68, 0x1d, 0x2f, 0xc0, 0xda, 0xed, 0x9d, 0x60, 0xa0, 0x20, 0xe0,
+  0x04, 0xa9, 0xdd, 0xcc, 0xa0, 0x5e, 0x2d, 0x70, 0xa0, 0xd0, 0x48, 0xf6,
+  0xb6, 0x58, 0x06, 0x63, 0xdb, 0xd4, 0x65, 0x2b, 0xa6, 0xc9, 0xf6, 0x17,
+  0xbb, 0xdb, 0x76, 0x69, 0xfd, 0x66, 0x51, 0xd0, 0xf1, 0x51, 0x83, 0x90,
+  0xb6, 0x0f, 0x2c, 0x3c, 0x4b, 0x4b, 0xca, 0x7d, 0xc8, 0x86, 0x38, 0xd0,
+  0x28, 0x82, 0x5e, 0xdd, 0x88, 0xb7, 0x13, 0x89, 0xe5, 0xb8, 0x9d, 0x8c,
+  0xf5, 0xc2, 0x24, 0x9e, 0x2e, 0x1a, 0x4a, 0xd5, 0x47, 0x31, 0x05, 0xa3,
+  0xfd, 0xd5, 0x2f, 0x3c, 0x7d, 0x3c, 0x72, 0x3d, 0x29, 0x90, 0x83, 0x26,
+  0x0a, 0xe2, 0x12, 0xf1, 0x3c, 0x1a, 0x9b, 0x54, 0xef, 0xed, 0x2f, 0x76,
+  0x58, 0x60, 0x39, 0x7f, 0x9a, 0xf7, 0xed, 0xed, 0xe4, 0x87, 0x78, 0x5d,
+  0x6b, 0xc2, 0xef, 0x7a, 0x16, 0x82, 0x90, 0xed, 0x7d, 0x6f, 0x24, 0x2f,
+  0x27, 0xe5, 0xec, 0xee, 0x4f, 0x08, 0x3b, 0xc9, 0x2b, 0x2f, 0xf7, 0xf0,
+  0xa3, 0x8e, 0xca, 0xdc, 0x37, 0x10, 0x46, 0x31, 0x47, 0x85, 0x3f, 0xbf,
+  0xa4, 0xc7, 0xd5, 0x62, 0xd8, 0x4e, 0x46, 0x23, 0xc3, 0x84, 0xea, 0x25,
+  0xda, 0x71, 0x6d, 0x10, 0x2c, 0x8c, 0x77, 0x07, 0x11, 0x4b, 0x4a, 0x8a,
+  0x40, 0x96, 0xc0, 0xb3, 0xa3, 0x56, 0x36, 0x3b, 0x21, 0xf9, 0x57, 0xd5,
+  0x17, 0xa3, 0xe4, 0x95, 0xcd, 0x92, 0xc9, 0x22, 0x18, 0xd9, 0x74, 0x8d,
+  0x59, 0x76, 0x78, 0x25, 0xe1, 0x9f, 0x4f, 0x72, 0x71, 0xb3, 0xcf, 0xca,
+  0x16, 0xee, 0x26, 0x63, 0x3a, 0x18, 0xe1, 0x1e, 0x47, 0x4a, 0x9b, 0x96,
+  0x15, 0xc7, 0x88, 0xd8, 0x9d, 0x6e, 0xed, 0x17, 0x99, 0xda, 0xf0, 0x48,
+  0x80, 0xb9, 0x94, 0x8d, 0x0e, 0x92, 0x67, 0xf6, 0x4b, 0x11, 0xac, 0x7a,
+  0xb6, 0xf8, 0xeb, 0xe4, 0xf3, 0x21, 0x3d, 0xe5, 0x75, 0x8b, 0x15, 0xba,
+  0x6f, 0x67, 0x70, 0x0c, 0x44, 0x29, 0x1c, 0x22, 0x31, 0x29, 0x52, 0x90,
+  0x03, 0x49, 0x30, 0x49, 0xeb, 0xec, 0xe9, 0x63, 0x55, 0x2f, 0x79, 0x97,
+  0x6a, 0xf5, 0xdf, 0xb6, 0x9c, 0xb0, 0x2c, 0x87, 0xbc, 0x05, 0x75, 0x2f,
+  0x02, 0x0a, 0x8b, 0x49, 0x39, 0xa3, 0xe6, 0x5f, 0x9c, 0x83, 0x4b, 0xd2,
+  0xd4, 0x28, 0x92, 0x97, 0x0d, 0x2a, 0x8a, 0x9e, 0x3d, 0xf5, 0x26, 0x7d,
+  0x8f, 0xbb, 0xa2, 0xc3, 0x49, 0x65, 0x85, 0xdd, 0x15, 0xa9, 0xbd, 0x6e,
+  0xbe, 0x1b, 0xdc, 0x4b, 0xf2, 0x75, 0x30, 0xf0, 0x98, 0xac, 0xd1, 0x3a,
+  0x18, 0xef, 0xbb, 0x46, 0xfe, 0x25, 0xf8, 0xa3, 0x12, 0x4e, 0xf7, 0xd3,
+  0x1b, 0x89, 0xda, 0x33, 0x91, 0xf4, 0x7d, 0x9e, 0x04, 0x13, 0xf6, 0xfd,
+  0x74, 0x4d, 0x41, 0x84, 0xf9, 0xba, 0x82, 0xf4, 0x91, 0xc7, 0x58, 0x49,
+  0xd0, 0x3a, 0x25, 0xd1, 0xd3, 0xdf, 0xbd, 0x7a, 0xff, 0xe1, 0xd5, 0xc9,
+  0xc3, 0xbb, 0x02, 0xb5, 0x1a, 0xcd, 0xdd, 0x93, 0x03, 0xeb, 0x83, 0x19,
+  0x74, 0xa0, 0x7e, 0xe2, 0x50, 0x06, 0x41, 0xd4, 0x81, 0xa0, 0x0d, 0xba,
+  0xd9, 0x7a, 0x54, 0x34, 0x46, 0x74, 0x45, 0x49, 0x22, 0x71, 0x08, 0x20,
+  0xce, 0xf3, 0x95, 0x10, 0xb9, 0x97, 0xb9, 0x99, 0xd6, 0xd2, 0x93, 0x71,
+  0x4b, 0xdf, 0xa7, 0xd7, 0xb7, 0x24, 0x79, 0xdc, 0xd6, 0x89, 0xc7, 0xa8,
+  0xdc, 0xd6, 0xb6, 0xdb, 0xd4, 0x2b, 0x6d, 0x6a, 0x2d, 0x02, 0xad, 0xe5,
+  0x7d, 0x2b, 0xe7, 0x73, 0x97, 0x3d, 0xdb, 0x8d, 0xf0, 0xbd, 0x7e, 0xdd,
+  0x5f, 0x72, 0xfb, 0x6b, 0xa2, 0xa5, 0x76, 0x32, 0xd2, 0xb1, 0x8d, 0x8e,
+  0xbb, 0x0f, 0x9b, 0x92, 0xab, 0xd1, 0x5f, 0xca, 0xdc, 0xe2, 0xbb, 0x6a,
+  0x26, 0xe8, 0x23, 0x07, 0xa8, 0x8a, 0x8b, 0x76, 0xb3, 0xe3, 0xa3, 0x73,
+  0x6c, 0xd6, 0xd9, 0xab, 0xf1, 0xd8, 0xca, 0xc2, 0x5a, 0xd2, 0x12, 0x06,
+  0x81, 0x31, 0x06, 0x35, 0xd2, 0x6f, 0x7b, 0x32, 0x4a, 0x6c, 0xa7, 0x58,
+  0x49, 0xe7, 0x44, 0xec, 0xc7, 0xd8, 0x7c, 0x17, 0xeb, 0xa5, 0xb9, 0x30,
+  0x46, 0xe3, 0x9d, 0x6d, 0xd7, 0x12, 0x8a, 0xed, 0x12, 0x1e, 0x71, 0x2e,
+  0xd1, 0xa4, 0x70, 0xd6, 0x44, 0x7b, 0x74, 0xf6, 0x63, 0x8d, 0x21, 0x11,
+  0x97, 0xe7, 0xe0, 0xb5, 0x0f, 0x71, 0x3b, 0x88, 0x3b, 0xd3, 0xb7, 0xc6,
+  0xc7, 0x17, 0x47, 0x66, 0xfb, 0x3e, 0x5c, 0x7c, 0xbd, 0x25, 0xa9, 0x0b,
+  0x5d, 0x14, 0x0c, 0x38, 0xed, 0xa9, 0xc5, 0xeb, 0xb5, 0xad, 0x96, 0xad,
+  0xd8, 0x91, 0x62, 0xac, 0x85, 0x98, 0x06, 0xee, 0x3e, 0x3a, 0xda, 0x70,
+  0x4a, 0x4f, 0x46, 0x4f, 0xba, 0xa7, 0xd4, 0x0f, 0x57, 0xcd, 0x00, 0xc6,
+  0x01, 0xb9, 0x0b, 0x2a, 0x32, 0x65, 0x4f, 0xed, 0xb9, 0xe6, 0x29, 0x08,
+  0xb2, 0x01, 0x5d, 0x27, 0xe5, 0x52, 0xf8, 0x00, 0x3d, 0x4f, 0xa1, 0x04,
+  0xbd, 0xb8, 0x38, 0xb0, 0x9b, 0x2d, 0xdc, 0x90, 0x78, 0x7b, 0x39, 0x1c,
+  0x6a, 0x4e, 0x2c, 0xad, 0x66, 0xb6, 0x2c, 0x34, 0xd4, 0x0f, 0x35, 0xd7,
+  0x8f, 0x5a, 0x32, 0x19, 0x12, 0xd0, 0x96, 0x2c, 0xad, 0x6a, 0xdd, 0xb0,
+  0xb7, 0x82, 0xcb, 0xe7, 0x8b, 0x83, 0x69, 0xc3, 0x8b, 0x8e, 0x2e, 0x2d,
+  0x16, 0x15, 0x7a, 0x63, 0xf6, 0x63, 0x1c, 0xff, 0x99, 0xf6, 0x55, 0xf2,
+  0x45, 0x5e, 0xf2, 0x9f, 0x71, 0x7a, 0x87, 0xc8, 0xad, 0xca, 0x05, 0x3b,
+  0x10, 0xe5, 0x0d, 0x4e, 0xe2, 0xe4, 0x62, 0x17, 0xa9, 0xc3, 0xa8, 0x90,
+  0x70, 0x28, 0x21, 0x1a, 0x34, 0x35, 0x0f, 0xdb, 0x6e, 0xed, 0x8c, 0x77,
+  0xad, 0xa7, 0xf5, 0x02, 0x11, 0x45, 0x8c, 0x16, 0xa9, 0x62, 0xf2, 0x90,
+  0x15, 0x45, 0xbd, 0x8c, 0xa1, 0xfb, 0x78, 0xb7, 0x37, 0xb4, 0x98, 0xc0,
+  0xa8, 0xa7, 0x37, 0xb3, 0x1e, 0xac, 0x3a, 0xb8, 0xb5, 0x90, 0x44, 0x06,
+  0x1b, 0x90, 0x6b, 0xa6, 0x5e, 0x7f, 0xf7, 0xc6, 0x6b, 0xb6, 0xa3, 0x79,
+  0x6a, 0x4c, 0x2f, 0xa2, 0x90, 0xf6, 0xa1, 0xc1, 0x65, 0x2e, 0xd9, 0x72,
+  0x84, 0xa0, 0xea, 0x2c, 0xcb, 0x56, 0x16, 0xda, 0x3c, 0x47, 0x8d, 0x4d,
+  0x5e, 0x23, 0x88, 0x2a, 0xb0, 0xf2, 0x68, 0x27, 0xd7, 0x33, 0x3b, 0x61,
+  0x1d, 0xda, 0x22, 0x12, 0xf6, 0x0e, 0x35, 0x0f, 0xa3, 0x30, 0xee, 0xc1,
+  0xb3, 0x47, 0x9f, 0x1b, 0xd9, 0x7c, 0x07, 0xac, 0x71, 0xb7, 0x65, 0x8c,
+  0x05, 0xdc, 0x8f, 0xf3, 0x27, 0x46, 0x8d, 0xa6, 0xf7, 0x0a, 0x9c, 0x42,
+  0x52, 0x93, 0x19, 0x01, 0x07, 0x95, 0x14, 0x37, 0x87, 0x58, 0x34, 0x66,
+  0x13, 0x65, 0xc3, 0x24, 0xe9, 0x0e, 0xfb, 0xc4, 0x09, 0x62, 0x23, 0x8f,
+  0x80, 0xa9, 0x41, 0x09, 0x75, 0x52, 0x33, 0x2c, 0xe5, 0xfc, 0xe8, 0xe2,
+  0xdc, 0xfc, 0x31, 0xbe, 0x38, 0x3d, 0xef, 0x41, 0x66, 0x6c, 0x18, 0xa6,
+  0x83, 0x36, 0x4d, 0xd3, 0x55, 0xb0, 0xcd, 0x6d, 0xd4, 0x36, 0x64, 0x42,
+  0x33, 0xdb, 0xa9, 0xa3, 0x40, 0x5f, 0x1e, 0xde, 0x57, 0x3d, 0x6a, 0x2d,
+  0x74, 0x6e, 0xe4, 0xc3, 0xc6, 0x85, 0xf1, 0x99, 0x6f, 0xa6, 0x10, 0x2c,
+  0x98, 0x88, 0x91, 0x56, 0x6c, 0x19, 0x3d, 0x66, 0x6b, 0x8c, 0x36, 0x72,
+  0xfe, 0x3b, 0x18, 0x7b, 0x6d, 0x4f, 0xdd, 0x83, 0x66, 0xc8, 0xa9, 0xb9,
+  0xdc, 0x9c, 0xc5, 0x75, 0x6b, 0x37, 0x9c, 0x56, 0xa1, 0x00, 0xb6, 0x92,
+  0x1d, 0x38, 0x90, 0x45, 0x2f, 0xb9, 0x87, 0x7e, 0x8d, 0x2e, 0xb4, 0xeb,
+  0x16, 0x5c, 0x97, 0xcb, 0x8c, 0x3d, 0xfc, 0x9c, 0x9c, 0xab, 0xcc, 0x89,
+  0x65, 0x0b, 0xe3, 0xd2, 0x26, 0x31, 0x3c, 0x0c, 0x0b, 0x21, 0x46, 0xa7,
+  0xbc, 0x6d, 0x11, 0x05, 0x4a, 0xa1, 0x0e, 0x3e, 0x97, 0xcc, 0x58, 0xaa,
+  0x0d, 0xb0, 0xd9, 0xb6, 0x75, 0x56, 0x1e, 0xb6, 0x58, 0x9b, 0x79, 0x1f,
+  0x74, 0x99, 0x0c, 0x81, 0x32, 0xc4, 0x39, 0x0b, 0xfa, 0xe8, 0x69, 0x71,
+  0x3d, 0x12, 0xad, 0x34, 0xc7, 0x06, 0xba, 0x84, 0xdf, 0x3f, 0xf4, 0x4c,
+  0x9e, 0x8a, 0x86, 0xd5, 0x50, 0xbd, 0x48, 0x60, 0x1e, 0x96, 0xb6, 0xe5,
+  0xc8, 0x39, 0x44, 0xb3, 0xee, 0x32, 0xdd, 0x96, 0x3e, 0x17, 0xb2, 0x59,
+  0x55, 0xda, 0x12, 0xd7, 0x91, 0x29, 0x40, 0xa3, 0xe8, 0x6d, 0xfb, 0xd5,
+  0x87, 0x12, 0xdd, 0xd5, 0x60, 0x90, 0x6e, 0xe5, 0x9c, 0x0c, 0xe8, 0x91,
+  0x1d, 0x45, 0xd0, 0x49, 0x3e, 0x14, 0x82, 0x1c, 0x53, 0x18, 0xdb, 0x02,
+  0xf9, 0x0f, 0x33, 0xbb, 0x69, 0x04, 0xa8, 0x44, 0x69, 0x5b, 0x2c, 0xb4,
+  0x66, 0x25, 0x2b, 0xf4, 0xc0, 0x74, 0x0e, 0x21, 0xc2, 0xe0, 0x43, 0x46,
+  0x36, 0x81, 0x4a, 0x1a, 0x19, 0xcf, 0xd9, 0x25, 0xd3, 0xa6, 0xbb, 0x52,
+  0xa0, 0x3c, 0x04, 0x0b, 0x3d, 0xf3, 0x0f, 0x8d, 0x59, 0x1a, 0xac, 0x1f,
+  0xc7, 0x0b, 0x1a, 0x06, 0x5b, 0x60, 0x44, 0x05, 0xf5, 0x0a, 0x08, 0xac,
+  0x45, 0x11, 0x2d, 0xcd, 0x62, 0x48, 0x8b, 0x75, 0xb1, 0xa0, 0x1c, 0xf1,
+  0x36, 0x54, 0x84, 0xaa, 0x81, 0xa3, 0x0d, 0x55, 0xac, 0x3e, 0xb2, 0x44,
+  0x8b, 0x24, 0xdb, 0xf5, 0xfa, 0xed, 0xd5, 0xf5, 0x56, 0xfe, 0x82, 0x40,
+  0xcf, 0xe9, 0xc8, 0x14, 0x91, 0x52, 0x69, 0x2b, 0x2f, 0x72, 0x42, 0x12,
+  0x2a, 0xab, 0x3d, 0xaa, 0x52, 0x21, 0xcc, 0x3e, 0x63, 0x55, 0x96, 0x0b,
+  0xb4, 0xf6, 0x51, 0xd5, 0x2d, 0xd6, 0x90, 0x19, 0x2a, 0x18, 0x63, 0xf0,
+  0x98, 0xc1, 0xdb, 0x95, 0xfb, 0x5e, 0xb3, 0x3a, 0x92, 0xa6, 0x1e, 0x6c,
+  0xc4, 0x28, 0xd6, 0x0e, 0x8e, 0x33, 0x42, 0x90, 0xf1, 0xd8, 0x56, 0xc7,
+  0xb4, 0x35, 0xa9, 0x36, 0x17, 0xc1, 0xb9, 0x42, 0xe5, 0x43, 0xfe, 0x7d,
+  0x4f, 0x2d, 0x9f, 0x36, 0x76, 0x01, 0x38, 0x94, 0xd9, 0x95, 0x01, 0x67,
+  0x87, 0xb4, 0x6f, 0x26, 0x2c, 0x87, 0xf6, 0xd7, 0xea, 0xac, 0x59, 0xaf,
+  0x42, 0x39, 0xef, 0xaa, 0x4f, 0xed, 0x88, 0x1a, 0x14, 0xf5, 0xa6, 0x48,
+  0xa8, 0x0a, 0x6e, 0xfb, 0x7d, 0x74, 0xfe, 0xee, 0x6d, 0x84, 0x26, 0x10,
+  0x48, 0xf7, 0x3e, 0x24, 0x00, 0x15, 0x2f, 0xd4, 0x20, 0x38, 0xd9, 0x32,
+  0xfa, 0xc5, 0xfe, 0x16, 0x03, 0x2d, 0x48, 0xd9, 0x16, 0x47, 0xd9, 0xed,
+  0xdb, 0x66, 0x5f, 0xbc, 0xf9, 0x86, 0x77, 0x46, 0xeb, 0x51, 0xa4, 0x64,
+  0x91, 0x4e, 0x67, 0x87, 0x7a, 0xd1, 0xe3, 0xfe, 0xee, 0x7e, 0xd6, 0xbb,
+  0xf4, 0x0d, 0xb3, 0xda, 0x3a, 0x78, 0x7e, 0x38, 0x3a, 0x78, 0xfa, 0xf9,
+  0xe8, 0x00, 0x9d, 0x6c, 0xbd, 0xb9, 0xb9, 0x8e, 0xab, 0xde, 0x40, 0x91,
+  0x7e, 0xbe, 0x49, 0x3f, 0xa2, 0x2f, 0x7f, 0x61, 0x79, 0x37, 0xa2, 0xe7,
+  0x46, 0xdc, 0x55, 0x27, 0xf8, 0xc6, 0xd2, 0xe8, 0x34, 0x79, 0x11, 0xc4,
+  0x41, 0x86, 0x2e, 0xab, 0x88, 0x69, 0x71, 0x95, 0x13, 0x19, 0x29, 0xca,
+  0xa6, 0xb7, 0x4f, 0xda, 0x10, 0xd0, 0x36, 0x38, 0xc1, 0xed, 0x8c, 0xcf,
+  0x48, 0x59, 0xfa, 0x54, 0xd4, 0x48, 0xc7, 0xd5, 0xed, 0xf7, 0x03, 0xb6,
+  0xf9, 0x93, 0xad, 0x3e, 0x82, 0x70, 0xb1, 0x97, 0xae, 0x0b, 0xd3, 0x05,
+  0x88, 0xa7, 0x2e, 0x4a, 0x90, 0x80, 0xbe, 0xf0, 0x83, 0xaa, 0x71, 0xdb,
+  0x80, 0xb8, 0x2f, 0x64, 0x00, 0x7e, 0xe4, 0x2a, 0x71, 0xfc, 0x4a, 0x62,
+  0x8c, 0x6c, 0xeb, 0x44, 0x3b, 0x70, 0x4e, 0x16, 0x66, 0x89, 0x99, 0xb4,
+  0x0e, 0x47, 0xef, 0xfc, 0xe1, 0x0f, 0x8e, 0x23, 0x71, 0x5b, 0x75, 0xf4,
+  0xf2, 0x78, 0x02, 0xa8, 0x56, 0x8e, 0x55, 0x73, 0x57, 0x80, 0xad, 0x17,
+  0x7f, 0x85, 0x73, 0xf8, 0xc7, 0xe1, 0x5f, 0xcd, 0x3f, 0x7f, 0xdc, 0xd2,
+  0x4b, 0xcd, 0xb0, 0x5c, 0xae, 0x60, 0xc4, 0xc1, 0x1f, 0xe2, 0x80, 0x06,
+  0x49, 0xbb, 0x2d, 0x2d, 0x34, 0x83, 0x8b, 0xd7, 0x67, 0x7c, 0x19, 0x2b,
+  0x0e, 0x7b, 0x83, 0x9a, 0x89, 0x0f, 0x41, 0xad, 0x27, 0x16, 0x8e, 0x8e,
+  0x1a, 0x4c, 0x27, 0x76, 0x2f, 0xbd, 0x57, 0x06, 0x2e, 0xa9, 0xe1, 0x86,
+  0x39, 0x40, 0x6a, 0xf4, 0xdb, 0x4b, 0xf2, 0xaf, 0x70, 0x49, 0xba, 0xe1,
+  0xbb, 0xaa, 0x48, 0x4b, 0xc7, 0x60, 0x02, 0xf6, 0x32, 0x6c, 0xc0, 0x5e,
+  0x87, 0x1b, 0x33, 0xa5, 0x41, 0x22, 0xf0, 0xb7, 0x5c, 0x1b, 0xd1, 0x08,
+  0x96, 0xa2, 0xd9, 0x06, 0xb3, 0x51, 0xca, 0x6d, 0xab, 0xbc, 0xfe, 0x44,
+  0xeb, 0x93, 0x32, 0x1f, 0x2f, 0x57, 0x88, 0xe6, 0xf3, 0x99, 0xd5, 0xfa,
+  0xee, 0x14, 0xb2, 0xc6, 0x16, 0xee, 0x79, 0x3b, 0xeb, 0xa4, 0x83, 0x1e,
+  0xbb, 0x02, 0x51, 0x46, 0x61, 0xb7, 0xe4, 0xb1, 0x2a, 0x7b, 0x00, 0x1a,
+  0x9c, 0xa4, 0xc2, 0x9c, 0x19, 0x3d, 0xd7, 0x92, 0x86, 0x07, 0xcd, 0x44,
+  0x25, 0xed, 0x44, 0x2c, 0x24, 0xfd, 0x76, 0xbb, 0x52, 0x8b, 0x3a, 0xd4,
+  0x90, 0xa3, 0x98, 0xe1, 0xa1, 0x2c, 0xbe, 0x19, 0x7a, 0x66, 0x51, 0xf9,
+  0x44, 0x65, 0xa6, 0x31, 0x1b, 0x68, 0x6d, 0x3e, 0xdf, 0x0c, 0x0a, 0xf2,
+  0xaa, 0x4e, 0xf7, 0x59, 0xd4, 0x56, 0xc0, 0x45, 0x73, 0xca, 0xe8, 0x82,
+  0x7d, 0xea, 0xb4, 0xf9, 0xd8, 0x75, 0xfa, 0xd3, 0x70, 0x6b, 0xed, 0xa8,
+  0x76, 0x53, 0xa0, 0x3d, 0x72, 0x12, 0x1a, 0x34, 0x98, 0xfe, 0x32, 0x06,
+  0xd1, 0xeb, 0x09, 0xd5, 0xc3, 0xfd, 0xd0, 0x95, 0x42, 0x4d, 0x9f, 0xb1,
+  0xc9, 0xc3, 0x7c, 0x75, 0xff, 0x06, 0x2a, 0xcc, 0x17, 0x1d, 0x69, 0x8b,
+  0xb3, 0x58, 0x09, 0x53, 0xaf, 0x2f, 0x2f, 0x81, 0x89, 0x11, 0x66, 0xe6,
+  0xa1, 0x62, 0x51, 0x0a, 0x07, 0xa4, 0x9f, 0x81, 0x61, 0xe4, 0x98, 0xb9,
+  0xee, 0x86, 0x2b, 0x8b, 0x14, 0x86, 0x53, 0xbb, 0xce, 0x24, 0xbd, 0xa5,
+  0xb3, 0xd4, 0xcb, 0x4e, 0xae, 0xb7, 0xd3, 0x64, 0xaa, 0x6c, 0xa8, 0x13,
+  0xed, 0xf2, 0x41, 0x4a, 0x0d, 0x0a, 0x32, 0x60, 0x99, 0x23, 0xc2, 0xd7,
+  0xd0, 0xcf, 0xfb, 0x36, 0xba, 0x1b, 0xc9, 0xc3, 0x46, 0xfd, 0x71, 0x18,
+  0x8e, 0x27, 0x9f, 0x0b, 0x88, 0x1f, 0xa3, 0xb0, 0x55, 0x16, 0xd5, 0x8a,
+  0xf5, 0x4a, 0xe1, 0x47, 0x5d, 0xa9, 0x39, 0xc7, 0x76, 0x6c, 0xf2, 0x0b,
+  0x38, 0x56, 0xe8, 0x6b, 0x4b, 0x8f, 0x47, 0x87, 0xc1, 0xc1, 0xd6, 0x8b,
+  0xe1, 0x74, 0x3a, 0x1d, 0x42, 0x0f, 0x78, 0xc9, 0xca, 0xc9, 0x9e, 0x28,
+  0x07, 0x3d, 0x3e, 0x83, 0x71, 0x26, 0xfb, 0xfd, 0xfa, 0xf5, 0x6b, 0xd1,
+  0x63, 0x2e, 0xae, 0x3a, 0x1a, 0x85, 0x05, 0x9c, 0x12, 0x8d, 0x2a, 0xd6,
+  0xe6, 0xb0, 0xbe, 0x5a, 0x37, 0x33, 0x74, 0x43, 0x26, 0x96, 0xa1, 0xac,
+  0xd7, 0xd6, 0xc8, 0x76, 0x50, 0x41, 0xa9, 0x29, 0xfd, 0xc0, 0x65, 0x26,
+  0x9a, 0xb1, 0x83, 0xa3, 0x59, 0x71, 0x03, 0x14, 0xbc, 0x28, 0x63, 0x77,
+  0x5b, 0xac, 0xf2, 0x54, 0x7d, 0xe8, 0x2e, 0x9d, 0x60, 0x1d, 0xcb, 0x64,
+  0xd3, 0x51, 0xf0, 0xd9, 0x34, 0x97, 0x0c, 0xb0, 0x54, 0xbe, 0xd5, 0x1d,
+  0xfb, 0x9e, 0xf3, 0x90, 0xad, 0x6e, 0x1f, 0xc9, 0xd3, 0xde, 0x23, 0x89,
+  0x6e, 0x3e, 0x59, 0x55, 0xb4, 0xed, 0x3b, 0xaf, 0x81, 0x28, 0xfa, 0x5a,
+  0x2e, 0xc4, 0xeb, 0x2b, 0xca, 0xdf, 0x5a, 0xd0, 0xe1, 0x98, 0x29, 0xd7,
+  0xcc, 0x04, 0x44, 0x7e, 0x8c, 0xc7, 0x27, 0x7b, 0x17, 0x27, 0xe3, 0x20,
+  0xe3, 0xfd, 0x8e, 0x5c, 0xc6, 0xdc, 0x44, 0xbb, 0xe5, 0xf2, 0xe4, 0x2d,
+  0x02, 0x38, 0x74, 0x39, 0x6f, 0x53, 0x38, 0x7f, 0x25, 0x8a, 0x77, 0xb2,
+  0x2e, 0xb4, 0x18, 0xc6, 0xca, 0xee, 0x22, 0x2b, 0x50, 0x44, 0x4e, 0x22,
+  0x1c, 0x37, 0x00, 0x09, 0xb1, 0x75, 0xf2, 0xfe, 0xd5, 0x05, 0x95, 0xb7,
+  0x34, 0x92, 0xe2, 0x41, 0x2e, 0xa0, 0xd0, 0x33, 0x7e, 0x63, 0x71, 0x09,
+  0x10, 0xb5, 0x49, 0xa7, 0xae, 0x19, 0x8a, 0x2a, 0xeb, 0x7c, 0x7c, 0xb5,
+  0x12, 0xde, 0xa6, 0xed, 0x37, 0x5b, 0x2a, 0xd2, 0xa1, 0x4b, 0xf3, 0xdd,
+  0xd3, 0x38, 0x88, 0x9e, 0x06, 0x6f, 0x40, 0xfc, 0x3a, 0x9c, 0x0b, 0x2b,
+  0xd7, 0x8d, 0x96, 0x2a, 0x7e, 0x9d, 0xfe, 0xa2, 0xbc, 0xcc, 0xc9, 0x13,
+  0x88, 0xf3, 0xf2, 0x03, 0x6f, 0x81, 0x9b, 0x94, 0x77, 0xa7, 0xe6, 0x52,
+  0x9c, 0x36, 0x80, 0x2d, 0x5f, 0x11, 0x92, 0x13, 0x76, 0x4f, 0x6d, 0x1f,
+  0x26, 0x2d, 0x81, 0x0c, 0x2b, 0x0c, 0x81, 0x9d, 0x97, 0x4f, 0x8d, 0x89,
+  0x30, 0xa5, 0xec, 0x0f, 0x94, 0x03, 0xd6, 0xed, 0x14, 0xdb, 0xbc, 0x05,
+  0xcb, 0xa7, 0x1e, 0xd2, 0x3a, 0x8c, 0x55, 0x40, 0x53, 0x90, 0x15, 0x6e,
+  0xf4, 0xc3, 0x3f, 0x6d, 0x09, 0x8f, 0xaf, 0xc8, 0x22, 0xbb, 0x0c, 0x84,
+  0xae, 0x45, 0xa1, 0x88, 0x20, 0xff, 0x41, 0x45, 0x45, 0x79, 0xbf, 0xf4,
+  0x36, 0xf6, 0x21, 0xdd, 0x37, 0xa1, 0x77, 0x0f, 0xba, 0xed, 0xcc, 0x18,
+  0x95, 0xb0, 0x0d, 0x56, 0xdd, 0x82, 0x06, 0xd2, 0x44, 0xdf, 0xce, 0x70,
+  0x5f, 0x1d, 0xb9, 0xf6, 0x09, 0x1d, 0xfc, 0xa0, 0x56, 0x6b, 0x05, 0x8e,
+  0x43, 0x52, 0x0c, 0xea, 0x86, 0xba, 0xb0, 0xde, 0xf4, 0x18, 0x39, 0xac,
+  0xc4, 0x5e, 0x38, 0x34, 0x76, 0xbe, 0x1f, 0xac, 0x05, 0x66, 0x36, 0x4b,
+  0x95, 0xa0, 0x67, 0x34, 0x40, 0xff, 0x1f, 0xdb, 0xae, 0x3b, 0xd0, 0x28,
+  0xe2, 0x87, 0x50, 0xe9, 0x10, 0x02, 0x08, 0xbb, 0xd0, 0xd3, 0xc0, 0x4d,
+  0xd8, 0x7d, 0x37, 0x6c, 0xef, 0xc1, 0xcb, 0xdb, 0x3c, 0x9f, 0xaf, 0x8f,
+  0x5e, 0xbd, 0xb1, 0x30, 0x02, 0xbf, 0x05, 0xb2, 0xb0, 0xf3, 0x6a, 0x4e,
+  0x32, 0xee, 0x02, 0xb1, 0x56, 0x47, 0x09, 0x4e, 0x47, 0x09, 0x15, 0xb4,
+  0x62, 0xd4, 0xb5, 0x3a, 0xe3, 0x1b, 0xd2, 0xdb, 0x0c, 0xa1, 0xd7, 0x33,
+  0xe2, 0x67, 0x1f, 0x88, 0xc7, 0x9a, 0x34, 0x65, 0xae, 0xad, 0xf2, 0x08,
+  0xf9, 0x12, 0x84, 0xbc, 0x28, 0x27, 0xe5, 0x7c, 0xbe, 0x41, 0xba, 0x33,
+  0x3c, 0x24, 0x6a, 0xa0, 0x98, 0x60, 0xb6, 0x68, 0x1b, 0xe9, 0xbd, 0x09,
+  0xcd, 0xde, 0x1c, 0xa9, 0xb9, 0x6a, 0x5b, 0x52, 0x98, 0x00, 0x95, 0x3c,
+  0xb8, 0x1b, 0xed, 0xc2, 0x74, 0xb5, 0x19, 0xd4, 0xc4, 0x43, 0x61, 0x3e,
+  0xbb, 0x63, 0x34, 0x4d, 0xc8, 0x02, 0xfb, 0xd7, 0xc9, 0x7f, 0xfd, 0xf3,
+  0xaf, 0x3f, 0x46, 0xba, 0x1b, 0x90, 0xc3, 0xef, 0x8a, 0x2b, 0x0b, 0xcd,
+  0xd3, 0x4b, 0x41, 0x6d, 0xb1, 0x38, 0xf1, 0x9c, 0x68, 0xc2, 0xf1, 0x8c,
+  0xa6, 0xce, 0x16, 0xf3, 0x91, 0x97, 0x53, 0x19, 0x8a, 0x45, 0x32, 0xa1,
+  0xf4, 0x83, 0xe8, 0x56, 0x47, 0xa5, 0xe0, 0x5c, 0xbe, 0x4b, 0xc8, 0xdd,
+  0x68, 0x11, 0xe4, 0x52, 0xa6, 0x2d, 0xb2, 0x2f, 0x9f, 0x44, 0x80, 0x1f,
+  0xe3, 0xda, 0xf8, 0x74, 0x83, 0xe9, 0x1f, 0xce, 0x8f, 0xad, 0xab, 0xd3,
+  0xe7, 0xca, 0x57, 0x86, 0x52, 0xef, 0x86, 0xd9, 0x5d, 0x36, 0x31, 0x5c,
+  0xa2, 0x56, 0xe0, 0x87, 0xe1, 0xb2, 0x4e, 0x5e, 0x2e, 0x0d, 0x8d, 0xe7,
+  0x3d, 0x90, 0x1d, 0x5f, 0xd3, 0x6b, 0x89, 0xbe, 0x66, 0xf1, 0x4b, 0x2f,
+  0xcb, 0xca, 0xec, 0xd0, 0x52, 0xaa, 0x71, 0xa5, 0x24, 0xb9, 0xed, 0xcc,
+  0x48, 0x50, 0x60, 0x12, 0xb8, 0x03, 0xae, 0x1f, 0x8b, 0xc6, 0x0d, 0x30,
+  0x36, 0x0f, 0x28, 0x0c, 0xca, 0xfa, 0xda, 0x28, 0x8f, 0x66, 0xf6, 0xc6,
+  0xc8, 0x26, 0x6b, 0xbd, 0x1e, 0x08, 0x49, 0x55, 0x8a, 0x23, 0x17, 0x85,
+  0x11, 0xb0, 0x65, 0x88, 0x6c, 0x61, 0x19, 0xa6, 0xe3, 0xaf, 0xc8, 0x76,
+  0x31, 0xf5, 0xd1, 0xdf, 0xa4, 0x77, 0x71, 0xb8, 0xaf, 0xba, 0x00, 0x76,
+  0x83, 0x26, 0x2e, 0x7b, 0x95, 0x0a, 0x36, 0x72, 0xed, 0x2f, 0xec, 0x7b,
+  0x62, 0xad, 0xa9, 0x1c, 0x5c, 0xca, 0x65, 0x3a, 0xb3, 0x85, 0xf4, 0x3e,
+  0x74, 0x20, 0xca, 0x10, 0x53, 0xaa, 0x8b, 0xcc, 0x16, 0x23, 0xe9, 0xaa,
+  0x8d, 0xb4, 0x2a, 0x37, 0x26, 0x18, 0x6e, 0x17, 0xd7, 0xa5, 0xa6, 0x14,
+  0x01, 0xae, 0x86, 0x15, 0x87, 0x3e, 0xca, 0xca, 0xc5, 0xf3, 0x10, 0x8d,
+  0xf5, 0x5e, 0x08, 0x5e, 0xce, 0x25, 0xcc, 0x7e, 0xb1, 0x1f, 0x00, 0x96,
+  0x8c, 0xde, 0x61, 0x0c, 0x43, 0x42, 0x6f, 0x23, 0xbd, 0x82, 0x78, 0x08,
+  0x1f, 0xf8, 0x91, 0x1c, 0x78, 0x67, 0x38, 0x8a, 0xb5, 0x3c, 0x7d, 0xf2,
+  0xe4, 0x09, 0xc7, 0x5a, 0xb6, 0x8e, 0xf1, 0xe1, 0xf3, 0xa3, 0xd7, 0xa7,
+  0xef, 0xde, 0x1d, 0xbd, 0x7f, 0x73, 0xf4, 0x46, 0x33, 0x3e, 0xbc, 0x95,
+  0x38, 0xea, 0x08, 0x57, 0x44, 0x59, 0x82, 0x66, 0x9f, 0x0f, 0x9e, 0xec,
+  0x0f, 0x0f, 0x9f, 0xec, 0x27, 0x86, 0x16, 0x53, 0x5b, 0xa7, 0x96, 0x2e,
+  0x52, 0xb2, 0x6f, 0xaf, 0xd6, 0x46, 0x55, 0x23, 0x68, 0xcf, 0x86, 0x30,
+  0x37, 0xe0, 0x7a, 0x25, 0x6f, 0x4f, 0xd6, 0x90, 0x1d, 0x1d, 0xc9, 0x0c,
+  0x18, 0x6d, 0x59, 0x90, 0x36, 0x17, 0xb0, 0x14, 0xdd, 0x07, 0x04, 0x7a,
+  0xb8, 0x4f, 0x1f, 0x1a, 0x25, 0x6f, 0x8d, 0xf6, 0x31, 0x2f, 0x6f, 0x99,
+  0x16, 0x5f, 0x5f, 0x19, 0xa5, 0x34, 0x0b, 0x43, 0x95, 0xed, 0xf7, 0xe9,
+  0xf5, 0x47, 0xfc, 0xfa, 0x6f, 0x18, 0xa3, 0x7f, 0xf2, 0xbc, 0x6d, 0x58,
+  0x9a, 0x8b, 0x0c, 0x54, 0x78, 0x2d, 0x49, 0xec, 0xc1, 0xf7, 0x1f, 0xb3,
+  0x39, 0xfe, 0xf5, 0xab, 0x33, 0x7a, 0xda, 0x98, 0xe5, 0xa7, 0xdf, 0xff,
+  0xc5, 0x95, 0x79, 0x5e, 0x1f, 0x68, 0x36, 0xa3, 0x54, 0xb2, 0xa2, 0x11,
+  0x5f, 0x11, 0x06, 0xbd, 0x9d, 0x32, 0x6b, 0x0d, 0x42, 0x15, 0x32, 0x58,
+  0x21, 0x65, 0xa0, 0x9a, 0xad, 0xe3, 0x1e, 0x59, 0x72, 0x68, 0x55, 0x2d,
+  0x57, 0x3c, 0x56, 0xd7, 0x6f, 0x58, 0x39, 0x4d, 0xe3, 0x36, 0xe7, 0xbe,
+  0x0f, 0x79, 0x31, 0xe3, 0xc6, 0xb4, 0x2d, 0xc7, 0x6c, 0x53, 0xad, 0xb3,
+  0x98, 0xd7, 0x74, 0x23, 0xc6, 0x0e, 0x29, 0xb5, 0x55, 0xbe, 0x4c, 0xab,
+  0x9c, 0xdb, 0xcf, 0x13, 0x81, 0xdf, 0x70, 0xaf, 0x4c, 0x4e, 0x95, 0x42,
+  0xec, 0xcb, 0x81, 0xc9, 0x96, 0x41, 0xda, 0xa9, 0xed, 0xe5, 0x40, 0x44,
+  0xcc, 0xb0, 0x46, 0x12, 0xa3, 0xe4, 0xcd, 0xda, 0x08, 0x43, 0xd7, 0xb6,
+  0xff, 0xad, 0x42, 0xd1, 0x07, 0x3a, 0x97, 0xbc, 0x3d, 0x3e, 0x39, 0xda,
+  0x4d, 0xde, 0x66, 0x8d, 0x94, 0x38, 0x69, 0x86, 0x31, 0x89, 0xfc, 0x7f,
+  0x83, 0x82, 0x65, 0x41, 0x09, 0xa5, 0x46, 0x38, 0x9a, 0x0b, 0x26, 0x3e,
+  0x38, 0x28, 0x1b, 0x5a, 0x2f, 0xc5, 0x87, 0x83, 0x25, 0x52, 0x3c, 0x4e,
+  0x73, 0xcb, 0x34, 0xbe, 0x29, 0x27, 0x1f, 0xc9, 0xbb, 0x55, 0x9c, 0x87,
+  0x91, 0x87, 0x78, 0x56, 0xfa, 0x29, 0x04, 0x34, 0x69, 0xc9, 0x79, 0xd6,
+  0x78, 0x71, 0x5e, 0xaf, 0x16, 0xc4, 0x0d, 0xa2, 0x28, 0x2f, 0x8b, 0xcc,
+  0x55, 0xf6, 0x81, 0xf2, 0xb9, 0x53, 0xbc, 0x18, 0x3d, 0x60, 0xa8, 0xb4,
+  0x5e, 0x6f, 0xe3, 0xbe, 0xd6, 0x8d, 0xa3, 0xb4, 0x13, 0xfe, 0x73, 0xef,
+  0xcb, 0x28, 0xf8, 0x98, 0x36, 0xb2, 0x40, 0xcf, 0x5c, 0x79, 0x03, 0x14,
+  0xc5, 0x3d, 0xd4, 0x45, 0xc8, 0xab, 0xda, 0xd9, 0xa2, 0x84, 0x88, 0xfa,
+  0x0a, 0xdf, 0x9d, 0x9a, 0xbb, 0x7f, 0x91, 0x3e, 0x4d, 0xaa, 0x3f, 0x50,
+  0x09, 0xb8, 0x93, 0x2e, 0xdc, 0xa5, 0xd7, 0x66, 0x19, 0x27, 0xb1, 0x96,
+  0x68, 0xcc, 0x95, 0xa5, 0x25, 0x2f, 0x6b, 0x53, 0x94, 0xad, 0x9f, 0x6a,
+  0xba, 0xbe, 0xce, 0x97, 0x1e, 0xbb, 0x12, 0xf0, 0x6a, 0xf8, 0x52, 0xb8,
+  0x8a, 0xac, 0x8e, 0xba, 0xfc, 0xa5, 0xbc, 0x4d, 0x42, 0x7b, 0x68, 0xa9,
+  0xca, 0x4e, 0x19, 0xd6, 0xa1, 0xd7, 0xa4, 0xd0, 0x71, 0x65, 0x17, 0xfa,
+  0x10, 0x54, 0x8c, 0x97, 0x19, 0xd1, 0x96, 0xe4, 0xeb, 0x3e, 0x0b, 0xea,
+  0xea, 0xec, 0xfe, 0x67, 0xda, 0x96, 0x68, 0xa8, 0x2e, 0x9a, 0xbd, 0x83,
+  0x4e, 0x49, 0x7d, 0x3f, 0xa8, 0xea, 0x7d, 0xfa, 0x29, 0x47, 0x21, 0xe2,
+  0x1a, 0xea, 0x5c, 0x5a, 0x68, 0xbd, 0x15, 0x4f, 0xd3, 0xe2, 0xbc, 0x1b,
+  0x72, 0x1b, 0xa1, 0x9c, 0x21, 0xae, 0x7d, 0x32, 0x64, 0x19, 0x39, 0x0d,
+  0x08, 0x85, 0x55, 0xe7, 0xb3, 0x40, 0x45, 0x83, 0xbd, 0x2d, 0xaa, 0xa8,
+  0x51, 0x3d, 0x24, 0x74, 0xc5, 0x08, 0x2e, 0x74, 0x86, 0x86, 0xcb, 0x70,
+  0xf9, 0xdd, 0x08, 0xc4, 0xd8, 0x76, 0x95, 0x31, 0x34, 0xfd, 0xc8, 0x58,
+  0xa2, 0x4b, 0x2a, 0x09, 0x50, 0xfc, 0x66, 0x5a, 0xb2, 0x6c, 0x8f, 0xe1,
+  0x6d, 0x97, 0xf9, 0x75, 0x2c, 0xcb, 0x82, 0xf2, 0x23, 0x64, 0x62, 0xc8,
+  0xd2, 0x70, 0xed, 0x62, 0x35, 0xed, 0xd8, 0x86, 0xb4, 0xd9, 0x2f, 0x4d,
+  0x38, 0x80, 0xb2, 0xb3, 0xc1, 0x0d, 0x5e, 0x90, 0xc6, 0x4a, 0x80, 0x5e,
+  0x05, 0x37, 0xe8, 0xfd, 0xda, 0x68, 0x3e, 0x2f, 0xb6, 0x2c, 0xa2, 0x3a,
+  0xfc, 0xaa, 0xe0, 0x8e, 0x2d, 0xca, 0x91, 0x96, 0xd1, 0xc3, 0x68, 0xdf,
+  0x31, 0xd1, 0xdc, 0x1b, 0x65, 0x5c, 0xb6, 0xe0, 0x26, 0x4c, 0x6b, 0xb6,
+  0x05, 0x30, 0x5c, 0x31, 0x1a, 0x22, 0xc6, 0xd3, 0x94, 0xbe, 0x1f, 0xbe,
+  0xc6, 0xc7, 0x87, 0x5f, 0x63, 0xb8, 0x3f, 0x6e, 0x59, 0x87, 0x6f, 0xf7,
+  0x57, 0x2f, 0xc2, 0x46, 0xc1, 0xce, 0x6f, 0xc8, 0x86, 0xc7, 0x5a, 0xab,
+  0x32, 0x90, 0x48, 0x22, 0x13, 0xe4, 0x1e, 0x5c, 0xe6, 0x8a, 0xec, 0xe9,
+  0x81, 0x23, 0x9a, 0x52, 0x87, 0x5d, 0x36, 0x6d, 0xca, 0x81, 0x91, 0x22,
+  0x2b, 0x80, 0xe9, 0xcc, 0x86, 0xe5, 0x7c, 0x88, 0x0c, 0x69, 0xc3, 0xfc,
+  0x3f, 0x51, 0x32, 0x92, 0x77, 0xeb, 0x00, 0x10, 0x02, 0xec, 0xed, 0xd9,
+  0x2c, 0xa6, 0x9a, 0x73, 0x21, 0x23, 0x69, 0x1d, 0x42, 0xf8, 0x5a, 0x68,
+  0xc1, 0x07, 0xf9, 0x42, 0xbc, 0xf2, 0x78, 0xdd, 0x76, 0xa1, 0x22, 0x64,
+  0x2e, 0x29, 0x88, 0x08, 0xfc, 0x69, 0x28, 0x8f, 0x18, 0xb0, 0xf6, 0x8e,
+  0x55, 0xc3, 0x86, 0x5b, 0xb2, 0x2b, 0x17, 0xfe, 0xe7, 0xf5, 0x0a, 0x2a,
+  0x2b, 0x21, 0x76, 0x06, 0xde, 0x17, 0x2d, 0x12, 0x01, 0x16, 0xa7, 0x11,
+  0xfe, 0x4f, 0x46, 0xfb, 0x83, 0x20, 0x50, 0xdf, 0xc0, 0xd8, 0x2f, 0x5c,
+  0x96, 0x90, 0x79, 0x18, 0x3c, 0x72, 0x18, 0xab, 0xae, 0xad, 0x9b, 0x3b,
+  0xe2, 0xd7, 0xb6, 0x98, 0x16, 0xa9, 0xc5, 0xae, 0xee, 0xc1, 0xe5, 0xf4,
+  0x60, 0x0b, 0x85, 0x6d, 0x72, 0x15, 0x6d, 0x0c, 0xe2, 0x54, 0x32, 0xb6,
+  0xbe, 0x1c, 0x76, 0xdb, 0x64, 0xda, 0x6e, 0x67, 0x7e, 0xf5, 0x86, 0xd7,
+  0xb7, 0xac, 0xd7, 0xd3, 0x04, 0x34, 0xd1, 0x57, 0xda, 0xfa, 0x66, 0x68,
+  0x36, 0x55, 0x3a, 0xba, 0x0e, 0x33, 0xfa, 0x21, 0x03, 0x76, 0x28, 0x70,
+  0x68, 0xdd, 0xbf, 0x67, 0x0c, 0xb2, 0xfb, 0x8c, 0x76, 0xcc, 0xb6, 0x16,
+  0xd0, 0x1e, 0x3a, 0x4e, 0x3e, 0x80, 0x6c, 0xbd, 0xbb, 0xd4, 0xdd, 0x33,
+  0xe2, 0x2a, 0xc4, 0x09, 0x0a, 0xcd, 0xf9, 0x46, 0x43, 0xf6, 0xdb, 0xbb,
+  0xde, 0xd4, 0xe2, 0x9e, 0x9c, 0x5f, 0x5c, 0x9b, 0xb7, 0xa4, 0xd8, 0x0f,
+  0xdf, 0x9b, 0x63, 0x78, 0x91, 0xfc, 0x67, 0x99, 0x71, 0xcd, 0xea, 0x3d,
+  0x25, 0xab, 0xdf, 0xbd, 0x3a, 0x7f, 0x7f, 0xfc, 0xfe, 0xab, 0x17, 0x96,
+  0xc7, 0x11, 0xbf, 0xeb, 0xf6, 0xb4, 0xb0, 0xbc, 0x1b, 0xbf, 0x65, 0xe4,
+  0x56, 0xf2, 0xfe, 0xf4, 0x61, 0x6c, 0x53, 0x2c, 0x13, 0xec, 0x99, 0x9d,
+  0x97, 0x55, 0xc6, 0x71, 0x11, 0xb6, 0x45, 0xb5, 0x72, 0x42, 0xca, 0x35,
+  0x21, 0x2a, 0xd1, 0xb8, 0x2d, 0x02, 0xd8, 0x30, 0x3c, 0xa1, 0x33, 0x59,
+  0x94, 0xad, 0x1e, 0x51, 0x44, 0x94, 0x0b, 0x1c, 0x7f, 0xe9, 0x53, 0x00,
+  0x5b, 0xcc, 0xda, 0x51, 0x9d, 0x9d, 0x3e, 0x91, 0xe0, 0x2d, 0x63, 0x64,
+  0xab, 0xe7, 0xd5, 0xf6, 0xc7, 0x91, 0x26, 0x17, 0x35, 0x8e, 0xac, 0xce,
+  0xe1, 0x6c, 0xb0, 0x5b, 0xa2, 0x39, 0x5e, 0x11, 0x3f, 0x88, 0xc0, 0x4b,
+  0xa7, 0x6b, 0xbe, 0x2f, 0x8c, 0x4e, 0x26, 0x3f, 0x75, 0x75, 0x19, 0x76,
+  0x07, 0x1e, 0x9c, 0xe6, 0xec, 0xf2, 0x9c, 0x59, 0x9f, 0x67, 0x03, 0xd1,
+  0x63, 0x59, 0xe6, 0x4f, 0x12, 0x25, 0x51, 0x1c, 0x92, 0x45, 0xe6, 0xaa,
+  0x92, 0xac, 0xae, 0x73, 0xc5, 0xba, 0xce, 0x62, 0x15, 0x80, 0xed, 0x51,
+  0x9a, 0x79, 0x42, 0xbf, 0x51, 0xa7, 0x0e, 0x05, 0xaf, 0x20, 0x81, 0xd5,
+  0x2c, 0x69, 0x81, 0xdb, 0xd9, 0xd6, 0x90, 0xcc, 0xd4, 0x43, 0x79, 0x4a,
+  0x78, 0x4f, 0x19, 0xe3, 0x8d, 0xf9, 0x15, 0x30, 0xe6, 0xeb, 0x66, 0x8f,
+  0x57, 0xeb, 0xc9, 0x72, 0xf6, 0x24, 0x79, 0x69, 0xfe, 0x13, 0x28, 0x59,
+  0xc8, 0x19, 0x1d, 0xbf, 0x36, 0x8a, 0x16, 0x25, 0xb8, 0x90, 0xbc, 0x60,
+  0xc8, 0x1b, 0xaf, 0x8b, 0xc4, 0xa3, 0x43, 0x33, 0xd3, 0xdb, 0x54, 0xa1,
+  0x2d, 0x8d, 0x46, 0x78, 0x99, 0x37, 0x9c, 0xa7, 0xd7, 0x83, 0x1b, 0xe4,
+  0xa5, 0x36, 0xe0, 0xcc, 0x0f, 0x0e, 0x3f, 0x4f, 0xa8, 0xf8, 0xe0, 0xdd,
+  0x9b, 0x27, 0xc9, 0xf4, 0x2a, 0x9b, 0x7e, 0xaa, 0xd7, 0x4b, 0x65, 0xc7,
+  0xb4, 0xa7, 0xc6, 0x3c, 0xa0, 0x79, 0x06, 0x88, 0x0f, 0x66, 0xe2, 0x8b,
+  0x7c, 0x4a, 0xa5, 0x7f, 0x83, 0x56, 0x74, 0x6a, 0xae, 0xd1, 0x29, 0xcf,
+  0x0e, 0xb5, 0x62, 0x03, 0xe9, 0x02, 0x9c, 0x53, 0x13, 0x09, 0x5e, 0x98,
+  0x3d, 0x30, 0x1f, 0xaf, 0xb9, 0x9b, 0xf5, 0x46, 0x97, 0xed, 0xb3, 0xb6,
+  0xd7, 0x9b, 0x2e, 0xf6, 0xfe, 0xe8, 0x79, 0x4f, 0x7f, 0x8e, 0x56, 0x6b,
+  0x0e, 0xaa, 0x55, 0xb2, 0xd5, 0x76, 0xb0, 0x07, 0x48, 0xcb, 0xa7, 0x49,
+  0x12, 0x20, 0x94, 0x86, 0xf1, 0x82, 0x8f, 0xd3, 0x93, 0x7b, 0xf4, 0x84,
+  0xf4, 0x96, 0x43, 0x16, 0x5b, 0x06, 0x4c, 0x0a, 0x26, 0x2d, 0xa4, 0x09,
+  0xd9, 0x28, 0xa0, 0x45, 0x38, 0x43, 0x08, 0x36, 0x54, 0xda, 0x6c, 0xfd,
+  0xb7, 0xba, 0x6c, 0x1c, 0x8b, 0x91, 0x12, 0x5a, 0x0f, 0xcd, 0x41, 0x6b,
+  0x09, 0x81, 0xd7, 0x46, 0x36, 0x45, 0x40, 0x64, 0xf6, 0xbb, 0x1c, 0x97,
+  0x76, 0xc7, 0x51, 0x33, 0x1a, 0x21, 0x9c, 0xe7, 0xd4, 0x25, 0x96, 0x2d,
+  0xea, 0xf2, 0xa6, 0xb8, 0xac, 0xc8, 0x3f, 0x82, 0xa2, 0xb0, 0x34, 0x16,
+  0xcb, 0x88, 0x99, 0xc5, 0xc9, 0x7c, 0x0d, 0x4b, 0x08, 0xc3, 0xeb, 0xae,
+  0x09, 0x7a, 0xa6, 0xd1, 0xd1, 0xa5, 0xa2, 0x11, 0xc2, 0xa0, 0x03, 0x8f,
+  0x8a, 0x84, 0xb0, 0xa0, 0x6b, 0x18, 0x71, 0x2d, 0x43, 0x0e, 0xd8, 0xda,
+  0x83, 0xd1, 0xbe, 0xe6, 0x5a, 0x45, 0x6c, 0x79, 0xef, 0xac, 0xf7, 0x07,
+  0x72, 0xde, 0xe6, 0x8d, 0x1e, 0xa3, 0xc4, 0x07, 0x5f, 0x93, 0x24, 0x99,
+  0xd6, 0x41, 0xd3, 0xb7, 0x3c, 0x85, 0x9b, 0xb3, 0x25, 0xcc, 0xad, 0xe9,
+  0x49, 0xe3, 0x33, 0x3b, 0x26, 0x8e, 0xb0, 0x6c, 0xd6, 0x1a, 0x68, 0x23,
+  0xf3, 0xf2, 0xbb, 0xc0, 0xf1, 0x74, 0x0f, 0x24, 0x9e, 0x43, 0xff, 0x3a,
+  0xec, 0x52, 0xaf, 0xf9, 0xf5, 0x43, 0xa8, 0x37, 0xb2, 0x96, 0x83, 0x8d,
+  0xd3, 0x68, 0x95, 0x7c, 0xec, 0x0f, 0xdc, 0xe7, 0xf6, 0x6d, 0x6b, 0x05,
+  0x9e, 0x8f, 0xde, 0xaf, 0x30, 0xbc, 0x1d, 0x62, 0xe7, 0xe3, 0x0d, 0xaa,
+  0x9b, 0x29, 0xab, 0x21, 0xe9, 0xfe, 0x8b, 0x6c, 0x16, 0xe8, 0x62, 0xb1,
+  0xc3, 0x00, 0xcf, 0xce, 0xeb, 0x9a, 0x94, 0x64, 0xd2, 0x8f, 0x41, 0xe8,
+  0x14, 0x7f, 0xc2, 0x92, 0xac, 0x73, 0x20, 0x96, 0xff, 0x0f, 0x22, 0x39,
+  0xb4, 0xaa, 0xbe, 0xd0, 0xcc, 0x41, 0xf2, 0x61, 0x05, 0x4a, 0xa6, 0x48,
+  0x79, 0xe3, 0xf7, 0x7d, 0xc0, 0xe4, 0x18, 0xa9, 0x25, 0x36, 0x3b, 0xaf,
+  0x2d, 0x84, 0x62, 0x35, 0x4a, 0xe1, 0x67, 0xad, 0x9f, 0xaa, 0xa9, 0xa2,
+  0xd6, 0x75, 0x9b, 0x63, 0xd0, 0x7f, 0x9d, 0x63, 0x0c, 0x1f, 0x98, 0x2f,
+  0xa8, 0xd1, 0x58, 0x65, 0x80, 0x56, 0x52, 0x3e, 0xa1, 0xac, 0x73, 0x2c,
+  0xc8, 0xf6, 0xfe, 0xa3, 0x22, 0x96, 0xb8, 0x1b, 0x49, 0x0f, 0x57, 0xd4,
+  0xc1, 0x0e, 0x42, 0x60, 0x10, 0x49, 0x8a, 0x1e, 0xc7, 0x83, 0x7b, 0x29,
+  0x04, 0x40, 0x60, 0x9d, 0x6e, 0x18, 0xbc, 0x9a, 0xd1, 0xc3, 0x88, 0x7b,
+  0x7f, 0x10, 0x9d, 0x1d, 0x91, 0x9b, 0x4f, 0xfc, 0x2d, 0x54, 0xbd, 0xe7,
+  0x11, 0xe2, 0xfa, 0x59, 0x77, 0xe1, 0x70, 0x53, 0x3c, 0xd5, 0x58, 0x6b,
+  0xe9, 0x62, 0x65, 0x74, 0x26, 0xf9, 0xc2, 0x83, 0xf6, 0xa7, 0x7b, 0xcc,
+  0xb1, 0x6e, 0x21, 0x3f, 0x61, 0x7f, 0xba, 0x7b, 0xe3, 0xf3, 0x32, 0x7f,
+  0x7f, 0xba, 0x67, 0xb9, 0xb1, 0x91, 0x05, 0xd7, 0xad, 0x6b, 0x8b, 0xf8,
+  0x21, 0xd7, 0xe6, 0xc5, 0xca, 0x52, 0x12, 0xb9, 0x91, 0x8a, 0x3b, 0x37,
+  0x48, 0x8e, 0x19, 0x53, 0x19, 0x89, 0x11, 0xf2, 0xfa, 0x09, 0x97, 0xf6,
+  0x89, 0xcb, 0x4d, 0xdd, 0x8d, 0x91, 0xe2, 0xdf, 0x7c, 0x4a, 0xc8, 0x4e,
+  0xce, 0xd9, 0x47, 0xca, 0xba, 0x8a, 0xab, 0x6a, 0x0d, 0x6f, 0x66, 0xf2,
+  0x6a, 0x45, 0xd5, 0x79, 0x86, 0x47, 0xdd, 0xba, 0xd6, 0xac, 0x91, 0xa6,
+  0xe9, 0x46, 0x83, 0xa3, 0x8d, 0x24, 0xe7, 0x91, 0x24, 0xfd, 0x76, 0xa7,
+  0x83, 0xd1, 0x19, 0x79, 0x6d, 0x41, 0x69, 0xee, 0x15, 0xeb, 0xac, 0x87,
+  0xc9, 0x65, 0x7e, 0x19, 0x20, 0xba, 0x4f, 0xee, 0x9a, 0x48, 0x05, 0x0a,
+  0xad, 0x9a, 0x76, 0x61, 0xa7, 0x96, 0x04, 0xb7, 0xc7, 0x4f, 0x47, 0xfb,
+  0xbb, 0x03, 0xea, 0x7d, 0xbd, 0xc2, 0x0e, 0x50, 0x89, 0x80, 0xd5, 0xeb,
+  0xa8, 0x42, 0x26, 0xbf, 0x24, 0x61, 0x07, 0xc7, 0x42, 0x24, 0x13, 0x84,
+  0x1c, 0x6b, 0x92, 0x61, 0xa5, 0xe9, 0x4b, 0x82, 0x74, 0xd9, 0xae, 0x8e,
+  0xcb, 0x07, 0x68, 0x7a, 0x05, 0xb7, 0x58, 0xd7, 0x6f, 0x2d, 0xce, 0x32,
+  0xd7, 0xeb, 0xde, 0x93, 0xe4, 0xaa, 0x6c, 0x0b, 0x0f, 0x90, 0xee, 0x00,
+  0x88, 0x29, 0x08, 0xb7, 0x0c, 0xc2, 0xa2, 0xed, 0x17, 0xa7, 0x70, 0xaa,
+  0xf0, 0x17, 0xc4, 0xf6, 0x65, 0x0b, 0xc3, 0x72, 0x3c, 0x32, 0x50, 0xc9,
+  0x95, 0xc8, 0x4d, 0x1e, 0x06, 0x21, 0xa2, 0x97, 0x75, 0x7b, 0x39, 0x8c,
+  0xda, 0xd6, 0x85, 0x53, 0x5c, 0xd9, 0xd1, 0x68, 0x14, 0xa9, 0xa4, 0xbf,
+  0xce, 0xb3, 0x9b, 0x96, 0x17, 0x50, 0x66, 0x36, 0xb0, 0xbd, 0x19, 0xd8,
+  0xf8, 0xbc, 0xa6, 0x1d, 0x32, 0x43, 0x4e, 0x4a, 0xdb, 0x66, 0x7d, 0xc3,
+  0x45, 0xf6, 0x9f, 0xf6, 0xb6, 0xf9, 0x13, 0x6f, 0x73, 0x1d, 0x2b, 0x45,
+  0x63, 0x4c, 0x56, 0x07, 0x25, 0x3f, 0x20, 0x63, 0xac, 0xba, 0x4b, 0xd0,
+  0x33, 0xc0, 0x29, 0xa9, 0xe0, 0x2b, 0x9c, 0xfa, 0x9c, 0xd7, 0x0c, 0x89,
+  0xca, 0x90, 0x26, 0x61, 0xa0, 0x8a, 0x3f, 0xd3, 0xbe, 0xf3, 0xe2, 0xa0,
+  0x53, 0xee, 0x64, 0x58, 0xfb, 0x94, 0x6c, 0x60, 0x08, 0x59, 0xc5, 0x41,
+  0x87, 0x15, 0x18, 0xc9, 0x7a, 0x90, 0x13, 0xf1, 0x9a, 0x26, 0x78, 0x41,
+  0x7a, 0xd7, 0xc9, 0x22, 0xd1, 0x05, 0xc6, 0x43, 0x4d, 0x7a, 0xae, 0x7e,
+  0x00, 0xc8, 0x5f, 0xc9, 0xe4, 0x4e, 0xbb, 0x42, 0x89, 0x1b, 0xc8, 0x41,
+  0xbd, 0x76, 0xd5, 0x53, 0x57, 0x1a, 0xe7, 0xe0, 0x7c, 0x9c, 0x43, 0x8d,
+  0x71, 0xc3, 0xb0, 0x32, 0x19, 0xbc, 0xf6, 0x31, 0x7a, 0x83, 0x2a, 0x67,
+  0xd7, 0xb7, 0x84, 0x06, 0xe6, 0xde, 0x22, 0xd1, 0x23, 0x66, 0xd5, 0x8f,
+  0x0b, 0xee, 0xa9, 0xfb, 0xcd, 0x9a, 0x62, 0xde, 0xb8, 0xfb, 0x52, 0x38,
+  0x2b, 0xb5, 0xb2, 0x5d, 0x1c, 0x05, 0x8b, 0x46, 0x45, 0xbb, 0x3f, 0xba,
+  0x4a, 0x6f, 0x6f, 0x47, 0x75, 0xb6, 0x67, 0xa8, 0xb6, 0xde, 0xab, 0xeb,
+  0x05, 0x7d, 0xb4, 0x06, 0xf0, 0xd3, 0xc6, 0xc6, 0x7a, 0xb7, 0x77, 0x96,
+  0x80, 0x84, 0x19, 0x4f, 0x53, 0x7a, 0xb5, 0xc5, 0x6c, 0x5d, 0x67, 0x3d,
+  0xee, 0x4d, 0xd1, 0xcd, 0x56, 0x64, 0xcc, 0x5b, 0xa0, 0x37, 0xfb, 0x85,
+  0x7e, 0xcc, 0x1a, 0x5c, 0x5e, 0x88, 0x1d, 0xc7, 0x41, 0x79, 0x13, 0xca,
+  0x6d, 0xd5, 0x97, 0x55, 0x2e, 0x77, 0xd5, 0x8b, 0xca, 0x98, 0x4d, 0xb1,
+  0xb9, 0xd7, 0x46, 0x3e, 0x38, 0x44, 0x0f, 0x6e, 0x36, 0x43, 0x4a, 0x7c,
+  0xf9, 0x29, 0x82, 0x36, 0xd3, 0xe7, 0x31, 0xf1, 0x96, 0x46, 0x59, 0xea,
+  0x2f, 0x1c, 0xb6, 0xd9, 0xcd, 0xcd, 0xcd, 0x68, 0x93, 0xcb, 0xe4, 0x5f,
+  0x0e, 0xbf, 0xb5, 0x87, 0x3b, 0x35, 0x54, 0x7b, 0x62, 0xec, 0x88, 0xdb,
+  0xc4, 0x83, 0x97, 0xb0, 0x7d, 0x48, 0x34, 0x26, 0x90, 0x7c, 0x7b, 0xfe,
+  0xd6, 0xf6, 0xe0, 0xd5, 0xc2, 0x7e, 0x72, 0x3a, 0xd5, 0xa1, 0x7b, 0x3c,
+  0xcb, 0x19, 0xf2, 0x83, 0xf0, 0x6a, 0x5f, 0xbf, 0x3a, 0xfb, 0xf8, 0xfe,
+  0xe8, 0xe2, 0xe3, 0xf9, 0xab, 0xef, 0x68, 0x0b, 0xd9, 0x20, 0x34, 0xf2,
+  0x8a, 0x5c, 0x91, 0x55, 0x59, 0x52, 0x3f, 0xad, 0x77, 0xa8, 0x58, 0xca,
+  0x0b, 0x20, 0x3b, 0x44, 0x3b, 0x3c, 0x5b, 0xb8, 0x1a, 0x99, 0xa7, 0x99,
+  0xcb, 0x8b, 0xa4, 0xb5, 0x5f, 0x9f, 0x8c, 0xe5, 0x90, 0x2d, 0x46, 0x65,
+  0x75, 0x49, 0x54, 0xb8, 0xf7, 0x46, 0xf8, 0x67, 0x74, 0xb8, 0x3d, 0x09,
+  0xa8, 0x12, 0xfa, 0xd1, 0x75, 0x35, 0x27, 0xb0, 0x84, 0x87, 0xb6, 0x47,
+  0xf3, 0x48, 0xf3, 0x31, 0x18, 0xe0, 0xea, 0xfa, 0xf1, 0x06, 0x63, 0xa0,
+  0xdd, 0xa4, 0x52, 0xda, 0x4b, 0x81, 0x82, 0x60, 0x76, 0xfa, 0x61, 0x72,
+  0x2e, 0x0c, 0x5b, 0xdc, 0x0d, 0x22, 0xb5, 0xd7, 0x00, 0xf3, 0x2e, 0x6d,
+  0x15, 0x3b, 0x6a, 0x6b, 0x28, 0xbe, 0xbf, 0xb1, 0xbb, 0xb6, 0xd5, 0x83,
+  0xba, 0x66, 0x47, 0x5f, 0x85, 0xfa, 0xf0, 0x69, 0xa8, 0x4b, 0x52, 0xbf,
+  0x37, 0x6f, 0xcd, 0x4f, 0x65, 0xcd, 0x4f, 0xff, 0xa5, 0x35, 0x3f, 0xfd,
+  0x17, 0xd6, 0xfc, 0xf8, 0x17, 0x5e, 0xf3, 0xe3, 0xe8, 0x9a, 0xbd, 0xaf,
+  0x0c, 0xff, 0x46, 0x6b, 0xfe, 0xdb, 0xba, 0xf8, 0x34, 0x34, 0xf3, 0x25,
+  0x29, 0x2c, 0xed, 0x9d, 0xea, 0xb8, 0xca, 0xdc, 0xea, 0xf1, 0x01, 0xb7,
+  0xa2, 0xc3, 0x36, 0xf5, 0xda, 0x55, 0xa5, 0x52, 0x2d, 0xca, 0xd1, 0xc5,
+  0xde, 0xa6, 0xdc, 0x9e, 0xd7, 0x39, 0xa7, 0x52, 0xc3, 0x7a, 0x4a, 0xb6,
+  0x0d, 0x39, 0xc6, 0xb6, 0x64, 0x36, 0x3a, 0xec, 0x96, 0xb6, 0x7c, 0xc0,
+  0x4d, 0x4f, 0x43, 0x88, 0x95, 0x29, 0x0c, 0x6b, 0xdc, 0x49, 0x1b, 0x7e,
+  0x73, 0x2d, 0xa1, 0xf3, 0xb9, 0x85, 0x9f, 0xd1, 0x81, 0x39, 0x24, 0x41,
+  0xee, 0xe6, 0x90, 0x67, 0x5c, 0xdc, 0xad, 0x68, 0x40, 0x23, 0x9b, 0x2b,
+  0x23, 0x83, 0x39, 0x06, 0xce, 0xfd, 0xca, 0xed, 0x24, 0x93, 0xce, 0x04,
+  0xc5, 0xd1, 0x7a, 0x95, 0xdd, 0x6d, 0x07, 0x0a, 0xc3, 0x74, 0x51, 0x12,
+  0xbf, 0x21, 0xbd, 0x6e, 0x83, 0x26, 0x32, 0x71, 0xbd, 0xb5, 0x58, 0x5e,
+  0x74, 0x9a, 0x6d, 0xf9, 0x72, 0xe3, 0x53, 0x96, 0xad, 0xd2, 0x05, 0xaa,
+  0xfa, 0x29, 0xec, 0xda, 0xd7, 0xa3, 0xa7, 0x95, 0x97, 0xa5, 0x39, 0xcb,
+  0x78, 0xa3, 0x95, 0xf4, 0x02, 0x3e, 0xc7, 0x07, 0x49, 0x49, 0xfa, 0x49,
+  0x3e, 0x43, 0x99, 0x5d, 0xbc, 0x65, 0x83, 0xc3, 0x83, 0xb7, 0x93, 0x80,
+  0xe1, 0x39, 0x11, 0xf8, 0x09, 0xfb, 0x09, 0x85, 0xb0, 0xa2, 0xac, 0x80,
+  0xeb, 0x9c, 0xb2, 0x81, 0xba, 0xb0, 0xa7, 0xf6, 0x7d, 0x7e, 0x1d, 0x80,
+  0x36, 0x2d, 0xd0, 0x76, 0x3e, 0x40, 0x7a, 0xa2, 0xb4, 0xf2, 0x8f, 0xd4,
+  0x0d, 0xb4, 0x30, 0x0c, 0x48, 0x4a, 0xb1, 0x5b, 0x59, 0xff, 0xbd, 0x78,
+  0x7d, 0xf6, 0xf1, 0x9b, 0xa3, 0xa3, 0xb3, 0xe3, 0x37, 0x27, 0x47, 0x72,
+  0x61, 0xec, 0x8f, 0xde, 0x5f, 0x7c, 0x7b, 0xa2, 0x2d, 0xaa, 0x94, 0x16,
+  0x03, 0x82, 0x17, 0xc4, 0x71, 0x66, 0xca, 0x03, 0x74, 0xe2, 0x29, 0x9a,
+  0xe4, 0xd5, 0xf1, 0xf7, 0x46, 0x6b, 0x3d, 0x1b, 0x7e, 0xf8, 0x3e, 0x68,
+  0x83, 0xe0, 0xa5, 0xb7, 0xf7, 0xb6, 0x27, 0x37, 0x84, 0x08, 0xdb, 0xd1,
+  0xad, 0xbd, 0x2f, 0xdb, 0xe7, 0x17, 0x16, 0x83, 0xd4, 0x5b, 0xb9, 0xb0,
+  0x0a, 0x03, 0xbf, 0xa8, 0xad, 0x46, 0xbc, 0x8c, 0x9a, 0xa7, 0xfb, 0xda,
+  0xc1, 0x69, 0xa3, 0xbf, 0xf4, 0xf3, 0xb6, 0xcd, 0xf8, 0x29, 0xbb, 0x03,
+  0x7c, 0x5c, 0xf2, 0x92, 0xfe, 0x1b, 0xef, 0xb0, 0x75, 0x56, 0xe5, 0xd7,
+  0xa4, 0xff, 0x99, 0x67, 0x39, 0x9a, 0x44, 0x8f, 0x8e, 0x6c, 0xbf, 0x31,
+  0x89, 0x68, 0xd1, 0x20, 0x08, 0x7a, 0x63, 0x50, 0x10, 0x56, 0x10, 0x15,
+  0xcd, 0x67, 0xec, 0xeb, 0xe0, 0xf1, 0x30, 0xa0, 0xd9, 0x9e, 0x51, 0xf2,
+  0xe6, 0xe8, 0x7c, 0x90, 0x9c, 0x1d, 0xbd, 0xe3, 0x1c, 0xf9, 0xa3, 0xf7,
+  0x5f, 0x71, 0x0b, 0x36, 0xed, 0xac, 0x85, 0x20, 0x6c, 0x98, 0x27, 0xe6,
+  0xed, 0x89, 0x79, 0x17, 0x49, 0x71, 0x75, 0x6d, 0xa4, 0xeb, 0xaf, 0x88,
+  0xdd, 0xc1, 0x6b, 0x7b, 0x69, 0xfe, 0x13, 0xdb, 0x2a, 0x63, 0x47, 0x7c,
+  0x1d, 0xd9, 0x2e, 0x51, 0xcc, 0x6c, 0xd8, 0x5e, 0x8c, 0x02, 0xda, 0x0d,
+  0xde, 0x31, 0xb3, 0x21, 0x61, 0x00, 0x59, 0x37, 0x08, 0x66, 0x1f, 0xd0,
+  0x4b, 0xb8, 0x6f, 0xa7, 0x84, 0xff, 0xc8, 0x8a, 0x35, 0x9f, 0x1b, 0x10,
+  0x5d, 0x02, 0x0b, 0xd9, 0x6d, 0x46, 0xac, 0x30, 0xb3, 0xca, 0xb9, 0x07,
+  0x6a, 0x07, 0x14, 0xcb, 0x6c, 0x77, 0x3e, 0xe3, 0xe2, 0x6f, 0x8a, 0x5d,
+  0x95, 0x15, 0xc5, 0x8e, 0xa9, 0xea, 0xfa, 0xff, 0xdd, 0x1b, 0xd5, 0xf5,
+  0xd5, 0x5e, 0x3e, 0xfb, 0x58, 0xd5, 0xe9, 0x76, 0x57, 0x16, 0x79, 0xbf,
+  0x9e, 0xd1, 0xaf, 0x93, 0xed, 0x91, 0x7d, 0x54, 0xfe, 0x4e, 0x3f, 0x8f,
+  0x96, 0x21, 0xab, 0x08, 0x62, 0xf7, 0x89, 0xa6, 0x92, 0x69, 0xe7, 0xb6,
+  0x45, 0x3e, 0xa9, 0x8c, 0x02, 0xe7, 0x1a, 0x0f, 0x48, 0x23, 0xb6, 0xd5,
+  0xa7, 0x69, 0x7d, 0x70, 0x10, 0x69, 0xe3, 0xae, 0xd5, 0x55, 0x03, 0x4d,
+  0x09, 0x3c, 0xfb, 0xe6, 0xf5, 0xf8, 0x77, 0x07, 0x07, 0xc8, 0xc0, 0xdc,
+  0xa1, 0x4c, 0xb9, 0x67, 0x4f, 0x0e, 0x0e, 0x77, 0x63, 0xea, 0x63, 0x90,
+  0x52, 0x40, 0xcd, 0xf3, 0x52, 0x47, 0x9f, 0xb4, 0xfb, 0x88, 0xb0, 0x49,
+  0xbe, 0xb5, 0x1d, 0x7a, 0x96, 0x51, 0x7e, 0x12, 0x8a, 0xca, 0x38, 0x92,
+  0x82, 0xb4, 0xad, 0x20, 0xea, 0x6b, 0x21, 0x58, 0xb6, 0x78, 0xf6, 0x2f,
+  0xb6, 0x2c, 0x55, 0xf9, 0xe9, 0xab, 0x08, 0x7d, 0x7b, 0xb3, 0x1e, 0xf1,
+  0x3e, 0x75, 0x3d, 0xfb, 0xfe, 0xba, 0x90, 0x63, 0xe5, 0x30, 0x6e, 0x58,
+  0x7c, 0xb9, 0xae, 0x75, 0x9d, 0xd8, 0x24, 0x85, 0x26, 0x03, 0xef, 0x9e,
+  0xcc, 0x69, 0x8b, 0xe9, 0x87, 0x08, 0x3e, 0x75, 0x83, 0xda, 0xdd, 0xf7,
+  0x18, 0x84, 0x3f, 0x68, 0x18, 0xf1, 0xe3, 0x6f, 0x24, 0x5b, 0xe6, 0xee,
+  0xc6, 0x87, 0xfc, 0x55, 0xef, 0x64, 0x35, 0x49, 0x5e, 0x2e, 0xcc, 0x8b,
+  0x8b, 0x9e, 0xaa, 0x9f, 0x23, 0xee, 0xf4, 0xf3, 0x4d, 0x56, 0x4d, 0xb2,
+  0xaa, 0xac, 0x3b, 0x05, 0x0a, 0xda, 0x50, 0x9e, 0x7d, 0x2a, 0x18, 0x47,
+  0x33, 0x35, 0x82, 0x9e, 0x7e, 0x0d, 0xac, 0x6f, 0x81, 0x97, 0x6e, 0x43,
+  0x82, 0x6c, 0xa3, 0x4c, 0x82, 0x2e, 0x00, 0xb5, 0xb6, 0xa1, 0x3f, 0xd1,
+  0x60, 0x9e, 0xfa, 0x50, 0xe4, 0xe9, 0x62, 0x9b, 0x1a, 0x8e, 0x74, 0xaf,
+  0x91, 0x50, 0xda, 0xf6, 0x88, 0x6a, 0x5f, 0xd8, 0x58, 0x43, 0x02, 0x06,
+  0x2a, 0x3d, 0xd3, 0x44, 0xe6, 0xa2, 0xa9, 0xa5, 0x74, 0xcd, 0x5d, 0x06,
+  0x52, 0x1d, 0x34, 0x61, 0xb1, 0xc3, 0xb5, 0x51, 0x5b, 0xfa, 0x92, 0x1b,
+  0x7f, 0x61, 0x31, 0xc5, 0xc7, 0xf0, 0x93, 0xfb, 0xf6, 0x5a, 0x77, 0x7b,
+  0x67, 0x38, 0x3d, 0x2b, 0xff, 0x9c, 0xf5, 0xfd, 0x68, 0x17, 0xcc, 0x57,
+  0x5c, 0x98, 0xda, 0x81, 0x39, 0x00, 0x20, 0x3a, 0x55, 0x53, 0xcc, 0xd8,
+  0x30, 0x94, 0xc2, 0x3b, 0x17, 0xb3, 0x65, 0x4e, 0x13, 0xc6, 0xe5, 0xb0,
+  0x54, 0xb4, 0x2e, 0xd0, 0x69, 0x0f, 0xd9, 0x78, 0x7f, 0x9d, 0x88, 0x37,
+  0x02, 0x25, 0x19, 0x37, 0x15, 0x01, 0x35, 0x16, 0x0e, 0xee, 0x75, 0x91,
+  0xf5, 0xe2, 0xf7, 0x28, 0x98, 0xa3, 0x39, 0xa4, 0x85, 0xb4, 0x55, 0xd3,
+  0x44, 0xa8, 0x4a, 0xe7, 0x34, 0x94, 0x38, 0xb2, 0x3a, 0x0c, 0xe8, 0xbd,
+  0x7f, 0xbb, 0x17, 0xcd, 0xe1, 0xbe, 0xb3, 0x73, 0x2a, 0x7d, 0xac, 0x42,
+  0xfb, 0xc1, 0x30, 0x55, 0x9d, 0x0a, 0x23, 0x24, 0x2b, 0x0f, 0x21, 0x93,
+  0x5e, 0x1a, 0x7e, 0x9a, 0x05, 0x38, 0x3d, 0xe3, 0x56, 0x69, 0xb7, 0x74,
+  0x9b, 0xd4, 0xea, 0x1d, 0xbc, 0x67, 0xbb, 0xee, 0xba, 0xa8, 0x10, 0x68,
+  0x7f, 0x08, 0x95, 0xb5, 0xeb, 0x6e, 0xa3, 0x4e, 0x09, 0xae, 0x42, 0x14,
+  0xb7, 0x16, 0x38, 0xd8, 0x8a, 0xaf, 0xa2, 0x09, 0x9a, 0xbc, 0x1d, 0xe4,
+  0x8b, 0x96, 0xd4, 0x3f, 0x18, 0x17, 0x69, 0xe0, 0x03, 0x41, 0xae, 0x35,
+  0x37, 0x1f, 0x10, 0x22, 0xd8, 0x9e, 0xb1, 0x67, 0x14, 0x47, 0x62, 0xa7,
+  0x4a, 0x17, 0x4f, 0xc2, 0x0c, 0x0c, 0xd8, 0x6e, 0x6e, 0x74, 0x60, 0x2a,
+  0x4c, 0xcc, 0x10, 0x37, 0xf9, 0xac, 0xb9, 0x42, 0x3b, 0x10, 0xb5, 0x8c,
+  0x6a, 0x29, 0x49, 0x26, 0x27, 0x75, 0x1e, 0x16, 0xdc, 0x4c, 0x7a, 0x1c,
+  0x78, 0x7c, 0x60, 0xd8, 0xd4, 0x84, 0xb1, 0x79, 0xc8, 0x51, 0x87, 0x73,
+  0x80, 0x53, 0x7b, 0x8f, 0x55, 0x3d, 0x8b, 0x4a, 0x91, 0x9a, 0x5b, 0x34,
+  0xa7, 0x4e, 0x1f, 0x81, 0xb9, 0xa6, 0x95, 0x31, 0x23, 0xbd, 0x21, 0x44,
+  0xc3, 0xdb, 0x9f, 0x18, 0x8f, 0xfb, 0x9b, 0x6d, 0x6d, 0x68, 0x49, 0x88,
+  0x6b, 0x5e, 0xf2, 0x3e, 0xf1, 0xf2, 0xe4, 0x53, 0x1e, 0x82, 0xc4, 0xe3,
+  0xeb, 0x03, 0xc3, 0x6b, 0x96, 0x3c, 0xc2, 0xbb, 0x6d, 0x75, 0x94, 0x52,
+  0xad, 0xf6, 0x65, 0x2a, 0xbf, 0x67, 0x9c, 0x86, 0xed, 0x4b, 0x7e, 0xe8,
+  0x2b, 0xf7, 0x50, 0x67, 0x38, 0xf2, 0xda, 0xb3, 0x97, 0x5e, 0xf3, 0x78,
+  0xea, 0x17, 0x94, 0x1b, 0xfe, 0xcd, 0x20, 0x79, 0xb4, 0xc4, 0xa1, 0x1c,
+  0x7c, 0x15, 0x63, 0x5c, 0xdc, 0x9e, 0xb4, 0x2e, 0x6d, 0xa5, 0xee, 0xf0,
+  0x2f, 0x64, 0x72, 0x61, 0xc3, 0x98, 0x2e, 0x6d, 0x11, 0x0a, 0x07, 0xf8,
+  0x94, 0x1f, 0x44, 0x82, 0x0e, 0x48, 0xe3, 0x5a, 0x91, 0x91, 0x30, 0xcb,
+  0x14, 0xa0, 0x78, 0x09, 0xef, 0x26, 0x25, 0x6a, 0xac, 0xa4, 0x12, 0x9f,
+  0xc8, 0x75, 0x68, 0xd1, 0x0f, 0xeb, 0x05, 0x3d, 0x80, 0x0e, 0x3d, 0x65,
+  0x90, 0xd4, 0xb9, 0x58, 0xc1, 0x40, 0xb2, 0x4d, 0xb4, 0xbc, 0x49, 0x51,
+  0x41, 0xdd, 0x34, 0x11, 0x1f, 0xcf, 0xaf, 0x28, 0x12, 0x17, 0xc8, 0x0e,
+  0xca, 0xeb, 0x66, 0x18, 0x81, 0x9a, 0x44, 0x0c, 0xe8, 0xec, 0xf4, 0xec,
+  0xd1, 0xae, 0x8f, 0xc7, 0x27, 0x75, 0xd9, 0xdc, 0x6e, 0x0e, 0x51, 0x22,
+  0x5b, 0xb3, 0x3d, 0x50, 0x76, 0xc3, 0x15, 0x42, 0xa1, 0x6d, 0x39, 0x15,
+  0xb0, 0x2a, 0x62, 0x2e, 0xf8, 0x22, 0x5c, 0xfe, 0x2e, 0x47, 0xdd, 0x6b,
+  0xc4, 0xe6, 0x2e, 0xa6, 0x22, 0xb3, 0x7d, 0x16, 0x22, 0x5a, 0xd4, 0x9c,
+  0xcb, 0x0a, 0x30, 0x88, 0x21, 0xea, 0x8e, 0xda, 0xad, 0x0c, 0x28, 0x67,
+  0x3a, 0x98, 0x65, 0xc2, 0x39, 0x0f, 0x91, 0x6c, 0x12, 0x29, 0xf0, 0x71,
+  0x4f, 0x22, 0x20, 0xa1, 0x75, 0x58, 0x00, 0x36, 0x71, 0xf1, 0x59, 0xf2,
+  0x96, 0x12, 0xd5, 0x32, 0x9c, 0xeb, 0xa8, 0xb7, 0x05, 0xb5, 0x85, 0xd4,
+  0x6f, 0x59, 0x64, 0xd2, 0x30, 0x29, 0x4d, 0xde, 0x9f, 0x8c, 0x2f, 0xfc,
+  0x20, 0x12, 0xf4, 0xb0, 0x20, 0x8b, 0xb2, 0x8d, 0x29, 0xe5, 0xa5, 0x22,
+  0x9c, 0x1c, 0x8f, 0x2f, 0x46, 0x31, 0xb0, 0x78, 0xa3, 0x9d, 0x8f, 0x29,
+  0xd3, 0xbf, 0x55, 0xa3, 0x9f, 0x70, 0x63, 0x62, 0xce, 0x71, 0xe4, 0xe8,
+  0x18, 0x47, 0x8b, 0xf2, 0xca, 0xaf, 0x47, 0xef, 0x0e, 0x67, 0xa6, 0xf8,
+  0x47, 0xce, 0x90, 0x94, 0xec, 0x4a, 0x8d, 0x12, 0xd5, 0xeb, 0xc9, 0xd0,
+  0x03, 0x71, 0x63, 0x7d, 0x07, 0xdd, 0x81, 0x0c, 0xf5, 0x1a, 0x09, 0xf5,
+  0x29, 0xb4, 0x31, 0x77, 0x98, 0xa0, 0xb0, 0x3f, 0x02, 0xbe, 0xd7, 0x72,
+  0x75, 0x4f, 0x93, 0x0c, 0x60, 0x9f, 0x70, 0x32, 0xd1, 0xb3, 0x0f, 0x26,
+  0x2a, 0xda, 0x8a, 0xce, 0x4e, 0x4a, 0x43, 0xb9, 0x76, 0xba, 0x34, 0x85,
+  0xed, 0x7e, 0x4a, 0x9c, 0xd2, 0x23, 0x41, 0x47, 0x74, 0x75, 0x96, 0xb1,
+  0xcb, 0xc9, 0x4e, 0xbb, 0x17, 0x7f, 0x34, 0x9f, 0x31, 0x04, 0x5f, 0xdd,
+  0xc6, 0xe0, 0xe3, 0x7a, 0x6b, 0x62, 0x3a, 0xdc, 0x7b, 0x84, 0x54, 0xb7,
+  0xbe, 0x93, 0x64, 0x9f, 0x5c, 0x2b, 0x35, 0x6e, 0xf8, 0x3d, 0x27, 0x5b,
+  0x22, 0x50, 0x36, 0xe8, 0x03, 0x87, 0x0a, 0xc9, 0x48, 0xfb, 0xc0, 0x7c,
+  0x38, 0x7e, 0x73, 0x62, 0x77, 0x4b, 0x76, 0x07, 0xd9, 0x7b, 0x76, 0xad,
+  0x94, 0x51, 0xaf, 0x6c, 0x13, 0x67, 0x12, 0x04, 0x7d, 0xd6, 0x45, 0xfe,
+  0x77, 0x64, 0x66, 0x40, 0x77, 0x9d, 0xe7, 0x40, 0x12, 0x42, 0xd3, 0xf0,
+  0x44, 0x25, 0xd9, 0x76, 0x6d, 0x9b, 0x68, 0xe5, 0x33, 0x9b, 0x79, 0xce,
+  0x31, 0xbe, 0x68, 0xea, 0xe3, 0x46, 0xd0, 0x86, 0x83, 0x36, 0xb2, 0x22,
+  0x00, 0x56, 0x05, 0x07, 0xc9, 0x08, 0xa4, 0x3d, 0x54, 0x4e, 0x05, 0xca,
+  0x05, 0x74, 0x33, 0x97, 0x8f, 0xd3, 0xc6, 0xf7, 0x28, 0x2b, 0xa9, 0xb7,
+  0xda, 0x79, 0x7b, 0x7e, 0xfa, 0x6e, 0x78, 0x71, 0x8a, 0x2e, 0xdb, 0x30,
+  0xe7, 0x16, 0x49, 0x12, 0xd1, 0x37, 0xf9, 0xbd, 0xda, 0x6f, 0x16, 0xde,
+  0x4e, 0x5d, 0xdb, 0xa9, 0x77, 0xb5, 0x97, 0x37, 0x44, 0x0a, 0xa6, 0xa7,
+  0x6f, 0x05, 0x9d, 0x13, 0x0a, 0xd6, 0x44, 0x52, 0x74, 0x67, 0x24, 0xbf,
+  0xe3, 0xd4, 0x8b, 0x63, 0xe1, 0x7d, 0xe5, 0xdc, 0x93, 0x75, 0x7d, 0x97,
+  0x48, 0x59, 0x1b, 0xc1, 0xa5, 0xc1, 0x96, 0x0a, 0xa3, 0x03, 0xb6, 0xed,
+  0xaf, 0x05, 0x49, 0xa1, 0x82, 0x1f, 0xae, 0x28, 0x69, 0x4a, 0x73, 0x7d,
+  0xd3, 0xaa, 0x2a, 0x6f, 0x54, 0x70, 0x49, 0xd9, 0xa9, 0x99, 0x3a, 0x1d,
+  0x52, 0x75, 0xd7, 0x0b, 0x2c, 0x21, 0x58, 0x49, 0xda, 0xb4, 0x78, 0xa3,
+  0xfa, 0xf7, 0xa4, 0x5d, 0xee, 0xaf, 0xc9, 0xa7, 0xc3, 0xa6, 0x5a, 0xd7,
+  0x61, 0xff, 0x73, 0x71, 0x3b, 0x9f, 0x10, 0x9b, 0x6c, 0x67, 0xab, 0x0e,
+  0x04, 0xcc, 0x8d, 0xb0, 0x3f, 0xd0, 0x66, 0xca, 0xfa, 0x25, 0xe1, 0x9f,
+  0xe0, 0x98, 0xe2, 0x1f, 0x82, 0x1b, 0x2c, 0x28, 0xaf, 0xa4, 0xd1, 0x53,
+  0x07, 0x49, 0x64, 0xac, 0xba, 0x16, 0x80, 0x79, 0xc3, 0xad, 0xff, 0x34,
+  0xa1, 0x14, 0x38, 0x4e, 0x60, 0x06, 0xf4, 0xd3, 0x40, 0x97, 0x54, 0x80,
+  0x96, 0x9c, 0x8a, 0xe3, 0x67, 0xeb, 0x29, 0x8e, 0x89, 0x22, 0x7e, 0xd4,
+  0x59, 0x70, 0xc2, 0x90, 0x91, 0x5a, 0x5f, 0x4e, 0x43, 0xbb, 0x4c, 0x5d,
+  0x76, 0xe0, 0x74, 0xb5, 0xac, 0x84, 0x1f, 0x73, 0xed, 0x92, 0x48, 0x99,
+  0xa4, 0x54, 0xa0, 0x8c, 0x15, 0xcb, 0xaa, 0x6b, 0x73, 0x52, 0x54, 0x49,
+  0xdb, 0xb5, 0x86, 0xec, 0x8a, 0xf0, 0xba, 0x81, 0x54, 0x2c, 0x41, 0x7f,
+  0x02, 0xd5, 0x23, 0x02, 0x46, 0xd0, 0xfd, 0xcf, 0x69, 0x6d, 0xf8, 0x52,
+  0x7b, 0xbc, 0xdd, 0x0d, 0xee, 0xe9, 0xb5, 0xe6, 0x74, 0x7b, 0xa7, 0xd7,
+  0x3a, 0x90, 0xf8, 0xc9, 0x1d, 0xb7, 0xca, 0xeb, 0x39, 0x35, 0xc3, 0xdb,
+  0x71, 0x61, 0x51, 0xc0, 0x7c, 0x43, 0x9a, 0x6c, 0x8a, 0x46, 0xbb, 0xd7,
+  0x31, 0xe6, 0x94, 0xda, 0x56, 0x72, 0x4d, 0xa2, 0x1f, 0x4d, 0x76, 0xb4,
+  0xe8, 0xcc, 0x16, 0x41, 0x9c, 0xc8, 0xaf, 0x5e, 0xd8, 0xaa, 0x38, 0xe2,
+  0x69, 0x9d, 0xe1, 0x1e, 0x7d, 0xff, 0x7d, 0xbb, 0xf5, 0xeb, 0x6e, 0x5f,
+  0x1d, 0xbe, 0xa4, 0xc3, 0xcf, 0x98, 0xf7, 0xe9, 0x84, 0x83, 0x92, 0x1e,
+  0x25, 0x3b, 0x0a, 0x31, 0x20, 0x81, 0x98, 0x1d, 0x30, 0xe2, 0x29, 0x32,
+  0x26, 0xe0, 0x95, 0xd6, 0x79, 0xb4, 0x52, 0x38, 0x50, 0xa1, 0x7f, 0x1c,
+  0xc9, 0x72, 0x02, 0xc3, 0xd5, 0xdc, 0x0b, 0x8e, 0xa9, 0x20, 0x1d, 0xd6,
+  0xdf, 0x2e, 0xd7, 0x1d, 0xbc, 0xbe, 0xa2, 0xd8, 0x82, 0x60, 0xc4, 0x6e,
+  0xee, 0x4f, 0x6b, 0x31, 0xfb, 0x6c, 0xd5, 0x17, 0xe4, 0x3d, 0x23, 0xda,
+  0x53, 0x16, 0xdd, 0xb4, 0xca, 0xc4, 0xdb, 0xa0, 0xfd, 0x47, 0x82, 0x28,
+  0x32, 0xe1, 0x85, 0xf0, 0xe5, 0x81, 0x53, 0x35, 0xf5, 0xee, 0x8b, 0x83,
+  0x7a, 0xeb, 0x9c, 0x98, 0x64, 0x80, 0x87, 0xda, 0xfb, 0x4d, 0x09, 0x74,
+  0x3f, 0xb4, 0x7d, 0x01, 0x62, 0x55, 0xc9, 0x8e, 0x2d, 0xe9, 0x5c, 0xca,
+  0xf2, 0xe6, 0x0f, 0x7a, 0x73, 0x47, 0x7e, 0xf0, 0x92, 0xa8, 0x20, 0x16,
+  0x02, 0x55, 0x66, 0x42, 0xe7, 0x42, 0xb0, 0xa2, 0x54, 0xcb, 0xac, 0xdd,
+  0x90, 0xc8, 0x53, 0xac, 0x31, 0x72, 0x56, 0xa7, 0x51, 0x04, 0x6f, 0x7b,
+  0x92, 0x07, 0xc9, 0x44, 0x7a, 0x65, 0x29, 0x87, 0x07, 0x4e, 0x4f, 0x07,
+  0x89, 0xc5, 0xce, 0x2d, 0x63, 0x94, 0x0e, 0xf1, 0x58, 0xdd, 0x97, 0x6e,
+  0x22, 0xa0, 0xc7, 0x68, 0x81, 0xcc, 0x9d, 0x1b, 0xfc, 0x3d, 0x53, 0x37,
+  0x99, 0x05, 0x5c, 0x90, 0x1a, 0x17, 0x69, 0x01, 0xf0, 0xd5, 0xd1, 0x45,
+  0xf7, 0x6a, 0xf9, 0x91, 0x43, 0xc0, 0x1b, 0x98, 0x7f, 0x9f, 0x7d, 0xb8,
+  0xd8, 0x75, 0xed, 0xed, 0x85, 0x5c, 0xfd, 0x14, 0x79, 0x29, 0x9d, 0x0b,
+  0xab, 0x00, 0x18, 0x50, 0x40, 0xf8, 0x94, 0x24, 0x03, 0xc9, 0xcd, 0x20,
+  0x1f, 0xcb, 0xa3, 0xfd, 0x03, 0x63, 0x47, 0xed, 0x1f, 0xa2, 0xd7, 0xed,
+  0xa3, 0xfd, 0x47, 0xb6, 0x06, 0x5b, 0x9f, 0x0a, 0x11, 0xf2, 0xf9, 0x45,
+  0xb8, 0x4c, 0x40, 0xf7, 0x8f, 0x6e, 0x6f, 0xf1, 0xe3, 0x76, 0x66, 0xf7,
+  0xd0, 0x56, 0x43, 0xf9, 0xd3, 0x8c, 0xca, 0x7d, 0x6f, 0xbf, 0x11, 0xd9,
+  0x5b, 0x17, 0x5c, 0x7b, 0x88, 0x5e, 0xc2, 0x04, 0x59, 0x30, 0xea, 0x6f,
+  0xac, 0xe3, 0x75, 0x09, 0x13, 0x60, 0x26, 0xbf, 0x33, 0x96, 0x21, 0x16,
+  0x1f, 0xec, 0x42, 0x00, 0x10, 0x02, 0xd6, 0x4c, 0xcf, 0x08, 0x54, 0x8c,
+  0xd9, 0x83, 0x5b, 0xb7, 0x43, 0xb6, 0x5b, 0xa3, 0x30, 0x00, 0x23, 0xe8,
+  0x84, 0x1d, 0xd9, 0x3c, 0xfe, 0x88, 0x13, 0x82, 0xf8, 0xdf, 0x0b, 0x4a,
+  0x13, 0x31, 0x77, 0x02, 0xfb, 0xab, 0x7f, 0x3d, 0x94, 0x54, 0x11, 0xfe,
+  0xd7, 0xa3, 0xb6, 0xa4, 0x24, 0xf7, 0xb0, 0x0e, 0xfa, 0x52, 0xfe, 0x12,
+  0xf8, 0x2a, 0xd1, 0xe2, 0x14, 0xba, 0x31, 0x9a, 0x53, 0xec, 0xb6, 0xfc,
+  0x27, 0x18, 0xc3, 0x4e, 0x4c, 0xb4, 0x14, 0x69, 0x1e, 0xcd, 0x2c, 0xba,
+  0x4b, 0x1b, 0x2d, 0xf9, 0x30, 0xea, 0xeb, 0x3d, 0xa6, 0x9a, 0x60, 0x30,
+  0xbe, 0x26, 0x58, 0xd8, 0x62, 0x65, 0x4f, 0x25, 0x2e, 0x57, 0xb1, 0xbb,
+  0x5b, 0x6b, 0x36, 0x2d, 0x09, 0x57, 0xeb, 0x6c, 0x97, 0x39, 0x76, 0xa6,
+  0x93, 0xbc, 0x6a, 0xd0, 0x8a, 0x16, 0x7e, 0xb0, 0xd0, 0x44, 0xa5, 0xad,
+  0x18, 0xf0, 0x56, 0xa0, 0xc5, 0x33, 0xf5, 0xea, 0xd0, 0x34, 0xcb, 0xd6,
+  0x4c, 0x39, 0x10, 0xb2, 0xf4, 0x13, 0x35, 0x22, 0x12, 0x4d, 0x92, 0x34,
+  0x70, 0xcc, 0xed, 0x85, 0xae, 0x28, 0xf3, 0x3c, 0x83, 0xda, 0x2f, 0x8d,
+  0x68, 0x1f, 0x0f, 0xf0, 0xb7, 0x27, 0xfb, 0xcf, 0xf9, 0x44, 0x8f, 0x8f,
+  0x2e, 0xde, 0x76, 0x9d, 0x79, 0x95, 0x21, 0x28, 0xfe, 0xef, 0x30, 0x4b,
+  0xab, 0x2b, 0x63, 0x5c, 0x10, 0x4a, 0xcb, 0x90, 0xa0, 0xff, 0x87, 0xfb,
+  0xfb, 0xb1, 0xbc, 0x8d, 0x5f, 0xb1, 0x32, 0xfd, 0xd1, 0xe3, 0x76, 0x48,
+  0x8f, 0x54, 0xfa, 0x21, 0x6d, 0x77, 0x3f, 0x88, 0x68, 0x9b, 0xbc, 0x52,
+  0xd5, 0x9d, 0xe5, 0xf1, 0x56, 0xc0, 0x3e, 0x4b, 0x2c, 0x1a, 0x6d, 0xd2,
+  0xc5, 0xe0, 0xf3, 0x4c, 0xec, 0xae, 0x7a, 0x63, 0xb3, 0x93, 0x8c, 0x98,
+  0x87, 0x4c, 0x6a, 0xee, 0x76, 0x13, 0x6e, 0x61, 0xc7, 0x9d, 0xa6, 0x1a,
+  0xd7, 0x4c, 0x3c, 0x5a, 0xb3, 0x5b, 0x4b, 0xd9, 0x52, 0x95, 0x11, 0xda,
+  0x13, 0xab, 0x7d, 0xd2, 0xb1, 0xe7, 0x7e, 0xc4, 0x2a, 0x6c, 0x41, 0x35,
+  0x5d, 0x49, 0xfd, 0x1a, 0xff, 0x9b, 0x44, 0x71, 0x2b, 0x7f, 0xf6, 0xf0,
+  0x49, 0x64, 0xe3, 0x20, 0xb0, 0x7f, 0xe6, 0xc6, 0x39, 0xe5, 0x88, 0xfd,
+  0x77, 0x30, 0x78, 0x6d, 0x95, 0x4d, 0x88, 0x24, 0x54, 0x6b, 0x47, 0xd9,
+  0x9f, 0xbc, 0x16, 0xda, 0xed, 0xd1, 0x26, 0xdc, 0x3b, 0xf7, 0xd6, 0xcf,
+  0x5c, 0xcb, 0xc0, 0x35, 0x5d, 0x20, 0xe9, 0xb1, 0x94, 0x9e, 0x52, 0xf0,
+  0x33, 0x20, 0xa0, 0xd9, 0xc5, 0xa4, 0xc8, 0x56, 0x19, 0x16, 0xef, 0xe7,
+  0x2d, 0x78, 0xc4, 0x6d, 0x6d, 0x54, 0xb2, 0x15, 0xb5, 0x16, 0xcb, 0x08,
+  0xd1, 0x7c, 0x45, 0x60, 0x03, 0x75, 0xd4, 0xcf, 0xd2, 0xea, 0x1b, 0x8f,
+  0xcd, 0x54, 0x97, 0xec, 0x40, 0xc4, 0x98, 0xbc, 0xae, 0x7b, 0xac, 0x3c,
+  0x2b, 0x50, 0x1a, 0xaf, 0xd3, 0x05, 0x99, 0xeb, 0x18, 0xc3, 0x1e, 0x56,
+  0xe9, 0x8a, 0x7a, 0x79, 0xf0, 0xb2, 0x47, 0xfc, 0xfb, 0xf3, 0x28, 0xec,
+  0xfb, 0x9c, 0xf0, 0xa8, 0xca, 0xec, 0xb7, 0xe7, 0x6f, 0xff, 0xa2, 0x76,
+  0xf7, 0xee, 0xa0, 0xc7, 0x12, 0xee, 0x4c, 0x77, 0x92, 0x79, 0x89, 0x80,
+  0x52, 0x7d, 0xde, 0xda, 0x75, 0xfe, 0x97, 0xcb, 0xb2, 0x0c, 0x82, 0x0a,
+  0x48, 0xfa, 0xd8, 0xa1, 0x30, 0x9b, 0x79, 0x6e, 0x2c, 0x26, 0xdd, 0xa3,
+  0xd1, 0x13, 0xf8, 0x43, 0xde, 0xbe, 0x7e, 0xf2, 0xe8, 0xf0, 0xc0, 0x58,
+  0xad, 0x3b, 0x1d, 0x6e, 0xb1, 0xfb, 0xd9, 0x83, 0x76, 0xdb, 0x9e, 0x77,
+  0x76, 0xbb, 0x22, 0xda, 0xdb, 0x39, 0xfa, 0xfe, 0xec, 0x7d, 0xb0, 0x46,
+  0xb3, 0xa6, 0x20, 0x90, 0xda, 0xb7, 0x46, 0xa7, 0x0b, 0xb4, 0xc6, 0xd7,
+  0xfc, 0x63, 0xf4, 0xca, 0x8d, 0x84, 0x2a, 0xdf, 0x56, 0x39, 0xe9, 0xb8,
+  0x5b, 0xb4, 0x25, 0x5b, 0x27, 0x65, 0x31, 0x33, 0xa2, 0xff, 0x94, 0xd0,
+  0xc1, 0xb2, 0x2d, 0xa3, 0xab, 0xdf, 0xbb, 0xba, 0xfe, 0x6b, 0xf2, 0x6e,
+  0x80, 0xab, 0x52, 0x84, 0x19, 0x2e, 0xef, 0xf0, 0x43, 0x80, 0xb1, 0x12,
+  0xae, 0x02, 0x97, 0xac, 0xad, 0x2f, 0x33, 0x76, 0xef, 0x92, 0x69, 0xd6,
+  0xbe, 0x6d, 0xb7, 0xe8, 0x85, 0x02, 0x8f, 0xcf, 0x4b, 0x38, 0xb4, 0xfb,
+  0x62, 0x21, 0xcc, 0x2d, 0x35, 0x1a, 0xc2, 0x3e, 0xa2, 0x1d, 0x75, 0xeb,
+  0xef, 0x7a, 0xcd, 0xa4, 0x81, 0x1b, 0xc8, 0xb1, 0x0e, 0xd2, 0xdb, 0x22,
+  0x3c, 0x17, 0x8f, 0x39, 0xbb, 0x22, 0x6f, 0xa7, 0xc4, 0xe3, 0x26, 0xa2,
+  0x0e, 0x7d, 0xd0, 0x86, 0x4d, 0x8b, 0xf9, 0xc0, 0x91, 0x41, 0x80, 0x66,
+  0x5f, 0x69, 0xd1, 0x86, 0x98, 0xa4, 0x3a, 0x6a, 0xb6, 0x7e, 0xb2, 0x5b,
+  0xf4, 0x6f, 0x34, 0x2a, 0xe2, 0xd3, 0x47, 0x91, 0x92, 0x30, 0x5e, 0x8a,
+  0x20, 0x4b, 0x88, 0x9b, 0xc9, 0xa2, 0xe0, 0xbe, 0x75, 0x6a, 0xef, 0x20,
+  0x1a, 0x87, 0x88, 0x85, 0xa4, 0x38, 0x2a, 0x21, 0xd6, 0x59, 0x27, 0x2e,
+  0xe1, 0xc7, 0x21, 0x70, 0x53, 0x28, 0x12, 0x21, 0x51, 0x86, 0xd0, 0x50,
+  0xf1, 0x22, 0x13, 0xfd, 0xa1, 0x89, 0x0d, 0xc1, 0x88, 0xae, 0x09, 0x6a,
+  0x43, 0x13, 0x2d, 0xe2, 0x7b, 0xf2, 0x79, 0x84, 0xf8, 0xde, 0x9f, 0x5e,
+  0x1c, 0xbd, 0x10, 0x74, 0x21, 0x85, 0xe1, 0x50, 0x33, 0x81, 0x13, 0xd3,
+  0xb8, 0x87, 0x34, 0x97, 0x29, 0x91, 0x90, 0xd5, 0x53, 0x1f, 0xc4, 0xae,
+  0x3c, 0x72, 0xc4, 0xe9, 0x9a, 0xb0, 0x97, 0xb7, 0xe9, 0x05, 0xe7, 0x44,
+  0x95, 0xb1, 0x58, 0x06, 0x4c, 0x4f, 0x74, 0xfe, 0x21, 0x28, 0x03, 0x2a,
+  0xf7, 0x51, 0x0c, 0xcf, 0xf2, 0x36, 0x20, 0x21, 0x16, 0x65, 0x6c, 0x70,
+  0xd9, 0x84, 0xc5, 0x29, 0xb5, 0x72, 0x0c, 0xfb, 0x0f, 0x22, 0x42, 0xf7,
+  0x56, 0x7a, 0x58, 0xc3, 0x1e, 0xb1, 0x08, 0x7f, 0x9b, 0x44, 0x9c, 0x0b,
+  0x24, 0x76, 0x2f, 0x95, 0x18, 0x67, 0xe4, 0x05, 0xfc, 0x53, 0x2f, 0xc2,
+  0x4e, 0xe3, 0xdd, 0x27, 0xa5, 0x13, 0x73, 0x8f, 0xd4, 0x4a, 0x23, 0xab,
+  0xd2, 0x9a, 0x29, 0x02, 0x9f, 0x11, 0x86, 0xaf, 0xc1, 0x02, 0xdb, 0x6e,
+  0x11, 0xd7, 0x68, 0x5d, 0xd5, 0x35, 0x24, 0xee, 0xd0, 0xce, 0x6a, 0xc0,
+  0x12, 0xda, 0x42, 0x0f, 0x08, 0xa4, 0x5f, 0xde, 0x2c, 0x4a, 0x35, 0x89,
+  0xbe, 0xa9, 0x11, 0xdc, 0x7e, 0x05, 0x02, 0x74, 0x3e, 0x58, 0xb3, 0x39,
+  0xd7, 0x98, 0x9b, 0x8f, 0x3c, 0xd9, 0xef, 0xb1, 0x65, 0x59, 0xe5, 0x1d,
+  0x67, 0x6d, 0x41, 0x6b, 0xde, 0x18, 0x1e, 0x58, 0x27, 0x6c, 0x8e, 0xba,
+  0x5a, 0x01, 0x92, 0xfa, 0xf5, 0x42, 0x4c, 0xcb, 0x81, 0x9c, 0xd1, 0xc6,
+  0x3c, 0xc6, 0x77, 0x1a, 0xf6, 0xa5, 0x87, 0xf2, 0x42, 0x53, 0xd4, 0x58,
+  0x53, 0xe2, 0x28, 0x9e, 0xe2, 0x65, 0x9a, 0x9b, 0x59, 0x52, 0xf4, 0xdc,
+  0x05, 0xbf, 0x23, 0x2d, 0xba, 0xa9, 0xee, 0x2d, 0x49, 0x7c, 0xf0, 0x23,
+  0x2d, 0x39, 0x92, 0x83, 0xa1, 0x5d, 0x87, 0xbf, 0x6d, 0x42, 0xa5, 0xc3,
+  0xc9, 0xdf, 0xca, 0x89, 0x38, 0x61, 0xc8, 0x72, 0x8c, 0x81, 0x88, 0xcc,
+  0x91, 0x3f, 0xbf, 0x36, 0x54, 0x36, 0x5b, 0xb3, 0x5f, 0x95, 0x26, 0x24,
+  0x99, 0xd8, 0xdc, 0x75, 0x96, 0x02, 0x1e, 0xc9, 0x25, 0x20, 0xfc, 0x38,
+  0x15, 0x54, 0xd1, 0xb1, 0xc3, 0xfa, 0xc8, 0xc3, 0x2e, 0x50, 0x44, 0x3a,
+  0x25, 0x6f, 0x88, 0x19, 0x5c, 0xea, 0xb2, 0x19, 0xeb, 0xcb, 0x25, 0xac,
+  0xa7, 0xd3, 0x66, 0x2d, 0x1b, 0xdf, 0x9d, 0x5d, 0xa9, 0x5e, 0x52, 0xf3,
+  0x2e, 0x10, 0xa8, 0x91, 0x85, 0x34, 0x35, 0x94, 0x97, 0x4e, 0xef, 0x54,
+  0x5f, 0x70, 0xc2, 0x55, 0xb0, 0xe4, 0x1c, 0x5e, 0x75, 0xb0, 0x58, 0x3b,
+  0x09, 0x8a, 0x76, 0xe6, 0x75, 0x4f, 0xa3, 0x88, 0x5f, 0xd4, 0x4e, 0xf1,
+  0xdb, 0xfd, 0xb0, 0xd3, 0x59, 0x31, 0xef, 0x5a, 0x57, 0x3d, 0x6b, 0x52,
+  0xda, 0xe5, 0x8d, 0x2d, 0xcb, 0x9c, 0x4b, 0xc0, 0x56, 0xd6, 0x20, 0x32,
+  0x08, 0x54, 0x2a, 0xaa, 0xb1, 0x41, 0x1c, 0x5c, 0x7b, 0xdd, 0x1c, 0x87,
+  0x7a, 0xc4, 0x3b, 0xf9, 0x0a, 0xf3, 0xc3, 0x1d, 0x30, 0x2b, 0x2d, 0x60,
+  0x62, 0x3b, 0xf3, 0x31, 0x67, 0x8c, 0x25, 0x4f, 0x3e, 0x7f, 0xf2, 0x78,
+  0x57, 0xfb, 0xa6, 0x6a, 0x16, 0xe2, 0x6e, 0xac, 0xf9, 0x18, 0x6e, 0x9c,
+  0xc0, 0xb9, 0x43, 0xaf, 0xc9, 0xa9, 0x3d, 0x1f, 0x03, 0x05, 0x88, 0x63,
+  0x33, 0xe7, 0x7e, 0x3d, 0xe4, 0x62, 0x47, 0xe7, 0x2b, 0x66, 0xca, 0x41,
+  0xfe, 0x00, 0x7d, 0x2c, 0xe3, 0x97, 0x77, 0xc0, 0xe1, 0xd3, 0xda, 0x31,
+  0x6f, 0x57, 0x19, 0xc4, 0xa8, 0xe2, 0x50, 0xd2, 0x34, 0xf5, 0x6d, 0x17,
+  0x35, 0xaf, 0x31, 0x09, 0x2a, 0xe9, 0xe7, 0xd0, 0x54, 0x45, 0xf5, 0xb8,
+  0xa2, 0x66, 0xd0, 0xa5, 0x27, 0x17, 0xd8, 0x37, 0xc2, 0xb5, 0x5d, 0x2c,
+  0x78, 0x62, 0x18, 0xb9, 0x28, 0x71, 0xaf, 0x39, 0x43, 0xaa, 0xbd, 0x8f,
+  0x8c, 0xba, 0x48, 0x94, 0xa2, 0xef, 0x4b, 0x82, 0x94, 0x9c, 0x49, 0xb4,
+  0x92, 0x78, 0x99, 0x2d, 0xb5, 0x31, 0x0d, 0xab, 0x1e, 0xa5, 0x64, 0x37,
+  0xb0, 0x2b, 0x42, 0x5b, 0xd1, 0x4b, 0xbe, 0x70, 0x1f, 0xe6, 0x87, 0xba,
+  0x41, 0x52, 0x85, 0x27, 0x68, 0xcd, 0xac, 0xb7, 0xbe, 0x45, 0xa9, 0x4d,
+  0x51, 0x40, 0xba, 0x65, 0x2d, 0xfa, 0x77, 0x4b, 0x95, 0x61, 0x45, 0x1b,
+  0x7f, 0xb5, 0xb3, 0x11, 0x3d, 0xb3, 0x87, 0x25, 0xc5, 0x90, 0x5d, 0xf0,
+  0xa5, 0x84, 0x7d, 0x29, 0x17, 0xc9, 0x0e, 0x26, 0xbc, 0xb7, 0xb7, 0x7b,
+  0xff, 0xa4, 0xe5, 0xc9, 0xfb, 0x26, 0x79, 0xc6, 0x8e, 0x0d, 0x0f, 0xc9,
+  0x7e, 0xee, 0xcd, 0x81, 0xbe, 0x49, 0x27, 0xc6, 0x70, 0xf3, 0x9c, 0x44,
+  0xc8, 0x89, 0x33, 0xa4, 0x42, 0x50, 0x8d, 0x72, 0xe8, 0xc4, 0xd7, 0xac,
+  0x34, 0x5e, 0x60, 0x7b, 0xed, 0x62, 0xf6, 0x32, 0x92, 0x98, 0xb0, 0x10,
+  0x4a, 0x8d, 0x02, 0xb4, 0xd3, 0x2b, 0x43, 0x84, 0xa1, 0xbe, 0xe9, 0xa6,
+  0xe5, 0x2d, 0x0e, 0x26, 0x6e, 0x3e, 0x48, 0x3c, 0x37, 0x3b, 0xdf, 0x42,
+  0xf5, 0x41, 0xb0, 0x3b, 0x3e, 0x52, 0x1b, 0xa1, 0x4f, 0xdb, 0x0c, 0x4b,
+  0x6e, 0xe2, 0x3c, 0x0a, 0xc0, 0x58, 0xf9, 0x49, 0xaf, 0x15, 0x77, 0x48,
+  0x9d, 0x2d, 0xc4, 0x02, 0x1e, 0xd0, 0x70, 0xd4, 0x4f, 0x6e, 0xcd, 0x0c,
+  0x85, 0xca, 0xcd, 0xa2, 0xa5, 0x17, 0x98, 0x0e, 0x46, 0xd3, 0x0d, 0x18,
+  0x2f, 0xe6, 0x66, 0xe9, 0x9b, 0x7b, 0xa2, 0x03, 0x07, 0x64, 0xc2, 0x3f,
+  0x6d, 0x6d, 0xe6, 0x80, 0xef, 0x28, 0x10, 0x38, 0x62, 0xba, 0x3a, 0x1a,
+  0xb6, 0x85, 0xb5, 0xdf, 0x76, 0x0f, 0x37, 0xa6, 0xe0, 0xd9, 0x1c, 0x3c,
+  0xf8, 0x79, 0x25, 0x0b, 0x2f, 0x94, 0xb3, 0xea, 0x6b, 0xd3, 0x41, 0xdb,
+  0xbe, 0x86, 0x67, 0x6d, 0x5f, 0x83, 0xad, 0x63, 0x8f, 0x6b, 0x68, 0x9c,
+  0x7c, 0x59, 0x27, 0xef, 0xf5, 0xb1, 0x64, 0x67, 0x7c, 0xf6, 0xfe, 0xe8,
+  0xab, 0xd3, 0xdd, 0xfb, 0x7c, 0x94, 0x6d, 0xfe, 0x6f, 0xd7, 0x95, 0x6a,
+  0x96, 0xb0, 0x4c, 0x1f, 0xd6, 0xc9, 0x57, 0xe3, 0xf1, 0xf0, 0xd5, 0xd9,
+  0x31, 0x1a, 0xec, 0x8d, 0xcd, 0x9f, 0x3d, 0x30, 0xd0, 0x23, 0xa0, 0x90,
+  0x0f, 0xbf, 0x95, 0xda, 0xd1, 0x5a, 0x93, 0x04, 0xe1, 0x01, 0xa4, 0xc3,
+  0x14, 0xe0, 0x36, 0xde, 0x23, 0x8b, 0x04, 0x80, 0xe1, 0xbb, 0x26, 0xcf,
+  0xd9, 0xf1, 0x1e, 0x3e, 0x45, 0x9f, 0xc4, 0x82, 0x7a, 0xdc, 0x07, 0xeb,
+  0xb0, 0xb7, 0x1e, 0x69, 0x3e, 0x48, 0x31, 0x05, 0x83, 0xd6, 0x64, 0x70,
+  0x63, 0xf9, 0x91, 0x38, 0x71, 0x01, 0xbb, 0x78, 0xe9, 0x0d, 0xb9, 0xc2,
+  0xa8, 0xb6, 0x42, 0xf1, 0x1a, 0x3b, 0xae, 0x37, 0x98, 0x68, 0x8c, 0xca,
+  0x85, 0xc6, 0xe9, 0x63, 0x8d, 0xae, 0x76, 0x9d, 0x22, 0xdb, 0xc3, 0x75,
+  0x92, 0xbc, 0xd8, 0x96, 0x9e, 0xd5, 0x45, 0xb9, 0xbe, 0xbc, 0x62, 0x03,
+  0xab, 0xed, 0x87, 0x00, 0x2f, 0xd7, 0xe8, 0xab, 0x85, 0x8d, 0x37, 0x93,
+  0x0c, 0x48, 0x10, 0xef, 0xa8, 0xde, 0x53, 0x65, 0x14, 0x1c, 0x62, 0xf5,
+  0x86, 0x93, 0x2e, 0x66, 0xbf, 0x09, 0xfc, 0xf2, 0x06, 0x0d, 0x64, 0xc2,
+  0x81, 0x53, 0xb8, 0xd1, 0x8a, 0x66, 0xb1, 0x94, 0xbf, 0xa6, 0xc5, 0x1d,
+  0xdc, 0xa5, 0xe2, 0xbf, 0x47, 0xfd, 0xa7, 0xa5, 0xe9, 0x36, 0xa1, 0x37,
+  0xd5, 0x14, 0x86, 0x3e, 0xa7, 0xa0, 0x72, 0xe1, 0xe7, 0x26, 0x9a, 0x45,
+  0x3b, 0xed, 0xa5, 0x11, 0xd3, 0x30, 0xed, 0x86, 0xc5, 0x40, 0x47, 0x19,
+  0x18, 0x73, 0x58, 0xc2, 0x64, 0xa2, 0x08, 0x0b, 0x11, 0x44, 0x58, 0x11,
+  0xba, 0xcf, 0xed, 0xa4, 0x93, 0xba, 0x5c, 0xac, 0x1b, 0xe8, 0x02, 0xe4,
+  0x14, 0xa5, 0xe2, 0x9a, 0x5d, 0x90, 0xae, 0x84, 0x2f, 0xcd, 0xa8, 0x89,
+  0x97, 0x80, 0x9a, 0xc4, 0xea, 0x00, 0x5c, 0x67, 0xc4, 0x91, 0x0b, 0x01,
+  0x70, 0x14, 0x51, 0xfc, 0x13, 0xb4, 0xb3, 0x3c, 0x16, 0x86, 0x5a, 0x21,
+  0x2d, 0xe9, 0xba, 0x8c, 0xf7, 0xec, 0x36, 0xe7, 0xa7, 0x67, 0xd5, 0xda,
+  0x1d, 0xf5, 0xae, 0x13, 0xeb, 0x6e, 0x25, 0xaa, 0x3b, 0xad, 0x31, 0xc6,
+  0xd9, 0x7a, 0x33, 0x95, 0x35, 0x5b, 0x60, 0x42, 0xb7, 0x64, 0x72, 0x67,
+  0x3f, 0xc6, 0xdf, 0x49, 0x91, 0xcb, 0x63, 0x15, 0xe1, 0x87, 0x82, 0xb1,
+  0xb8, 0xc3, 0x18, 0x6d, 0x4a, 0x46, 0x69, 0x7f, 0xa9, 0x33, 0xf4, 0xb7,
+  0x19, 0xe7, 0x9d, 0xf1, 0x11, 0xe3, 0x34, 0x5a, 0x87, 0xcc, 0x5a, 0x7e,
+  0xb7, 0x9f, 0x16, 0x6d, 0xc4, 0x08, 0x4f, 0x04, 0x04, 0x4c, 0xa1, 0x74,
+  0xbb, 0x2a, 0x55, 0x8f, 0xc8, 0xdf, 0x96, 0x72, 0x27, 0x3f, 0x7e, 0xd9,
+  0xfb, 0x86, 0x2d, 0x05, 0x2a, 0x37, 0x37, 0xdb, 0x74, 0xa7, 0x33, 0x7a,
+  0xc0, 0x86, 0xb8, 0xf5, 0xbb, 0x1f, 0x06, 0x96, 0x9d, 0x8d, 0x17, 0xd7,
+  0x40, 0xc3, 0xb3, 0x8b, 0x32, 0x9c, 0xff, 0xa3, 0xfc, 0x85, 0xee, 0xc0,
+  0x77, 0x79, 0x61, 0x34, 0xc3, 0x7a, 0x57, 0x89, 0x33, 0x2f, 0x62, 0x30,
+  0x0a, 0xc4, 0x3b, 0xb6, 0x6b, 0x63, 0x89, 0x19, 0x8e, 0xe3, 0x12, 0xf5,
+  0x48, 0x71, 0xe6, 0x80, 0x4d, 0xc0, 0x8a, 0xbc, 0x9e, 0x8a, 0x77, 0xab,
+  0xa0, 0x7e, 0x66, 0x6a, 0x99, 0x0e, 0xc6, 0x00, 0x6e, 0xaa, 0x31, 0x0b,
+  0x8a, 0xfc, 0x76, 0x64, 0x83, 0xfb, 0x16, 0xf8, 0xc9, 0x0f, 0x6e, 0x1a,
+  0x46, 0x18, 0x69, 0xa7, 0x0d, 0xce, 0xd6, 0x0d, 0x61, 0xd1, 0xee, 0x62,
+  0x9d, 0x3b, 0x4f, 0x76, 0x93, 0x79, 0xb3, 0xda, 0x39, 0xd8, 0x65, 0xf8,
+  0x6c, 0x69, 0xe3, 0x5c, 0x3a, 0x71, 0x1f, 0x7a, 0x71, 0x28, 0xb7, 0x30,
+  0x79, 0x6d, 0x3f, 0x8b, 0xe0, 0x26, 0x21, 0x49, 0xa1, 0x8a, 0x6f, 0x2e,
+  0x37, 0x98, 0x37, 0xcc, 0xf6, 0x7e, 0x45, 0x1a, 0x73, 0x64, 0xef, 0xb8,
+  0x16, 0x7f, 0x45, 0xa0, 0x92, 0xa8, 0x6c, 0x34, 0x16, 0x84, 0x6b, 0xc0,
+  0x29, 0x6d, 0x88, 0xa4, 0xf4, 0xd9, 0xec, 0xdc, 0x62, 0x36, 0x24, 0x1e,
+  0x72, 0x59, 0x95, 0x46, 0x44, 0x56, 0x11, 0xe8, 0x3d, 0xb1, 0x29, 0x2e,
+  0x50, 0x7d, 0x73, 0x9d, 0x57, 0x65, 0x01, 0x74, 0xc3, 0xeb, 0xb4, 0xca,
+  0x11, 0xe6, 0xdf, 0xfa, 0xfa, 0xf4, 0xdd, 0xd1, 0x96, 0xef, 0x14, 0x99,
+  0xe7, 0xe2, 0x47, 0xc7, 0xf9, 0x75, 0xbd, 0xd4, 0x7a, 0x9a, 0x31, 0xa7,
+  0xa1, 0x11, 0xe9, 0x53, 0x56, 0xfb, 0x00, 0xc4, 0x00, 0x94, 0xaa, 0xcc,
+  0x46, 0xc8, 0x8d, 0x2a, 0x29, 0x49, 0x00, 0xd2, 0xd2, 0x4d, 0x29, 0x0c,
+  0x49, 0x40, 0xb1, 0xc6, 0x1b, 0x6a, 0x1a, 0xa2, 0xf9, 0x46, 0xe9, 0x37,
+  0x15, 0x4b, 0xbc, 0xc6, 0x63, 0xa4, 0xe6, 0x6b, 0x47, 0x06, 0xe7, 0x62,
+  0xef, 0x8a, 0xc7, 0xe5, 0x1d, 0x59, 0x36, 0xdb, 0x6d, 0x01, 0xb8, 0x5d,
+  0x93, 0x31, 0xde, 0x6c, 0xeb, 0xf6, 0x22, 0x5d, 0xd4, 0xf1, 0xf8, 0xb0,
+  0xd9, 0x6b, 0xcf, 0xd7, 0x99, 0xaa, 0xf9, 0x13, 0x6e, 0x74, 0x1e, 0xdc,
+  0xdd, 0xbe, 0x17, 0x7c, 0xfb, 0x6e, 0xbb, 0xd6, 0x5d, 0x88, 0x7f, 0x93,
+  0xba, 0x02, 0xb1, 0x76, 0x9f, 0xd8, 0x76, 0x94, 0x9e, 0xe0, 0xed, 0x43,
+  0xaf, 0xa2, 0xf9, 0x7c, 0x39, 0x65, 0x24, 0x22, 0x1b, 0x57, 0xed, 0x60,
+  0xcd, 0xaa, 0x96, 0x54, 0x78, 0x1d, 0x23, 0x31, 0x5a, 0x2f, 0xd6, 0xa1,
+  0x11, 0xdc, 0x48, 0xa3, 0x52, 0xc8, 0xb7, 0xdc, 0xe8, 0x06, 0x37, 0x85,
+  0x8b, 0x22, 0xcb, 0x97, 0x06, 0x7e, 0x35, 0x75, 0x1f, 0xfa, 0xa9, 0x4b,
+  0x46, 0xb1, 0x7a, 0x09, 0xc3, 0x7f, 0x32, 0x80, 0xa4, 0x05, 0x8c, 0x52,
+  0x10, 0xcd, 0x50, 0x3f, 0xb6, 0x3b, 0xa9, 0x8e, 0x6d, 0x54, 0x2c, 0x99,
+  0xbf, 0xb1, 0x39, 0x63, 0x23, 0xfe, 0x8c, 0xd2, 0x01, 0x85, 0x83, 0x3a,
+  0x1f, 0xa4, 0xc8, 0xb2, 0xc9, 0xa2, 0x30, 0x4f, 0xee, 0x3e, 0x9a, 0xa5,
+  0x09, 0x86, 0x7b, 0xbd, 0xae, 0xae, 0x51, 0xf5, 0x2a, 0xad, 0x7f, 0x38,
+  0x35, 0xd8, 0x9d, 0x87, 0x9c, 0x43, 0x44, 0xca, 0x7b, 0x33, 0xa4, 0xb4,
+  0xcd, 0x6a, 0x2d, 0x38, 0xdf, 0x5f, 0xf1, 0x2c, 0xec, 0x04, 0xad, 0xa5,
+  0x43, 0x00, 0x28, 0xac, 0xc5, 0x06, 0x49, 0xfa, 0x65, 0x0d, 0xc8, 0xce,
+  0xa6, 0x4a, 0xa7, 0xee, 0x2f, 0xc3, 0xb4, 0x9e, 0xe6, 0xb9, 0xb6, 0x92,
+  0xa1, 0xf8, 0x60, 0x46, 0xe9, 0xb0, 0x51, 0x7c, 0x1c, 0x77, 0x1e, 0xb6,
+  0x89, 0xc3, 0xac, 0x64, 0xf7, 0x2e, 0xe7, 0x9c, 0xa4, 0xdc, 0x65, 0x8c,
+  0x32, 0x58, 0x50, 0x1a, 0x27, 0xc1, 0xc3, 0x58, 0x77, 0x1d, 0xad, 0xb4,
+  0xe9, 0x31, 0x6d, 0x8d, 0xf5, 0x7d, 0xe0, 0x9b, 0xdf, 0xba, 0x09, 0x43,
+  0xc2, 0x1a, 0xaf, 0x1b, 0x36, 0x25, 0x6f, 0x6e, 0x0e, 0xfd, 0x67, 0x36,
+  0x45, 0xc3, 0x9f, 0x76, 0x8c, 0x13, 0x46, 0x7b, 0x8a, 0x99, 0x26, 0xe3,
+  0xdd, 0x56, 0xaf, 0xbd, 0x57, 0x27, 0x67, 0xef, 0x81, 0xb0, 0x45, 0xa0,
+  0xcd, 0x45, 0xcd, 0x59, 0x0a, 0xf4, 0x33, 0x4a, 0x60, 0x87, 0x50, 0x20,
+  0xa8, 0x44, 0xc2, 0x4b, 0x0e, 0xcb, 0xab, 0x81, 0x4b, 0x0f, 0xf3, 0x21,
+  0x66, 0x5f, 0x71, 0x7a, 0x5b, 0x91, 0x78, 0x05, 0x8e, 0xcc, 0xe0, 0xd5,
+  0xbe, 0xe8, 0x2e, 0xc7, 0x7c, 0xd5, 0x7d, 0x5b, 0x01, 0xde, 0x6d, 0x21,
+  0x52, 0xfb, 0x5d, 0x0b, 0x32, 0x56, 0x2a, 0xa2, 0x58, 0xc0, 0xcf, 0x9b,
+  0xcc, 0x42, 0x99, 0x89, 0x5d, 0x67, 0x61, 0x18, 0xb5, 0x79, 0x0e, 0x27,
+  0x69, 0x00, 0xb8, 0x42, 0xeb, 0xe3, 0xeb, 0xcd, 0x88, 0x06, 0x66, 0x63,
+  0x8b, 0x55, 0xd1, 0x06, 0xf3, 0xb2, 0xdb, 0x1d, 0x35, 0x42, 0xbb, 0xf3,
+  0xda, 0x5c, 0x17, 0xa6, 0x53, 0xa5, 0x9e, 0x3d, 0x1b, 0x0e, 0xf8, 0xfd,
+  0x80, 0xbf, 0x3a, 0x59, 0x13, 0x87, 0xe8, 0x7c, 0x41, 0x8e, 0x97, 0x95,
+  0x26, 0x7e, 0x82, 0xbe, 0x27, 0xee, 0x2f, 0x46, 0x52, 0xa2, 0x1a, 0xce,
+  0x2c, 0x5d, 0x1a, 0xb5, 0xa0, 0xd0, 0x42, 0x01, 0xf2, 0xfc, 0x52, 0x3e,
+  0x67, 0x77, 0xc2, 0xeb, 0x54, 0x38, 0x96, 0x22, 0x69, 0x83, 0x0b, 0x74,
+  0xea, 0x07, 0xf8, 0x33, 0xc4, 0x49, 0xfd, 0xe1, 0x63, 0x35, 0x61, 0x78,
+  0xdd, 0xe2, 0x1e, 0x48, 0xdc, 0x46, 0xbb, 0x0e, 0x32, 0x66, 0x31, 0x0f,
+  0x61, 0x1b, 0x0f, 0x53, 0xd3, 0x9c, 0xab, 0x75, 0xf1, 0xc9, 0x4c, 0x21,
+  0x2c, 0x87, 0xd6, 0x64, 0x5f, 0xc2, 0xdd, 0xe7, 0x6e, 0x9d, 0xf4, 0x17,
+  0x6e, 0xfd, 0x6a, 0x47, 0x20, 0xb8, 0xe4, 0x6b, 0x72, 0xe4, 0x85, 0x1d,
+  0xdf, 0x63, 0xb3, 0x9b, 0xd9, 0xfb, 0x91, 0x36, 0x6e, 0x03, 0xa3, 0xe9,
+  0xec, 0x7a, 0xd2, 0xae, 0xcf, 0xb5, 0xa1, 0x46, 0x4f, 0xa4, 0x48, 0x14,
+  0x5b, 0x01, 0xa4, 0x50, 0x91, 0xa4, 0xa9, 0x5e, 0x01, 0x3b, 0x5c, 0x83,
+  0xec, 0xc9, 0x64, 0xc3, 0x37, 0x81, 0xdd, 0xe2, 0x35, 0xbe, 0x89, 0xcc,
+  0xa4, 0x5d, 0x9b, 0xdf, 0x47, 0x07, 0xac, 0xa4, 0xc0, 0x91, 0x65, 0x88,
+  0xc0, 0x95, 0xf2, 0x4b, 0x26, 0x8a, 0xd5, 0xd9, 0xa8, 0x25, 0xa5, 0xdf,
+  0x13, 0x2f, 0xc2, 0xb7, 0x5c, 0x29, 0x57, 0x56, 0x58, 0x22, 0x5b, 0xd2,
+  0x45, 0x95, 0xd0, 0xce, 0x6f, 0xb8, 0x4b, 0x6e, 0x21, 0xde, 0x46, 0xd9,
+  0x1f, 0x76, 0x36, 0xa9, 0x78, 0x10, 0x37, 0x7c, 0x1f, 0x32, 0xc3, 0xf7,
+  0x6d, 0x5e, 0xe8, 0x56, 0x1a, 0xd4, 0x51, 0x47, 0x6e, 0xf4, 0xbd, 0x3c,
+  0x90, 0x86, 0xa7, 0x04, 0xfb, 0xb3, 0xf7, 0x61, 0x95, 0xb7, 0xb8, 0xff,
+  0x26, 0xa8, 0xcf, 0xbe, 0x8f, 0x0b, 0x5a, 0xd3, 0x5d, 0x7e, 0xd6, 0xe3,
+  0xda, 0xfa, 0xf9, 0x2c, 0xb0, 0x8d, 0x23, 0x18, 0xe1, 0x80, 0x45, 0xc0,
+  0x00, 0x85, 0xee, 0x7e, 0x1d, 0x16, 0x48, 0x9f, 0x94, 0x09, 0xe7, 0xb3,
+  0x28, 0x82, 0x83, 0x3d, 0x59, 0x69, 0x48, 0x29, 0x01, 0x0b, 0x3a, 0x0b,
+  0xc5, 0x8e, 0x39, 0x7e, 0x63, 0x48, 0x8c, 0x54, 0x55, 0x6a, 0x4f, 0xfc,
+  0xe7, 0xbe, 0xa3, 0x45, 0xc7, 0x7b, 0x0d, 0xe9, 0xc2, 0xbc, 0x9f, 0x91,
+  0x31, 0xef, 0xc1, 0x7a, 0x11, 0xce, 0xdf, 0xc8, 0x23, 0x75, 0x0e, 0xb7,
+  0x6b, 0xf3, 0x8b, 0x9e, 0x16, 0x03, 0x19, 0xd0, 0xca, 0x00, 0x68, 0x7b,
+  0xb5, 0x26, 0x00, 0x40, 0x12, 0x77, 0xdc, 0xb0, 0x46, 0x7a, 0x2a, 0x55,
+  0x19, 0xcd, 0xb9, 0x3d, 0xe1, 0x00, 0xa8, 0x8e, 0x9d, 0xd8, 0x75, 0x66,
+  0xae, 0x21, 0xd7, 0x09, 0x4d, 0xaa, 0xf2, 0x53, 0xc6, 0x34, 0x07, 0xc3,
+  0x02, 0xc8, 0x4b, 0xac, 0x47, 0x89, 0x2f, 0xd6, 0x70, 0x39, 0xc6, 0xa3,
+  0xa7, 0x7c, 0x85, 0x20, 0xe8, 0xca, 0xcd, 0xf1, 0x04, 0xb2, 0xc1, 0xf1,
+  0xc2, 0x1c, 0xaf, 0x03, 0x2c, 0x41, 0x21, 0xe4, 0xf9, 0xb8, 0xa6, 0x04,
+  0xf4, 0x16, 0xbf, 0xf7, 0x96, 0x0e, 0x88, 0x9c, 0x37, 0x5c, 0x7d, 0xff,
+  0xe6, 0x8b, 0x83, 0xa6, 0xff, 0xde, 0xdb, 0x53, 0xf7, 0xef, 0x7d, 0xe4,
+  0x44, 0x1f, 0xde, 0xf3, 0xce, 0xd0, 0x12, 0x1c, 0x60, 0xc9, 0x4b, 0x43,
+  0x54, 0xec, 0x0a, 0xa3, 0x50, 0x56, 0xd7, 0xcb, 0x85, 0xde, 0x8d, 0x43,
+  0xb5, 0x38, 0x66, 0x9c, 0xc6, 0x03, 0x6b, 0x8d, 0xb4, 0x70, 0xae, 0x6a,
+  0x98, 0xb9, 0x5e, 0xaa, 0x82, 0xdd, 0x3e, 0x60, 0x15, 0xc9, 0x50, 0x4c,
+  0xe4, 0x8a, 0x3b, 0xff, 0x0d, 0xd7, 0xc0, 0x42, 0x07, 0xa7, 0xe3, 0x01,
+  0x68, 0x4f, 0x5e, 0x3b, 0x25, 0xf3, 0xdf, 0x29, 0x0d, 0xd8, 0x68, 0xb4,
+  0x0d, 0xe5, 0x81, 0xe1, 0x5b, 0x81, 0xca, 0xc9, 0x7d, 0xcc, 0x6c, 0x9d,
+  0x08, 0x17, 0x79, 0x5b, 0x4c, 0x1a, 0x42, 0x3e, 0xf6, 0x35, 0x03, 0x06,
+  0x96, 0x4f, 0x8e, 0xc8, 0x5a, 0x89, 0x18, 0x82, 0xec, 0xb0, 0xc8, 0x6d,
+  0x95, 0x5d, 0x2e, 0xb8, 0xd4, 0x9c, 0xb4, 0x25, 0x86, 0x75, 0xaa, 0xd9,
+  0x58, 0xbc, 0x78, 0x1f, 0x2b, 0x2f, 0x82, 0xb5, 0xce, 0x09, 0x4f, 0x62,
+  0x9d, 0xe9, 0x0f, 0x6c, 0x03, 0xb3, 0x56, 0xb6, 0x0c, 0x1b, 0x28, 0x62,
+  0xb1, 0x46, 0xba, 0x90, 0x61, 0x2a, 0x89, 0xf7, 0x98, 0xff, 0xca, 0x8b,
+  0xcf, 0xf7, 0x07, 0x62, 0xd3, 0x50, 0x94, 0xcb, 0x7f, 0x86, 0x5c, 0x53,
+  0x11, 0x2d, 0x82, 0x1e, 0x33, 0x3f, 0xb5, 0x4f, 0x86, 0x1c, 0x50, 0x50,
+  0x33, 0x9f, 0x3c, 0xa2, 0x50, 0x77, 0xdc, 0x95, 0xc4, 0xec, 0xce, 0x77,
+  0x1e, 0x58, 0xef, 0x41, 0x1d, 0xc5, 0xdf, 0x9d, 0x79, 0x92, 0x47, 0x4e,
+  0xe3, 0x58, 0xc2, 0xa4, 0xdb, 0xe8, 0x75, 0x16, 0x75, 0x44, 0xcc, 0xf2,
+  0x3a, 0xe2, 0xbb, 0xe0, 0x04, 0x36, 0x21, 0x38, 0xdb, 0x82, 0x0e, 0x0d,
+  0x78, 0x98, 0xb4, 0x71, 0x8a, 0xe6, 0xc2, 0x6c, 0xa1, 0x7f, 0x86, 0xce,
+  0xda, 0xec, 0xfe, 0xc6, 0x7b, 0xf2, 0x7c, 0xf4, 0xb8, 0x75, 0x4f, 0x9a,
+  0xc5, 0x72, 0x78, 0x33, 0xb9, 0x27, 0xe4, 0x71, 0x71, 0xf2, 0x0e, 0x29,
+  0x1f, 0xca, 0x6e, 0xd0, 0x04, 0x42, 0xbd, 0xcf, 0xe4, 0xd7, 0x61, 0x17,
+  0x21, 0x61, 0xfa, 0x62, 0x22, 0x0f, 0xc9, 0xac, 0xb5, 0x35, 0xa3, 0x62,
+  0xee, 0x2b, 0xe4, 0x9d, 0x19, 0x92, 0xdd, 0xd8, 0xab, 0xd5, 0x22, 0x8f,
+  0x16, 0xf6, 0x68, 0x66, 0x6d, 0x76, 0x9b, 0x4d, 0xd7, 0x08, 0x4f, 0x93,
+  0x72, 0x48, 0x18, 0x52, 0x9b, 0xfd, 0xe6, 0x9e, 0xaf, 0x5c, 0xbc, 0xe3,
+  0xe6, 0x07, 0xdd, 0xcd, 0xe8, 0xae, 0x9d, 0x17, 0x1f, 0x38, 0xcd, 0xb8,
+  0xbe, 0x3d, 0xf6, 0xbb, 0x20, 0x44, 0x8c, 0x7c, 0x7e, 0x12, 0x88, 0x86,
+  0xa4, 0xf2, 0xcb, 0x82, 0x55, 0x8e, 0x77, 0xf9, 0xb4, 0x2a, 0xeb, 0x72,
+  0xce, 0x99, 0x6a, 0x9e, 0x79, 0x74, 0x7c, 0x3c, 0x4e, 0x6e, 0xb2, 0x89,
+  0x96, 0xc4, 0x8e, 0x42, 0x1f, 0x32, 0x78, 0x08, 0x05, 0x46, 0xaa, 0x3c,
+  0x6b, 0x68, 0xcb, 0x34, 0x14, 0x4a, 0x10, 0x51, 0x68, 0x89, 0x25, 0x00,
+  0x2a, 0x50, 0xdf, 0xa9, 0xab, 0xe0, 0x82, 0x05, 0xd3, 0x2a, 0x2b, 0x23,
+  0xf1, 0x70, 0x9e, 0x80, 0x8a, 0x15, 0xa6, 0x13, 0xc8, 0xf0, 0x49, 0x2a,
+  0x0d, 0x9b, 0xd8, 0x33, 0x60, 0xd8, 0x0e, 0x69, 0x28, 0xe2, 0x51, 0xf9,
+  0x44, 0xae, 0xb2, 0xa0, 0x56, 0x65, 0x92, 0x51, 0x8b, 0x43, 0x8a, 0xf2,
+  0xb7, 0x9d, 0x76, 0xc5, 0xac, 0xac, 0x90, 0x81, 0xe4, 0xb5, 0x52, 0x41,
+  0xd3, 0xc1, 0x75, 0x85, 0xa2, 0x2b, 0xc0, 0x97, 0x86, 0xfc, 0xf4, 0xe6,
+  0x8a, 0xc3, 0xb5, 0x7a, 0x0a, 0x24, 0x9c, 0x50, 0x65, 0xcb, 0xa5, 0x3d,
+  0x02, 0xd8, 0x4f, 0xf3, 0x77, 0xe2, 0xc6, 0x3b, 0x8d, 0x28, 0xd4, 0xa1,
+  0x9c, 0x87, 0x2b, 0x29, 0x95, 0x1c, 0x85, 0x37, 0xf9, 0x65, 0x4f, 0x67,
+  0x4d, 0x0b, 0xee, 0x00, 0xe1, 0x84, 0x1b, 0x8b, 0xd9, 0x88, 0xc8, 0xac,
+  0xf8, 0x8e, 0x26, 0x41, 0xbb, 0x58, 0x54, 0x3d, 0x85, 0x0e, 0xd8, 0x1e,
+  0xea, 0xeb, 0xc3, 0xc4, 0xf0, 0xf4, 0xc6, 0x4e, 0x3c, 0x09, 0x92, 0xa5,
+  0xb1, 0xfd, 0xfe, 0x48, 0x81, 0xf9, 0x89, 0xa1, 0xa4, 0xf6, 0x54, 0xec,
+  0x0d, 0xf0, 0x50, 0xc7, 0x5b, 0x5a, 0x9f, 0x6a, 0x79, 0x01, 0x00, 0x85,
+  0xe7, 0x2a, 0x88, 0x2b, 0x7d, 0x7d, 0x50, 0xd2, 0x88, 0x64, 0x45, 0xf2,
+  0x51, 0xbc, 0x60, 0xac, 0xed, 0x28, 0x4f, 0xc7, 0xd3, 0x8e, 0x74, 0xf9,
+  0x57, 0xb7, 0xa4, 0x1f, 0x1c, 0x0e, 0x27, 0x59, 0x4a, 0xcd, 0x5d, 0x5e,
+  0x36, 0xa4, 0x30, 0xc5, 0x2b, 0x53, 0x7a, 0x0a, 0x53, 0xfe, 0xcc, 0x6f,
+  0x5e, 0x40, 0xd3, 0xa2, 0xa3, 0x3d, 0x7d, 0xf5, 0xe1, 0xe2, 0xeb, 0x24,
+  0x39, 0x24, 0x60, 0xf9, 0x87, 0x54, 0xa6, 0x80, 0x23, 0xb4, 0x46, 0xd1,
+  0x5b, 0x8d, 0x1e, 0xb1, 0xc5, 0xdf, 0xd6, 0x45, 0xbb, 0x77, 0x44, 0xcc,
+  0x37, 0x0f, 0xf9, 0x29, 0xa2, 0x97, 0xcb, 0xa4, 0x5b, 0x99, 0xd5, 0xda,
+  0x59, 0x88, 0x4f, 0x64, 0x38, 0xe4, 0xea, 0x39, 0x73, 0xb5, 0xef, 0x09,
+  0x63, 0xd6, 0x71, 0x78, 0x0e, 0x99, 0xad, 0x4c, 0x57, 0xf1, 0x83, 0x34,
+  0x5e, 0x8a, 0x56, 0x2e, 0xe4, 0xe0, 0x6f, 0xba, 0x9d, 0x41, 0xcf, 0xdf,
+  0xbe, 0xee, 0x0c, 0xf7, 0xf4, 0xd9, 0x93, 0xfd, 0x5f, 0x31, 0x49, 0xaf,
+  0x24, 0xef, 0x88, 0x78, 0x11, 0xa2, 0xa8, 0x39, 0xdf, 0x55, 0x54, 0xb6,
+  0xaa, 0x7e, 0x86, 0x52, 0x1e, 0xf2, 0xcb, 0xea, 0xeb, 0x66, 0x46, 0xd9,
+  0x5a, 0x16, 0x75, 0xa3, 0x52, 0x75, 0xff, 0xbf, 0xfe, 0x19, 0x96, 0xd5,
+  0xfe, 0xf5, 0x47, 0xf6, 0x13, 0xcf, 0xd1, 0x4f, 0xcf, 0x25, 0xfa, 0x2b,
+  0x9b, 0xa9, 0x9d, 0x44, 0xa6, 0x1b, 0xbd, 0xfd, 0xbb, 0x6d, 0xdb, 0xf5,
+  0x06, 0x3a, 0x7f, 0xb4, 0x28, 0x5b, 0x85, 0xa7, 0xcc, 0x4d, 0x0f, 0x16,
+  0xa0, 0xe4, 0xa9, 0xa7, 0x0e, 0x28, 0x34, 0x95, 0x6d, 0x0a, 0x36, 0xeb,
+  0xeb, 0x59, 0xa5, 0xcd, 0x5b, 0x04, 0xbe, 0x4b, 0xdd, 0xe4, 0xe4, 0xce,
+  0xe6, 0xdc, 0x2a, 0xcc, 0x9f, 0x54, 0x51, 0x94, 0x2f, 0xe7, 0x45, 0x8f,
+  0xef, 0x52, 0x12, 0x88, 0xfe, 0xcb, 0x9c, 0xc0, 0xa0, 0xb9, 0x29, 0xff,
+  0xd9, 0xf6, 0x63, 0x1a, 0x0d, 0x83, 0x66, 0xfc, 0xf1, 0x77, 0x07, 0x54,
+  0x11, 0xb4, 0xd5, 0x1d, 0xc2, 0x7c, 0x74, 0x8d, 0xd2, 0x23, 0x3e, 0x55,
+  0xab, 0x20, 0x6d, 0x02, 0xe7, 0xd5, 0x0f, 0x52, 0xb1, 0xf1, 0x80, 0xf4,
+  0xc6, 0x7f, 0x8e, 0xe8, 0xbf, 0x7f, 0x3d, 0x18, 0x3e, 0xf9, 0xd1, 0x7e,
+  0xf4, 0x77, 0x07, 0x1f, 0x7f, 0x77, 0xb8, 0x15, 0x2d, 0xab, 0x73, 0xb5,
+  0xff, 0x5e, 0x86, 0x22, 0xa9, 0xb3, 0xc5, 0x9d, 0x94, 0x69, 0x48, 0x84,
+  0xd1, 0xb5, 0xd9, 0x43, 0xd3, 0xde, 0x10, 0x1f, 0x89, 0xfc, 0x56, 0x1d,
+  0x4d, 0x55, 0xfb, 0xec, 0x29, 0x73, 0xb8, 0x29, 0xf9, 0x65, 0xf1, 0xa9,
+  0x70, 0xfd, 0x9f, 0xd6, 0x0f, 0x04, 0xbc, 0x90, 0xa0, 0x98, 0x7c, 0xda,
+  0x20, 0xb4, 0x14, 0x85, 0xd8, 0x08, 0x77, 0x43, 0xd2, 0xa2, 0x8c, 0x34,
+  0x4b, 0x93, 0xce, 0xa6, 0x4f, 0x26, 0xf6, 0x27, 0x45, 0x16, 0x14, 0x62,
+  0xa5, 0x8c, 0x11, 0x95, 0x09, 0xd8, 0x5d, 0x62, 0xb9, 0x82, 0x79, 0xd3,
+  0x86, 0xad, 0x25, 0x9a, 0x85, 0xd9, 0xbb, 0x76, 0xcd, 0xd4, 0x35, 0xb8,
+  0xcb, 0x2d, 0xfe, 0xb6, 0xd6, 0x5e, 0xda, 0x4e, 0xa0, 0x98, 0x91, 0xf2,
+  0xda, 0xc5, 0x5e, 0xf0, 0x33, 0x89, 0xbb, 0xa0, 0xbe, 0x1f, 0x32, 0xae,
+  0x2e, 0x63, 0x91, 0xbc, 0x74, 0x42, 0x4d, 0xf0, 0x5a, 0x3d, 0x85, 0x6c,
+  0x83, 0x98, 0x89, 0x43, 0x9b, 0x4a, 0xeb, 0x9e, 0x0d, 0xf1, 0xb7, 0xc2,
+  0xdb, 0x04, 0xd9, 0x28, 0x6c, 0xce, 0x06, 0xa7, 0x2e, 0x17, 0xc5, 0x52,
+  0xf6, 0x68, 0x93, 0x0d, 0xbd, 0xaa, 0x58, 0x54, 0xe1, 0xe2, 0xa7, 0x5e,
+  0x86, 0x9b, 0x84, 0xf5, 0x86, 0x41, 0x2c, 0xd2, 0x10, 0xd1, 0xec, 0xce,
+  0x70, 0x42, 0x06, 0x76, 0xb5, 0x38, 0x91, 0xea, 0x21, 0x10, 0x5e, 0x63,
+  0xe8, 0x6c, 0x7b, 0xb8, 0x9d, 0xec, 0xa0, 0x72, 0x1e, 0x66, 0x5d, 0x32,
+  0x4b, 0xeb, 0xab, 0xdd, 0x98, 0x17, 0xd2, 0x39, 0xfe, 0x1c, 0xa3, 0x9a,
+  0x88, 0xeb, 0x81, 0x24, 0x26, 0x73, 0xa8, 0x4d, 0xde, 0xea, 0x53, 0x06,
+  0xd5, 0xa0, 0x24, 0xc1, 0xa1, 0x8d, 0x24, 0xb7, 0x7e, 0x32, 0x24, 0x63,
+  0x11, 0x3f, 0xfd, 0x4f, 0x7e, 0x36, 0x88, 0x63, 0xd0, 0x93, 0x9c, 0xe5,
+  0x35, 0xe4, 0x02, 0x28, 0x27, 0x44, 0x29, 0x7e, 0x97, 0xbc, 0x5c, 0x5d,
+  0x55, 0x46, 0xf3, 0x0b, 0xeb, 0xac, 0xc6, 0x5f, 0x27, 0x8c, 0xa3, 0x69,
+  0x9e, 0xe2, 0x67, 0x2c, 0x71, 0x78, 0x50, 0x83, 0xbf, 0x22, 0x3e, 0x1e,
+  0x25, 0x90, 0x0c, 0xd3, 0x7a, 0x18, 0x68, 0x39, 0x17, 0x7e, 0x36, 0x2d,
+  0xe9, 0x9c, 0x64, 0x88, 0x50, 0xe2, 0x22, 0xc5, 0xd3, 0x8a, 0x29, 0x5a,
+  0x81, 0x27, 0x7b, 0xa3, 0xd1, 0x1e, 0x31, 0xab, 0x3d, 0xf3, 0x87, 0x06,
+  0xef, 0x05, 0xa1, 0xaa, 0xdb, 0x30, 0x8b, 0xc2, 0x81, 0xf4, 0x31, 0x00,
+  0x65, 0x48, 0x7b, 0x49, 0xaf, 0x05, 0xd1, 0xdf, 0xd7, 0x48, 0x3e, 0xad,
+  0x8c, 0x2e, 0x59, 0x71, 0x15, 0xef, 0xb2, 0x25, 0x1f, 0x83, 0x36, 0x55,
+  0xec, 0x52, 0xaf, 0x05, 0x2f, 0xa2, 0xd3, 0x7a, 0x8d, 0x4c, 0x3a, 0x78,
+  0x5e, 0x68, 0x11, 0x79, 0xa3, 0x28, 0x5d, 0xa8, 0x9f, 0x4e, 0x37, 0xda,
+  0x72, 0x8f, 0x0f, 0xdb, 0x3e, 0x8f, 0x55, 0x5e, 0x18, 0xeb, 0xc2, 0x68,
+  0xc5, 0x00, 0xf7, 0xa4, 0xec, 0xbb, 0xb0, 0x7e, 0x87, 0x1d, 0x69, 0xed,
+  0xb8, 0x2b, 0x3b, 0x92, 0x99, 0xb7, 0x59, 0x6d, 0x43, 0xb5, 0x6b, 0x46,
+  0x37, 0xe5, 0x08, 0xfe, 0x4e, 0x20, 0x28, 0xf9, 0x23, 0xbb, 0x2c, 0x2d,
+  0x25, 0x3f, 0x17, 0x04, 0x91, 0xd9, 0x66, 0x1b, 0xa2, 0xc7, 0xa4, 0x9c,
+  0xff, 0x03, 0xc5, 0x1d, 0xa3, 0xc5, 0x3c, 0x1e, 0xd6, 0xdd, 0x60, 0x9d,
+  0x24, 0xae, 0x29, 0x17, 0xad, 0x99, 0xf0, 0x51, 0xcd, 0xbe, 0xbf, 0x39,
+  0x3a, 0x17, 0xd5, 0x04, 0xce, 0x07, 0xd7, 0x4f, 0x35, 0x6c, 0x37, 0x4c,
+  0x46, 0xcc, 0xd3, 0xc7, 0xb6, 0xc1, 0x79, 0x7d, 0x95, 0x1e, 0x3e, 0x79,
+  0x2a, 0xd3, 0x56, 0xb4, 0x2c, 0xc8, 0xec, 0x6d, 0xfe, 0xd5, 0xde, 0x1e,
+  0x07, 0xca, 0xc9, 0x2c, 0x0d, 0x78, 0x42, 0x2a, 0x6d, 0xda, 0xb7, 0xff,
+  0xb8, 0x1d, 0x4d, 0x91, 0x53, 0xa5, 0x95, 0x4d, 0x77, 0x72, 0x3b, 0x23,
+  0x8d, 0xcf, 0x6f, 0xca, 0x30, 0xe8, 0x36, 0xe9, 0x41, 0xd9, 0x4a, 0xa0,
+  0x31, 0xf8, 0xfd, 0x0a, 0xb4, 0xab, 0x31, 0x37, 0x72, 0x6c, 0xea, 0x44,
+  0x2b, 0x51, 0x09, 0xb9, 0xd3, 0xdf, 0x9f, 0x9a, 0x7b, 0xc9, 0x4e, 0x43,
+  0x10, 0x13, 0x49, 0x77, 0xa3, 0xd3, 0xf0, 0x06, 0x96, 0xbc, 0x4f, 0x02,
+  0xbe, 0x26, 0x58, 0x3f, 0x22, 0x3c, 0x8d, 0xb7, 0xb0, 0x37, 0x06, 0x33,
+  0x35, 0x5f, 0x08, 0x32, 0x14, 0x94, 0x2e, 0x2c, 0xd0, 0x26, 0x8c, 0x79,
+  0x2f, 0x31, 0xd0, 0xdd, 0x16, 0x23, 0x0a, 0xaa, 0xa6, 0x83, 0x41, 0x13,
+  0x58, 0x8d, 0xc0, 0x75, 0x56, 0xf8, 0x14, 0x24, 0x86, 0x4d, 0xb3, 0x9c,
+  0x81, 0x97, 0xcc, 0xd9, 0x52, 0xc4, 0x27, 0xb8, 0x07, 0x86, 0x14, 0xf6,
+  0x88, 0x0e, 0xc4, 0xce, 0x08, 0x1a, 0x28, 0x90, 0x7f, 0xf9, 0xf9, 0x68,
+  0xff, 0x85, 0x42, 0xb2, 0x0e, 0x92, 0xaf, 0x8a, 0x35, 0x1d, 0x09, 0xad,
+  0xfa, 0xab, 0xf1, 0x37, 0x41, 0x71, 0x15, 0xbd, 0xf1, 0xf8, 0x11, 0xbd,
+  0xf1, 0x7e, 0xcc, 0x4f, 0xdd, 0x94, 0x8b, 0xb9, 0x79, 0x33, 0xf6, 0xdc,
+  0x33, 0x7a, 0xce, 0x50, 0xdc, 0xac, 0x59, 0xd4, 0x4a, 0x54, 0x1b, 0x66,
+  0xf2, 0xf8, 0x71, 0x64, 0x26, 0x83, 0x9f, 0xfc, 0xa1, 0x53, 0xb8, 0xe8,
+  0x88, 0xa0, 0x26, 0xe9, 0xf4, 0x13, 0x28, 0x07, 0x69, 0xe7, 0x16, 0x60,
+  0xf8, 0xd7, 0x64, 0xbe, 0x0c, 0x14, 0xf0, 0x90, 0x3e, 0x46, 0x15, 0x70,
+  0xd2, 0x1a, 0xd4, 0x9f, 0x3f, 0x3b, 0x7c, 0x74, 0xb0, 0xf7, 0x74, 0xf4,
+  0x78, 0x74, 0x68, 0xd3, 0xc0, 0x0c, 0x1d, 0x5c, 0x53, 0xd7, 0x0c, 0x8a,
+  0xba, 0x47, 0x5c, 0xd5, 0x48, 0x80, 0xc8, 0x0b, 0x33, 0x8e, 0x07, 0x8b,
+  0x20, 0xe8, 0xe6, 0x2e, 0x01, 0x84, 0x40, 0x10, 0x0e, 0xfc, 0x7a, 0xa2,
+  0x51, 0xa4, 0x41, 0x20, 0x61, 0x2b, 0xd0, 0x24, 0xc4, 0x2d, 0x61, 0x4c,
+  0x75, 0xda, 0x81, 0x49, 0x6e, 0xac, 0xdb, 0xa6, 0x5c, 0xc3, 0xfb, 0x4d,
+  0xae, 0x16, 0xc5, 0x58, 0x17, 0x75, 0x46, 0x3a, 0x51, 0x97, 0x59, 0xac,
+  0xa3, 0x9f, 0xcc, 0x9e, 0x13, 0x6e, 0x39, 0x8a, 0x6e, 0xbb, 0xb9, 0x93,
+  0xdf, 0x94, 0xd8, 0x17, 0x37, 0x38, 0x31, 0x96, 0x47, 0x31, 0xa5, 0x3e,
+  0x5b, 0xc6, 0x2a, 0xb8, 0x26, 0x17, 0x6f, 0xac, 0x3f, 0xb8, 0x14, 0x18,
+  0xaa, 0x8b, 0x5e, 0x52, 0x11, 0x1c, 0x10, 0xba, 0xfc, 0x80, 0x8b, 0x1b,
+  0xb4, 0xb0, 0x94, 0xeb, 0xa8, 0x02, 0xee, 0xa4, 0xfb, 0x10, 0xf4, 0x31,
+  0x17, 0x1c, 0x71, 0xaa, 0x30, 0x62, 0x6f, 0x34, 0x83, 0xbf, 0xd1, 0x36,
+  0xba, 0x4a, 0xb1, 0x98, 0xb3, 0x64, 0x93, 0x33, 0x2d, 0x8a, 0x16, 0xc1,
+  0xff, 0x3a, 0x19, 0x24, 0xad, 0xa6, 0x9e, 0x1b, 0x1a, 0xb1, 0x75, 0xfb,
+  0x1e, 0xca, 0xa8, 0x3f, 0x9b, 0xca, 0x1e, 0xfd, 0xf2, 0x54, 0x76, 0xf8,
+  0x50, 0x2a, 0xf3, 0xc8, 0x8c, 0x9d, 0x36, 0x1b, 0x08, 0x8d, 0x1a, 0x25,
+  0xd2, 0x3a, 0x7a, 0xa8, 0xcc, 0x23, 0x32, 0x17, 0x9e, 0x6c, 0x91, 0x58,
+  0x9b, 0xc6, 0x1c, 0x91, 0xf5, 0x51, 0x19, 0x83, 0x59, 0x28, 0x9d, 0xdd,
+  0x43, 0x68, 0xec, 0x13, 0xdb, 0x4c, 0x65, 0x17, 0x6d, 0xbe, 0xb2, 0x81,
+  0xc6, 0x7c, 0x82, 0x78, 0x30, 0x95, 0x39, 0x07, 0x15, 0xf3, 0x9d, 0xa4,
+  0x87, 0xd0, 0x7c, 0x3a, 0x53, 0xd5, 0x28, 0xa4, 0xb2, 0xe7, 0x31, 0x2a,
+  0x7b, 0xf4, 0x10, 0x2a, 0x33, 0xe7, 0xb9, 0x20, 0x59, 0xd9, 0xa2, 0xb2,
+  0xc7, 0x3f, 0x89, 0xca, 0x98, 0xcc, 0x40, 0x67, 0xbd, 0x84, 0x46, 0x4b,
+  0x6a, 0x17, 0x47, 0xbe, 0xfa, 0x57, 0xb9, 0x45, 0xda, 0x1a, 0x34, 0x28,
+  0x19, 0xfc, 0x69, 0x67, 0xd8, 0xd9, 0xea, 0x07, 0x9c, 0xd8, 0x61, 0xfb,
+  0xc4, 0x0e, 0x7e, 0xda, 0x89, 0x1d, 0x76, 0xc2, 0x79, 0x46, 0x53, 0x63,
+  0x2f, 0xeb, 0x5f, 0xd5, 0xd9, 0xfd, 0x62, 0x6f, 0xef, 0x47, 0xf8, 0x0c,
+  0x5e, 0x90, 0xec, 0xfb, 0x31, 0xe8, 0x79, 0x9b, 0x75, 0xca, 0x0a, 0xc7,
+  0xa7, 0xaf, 0xbf, 0x19, 0x8b, 0xab, 0x56, 0x14, 0x0e, 0x55, 0x48, 0xd8,
+  0xa9, 0x05, 0x28, 0x4e, 0xee, 0x59, 0x16, 0xa8, 0xb9, 0xdc, 0x2b, 0x31,
+  0x19, 0xde, 0x0e, 0xac, 0xcf, 0x94, 0x8a, 0xd5, 0x8a, 0x44, 0xaf, 0x0a,
+  0x80, 0xcd, 0x18, 0x5e, 0x09, 0x76, 0xb2, 0x0c, 0xdd, 0x83, 0x5f, 0xe5,
+  0xcf, 0x45, 0x8c, 0xf4, 0xc2, 0xbd, 0xb2, 0xd3, 0x5c, 0x55, 0x28, 0x62,
+  0xc0, 0x63, 0xa2, 0x5b, 0x7b, 0x1d, 0xd5, 0x7a, 0x66, 0x27, 0xb3, 0xfa,
+  0x1a, 0xe0, 0xaf, 0xab, 0x2a, 0xeb, 0xe9, 0x33, 0x7d, 0x71, 0xe5, 0xfd,
+  0x56, 0x3d, 0x47, 0x31, 0x90, 0x03, 0x01, 0x33, 0xf3, 0xf6, 0x9b, 0xde,
+  0x0b, 0x52, 0xc6, 0xf2, 0x5b, 0x1f, 0x52, 0x85, 0xa8, 0x00, 0x4d, 0x46,
+  0x1b, 0xed, 0xca, 0x71, 0x7b, 0xe7, 0xba, 0x42, 0x72, 0xbe, 0x4e, 0xc6,
+  0x8d, 0x2f, 0xea, 0xc7, 0x66, 0xc8, 0xae, 0x1f, 0x82, 0x7f, 0x91, 0xd2,
+  0x6f, 0xe4, 0x1f, 0x4f, 0xe8, 0xc3, 0xf0, 0x71, 0xf2, 0x3f, 0xaf, 0xf0,
+  0x6f, 0xfa, 0xa4, 0x22, 0x26, 0x79, 0xe7, 0x3c, 0x8d, 0x6e, 0xb4, 0xb2,
+  0x52, 0x36, 0xb7, 0xb9, 0x92, 0xff, 0x7d, 0xe9, 0x2a, 0xc8, 0xfc, 0x35,
+  0x93, 0xeb, 0x0d, 0xc5, 0x90, 0xb1, 0xb2, 0x03, 0x8f, 0x11, 0x63, 0xe4,
+  0xc7, 0x3d, 0xee, 0xfb, 0x2c, 0xf1, 0x61, 0x15, 0xb5, 0x4e, 0xde, 0x6f,
+  0x96, 0xe5, 0x22, 0x84, 0x72, 0x04, 0x03, 0x46, 0xd8, 0x0c, 0x13, 0x5a,
+  0xa9, 0x11, 0x84, 0xcc, 0xfc, 0x60, 0xff, 0xf3, 0xd0, 0xc9, 0xfa, 0x41,
+  0x2b, 0xb8, 0x1c, 0xb2, 0x20, 0xd2, 0x00, 0x90, 0x4b, 0x3d, 0x71, 0x75,
+  0x0b, 0xb1, 0x8f, 0x46, 0x8a, 0xbc, 0x60, 0xfb, 0xce, 0x32, 0xb6, 0x96,
+  0x26, 0x6c, 0xf6, 0x86, 0x49, 0xb4, 0x28, 0x5a, 0xad, 0x21, 0xd7, 0x04,
+  0x12, 0x57, 0x62, 0xd9, 0x01, 0x7f, 0x47, 0x7b, 0x6d, 0x09, 0xb1, 0x7c,
+  0xe9, 0x70, 0xcb, 0x7e, 0xff, 0x78, 0x9f, 0xce, 0x54, 0x07, 0xa1, 0x66,
+  0x30, 0x0b, 0x75, 0x8d, 0xff, 0xfe, 0x51, 0x3a, 0xfa, 0x0d, 0x71, 0x87,
+  0x9e, 0xb4, 0xad, 0xe8, 0xdf, 0x0d, 0xf8, 0x86, 0x5f, 0x12, 0x38, 0xca,
+  0x70, 0x92, 0x56, 0x91, 0x7a, 0x01, 0x91, 0xdd, 0x8a, 0xa9, 0xa1, 0x88,
+  0x14, 0xfa, 0x16, 0xb7, 0x42, 0x90, 0x1c, 0x70, 0xfb, 0x43, 0x33, 0x54,
+  0x12, 0x76, 0x57, 0xb0, 0xfe, 0x69, 0xbf, 0xb9, 0xea, 0x80, 0x91, 0xa0,
+  0x3c, 0x20, 0xa8, 0x74, 0x31, 0xa0, 0xc8, 0x55, 0x04, 0x2e, 0x88, 0x95,
+  0x3d, 0xfb, 0x15, 0x7c, 0x66, 0x56, 0xa5, 0x37, 0x9e, 0x0d, 0xcd, 0x58,
+  0xec, 0x73, 0xb8, 0xa9, 0x6d, 0xca, 0x81, 0xf9, 0x3d, 0x45, 0x20, 0x63,
+  0xda, 0x47, 0x3d, 0xad, 0xa8, 0x6d, 0x8e, 0x74, 0x07, 0xc0, 0x48, 0x2b,
+  0x42, 0xc3, 0x33, 0x9a, 0xc7, 0x65, 0xa6, 0x95, 0x82, 0x76, 0xd5, 0x0a,
+  0x05, 0x01, 0xfc, 0x87, 0x51, 0x2c, 0x09, 0xd7, 0x65, 0xda, 0xd8, 0x76,
+  0xb7, 0xa4, 0xc4, 0x32, 0x60, 0x04, 0xbd, 0xae, 0x75, 0x9b, 0x16, 0x4c,
+  0x70, 0x45, 0x5d, 0xdb, 0xea, 0xab, 0xbc, 0xdb, 0xca, 0x7c, 0x67, 0xf8,
+  0x45, 0xf9, 0xc5, 0x70, 0x57, 0x48, 0xbc, 0xbc, 0xce, 0x6a, 0x58, 0x42,
+  0x98, 0x2a, 0x45, 0x27, 0xaf, 0xe0, 0x62, 0x11, 0xe1, 0x85, 0xf2, 0x44,
+  0x4a, 0x16, 0x84, 0x36, 0x06, 0x87, 0x78, 0xd0, 0x4e, 0x84, 0x27, 0x56,
+  0x51, 0x68, 0x52, 0xf8, 0x1d, 0xb9, 0x63, 0xcc, 0x5e, 0xcd, 0x39, 0x9f,
+  0x09, 0x25, 0x8c, 0x14, 0xb5, 0x15, 0xdc, 0x60, 0xf6, 0x02, 0x97, 0xab,
+  0xb6, 0x6c, 0xa2, 0x6a, 0x58, 0xe5, 0x0d, 0x2f, 0x95, 0xad, 0xfc, 0xe9,
+  0xde, 0x5c, 0x77, 0xcb, 0x80, 0xe6, 0xe2, 0xc4, 0xa0, 0xcb, 0x87, 0xda,
+  0x07, 0x46, 0x1c, 0x9e, 0x5e, 0x65, 0x4b, 0x69, 0xbb, 0xd2, 0x53, 0x39,
+  0xdc, 0x5b, 0x66, 0xdb, 0x9e, 0x13, 0x27, 0x83, 0xcd, 0x9b, 0xd5, 0x68,
+  0x59, 0xfe, 0xc3, 0xec, 0x71, 0x4a, 0x7d, 0xdc, 0x82, 0x2b, 0x41, 0x25,
+  0x7e, 0x05, 0x1f, 0x0a, 0x83, 0xf6, 0x14, 0xd6, 0xb0, 0x74, 0x2c, 0x5c,
+  0x91, 0xa1, 0x51, 0xe2, 0x9d, 0xbc, 0x36, 0x33, 0x3e, 0xfa, 0xf8, 0xe1,
+  0xfd, 0xf8, 0xc3, 0x59, 0x97, 0xb0, 0xcf, 0x4e, 0xcf, 0x2f, 0x8e, 0xde,
+  0x7c, 0x3c, 0x3b, 0x3f, 0xbd, 0x38, 0x7d, 0x7d, 0x7a, 0x92, 0xec, 0x1c,
+  0xec, 0x6e, 0xac, 0x68, 0xb2, 0x2e, 0x08, 0x0f, 0x1b, 0x4f, 0xe7, 0xcf,
+  0x3c, 0xcb, 0x4e, 0x61, 0x87, 0xd6, 0x13, 0x8e, 0xf6, 0x9d, 0xd0, 0x56,
+  0x0b, 0x6b, 0x18, 0x7e, 0x08, 0x08, 0x37, 0x70, 0xf5, 0x34, 0xb9, 0x5c,
+  0xf3, 0x65, 0x94, 0xd8, 0xb6, 0x96, 0x7b, 0xd4, 0x4d, 0x20, 0x8a, 0xb2,
+  0x4c, 0x22, 0x6c, 0x5e, 0x31, 0xcc, 0x46, 0x77, 0xdc, 0x93, 0xae, 0xce,
+  0x42, 0x67, 0x00, 0x05, 0xcc, 0x51, 0x45, 0x1d, 0x27, 0x0b, 0x4b, 0x17,
+  0x0c, 0xa1, 0x01, 0xdc, 0x65, 0xfb, 0x0a, 0x40, 0xe9, 0x25, 0xe2, 0x51,
+  0x16, 0x56, 0xa5, 0x1b, 0x25, 0x67, 0x61, 0x6f, 0x22, 0x79, 0x63, 0x96,
+  0x15, 0xd2, 0x20, 0x53, 0xe6, 0x81, 0x80, 0x17, 0x3a, 0x6f, 0x70, 0xf8,
+  0xd5, 0x3c, 0x40, 0xbf, 0xf5, 0xf6, 0x0a, 0x25, 0x96, 0x59, 0x10, 0x45,
+  0xe4, 0xb7, 0x19, 0x5d, 0xe2, 0xc6, 0x9b, 0x13, 0x8d, 0x47, 0x4a, 0x19,
+  0xb0, 0xef, 0x22, 0x1c, 0xf6, 0x48, 0xc3, 0x29, 0x8c, 0x8c, 0x81, 0x3b,
+  0x09, 0xfd, 0x45, 0x31, 0x55, 0xc6, 0xfe, 0x5a, 0xee, 0x21, 0x64, 0xde,
+  0x44, 0xf2, 0x6d, 0x0f, 0xe8, 0xec, 0x07, 0x4c, 0xd0, 0x12, 0x45, 0xda,
+  0x90, 0x50, 0xef, 0x12, 0x00, 0x7d, 0x8f, 0x14, 0x26, 0xc4, 0x05, 0x53,
+  0x98, 0xc8, 0xc0, 0x62, 0xbd, 0xbc, 0xed, 0x4c, 0xab, 0xcb, 0x7e, 0x9e,
+  0x8d, 0x9e, 0x3e, 0x19, 0x1d, 0x12, 0x50, 0xc1, 0xe9, 0x82, 0xa2, 0x2e,
+  0xa2, 0x59, 0xc0, 0xbf, 0x8c, 0x0f, 0x08, 0x2a, 0x0b, 0x52, 0xb6, 0xdc,
+  0x5e, 0xc9, 0x88, 0x31, 0x5b, 0x2a, 0xd1, 0x02, 0x4a, 0x15, 0x65, 0x5a,
+  0xcb, 0x2e, 0x6d, 0x54, 0x05, 0xca, 0x97, 0x90, 0x30, 0xcc, 0x77, 0x5e,
+  0xd8, 0xb4, 0x25, 0xca, 0xe3, 0xe9, 0xf2, 0x5a, 0x2a, 0x8b, 0x07, 0xcc,
+  0xe0, 0xeb, 0x33, 0xce, 0x69, 0xb4, 0x65, 0xf1, 0x60, 0xe5, 0xda, 0x26,
+  0x78, 0x9f, 0x22, 0xda, 0xe3, 0x77, 0x7f, 0x96, 0x20, 0x92, 0xf9, 0xdb,
+  0x38, 0x56, 0xee, 0xcd, 0xea, 0xbc, 0x8e, 0x31, 0x4a, 0xfc, 0x00, 0x08,
+  0x2d, 0xcf, 0x4c, 0xef, 0x0f, 0xf4, 0xa7, 0xa6, 0x0d, 0x77, 0x97, 0xdc,
+  0x03, 0xfd, 0x32, 0xf0, 0x2a, 0xd7, 0xcd, 0x7d, 0xad, 0xb3, 0xf8, 0x8a,
+  0x47, 0x9b, 0xd1, 0xaf, 0x0e, 0x83, 0x8b, 0x76, 0xef, 0x15, 0x7b, 0xe8,
+  0x0d, 0xb3, 0xa1, 0x01, 0x95, 0x0e, 0x5d, 0x99, 0x76, 0x66, 0xdf, 0x62,
+  0xb0, 0x0b, 0x2a, 0x99, 0xe1, 0xec, 0xc1, 0x6c, 0x0e, 0xdd, 0x10, 0x75,
+  0x6c, 0x03, 0xfc, 0x12, 0x21, 0x30, 0x9b, 0xe3, 0xc4, 0x27, 0x11, 0x03,
+  0xcc, 0x48, 0xa7, 0xbe, 0xae, 0x6d, 0x81, 0xd3, 0xb6, 0xcd, 0xa6, 0x52,
+  0xc7, 0x1d, 0xa9, 0xa4, 0x5c, 0xdc, 0x01, 0x28, 0x3c, 0xbf, 0xd5, 0x2c,
+  0xe2, 0x7f, 0x64, 0x55, 0x19, 0x86, 0x63, 0xa1, 0x3c, 0x28, 0x80, 0x15,
+  0x99, 0x92, 0x8a, 0xb0, 0xe1, 0x7e, 0x48, 0x5f, 0x0d, 0xee, 0xdc, 0x1f,
+  0xd0, 0xee, 0x95, 0x01, 0x69, 0xb9, 0x35, 0x93, 0x20, 0x2c, 0x00, 0x2c,
+  0x2e, 0xd7, 0x10, 0x9a, 0xc7, 0x03, 0x16, 0x54, 0x77, 0x77, 0xc7, 0x25,
+  0x7b, 0x81, 0x89, 0x09, 0xf5, 0x6f, 0x46, 0xe6, 0x8c, 0xcb, 0x12, 0xd7,
+  0xdb, 0x88, 0xd6, 0x4a, 0x0e, 0x64, 0x4b, 0xf4, 0xb9, 0x90, 0xa7, 0x0f,
+  0x93, 0xe4, 0x4d, 0x56, 0xdc, 0xb5, 0x27, 0x34, 0x00, 0x4e, 0x06, 0xdc,
+  0xc3, 0x79, 0xe3, 0x4a, 0xb9, 0xb5, 0x79, 0xc0, 0xdc, 0x33, 0x38, 0xc2,
+  0x29, 0xb5, 0xe7, 0x1c, 0xe3, 0x5c, 0x5f, 0xd8, 0x6d, 0xd0, 0x14, 0x1b,
+  0x7f, 0x33, 0x76, 0x80, 0xc8, 0xa0, 0x51, 0x40, 0x7c, 0xf2, 0x21, 0xdb,
+  0x00, 0x9c, 0x39, 0x58, 0x75, 0xf5, 0x7a, 0xf2, 0x37, 0x06, 0xf6, 0x4e,
+  0xc8, 0xb3, 0x50, 0xc9, 0x2e, 0x48, 0x5a, 0x9c, 0x39, 0x55, 0xf3, 0x00,
+  0x07, 0xae, 0x88, 0x39, 0x14, 0xb1, 0xe1, 0x10, 0x9c, 0x54, 0x48, 0xed,
+  0x36, 0x85, 0x61, 0x46, 0xd1, 0x5a, 0xa8, 0xac, 0x47, 0x65, 0xd0, 0xfb,
+  0x33, 0x9c, 0x13, 0x4f, 0xe5, 0x74, 0xab, 0x8e, 0xf0, 0xe5, 0xbd, 0xe4,
+  0x1c, 0x3f, 0x9b, 0x71, 0x4a, 0x8f, 0xf7, 0x8e, 0xa5, 0x9c, 0xba, 0x1e,
+  0xfc, 0x81, 0xfe, 0x08, 0xd7, 0xd0, 0x22, 0x59, 0xda, 0x65, 0x65, 0x23,
+  0xf4, 0x38, 0x18, 0x13, 0x5e, 0xef, 0xfb, 0xc0, 0x17, 0x4e, 0x0c, 0x6c,
+  0x1e, 0x1b, 0x5c, 0xec, 0x21, 0x1f, 0xf8, 0x50, 0x28, 0x80, 0x99, 0x52,
+  0xf7, 0xca, 0x22, 0xaa, 0xdf, 0xa4, 0x55, 0x81, 0x8c, 0x72, 0xdf, 0x0e,
+  0x22, 0xdc, 0x8b, 0x95, 0x74, 0x5b, 0x48, 0xe7, 0x94, 0x8c, 0x5b, 0x65,
+  0x0e, 0x00, 0x96, 0x8e, 0x92, 0xe1, 0x6d, 0x04, 0x51, 0x5a, 0x53, 0x43,
+  0x57, 0x65, 0xc3, 0xd8, 0xd6, 0x94, 0xbd, 0x4b, 0x9a, 0x4e, 0x45, 0x0e,
+  0x42, 0x6f, 0x93, 0x55, 0x45, 0xa6, 0xd1, 0xec, 0xe1, 0xc3, 0x8f, 0xb6,
+  0x5e, 0x95, 0x85, 0x4b, 0xfc, 0x97, 0xe0, 0xab, 0xc7, 0xc6, 0xe4, 0x8b,
+  0x9c, 0x82, 0x05, 0xa7, 0x93, 0x85, 0xc1, 0xbe, 0x2e, 0x73, 0x42, 0xb3,
+  0xd1, 0xe1, 0xa0, 0xbd, 0x39, 0x2a, 0xb9, 0x88, 0x77, 0x67, 0x70, 0x79,
+  0x2f, 0x62, 0x5f, 0xb9, 0xb4, 0xe0, 0xb4, 0x6e, 0x55, 0xfb, 0xe4, 0xad,
+  0x04, 0x61, 0x24, 0x48, 0x18, 0x1b, 0x88, 0xd0, 0xd5, 0x0c, 0x4d, 0x16,
+  0x1c, 0xba, 0x12, 0xe3, 0x53, 0x19, 0x2e, 0x4d, 0x0f, 0x29, 0x6b, 0x05,
+  0x59, 0x3d, 0x53, 0x8b, 0x3c, 0xd4, 0x05, 0xb0, 0x6e, 0xb7, 0xb4, 0xb6,
+  0xba, 0x80, 0x4d, 0xe3, 0x74, 0x6a, 0xee, 0xe8, 0x1e, 0x19, 0x71, 0x7b,
+  0xa7, 0x89, 0x63, 0x9b, 0x55, 0xb0, 0x15, 0x4a, 0x79, 0xcd, 0x3e, 0xe7,
+  0x0d, 0x4e, 0xac, 0x93, 0xb8, 0xaa, 0x09, 0x9d, 0xd2, 0xf3, 0x62, 0xb9,
+  0x0e, 0x1b, 0xe6, 0x49, 0xb0, 0xce, 0xe6, 0xe9, 0x30, 0x98, 0x13, 0xb4,
+  0x1f, 0xf1, 0xd2, 0x30, 0xa2, 0x3f, 0x6c, 0x74, 0xe9, 0x72, 0x00, 0xf7,
+  0x13, 0xe2, 0x77, 0x71, 0x3f, 0xe2, 0x9e, 0x45, 0x72, 0x31, 0x04, 0x53,
+  0xcc, 0x86, 0x86, 0x09, 0xac, 0x36, 0xf8, 0xe7, 0x6f, 0x07, 0xba, 0xe8,
+  0x56, 0xc6, 0xab, 0x0f, 0x1d, 0xc1, 0x3f, 0xe1, 0xc4, 0x3a, 0xd9, 0xbb,
+  0x30, 0x63, 0xdc, 0x68, 0x1a, 0x8f, 0x62, 0x3b, 0x19, 0xcb, 0xdc, 0x0b,
+  0x2d, 0x9c, 0x5e, 0x9c, 0x7f, 0x2d, 0xe8, 0xc2, 0x06, 0xea, 0x86, 0xf5,
+  0xa5, 0x39, 0xf1, 0xf6, 0xc9, 0xce, 0x7d, 0xe0, 0x7a, 0x2a, 0x8c, 0x89,
+  0x32, 0xd9, 0x42, 0x72, 0xa5, 0xbd, 0x6f, 0xb1, 0x29, 0x17, 0xec, 0x23,
+  0xb0, 0x95, 0x18, 0x33, 0x9e, 0x9f, 0x13, 0xa1, 0x64, 0x59, 0x5d, 0x30,
+  0x49, 0x39, 0xeb, 0x98, 0x2f, 0x08, 0x7c, 0x12, 0x1f, 0xa2, 0x89, 0xe5,
+  0x1b, 0x51, 0x0b, 0x7a, 0x0e, 0x23, 0x06, 0xd8, 0x31, 0xeb, 0xa4, 0xa1,
+  0xea, 0xcf, 0xb9, 0x73, 0x7b, 0x3c, 0xf9, 0x6d, 0x2c, 0xf7, 0x4d, 0xfb,
+  0xbb, 0x83, 0x4f, 0x6b, 0xe6, 0xa1, 0xe7, 0x1c, 0xe4, 0xc6, 0x43, 0xb7,
+  0xcd, 0x3d, 0xee, 0x5b, 0xf9, 0x1e, 0xc2, 0xf5, 0xda, 0xe7, 0x59, 0x06,
+  0x76, 0xff, 0x74, 0xbf, 0x35, 0xab, 0x8b, 0x31, 0x69, 0x3a, 0xab, 0x7e,
+  0x2f, 0x4b, 0xfb, 0x2b, 0x2f, 0xcd, 0x8d, 0xde, 0xb4, 0x28, 0x3c, 0xf4,
+  0x73, 0x16, 0xe5, 0x18, 0x87, 0xdb, 0x42, 0x99, 0x73, 0xe7, 0x44, 0xf8,
+  0x23, 0x1b, 0x63, 0x55, 0x3d, 0x4b, 0x30, 0x63, 0x6e, 0x68, 0x3d, 0xeb,
+  0x2d, 0xc3, 0x3e, 0xf8, 0x53, 0x57, 0x72, 0xff, 0x36, 0x82, 0x34, 0xe8,
+  0xbf, 0x7f, 0x7d, 0x01, 0x37, 0xe0, 0xec, 0xc7, 0xde, 0x79, 0x1c, 0x0d,
+  0x64, 0x2e, 0xbf, 0xc2, 0x34, 0xf2, 0xd5, 0x15, 0xe9, 0x96, 0x2f, 0x63,
+  0xa5, 0x36, 0xde, 0x46, 0xc8, 0x63, 0xbf, 0xfc, 0xf7, 0xab, 0x85, 0x03,
+  0xb5, 0xd9, 0xf0, 0x7d, 0x79, 0xec, 0x17, 0xff, 0x3e, 0xdf, 0xdd, 0xcd,
+  0xc2, 0xc5, 0x72, 0xc5, 0x37, 0x92, 0xd0, 0xdc, 0xe6, 0x38, 0x4e, 0xaa,
+  0xfc, 0x0c, 0xa6, 0x28, 0x39, 0xd2, 0x21, 0x57, 0x94, 0x6f, 0x45, 0x3b,
+  0x2f, 0xf8, 0x6c, 0xf1, 0x17, 0xe1, 0x60, 0x60, 0xcd, 0xe1, 0xe6, 0x48,
+  0x2b, 0x94, 0x97, 0xfc, 0xe7, 0xde, 0x97, 0xb1, 0x33, 0x52, 0x2c, 0xd4,
+  0x23, 0x12, 0x83, 0xda, 0x3c, 0x05, 0xdd, 0x38, 0x18, 0x2b, 0x40, 0x54,
+  0x5e, 0xdb, 0x49, 0x82, 0x36, 0x4b, 0xb3, 0x46, 0xe8, 0xd5, 0x58, 0xc7,
+  0x16, 0xd9, 0x21, 0x4a, 0x1b, 0x25, 0x0b, 0x4f, 0xe3, 0x14, 0x2e, 0x67,
+  0x88, 0x14, 0x8f, 0xcc, 0xfb, 0x60, 0xdd, 0xd7, 0x7c, 0x8b, 0x8b, 0x81,
+  0xbc, 0xbe, 0x97, 0x0e, 0xb5, 0xf4, 0xeb, 0x81, 0x74, 0x4c, 0x31, 0xc3,
+  0x11, 0x59, 0x49, 0xde, 0xa4, 0xd2, 0x13, 0x8e, 0x33, 0x84, 0x76, 0xe1,
+  0x74, 0x78, 0xd2, 0x4d, 0x17, 0x9c, 0x9e, 0x9b, 0xbc, 0x3e, 0x7d, 0xff,
+  0xfe, 0xe8, 0x75, 0x37, 0x1e, 0x0d, 0xd8, 0x0a, 0x54, 0x20, 0xa0, 0x41,
+  0x8f, 0xa8, 0xfa, 0x41, 0xbf, 0x3e, 0x7c, 0x9d, 0xc1, 0xd8, 0x6d, 0xc8,
+  0x88, 0x67, 0x80, 0x6e, 0x3e, 0xa9, 0x20, 0xb3, 0x72, 0x21, 0x83, 0x87,
+  0xd9, 0xc9, 0x14, 0x10, 0xa9, 0xee, 0x0a, 0xe8, 0xc1, 0xf9, 0x50, 0xe0,
+  0x4c, 0xa3, 0x5e, 0x8e, 0xac, 0x81, 0xc2, 0x7e, 0xd5, 0x19, 0x60, 0xba,
+  0xc6, 0x60, 0xdc, 0x93, 0xf4, 0x65, 0xa9, 0x8b, 0x0b, 0xbb, 0xc6, 0x59,
+  0x5a, 0x66, 0x94, 0x2f, 0x2a, 0x13, 0x19, 0x96, 0x73, 0x6e, 0x1d, 0xba,
+  0x4c, 0xab, 0x4f, 0x14, 0xcf, 0xf6, 0x0a, 0x46, 0x50, 0x30, 0x08, 0xc0,
+  0xe1, 0xd9, 0x2c, 0x56, 0x87, 0x0e, 0xaf, 0xbb, 0x66, 0xc8, 0xa3, 0x20,
+  0x8d, 0x27, 0x24, 0xed, 0xf6, 0x5e, 0x68, 0x25, 0x1f, 0xbd, 0x5e, 0x64,
+  0x37, 0xf4, 0x19, 0x06, 0xdf, 0xa0, 0x62, 0xf2, 0x10, 0xbf, 0x9f, 0x31,
+  0xa3, 0x39, 0xaa, 0x70, 0x27, 0x75, 0xec, 0x74, 0x56, 0x4b, 0x46, 0xc8,
+  0x07, 0x08, 0x2f, 0xb5, 0x9c, 0xe2, 0x2a, 0x90, 0x60, 0xaf, 0xbe, 0x56,
+  0x20, 0x3d, 0x2f, 0xa5, 0x2e, 0xc8, 0xfd, 0xb3, 0x98, 0x39, 0x93, 0xac,
+  0x05, 0xaf, 0xd7, 0x87, 0x45, 0xc2, 0xbb, 0x8d, 0x63, 0x20, 0x6b, 0xa5,
+  0x6e, 0x0d, 0xa0, 0x47, 0x9b, 0xf6, 0x44, 0xfe, 0xc6, 0x04, 0x8c, 0x0d,
+  0xa3, 0x19, 0x2c, 0xec, 0x49, 0x17, 0xe2, 0x15, 0xe8, 0x47, 0x70, 0x92,
+  0x12, 0xec, 0xd9, 0xe5, 0x9a, 0x0b, 0xde, 0xc8, 0x1d, 0x82, 0xcb, 0x1a,
+  0xa8, 0xb9, 0x48, 0x83, 0x46, 0x25, 0xd8, 0x40, 0x9b, 0xa7, 0xa3, 0xfb,
+  0xcf, 0x8c, 0x9a, 0x9a, 0xea, 0xe6, 0x2b, 0x92, 0x09, 0x07, 0x21, 0xe4,
+  0x02, 0xe7, 0xc5, 0x6a, 0xdd, 0x04, 0x81, 0x44, 0x82, 0x74, 0xe2, 0x6a,
+  0xfe, 0x2f, 0x87, 0x61, 0xfb, 0xa3, 0x74, 0xe6, 0x9f, 0x29, 0x18, 0x38,
+  0x2c, 0xff, 0xba, 0x31, 0xd7, 0x7f, 0xa3, 0x67, 0xd9, 0xb7, 0x68, 0x9c,
+  0x49, 0x23, 0x79, 0xe2, 0x1c, 0xf9, 0x75, 0xc4, 0xba, 0x07, 0xd7, 0x42,
+  0x97, 0x16, 0xec, 0x5b, 0xca, 0x22, 0x36, 0x21, 0x77, 0x00, 0x56, 0xb0,
+  0xc3, 0xfd, 0x8c, 0x95, 0x43, 0x8e, 0xad, 0xac, 0x4f, 0x28, 0x7d, 0xe2,
+  0x8e, 0x4c, 0xfc, 0xd0, 0x2f, 0x2f, 0x99, 0x6c, 0xf7, 0xeb, 0x7b, 0x74,
+  0x14, 0xfb, 0xdc, 0xaf, 0x31, 0x83, 0x68, 0xbf, 0xf9, 0xd6, 0xb7, 0x1f,
+  0xfe, 0xd9, 0x00, 0xdf, 0x6e, 0x83, 0xd4, 0xb5, 0x29, 0xae, 0x90, 0x85,
+  0xf7, 0xc2, 0x37, 0x82, 0xe7, 0x06, 0x79, 0xa9, 0x9e, 0x44, 0xde, 0x28,
+  0x83, 0x5d, 0xdd, 0x92, 0x2f, 0x86, 0x23, 0x01, 0xfb, 0xd8, 0x44, 0x24,
+  0x04, 0xf5, 0x30, 0x91, 0x7c, 0xaf, 0x08, 0x6e, 0x95, 0x7d, 0x76, 0xf3,
+  0xac, 0x6c, 0xd9, 0xd7, 0xc3, 0x37, 0x8e, 0x6a, 0xde, 0x7e, 0x49, 0x75,
+  0x05, 0xb5, 0x66, 0x2d, 0x65, 0x05, 0x9f, 0x68, 0x6d, 0xc2, 0x43, 0xa4,
+  0x52, 0xb0, 0x25, 0xdd, 0xda, 0xb1, 0xd6, 0x46, 0x85, 0xbb, 0xb0, 0x29,
+  0xeb, 0xdd, 0x91, 0x27, 0x9e, 0xfa, 0xc5, 0xaf, 0xc5, 0xc3, 0x53, 0xb6,
+  0xe3, 0x27, 0xd3, 0x97, 0xb5, 0x4d, 0xc3, 0x31, 0x3c, 0x74, 0x6f, 0xca,
+  0x36, 0x25, 0x37, 0x79, 0x09, 0xdb, 0x9e, 0x5f, 0xa2, 0x2f, 0x63, 0xfb,
+  0xff, 0xc4, 0x94, 0xed, 0x56, 0xce, 0x36, 0xa9, 0x57, 0x94, 0x22, 0x1c,
+  0x4b, 0xdb, 0xf6, 0x20, 0x36, 0x38, 0x67, 0x7b, 0x53, 0xca, 0xb6, 0x97,
+  0xb1, 0xbd, 0x21, 0x61, 0x9b, 0x01, 0x4b, 0x37, 0xa5, 0x6c, 0xff, 0xcc,
+  0x9c, 0xed, 0x9e, 0x94, 0xed, 0x9f, 0x9c, 0xb1, 0xfd, 0x0b, 0xa7, 0x6c,
+  0xff, 0x92, 0xd9, 0xc8, 0xb8, 0x3d, 0x74, 0x1e, 0xf9, 0x54, 0x4a, 0x61,
+  0x5e, 0xde, 0x0b, 0x63, 0xda, 0x4e, 0x60, 0xf1, 0xe2, 0xcc, 0x32, 0x0e,
+  0xab, 0x34, 0x4e, 0x71, 0x2f, 0x02, 0x9d, 0x47, 0x48, 0x25, 0x92, 0x01,
+  0xe7, 0xc7, 0x81, 0x1f, 0xc5, 0x6e, 0x7a, 0x5d, 0x2f, 0x86, 0x98, 0x00,
+  0xd5, 0xa8, 0x06, 0x56, 0xa2, 0xe3, 0x33, 0x9d, 0xe7, 0x7e, 0x79, 0x96,
+  0xd3, 0x2c, 0xea, 0x83, 0x47, 0xce, 0x56, 0x97, 0xbf, 0xac, 0xa9, 0x7e,
+  0x32, 0x66, 0xb7, 0x33, 0xf7, 0x19, 0x0b, 0x87, 0x51, 0x50, 0x0c, 0x7e,
+  0x0b, 0x3e, 0xd2, 0xcc, 0xb6, 0x71, 0xb3, 0x11, 0x09, 0xdb, 0x95, 0x35,
+  0x2c, 0x86, 0x41, 0xc1, 0xb4, 0xbf, 0x0e, 0x88, 0x10, 0x2a, 0x7b, 0x51,
+  0xa6, 0x5d, 0xe3, 0x0a, 0x1e, 0x8c, 0x1e, 0x71, 0x45, 0xad, 0x42, 0x72,
+  0xc8, 0x3c, 0x03, 0x14, 0x1c, 0x4c, 0x00, 0x18, 0xc4, 0x6a, 0xda, 0x71,
+  0x93, 0x24, 0x79, 0x7e, 0x94, 0x9c, 0x93, 0xea, 0x68, 0x14, 0x75, 0x44,
+  0xfb, 0x71, 0xbb, 0xcd, 0xd8, 0x89, 0xfc, 0x3e, 0x36, 0x5c, 0x1b, 0xf8,
+  0xd2, 0xd0, 0xcf, 0x87, 0xf3, 0x93, 0x30, 0x3e, 0x8d, 0xe8, 0xc1, 0x8b,
+  0xbd, 0x3d, 0x24, 0x48, 0x5d, 0xa5, 0xb7, 0xb7, 0xa3, 0x3a, 0xdb, 0x9b,
+  0x95, 0xd3, 0x7a, 0x8f, 0x4e, 0x50, 0xbf, 0x7e, 0xd5, 0x2c, 0x17, 0x9f,
+  0xdd, 0x07, 0xad, 0xab, 0x75, 0x9c, 0x8b, 0x3b, 0xa9, 0xf4, 0x76, 0xd9,
+  0x97, 0xb8, 0x95, 0xb9, 0x57, 0x56, 0xbd, 0x0e, 0xba, 0x1d, 0x4a, 0x55,
+  0x81, 0x59, 0x95, 0xf9, 0x3f, 0xf4, 0x79, 0xa0, 0xa8, 0x52, 0xa4, 0xd0,
+  0xd5, 0xef, 0x85, 0xe9, 0xd5, 0x10, 0x84, 0x07, 0xc4, 0x3d, 0x0a, 0x1a,
+  0xc2, 0xb1, 0xcc, 0x1a, 0x30, 0x31, 0x39, 0x91, 0xce, 0xb1, 0x77, 0xba,
+  0x50, 0x32, 0x79, 0x85, 0xad, 0xa2, 0x40, 0x67, 0x3d, 0x7d, 0x29, 0x7f,
+  0x71, 0x96, 0x60, 0xa8, 0x9b, 0xa4, 0xfc, 0x43, 0x94, 0x5d, 0xff, 0xd1,
+  0x5f, 0xe3, 0x96, 0xd9, 0x84, 0xbc, 0x97, 0x9c, 0x6d, 0xb7, 0x71, 0x26,
+  0xf6, 0xe1, 0x5f, 0x63, 0x26, 0x28, 0xea, 0x8e, 0xf2, 0xc7, 0xd6, 0x1c,
+  0xf0, 0xd8, 0xaf, 0xf1, 0xfd, 0xeb, 0x83, 0xbe, 0xcf, 0xa2, 0xf1, 0x24,
+  0x9e, 0xf8, 0x05, 0x3f, 0xfc, 0xc1, 0x3a, 0xab, 0xb8, 0x06, 0xfe, 0x25,
+  0xfd, 0xf7, 0x85, 0xee, 0x70, 0x5f, 0x47, 0xab, 0x0d, 0x68, 0xe1, 0x5e,
+  0x33, 0xed, 0x00, 0xeb, 0xe1, 0x41, 0x19, 0xed, 0xc7, 0x0c, 0xc8, 0x2e,
+  0x20, 0x42, 0x82, 0x24, 0x0c, 0x80, 0xf7, 0xa1, 0xc2, 0x90, 0x31, 0xe4,
+  0x06, 0x63, 0xa0, 0x30, 0xa2, 0x85, 0x42, 0xf2, 0xbc, 0xef, 0x11, 0x43,
+  0xc8, 0x10, 0x88, 0x69, 0xe5, 0x8d, 0x3a, 0x8d, 0x70, 0x8d, 0xfd, 0xda,
+  0x48, 0x73, 0xb1, 0x16, 0x61, 0x5a, 0xcb, 0x7d, 0x38, 0xe9, 0xe0, 0xd9,
+  0x3e, 0x72, 0xcd, 0xc4, 0xfa, 0xd1, 0xc0, 0x57, 0xba, 0x4c, 0x54, 0x31,
+  0x34, 0x17, 0x0e, 0xec, 0xc0, 0x5e, 0xf1, 0x17, 0xc9, 0xd6, 0xf0, 0x43,
+  0xf2, 0x62, 0x2b, 0xd8, 0xa2, 0xd3, 0x42, 0xfa, 0x4c, 0xc0, 0xe9, 0x55,
+  0xa1, 0x70, 0x1a, 0xad, 0x6b, 0x7c, 0xd5, 0xe4, 0x8a, 0x00, 0x6e, 0x9c,
+  0x39, 0x61, 0x31, 0xda, 0x2f, 0x83, 0x20, 0x1c, 0x3b, 0x2f, 0x58, 0x89,
+  0xd2, 0xae, 0x2a, 0x24, 0x4a, 0xc8, 0x6d, 0xe3, 0x20, 0x97, 0xa1, 0x3e,
+  0x31, 0x62, 0xbc, 0x24, 0x36, 0x50, 0x34, 0x73, 0x1a, 0xba, 0x5f, 0x6c,
+  0x3f, 0x62, 0x8c, 0xb8, 0x2a, 0xeb, 0x3a, 0x9f, 0x18, 0x1e, 0x7d, 0x29,
+  0xfc, 0xb1, 0xce, 0x38, 0x9d, 0x8a, 0x1b, 0x3b, 0xd2, 0x5e, 0xd6, 0x2e,
+  0xb9, 0xac, 0x0e, 0xa1, 0x98, 0x78, 0xa5, 0x16, 0xa5, 0x5e, 0xdc, 0x4b,
+  0x66, 0x76, 0xcc, 0xda, 0xae, 0x73, 0x1a, 0x9e, 0x09, 0x2e, 0x4d, 0x26,
+  0x55, 0x9e, 0xcd, 0x93, 0x65, 0xc9, 0x5b, 0x0f, 0xc5, 0xab, 0xcb, 0x64,
+  0x17, 0x04, 0xe4, 0x40, 0x9d, 0x89, 0x29, 0xd3, 0xb6, 0x26, 0xa0, 0x3b,
+  0xe4, 0x5f, 0x23, 0xfb, 0xd1, 0xe5, 0x76, 0x57, 0x19, 0x65, 0x0e, 0x5c,
+  0x67, 0x72, 0xac, 0xa9, 0xf6, 0xfb, 0xe8, 0xc9, 0x49, 0xad, 0x2c, 0x1e,
+  0x30, 0xaa, 0x1d, 0x80, 0x21, 0x63, 0xf1, 0x2c, 0xe8, 0x8b, 0x89, 0xb6,
+  0xf6, 0x4e, 0x5b, 0xa5, 0xde, 0xa3, 0x5f, 0x8d, 0xc7, 0x7b, 0x5e, 0xe8,
+  0x9f, 0x5d, 0x07, 0xd0, 0x9f, 0x15, 0xdf, 0x4e, 0x8d, 0x0e, 0xe0, 0x37,
+  0xe2, 0xf9, 0xf0, 0x73, 0x42, 0xe2, 0x7e, 0xdf, 0xd5, 0x72, 0x22, 0xa9,
+  0xe5, 0x94, 0x40, 0xc7, 0xf9, 0x6a, 0x76, 0x75, 0x0d, 0x6a, 0xd1, 0x01,
+  0xec, 0xe1, 0xc7, 0x86, 0x3f, 0x04, 0x22, 0xde, 0xa5, 0xcb, 0xb7, 0x12,
+  0xe4, 0x5d, 0x7e, 0x3c, 0x9d, 0x95, 0xcb, 0x8e, 0x47, 0x41, 0x08, 0xbb,
+  0xc8, 0x53, 0x9a, 0x41, 0x28, 0x93, 0x09, 0xb7, 0xb8, 0x3f, 0x37, 0xde,
+  0xe8, 0x7c, 0x5e, 0xac, 0xde, 0x21, 0x0d, 0x92, 0x83, 0x35, 0x1e, 0x25,
+  0xc6, 0x0d, 0x05, 0xe6, 0xfc, 0xb3, 0xa0, 0x73, 0x9c, 0xd4, 0x4e, 0x08,
+  0xe3, 0xb4, 0xd9, 0x0b, 0xd7, 0x79, 0x6a, 0x75, 0x28, 0xf7, 0x2d, 0xde,
+  0x51, 0xf7, 0xa9, 0xbe, 0x38, 0x1c, 0x23, 0xb4, 0x44, 0x2a, 0x3b, 0xdf,
+  0x8f, 0xc7, 0x61, 0x8a, 0x7c, 0x61, 0x8c, 0x93, 0xf2, 0xb2, 0xc8, 0xff,
+  0x21, 0x2d, 0x7d, 0xba, 0x99, 0xad, 0xad, 0x1a, 0x85, 0x76, 0x40, 0x9e,
+  0x12, 0x25, 0x42, 0xfe, 0x46, 0x4e, 0x6d, 0x11, 0x3b, 0x48, 0x08, 0x23,
+  0xc8, 0x23, 0x97, 0x0c, 0x48, 0x71, 0x06, 0xee, 0xdb, 0xd2, 0x4a, 0x7a,
+  0x50, 0x7c, 0x95, 0xcf, 0x42, 0x45, 0x92, 0xf6, 0x40, 0xb0, 0x4a, 0xe2,
+  0x2a, 0x52, 0xf6, 0x33, 0x0a, 0x0a, 0x88, 0x83, 0xfe, 0xac, 0x92, 0x82,
+  0xb6, 0x82, 0xea, 0xc1, 0xa1, 0x65, 0xb7, 0xcc, 0x41, 0xa3, 0x30, 0x66,
+  0xe2, 0x9c, 0xae, 0xb3, 0x98, 0x78, 0xb1, 0x71, 0x08, 0xb4, 0x6c, 0x78,
+  0x00, 0x26, 0x9a, 0x55, 0x3d, 0x03, 0xf1, 0x12, 0x41, 0x44, 0xb3, 0xa3,
+  0x3f, 0x00, 0x0a, 0x8d, 0xdc, 0xf8, 0x0a, 0x64, 0x2d, 0x53, 0x46, 0x7b,
+  0x07, 0xee, 0x1a, 0x9a, 0x31, 0x7e, 0x19, 0x4d, 0xcb, 0x5d, 0x49, 0xbe,
+  0xb0, 0xd1, 0xc6, 0x83, 0xab, 0x54, 0x14, 0xf7, 0x89, 0x16, 0xed, 0x35,
+  0xbc, 0xb7, 0xf4, 0xf6, 0x88, 0xd0, 0xba, 0xa8, 0xa8, 0xca, 0x02, 0x29,
+  0x91, 0x25, 0x8f, 0xea, 0x3d, 0xa5, 0x89, 0x2e, 0x69, 0x39, 0x50, 0x71,
+  0x3b, 0x45, 0xce, 0x12, 0x11, 0x1f, 0xbf, 0x6d, 0x96, 0xd5, 0x96, 0x61,
+  0x0c, 0x59, 0x19, 0x90, 0x96, 0x20, 0x99, 0x40, 0x0d, 0x58, 0x1b, 0xa3,
+  0x8c, 0xc0, 0x46, 0xb9, 0xb4, 0xc8, 0x9e, 0xc9, 0x80, 0xb8, 0x0f, 0xb3,
+  0x5c, 0xf1, 0xd4, 0x0d, 0x57, 0xca, 0x65, 0xbb, 0x8b, 0xbd, 0x93, 0x41,
+  0x7a, 0x74, 0xf9, 0x5f, 0xa1, 0x12, 0xe5, 0xe7, 0x14, 0xa2, 0xfc, 0xca,
+  0x95, 0x28, 0x9e, 0xa4, 0x20, 0xb1, 0x13, 0xca, 0x09, 0xa4, 0x45, 0x91,
+  0x4b, 0x86, 0xf3, 0xa0, 0x6e, 0x52, 0xdb, 0xee, 0x02, 0x6f, 0x75, 0x86,
+  0x8b, 0xde, 0xa4, 0x76, 0x8e, 0xac, 0xc7, 0x41, 0x94, 0x3f, 0x72, 0x0a,
+  0x3c, 0x35, 0xda, 0x8a, 0xc0, 0xc2, 0x60, 0x02, 0x54, 0x32, 0x3e, 0xcb,
+  0x04, 0xcf, 0xe9, 0x0f, 0xae, 0xdb, 0xc4, 0xaf, 0x6d, 0x80, 0x1d, 0x18,
+  0xde, 0xfc, 0xd2, 0x93, 0xc7, 0x7f, 0x8a, 0x08, 0xe4, 0xc0, 0x69, 0xc9,
+  0x75, 0x6d, 0xf4, 0x6a, 0x1b, 0x35, 0x31, 0xc2, 0xf4, 0xe2, 0x17, 0x06,
+  0xcd, 0x2d, 0x19, 0x19, 0x4f, 0xd8, 0x1b, 0xa5, 0xc5, 0xd1, 0xcb, 0x3d,
+  0x0c, 0x4e, 0x70, 0x39, 0xd5, 0x20, 0x36, 0xfc, 0x7c, 0x92, 0x35, 0x37,
+  0xa4, 0xc5, 0x61, 0x37, 0x74, 0x1b, 0x3d, 0x1e, 0x60, 0xf9, 0x61, 0x6f,
+  0xbe, 0xcb, 0x40, 0x00, 0x51, 0x89, 0xa3, 0x30, 0xe8, 0xab, 0xf5, 0x8c,
+  0x68, 0x5c, 0x37, 0xb8, 0x7e, 0xb1, 0xf6, 0x31, 0x2e, 0x44, 0xcd, 0xdf,
+  0xa7, 0x7d, 0xf1, 0x72, 0x71, 0x5b, 0x15, 0x43, 0x9a, 0xb9, 0x24, 0x0f,
+  0xfa, 0x3e, 0x7e, 0x7b, 0x8d, 0xe5, 0xda, 0xc6, 0xbc, 0x9f, 0x6d, 0x36,
+  0xa7, 0x87, 0xef, 0xe9, 0x59, 0x83, 0x0e, 0x18, 0x9d, 0x2b, 0x90, 0x8b,
+  0x85, 0x86, 0x7b, 0xb9, 0x0c, 0xbb, 0x72, 0xe4, 0xb7, 0xe9, 0xca, 0xfc,
+  0x8c, 0x42, 0x82, 0x00, 0x20, 0x9d, 0x65, 0xb1, 0xbc, 0x84, 0xce, 0xe6,
+  0x77, 0xe2, 0xe2, 0x38, 0x9f, 0x10, 0x9a, 0xdd, 0x1a, 0x67, 0xb1, 0x96,
+  0x1a, 0xb5, 0x20, 0xfd, 0xa8, 0x7b, 0x4a, 0x83, 0xe0, 0x12, 0x6c, 0xf1,
+  0x29, 0x4d, 0x10, 0x8c, 0x0b, 0x29, 0xdf, 0x0c, 0xe1, 0x8e, 0x5b, 0x6b,
+  0x0c, 0xbb, 0x6d, 0x5f, 0x30, 0xfa, 0x1d, 0xea, 0xb1, 0xba, 0xf3, 0x97,
+  0x1c, 0x3e, 0x6d, 0xb3, 0xd6, 0x72, 0xf2, 0x40, 0x96, 0x85, 0x2e, 0x33,
+  0x01, 0x0b, 0xd2, 0x57, 0x04, 0x32, 0x57, 0x3e, 0x60, 0xdb, 0x51, 0xf6,
+  0x45, 0x26, 0x63, 0x39, 0x1c, 0xad, 0x5b, 0x2b, 0xb1, 0x87, 0x48, 0x6c,
+  0x6e, 0x67, 0x4c, 0x75, 0x11, 0xe3, 0xd7, 0x67, 0xbb, 0xc9, 0x59, 0x27,
+  0xac, 0x80, 0xa2, 0x24, 0x12, 0xa6, 0x3e, 0x23, 0x96, 0xf6, 0x5f, 0x8c,
+  0x89, 0xd8, 0xef, 0x82, 0xce, 0xe5, 0x92, 0x59, 0xe4, 0x4f, 0x84, 0x7e,
+  0x7f, 0x71, 0xc6, 0xd4, 0x59, 0xcb, 0x2b, 0x14, 0x69, 0x30, 0x28, 0x88,
+  0x98, 0x94, 0xfe, 0x2d, 0x35, 0x26, 0x74, 0x49, 0xa5, 0x76, 0xdc, 0x70,
+  0x47, 0x9c, 0xf2, 0xea, 0x4c, 0x5f, 0x04, 0xa9, 0x8e, 0x0c, 0x8a, 0xa3,
+  0x99, 0xe7, 0x1e, 0xfc, 0x91, 0xb4, 0xbe, 0xab, 0x59, 0x2e, 0x75, 0xa0,
+  0xe9, 0x69, 0x15, 0x97, 0x59, 0x11, 0x76, 0xba, 0xc0, 0x47, 0x49, 0x90,
+  0x0b, 0x51, 0xcf, 0x46, 0x5d, 0x94, 0x75, 0x2f, 0x6c, 0x20, 0x93, 0xcb,
+  0x4b, 0x87, 0xce, 0xdd, 0x87, 0xc8, 0x48, 0x26, 0xff, 0x04, 0x05, 0x80,
+  0x9f, 0x88, 0x27, 0x5e, 0x52, 0xa0, 0xa6, 0x81, 0x8c, 0x5b, 0xdd, 0xd1,
+  0x76, 0x98, 0x07, 0xeb, 0xfa, 0xea, 0xd0, 0x70, 0x8e, 0xc3, 0xd1, 0xe7,
+  0x30, 0x51, 0x8c, 0xb0, 0x8e, 0xc0, 0xb7, 0x72, 0xee, 0x88, 0xb4, 0xc8,
+  0xec, 0x8c, 0x26, 0x5a, 0xf8, 0xc8, 0x29, 0xfe, 0xc3, 0xff, 0x4e, 0x94,
+  0xf6, 0xf7, 0x75, 0x18, 0xbf, 0xdb, 0x01, 0x41, 0xbd, 0x05, 0xf6, 0x22,
+  0xb5, 0x60, 0x41, 0xa6, 0xc1, 0x24, 0x6f, 0x00, 0xa3, 0xae, 0x36, 0x64,
+  0xfb, 0x62, 0xbe, 0xe5, 0x92, 0xe7, 0x04, 0xaf, 0x45, 0x6b, 0xe2, 0x8d,
+  0x0a, 0xfe, 0xdf, 0xe9, 0x5b, 0x3a, 0x00, 0xd7, 0x26, 0x21, 0x1b, 0xe2,
+  0xcf, 0x47, 0x6f, 0x4f, 0xcf, 0x8f, 0xda, 0xf5, 0x8a, 0x0d, 0x1a, 0x3e,
+  0x21, 0xd8, 0xdf, 0x9d, 0x1d, 0x50, 0xd0, 0x5c, 0x23, 0xd1, 0xbc, 0xc8,
+  0xc9, 0xe8, 0x4f, 0xce, 0xbe, 0x7b, 0x63, 0x27, 0x97, 0x83, 0x69, 0x62,
+  0x52, 0x3a, 0xe2, 0x40, 0xf7, 0xb9, 0x2b, 0xda, 0x49, 0x09, 0xa0, 0x06,
+  0x44, 0xd2, 0xd0, 0xd8, 0x4e, 0x0f, 0x49, 0x16, 0x9c, 0x1a, 0xa3, 0xa5,
+  0xfa, 0xc0, 0xdc, 0xae, 0x6b, 0x2a, 0xbd, 0xb7, 0xc3, 0x06, 0x7a, 0x2f,
+  0x44, 0x3f, 0xd0, 0xa6, 0xc4, 0x16, 0x25, 0xa4, 0x31, 0x82, 0x1f, 0x1b,
+  0x25, 0xf6, 0x23, 0xee, 0x2b, 0x40, 0x10, 0xe4, 0x6c, 0x20, 0x7c, 0x25,
+  0xc6, 0xb0, 0xa9, 0xd7, 0x36, 0xc7, 0x41, 0x58, 0xde, 0x91, 0xc3, 0x85,
+  0x68, 0xd6, 0xf6, 0x3a, 0x1a, 0x30, 0x32, 0x9c, 0x84, 0x7b, 0xfc, 0x7d,
+  0x8c, 0x44, 0xc8, 0xcd, 0x67, 0x77, 0xea, 0xdd, 0x81, 0x37, 0x53, 0xbb,
+  0x6d, 0x32, 0xe1, 0xed, 0x3f, 0x6c, 0x27, 0x52, 0x10, 0x02, 0x86, 0xc7,
+  0x0d, 0x6a, 0x7a, 0x7a, 0x1c, 0xba, 0x9e, 0x57, 0xbb, 0xf7, 0xe5, 0x6f,
+  0xe9, 0xa2, 0xfb, 0xeb, 0xb1, 0x25, 0x74, 0x27, 0x49, 0x3d, 0x68, 0x3e,
+  0xb9, 0x66, 0x80, 0x4b, 0xb0, 0x0e, 0x11, 0xa7, 0x3a, 0x0e, 0x33, 0x96,
+  0xb0, 0xf8, 0xa2, 0x21, 0xd8, 0x05, 0xd7, 0x07, 0x47, 0x19, 0x0e, 0x22,
+  0x66, 0x8a, 0x74, 0xce, 0xb1, 0x08, 0xa2, 0xee, 0xfa, 0xae, 0x68, 0xe8,
+  0xa2, 0x32, 0x4f, 0x99, 0x96, 0x55, 0xbc, 0x00, 0x0c, 0xc4, 0xe4, 0x68,
+  0xb7, 0x06, 0xd6, 0xc4, 0xf3, 0x27, 0xcf, 0x49, 0xb8, 0x23, 0x47, 0x49,
+  0xfa, 0x40, 0x09, 0x22, 0x30, 0xe2, 0xa7, 0x3c, 0xe7, 0x28, 0x72, 0x88,
+  0x8c, 0x23, 0x9d, 0x7b, 0x27, 0xd9, 0x82, 0x3b, 0x4f, 0x8d, 0xbd, 0x21,
+  0x42, 0x30, 0xa5, 0xbe, 0x13, 0x23, 0x8c, 0x3e, 0x43, 0x3b, 0x79, 0xfd,
+  0x29, 0xd9, 0xf9, 0x77, 0x6e, 0xd3, 0xe7, 0xaa, 0xe3, 0x39, 0xf8, 0x9b,
+  0x17, 0xeb, 0x80, 0xf2, 0xd1, 0x6a, 0x3d, 0x6f, 0xed, 0x29, 0xb6, 0x1c,
+  0xcb, 0x9b, 0xc4, 0x8a, 0xf2, 0xea, 0xa6, 0x5c, 0x91, 0xd2, 0x06, 0xf8,
+  0x84, 0x48, 0xa7, 0x50, 0x73, 0x58, 0x0f, 0x4e, 0xf2, 0x69, 0x97, 0x2d,
+  0x84, 0x12, 0x91, 0x76, 0x02, 0x20, 0xca, 0xe2, 0x6e, 0x55, 0xe5, 0x6a,
+  0x94, 0x7c, 0x28, 0x90, 0x89, 0x27, 0x64, 0x27, 0x62, 0x22, 0x2f, 0xcc,
+  0x0e, 0x18, 0x9a, 0x26, 0x28, 0x8f, 0x08, 0x13, 0x02, 0x9f, 0xf3, 0xef,
+  0x9d, 0xb0, 0xc9, 0x4e, 0x88, 0x14, 0xf7, 0xd6, 0x62, 0x5e, 0x0b, 0xdf,
+  0x7a, 0x1b, 0xf6, 0x54, 0xe3, 0x9e, 0x50, 0x44, 0xea, 0x66, 0x39, 0x18,
+  0x9b, 0x42, 0xe0, 0xd9, 0x62, 0x31, 0x64, 0xd0, 0x6d, 0x02, 0x21, 0x26,
+  0xe5, 0x9e, 0x8b, 0xa4, 0x91, 0xc0, 0xe6, 0x97, 0xe0, 0x07, 0x92, 0x05,
+  0xb5, 0xde, 0x23, 0xd4, 0x00, 0x29, 0xd8, 0x88, 0xa4, 0xbd, 0x6b, 0x64,
+  0x8d, 0x0a, 0xf7, 0x9c, 0x3f, 0x04, 0xbb, 0xf3, 0x77, 0xe5, 0xa7, 0xb1,
+  0x2e, 0x48, 0x21, 0x8c, 0xe5, 0xf4, 0xea, 0xb2, 0x5a, 0x71, 0x27, 0xb6,
+  0x58, 0x9b, 0x38, 0x4f, 0xeb, 0xe6, 0x27, 0x95, 0x24, 0xea, 0xac, 0xe1,
+  0xa9, 0xf0, 0xab, 0xc7, 0x6f, 0x5a, 0x1d, 0x9d, 0x69, 0x27, 0x50, 0xe7,
+  0x16, 0x1f, 0x4e, 0xfa, 0x68, 0xda, 0x56, 0xeb, 0x4e, 0x72, 0xd8, 0xd1,
+  0x9c, 0x89, 0x31, 0xb9, 0x73, 0xbf, 0x89, 0x0f, 0x27, 0x63, 0xb0, 0xa6,
+  0xca, 0x23, 0xe8, 0xb0, 0xa0, 0x15, 0xed, 0x39, 0x4e, 0xd4, 0x70, 0x99,
+  0x55, 0xf6, 0x23, 0x61, 0x92, 0xe4, 0xd5, 0xb2, 0x9c, 0x51, 0x51, 0x57,
+  0x76, 0xef, 0x5e, 0xd0, 0x83, 0xba, 0x17, 0x52, 0x0b, 0x57, 0xfb, 0xeb,
+  0xc2, 0x20, 0x86, 0x4a, 0x89, 0xf2, 0x04, 0xdf, 0x33, 0x3e, 0x9c, 0x5b,
+  0xa8, 0x76, 0x46, 0xcc, 0xf8, 0x65, 0x7f, 0x09, 0x45, 0x52, 0x4e, 0x1b,
+  0x6f, 0x05, 0xf4, 0x40, 0x7c, 0x38, 0x66, 0xac, 0x91, 0x95, 0x51, 0x81,
+  0x14, 0x2c, 0xca, 0xfb, 0x56, 0x46, 0x0f, 0x06, 0xa7, 0x6c, 0x7e, 0xc8,
+  0xec, 0xba, 0x73, 0xc4, 0x7c, 0x38, 0xf1, 0xe1, 0xda, 0x07, 0xac, 0x27,
+  0x8c, 0x39, 0xc4, 0x0e, 0x58, 0x30, 0x8f, 0x43, 0x0d, 0xcb, 0xd9, 0xc7,
+  0xbc, 0x3b, 0xf6, 0xc1, 0xde, 0x03, 0x96, 0x6f, 0x04, 0xbb, 0xb0, 0x28,
+  0x8c, 0x76, 0xb7, 0xae, 0xa6, 0xd9, 0x47, 0xcc, 0xad, 0x49, 0xab, 0xcb,
+  0xac, 0xf9, 0xb8, 0x79, 0x43, 0x16, 0x82, 0xa6, 0x70, 0xb7, 0x44, 0x6b,
+  0x63, 0xcb, 0x2b, 0x04, 0x8d, 0x34, 0x15, 0x74, 0x01, 0xa3, 0xe0, 0x71,
+  0xfb, 0xe8, 0xa6, 0x7f, 0x43, 0xbc, 0xef, 0x71, 0x83, 0x04, 0x36, 0xcc,
+  0x56, 0x65, 0x5e, 0xb0, 0xbf, 0x4c, 0x79, 0x8c, 0x37, 0xc7, 0x18, 0xf2,
+  0xd2, 0xa6, 0x70, 0xd5, 0xf2, 0x13, 0x95, 0x58, 0x59, 0x25, 0xe0, 0x63,
+  0xa4, 0x99, 0x84, 0xb7, 0x38, 0x7e, 0x5a, 0x4f, 0x9b, 0x97, 0x24, 0x25,
+  0x84, 0xb6, 0x01, 0xa6, 0x7f, 0xd0, 0x54, 0x54, 0xdc, 0x33, 0x1b, 0xff,
+  0x83, 0xf6, 0x46, 0x76, 0x67, 0xb7, 0xba, 0x99, 0x59, 0x20, 0x9b, 0x1b,
+  0x77, 0x81, 0x54, 0xb4, 0x23, 0xb3, 0x59, 0x9b, 0xcc, 0x52, 0x06, 0x13,
+  0x0f, 0x36, 0x57, 0xc4, 0xe4, 0xde, 0x4f, 0x17, 0x4d, 0xa8, 0xff, 0x04,
+  0x1f, 0xaf, 0xd0, 0x2d, 0x57, 0x76, 0x57, 0x0e, 0xa3, 0x7f, 0x6b, 0xe4,
+  0x69, 0x37, 0x45, 0xe6, 0xee, 0x96, 0xfe, 0xcb, 0x2a, 0xb2, 0x47, 0x1b,
+  0xd8, 0x9d, 0x7c, 0xb6, 0xcb, 0xf0, 0x66, 0x19, 0xb9, 0x65, 0x99, 0x12,
+  0x90, 0xb3, 0x75, 0xff, 0xbd, 0xe2, 0x99, 0xf7, 0xee, 0x71, 0xb5, 0xbc,
+  0xe7, 0x8a, 0x9b, 0x07, 0xdc, 0xaa, 0x18, 0x89, 0xc3, 0xae, 0x2a, 0xb8,
+  0x95, 0xd2, 0x4c, 0xb7, 0x67, 0xe7, 0xfb, 0x66, 0xd0, 0xa2, 0xc1, 0xfe,
+  0x99, 0xc8, 0x93, 0xd1, 0xe9, 0xb8, 0xcd, 0x35, 0xa7, 0x5b, 0xdd, 0xb9,
+  0x99, 0xc5, 0x87, 0x93, 0xe9, 0xba, 0xb7, 0x64, 0x7b, 0x06, 0x9e, 0xef,
+  0x92, 0x3b, 0x4f, 0x18, 0xb3, 0x31, 0xa4, 0x0d, 0xbd, 0xde, 0x3f, 0x89,
+  0x3d, 0x90, 0x7d, 0xbe, 0x28, 0x7c, 0x8b, 0x9c, 0xbe, 0x68, 0x24, 0xef,
+  0x86, 0x52, 0x16, 0x2f, 0x62, 0x6d, 0x8f, 0x9b, 0xfb, 0x97, 0x22, 0xee,
+  0x8a, 0x84, 0x3c, 0x24, 0xaa, 0xa2, 0x73, 0x91, 0x28, 0xa9, 0x00, 0x8c,
+  0x9b, 0x51, 0x4f, 0x88, 0x30, 0x6f, 0x3e, 0xe1, 0x6f, 0x26, 0x9c, 0xb7,
+  0x85, 0x6d, 0x45, 0xec, 0x50, 0xd4, 0x10, 0xed, 0x8f, 0x5a, 0x67, 0x62,
+  0x27, 0xc8, 0xe3, 0xdc, 0x66, 0x22, 0x6c, 0x0a, 0xdb, 0x49, 0x9e, 0xab,
+  0x47, 0x9e, 0x1b, 0x82, 0x73, 0x45, 0xb2, 0xcb, 0x99, 0xdf, 0x62, 0xd9,
+  0x5b, 0x7e, 0x35, 0xe0, 0x2d, 0xb8, 0x34, 0x8b, 0xc7, 0x1f, 0xd1, 0x22,
+  0x91, 0x44, 0x0d, 0x49, 0xa0, 0x1e, 0xec, 0x26, 0xe7, 0x12, 0xda, 0x24,
+  0xa5, 0xee, 0xae, 0xc1, 0x04, 0xcd, 0x00, 0x3b, 0xf9, 0xc8, 0x08, 0x43,
+  0x2e, 0x0a, 0x20, 0x05, 0x89, 0xe0, 0xdb, 0x63, 0x81, 0xe2, 0x5d, 0x8d,
+  0x14, 0x2b, 0x04, 0xd8, 0xde, 0xc1, 0xe8, 0x60, 0x90, 0x58, 0xdb, 0xd3,
+  0xd3, 0x9d, 0x91, 0xbc, 0x28, 0xd0, 0xd1, 0xf4, 0xe9, 0xae, 0x9f, 0xe1,
+  0x9c, 0x3e, 0x5c, 0x87, 0x5e, 0x61, 0xb8, 0x96, 0x9d, 0xc1, 0x72, 0x93,
+  0xde, 0x85, 0x8a, 0xe9, 0xfe, 0xf0, 0xf1, 0xf3, 0xe7, 0x2d, 0x79, 0x5e,
+  0x7b, 0xd0, 0xdb, 0x4f, 0xf6, 0xf7, 0xb1, 0xb6, 0xa0, 0x26, 0xda, 0xfc,
+  0x62, 0xf8, 0x1c, 0x2f, 0xb6, 0x5f, 0xab, 0x33, 0x73, 0x04, 0xb3, 0xfe,
+  0xf7, 0x86, 0xf4, 0x9b, 0xc8, 0xe7, 0xe0, 0x4f, 0xe9, 0x7d, 0xeb, 0x39,
+  0x7d, 0x2e, 0xf2, 0x16, 0x1e, 0xe6, 0x6d, 0x2c, 0xe7, 0x73, 0xf2, 0x64,
+  0xd1, 0x93, 0x8a, 0xcc, 0x73, 0x93, 0x56, 0xb3, 0x70, 0xb9, 0xfb, 0x83,
+  0xe1, 0x41, 0xdf, 0x72, 0x11, 0x4d, 0x46, 0x02, 0x1c, 0x9d, 0x27, 0x19,
+  0x8a, 0xc6, 0x00, 0xe1, 0x02, 0xa1, 0xee, 0x40, 0x07, 0x66, 0x46, 0x07,
+  0xcf, 0x9f, 0x0f, 0x68, 0x66, 0x4f, 0x9e, 0x3f, 0xef, 0x2d, 0x08, 0xf7,
+  0x3e, 0x73, 0x53, 0x3a, 0xf7, 0x13, 0xbd, 0xee, 0x88, 0xa6, 0x26, 0x3b,
+  0x27, 0xfe, 0x1d, 0xfa, 0xcd, 0x17, 0xc9, 0xfb, 0xd3, 0x8b, 0x23, 0xcf,
+  0x31, 0x83, 0xeb, 0xc5, 0x11, 0x43, 0x2f, 0x45, 0x14, 0x21, 0xd8, 0x15,
+  0x3a, 0x3f, 0xc1, 0xf0, 0x25, 0x9b, 0x24, 0x34, 0x26, 0x51, 0xac, 0xa2,
+  0x3e, 0xc1, 0x7f, 0x0b, 0x33, 0x22, 0xc8, 0x38, 0x9e, 0xe5, 0x97, 0x79,
+  0xe3, 0xc3, 0x36, 0xed, 0x98, 0xd3, 0xde, 0x85, 0x8b, 0x83, 0x13, 0xdd,
+  0x24, 0x9a, 0xb2, 0x5d, 0x53, 0x79, 0x07, 0x67, 0xc2, 0x6e, 0x93, 0x35,
+  0xb5, 0x1d, 0x14, 0x58, 0x64, 0x8b, 0x59, 0xad, 0x82, 0x90, 0x1f, 0x1f,
+  0xe2, 0x41, 0xb9, 0x2d, 0x30, 0x57, 0xb9, 0xaf, 0x74, 0x0a, 0x50, 0x4b,
+  0xfe, 0x74, 0x7f, 0x3c, 0x05, 0xee, 0x2c, 0x24, 0x62, 0x68, 0x61, 0x16,
+  0x8d, 0xe3, 0xa7, 0xca, 0x6e, 0xd7, 0xce, 0xe5, 0x69, 0xbd, 0x73, 0x05,
+  0x9d, 0x43, 0x80, 0x47, 0xc8, 0x4e, 0xfc, 0x59, 0xb6, 0xd2, 0x94, 0xd2,
+  0xa2, 0x3d, 0x8e, 0xa1, 0xe5, 0x79, 0x7e, 0xb9, 0xae, 0xe2, 0xe9, 0x97,
+  0x7f, 0x71, 0x65, 0x42, 0x0a, 0x32, 0x9f, 0xde, 0xa4, 0x5a, 0x9e, 0x84,
+  0xbe, 0x00, 0x7a, 0xaf, 0xd5, 0x08, 0xd6, 0x72, 0x20, 0xb4, 0x00, 0x08,
+  0x2c, 0x69, 0xf2, 0x4e, 0xcc, 0x8d, 0x26, 0x43, 0x4e, 0x02, 0x6d, 0x15,
+  0x08, 0xb7, 0x9e, 0x74, 0x83, 0x93, 0x0c, 0x1b, 0x71, 0x21, 0xd2, 0x79,
+  0x93, 0x38, 0x4d, 0x65, 0x0b, 0xc2, 0x9c, 0xba, 0xed, 0x85, 0xf3, 0xdd,
+  0xd3, 0x93, 0xf0, 0xb6, 0x5c, 0x95, 0x5e, 0x4f, 0x89, 0x10, 0xb4, 0x41,
+  0x40, 0x69, 0xc0, 0x7d, 0xf8, 0x88, 0x66, 0x46, 0x85, 0x5e, 0x94, 0x29,
+  0x1d, 0xa3, 0x7a, 0x4e, 0x38, 0x9a, 0xce, 0xda, 0x01, 0x23, 0x8e, 0xe9,
+  0xd9, 0x06, 0x59, 0x1d, 0x74, 0xd4, 0x72, 0xca, 0x84, 0xe5, 0xed, 0x40,
+  0x45, 0x40, 0xa4, 0x9e, 0x1b, 0x84, 0xf9, 0x94, 0xf9, 0x08, 0x23, 0x64,
+  0xec, 0x8e, 0x92, 0xd0, 0xec, 0x25, 0x82, 0xe7, 0xd3, 0xb2, 0x9d, 0x11,
+  0xd0, 0x63, 0x91, 0x84, 0x24, 0x4d, 0x58, 0xc5, 0xf1, 0xf8, 0xf8, 0xff,
+  0x39, 0xfa, 0x35, 0xa3, 0x4e, 0x55, 0x7a, 0x63, 0x0b, 0x07, 0xbf, 0x63,
+  0xc0, 0x4a, 0x89, 0x06, 0x59, 0xa4, 0x8a, 0x74, 0x21, 0x46, 0x3c, 0x35,
+  0xa3, 0x87, 0xf4, 0x40, 0x5c, 0x51, 0x5a, 0xa8, 0x1a, 0xc2, 0x0a, 0x69,
+  0x9b, 0xbc, 0x66, 0x04, 0xaf, 0xa0, 0x4e, 0x43, 0x24, 0xa3, 0xa3, 0xe4,
+  0x8b, 0x9d, 0x80, 0x7c, 0x90, 0x4b, 0xb8, 0x12, 0x61, 0xd9, 0x93, 0xb7,
+  0x97, 0x11, 0xa5, 0xc2, 0x70, 0x01, 0x20, 0x11, 0x69, 0x52, 0x66, 0xae,
+  0xf7, 0xf4, 0xb0, 0xf3, 0x2b, 0xed, 0x33, 0x06, 0xf0, 0xa7, 0x00, 0x55,
+  0x95, 0xbc, 0xfc, 0x70, 0x7e, 0xd2, 0x53, 0x2e, 0x39, 0xc6, 0x19, 0xd0,
+  0x66, 0x6d, 0x9d, 0x67, 0x40, 0x33, 0xab, 0x92, 0xb3, 0xf4, 0x32, 0xdb,
+  0xf2, 0x01, 0xe4, 0x54, 0x55, 0xc4, 0xf2, 0xc5, 0xff, 0x10, 0x73, 0xa7,
+  0xf8, 0x6d, 0x1a, 0x88, 0x89, 0xbb, 0xb0, 0xb0, 0x5f, 0xe3, 0x38, 0x5f,
+  0xa4, 0xb2, 0x77, 0xeb, 0x8a, 0x02, 0xfa, 0xd8, 0xf9, 0x48, 0xeb, 0x21,
+  0x7e, 0xbd, 0x8d, 0xfa, 0xe9, 0x32, 0x4c, 0x29, 0x12, 0x84, 0x46, 0xdc,
+  0x5b, 0x7f, 0x24, 0xf7, 0xfb, 0x96, 0x87, 0x74, 0x39, 0xcc, 0xc2, 0x20,
+  0x9b, 0x6e, 0x05, 0x63, 0x14, 0x5a, 0x57, 0x14, 0xbb, 0xf2, 0x5b, 0xee,
+  0xfb, 0x5a, 0x2e, 0xd8, 0xaa, 0xca, 0x08, 0x8f, 0x17, 0x19, 0xbc, 0x41,
+  0x6b, 0x29, 0x4e, 0x3b, 0x66, 0x08, 0x56, 0xb2, 0xff, 0x4e, 0x64, 0x7e,
+  0x2f, 0x24, 0xd2, 0xc2, 0x6a, 0x90, 0x9d, 0x9a, 0xc4, 0xa9, 0x79, 0xe2,
+  0x93, 0x2c, 0xb6, 0xd8, 0x74, 0x41, 0x0d, 0x54, 0xd8, 0xfb, 0x25, 0xa1,
+  0xf7, 0x59, 0x49, 0x3d, 0x37, 0xd0, 0xa3, 0xbb, 0xb0, 0xfe, 0xe4, 0xd6,
+  0xc9, 0xfe, 0xea, 0x50, 0x87, 0x2e, 0x00, 0xf4, 0x6a, 0x20, 0x5d, 0x81,
+  0x86, 0x86, 0x3a, 0x0a, 0xa9, 0x84, 0xf7, 0x8e, 0xd5, 0xa3, 0xbd, 0xff,
+  0xf4, 0x1a, 0x4d, 0x78, 0xcd, 0x22, 0x7a, 0x10, 0x73, 0xbd, 0xe9, 0x36,
+  0xa8, 0x52, 0x01, 0xc1, 0x04, 0xcd, 0x2a, 0x5c, 0xc1, 0xac, 0x48, 0xcb,
+  0xa8, 0x3b, 0x7f, 0xe8, 0x94, 0xa6, 0xd7, 0x5c, 0xb9, 0x39, 0x7c, 0x93,
+  0x1b, 0x19, 0x52, 0x33, 0x00, 0x11, 0x94, 0x5c, 0xae, 0x3d, 0xd4, 0x6b,
+  0x08, 0xdf, 0x48, 0x16, 0xa4, 0x2b, 0x70, 0x94, 0x04, 0x89, 0xcf, 0xf6,
+  0x1d, 0x1b, 0xb2, 0x31, 0x14, 0x71, 0xaf, 0xb3, 0xd8, 0x53, 0x18, 0x52,
+  0xe7, 0xaf, 0x90, 0x9e, 0xe1, 0xdc, 0xc3, 0x80, 0x6f, 0x87, 0x91, 0x08,
+  0x91, 0xdd, 0x51, 0x58, 0x20, 0x64, 0xcd, 0x38, 0xbc, 0x1e, 0xe9, 0xd9,
+  0x13, 0x98, 0x9a, 0xb6, 0x5b, 0x32, 0x4b, 0xa5, 0x80, 0xc4, 0x28, 0x2f,
+  0xc5, 0x36, 0x4e, 0xe1, 0xd8, 0x09, 0x83, 0xf0, 0x71, 0x69, 0xea, 0xd4,
+  0x0c, 0x6c, 0xe3, 0xe6, 0xda, 0x0b, 0x56, 0x7a, 0xbe, 0xc4, 0x05, 0xee,
+  0x5d, 0x6b, 0x55, 0x48, 0x1a, 0xf5, 0x09, 0x8f, 0x62, 0x03, 0x45, 0x29,
+  0x08, 0x2f, 0xb1, 0x10, 0x3a, 0xf2, 0x77, 0xcc, 0x13, 0x9e, 0x0c, 0xe4,
+  0x7c, 0x8d, 0xe4, 0xf7, 0x43, 0xd7, 0x79, 0x63, 0xe7, 0x2e, 0x33, 0xfa,
+  0xb5, 0x05, 0xd5, 0x52, 0x43, 0x2a, 0x52, 0xfd, 0x99, 0x70, 0x37, 0xc9,
+  0xba, 0x55, 0x98, 0x02, 0x13, 0xc4, 0x8b, 0x2c, 0xf2, 0x96, 0x1b, 0x2d,
+  0x00, 0x89, 0x96, 0x45, 0x76, 0x4b, 0x18, 0xe0, 0xfd, 0xc3, 0x85, 0x4a,
+  0xf6, 0x77, 0xaf, 0xce, 0xdf, 0x1f, 0xbf, 0xff, 0xea, 0x45, 0x72, 0x74,
+  0x9b, 0x55, 0x53, 0xea, 0x7b, 0xfc, 0xb7, 0xf5, 0x2c, 0x9f, 0x82, 0x4d,
+  0x48, 0x3f, 0x59, 0x3f, 0xe4, 0x6d, 0xac, 0x80, 0x4c, 0xfc, 0xab, 0x24,
+  0x70, 0x83, 0x42, 0x18, 0xc9, 0xe5, 0x25, 0xe0, 0x08, 0x63, 0x45, 0x95,
+  0x97, 0x6b, 0x8f, 0x7c, 0xa6, 0xdc, 0xe7, 0x0e, 0xb1, 0x00, 0xc4, 0x48,
+  0xaf, 0x64, 0xaf, 0xc9, 0xe9, 0x9a, 0xbc, 0x39, 0x39, 0x09, 0xa1, 0x7c,
+  0x39, 0x81, 0x94, 0x2d, 0x47, 0x94, 0xfa, 0x62, 0x08, 0x9b, 0x6f, 0x4a,
+  0xb1, 0x3c, 0x23, 0xfe, 0xb9, 0xcb, 0x9d, 0xc7, 0xf0, 0x00, 0x06, 0xf6,
+  0x5d, 0x98, 0xc9, 0x89, 0x34, 0x63, 0x24, 0x07, 0xe2, 0x84, 0xf3, 0x6a,
+  0x06, 0x5b, 0xc8, 0x70, 0xc8, 0x72, 0xde, 0x90, 0x7e, 0xd4, 0x92, 0xa4,
+  0xed, 0x2e, 0x32, 0x9b, 0x92, 0xc2, 0x38, 0x66, 0xd4, 0xc6, 0x89, 0x92,
+  0x90, 0x24, 0x72, 0x56, 0x0d, 0x41, 0xb2, 0x62, 0x88, 0xd6, 0x43, 0x48,
+  0x35, 0x0b, 0x12, 0x6a, 0x53, 0xdb, 0x4d, 0xb9, 0x26, 0x6e, 0x19, 0xb2,
+  0x8b, 0x9b, 0xac, 0x12, 0xd3, 0xd3, 0x16, 0x11, 0x1b, 0x66, 0x37, 0x4a,
+  0xc6, 0xa5, 0x79, 0x3e, 0x52, 0xb5, 0xa0, 0x3d, 0xfa, 0x5a, 0xcd, 0xbe,
+  0x39, 0x85, 0xd6, 0xe6, 0x55, 0xa1, 0x7f, 0x11, 0x62, 0x6e, 0xed, 0xf5,
+  0x46, 0xfa, 0x03, 0x13, 0xfd, 0x4f, 0x32, 0xab, 0x50, 0xdc, 0x69, 0x68,
+  0x87, 0x88, 0x64, 0x6b, 0x68, 0xd8, 0xe9, 0x16, 0xed, 0x2c, 0xba, 0x16,
+  0x7b, 0x23, 0xdd, 0xd3, 0x7b, 0xd3, 0x4f, 0x53, 0xef, 0x2e, 0xf8, 0x9e,
+  0x96, 0x66, 0x6a, 0x75, 0x7a, 0x8e, 0x53, 0x69, 0x2c, 0x65, 0x63, 0xa5,
+  0xcc, 0x93, 0x32, 0xb4, 0x20, 0x0e, 0x02, 0xe0, 0x6c, 0x4e, 0x58, 0x77,
+  0x8c, 0x5f, 0x28, 0xef, 0xbf, 0x2e, 0xf2, 0x66, 0xe0, 0xbc, 0x0b, 0xa4,
+  0x15, 0x04, 0xe5, 0xda, 0xc6, 0xc6, 0x1b, 0xed, 0xc6, 0xf2, 0x6a, 0x84,
+  0x2f, 0x0a, 0x90, 0x6b, 0x7a, 0xed, 0xf2, 0xbd, 0x7a, 0x39, 0xdf, 0x48,
+  0xf3, 0xe3, 0xbb, 0x32, 0x1a, 0x90, 0x07, 0x9e, 0x3f, 0x9c, 0x87, 0x03,
+  0x33, 0xf1, 0x8b, 0x59, 0xbc, 0x68, 0xa5, 0xc3, 0x25, 0x08, 0x87, 0xf3,
+  0x0a, 0xbe, 0xfa, 0x99, 0xb0, 0x44, 0x6d, 0xf2, 0xe2, 0xba, 0xfc, 0xc4,
+  0xf2, 0x9e, 0x5b, 0x1b, 0xc6, 0x52, 0x54, 0xf2, 0xde, 0xb2, 0x16, 0xf6,
+  0x4b, 0xf1, 0xae, 0xca, 0xdc, 0x59, 0x64, 0x79, 0x95, 0x04, 0x66, 0x31,
+  0x12, 0x8c, 0xb1, 0x25, 0x80, 0x56, 0x3c, 0x75, 0xf3, 0xfd, 0xf5, 0x2e,
+  0x0d, 0xb4, 0x01, 0x75, 0x92, 0x2d, 0xea, 0x6c, 0xe0, 0x55, 0x03, 0xaa,
+  0xb0, 0x51, 0x69, 0x83, 0xe4, 0x4f, 0xed, 0x24, 0xd7, 0x2f, 0x49, 0x46,
+  0xae, 0x36, 0xc1, 0xdb, 0x6e, 0x67, 0xc4, 0x22, 0xb8, 0xc9, 0x51, 0xa7,
+  0xe9, 0x55, 0x59, 0x46, 0xc5, 0xb6, 0x93, 0x21, 0x50, 0x69, 0x00, 0x88,
+  0xd1, 0xa3, 0x3f, 0xb4, 0x5b, 0x1b, 0x4a, 0x32, 0x79, 0xf7, 0xee, 0x29,
+  0xd4, 0xa0, 0x68, 0x83, 0x1e, 0x40, 0x69, 0x5b, 0xba, 0xf1, 0x84, 0x02,
+  0xd9, 0x1c, 0x4b, 0x5e, 0xe0, 0xdf, 0x75, 0xe4, 0x71, 0xd3, 0x42, 0x4f,
+  0xf0, 0x37, 0x25, 0x2a, 0xec, 0x38, 0x01, 0xcd, 0xa5, 0x25, 0x82, 0x6e,
+  0x60, 0x34, 0x15, 0xed, 0x80, 0x06, 0xe6, 0x99, 0x37, 0x60, 0x20, 0xbf,
+  0x3f, 0xdc, 0xef, 0x63, 0xf2, 0xac, 0xc6, 0x6a, 0x95, 0x2b, 0x5d, 0x47,
+  0x6b, 0x9c, 0xb3, 0x20, 0x74, 0x85, 0x01, 0x24, 0x40, 0xd6, 0xab, 0x04,
+  0xad, 0xaf, 0xa8, 0x69, 0x5a, 0xcf, 0xfe, 0x47, 0xad, 0xe2, 0x9f, 0xdb,
+  0x2a, 0xaf, 0xaf, 0x57, 0x9e, 0xe3, 0x5f, 0xe7, 0xde, 0x19, 0xd3, 0x48,
+  0xd1, 0xf2, 0x5a, 0xe6, 0x25, 0x9e, 0xab, 0xc4, 0xd3, 0xd9, 0x9d, 0xde,
+  0x00, 0xcb, 0x1e, 0xcc, 0x8e, 0x73, 0x0c, 0xf2, 0x90, 0x25, 0x1b, 0x9b,
+  0x76, 0xb9, 0x8a, 0x30, 0x2c, 0x7b, 0x09, 0x34, 0x4b, 0x25, 0x75, 0x68,
+  0x97, 0xa9, 0xb0, 0x47, 0xc3, 0x39, 0x43, 0xf4, 0x15, 0xe1, 0xa4, 0x6c,
+  0x8c, 0xa7, 0x92, 0xad, 0x89, 0x1d, 0xa1, 0x2f, 0xb5, 0x05, 0x23, 0xb2,
+  0xce, 0x86, 0x51, 0x6f, 0xbf, 0x62, 0xd6, 0x84, 0xe0, 0x67, 0xb0, 0xa4,
+  0x1c, 0x18, 0xfe, 0x16, 0xbf, 0xbe, 0x95, 0xec, 0x10, 0x57, 0xdd, 0x55,
+  0xed, 0x35, 0xac, 0x7f, 0x76, 0x35, 0x75, 0x60, 0xbf, 0x69, 0x1d, 0x64,
+  0xce, 0x42, 0x7b, 0x4d, 0x8c, 0x91, 0x57, 0x19, 0x05, 0x60, 0xbd, 0x48,
+  0x2b, 0xa9, 0x1c, 0x9c, 0xaf, 0x17, 0x31, 0x33, 0x07, 0x37, 0x5b, 0x63,
+  0x43, 0x66, 0x8b, 0xea, 0xb5, 0xf6, 0x12, 0x70, 0x38, 0x33, 0x02, 0x3a,
+  0xb8, 0x30, 0x33, 0x42, 0x41, 0xcb, 0x82, 0x5b, 0x9c, 0x45, 0x29, 0x17,
+  0xae, 0x61, 0xec, 0x99, 0x2a, 0x98, 0x6c, 0x45, 0xf1, 0xdc, 0xaa, 0xec,
+  0x92, 0xa6, 0xe4, 0xda, 0xa8, 0xd1, 0x16, 0x50, 0x33, 0xef, 0x3c, 0x48,
+  0x1a, 0xdc, 0x3a, 0x3d, 0xbb, 0x38, 0x3e, 0x7d, 0x3f, 0x4e, 0xfe, 0x7d,
+  0x6b, 0x63, 0x79, 0x57, 0x1b, 0x58, 0xf9, 0xfb, 0x81, 0x3b, 0x93, 0xe4,
+  0xa5, 0xf8, 0x19, 0xfa, 0x6c, 0x63, 0x4f, 0x83, 0x9f, 0x1a, 0xe9, 0x6d,
+  0xd8, 0xab, 0xbe, 0x29, 0xd8, 0x6e, 0x72, 0x58, 0x1d, 0x24, 0x83, 0x40,
+  0x5b, 0xf6, 0x61, 0x1f, 0x7c, 0x1b, 0x9a, 0x79, 0xbd, 0x33, 0x59, 0x3a,
+  0xa3, 0xf7, 0x70, 0x60, 0xc6, 0x22, 0x69, 0xd9, 0x2f, 0xd8, 0x3b, 0x79,
+  0x0b, 0xdb, 0x7c, 0x43, 0xba, 0x29, 0x1e, 0xdc, 0x91, 0x46, 0xf4, 0xac,
+  0x68, 0xd5, 0x61, 0x86, 0xe0, 0x57, 0x47, 0x17, 0xbb, 0x52, 0xe8, 0x6a,
+  0xe7, 0x07, 0x4f, 0x97, 0xa8, 0x3d, 0xa9, 0xd5, 0xcc, 0xb4, 0xb4, 0x95,
+  0x81, 0xdc, 0x8c, 0xf6, 0xbc, 0x48, 0x8b, 0x68, 0x09, 0x1b, 0x69, 0xb4,
+  0xaf, 0xcd, 0x76, 0x10, 0x1f, 0x56, 0x8e, 0xac, 0xde, 0x13, 0xaf, 0x7f,
+  0x0e, 0xe3, 0x32, 0x9d, 0x7d, 0xb8, 0xc0, 0x80, 0x6f, 0x8e, 0x4e, 0x8e,
+  0x2e, 0x8e, 0xba, 0x96, 0xfb, 0x84, 0xc1, 0x2c, 0x51, 0xea, 0xd2, 0x64,
+  0xd3, 0xab, 0xa2, 0x5c, 0x94, 0x97, 0xb9, 0x34, 0x08, 0x4d, 0xbe, 0xcb,
+  0x26, 0x6f, 0x5e, 0x7d, 0x4b, 0xfa, 0x04, 0x79, 0x9c, 0xce, 0xce, 0x4f,
+  0xcf, 0xde, 0x1e, 0xbf, 0x7f, 0x33, 0x48, 0x5e, 0x9f, 0x9e, 0xfd, 0x65,
+  0x90, 0xbc, 0x3b, 0xfd, 0xf6, 0x28, 0x92, 0xe2, 0x4c, 0x08, 0xb7, 0x01,
+  0xc5, 0xd8, 0x56, 0x7d, 0x2c, 0xce, 0xd8, 0xf4, 0x46, 0x5b, 0xf0, 0x8e,
+  0x18, 0xa1, 0x1a, 0x80, 0xba, 0x14, 0x7e, 0x6b, 0xf6, 0x6e, 0x90, 0x7c,
+  0x7d, 0xf4, 0xea, 0xcd, 0x20, 0x00, 0x30, 0x1f, 0xf3, 0xaa, 0x68, 0x75,
+  0x76, 0xc9, 0x80, 0xbd, 0x66, 0xeb, 0x03, 0x3a, 0x02, 0x07, 0xb9, 0xf8,
+  0xca, 0x1a, 0x82, 0x45, 0x91, 0xfe, 0xac, 0x2f, 0x73, 0x42, 0x90, 0xf8,
+  0x7b, 0x5b, 0xf2, 0xb6, 0xca, 0x2e, 0xa0, 0xae, 0xf9, 0x8a, 0xb6, 0xc0,
+  0x35, 0x21, 0xb3, 0x5e, 0xeb, 0xb0, 0xec, 0x71, 0xf7, 0x20, 0x06, 0x0d,
+  0x5a, 0x48, 0x01, 0x60, 0x47, 0xec, 0x7a, 0x4c, 0xa5, 0xa3, 0x21, 0x7a,
+  0x16, 0x19, 0x33, 0x89, 0xb4, 0xea, 0xb9, 0x43, 0x89, 0x8d, 0x6b, 0xd8,
+  0xaa, 0x22, 0x94, 0x0a, 0xa6, 0x2e, 0xc0, 0x4d, 0xb4, 0x7d, 0xba, 0x45,
+  0x03, 0xed, 0x18, 0xf3, 0x3d, 0xff, 0x58, 0x65, 0x6c, 0x50, 0x69, 0x3d,
+  0x37, 0x84, 0x99, 0x71, 0xca, 0x14, 0xce, 0xc8, 0xb9, 0x05, 0x92, 0xe1,
+  0xb1, 0x3a, 0x25, 0x36, 0x29, 0x58, 0x72, 0x59, 0xc4, 0x31, 0x03, 0xa0,
+  0x28, 0x75, 0x58, 0xb5, 0x79, 0x84, 0x6b, 0xa8, 0xcb, 0xf7, 0x6e, 0x1e,
+  0xf0, 0x35, 0xd2, 0xf7, 0xed, 0x19, 0x0f, 0x04, 0xe8, 0xc2, 0xd6, 0x4f,
+  0xf8, 0xfb, 0x82, 0xec, 0xdb, 0xb6, 0x3f, 0xcb, 0x48, 0xd8, 0x40, 0xb8,
+  0xd0, 0x63, 0x86, 0x93, 0x14, 0xe2, 0x10, 0xa5, 0xc0, 0xdb, 0x90, 0x2d,
+  0x69, 0x3f, 0xe7, 0x57, 0xd9, 0xa7, 0xaa, 0xa6, 0x3a, 0x85, 0x78, 0x0b,
+  0xf9, 0x56, 0x0b, 0x66, 0x7b, 0xf0, 0x8f, 0xf6, 0x6f, 0x9d, 0x8f, 0x9d,
+  0x74, 0x89, 0x3a, 0x19, 0x0a, 0xde, 0x37, 0x8a, 0xf7, 0x82, 0xad, 0xdb,
+  0x79, 0xdb, 0xc3, 0x18, 0x7d, 0xaf, 0xad, 0xad, 0xe8, 0xb7, 0xd9, 0xe6,
+  0x27, 0xc7, 0xe6, 0x3a, 0x44, 0xa0, 0x71, 0x66, 0x25, 0x1a, 0x0d, 0x23,
+  0xcd, 0x20, 0x57, 0x51, 0x42, 0x63, 0x85, 0x1f, 0xa6, 0xce, 0xdb, 0xd1,
+  0x2f, 0xa3, 0x25, 0xf7, 0x3d, 0x9f, 0x0e, 0xce, 0xec, 0xfc, 0xe8, 0xe2,
+  0x7c, 0x94, 0xec, 0xf8, 0x98, 0xaf, 0x4f, 0x47, 0xfb, 0x61, 0xd0, 0x86,
+  0x9a, 0x7e, 0xef, 0x26, 0xde, 0x67, 0xdd, 0x77, 0xd1, 0x0f, 0x7c, 0xf3,
+  0x77, 0xc3, 0x3c, 0x62, 0x0f, 0xe9, 0x69, 0x3f, 0xf6, 0x3d, 0xbf, 0xb5,
+  0x78, 0x6b, 0x95, 0xf4, 0x8b, 0x0d, 0x5f, 0xfb, 0xfa, 0xe8, 0xe4, 0x2c,
+  0x5c, 0xe5, 0xb7, 0xe7, 0x6f, 0xff, 0xd2, 0x5e, 0xe5, 0xa3, 0xc7, 0x91,
+  0xaf, 0xfe, 0x92, 0x0e, 0xf5, 0xac, 0x2e, 0x17, 0x46, 0x5f, 0x41, 0x15,
+  0x07, 0x8a, 0x38, 0x5e, 0x18, 0x01, 0x40, 0xb9, 0xe6, 0x7f, 0x1d, 0xc8,
+  0x5f, 0x7e, 0x1c, 0x8d, 0x46, 0x7f, 0x0a, 0x51, 0xd1, 0xe1, 0xa3, 0x71,
+  0xeb, 0x95, 0x87, 0xbb, 0x26, 0x38, 0xaa, 0x66, 0x50, 0x26, 0x44, 0x91,
+  0x8b, 0x55, 0x9a, 0x57, 0x54, 0xf2, 0x18, 0x13, 0xb8, 0xb4, 0x22, 0x57,
+  0xe8, 0x65, 0xb5, 0x39, 0x01, 0x04, 0xe3, 0xcb, 0xba, 0x53, 0xef, 0x4a,
+  0x55, 0xb5, 0x57, 0x4f, 0x92, 0xce, 0x02, 0x47, 0x08, 0x37, 0x47, 0xc1,
+  0x67, 0x2b, 0x72, 0xd0, 0xb2, 0xa2, 0xe9, 0x04, 0x6d, 0xa1, 0xc2, 0x43,
+  0x96, 0x3f, 0xb3, 0xd3, 0x8f, 0x79, 0x2f, 0xb8, 0x4e, 0xf2, 0xb5, 0x44,
+  0xd4, 0x61, 0x7f, 0x41, 0xa2, 0xa0, 0xcf, 0x6c, 0xd6, 0x4c, 0xf7, 0x68,
+  0x91, 0x75, 0xd0, 0x0b, 0x89, 0x95, 0xb8, 0xd0, 0x89, 0x24, 0x58, 0x2b,
+  0x5e, 0x09, 0x2d, 0x67, 0xb7, 0x78, 0x35, 0x09, 0xae, 0x8a, 0xd7, 0xd3,
+  0xd5, 0xd5, 0x39, 0x12, 0xeb, 0xe1, 0xa2, 0xdb, 0x6d, 0x2b, 0x47, 0x80,
+  0x9e, 0x56, 0xd6, 0x4d, 0xeb, 0xe0, 0xe9, 0x6d, 0xb2, 0x01, 0x9b, 0x44,
+  0x0b, 0xd5, 0x42, 0xb5, 0x1f, 0xdc, 0x59, 0x29, 0x89, 0xf2, 0x28, 0x80,
+  0x3e, 0x3e, 0x6f, 0xf9, 0x5c, 0xd4, 0x43, 0xe7, 0x9f, 0x39, 0xa6, 0x11,
+  0xfa, 0x35, 0x30, 0x07, 0x46, 0x12, 0x57, 0x03, 0x9e, 0x16, 0x1a, 0xca,
+  0xc3, 0x3f, 0xb7, 0xaa, 0xcc, 0xb7, 0xff, 0x7d, 0x9b, 0x54, 0x61, 0xbc,
+  0x1d, 0xad, 0x6d, 0x57, 0xba, 0x25, 0xc3, 0x06, 0x8f, 0x45, 0xf4, 0x06,
+  0xb7, 0x2b, 0x4a, 0x7b, 0x36, 0x5d, 0xca, 0x52, 0x8f, 0x2c, 0x61, 0x94,
+  0x7c, 0x97, 0x2f, 0x66, 0xd3, 0xb4, 0x42, 0x7a, 0x58, 0x28, 0x5e, 0x85,
+  0x4a, 0x70, 0x9d, 0xea, 0x12, 0x5f, 0x75, 0x77, 0x47, 0x7b, 0xc9, 0xc4,
+  0x69, 0x3e, 0x56, 0xf4, 0x63, 0xcf, 0x83, 0x82, 0xdf, 0x3d, 0x4d, 0xbb,
+  0x84, 0x7e, 0x74, 0x8f, 0x49, 0xda, 0xb5, 0x5b, 0x78, 0xb4, 0x8f, 0x56,
+  0xe3, 0x10, 0xc3, 0xc7, 0x61, 0x2c, 0x25, 0x5f, 0x5d, 0x3f, 0x86, 0xfb,
+  0xea, 0xe9, 0x80, 0xff, 0xf5, 0x94, 0xc1, 0x21, 0x1b, 0x2b, 0xdc, 0xb1,
+  0xad, 0x6c, 0xc6, 0xb0, 0xd6, 0x7f, 0x7c, 0xa6, 0x15, 0xae, 0x5d, 0x9e,
+  0x38, 0x96, 0x28, 0xa4, 0xe0, 0x23, 0x98, 0x59, 0xaa, 0x01, 0x63, 0xde,
+  0xd1, 0xd9, 0xd2, 0x96, 0x18, 0xfe, 0xf5, 0xd7, 0x49, 0x45, 0xb0, 0x23,
+  0x4d, 0xfd, 0xe3, 0xa6, 0x7a, 0x62, 0xa3, 0xf3, 0x3f, 0x1b, 0x85, 0x75,
+  0x5b, 0x63, 0x1f, 0xfa, 0xdc, 0x7d, 0xc9, 0xe6, 0xfb, 0xba, 0xcf, 0x51,
+  0x86, 0x3f, 0xc2, 0x76, 0x94, 0xf5, 0xb3, 0xf9, 0x43, 0xcf, 0x37, 0x7c,
+  0x68, 0x0e, 0x60, 0x23, 0x3a, 0x53, 0x6b, 0x00, 0xdc, 0x28, 0x55, 0xf8,
+  0x35, 0xca, 0x66, 0x9c, 0xa7, 0x8f, 0x47, 0xfb, 0x0f, 0xcf, 0x50, 0x76,
+  0xd6, 0x37, 0x79, 0xf6, 0x66, 0xf2, 0x13, 0x90, 0x89, 0xa4, 0x88, 0x95,
+  0x7d, 0x34, 0xb7, 0xb1, 0x33, 0x06, 0xc1, 0xe6, 0xb4, 0x78, 0xb9, 0x59,
+  0x3f, 0x4a, 0x84, 0x2a, 0x63, 0x1c, 0xd6, 0xc1, 0x0e, 0x1c, 0x7b, 0xda,
+  0xbd, 0xde, 0x04, 0x3e, 0x6d, 0x4a, 0x1d, 0xc1, 0x8f, 0x09, 0x7f, 0x41,
+  0xf9, 0xdc, 0x11, 0xd5, 0x31, 0x9d, 0x1f, 0xbd, 0xfd, 0x30, 0x3e, 0x7a,
+  0x03, 0xb8, 0xcd, 0x58, 0x3f, 0xa5, 0x9c, 0x6e, 0x34, 0x47, 0x26, 0x9a,
+  0x92, 0x95, 0x4a, 0x99, 0x48, 0xbb, 0xe1, 0x20, 0xf7, 0xc8, 0x84, 0x42,
+  0xd6, 0x94, 0xc6, 0x30, 0x0e, 0xeb, 0x4e, 0x58, 0x95, 0x93, 0x77, 0x7f,
+  0x02, 0xee, 0x08, 0xaf, 0x7a, 0x96, 0x51, 0x73, 0xae, 0x97, 0x9c, 0x05,
+  0x13, 0x80, 0xaa, 0xbd, 0xf3, 0xb2, 0xd8, 0xeb, 0x45, 0x96, 0xad, 0x34,
+  0xe8, 0x9f, 0x2e, 0xcb, 0x75, 0xc1, 0x9e, 0x51, 0x73, 0x3e, 0xea, 0x0f,
+  0x84, 0xf7, 0x19, 0xe3, 0xb2, 0xfa, 0x96, 0xf6, 0x74, 0x92, 0x82, 0xd3,
+  0x87, 0xf2, 0xd5, 0x1d, 0x60, 0x40, 0x77, 0x53, 0x76, 0xf2, 0xc6, 0xaa,
+  0xf5, 0x0a, 0x3f, 0x1e, 0x74, 0xd5, 0x63, 0x38, 0x72, 0x42, 0xe8, 0x31,
+  0x86, 0x11, 0x63, 0x55, 0x92, 0x96, 0x7a, 0x59, 0x56, 0x66, 0xd0, 0xa5,
+  0x2d, 0x56, 0x64, 0x44, 0x87, 0x7a, 0xb7, 0xdb, 0xca, 0xb1, 0x6b, 0xb6,
+  0x93, 0x2d, 0x81, 0x08, 0x78, 0xc6, 0xf5, 0xdb, 0xc4, 0x15, 0x78, 0x9b,
+  0xe0, 0x31, 0xa1, 0xe8, 0x20, 0x8b, 0xb4, 0xb1, 0x54, 0x5d, 0x63, 0x2f,
+  0x78, 0x07, 0x43, 0x73, 0x93, 0xba, 0x8e, 0x74, 0x9d, 0x39, 0xaa, 0xba,
+  0x6b, 0x34, 0x40, 0xa7, 0x4e, 0x33, 0xff, 0x2d, 0xbb, 0xb9, 0x1d, 0x1c,
+  0xc6, 0x6e, 0xc0, 0x32, 0xbd, 0x85, 0x8b, 0xaa, 0x97, 0x1c, 0xc4, 0x61,
+  0x4b, 0x1b, 0x42, 0xcf, 0x55, 0xcc, 0xf3, 0xc1, 0x61, 0x5d, 0xe9, 0x0b,
+  0x27, 0x26, 0xd9, 0xa3, 0x16, 0xff, 0x15, 0x19, 0xde, 0x61, 0xe8, 0x11,
+  0x50, 0x59, 0x32, 0x67, 0x78, 0x09, 0x53, 0x5a, 0x24, 0xd9, 0x6f, 0x3b,
+  0xdc, 0x58, 0x0a, 0x1f, 0xdb, 0xa5, 0x1f, 0x2f, 0x4a, 0x8a, 0x51, 0x2a,
+  0x31, 0xe0, 0xf3, 0x21, 0x64, 0x1f, 0x99, 0x09, 0x15, 0x51, 0x21, 0x32,
+  0xf0, 0x6c, 0xe2, 0x0d, 0x9a, 0xd9, 0xa0, 0x58, 0x8c, 0xf0, 0xcb, 0xd8,
+  0x05, 0x36, 0xb7, 0x3e, 0xb4, 0x4a, 0xde, 0x0c, 0x72, 0x58, 0x75, 0x9c,
+  0x8c, 0x07, 0x18, 0xb4, 0x61, 0x95, 0x65, 0xda, 0xa8, 0xcd, 0x84, 0x9f,
+  0x80, 0x7b, 0xa9, 0x69, 0x8d, 0x7c, 0x44, 0x55, 0x63, 0xb0, 0x01, 0x72,
+  0x35, 0xa2, 0xb6, 0x89, 0x56, 0x04, 0x43, 0x33, 0x2d, 0xfc, 0xc9, 0xe2,
+  0x04, 0xcc, 0x20, 0x79, 0x39, 0x43, 0x55, 0x14, 0x77, 0xe2, 0xe9, 0x81,
+  0x8f, 0x91, 0xd9, 0x6c, 0x93, 0xab, 0xf2, 0x36, 0x5f, 0xae, 0x97, 0x78,
+  0x7d, 0xc0, 0x06, 0xd8, 0x92, 0xa4, 0x96, 0x1e, 0x2a, 0xb2, 0x0b, 0x6d,
+  0xdb, 0xaf, 0x98, 0x33, 0x83, 0x58, 0x1b, 0x88, 0xb6, 0xe1, 0x94, 0x1f,
+  0x7a, 0x8b, 0x5b, 0x6c, 0xe0, 0xa0, 0xfe, 0xa7, 0xd3, 0x67, 0xf2, 0xd2,
+  0x28, 0x74, 0x7f, 0x8a, 0x44, 0xa3, 0x53, 0x9f, 0xa7, 0x0a, 0xff, 0x00,
+  0x65, 0x52, 0xaa, 0x73, 0x36, 0xf3, 0x4c, 0x49, 0xa6, 0x38, 0xd2, 0xc4,
+  0xf8, 0x90, 0x7a, 0x39, 0xd4, 0xc0, 0x3a, 0xbe, 0x85, 0xdc, 0x69, 0xa1,
+  0xce, 0xf7, 0xcb, 0x42, 0x49, 0x88, 0x9e, 0xce, 0x4d, 0x3a, 0x8f, 0x04,
+  0x32, 0x5f, 0xe1, 0x19, 0x40, 0xb4, 0xf2, 0xbe, 0xf9, 0xfc, 0xbe, 0x24,
+  0xc5, 0x88, 0x7d, 0x4b, 0x1e, 0x73, 0xd9, 0x65, 0x75, 0x63, 0xb5, 0x7b,
+  0x85, 0xd8, 0x70, 0x20, 0xd8, 0x06, 0x31, 0xb2, 0x0e, 0xbb, 0x64, 0xb5,
+  0x94, 0xa1, 0x90, 0x5e, 0x10, 0x3b, 0xe5, 0xb3, 0x1b, 0x70, 0xb2, 0x26,
+  0x32, 0x34, 0x1f, 0xdf, 0xde, 0x06, 0x14, 0xee, 0x19, 0xc4, 0x8c, 0x37,
+  0xc9, 0xd6, 0xf2, 0xe3, 0x7d, 0x94, 0x39, 0x3e, 0xb9, 0xed, 0x18, 0xcd,
+  0xa3, 0x38, 0x38, 0x24, 0xcb, 0x07, 0x62, 0x91, 0x93, 0x92, 0xa3, 0x70,
+  0xbc, 0x69, 0x69, 0x64, 0x3b, 0x99, 0x3b, 0xdc, 0xa4, 0x39, 0x08, 0x22,
+  0x48, 0x6d, 0x40, 0x2e, 0xa6, 0x6d, 0xf6, 0xaa, 0x51, 0x52, 0x34, 0x2d,
+  0x34, 0x9a, 0x3f, 0x6d, 0xa5, 0xee, 0x93, 0xcd, 0x03, 0x98, 0x95, 0x6b,
+  0x40, 0x61, 0x84, 0xdb, 0x45, 0x5f, 0xe1, 0xdd, 0xa7, 0x2b, 0x65, 0xe4,
+  0x55, 0xbe, 0xa0, 0xd7, 0xf8, 0x62, 0xd7, 0xc9, 0x81, 0x39, 0x85, 0xbc,
+  0x58, 0x37, 0x16, 0xae, 0x0f, 0xdf, 0xb4, 0xb0, 0x33, 0x91, 0xdd, 0x5f,
+  0x20, 0xd1, 0x57, 0x2b, 0xe0, 0xe9, 0xf6, 0xd5, 0x5e, 0x74, 0x90, 0x6f,
+  0x09, 0x34, 0x72, 0xdb, 0xd3, 0xd9, 0x97, 0xb2, 0x31, 0x57, 0x91, 0x0d,
+  0xc3, 0x8a, 0x5c, 0xcd, 0x6e, 0xcd, 0x6e, 0x33, 0x8a, 0x92, 0x27, 0xd8,
+  0xac, 0x48, 0x1b, 0x79, 0x5d, 0x28, 0x22, 0x99, 0x3f, 0x2d, 0x26, 0x6e,
+  0x9b, 0x78, 0x81, 0xcf, 0x95, 0x8d, 0x5c, 0x49, 0xdb, 0x7c, 0x8d, 0xb5,
+  0xb6, 0xff, 0xe9, 0x57, 0xbb, 0x4e, 0xeb, 0xc5, 0x30, 0xef, 0xf2, 0xf2,
+  0x23, 0xe4, 0x12, 0xda, 0x5c, 0x20, 0x4b, 0x85, 0x66, 0x88, 0xf1, 0xab,
+  0xf1, 0x49, 0x07, 0xcb, 0x6b, 0x23, 0xd0, 0xf4, 0x41, 0x5b, 0xed, 0x79,
+  0x20, 0x1a, 0xe6, 0x4f, 0x06, 0xc3, 0x64, 0x74, 0xe2, 0xbe, 0x06, 0x7f,
+  0xf5, 0x0b, 0x7c, 0xdc, 0x61, 0xee, 0x06, 0x53, 0x61, 0xfc, 0x22, 0xd4,
+  0x6c, 0x70, 0x27, 0x46, 0x36, 0xa0, 0x23, 0x18, 0x47, 0xb3, 0x3d, 0x49,
+  0x01, 0xba, 0x2f, 0x92, 0xce, 0x10, 0x9b, 0xba, 0xf2, 0x31, 0x49, 0x03,
+  0xea, 0x54, 0x3a, 0x8c, 0xc1, 0xf5, 0xd8, 0xa4, 0x40, 0xd1, 0x27, 0x6b,
+  0x3c, 0x4d, 0x09, 0x41, 0xec, 0x1d, 0xf5, 0xf8, 0x15, 0x8d, 0xe1, 0xf2,
+  0x6a, 0x08, 0xe8, 0x3d, 0x84, 0x85, 0xe7, 0x70, 0xeb, 0x9c, 0x9b, 0x41,
+  0xea, 0x0c, 0xbc, 0x31, 0xbb, 0x7c, 0x32, 0xe7, 0x5e, 0x01, 0x55, 0xf2,
+  0xf7, 0x75, 0x9e, 0x35, 0x28, 0xba, 0x1a, 0x25, 0x6f, 0x38, 0x2d, 0x4c,
+  0x3a, 0x2a, 0x72, 0xe7, 0x56, 0xb4, 0x77, 0xe5, 0x52, 0x67, 0xfe, 0x3e,
+  0x4d, 0x20, 0xb0, 0x00, 0xcc, 0x84, 0x50, 0xcd, 0xf7, 0x0e, 0xb3, 0x4e,
+  0x5e, 0xd3, 0xb4, 0x97, 0xe6, 0xa6, 0x03, 0x6b, 0xc6, 0x43, 0x11, 0xd3,
+  0xbc, 0x01, 0xcd, 0xe4, 0x47, 0xb2, 0x6a, 0xfd, 0x29, 0xcc, 0xd5, 0x1f,
+  0xb4, 0x3a, 0x52, 0xc1, 0x66, 0x14, 0x43, 0xa0, 0xa1, 0x76, 0x66, 0x45,
+  0xba, 0xd8, 0xab, 0x9b, 0x19, 0x71, 0xbf, 0x75, 0xb1, 0xa0, 0x79, 0xd2,
+  0x48, 0x3d, 0xfd, 0x11, 0x23, 0x78, 0x3b, 0xc0, 0xfb, 0xa0, 0x13, 0x6a,
+  0x1d, 0x91, 0xc4, 0xf0, 0xfb, 0x22, 0xbd, 0x5e, 0x16, 0x47, 0x08, 0xfe,
+  0xe3, 0xef, 0x16, 0xb9, 0x11, 0x78, 0xbd, 0xd8, 0xcb, 0xd6, 0xb9, 0x6d,
+  0x82, 0x42, 0xb8, 0xa6, 0xf3, 0x32, 0x84, 0x36, 0x29, 0x6b, 0x05, 0x89,
+  0x36, 0x8b, 0x34, 0xaf, 0xb7, 0xee, 0x13, 0xa0, 0xb6, 0xee, 0x45, 0x33,
+  0x89, 0xb4, 0x19, 0x7f, 0x7c, 0x2f, 0x8c, 0x09, 0xbf, 0x11, 0x36, 0xd3,
+  0xfe, 0xc9, 0x40, 0x26, 0x71, 0xa4, 0x26, 0x32, 0x26, 0x6d, 0xf2, 0xa3,
+  0x64, 0x35, 0xb5, 0x50, 0x3d, 0x38, 0xe6, 0x7b, 0x17, 0x69, 0x45, 0x68,
+  0x88, 0x69, 0x2d, 0x18, 0x08, 0xd3, 0x85, 0x61, 0xf6, 0x11, 0x83, 0x53,
+  0x7b, 0x50, 0x12, 0xdc, 0xd7, 0xa0, 0xcb, 0x4e, 0xeb, 0x35, 0x69, 0x20,
+  0x8b, 0x35, 0x7d, 0x99, 0x91, 0xb2, 0x2c, 0x52, 0x93, 0x96, 0x6e, 0x47,
+  0xd1, 0xcd, 0x2c, 0x1e, 0x0a, 0xdd, 0x51, 0x0f, 0xe8, 0x4d, 0xb1, 0x4b,
+  0x2d, 0x06, 0x5a, 0x17, 0x2c, 0x6c, 0xd4, 0x33, 0x3b, 0xb2, 0x0a, 0x07,
+  0x7e, 0xeb, 0x78, 0xdf, 0x00, 0xa7, 0x62, 0x16, 0x9d, 0x4e, 0xbb, 0x1d,
+  0x7b, 0x0c, 0xbd, 0xca, 0x86, 0x86, 0x5b, 0x33, 0x53, 0xd9, 0xa1, 0x95,
+  0xd2, 0x48, 0x30, 0xf7, 0xd1, 0xce, 0xd0, 0x22, 0x3e, 0x88, 0x7b, 0x3c,
+  0xa4, 0x5f, 0x7c, 0x6f, 0x87, 0xf8, 0x10, 0x89, 0x24, 0xd6, 0x31, 0xde,
+  0x8f, 0x0f, 0x94, 0x2d, 0xb8, 0xdd, 0xdf, 0x54, 0x1e, 0x3e, 0x69, 0x37,
+  0x0e, 0x13, 0xe8, 0xba, 0x9f, 0x75, 0xa1, 0xd2, 0x87, 0xdd, 0xa8, 0x9e,
+  0xaa, 0x82, 0xff, 0x3b, 0x6f, 0x54, 0x9a, 0x3c, 0xec, 0x4e, 0xa5, 0xdd,
+  0x4b, 0x15, 0xb2, 0xa5, 0xdb, 0xde, 0x19, 0xff, 0x82, 0xb7, 0x8c, 0xaf,
+  0xd9, 0x4f, 0xba, 0x67, 0x4a, 0x14, 0xff, 0x37, 0xdf, 0xb2, 0xcf, 0x3b,
+  0x5a, 0x20, 0x70, 0x20, 0x1f, 0xd8, 0x9f, 0x8f, 0x92, 0xc1, 0x49, 0xd7,
+  0xda, 0xb3, 0x90, 0x6d, 0xf1, 0x06, 0x0f, 0x0c, 0x31, 0x14, 0x0b, 0xd1,
+  0x94, 0x7a, 0xb2, 0x4f, 0x2c, 0xcf, 0xd3, 0xf2, 0xea, 0x8d, 0x03, 0x87,
+  0x4e, 0x2a, 0x05, 0xc2, 0x45, 0x2e, 0xab, 0x6d, 0xe9, 0x98, 0x48, 0xb3,
+  0x08, 0x59, 0xd6, 0xa5, 0x11, 0xed, 0xab, 0x3c, 0xe1, 0x8e, 0xd4, 0x86,
+  0x00, 0xbf, 0x1a, 0x8f, 0x87, 0xaf, 0xce, 0x8e, 0xcd, 0xe8, 0xc3, 0x90,
+  0xa2, 0x3c, 0x44, 0xdc, 0xd2, 0x9f, 0x64, 0xcc, 0x2e, 0xe8, 0x4f, 0x37,
+  0x69, 0x7f, 0xda, 0x28, 0xba, 0xdd, 0x6d, 0x7d, 0x55, 0xb7, 0x92, 0x29,
+  0x75, 0x4a, 0xb6, 0xb1, 0x00, 0x29, 0xdb, 0x8a, 0x2d, 0x8b, 0x78, 0x31,
+  0xd9, 0xa4, 0xc4, 0x65, 0xf8, 0x89, 0x20, 0xf7, 0x14, 0x48, 0x22, 0x00,
+  0x01, 0x49, 0x0e, 0x9e, 0x3f, 0x3d, 0x30, 0xd7, 0xe2, 0x8e, 0x01, 0xee,
+  0xe4, 0xfd, 0xc7, 0xa3, 0x47, 0x7b, 0x8f, 0x47, 0x8f, 0x89, 0xab, 0xb9,
+  0xa8, 0x90, 0x8c, 0x6f, 0xb8, 0x5d, 0x24, 0xfb, 0x82, 0xa6, 0xf5, 0xfe,
+  0xe8, 0x75, 0xc2, 0x09, 0x7a, 0x80, 0x3b, 0x4b, 0x50, 0x2b, 0x44, 0x75,
+  0x47, 0x72, 0x1e, 0x48, 0x12, 0x20, 0x46, 0x3a, 0x52, 0x77, 0x18, 0x13,
+  0x6b, 0x60, 0x8c, 0x05, 0xdb, 0x91, 0xa8, 0x2d, 0x81, 0x02, 0xfc, 0xc2,
+  0xce, 0x84, 0xf8, 0x1d, 0x9b, 0x15, 0xb2, 0x33, 0xab, 0x48, 0xbb, 0x72,
+  0x7f, 0x4f, 0xbc, 0x1d, 0xbb, 0x27, 0x8d, 0xf6, 0x71, 0xff, 0xf9, 0xa8,
+  0xf9, 0xd2, 0x63, 0x00, 0x39, 0x0f, 0x65, 0x60, 0xe7, 0x08, 0x3f, 0xd4,
+  0xf4, 0x42, 0xf2, 0xb3, 0x4c, 0x97, 0xd6, 0x24, 0x99, 0xff, 0x7d, 0x56,
+  0x8c, 0x7e, 0xaa, 0x3d, 0x15, 0x51, 0x88, 0xdb, 0x66, 0x13, 0xcf, 0x5d,
+  0x18, 0xb5, 0x98, 0x4b, 0x7d, 0x2b, 0x62, 0x13, 0xa9, 0xeb, 0x09, 0x00,
+  0x01, 0xd0, 0x5d, 0x66, 0x03, 0xca, 0x1b, 0xc8, 0x8e, 0xbe, 0x69, 0xf0,
+  0x48, 0x09, 0x86, 0xfb, 0xd6, 0x5e, 0x95, 0xa5, 0x0b, 0x79, 0x51, 0x4c,
+  0x37, 0x20, 0xa3, 0x06, 0xbf, 0x9c, 0xa3, 0x8d, 0x56, 0x1d, 0x00, 0x51,
+  0x31, 0x92, 0xb3, 0x85, 0x81, 0xe3, 0xa7, 0x6d, 0x3a, 0x8a, 0xd7, 0xb0,
+  0xa2, 0x32, 0xe2, 0x24, 0x5f, 0xa5, 0x8b, 0xe4, 0x01, 0x39, 0xd4, 0xfd,
+  0x87, 0x7f, 0x2f, 0xbf, 0x73, 0xec, 0x22, 0xe4, 0x72, 0xb6, 0x60, 0x59,
+  0x13, 0xe5, 0xba, 0x52, 0x55, 0x38, 0x48, 0x8b, 0xcf, 0xf5, 0x0c, 0x48,
+  0x49, 0xbd, 0xc2, 0xce, 0x1c, 0xda, 0x4d, 0x37, 0x51, 0x20, 0x9f, 0x5b,
+  0xe4, 0xb7, 0x69, 0xb9, 0x5c, 0xb9, 0x98, 0x81, 0x0e, 0x2a, 0xd5, 0x7d,
+  0xd4, 0x6e, 0x9e, 0xcd, 0xa8, 0x4d, 0xcc, 0xdd, 0xb2, 0xc4, 0x7b, 0x59,
+  0xef, 0x2f, 0xc1, 0x0c, 0x49, 0x85, 0x63, 0x3f, 0xc3, 0x4f, 0xc5, 0x7a,
+  0xf4, 0x85, 0x45, 0xb2, 0x83, 0x80, 0xb7, 0xad, 0xd6, 0xa2, 0x1f, 0x69,
+  0x08, 0x35, 0xf4, 0x52, 0xd9, 0xe8, 0xd8, 0xee, 0xe8, 0x21, 0xa0, 0xb8,
+  0x03, 0xc1, 0xbf, 0xb5, 0x90, 0xb7, 0x01, 0x9f, 0xfd, 0xbf, 0x42, 0x0d,
+  0x7c, 0x92, 0xd8, 0xb3, 0x7a, 0x88, 0x36, 0xc8, 0x08, 0xd2, 0xdc, 0x57,
+  0x39, 0x80, 0xf8, 0x72, 0x26, 0xd7, 0xff, 0xaf, 0x0d, 0xfe, 0xef, 0xa4,
+  0x0d, 0xfe, 0xe4, 0x5b, 0xda, 0xba, 0xa4, 0x43, 0xc9, 0xe0, 0xb4, 0xf7,
+  0xd2, 0xdd, 0xc4, 0x78, 0x62, 0xf5, 0xe2, 0xee, 0x81, 0x17, 0xb4, 0x7b,
+  0x43, 0x93, 0x90, 0x14, 0xfe, 0xef, 0xb8, 0xa2, 0x0f, 0xba, 0x99, 0xff,
+  0xbf, 0xef, 0xe3, 0x7f, 0xb5, 0x7b, 0xd8, 0xaf, 0x0d, 0xee, 0x18, 0x22,
+  0xbb, 0xa1, 0xec, 0x24, 0xee, 0xe9, 0x04, 0x3b, 0x7b, 0xd7, 0x69, 0x3e,
+  0x54, 0x77, 0xc4, 0x7b, 0x77, 0x7c, 0xf6, 0xed, 0x53, 0x46, 0x1a, 0x19,
+  0x77, 0x83, 0xf6, 0x55, 0x72, 0xf2, 0xe6, 0xd5, 0xd9, 0x4f, 0xb8, 0xed,
+  0x7f, 0x81, 0x17, 0x7a, 0x95, 0x65, 0xb3, 0x21, 0xc7, 0x47, 0x5e, 0xe2,
+  0x1f, 0x91, 0xc0, 0x62, 0x6a, 0x91, 0x04, 0x40, 0xb6, 0x14, 0x36, 0x09,
+  0xc3, 0xb5, 0x78, 0xd9, 0xa8, 0x29, 0x85, 0x60, 0x7b, 0xac, 0xd0, 0xfa,
+  0x2c, 0xf0, 0xb1, 0x94, 0xc5, 0x6c, 0x97, 0x0b, 0x9a, 0xf0, 0x65, 0x90,
+  0x8a, 0x44, 0xd9, 0xe9, 0x7e, 0x5f, 0x12, 0xfa, 0x97, 0x05, 0x48, 0xf4,
+  0x9e, 0x51, 0xc4, 0xdb, 0x68, 0xd2, 0xc7, 0x9d, 0x5b, 0x0a, 0x87, 0x76,
+  0x18, 0xa5, 0xeb, 0xd1, 0x3e, 0xf9, 0xdf, 0xc1, 0x45, 0xb2, 0xe6, 0x57,
+  0x44, 0x15, 0xe8, 0x7e, 0xbe, 0x2f, 0x6d, 0x60, 0xe3, 0x56, 0xfa, 0x27,
+  0xd1, 0xda, 0x41, 0x8a, 0x04, 0xce, 0xd6, 0x55, 0xd8, 0x2d, 0x31, 0xf5,
+  0xf7, 0x87, 0x03, 0xe5, 0x3c, 0x5f, 0xfb, 0x89, 0xf6, 0x6e, 0x9a, 0xcf,
+  0x7b, 0x2f, 0x04, 0x16, 0xb5, 0xad, 0xbd, 0xf1, 0x5b, 0xdc, 0xfb, 0xb3,
+  0x72, 0x99, 0xd1, 0x07, 0xea, 0xdd, 0x77, 0x29, 0xd4, 0x7f, 0x09, 0xb3,
+  0xc6, 0xbc, 0x77, 0x37, 0xa7, 0x3a, 0x95, 0x45, 0x53, 0x51, 0x2b, 0x05,
+  0x8d, 0x92, 0x2a, 0xa2, 0xb6, 0xe1, 0x8b, 0x7e, 0x8d, 0x73, 0x8a, 0x8c,
+  0xe8, 0x04, 0xbb, 0x16, 0xb6, 0x15, 0xe4, 0xfb, 0x9d, 0x64, 0xcd, 0x74,
+  0xe4, 0xce, 0x16, 0x50, 0x6d, 0xe6, 0x97, 0x53, 0xa3, 0xe4, 0x6a, 0xef,
+  0xdd, 0x41, 0xc2, 0x81, 0x6c, 0x32, 0x79, 0x7a, 0x7c, 0x15, 0x1a, 0xf1,
+  0xff, 0xf5, 0xdb, 0x50, 0x6d, 0xee, 0xf3, 0x16, 0x96, 0xca, 0xab, 0x79,
+  0x62, 0xd9, 0x42, 0x6a, 0xd8, 0x19, 0x2a, 0xcc, 0xd1, 0x0c, 0x36, 0x6f,
+  0xee, 0x08, 0x6d, 0xe1, 0x46, 0x92, 0xfd, 0xbb, 0xfc, 0x7e, 0x7c, 0xf2,
+  0x88, 0x33, 0x1b, 0x2f, 0x4e, 0xc6, 0x3e, 0x4e, 0x78, 0x8d, 0xfe, 0xc0,
+  0xa8, 0xf4, 0xfa, 0xf3, 0xd1, 0xab, 0xf1, 0xc5, 0x28, 0xb2, 0xc6, 0x30,
+  0x31, 0xc4, 0x15, 0x7e, 0x12, 0x80, 0xd3, 0x22, 0xbd, 0x23, 0x94, 0x40,
+  0xa9, 0x1f, 0xa3, 0xb9, 0xf1, 0xd4, 0x74, 0x6c, 0x32, 0x73, 0xb9, 0x53,
+  0x06, 0x52, 0x8b, 0xc2, 0xd4, 0x0b, 0xb3, 0x77, 0x93, 0x7c, 0x41, 0x2b,
+  0x30, 0xd3, 0x32, 0xc6, 0xd0, 0x52, 0x92, 0xc3, 0x51, 0x8d, 0x5c, 0x2e,
+  0x28, 0xa3, 0x8c, 0xbe, 0xd3, 0xf6, 0x44, 0x50, 0xe2, 0xa5, 0x94, 0x68,
+  0xf7, 0x17, 0x5c, 0x1a, 0xbd, 0xa3, 0xa4, 0x36, 0x37, 0x76, 0xae, 0xba,
+  0x57, 0x5c, 0x0d, 0xe6, 0x35, 0x26, 0xa3, 0x4e, 0xdc, 0x04, 0x56, 0x11,
+  0xa6, 0xb5, 0xa6, 0xf5, 0x27, 0xcd, 0xec, 0x47, 0xfb, 0x44, 0x4a, 0x9e,
+  0xd9, 0x98, 0x5b, 0xd7, 0xb5, 0x84, 0xcc, 0x41, 0xa3, 0xf6, 0x97, 0xaa,
+  0x40, 0x82, 0x24, 0x70, 0x72, 0x00, 0x14, 0xd9, 0x62, 0x77, 0xc3, 0x89,
+  0x6b, 0x80, 0xdc, 0x6f, 0xef, 0x48, 0xa3, 0xc5, 0x7b, 0x4a, 0x25, 0xd3,
+  0xab, 0xcc, 0x48, 0x91, 0x91, 0x57, 0xc1, 0xfe, 0xe0, 0x0d, 0xf9, 0x2c,
+  0x80, 0x39, 0x8b, 0x6c, 0xcf, 0x4f, 0xde, 0x90, 0xc7, 0x8f, 0xc3, 0x0d,
+  0xa9, 0xb2, 0xbf, 0xcf, 0x62, 0x98, 0xcf, 0xc8, 0xb4, 0x47, 0x9a, 0x3f,
+  0xa7, 0xc7, 0x9f, 0x33, 0x70, 0x35, 0x4d, 0x75, 0x8f, 0x5a, 0xb7, 0x68,
+  0xbe, 0xb0, 0x03, 0x0d, 0x23, 0x03, 0x9b, 0x02, 0x90, 0x61, 0xdb, 0x69,
+  0x45, 0x17, 0xf4, 0xfa, 0x0c, 0xe6, 0x71, 0xd8, 0x03, 0xc9, 0xe2, 0x94,
+  0x8f, 0x6c, 0x64, 0x59, 0x94, 0xcd, 0x89, 0x06, 0x20, 0x54, 0x4b, 0x67,
+  0xef, 0xce, 0x70, 0x38, 0x6f, 0x56, 0x76, 0x61, 0x1b, 0xa9, 0x63, 0x3f,
+  0xd8, 0x8c, 0x9e, 0xa5, 0x5f, 0x54, 0xda, 0x08, 0x65, 0xf3, 0xea, 0xc3,
+  0xac, 0x32, 0xea, 0x2e, 0xa2, 0x1d, 0xab, 0x01, 0xd0, 0x24, 0xed, 0xa2,
+  0x1f, 0xba, 0x11, 0x21, 0xf3, 0xc0, 0xb6, 0xb4, 0x3a, 0xe8, 0xea, 0x7a,
+  0x85, 0x85, 0x6b, 0x70, 0x54, 0x76, 0x00, 0x33, 0x95, 0xc4, 0xed, 0xe0,
+  0xb6, 0x17, 0x54, 0x3e, 0x78, 0x9d, 0x2d, 0x50, 0x56, 0x95, 0x15, 0xd3,
+  0xea, 0x6e, 0xe5, 0x83, 0x94, 0xcf, 0xee, 0xd1, 0xe0, 0xef, 0x39, 0x81,
+  0x56, 0x0d, 0xc4, 0x81, 0xe1, 0x75, 0xbb, 0xa1, 0xfe, 0x95, 0x2a, 0x83,
+  0x67, 0xe3, 0x04, 0x8a, 0x77, 0xe3, 0xa7, 0x44, 0x93, 0x21, 0xa3, 0x8c,
+  0x9b, 0x71, 0x02, 0x05, 0x99, 0x2d, 0x99, 0x87, 0x0e, 0x64, 0xda, 0x5a,
+  0x9b, 0xf1, 0xfc, 0xe0, 0x93, 0x3f, 0x1c, 0xf0, 0x7e, 0x5d, 0x1f, 0x06,
+  0x3c, 0x61, 0x7c, 0xb2, 0x4b, 0x30, 0xbc, 0x15, 0xc1, 0x62, 0xb4, 0xdc,
+  0x52, 0x74, 0x61, 0xb5, 0x11, 0xd3, 0x21, 0x7b, 0xa3, 0xfc, 0xb6, 0xb4,
+  0xac, 0x64, 0x07, 0x29, 0x4e, 0x28, 0x81, 0xe5, 0xbb, 0xce, 0xa5, 0x88,
+  0x63, 0xc3, 0x57, 0x39, 0x7f, 0xab, 0xdd, 0x36, 0xd2, 0x56, 0x77, 0xd2,
+  0xd3, 0xd7, 0x87, 0xbd, 0x80, 0xdb, 0x23, 0xf9, 0x3d, 0x4a, 0x75, 0x67,
+  0x19, 0x30, 0xab, 0x15, 0x33, 0x30, 0xb1, 0xcd, 0xc9, 0x91, 0xbf, 0x48,
+  0xde, 0xe9, 0xa7, 0x07, 0xcf, 0x9e, 0xee, 0x46, 0x83, 0xec, 0x4c, 0x4c,
+  0x54, 0xc2, 0xd5, 0x34, 0x2b, 0x2a, 0x44, 0x14, 0x32, 0xa2, 0x7f, 0x1e,
+  0x8e, 0xfc, 0x3d, 0x0a, 0xbb, 0x38, 0x74, 0x45, 0x52, 0x31, 0x23, 0x82,
+  0xa0, 0x6d, 0x50, 0x54, 0x7b, 0x22, 0x14, 0xdb, 0x0f, 0x53, 0xef, 0x38,
+  0x08, 0x39, 0x34, 0x09, 0x03, 0xc4, 0x6d, 0x98, 0x88, 0xc3, 0x47, 0x3a,
+  0x81, 0x47, 0x3c, 0x33, 0xaf, 0x0d, 0x21, 0xcf, 0x14, 0x7f, 0x1f, 0xb5,
+  0xff, 0xe5, 0x07, 0x33, 0xdd, 0x00, 0x3f, 0xef, 0x94, 0x1f, 0xfd, 0xda,
+  0xa7, 0xfc, 0xe8, 0x9e, 0x53, 0x7e, 0xf4, 0xd0, 0x53, 0x7e, 0xf6, 0xe4,
+  0xe9, 0xe7, 0x3f, 0xef, 0x94, 0xbd, 0x4d, 0xfe, 0x9f, 0x73, 0xca, 0x1e,
+  0x99, 0xfd, 0xbc, 0x53, 0x96, 0xa4, 0x90, 0x6e, 0xe1, 0x99, 0x24, 0xbf,
+  0x70, 0xd9, 0x20, 0x61, 0x06, 0x70, 0xe6, 0x25, 0x3f, 0x1c, 0x16, 0x94,
+  0x48, 0x97, 0x3d, 0xee, 0xee, 0x65, 0xd4, 0xb0, 0x88, 0x91, 0xed, 0x00,
+  0x0c, 0xa0, 0xdf, 0xae, 0x16, 0xd4, 0x24, 0x6a, 0x7b, 0xb8, 0xad, 0xa1,
+  0x6b, 0x2d, 0x13, 0x53, 0xfc, 0x1f, 0xfe, 0x9a, 0x39, 0xec, 0xdf, 0x10,
+  0x3d, 0x2a, 0xcc, 0x99, 0xf1, 0xb2, 0x9e, 0xda, 0x9b, 0x76, 0xb7, 0x30,
+  0x66, 0x02, 0x67, 0x20, 0x45, 0xb3, 0xdf, 0xa4, 0x9e, 0x55, 0x21, 0x6c,
+  0xd4, 0x4b, 0x33, 0x31, 0x3a, 0xa1, 0x11, 0x01, 0x05, 0xe5, 0xf4, 0xdc,
+  0x2d, 0x32, 0xa9, 0x94, 0xa4, 0x35, 0xc3, 0x27, 0x4f, 0xa6, 0x7c, 0xd7,
+  0x25, 0x2c, 0x3d, 0x51, 0x2c, 0x70, 0x98, 0xe6, 0x2c, 0xd9, 0x1e, 0xf3,
+  0x65, 0x7b, 0x3a, 0xd8, 0x39, 0x73, 0x51, 0x38, 0xee, 0xb0, 0x8c, 0x80,
+  0x9a, 0x6c, 0xe0, 0xf4, 0x4f, 0xbb, 0x09, 0x77, 0x3d, 0x3d, 0x58, 0x62,
+  0x09, 0x68, 0x41, 0x3b, 0x1e, 0x7b, 0x34, 0x0c, 0x27, 0x65, 0x5b, 0xc4,
+  0xd8, 0x34, 0x6c, 0xd8, 0xc7, 0x94, 0x83, 0x1d, 0x14, 0x5c, 0xa2, 0x64,
+  0x54, 0xd6, 0xa3, 0x3d, 0x6f, 0xbc, 0xd7, 0x25, 0xa1, 0x50, 0x37, 0xe7,
+  0x9e, 0xda, 0x00, 0xca, 0xaf, 0x6d, 0xbc, 0xf6, 0x7f, 0x62, 0xfd, 0xbd,
+  0xa1, 0xe9, 0xce, 0xd6, 0xcb, 0x95, 0x42, 0xbe, 0x51, 0x19, 0x47, 0x8e,
+  0x34, 0x2e, 0xad, 0xfa, 0x8e, 0xb6, 0x83, 0x27, 0x37, 0x9a, 0xad, 0xea,
+  0xb0, 0x19, 0x6e, 0xec, 0xb3, 0xd2, 0xd3, 0x92, 0xba, 0x65, 0x5e, 0x01,
+  0x12, 0xd7, 0x2c, 0xd6, 0x54, 0x90, 0x7a, 0x40, 0xf7, 0xcc, 0x4c, 0x7b,
+  0x96, 0x4d, 0xd6, 0x97, 0x5a, 0x39, 0x6d, 0xdb, 0x78, 0xb5, 0x69, 0x12,
+  0x85, 0x26, 0x84, 0xa4, 0x92, 0x0d, 0x38, 0x8d, 0x2e, 0x2d, 0xee, 0x42,
+  0x10, 0x89, 0x86, 0x5a, 0xd8, 0x4d, 0x37, 0x25, 0x87, 0x05, 0x4b, 0x07,
+  0xb1, 0xe7, 0x03, 0x6f, 0xe9, 0xf8, 0x49, 0xeb, 0x44, 0x23, 0x2d, 0x82,
+  0x7c, 0x52, 0x69, 0xa6, 0xab, 0xe1, 0x3c, 0x25, 0x08, 0xc6, 0xa0, 0x80,
+  0x56, 0x12, 0x42, 0xe5, 0x0e, 0x5c, 0xbc, 0x3e, 0x4b, 0xde, 0xa6, 0xd2,
+  0x56, 0x25, 0xd9, 0x31, 0x1c, 0xf8, 0xd9, 0xe3, 0x83, 0x47, 0xbb, 0x1b,
+  0xf5, 0xf0, 0x36, 0xac, 0x10, 0xbe, 0x55, 0x94, 0xb1, 0xc4, 0xdc, 0x8b,
+  0xb5, 0x31, 0x9a, 0x05, 0xae, 0xc4, 0x7c, 0xe8, 0xe3, 0xfb, 0xd3, 0x37,
+  0x47, 0x27, 0xaf, 0xfe, 0x62, 0x0b, 0xe3, 0x69, 0x0f, 0xb4, 0xc2, 0xf2,
+  0xa3, 0xb1, 0x5e, 0xef, 0x3e, 0xd6, 0x99, 0x99, 0x72, 0xb3, 0xf3, 0x68,
+  0x17, 0x05, 0xec, 0x41, 0xf3, 0xbb, 0xcb, 0xac, 0x85, 0x2a, 0x20, 0x59,
+  0xd2, 0x1b, 0x80, 0x71, 0xc6, 0xb6, 0x77, 0xe2, 0xfe, 0xc8, 0xb0, 0x67,
+  0x49, 0xbb, 0x64, 0x80, 0x78, 0x47, 0xa4, 0x5e, 0x87, 0x88, 0x54, 0xb0,
+  0xb3, 0xa4, 0x44, 0x3c, 0x68, 0xb1, 0xb2, 0x5a, 0xe4, 0xd3, 0x9c, 0xac,
+  0x15, 0xb9, 0xd5, 0x94, 0x7d, 0x3d, 0x9f, 0xb7, 0xe1, 0xf7, 0x50, 0xa4,
+  0x88, 0xb4, 0xec, 0x8d, 0xce, 0xb4, 0x36, 0xef, 0x6f, 0x20, 0x2c, 0xb2,
+  0x45, 0x91, 0x35, 0x43, 0x99, 0xd6, 0x4b, 0xf3, 0xe7, 0x17, 0xd7, 0xe9,
+  0x22, 0x28, 0x7d, 0xa5, 0xde, 0x71, 0x4a, 0x9b, 0x36, 0x79, 0x92, 0xde,
+  0xf4, 0x5a, 0x4b, 0x8c, 0x6d, 0x87, 0x05, 0x7d, 0xd2, 0x5c, 0x95, 0xa0,
+  0x93, 0xc2, 0xc5, 0xc5, 0x5f, 0xce, 0x8e, 0xbe, 0x78, 0x49, 0x6c, 0xec,
+  0x4f, 0x94, 0x63, 0x5f, 0xb7, 0xb8, 0x5a, 0x42, 0xbd, 0xaa, 0x83, 0x35,
+  0x7c, 0xff, 0xe6, 0x78, 0x7c, 0x76, 0x72, 0xfa, 0xfa, 0x8b, 0x97, 0xdf,
+  0x93, 0x4d, 0x69, 0x84, 0xc7, 0x9d, 0xf7, 0xae, 0xfd, 0x99, 0x05, 0x8b,
+  0x0f, 0x81, 0x13, 0x8e, 0xbe, 0xfb, 0x78, 0xf4, 0xfe, 0xdb, 0x2f, 0x5e,
+  0x5e, 0xa7, 0xd5, 0x80, 0xd6, 0xc7, 0x6f, 0xf7, 0xb4, 0x66, 0x6c, 0x91,
+  0x1a, 0x29, 0xe7, 0x93, 0xc5, 0xa7, 0x3a, 0xff, 0x47, 0x96, 0x98, 0xd7,
+  0x17, 0xeb, 0x10, 0xae, 0xf9, 0x42, 0xda, 0xfd, 0x18, 0xe9, 0x4d, 0xe6,
+  0xd0, 0x9f, 0x4f, 0xbe, 0x21, 0x48, 0x50, 0xeb, 0x28, 0x5d, 0x72, 0x7f,
+  0x99, 0xe4, 0x4f, 0x4f, 0x0e, 0x0e, 0x77, 0x5d, 0x57, 0x43, 0x40, 0x0a,
+  0x9b, 0x19, 0x7f, 0x0a, 0xaa, 0x43, 0xfe, 0xa1, 0xd0, 0x68, 0xb6, 0x77,
+  0x48, 0xe3, 0x2c, 0x2a, 0x48, 0x0c, 0xf5, 0x3a, 0x01, 0x17, 0x80, 0xc1,
+  0x4a, 0x4a, 0x62, 0x08, 0x84, 0xae, 0x14, 0x78, 0xdc, 0x2e, 0xde, 0x7a,
+  0x60, 0x1e, 0x7f, 0x76, 0x84, 0x67, 0xa6, 0x23, 0x5e, 0xbb, 0x8d, 0xf2,
+  0xf1, 0x57, 0x8c, 0xe5, 0x74, 0x4d, 0x4a, 0x6c, 0xb6, 0x11, 0x68, 0x42,
+  0x3f, 0xf1, 0x7d, 0xf6, 0x62, 0xde, 0xa8, 0x74, 0x29, 0x19, 0x7e, 0x0e,
+  0xab, 0x54, 0xc2, 0xd3, 0xda, 0xe9, 0x8d, 0x06, 0x71, 0xbe, 0xa4, 0x02,
+  0x4b, 0x2a, 0x47, 0x60, 0xe7, 0x8e, 0xe7, 0xba, 0x59, 0x64, 0x97, 0xe9,
+  0xf4, 0x2e, 0xb1, 0x40, 0xba, 0xd2, 0xdc, 0x72, 0xd6, 0xbd, 0x9d, 0xec,
+  0xe3, 0x9b, 0x92, 0x2d, 0x67, 0x24, 0x30, 0xe1, 0x1b, 0x10, 0x57, 0x66,
+  0xcc, 0x08, 0x2a, 0x48, 0x53, 0xbf, 0x4f, 0x6b, 0x76, 0x23, 0x96, 0x97,
+  0xb4, 0xa9, 0x5d, 0xe9, 0xdc, 0xde, 0xe2, 0x0e, 0xf5, 0x11, 0xd9, 0xa0,
+  0xe7, 0xea, 0xc6, 0x3d, 0x7d, 0xdc, 0xf6, 0x98, 0xff, 0x03, 0x97, 0x9c,
+  0xd0, 0x86, 0xe0, 0x94, 0x7d, 0x49, 0x7f, 0xed, 0xc5, 0x1b, 0x67, 0xaf,
+  0x05, 0x77, 0xd5, 0x75, 0x08, 0x7d, 0x16, 0x26, 0x4e, 0x1a, 0x78, 0x50,
+  0x49, 0x70, 0xa3, 0x2e, 0xe0, 0x5e, 0x2c, 0x2f, 0xad, 0xe8, 0x23, 0x4f,
+  0xb0, 0x79, 0xdc, 0xf6, 0xf4, 0xe9, 0x19, 0xd2, 0x16, 0xa1, 0x85, 0x21,
+  0x1a, 0x14, 0x40, 0x51, 0x2a, 0xc2, 0x4b, 0x1a, 0x88, 0x38, 0x22, 0xa9,
+  0x24, 0x66, 0xa3, 0xfe, 0xa4, 0x41, 0x9f, 0xd4, 0x87, 0x3b, 0xc1, 0x43,
+  0x0c, 0x99, 0x41, 0x4a, 0x74, 0x15, 0xcd, 0x6e, 0x57, 0xbf, 0x01, 0x27,
+  0x68, 0x50, 0x40, 0xcd, 0xc2, 0xe7, 0x9a, 0x49, 0xd6, 0xaa, 0x95, 0x52,
+  0xad, 0x17, 0x8c, 0x74, 0x07, 0xb0, 0x19, 0x6b, 0x47, 0xa9, 0x95, 0x49,
+  0x0a, 0x7b, 0xcc, 0xab, 0x92, 0x64, 0x04, 0xcc, 0x67, 0x67, 0x49, 0xcb,
+  0xd8, 0x15, 0x10, 0x76, 0xc6, 0xbc, 0x4f, 0xfa, 0x1a, 0x53, 0x77, 0xc4,
+  0x94, 0x19, 0x95, 0xc6, 0x20, 0x11, 0x65, 0x24, 0x14, 0x64, 0x12, 0x97,
+  0x9f, 0x77, 0xb6, 0x23, 0x52, 0x65, 0xd9, 0x70, 0x12, 0x7f, 0x57, 0x44,
+  0x11, 0x78, 0xb2, 0x26, 0xce, 0xb7, 0x46, 0xf0, 0xbb, 0x6e, 0xed, 0x0c,
+  0x77, 0x6d, 0xa9, 0x74, 0xde, 0x58, 0xa5, 0x2d, 0x02, 0x2d, 0x92, 0x58,
+  0x84, 0x67, 0x0b, 0x51, 0xc5, 0xbe, 0x4f, 0x89, 0xb7, 0x68, 0x33, 0x73,
+  0xfa, 0xda, 0x1e, 0xd7, 0xb8, 0x29, 0x0f, 0xca, 0xc3, 0x12, 0xdb, 0x60,
+  0xac, 0x22, 0xbb, 0xf1, 0xc7, 0x72, 0x66, 0x87, 0x1d, 0xef, 0xd7, 0xf4,
+  0x76, 0x1b, 0x9b, 0x89, 0xea, 0x72, 0x92, 0x97, 0xdf, 0x1e, 0x9d, 0x8f,
+  0x8f, 0x4f, 0xdf, 0xff, 0x29, 0x6a, 0x0e, 0xcb, 0x2f, 0x6d, 0x43, 0x2b,
+  0xad, 0xe8, 0x73, 0x5d, 0x87, 0xc8, 0x0b, 0xa6, 0xbe, 0x16, 0x06, 0x77,
+  0xc9, 0x0b, 0x7a, 0x24, 0xe8, 0x66, 0x34, 0xcd, 0x56, 0x0d, 0x97, 0x15,
+  0xa9, 0x29, 0xed, 0x3a, 0x27, 0x52, 0xe2, 0x20, 0x1b, 0x71, 0xfb, 0x03,
+  0xfd, 0xdb, 0x81, 0xfd, 0xdb, 0x61, 0x48, 0xed, 0xfc, 0x8b, 0x47, 0xc1,
+  0x06, 0xc5, 0x13, 0x76, 0xbc, 0x78, 0xf9, 0x7a, 0xc5, 0xb5, 0x60, 0x84,
+  0xd9, 0xc0, 0x08, 0x2f, 0xfe, 0x02, 0x02, 0x7c, 0x7a, 0x6a, 0x6c, 0xea,
+  0xbf, 0x68, 0x1e, 0xbe, 0x3e, 0xf0, 0x2a, 0x58, 0xec, 0x73, 0x07, 0xb1,
+  0xe7, 0x0e, 0xc2, 0xe7, 0x0e, 0x63, 0xcf, 0x1d, 0x86, 0xcf, 0x3d, 0x8a,
+  0x3d, 0xe7, 0xad, 0xd7, 0x73, 0xfc, 0xc9, 0xc6, 0x6d, 0xb2, 0x8c, 0x5b,
+  0xff, 0x7a, 0x34, 0x72, 0xc7, 0xff, 0x99, 0xf5, 0x56, 0x74, 0x5b, 0x72,
+  0xfe, 0x24, 0xc3, 0xfe, 0x55, 0xa7, 0xe3, 0xb7, 0xd1, 0x12, 0x3b, 0x2e,
+  0x66, 0xf3, 0xbd, 0x83, 0x47, 0xc3, 0x69, 0xbe, 0xba, 0x22, 0xb9, 0xf3,
+  0x52, 0x3b, 0x58, 0xd1, 0xe6, 0xd3, 0x62, 0xe5, 0x17, 0x6b, 0xb2, 0xc8,
+  0x43, 0x3d, 0xe4, 0x64, 0xec, 0xc3, 0xb2, 0x08, 0x12, 0x21, 0xde, 0x48,
+  0xf8, 0x15, 0x07, 0xca, 0xd2, 0xf5, 0x2f, 0x87, 0x70, 0x48, 0x79, 0x93,
+  0x58, 0xef, 0x0d, 0x39, 0x7a, 0x64, 0x0a, 0x4c, 0xbc, 0x3a, 0x2f, 0x9d,
+  0xa8, 0x0c, 0xcf, 0x9d, 0xe1, 0x38, 0xf4, 0xde, 0x75, 0xed, 0x02, 0xca,
+  0x5f, 0x9e, 0x17, 0x28, 0x2f, 0xea, 0x40, 0x55, 0x74, 0xd6, 0xc6, 0x43,
+  0x39, 0x18, 0x2f, 0x14, 0xcf, 0x84, 0xa2, 0xf2, 0xc3, 0xf9, 0x49, 0xa0,
+  0x5a, 0xda, 0x6e, 0xeb, 0xe8, 0xa4, 0x7c, 0x95, 0xde, 0xde, 0x8e, 0xea,
+  0x6c, 0xcf, 0xf0, 0x93, 0x7a, 0x0f, 0x0e, 0x5f, 0xf9, 0xf6, 0x55, 0xb3,
+  0x5c, 0x6c, 0x76, 0xd4, 0xe6, 0xec, 0xd7, 0x92, 0xc6, 0xd7, 0xcc, 0x3b,
+  0x50, 0x61, 0xde, 0x6a, 0x66, 0x6a, 0x8f, 0x38, 0x2c, 0xf5, 0x92, 0x8e,
+  0x91, 0xe8, 0x57, 0x7b, 0x40, 0x92, 0x0f, 0x12, 0x13, 0xe1, 0x4c, 0xc4,
+  0x21, 0x00, 0xfb, 0xca, 0x99, 0x0f, 0x0e, 0x23, 0x84, 0x5e, 0xa0, 0xb2,
+  0xc1, 0x2c, 0x08, 0x67, 0x58, 0x34, 0x90, 0xea, 0xce, 0x76, 0x0d, 0x8f,
+  0xed, 0x5a, 0xed, 0x07, 0x3e, 0x10, 0x2b, 0xe4, 0x25, 0x47, 0xd5, 0x8c,
+  0x5f, 0x99, 0x69, 0x52, 0x4a, 0x1e, 0x29, 0xf3, 0x46, 0xe5, 0x30, 0xff,
+  0xfd, 0x53, 0x58, 0x5c, 0x8b, 0x15, 0x74, 0x13, 0xf7, 0x48, 0xfb, 0xa7,
+  0x92, 0x2f, 0xde, 0x7a, 0xfe, 0x5a, 0xab, 0x11, 0x00, 0xd0, 0x65, 0xe2,
+  0x25, 0xd0, 0x38, 0xb6, 0xad, 0xf1, 0xf9, 0xd9, 0xd6, 0x80, 0xf3, 0x35,
+  0xe9, 0x0b, 0x43, 0xf3, 0xef, 0x04, 0x56, 0x26, 0xb5, 0x11, 0x79, 0xf2,
+  0x78, 0x57, 0xf0, 0x40, 0x31, 0x47, 0x34, 0xc0, 0x8a, 0x84, 0x8f, 0xf0,
+  0x4b, 0x97, 0x5c, 0x58, 0xb5, 0x1a, 0xfe, 0x18, 0xfb, 0xaf, 0xbd, 0x40,
+  0xce, 0xfa, 0x19, 0x70, 0x16, 0xc7, 0x06, 0xb5, 0xce, 0x87, 0xb7, 0xe3,
+  0x79, 0x8e, 0x3a, 0x11, 0x9a, 0xb2, 0xfa, 0x24, 0x7d, 0x0f, 0x24, 0xca,
+  0x01, 0xe6, 0x12, 0x74, 0x99, 0x6d, 0x31, 0x9b, 0xb6, 0x77, 0xd4, 0x5b,
+  0xb3, 0x6c, 0x98, 0xc3, 0xfa, 0xea, 0x69, 0xa5, 0xaa, 0xb4, 0x6a, 0x36,
+  0xec, 0xab, 0x62, 0x4d, 0x87, 0x82, 0x81, 0x74, 0x1c, 0x19, 0xe6, 0x1e,
+  0x4c, 0x8e, 0xc7, 0x9d, 0xd3, 0xd7, 0xcd, 0x8b, 0x1c, 0xbb, 0x6b, 0x9e,
+  0x8e, 0x43, 0x82, 0x4d, 0xa3, 0xb8, 0x83, 0x11, 0x92, 0x50, 0x0c, 0xb4,
+  0xbe, 0x6a, 0x32, 0xc5, 0xd0, 0xf0, 0x4e, 0x64, 0xa4, 0xc1, 0x37, 0x61,
+  0xd3, 0xee, 0xac, 0x3d, 0xdc, 0xff, 0xfb, 0x17, 0xe4, 0xaf, 0x07, 0x6f,
+  0x47, 0x13, 0xae, 0x69, 0x49, 0x9a, 0x90, 0xfa, 0xa0, 0x05, 0xe9, 0x8a,
+  0x36, 0x2c, 0x49, 0x8e, 0xb2, 0xb3, 0x28, 0xb7, 0x2a, 0x6f, 0x59, 0x8e,
+  0x4a, 0x69, 0x69, 0x01, 0xe9, 0x3d, 0x68, 0xa1, 0xad, 0x95, 0x92, 0x88,
+  0x8c, 0x0a, 0x16, 0x71, 0xf8, 0xfb, 0xfe, 0x7e, 0x4f, 0x25, 0x80, 0x0a,
+  0xa0, 0x8c, 0xae, 0x9d, 0x6e, 0xdc, 0x5b, 0x55, 0x21, 0xae, 0x7f, 0x1a,
+  0x45, 0xfb, 0x35, 0x44, 0xd0, 0x5b, 0xc8, 0x65, 0xaa, 0x5f, 0x91, 0x2e,
+  0x81, 0xd2, 0xfa, 0xb7, 0x13, 0xdc, 0x54, 0xc5, 0x91, 0x13, 0xc0, 0x90,
+  0xa1, 0xd0, 0x19, 0xee, 0x23, 0xdd, 0xad, 0x8f, 0xc2, 0x3a, 0x8d, 0x06,
+  0x45, 0x77, 0x19, 0xf0, 0x80, 0x39, 0x81, 0xcc, 0xa7, 0x80, 0x7b, 0xa4,
+  0x48, 0x41, 0x8d, 0xf6, 0x18, 0xae, 0x53, 0x8b, 0x08, 0xa1, 0x2e, 0x97,
+  0xa7, 0x71, 0xcc, 0x35, 0xa4, 0xd6, 0xbe, 0xea, 0x8d, 0x55, 0x6d, 0xb1,
+  0x03, 0x1e, 0x85, 0xf6, 0x08, 0x56, 0x29, 0x94, 0x6d, 0x0b, 0x74, 0xff,
+  0xfb, 0xaa, 0xa1, 0x43, 0x55, 0x81, 0x34, 0x98, 0x9f, 0x77, 0x58, 0x07,
+  0xff, 0x7b, 0x1d, 0xd6, 0xc1, 0xff, 0x19, 0x87, 0x75, 0xf8, 0xf3, 0x0e,
+  0xeb, 0xf0, 0x7f, 0xaf, 0xc3, 0x3a, 0xfc, 0x3f, 0xe3, 0xb0, 0x1e, 0xfd,
+  0xbc, 0xc3, 0x7a, 0xf4, 0xcb, 0x1f, 0x96, 0xeb, 0x94, 0xae, 0x5a, 0x5f,
+  0x2e, 0x7a, 0x82, 0xd3, 0x8a, 0x26, 0x77, 0x68, 0xb2, 0x3d, 0xa1, 0x0d,
+  0x11, 0x83, 0x41, 0x94, 0xc9, 0xba, 0x6b, 0x35, 0xbd, 0x72, 0x18, 0xd4,
+  0xb6, 0x19, 0x84, 0xc4, 0xa0, 0x04, 0x93, 0x9b, 0x54, 0x9e, 0x3f, 0x97,
+  0xe4, 0x42, 0x31, 0x9a, 0xc1, 0x20, 0x79, 0x3f, 0x1e, 0x73, 0xda, 0xd1,
+  0x18, 0xa1, 0xd3, 0xee, 0x61, 0x91, 0x33, 0x12, 0x36, 0xce, 0x0e, 0xa9,
+  0x8d, 0xa7, 0x66, 0x86, 0x8e, 0xbb, 0xf0, 0x7b, 0xcb, 0x74, 0x4a, 0x3f,
+  0xde, 0x1f, 0x1d, 0xb8, 0xdd, 0xd9, 0xfd, 0x09, 0x80, 0x57, 0x2e, 0xae,
+  0x19, 0x0f, 0x46, 0x47, 0xa0, 0xa9, 0x81, 0xf4, 0x5c, 0x37, 0x9d, 0xc3,
+  0xb9, 0x6d, 0x47, 0xa5, 0x7b, 0x41, 0x90, 0x63, 0xa7, 0xc2, 0xe9, 0x17,
+  0x8a, 0x22, 0x48, 0xbf, 0x70, 0x16, 0x3a, 0x0c, 0xe0, 0xc0, 0xfa, 0x96,
+  0x5e, 0xf3, 0x3f, 0x23, 0xb2, 0xec, 0x05, 0x72, 0xff, 0xe7, 0x44, 0x96,
+  0x1f, 0x64, 0x1f, 0xfb, 0x57, 0xa6, 0x1a, 0x6a, 0x07, 0xa9, 0x38, 0x4e,
+  0xb5, 0xf3, 0x2c, 0x52, 0x29, 0x10, 0x10, 0xec, 0x66, 0x4c, 0x3a, 0x94,
+  0x69, 0x73, 0x24, 0xef, 0xba, 0xe0, 0x1e, 0x9b, 0x31, 0x21, 0xce, 0x8c,
+  0x54, 0xda, 0x59, 0x58, 0x15, 0x05, 0xb6, 0xe0, 0x55, 0xd6, 0x4c, 0x6f,
+  0xeb, 0x42, 0x3f, 0x22, 0xb9, 0xa1, 0xe4, 0x22, 0x67, 0x90, 0xa7, 0xb0,
+  0x41, 0x79, 0xc6, 0x10, 0x40, 0xf9, 0x7d, 0x9a, 0xd2, 0xd3, 0xf6, 0x7a,
+  0xd3, 0x69, 0x36, 0x4c, 0xeb, 0x69, 0x9e, 0xc7, 0x5b, 0x58, 0x6a, 0x1c,
+  0x38, 0x4d, 0xe6, 0x6b, 0x78, 0xf0, 0xcd, 0xf3, 0x09, 0xc5, 0xdc, 0xb4,
+  0x21, 0x35, 0x71, 0x44, 0xa0, 0xe2, 0xd0, 0x84, 0xcb, 0x75, 0x73, 0x59,
+  0xaa, 0x33, 0x7f, 0x10, 0x71, 0x0c, 0x52, 0x54, 0x8e, 0x11, 0x98, 0xeb,
+  0x69, 0x95, 0xaf, 0x00, 0xb8, 0xe9, 0x35, 0xbf, 0x1a, 0xd8, 0xce, 0xd0,
+  0xf0, 0xb4, 0x69, 0xe8, 0x94, 0x7b, 0x25, 0x13, 0x07, 0xed, 0xe2, 0x92,
+  0x0f, 0xb7, 0xc8, 0xad, 0x69, 0xbb, 0x06, 0x99, 0xb7, 0x09, 0x25, 0xd9,
+  0x8b, 0x5a, 0x92, 0x57, 0xbd, 0xd9, 0x10, 0x86, 0xd7, 0x30, 0x86, 0x21,
+  0xa1, 0x3b, 0x45, 0xe2, 0x45, 0x63, 0x04, 0x0d, 0x50, 0x4e, 0x18, 0x6c,
+  0x9d, 0x1c, 0xec, 0x8a, 0x7a, 0x7f, 0x95, 0xdd, 0x72, 0x21, 0x69, 0x68,
+  0x72, 0x31, 0x37, 0xbb, 0xd2, 0x22, 0xcb, 0x57, 0xe3, 0xd7, 0xc7, 0xc7,
+  0xad, 0xa2, 0x53, 0xda, 0x3a, 0x44, 0x52, 0x19, 0xcd, 0x24, 0xa9, 0x09,
+  0xcc, 0x14, 0x70, 0x22, 0xb1, 0x28, 0x3c, 0x37, 0xc5, 0x33, 0xd7, 0x0f,
+  0x91, 0x17, 0xc3, 0x08, 0x72, 0x6d, 0x59, 0x98, 0x72, 0x8a, 0xd7, 0xba,
+  0x30, 0xd3, 0xcc, 0x09, 0x61, 0xea, 0x6a, 0xbd, 0x4c, 0x8b, 0x5f, 0x1f,
+  0x46, 0xc7, 0x37, 0xf4, 0x5c, 0x29, 0x87, 0xec, 0x16, 0xdf, 0x2b, 0x3f,
+  0xd6, 0x1b, 0xd2, 0x5a, 0xa4, 0x01, 0xc1, 0x59, 0x25, 0xed, 0xe9, 0x00,
+  0xa3, 0x05, 0x7f, 0x3b, 0x37, 0x11, 0xa0, 0x16, 0xea, 0x84, 0xe7, 0xc7,
+  0x83, 0x9b, 0xe5, 0x6a, 0x04, 0x19, 0xf0, 0xdc, 0x36, 0xb8, 0xd4, 0x75,
+  0x0a, 0x72, 0x18, 0x6d, 0x63, 0xb5, 0xdc, 0x41, 0x57, 0x54, 0xe2, 0x0b,
+  0xbf, 0xe5, 0x0d, 0x68, 0x5d, 0x81, 0xfb, 0xef, 0x00, 0x5f, 0x81, 0x5f,
+  0xe2, 0x06, 0x48, 0x21, 0xd1, 0xd6, 0xef, 0xb7, 0x92, 0x78, 0x8b, 0x8a,
+  0x07, 0x8c, 0xd3, 0x02, 0x60, 0xf9, 0x6d, 0x29, 0x2d, 0x82, 0x08, 0xe3,
+  0x31, 0x31, 0xff, 0x4c, 0xd7, 0x45, 0x7e, 0x8b, 0x8a, 0x0e, 0xa3, 0x4a,
+  0xbc, 0xa4, 0x0e, 0x0d, 0x3d, 0xad, 0x07, 0x5e, 0xb3, 0x62, 0x93, 0x68,
+  0x7d, 0x0a, 0x56, 0xf1, 0xc1, 0xbc, 0x6c, 0x14, 0xc6, 0x25, 0xe5, 0xf7,
+  0xf0, 0x18, 0x03, 0x1f, 0x03, 0x1a, 0x6c, 0x3d, 0x92, 0x1f, 0x54, 0x64,
+  0x0d, 0xb9, 0x3f, 0x36, 0x46, 0xb6, 0xda, 0xd1, 0xc2, 0x0b, 0xf4, 0x7a,
+  0x5b, 0x51, 0xd1, 0xc0, 0x86, 0x4e, 0xc2, 0xd8, 0x0c, 0x97, 0xa4, 0xdf,
+  0x0e, 0x20, 0x78, 0xed, 0x86, 0x84, 0x74, 0x6c, 0x4b, 0x1b, 0xee, 0x3f,
+  0x11, 0x4b, 0x65, 0xb2, 0x7d, 0x52, 0x5c, 0x93, 0xa1, 0xbc, 0x1b, 0x99,
+  0x40, 0x23, 0x1b, 0x17, 0xbe, 0x95, 0x2e, 0x80, 0xa1, 0xec, 0xee, 0xf4,
+  0x3b, 0x1a, 0x79, 0xad, 0x57, 0x5b, 0xdd, 0x98, 0x80, 0xc6, 0x96, 0x2f,
+  0x88, 0xfc, 0xf7, 0x34, 0xbd, 0x61, 0x11, 0xe6, 0xde, 0xbb, 0x26, 0x3f,
+  0xc2, 0xeb, 0xa8, 0xd2, 0x0b, 0x41, 0x4e, 0xfa, 0x37, 0x90, 0x94, 0x54,
+  0x89, 0x68, 0xaf, 0x82, 0x7b, 0x76, 0x75, 0xd5, 0x17, 0x2f, 0xfe, 0x7c,
+  0x45, 0x5d, 0x9f, 0x75, 0x5e, 0x15, 0x13, 0x62, 0xbb, 0xaf, 0xb7, 0x86,
+  0xb4, 0xbd, 0xc6, 0x25, 0x41, 0x5e, 0x33, 0x5f, 0x8f, 0x75, 0x9d, 0x89,
+  0x2e, 0xc5, 0x08, 0x9b, 0x54, 0x6a, 0x47, 0x8d, 0x12, 0x28, 0x4f, 0xcf,
+  0x76, 0x99, 0xe5, 0x83, 0xe5, 0xf6, 0xd4, 0x52, 0xd3, 0x1b, 0x20, 0x88,
+  0xe6, 0x8b, 0x91, 0x5f, 0x35, 0x21, 0x6e, 0x5a, 0x2d, 0xd6, 0xda, 0x31,
+  0xca, 0x3a, 0x6b, 0x6e, 0x7c, 0x79, 0xa8, 0xc9, 0x81, 0x22, 0x50, 0xf7,
+  0xc3, 0x13, 0xc7, 0xe1, 0x9d, 0xda, 0x19, 0x6c, 0xc4, 0x3a, 0x76, 0x52,
+  0x85, 0x71, 0xa4, 0x60, 0xd9, 0xae, 0xaa, 0x9d, 0xe6, 0x8a, 0xe7, 0x85,
+  0x4f, 0xef, 0x69, 0x34, 0x38, 0x2a, 0x72, 0xf9, 0x95, 0xa0, 0x67, 0x67,
+  0xea, 0xea, 0xf4, 0xbe, 0x31, 0x32, 0x5c, 0xc6, 0x7c, 0x44, 0xbf, 0x22,
+  0xc5, 0x32, 0xbb, 0x41, 0xcf, 0x85, 0x3b, 0xc6, 0xfd, 0xf7, 0xea, 0x8f,
+  0xfd, 0xa6, 0x1b, 0x34, 0xd5, 0xce, 0xd4, 0x90, 0x57, 0x8d, 0xc4, 0x83,
+  0xf0, 0x26, 0x02, 0xa4, 0x40, 0x4d, 0x3c, 0x08, 0x4b, 0xb4, 0x4a, 0x91,
+  0xbe, 0xd0, 0xcc, 0xcd, 0x04, 0x2a, 0x93, 0x87, 0x83, 0xcf, 0x75, 0x92,
+  0x09, 0x84, 0x62, 0xe0, 0xa9, 0x44, 0x27, 0xb7, 0x68, 0xd3, 0x1e, 0xee,
+  0x32, 0xa9, 0x55, 0x7a, 0xc4, 0xd3, 0xc2, 0x0b, 0x6d, 0x9b, 0xa2, 0x51,
+  0x9f, 0x95, 0x52, 0x43, 0x16, 0xfd, 0x7d, 0x27, 0x46, 0xc9, 0x11, 0x3d,
+  0x1d, 0x0e, 0xf4, 0x07, 0x8c, 0x00, 0x30, 0x6c, 0xd7, 0xf0, 0x90, 0x7b,
+  0x87, 0x87, 0x74, 0x25, 0x94, 0xc7, 0xb8, 0xa0, 0x94, 0x75, 0x87, 0x12,
+  0xff, 0x91, 0x74, 0xf4, 0x21, 0xb5, 0x5d, 0x75, 0xcd, 0x64, 0xeb, 0x72,
+  0x51, 0x4e, 0x26, 0x66, 0xf1, 0x5b, 0xaa, 0xa5, 0x98, 0x6f, 0x07, 0xbe,
+  0x64, 0x7f, 0x26, 0x69, 0x75, 0x09, 0x4b, 0x7a, 0x00, 0x33, 0x82, 0x1d,
+  0xf5, 0x34, 0x0b, 0xd7, 0x31, 0x54, 0x3f, 0xaf, 0x90, 0xcf, 0x11, 0x39,
+  0xc3, 0xd9, 0x80, 0x96, 0x00, 0x69, 0x6d, 0x2d, 0xbf, 0x3f, 0x0a, 0x1a,
+  0xe9, 0xa7, 0x3a, 0x3d, 0xce, 0x36, 0xec, 0x4b, 0x97, 0x75, 0x7d, 0x36,
+  0xc0, 0xb6, 0xa4, 0xe5, 0x5a, 0x5e, 0x87, 0xf1, 0x15, 0x6c, 0x41, 0x7b,
+  0x41, 0x5b, 0xff, 0x45, 0x7f, 0x1c, 0x0c, 0xe8, 0xbf, 0x87, 0xff, 0xdc,
+  0x42, 0x08, 0xe6, 0xc5, 0xde, 0xde, 0xcd, 0xcd, 0xcd, 0x48, 0x1a, 0x4a,
+  0x8c, 0xcc, 0x91, 0x7d, 0x16, 0x56, 0xfe, 0x11, 0x0e, 0x5b, 0xcf, 0x07,
+  0x2e, 0x92, 0xad, 0x7c, 0x79, 0xf9, 0xd7, 0x83, 0xe1, 0xc1, 0xfe, 0xfe,
+  0xfe, 0x8f, 0xa3, 0x15, 0xed, 0xef, 0x1c, 0xc3, 0x9a, 0xff, 0xfa, 0xc3,
+  0xee, 0xf1, 0x4c, 0xf6, 0xa2, 0xd0, 0x96, 0xfc, 0x3b, 0xb5, 0xb2, 0x0b,
+  0x6e, 0x4e, 0xc0, 0xa4, 0xfc, 0xc2, 0x63, 0x31, 0x1c, 0x47, 0x4e, 0x37,
+  0xd5, 0xd1, 0x73, 0xea, 0x20, 0x85, 0x10, 0x9e, 0x3c, 0x3a, 0x3c, 0x4c,
+  0x58, 0xe1, 0xe0, 0xf2, 0x34, 0x4e, 0x65, 0x20, 0x64, 0x02, 0xe9, 0xa4,
+  0xcc, 0xb2, 0x6c, 0x4a, 0x00, 0x6d, 0x1c, 0xac, 0x31, 0x94, 0xd1, 0x93,
+  0xd2, 0xc9, 0x86, 0x71, 0x6e, 0x04, 0x79, 0x39, 0xbb, 0x73, 0xa3, 0x1a,
+  0x12, 0xaf, 0x88, 0xb1, 0x52, 0x33, 0x44, 0xae, 0xf9, 0x4a, 0x24, 0x4e,
+  0x21, 0xd9, 0xd6, 0x41, 0x39, 0xa1, 0xb4, 0xf8, 0x82, 0x94, 0x03, 0x1c,
+  0x68, 0x51, 0x4a, 0x3f, 0x5f, 0x44, 0xee, 0xe7, 0xeb, 0x4a, 0xba, 0xb9,
+  0x20, 0xd1, 0xe1, 0x26, 0xbd, 0x6b, 0x09, 0x7b, 0xb3, 0xe3, 0x2f, 0xcd,
+  0x7f, 0x02, 0xbf, 0xb6, 0x5c, 0x4d, 0x52, 0x2d, 0x6d, 0x3b, 0xda, 0x79,
+  0xd6, 0x4c, 0xaf, 0xba, 0xe9, 0x96, 0xe0, 0xe0, 0x66, 0xb6, 0x57, 0x66,
+  0x41, 0x77, 0xb6, 0x71, 0x74, 0xac, 0xd3, 0x9d, 0x57, 0x97, 0x6b, 0x86,
+  0xa4, 0xc6, 0x06, 0x28, 0x4d, 0xe0, 0xc6, 0xd7, 0xcc, 0x14, 0xa3, 0xca,
+  0x51, 0xe6, 0xfa, 0xc3, 0xe1, 0x7b, 0x79, 0xad, 0x65, 0xc3, 0xd3, 0xab,
+  0x6c, 0x29, 0x1c, 0x73, 0x47, 0x73, 0x26, 0xb7, 0x84, 0x06, 0xb7, 0x22,
+  0x16, 0xf9, 0xd6, 0x5c, 0x7f, 0x65, 0x56, 0xb2, 0x2b, 0x85, 0xb7, 0x56,
+  0xcc, 0x49, 0xcf, 0x97, 0xcb, 0x35, 0x19, 0x8e, 0x93, 0x54, 0xe4, 0x89,
+  0xd6, 0x83, 0xf7, 0x64, 0x36, 0x1b, 0xb6, 0x98, 0x55, 0x10, 0x62, 0xf5,
+  0x7a, 0x32, 0x14, 0xcd, 0x07, 0x33, 0x42, 0x72, 0x09, 0xdd, 0xd6, 0x37,
+  0xc7, 0xaf, 0x2f, 0xb8, 0x04, 0xd6, 0xfc, 0x97, 0xaa, 0x65, 0xcc, 0x1f,
+  0x54, 0xf9, 0x1a, 0x36, 0xe4, 0x39, 0x7b, 0xc4, 0x29, 0x44, 0x20, 0x56,
+  0x1b, 0x51, 0x4a, 0x5d, 0x9a, 0x5d, 0x4b, 0xf5, 0x1b, 0x78, 0xed, 0x1d,
+  0x22, 0xb9, 0xc3, 0x2d, 0x2d, 0xd1, 0x56, 0x4e, 0x3f, 0x7e, 0x32, 0xda,
+  0xe7, 0x25, 0xd2, 0x1e, 0x4a, 0x06, 0x8d, 0x54, 0x6a, 0xc1, 0x8d, 0xa4,
+  0x11, 0xc6, 0x34, 0x9e, 0x33, 0x60, 0xa7, 0x32, 0x48, 0x18, 0xe7, 0x99,
+  0xa1, 0x14, 0xf4, 0xb7, 0x5e, 0xb6, 0xe4, 0x3d, 0xe5, 0x30, 0x2a, 0xbb,
+  0x24, 0x47, 0xf8, 0xae, 0x8b, 0xd1, 0x0b, 0x04, 0x65, 0xad, 0xd2, 0x01,
+  0x13, 0x8e, 0x95, 0xcb, 0x09, 0x4d, 0x48, 0xde, 0xf8, 0xc0, 0x75, 0xd8,
+  0x29, 0x49, 0x0a, 0x88, 0xcc, 0x92, 0xea, 0x23, 0x74, 0xa4, 0x74, 0x2d,
+  0xdd, 0x62, 0xfa, 0x49, 0xd0, 0xba, 0x68, 0xf8, 0x67, 0xe9, 0x29, 0xcc,
+  0x7a, 0x72, 0xac, 0xf4, 0x0b, 0x67, 0xb9, 0xab, 0x69, 0xae, 0x6c, 0xba,
+  0xaa, 0xca, 0x39, 0x22, 0x87, 0x21, 0x9f, 0x7c, 0xd3, 0xed, 0x3e, 0x9d,
+  0x05, 0x36, 0x0e, 0xf0, 0x4d, 0xbc, 0xea, 0xbe, 0x14, 0xcb, 0x63, 0x11,
+  0xc1, 0x86, 0x1e, 0x47, 0x86, 0xb6, 0xfe, 0x48, 0x21, 0xa1, 0x2f, 0x5e,
+  0xd9, 0x08, 0x62, 0x1c, 0xca, 0x08, 0xea, 0x54, 0xcd, 0xfc, 0xad, 0x6d,
+  0xcc, 0x08, 0x4f, 0x23, 0xbe, 0x9f, 0xdd, 0x32, 0x66, 0x27, 0x4e, 0xee,
+  0x26, 0x2f, 0x1e, 0x1d, 0x26, 0xf5, 0x9d, 0xd1, 0x20, 0x96, 0xfe, 0x26,
+  0x74, 0x1b, 0x2b, 0x47, 0x43, 0x61, 0xad, 0x8e, 0x64, 0xcc, 0xba, 0x3e,
+  0xd0, 0x2b, 0xaf, 0xf0, 0x8a, 0x74, 0x31, 0xd2, 0x7c, 0xbd, 0x07, 0x74,
+  0xeb, 0x2e, 0x95, 0x89, 0x4d, 0x16, 0x69, 0xf1, 0xc9, 0x66, 0x55, 0xf3,
+  0x40, 0x03, 0x6a, 0x82, 0xc9, 0x85, 0xa4, 0xee, 0x87, 0xb2, 0x3d, 0x2c,
+  0x18, 0x83, 0x6e, 0x51, 0x50, 0xec, 0x97, 0x69, 0x85, 0x1a, 0x43, 0x6c,
+  0x9b, 0xa4, 0x3f, 0x3f, 0xa8, 0x25, 0x78, 0x28, 0xc2, 0x38, 0xc6, 0xce,
+  0xb8, 0x3f, 0x9a, 0x43, 0xde, 0xd3, 0xf9, 0xea, 0x97, 0x8b, 0xad, 0xaf,
+  0xf5, 0x24, 0x0c, 0xd7, 0x36, 0xff, 0x7d, 0xa1, 0x01, 0xc0, 0x3e, 0xfe,
+  0xdd, 0x08, 0x56, 0x99, 0xeb, 0xec, 0x6c, 0x43, 0x86, 0x7e, 0xab, 0x4e,
+  0x56, 0xf1, 0x5c, 0xa8, 0x32, 0x16, 0x61, 0x1f, 0x25, 0xa7, 0xce, 0x9c,
+  0x2c, 0x06, 0xc0, 0xc4, 0x6d, 0xaa, 0xa9, 0x18, 0x93, 0xf8, 0xbb, 0xa4,
+  0x6e, 0xa6, 0x8b, 0x68, 0xeb, 0x69, 0x68, 0x39, 0x35, 0x65, 0x45, 0xde,
+  0x39, 0xdd, 0xcf, 0x13, 0x71, 0xdc, 0x15, 0xd2, 0xf1, 0x63, 0xb3, 0xb5,
+  0xd4, 0x3e, 0x11, 0xd0, 0x55, 0x41, 0x66, 0x36, 0x2f, 0x22, 0xda, 0x48,
+  0x24, 0xbe, 0xde, 0x5a, 0x22, 0xf9, 0x0b, 0x23, 0x13, 0xd7, 0x2b, 0x1b,
+  0x7a, 0x48, 0x04, 0xa4, 0x81, 0xd0, 0x5f, 0xca, 0x62, 0x10, 0xe0, 0x3b,
+  0x21, 0x76, 0x2e, 0x4e, 0x27, 0xca, 0x0a, 0x5c, 0x4a, 0xaf, 0xe2, 0xcc,
+  0xba, 0x9a, 0xf9, 0x4d, 0x25, 0x4f, 0xf7, 0xf1, 0x7b, 0x5a, 0xaa, 0x72,
+  0xcf, 0x13, 0x3d, 0x0c, 0x43, 0x83, 0x03, 0xae, 0xe5, 0x0b, 0x96, 0x74,
+  0x5a, 0xe8, 0x8d, 0x14, 0xb8, 0xa9, 0x9c, 0x0b, 0xa9, 0x6b, 0x7f, 0xaf,
+  0xae, 0xa8, 0x39, 0x8d, 0xe7, 0xfd, 0x10, 0xcc, 0x2e, 0xa3, 0x6f, 0x06,
+  0xfa, 0x32, 0xa0, 0xd6, 0x39, 0x13, 0xd1, 0xec, 0x30, 0xe9, 0x2a, 0xc8,
+  0xe7, 0xa1, 0x84, 0x49, 0x97, 0x9e, 0x4c, 0x1a, 0x45, 0x56, 0xb0, 0x5d,
+  0x5f, 0x2a, 0xf8, 0x5a, 0x32, 0x0d, 0xb1, 0x13, 0x67, 0x0c, 0xad, 0x5b,
+  0xf3, 0x88, 0xb6, 0x91, 0xf3, 0xa5, 0x48, 0x91, 0x9a, 0xd2, 0x3c, 0x0d,
+  0x43, 0xe3, 0xa6, 0x1b, 0xb4, 0x39, 0xb5, 0xdb, 0xf9, 0x48, 0xf3, 0x1c,
+  0x5e, 0x69, 0xa2, 0xed, 0x02, 0xee, 0x7c, 0xc8, 0x5f, 0x73, 0x1b, 0xae,
+  0x73, 0xde, 0x7b, 0x86, 0x33, 0x9b, 0x54, 0x79, 0x36, 0x37, 0xdc, 0x0b,
+  0x4b, 0xe2, 0x14, 0xd2, 0xc0, 0x6b, 0x94, 0xa5, 0x15, 0xc4, 0x1f, 0x69,
+  0x07, 0x54, 0x40, 0x9c, 0xc3, 0x71, 0xc4, 0x3c, 0xd1, 0x82, 0xcb, 0x31,
+  0x98, 0xf6, 0xb5, 0x36, 0xa8, 0x4d, 0xb5, 0xa4, 0x29, 0x9a, 0x9f, 0x89,
+  0x7e, 0xd3, 0xe2, 0xf1, 0x24, 0x02, 0x2b, 0xe8, 0x16, 0xdb, 0x86, 0x75,
+  0xf8, 0x22, 0xb3, 0x55, 0xd1, 0x6e, 0xbc, 0xae, 0x47, 0x3d, 0x1d, 0x44,
+  0x61, 0x3f, 0x7d, 0x93, 0x55, 0x46, 0xfc, 0x95, 0x66, 0xdd, 0xdf, 0x3e,
+  0xd1, 0x28, 0x84, 0x34, 0xdf, 0x16, 0x65, 0x44, 0x6e, 0x29, 0x1a, 0xc1,
+  0x61, 0xea, 0x41, 0xf8, 0x82, 0x8b, 0x37, 0x68, 0x6f, 0xf5, 0x4d, 0x5f,
+  0x21, 0xe9, 0x52, 0xe8, 0x00, 0x20, 0xc5, 0x86, 0xfa, 0x48, 0xbd, 0x8c,
+  0x77, 0x59, 0xb2, 0xad, 0xbe, 0x49, 0xfd, 0x33, 0x1a, 0x16, 0x51, 0x0b,
+  0xb9, 0xf3, 0xa8, 0x53, 0xf8, 0xa4, 0x49, 0xb9, 0x51, 0xb1, 0x9d, 0xf9,
+  0x45, 0x4e, 0x0e, 0x1f, 0xcd, 0x73, 0x8a, 0x96, 0xf5, 0x48, 0x17, 0x76,
+  0x87, 0x0f, 0xde, 0x49, 0x8f, 0x20, 0x2d, 0xb2, 0xbe, 0x22, 0x45, 0x8c,
+  0xf4, 0x03, 0x18, 0xf9, 0x71, 0xf5, 0x1e, 0x9b, 0xf6, 0xfe, 0xe2, 0xe4,
+  0xdd, 0xa0, 0x73, 0xed, 0x44, 0xa5, 0xf1, 0x2c, 0x62, 0x65, 0x39, 0x42,
+  0x53, 0x21, 0x26, 0x40, 0x95, 0xc8, 0x7e, 0xd8, 0x12, 0x43, 0xc6, 0xa4,
+  0xa0, 0xad, 0x1b, 0x48, 0x32, 0x4e, 0x25, 0xa5, 0x6b, 0x6a, 0xf6, 0xf3,
+  0xbe, 0x86, 0x9e, 0x6c, 0x22, 0xc2, 0x1a, 0x67, 0x0f, 0x57, 0x89, 0x91,
+  0x27, 0x86, 0xd9, 0x78, 0x0d, 0xf6, 0x42, 0x8e, 0xe5, 0xb4, 0x62, 0xf7,
+  0x55, 0x5e, 0x0a, 0xb1, 0x17, 0x6e, 0x0c, 0x90, 0xbc, 0x29, 0x6f, 0x8a,
+  0xe1, 0x09, 0x55, 0x1f, 0x27, 0x27, 0xe5, 0x25, 0xdd, 0xa0, 0xf7, 0x80,
+  0x8f, 0x0a, 0x4e, 0xed, 0xc3, 0xd9, 0xfb, 0x64, 0x87, 0xe4, 0x6e, 0x72,
+  0x66, 0x31, 0xe7, 0xe8, 0xd1, 0x5d, 0x31, 0x31, 0x6a, 0x56, 0x49, 0x64,
+  0x36, 0x83, 0xe4, 0xe8, 0xfb, 0x57, 0xef, 0xce, 0x4e, 0x8e, 0x7e, 0xe0,
+  0x04, 0x99, 0x60, 0x39, 0xf4, 0xe3, 0x2f, 0x3d, 0x9b, 0x0b, 0x11, 0x1a,
+  0x4a, 0x1a, 0x34, 0x33, 0x89, 0x02, 0xce, 0x10, 0x75, 0x32, 0x5b, 0x54,
+  0x12, 0x1c, 0x8f, 0xcf, 0x8e, 0x87, 0x8a, 0x16, 0xc7, 0x3d, 0x19, 0xf3,
+  0x82, 0xcc, 0x23, 0x98, 0xd8, 0xda, 0xce, 0x81, 0xa8, 0x68, 0x18, 0x38,
+  0x65, 0xe4, 0x3e, 0x0c, 0x92, 0xf7, 0x9a, 0x8a, 0x38, 0xc0, 0xa1, 0xd3,
+  0x1d, 0x7c, 0x93, 0x5f, 0x22, 0xa2, 0xd4, 0xc9, 0x21, 0x13, 0x03, 0x84,
+  0xe8, 0x20, 0xc0, 0x62, 0xf4, 0xba, 0x69, 0xd5, 0xd9, 0x82, 0x9d, 0x97,
+  0xbd, 0xf2, 0x91, 0x59, 0x24, 0x4e, 0x11, 0x75, 0x22, 0x41, 0xa8, 0x4c,
+  0xea, 0x46, 0x26, 0xad, 0x36, 0x5e, 0x96, 0x42, 0x58, 0x2a, 0x88, 0x2e,
+  0x61, 0xd9, 0xfe, 0x8b, 0x64, 0x6b, 0xb8, 0x4e, 0x5e, 0x6c, 0xfd, 0x8a,
+  0x2a, 0x82, 0xef, 0xe9, 0x8d, 0x34, 0x05, 0xd2, 0xa2, 0x5d, 0x1b, 0x14,
+  0x10, 0xa8, 0x16, 0xb6, 0x66, 0xd4, 0xe1, 0x06, 0x9f, 0xb9, 0xb9, 0xe9,
+  0xa2, 0xd0, 0x4f, 0xd6, 0x97, 0x97, 0x11, 0x38, 0x17, 0xea, 0x38, 0x96,
+  0xc1, 0xfd, 0x43, 0xde, 0x94, 0xed, 0x3a, 0x61, 0x1f, 0xbe, 0x99, 0xff,
+  0x16, 0xe2, 0x92, 0xcc, 0x43, 0xae, 0xca, 0x72, 0x46, 0xaa, 0xea, 0xab,
+  0x84, 0x03, 0x10, 0x14, 0xa5, 0xa8, 0x9a, 0x70, 0x38, 0xd6, 0xde, 0xb6,
+  0xff, 0xb4, 0x6d, 0xa3, 0xac, 0x5b, 0xa2, 0x57, 0x81, 0x5f, 0x6f, 0xb1,
+  0x12, 0x3b, 0xe1, 0xc6, 0x9e, 0x83, 0x64, 0xfb, 0xe5, 0xb6, 0x3c, 0xb7,
+  0x15, 0x55, 0xd1, 0xf8, 0x1d, 0x8e, 0xf0, 0xb1, 0x56, 0x3d, 0xb5, 0x2e,
+  0x50, 0x52, 0xfe, 0xf2, 0xd9, 0x2c, 0x83, 0xd8, 0x96, 0xde, 0x78, 0x09,
+  0x23, 0x3c, 0x0e, 0xc4, 0xf7, 0xd3, 0x55, 0x39, 0x30, 0x75, 0x9d, 0x39,
+  0xcf, 0x95, 0x5a, 0xb6, 0xf1, 0x0c, 0xbc, 0x0e, 0xb2, 0x14, 0x92, 0x70,
+  0xbd, 0xcc, 0xe4, 0xab, 0x7d, 0x37, 0x85, 0xd3, 0x4a, 0xc9, 0x38, 0x86,
+  0x26, 0x1c, 0x2d, 0x20, 0x1c, 0x74, 0x6a, 0xf3, 0x10, 0xd7, 0x0a, 0xdd,
+  0x97, 0x7c, 0x7c, 0x20, 0x1e, 0x33, 0xf2, 0x76, 0x45, 0xd8, 0x65, 0xdc,
+  0xe2, 0x9d, 0x5a, 0xe0, 0xf5, 0x7c, 0x5f, 0x3d, 0xbb, 0x8e, 0xf0, 0x58,
+  0xd4, 0x6a, 0x81, 0x04, 0x69, 0x13, 0x78, 0x50, 0x74, 0x01, 0xb5, 0xed,
+  0x06, 0x21, 0x9a, 0x0d, 0x77, 0xd0, 0x92, 0xde, 0xa8, 0x43, 0x1b, 0x7a,
+  0x6a, 0xc7, 0x4a, 0xb5, 0x4a, 0x38, 0xe6, 0x66, 0xf5, 0xcb, 0x6d, 0xdb,
+  0x5d, 0xda, 0xc4, 0x95, 0x8d, 0x06, 0x03, 0x1b, 0x2b, 0xb5, 0x5b, 0xf5,
+  0x9b, 0xa3, 0x7e, 0x08, 0x35, 0x3f, 0xf0, 0x16, 0x26, 0x7f, 0x46, 0xc3,
+  0x22, 0xdf, 0xca, 0xad, 0xaa, 0x43, 0x3b, 0xeb, 0x8d, 0x04, 0xce, 0xfc,
+  0x68, 0x94, 0x94, 0x0a, 0xb2, 0xd7, 0xb0, 0xd0, 0x56, 0x44, 0x1c, 0x9f,
+  0xd7, 0xb4, 0x81, 0x1c, 0xde, 0xfd, 0x7a, 0x14, 0x51, 0x61, 0x59, 0x27,
+  0x05, 0xc9, 0xc9, 0x6a, 0xd8, 0xbd, 0x8e, 0x50, 0x9a, 0xbe, 0xaf, 0x19,
+  0x3b, 0xe8, 0x3d, 0xcd, 0x43, 0xc7, 0x42, 0xab, 0x90, 0x1f, 0x8f, 0x2a,
+  0x6e, 0xc1, 0x7e, 0x27, 0x89, 0x35, 0xdc, 0x9e, 0xb8, 0xf8, 0xa4, 0x19,
+  0x94, 0x34, 0x78, 0x76, 0x9b, 0x4d, 0xd7, 0x4d, 0xbb, 0x04, 0xce, 0x9b,
+  0x93, 0x22, 0x3b, 0xf1, 0xb4, 0x76, 0x70, 0x15, 0x04, 0xf0, 0x66, 0xeb,
+  0x4c, 0x61, 0x79, 0x5e, 0x6c, 0xed, 0x4a, 0x1c, 0x37, 0x65, 0x0d, 0x9e,
+  0x7f, 0x1c, 0x8b, 0xcf, 0xea, 0x9c, 0xab, 0x8c, 0xdd, 0xa9, 0x2e, 0x59,
+  0x21, 0xfa, 0x79, 0x43, 0xa4, 0xd5, 0x2c, 0xf6, 0xed, 0xb7, 0xec, 0x7b,
+  0xf3, 0x3e, 0x6d, 0xdb, 0x12, 0x8a, 0x5b, 0xae, 0x0e, 0xae, 0x72, 0xf0,
+  0x65, 0xb4, 0x67, 0x1e, 0x25, 0xaf, 0x6c, 0x6f, 0x75, 0x7d, 0x55, 0xf7,
+  0x3f, 0x70, 0x87, 0x1e, 0x9f, 0x5d, 0x3f, 0x15, 0x6f, 0x36, 0xa9, 0x1c,
+  0x24, 0xf3, 0xf0, 0x23, 0xcb, 0xf1, 0x83, 0x55, 0x7c, 0xaa, 0x26, 0x8f,
+  0xcd, 0x1f, 0xdf, 0xd0, 0x1f, 0x73, 0x76, 0x0b, 0x08, 0xa8, 0x1e, 0xfb,
+  0x61, 0x43, 0xd2, 0x1e, 0x9f, 0xd8, 0x3f, 0x6c, 0xa2, 0x96, 0x39, 0x75,
+  0xaa, 0x54, 0x24, 0x08, 0x3e, 0x07, 0x86, 0x04, 0xd3, 0x46, 0xc7, 0x19,
+  0x68, 0xfd, 0x70, 0xbc, 0xbe, 0x03, 0x88, 0x71, 0x03, 0x20, 0xb2, 0x0d,
+  0xe0, 0x73, 0x1a, 0x33, 0x23, 0x2f, 0x63, 0xf5, 0xa3, 0x66, 0xab, 0xfe,
+  0x41, 0x71, 0x38, 0x5b, 0xca, 0x3e, 0xcb, 0x34, 0xb7, 0x42, 0x48, 0xd0,
+  0xcb, 0xe7, 0x60, 0xef, 0x34, 0x5d, 0x33, 0x66, 0x67, 0x61, 0x42, 0xaa,
+  0x05, 0xca, 0xeb, 0x5b, 0x32, 0x84, 0xbb, 0xfc, 0x11, 0x62, 0xce, 0xf6,
+  0xbf, 0xf7, 0x06, 0xf5, 0xd3, 0x72, 0xe1, 0xf9, 0x2a, 0xc0, 0xf9, 0x91,
+  0xda, 0xc3, 0xe6, 0x8c, 0x18, 0x9c, 0x0e, 0x1e, 0x16, 0x5b, 0x87, 0x15,
+  0x93, 0x9e, 0x79, 0x2e, 0xd1, 0x1a, 0x8f, 0x9a, 0x6e, 0x80, 0x2b, 0x7c,
+  0xd2, 0x68, 0xf5, 0x32, 0x5b, 0x52, 0xe0, 0xcb, 0xca, 0x45, 0xc1, 0xf0,
+  0x22, 0xc5, 0x0a, 0x1f, 0x1f, 0xc6, 0x87, 0x9b, 0x91, 0xfe, 0x46, 0x22,
+  0x96, 0xd3, 0xb7, 0xfe, 0x2d, 0x88, 0x76, 0xd6, 0x77, 0xc5, 0xf4, 0xea,
+  0xcd, 0xfb, 0x71, 0xfc, 0xf5, 0x70, 0x71, 0x78, 0xde, 0xe8, 0x21, 0x44,
+  0x0c, 0x50, 0x60, 0x04, 0xc4, 0xd2, 0x28, 0x79, 0xaf, 0xbc, 0xdf, 0xc5,
+  0x87, 0x6b, 0xbd, 0x60, 0x3d, 0x81, 0xa4, 0x58, 0x30, 0x13, 0x17, 0xcd,
+  0x13, 0x61, 0x97, 0x61, 0x4a, 0x57, 0x81, 0x96, 0x17, 0x2a, 0xd0, 0xf6,
+  0x4e, 0x53, 0xc0, 0x08, 0x1d, 0xe2, 0x31, 0x64, 0xe5, 0x25, 0xa0, 0x75,
+  0xe9, 0x1a, 0x0d, 0x77, 0xf4, 0x8f, 0x9f, 0x72, 0xcc, 0x27, 0xc6, 0xa2,
+  0xcd, 0x22, 0xc1, 0x45, 0x7f, 0x87, 0x5a, 0x09, 0x41, 0x5e, 0xf0, 0xd7,
+  0xd0, 0xea, 0x82, 0x5e, 0x67, 0x32, 0x1d, 0x08, 0xb5, 0xe2, 0x47, 0x55,
+  0xdf, 0x92, 0xcc, 0xa6, 0x1c, 0x7e, 0xf5, 0xe7, 0x50, 0x7a, 0xbe, 0x79,
+  0xdf, 0xf3, 0x39, 0xfa, 0xcd, 0x50, 0xab, 0x09, 0x45, 0x23, 0xf0, 0x54,
+  0xfa, 0x70, 0x2f, 0x04, 0x0b, 0x39, 0x3e, 0x01, 0x05, 0x4a, 0xbe, 0x87,
+  0x4b, 0x98, 0x27, 0xe4, 0x8f, 0x8d, 0x0f, 0x4a, 0x4e, 0x7f, 0xfc, 0x53,
+  0x94, 0xec, 0xbf, 0xc3, 0x09, 0x7e, 0xc9, 0x39, 0x07, 0x71, 0xcf, 0x44,
+  0x13, 0xde, 0x8d, 0x1c, 0x91, 0xfb, 0x4c, 0x7c, 0x38, 0xe2, 0x6f, 0x31,
+  0x48, 0x2a, 0xe2, 0x0b, 0x87, 0xfc, 0xc7, 0xde, 0xa1, 0x4d, 0x4e, 0xb3,
+  0x05, 0xa1, 0xb8, 0xa4, 0x46, 0x80, 0x87, 0x0a, 0x42, 0x91, 0xdf, 0x8e,
+  0x91, 0x4f, 0xd0, 0x43, 0xcd, 0x48, 0x3c, 0xe0, 0x8c, 0x03, 0xbb, 0x07,
+  0x34, 0x51, 0xd5, 0xc4, 0xa2, 0x33, 0x19, 0xb3, 0xfb, 0xee, 0x3e, 0x62,
+  0xca, 0x23, 0xf9, 0x74, 0x9b, 0x70, 0x37, 0xdf, 0x19, 0x25, 0x89, 0x84,
+  0xeb, 0xfd, 0xd7, 0xd8, 0xd2, 0x8d, 0x7d, 0x27, 0xd9, 0x99, 0x18, 0x89,
+  0xed, 0xe1, 0xe8, 0x10, 0xbf, 0x79, 0x8c, 0x12, 0x96, 0xf8, 0x70, 0x4f,
+  0x3e, 0x7f, 0xf2, 0x78, 0x77, 0x77, 0x20, 0xae, 0x2a, 0xce, 0x8e, 0x99,
+  0x50, 0x31, 0x56, 0x4e, 0x7c, 0x8b, 0xe3, 0x4c, 0xb4, 0xc1, 0x57, 0xdc,
+  0x57, 0x89, 0xbf, 0x1b, 0x89, 0x80, 0x3b, 0x83, 0xcf, 0xbe, 0x4a, 0x87,
+  0x48, 0x26, 0x38, 0x38, 0xba, 0x35, 0x83, 0x53, 0xe5, 0x89, 0xb5, 0x0b,
+  0xba, 0xf4, 0x72, 0x05, 0x38, 0x52, 0x9c, 0x87, 0x91, 0xdc, 0x4a, 0x1c,
+  0x2f, 0x4e, 0x55, 0xd2, 0x86, 0x89, 0xa0, 0x67, 0x2c, 0xf6, 0xe8, 0x0f,
+  0xa2, 0xe7, 0x2b, 0x6d, 0x54, 0x7b, 0xb6, 0x9e, 0x2c, 0x8c, 0x04, 0x1a,
+  0xaf, 0xe7, 0x73, 0x73, 0xd6, 0x27, 0xb9, 0xb4, 0x1c, 0x16, 0x5b, 0x81,
+  0xdd, 0xe4, 0x91, 0xfa, 0x1b, 0x3f, 0xb8, 0x08, 0x4a, 0x63, 0x52, 0x6b,
+  0xd5, 0xcd, 0xb8, 0x12, 0x6e, 0xd6, 0xdb, 0xb6, 0x56, 0xfc, 0xad, 0x7a,
+  0x3d, 0x1f, 0xf6, 0x2d, 0xec, 0x36, 0xab, 0x43, 0x33, 0xee, 0x1d, 0xc5,
+  0x6d, 0x8d, 0xc0, 0x7e, 0x30, 0x7f, 0xb2, 0xbd, 0x7d, 0xdb, 0x29, 0xbb,
+  0x56, 0xef, 0xbc, 0x21, 0xbd, 0x13, 0x18, 0x3c, 0x14, 0xcd, 0x48, 0x5e,
+  0xb2, 0x86, 0x19, 0xed, 0xf6, 0xca, 0x2d, 0x09, 0x05, 0x0c, 0xc1, 0xd7,
+  0x45, 0xa1, 0xd6, 0xc3, 0xef, 0x9f, 0xce, 0x29, 0x31, 0x99, 0x93, 0x30,
+  0x17, 0x19, 0x32, 0xba, 0x89, 0x3f, 0x86, 0xa8, 0x24, 0x95, 0xe0, 0xbf,
+  0x8b, 0xd7, 0x20, 0x11, 0xe7, 0x87, 0x38, 0xf1, 0x91, 0x5e, 0x97, 0x02,
+  0x58, 0x09, 0x4e, 0x20, 0xc6, 0xf3, 0xe1, 0x58, 0x82, 0xd9, 0x97, 0x59,
+  0xcc, 0xb0, 0x6b, 0x87, 0x78, 0x14, 0x6c, 0xa1, 0x66, 0x3f, 0xa8, 0x7c,
+  0x25, 0xf4, 0xdd, 0xd0, 0x71, 0x85, 0x96, 0x58, 0x03, 0x9b, 0x38, 0xd9,
+  0xe2, 0xf9, 0x6c, 0x09, 0x1c, 0x8a, 0xd6, 0xc9, 0x21, 0x01, 0x4b, 0x0d,
+  0x07, 0x56, 0xbd, 0x65, 0x7c, 0xf6, 0xee, 0x45, 0x62, 0xea, 0xa2, 0x4a,
+  0x7e, 0xa9, 0x79, 0x5c, 0x5b, 0x89, 0xf4, 0xb0, 0xef, 0x74, 0xe0, 0x96,
+  0xe1, 0xec, 0xae, 0x44, 0x10, 0x17, 0x38, 0x33, 0x02, 0x49, 0xea, 0x74,
+  0x6a, 0x66, 0xd0, 0xe1, 0x56, 0x5c, 0x9f, 0xb6, 0x7b, 0x40, 0x8e, 0xd8,
+  0x0c, 0xc6, 0x6d, 0xcb, 0xf0, 0xd3, 0xaf, 0xa8, 0x9d, 0x4f, 0xe9, 0xdd,
+  0x4d, 0xde, 0xac, 0x43, 0xa6, 0x2b, 0x91, 0x62, 0xe0, 0x53, 0x20, 0x34,
+  0x41, 0x27, 0xe1, 0x40, 0x24, 0x60, 0xe5, 0x51, 0xb2, 0x5b, 0x03, 0x70,
+  0x68, 0xcb, 0x24, 0xa8, 0x17, 0x89, 0x51, 0x48, 0x6e, 0x82, 0x0c, 0x71,
+  0x02, 0x30, 0x75, 0xb3, 0x6b, 0x57, 0xc0, 0x99, 0x01, 0x7e, 0xff, 0x5f,
+  0xfa, 0xcb, 0x8f, 0xb4, 0x59, 0xff, 0xd4, 0xcd, 0x92, 0x69, 0xa7, 0x01,
+  0x4c, 0x02, 0xcc, 0xeb, 0xdf, 0x63, 0x53, 0xfe, 0x46, 0x49, 0x4d, 0xbc,
+  0x33, 0x04, 0x50, 0x84, 0xe1, 0x7e, 0x3f, 0xb2, 0x6a, 0xb4, 0x0e, 0x41,
+  0x65, 0xdf, 0xec, 0x2c, 0x98, 0xdc, 0x05, 0x2e, 0x29, 0xa2, 0xc1, 0x1f,
+  0x8a, 0x01, 0xa0, 0x96, 0x8d, 0x45, 0x47, 0x28, 0x2d, 0xdc, 0x31, 0x94,
+  0x8f, 0xf1, 0x87, 0x4a, 0x30, 0x87, 0x8c, 0x2d, 0x63, 0x26, 0x4e, 0x76,
+  0x1e, 0xff, 0x3c, 0x6e, 0x58, 0xd8, 0x74, 0x59, 0xdd, 0xe7, 0x16, 0x08,
+  0x95, 0x19, 0x89, 0x9a, 0x61, 0xab, 0x29, 0x3e, 0x51, 0xfc, 0x17, 0x26,
+  0xd5, 0xee, 0xd9, 0x03, 0xa3, 0x45, 0x20, 0xa8, 0xf5, 0x55, 0x6e, 0xda,
+  0x66, 0x83, 0x7a, 0xbf, 0xff, 0x2f, 0x4e, 0x04, 0xfc, 0x67, 0xa8, 0xfb,
+  0x9e, 0x5e, 0x1c, 0xbd, 0xc0, 0x94, 0x7e, 0x3f, 0xac, 0xef, 0x96, 0x93,
+  0x72, 0x21, 0xb7, 0x8e, 0xf6, 0xde, 0x6c, 0xa0, 0xfe, 0x8c, 0x69, 0x04,
+  0xb1, 0xba, 0xa1, 0x07, 0x60, 0x32, 0x88, 0xf6, 0xa6, 0x80, 0x1d, 0x96,
+  0x94, 0x53, 0x2e, 0x68, 0xa5, 0xda, 0x05, 0x73, 0xfb, 0x7e, 0x9f, 0x28,
+  0x2a, 0x09, 0xb7, 0xe0, 0x94, 0x46, 0xab, 0x1e, 0x68, 0x66, 0xbc, 0xc8,
+  0x32, 0xba, 0x7f, 0x1e, 0xa1, 0x58, 0xeb, 0x29, 0x06, 0xfd, 0x42, 0xcc,
+  0xc2, 0x4c, 0xf3, 0x23, 0xaa, 0x26, 0xf9, 0xd5, 0xd7, 0xfc, 0xa3, 0xe1,
+  0x05, 0xfd, 0x48, 0x72, 0x68, 0x14, 0x6a, 0x80, 0xa8, 0x53, 0x2b, 0x4f,
+  0x06, 0x91, 0x02, 0xe5, 0x24, 0x96, 0x9a, 0x87, 0x9e, 0xe5, 0x45, 0x28,
+  0x91, 0xf5, 0x5e, 0x7f, 0xcc, 0x80, 0xc8, 0x9b, 0x5f, 0x67, 0x9b, 0x47,
+  0x03, 0x5d, 0x10, 0x67, 0x5e, 0xa2, 0xe3, 0xa3, 0x4d, 0xef, 0xf4, 0x91,
+  0x59, 0x18, 0x17, 0x8d, 0xa3, 0xa9, 0xa3, 0xfb, 0x86, 0xe3, 0xa8, 0x0a,
+  0xdc, 0x3d, 0x92, 0xfa, 0x43, 0xce, 0x35, 0xaf, 0x43, 0x46, 0x43, 0xe5,
+  0x38, 0xc8, 0x37, 0xa2, 0x71, 0xef, 0x59, 0x2b, 0x00, 0x32, 0x99, 0x71,
+  0x89, 0xd7, 0x2c, 0x12, 0xdf, 0x96, 0xac, 0x3e, 0x0a, 0x85, 0x6f, 0x1e,
+  0xce, 0xc5, 0xc9, 0x25, 0x32, 0x75, 0x8c, 0xae, 0xc4, 0x25, 0x67, 0x1f,
+  0x62, 0x9e, 0xa8, 0x63, 0x59, 0x92, 0xdf, 0x36, 0x12, 0x67, 0x4e, 0x62,
+  0x6e, 0x3c, 0x44, 0x47, 0xff, 0x73, 0xe0, 0xa6, 0xc3, 0xbe, 0xad, 0xa1,
+  0x17, 0x66, 0x1f, 0x09, 0xe4, 0xe5, 0xe6, 0xe1, 0x38, 0xff, 0xfe, 0xe9,
+  0x68, 0x7f, 0x37, 0x38, 0xd4, 0x66, 0xf5, 0xd1, 0x10, 0x47, 0x75, 0xf7,
+  0x91, 0xb2, 0x54, 0x71, 0x66, 0x1a, 0x55, 0xc0, 0x0f, 0xb0, 0xb5, 0x8c,
+  0x5e, 0xb0, 0x5e, 0xd1, 0x38, 0x20, 0xf2, 0x45, 0xc9, 0x26, 0xdb, 0x7d,
+  0xcb, 0x90, 0x08, 0xb5, 0x24, 0x34, 0xfa, 0x20, 0x3a, 0x3b, 0xed, 0x1e,
+  0x70, 0x8f, 0x83, 0x89, 0x51, 0x06, 0xca, 0x47, 0x84, 0xae, 0x2d, 0x31,
+  0x19, 0xc9, 0x97, 0x55, 0xf9, 0xd4, 0x6f, 0x88, 0x8a, 0x07, 0x40, 0x4f,
+  0x8c, 0x0c, 0x4a, 0xb1, 0xec, 0x28, 0x08, 0x72, 0xe7, 0x7f, 0xf0, 0xff,
+  0xba, 0x88, 0x95, 0x26, 0x3b, 0x42, 0x04, 0x9a, 0x69, 0x52, 0x5e, 0x8d,
+  0x97, 0x7f, 0x10, 0xa2, 0xd4, 0x77, 0xfe, 0x07, 0x94, 0xf5, 0xc3, 0x44,
+  0xca, 0x2a, 0xf2, 0xb4, 0xb6, 0x33, 0xe4, 0x25, 0xe0, 0x4a, 0x61, 0xc1,
+  0x82, 0x77, 0x76, 0xef, 0x3d, 0xe4, 0x0c, 0x34, 0x52, 0x40, 0x46, 0x3d,
+  0x3b, 0xc3, 0x89, 0xc3, 0xdd, 0x9d, 0xe9, 0xdf, 0x10, 0x5d, 0xf3, 0x70,
+  0xf3, 0xb7, 0x15, 0x18, 0x6e, 0x47, 0xa2, 0x78, 0xd0, 0xce, 0x77, 0x39,
+  0x5b, 0x0e, 0xc4, 0xa0, 0x20, 0x72, 0xc2, 0x62, 0xee, 0xb9, 0xb5, 0x3b,
+  0xed, 0xde, 0xb7, 0x3d, 0xe7, 0x6c, 0x8b, 0x80, 0x98, 0x69, 0xd0, 0xcf,
+  0xbc, 0xca, 0x20, 0xd6, 0x4a, 0x69, 0x3d, 0x89, 0x65, 0x3d, 0x0a, 0x2a,
+  0xf0, 0x13, 0x3e, 0xff, 0x64, 0x3f, 0x42, 0xff, 0x48, 0x1f, 0xfe, 0x98,
+  0xaf, 0x7c, 0x9e, 0x75, 0x7c, 0x86, 0xb6, 0xa3, 0xa8, 0x7d, 0x11, 0x86,
+  0xca, 0x59, 0xc6, 0x94, 0x74, 0x21, 0x3f, 0xc0, 0xcd, 0xbe, 0x77, 0x33,
+  0xa7, 0x0c, 0x7f, 0x00, 0x87, 0x80, 0x87, 0x14, 0x31, 0x54, 0x25, 0x4d,
+  0xfd, 0x03, 0xe4, 0xf5, 0x7a, 0x1c, 0x09, 0x44, 0x25, 0x11, 0x77, 0x99,
+  0xbf, 0xa4, 0xc3, 0xe7, 0xbd, 0x4b, 0x82, 0x81, 0x65, 0x97, 0xc4, 0xf3,
+  0x6f, 0x75, 0xda, 0x68, 0x2f, 0xc4, 0x9b, 0xe9, 0x3d, 0x4b, 0x72, 0xcb,
+  0xb8, 0x77, 0x26, 0xe6, 0x4b, 0x1f, 0x1d, 0x46, 0x7b, 0xf2, 0xde, 0x7e,
+  0xd8, 0x28, 0x26, 0x0e, 0xbc, 0x1d, 0x2d, 0xe4, 0x73, 0x6d, 0x29, 0x3d,
+  0x45, 0x68, 0x3d, 0xaa, 0x51, 0x27, 0x11, 0x05, 0xbb, 0x43, 0x5f, 0x8f,
+  0xa2, 0x73, 0xd0, 0x4e, 0xb4, 0xb5, 0x3f, 0x07, 0xf7, 0x43, 0xbe, 0x2e,
+  0x24, 0xfa, 0xe6, 0xa5, 0x74, 0x87, 0xb6, 0xd3, 0xb9, 0x67, 0x0e, 0x7c,
+  0x05, 0xee, 0x9f, 0x05, 0x6e, 0xd1, 0xc7, 0xba, 0x5e, 0x10, 0xa9, 0xe7,
+  0xf3, 0x3b, 0x33, 0xa5, 0xba, 0x17, 0x3c, 0xc6, 0x17, 0xa0, 0xfc, 0x9c,
+  0x1e, 0x96, 0x67, 0x30, 0x6f, 0xd7, 0xf0, 0x69, 0xae, 0x32, 0x4a, 0xbe,
+  0x61, 0x70, 0xf0, 0xfb, 0x88, 0x91, 0xc4, 0x30, 0x3e, 0xef, 0xe2, 0x7c,
+  0xc2, 0x27, 0xac, 0xba, 0x30, 0xa2, 0xde, 0xec, 0xb0, 0x05, 0xef, 0x65,
+  0xa1, 0xad, 0x91, 0x68, 0x10, 0x17, 0xda, 0x6e, 0x6f, 0x08, 0x15, 0x22,
+  0x06, 0x1b, 0xa2, 0xbb, 0xff, 0x11, 0x16, 0x25, 0xc7, 0xa3, 0xb5, 0xff,
+  0xba, 0xe2, 0x24, 0xd1, 0xa0, 0x20, 0x0e, 0x8d, 0x28, 0x0f, 0x4f, 0x48,
+  0x16, 0x2e, 0x22, 0xe0, 0xe7, 0x49, 0x0c, 0xcc, 0x02, 0xdd, 0xae, 0x24,
+  0x0d, 0x5b, 0xcf, 0x7a, 0xa7, 0x94, 0x9a, 0xd2, 0x21, 0x5a, 0x85, 0xe3,
+  0x17, 0xbd, 0x2e, 0x56, 0x97, 0xee, 0xd1, 0xec, 0x4a, 0xf2, 0x99, 0x2a,
+  0x6a, 0x92, 0x53, 0x41, 0xd0, 0x95, 0x50, 0x1b, 0xd2, 0x29, 0x75, 0x85,
+  0x91, 0x3c, 0xcf, 0x74, 0xf3, 0x70, 0x3a, 0x1b, 0x69, 0x97, 0x06, 0x53,
+  0xeb, 0x12, 0xc0, 0x5e, 0x65, 0x87, 0x94, 0x8c, 0x50, 0x89, 0xec, 0x1c,
+  0x09, 0x53, 0xcb, 0xb2, 0x2e, 0xfc, 0x92, 0x0b, 0xc3, 0xb9, 0x3a, 0x8c,
+  0xeb, 0x5f, 0xb8, 0xde, 0x96, 0x4b, 0x09, 0x93, 0x02, 0x8f, 0x2a, 0xab,
+  0x0e, 0x17, 0xba, 0x4f, 0x30, 0x46, 0x19, 0x83, 0xac, 0x41, 0x79, 0x94,
+  0xbf, 0x86, 0xdf, 0x98, 0x45, 0x49, 0xfa, 0xab, 0x7f, 0xe5, 0xe8, 0x08,
+  0xe5, 0xc7, 0x3b, 0xb5, 0xc3, 0x51, 0xa6, 0x5a, 0xb9, 0x59, 0x62, 0xe3,
+  0x05, 0xbb, 0x49, 0x0c, 0x69, 0xad, 0xab, 0xc6, 0x19, 0x0a, 0xf6, 0x45,
+  0x16, 0xc2, 0xd1, 0xf7, 0xde, 0x0d, 0x82, 0xaa, 0xfb, 0x68, 0xbb, 0x79,
+  0x70, 0xe0, 0x06, 0x0d, 0xec, 0xd3, 0xa5, 0x91, 0xe7, 0x60, 0x06, 0x0c,
+  0x3a, 0xe8, 0x18, 0x97, 0x3e, 0x1d, 0xf1, 0xd1, 0x61, 0x34, 0x8d, 0x01,
+  0x6f, 0x1a, 0x4d, 0xab, 0x04, 0xed, 0x50, 0x08, 0xa5, 0xde, 0x73, 0xd3,
+  0x08, 0x0d, 0x28, 0xfa, 0x45, 0x8b, 0x50, 0xfb, 0xa0, 0xf9, 0xc3, 0x70,
+  0x87, 0x8a, 0x7c, 0x2f, 0xdf, 0xf1, 0x59, 0x44, 0xfc, 0xd3, 0x9a, 0xff,
+  0xff, 0xb0, 0x4f, 0x6b, 0x0e, 0x7b, 0x38, 0x16, 0x35, 0x32, 0x71, 0xe7,
+  0x40, 0x63, 0xa5, 0x94, 0x48, 0x70, 0xe9, 0xb5, 0x5a, 0xe1, 0xf6, 0x37,
+  0xce, 0xa0, 0x31, 0xbc, 0xb3, 0x5e, 0x13, 0x46, 0xf6, 0xfc, 0x3e, 0x59,
+  0x2e, 0x95, 0x18, 0xf0, 0x20, 0xd9, 0xf1, 0x08, 0x5c, 0xb2, 0xdd, 0x03,
+  0xa6, 0x67, 0x56, 0x76, 0x89, 0xfe, 0xac, 0xe4, 0x87, 0xdd, 0x39, 0xb9,
+  0x49, 0xfd, 0xc4, 0x59, 0xf1, 0x78, 0x0f, 0x99, 0xd3, 0x4f, 0x97, 0x6b,
+  0x1d, 0xc1, 0xd6, 0x15, 0x65, 0x2d, 0x59, 0xf5, 0x10, 0x66, 0x7f, 0x8f,
+  0x28, 0x6b, 0x49, 0xab, 0xfb, 0xef, 0x6c, 0x9f, 0x28, 0x3b, 0x88, 0xb2,
+  0x10, 0x86, 0xf4, 0xd6, 0xff, 0xbd, 0x45, 0xca, 0x0b, 0x84, 0x85, 0x61,
+  0x66, 0x39, 0xd1, 0x35, 0x0a, 0x2b, 0xc9, 0x96, 0xeb, 0x38, 0x22, 0xa3,
+  0x75, 0xb7, 0x49, 0x3c, 0x03, 0x5d, 0x1d, 0x2a, 0x9c, 0x45, 0xa6, 0x7e,
+  0x11, 0x76, 0x8c, 0x8c, 0xac, 0xa2, 0xfb, 0x00, 0x86, 0xfc, 0xf4, 0x51,
+  0x7c, 0x0d, 0x40, 0x85, 0xff, 0x6d, 0xd6, 0x10, 0x3a, 0x85, 0x46, 0xce,
+  0xbe, 0xbf, 0x9f, 0x03, 0x48, 0x9e, 0xfc, 0x80, 0xfb, 0xd6, 0x72, 0xcd,
+  0xcf, 0x44, 0x11, 0xa5, 0x1d, 0x76, 0x37, 0x39, 0x82, 0xd9, 0x59, 0x7b,
+  0x8f, 0xc5, 0x83, 0xc7, 0x35, 0xb1, 0x9a, 0x0b, 0x4c, 0xdb, 0x96, 0x43,
+  0x74, 0xcb, 0x48, 0x2c, 0x7c, 0x4c, 0x57, 0x2b, 0x91, 0x36, 0xf7, 0x93,
+  0x3c, 0xc3, 0x36, 0x72, 0x8f, 0x5e, 0xea, 0x13, 0x05, 0x84, 0xcc, 0xa6,
+  0x2c, 0x3f, 0xb1, 0x4b, 0x95, 0x53, 0xb0, 0xa9, 0x16, 0x32, 0x09, 0x91,
+  0xa2, 0x03, 0x92, 0x5f, 0x24, 0x7a, 0x6f, 0xf6, 0xc6, 0xe3, 0xaf, 0xf7,
+  0xb2, 0x66, 0xaa, 0x62, 0x6f, 0xcf, 0xa5, 0xff, 0x59, 0xf3, 0xfb, 0x9e,
+  0xe1, 0x20, 0x78, 0xd1, 0xaf, 0x8f, 0x88, 0xdf, 0xfa, 0xb5, 0x1f, 0x40,
+  0xfb, 0xd8, 0x84, 0xb6, 0x2d, 0xfa, 0x0b, 0x2f, 0x53, 0x60, 0xa8, 0x75,
+  0x75, 0x1d, 0x97, 0x02, 0x26, 0x4d, 0x3a, 0x1d, 0x9b, 0xa9, 0xf7, 0xdf,
+  0x6c, 0xb7, 0xb8, 0xe8, 0x52, 0xc8, 0xb3, 0x42, 0x29, 0x3f, 0xeb, 0xd5,
+  0x6f, 0x7e, 0x9e, 0x28, 0x7b, 0x72, 0xe1, 0x64, 0x24, 0x48, 0xdd, 0x3f,
+  0xe1, 0x15, 0x39, 0x31, 0xd8, 0x4f, 0xf1, 0x00, 0xa6, 0xfb, 0xe0, 0x29,
+  0x3f, 0x78, 0xc6, 0x5c, 0xf9, 0x2b, 0x33, 0xc0, 0x84, 0xe1, 0x9c, 0x96,
+  0x10, 0x10, 0x98, 0xd5, 0x24, 0xbb, 0xcc, 0x8b, 0x07, 0x39, 0xf7, 0x34,
+  0x4b, 0x87, 0xd3, 0x5e, 0xb2, 0xa1, 0x1d, 0x57, 0x12, 0x80, 0x6b, 0xc9,
+  0x15, 0xbe, 0x2c, 0xef, 0x9d, 0x5d, 0x2a, 0x40, 0xdb, 0x24, 0x16, 0x3c,
+  0xdf, 0xfb, 0x54, 0xe9, 0x87, 0xf2, 0x78, 0xf2, 0xe9, 0x9a, 0xf2, 0x8f,
+  0x23, 0x1d, 0xa7, 0x03, 0x37, 0x96, 0x51, 0xf8, 0xb8, 0xd6, 0xea, 0x9a,
+  0xc2, 0xf2, 0x3d, 0x67, 0x61, 0xf5, 0xfa, 0xfb, 0xc8, 0x83, 0x12, 0xaf,
+  0x17, 0x0b, 0x6b, 0x07, 0xdc, 0x2b, 0x92, 0x8c, 0x38, 0x5b, 0xe9, 0xf6,
+  0x10, 0x5d, 0x48, 0x57, 0x4d, 0x22, 0xd3, 0x81, 0x5e, 0x8c, 0x41, 0xf2,
+  0x60, 0x52, 0xe0, 0xb2, 0x4c, 0xdd, 0x5b, 0xc5, 0x0d, 0xd6, 0x44, 0x7e,
+  0x40, 0x88, 0xd3, 0x2f, 0xd3, 0xa9, 0x9a, 0x76, 0xf7, 0xcd, 0x2e, 0xe5,
+  0x4e, 0x73, 0xed, 0x4d, 0x70, 0x48, 0x14, 0x56, 0xa1, 0xe0, 0xec, 0xa8,
+  0x87, 0xd9, 0x6e, 0xb9, 0xb6, 0x8c, 0x76, 0xd1, 0x3d, 0x6f, 0xbf, 0xea,
+  0xd1, 0xc3, 0x2d, 0x90, 0xa8, 0x41, 0x8e, 0xb9, 0x62, 0xe6, 0x0f, 0xbf,
+  0x3e, 0xbf, 0x06, 0x03, 0xd7, 0xca, 0x09, 0xd2, 0x4a, 0xdd, 0xf5, 0x11,
+  0x8c, 0x7c, 0x54, 0xd3, 0x3c, 0xd0, 0x15, 0x82, 0x0c, 0xfd, 0xf6, 0x35,
+  0xea, 0x32, 0x08, 0x4d, 0xca, 0x5c, 0xd4, 0xe5, 0xfd, 0x5a, 0xa0, 0x9c,
+  0x80, 0xd7, 0x28, 0x8a, 0xd0, 0xf5, 0x59, 0xc0, 0x1a, 0x5b, 0x88, 0xae,
+  0x0e, 0x87, 0x9f, 0x1e, 0xe0, 0x52, 0x34, 0x07, 0x18, 0xbf, 0x31, 0xac,
+  0x9b, 0xb7, 0x35, 0xf5, 0x70, 0x97, 0x2d, 0x50, 0x2c, 0x32, 0xf7, 0x38,
+  0xbf, 0xf6, 0x21, 0x44, 0x44, 0x0e, 0xcf, 0xc8, 0x5d, 0x45, 0xdf, 0x02,
+  0x35, 0xca, 0x9c, 0xc9, 0xe7, 0x9c, 0xa6, 0x19, 0xc7, 0x9f, 0xe8, 0x75,
+  0x57, 0xcc, 0x01, 0x23, 0x94, 0xf4, 0xc9, 0xe1, 0x7d, 0xae, 0x76, 0x8d,
+  0x4a, 0x50, 0x06, 0x29, 0x60, 0x03, 0x16, 0x33, 0x05, 0x05, 0xa3, 0xfa,
+  0x4f, 0xf6, 0x48, 0x58, 0xa0, 0xfd, 0x17, 0x9b, 0x87, 0xd3, 0xfe, 0x1c,
+  0xbf, 0x22, 0xd2, 0xe8, 0x6d, 0x6a, 0xee, 0x40, 0xb4, 0xaa, 0xa2, 0x4e,
+  0xaf, 0x19, 0x61, 0x4c, 0x82, 0x7b, 0x70, 0x02, 0x13, 0xc7, 0x6f, 0x37,
+  0xb5, 0x6d, 0x77, 0xac, 0xab, 0x9b, 0x48, 0x09, 0x89, 0xd1, 0xea, 0x29,
+  0xba, 0x0d, 0x69, 0x61, 0x2c, 0xea, 0x14, 0xb5, 0x23, 0xe6, 0x07, 0xd9,
+  0x6d, 0xc3, 0xc1, 0x05, 0x09, 0xc4, 0xd0, 0x54, 0x72, 0xa3, 0xd5, 0x21,
+  0xcf, 0xc2, 0x81, 0x98, 0x46, 0xaa, 0x2a, 0xa4, 0x68, 0x11, 0x5f, 0xb3,
+  0xfe, 0xba, 0xdb, 0xd9, 0xe5, 0xa8, 0xac, 0x72, 0x92, 0x37, 0x48, 0x1a,
+  0xd5, 0xd1, 0x88, 0xf0, 0x07, 0xe0, 0x26, 0x64, 0x3d, 0xc6, 0x86, 0x93,
+  0xc0, 0x5a, 0xa2, 0x70, 0xa4, 0xed, 0x71, 0x97, 0x20, 0x56, 0xc4, 0xdc,
+  0xec, 0x98, 0x82, 0x82, 0x1a, 0x6a, 0xab, 0xbc, 0x12, 0x2d, 0xc2, 0xb1,
+  0xed, 0x5c, 0x35, 0xe9, 0xc5, 0x2e, 0xd9, 0xad, 0x95, 0xa2, 0xb0, 0x37,
+  0x69, 0x85, 0x62, 0xf6, 0xc0, 0x17, 0x95, 0xd7, 0xf5, 0x1a, 0x07, 0xf6,
+  0xf6, 0xf8, 0xe4, 0xc8, 0x66, 0xb5, 0xfd, 0xbf, 0x7b, 0x23, 0xda, 0xf0,
+  0x6a, 0x1a, 0xe4, 0xf0, 0x71, 0x0d, 0xa9, 0x57, 0x10, 0x2c, 0x45, 0xa6,
+  0xdf, 0x0c, 0xb8, 0xf3, 0x25, 0x7e, 0xdc, 0xaa, 0x30, 0x3d, 0x7a, 0xff,
+  0xed, 0xf1, 0xf9, 0xe9, 0xfb, 0x77, 0x47, 0xef, 0x2f, 0x3e, 0xf3, 0xd8,
+  0x5d, 0xac, 0xaf, 0x43, 0x1d, 0xa6, 0x17, 0xe4, 0x14, 0x0e, 0xba, 0x41,
+  0x09, 0x20, 0xf7, 0x57, 0x31, 0xeb, 0x94, 0x7f, 0x8d, 0xfc, 0xe1, 0xbc,
+  0x87, 0xd4, 0xb3, 0x4f, 0x89, 0x24, 0x2b, 0x72, 0xec, 0xcc, 0x28, 0xaa,
+  0x3a, 0xe2, 0x58, 0x80, 0xed, 0x1d, 0x4c, 0xad, 0x25, 0x6e, 0x09, 0xca,
+  0x1b, 0xa9, 0xc0, 0xd4, 0x27, 0xf6, 0x33, 0xbb, 0x25, 0x1c, 0x05, 0x74,
+  0xb1, 0xd2, 0xd6, 0x24, 0x1c, 0x71, 0x7f, 0xe0, 0x12, 0xd0, 0x78, 0x8f,
+  0x0a, 0xc5, 0xbe, 0x73, 0x6d, 0xe5, 0xaf, 0xd2, 0xda, 0xc5, 0x5e, 0xc4,
+  0x71, 0xe3, 0x03, 0xd5, 0x78, 0xb8, 0xc0, 0x5e, 0x9b, 0xe3, 0x2e, 0x16,
+  0xb0, 0xb7, 0x8a, 0xbf, 0xaa, 0xb7, 0xe8, 0xc5, 0xde, 0xde, 0x8f, 0xe8,
+  0xaf, 0xfd, 0x27, 0x69, 0xb0, 0x1d, 0x42, 0xa0, 0xd6, 0xde, 0x44, 0x84,
+  0xe3, 0x7a, 0xd5, 0x85, 0x44, 0xb7, 0x76, 0x3b, 0xe1, 0x06, 0xfe, 0x78,
+  0x76, 0x7e, 0xfa, 0xfd, 0x5f, 0x7e, 0xe1, 0x4f, 0x78, 0xc9, 0x66, 0x7f,
+  0xa5, 0x1c, 0x4c, 0x1d, 0xfc, 0xc7, 0x9f, 0xf5, 0xb5, 0x8d, 0x9f, 0x6b,
+  0x8f, 0x3f, 0x90, 0x50, 0xbb, 0xbc, 0x11, 0x04, 0xce, 0x51, 0xb8, 0xcd,
+  0x7d, 0xaf, 0xb4, 0x8c, 0xdb, 0x79, 0x38, 0x6c, 0x22, 0x10, 0xcb, 0xb7,
+  0xba, 0x83, 0xe5, 0x11, 0x3a, 0x64, 0x01, 0x4d, 0x83, 0x8a, 0x62, 0x97,
+  0xc1, 0x3b, 0x90, 0xb2, 0x72, 0xaa, 0x1b, 0x1f, 0xa0, 0x1e, 0x19, 0x19,
+  0xa9, 0x76, 0x3f, 0x5e, 0x9d, 0x9c, 0xfc, 0xfc, 0x4d, 0xd0, 0x0e, 0x4c,
+  0xed, 0x6d, 0x40, 0x9b, 0x62, 0xbb, 0xa0, 0xa1, 0xd5, 0x51, 0xf5, 0x0a,
+  0x6c, 0x42, 0xa2, 0x7d, 0x7f, 0x2a, 0xb3, 0x79, 0x09, 0xe5, 0x78, 0x58,
+  0x67, 0x46, 0xa5, 0x4d, 0x29, 0xe2, 0xaf, 0xc0, 0xe2, 0x34, 0xb1, 0x7a,
+  0x8f, 0x13, 0x27, 0x03, 0xa4, 0x73, 0xff, 0x21, 0xce, 0xaa, 0xe4, 0xfd,
+  0xe4, 0xa2, 0x38, 0x94, 0x2d, 0x94, 0x16, 0x95, 0x88, 0xbb, 0xa5, 0x4b,
+  0xc3, 0xee, 0x79, 0xac, 0x21, 0x33, 0xe3, 0x43, 0x90, 0xbc, 0xad, 0xf2,
+  0xfa, 0x13, 0x8a, 0x3a, 0xe8, 0x86, 0x42, 0x43, 0xd2, 0x1a, 0x7e, 0x52,
+  0x79, 0x31, 0x27, 0x01, 0x19, 0x71, 0xf5, 0x74, 0x79, 0x1d, 0x9b, 0x1d,
+  0x09, 0xdd, 0x94, 0x45, 0x31, 0xb9, 0x51, 0xd9, 0x09, 0x9d, 0xb6, 0x8a,
+  0xbb, 0x04, 0x9f, 0x9d, 0x33, 0xa8, 0x6a, 0x0b, 0x33, 0x10, 0x2b, 0x4b,
+  0x1f, 0x68, 0xb9, 0x31, 0x3d, 0xc0, 0x9f, 0x6e, 0xea, 0x6c, 0x31, 0xef,
+  0xa9, 0xb0, 0xf7, 0x19, 0x86, 0xe3, 0x18, 0x5a, 0xe4, 0x6f, 0x7b, 0xc6,
+  0x3b, 0x02, 0x27, 0x30, 0x0e, 0x44, 0x16, 0x42, 0x7f, 0x9d, 0x50, 0xa2,
+  0x2b, 0x89, 0xbe, 0x45, 0x8a, 0x81, 0x90, 0x84, 0xc6, 0xf1, 0x05, 0x1b,
+  0x91, 0x3e, 0xae, 0x67, 0xfb, 0xc5, 0x2c, 0x2c, 0x98, 0x32, 0x2c, 0xc9,
+  0xc7, 0xef, 0xd0, 0x9c, 0xbc, 0xe1, 0x6d, 0xa2, 0xc0, 0x21, 0x7c, 0x52,
+  0xad, 0x67, 0xe4, 0x37, 0x0f, 0x19, 0x2e, 0x85, 0xe7, 0x2b, 0x53, 0xba,
+  0x4d, 0x1a, 0xca, 0xed, 0x6d, 0x12, 0x89, 0x6c, 0x08, 0x62, 0x11, 0x9d,
+  0x6c, 0xac, 0x4e, 0xc2, 0x9b, 0x78, 0x38, 0xf2, 0x03, 0x66, 0x1a, 0x89,
+  0x0d, 0x9b, 0xc7, 0xc8, 0x09, 0xcf, 0x08, 0x32, 0xfe, 0x78, 0x76, 0xa2,
+  0x00, 0xe2, 0xe4, 0x59, 0xb2, 0x1e, 0xa7, 0x50, 0x5a, 0x59, 0x2c, 0x08,
+  0x17, 0x4f, 0x5f, 0x02, 0xc1, 0xa1, 0x18, 0x04, 0x17, 0x42, 0x6e, 0x44,
+  0xab, 0xaa, 0x5d, 0x4b, 0x87, 0x5c, 0xac, 0x1d, 0xd1, 0x96, 0xa0, 0x96,
+  0x17, 0x79, 0xfc, 0x02, 0xa2, 0x88, 0x50, 0x89, 0xad, 0x3a, 0x90, 0x5a,
+  0x59, 0x54, 0xd7, 0x4d, 0xb4, 0xca, 0xd8, 0x36, 0x64, 0x34, 0x22, 0x70,
+  0x51, 0xd6, 0x31, 0x38, 0xcd, 0x09, 0xa5, 0xcd, 0x67, 0x68, 0xc5, 0xc3,
+  0x57, 0xde, 0xfc, 0xf7, 0xe2, 0xf4, 0xf5, 0xe9, 0x89, 0xf9, 0xcb, 0xd1,
+  0xdb, 0xe3, 0xef, 0x9d, 0x56, 0x20, 0x9d, 0xb3, 0x6c, 0x6d, 0x1a, 0xc7,
+  0xcf, 0x01, 0xbd, 0xf8, 0x6c, 0xd0, 0x62, 0xc7, 0x9c, 0x84, 0x48, 0xf9,
+  0x87, 0x2d, 0x61, 0xde, 0xee, 0x2f, 0xe9, 0xf1, 0x39, 0x92, 0xd3, 0x94,
+  0x31, 0xea, 0xe1, 0x8f, 0xa4, 0x02, 0xbd, 0x44, 0x5a, 0x34, 0x8f, 0x6a,
+  0x6b, 0x29, 0xdc, 0x26, 0x1f, 0xb7, 0x58, 0x1c, 0x34, 0x2b, 0x5f, 0x73,
+  0x68, 0x33, 0x47, 0x9e, 0x14, 0x92, 0x30, 0xf2, 0xb9, 0x16, 0xcf, 0x36,
+  0x7e, 0x0f, 0x74, 0xad, 0xa9, 0x92, 0xae, 0x33, 0x94, 0xc1, 0xe3, 0xa3,
+  0xda, 0x17, 0xd9, 0xc0, 0x5b, 0xa4, 0x2a, 0xbc, 0x4d, 0x95, 0x81, 0x31,
+  0x22, 0xaf, 0xa9, 0x85, 0xf2, 0xd1, 0xa1, 0x08, 0x22, 0x05, 0x37, 0x5c,
+  0x7b, 0x4d, 0xb2, 0x01, 0x92, 0xca, 0x87, 0xdc, 0x0a, 0x52, 0xe4, 0x3d,
+  0x88, 0x1f, 0xa1, 0xd6, 0x68, 0xb9, 0x20, 0x97, 0x29, 0xd1, 0x1f, 0x6e,
+  0x12, 0xca, 0x52, 0xe9, 0xab, 0xb6, 0x99, 0x0b, 0xb6, 0x4b, 0x83, 0x52,
+  0xab, 0xd0, 0xb4, 0xa2, 0x33, 0x10, 0x65, 0xbf, 0xad, 0x71, 0xd4, 0x1b,
+  0x3e, 0x1d, 0x6e, 0x40, 0x90, 0x75, 0x4d, 0x59, 0xdf, 0xf5, 0xe3, 0x4d,
+  0x63, 0x90, 0x46, 0xf8, 0xf7, 0x75, 0x7e, 0x9d, 0xa2, 0xb6, 0xcc, 0x5c,
+  0x95, 0xe1, 0x90, 0x5f, 0xea, 0x8c, 0x91, 0xfe, 0xac, 0x41, 0xd2, 0xf6,
+  0x28, 0x4f, 0x7e, 0xce, 0x20, 0x4f, 0x3a, 0x63, 0x5c, 0xfd, 0xac, 0x41,
+  0x86, 0x2a, 0x20, 0x8c, 0x62, 0xfc, 0xfd, 0xf1, 0x45, 0xf2, 0xfa, 0xf4,
+  0x8d, 0xbb, 0x60, 0x17, 0x92, 0x0f, 0x48, 0x24, 0x90, 0x4c, 0xd6, 0x85,
+  0xa1, 0x41, 0xea, 0x97, 0x64, 0x1b, 0x50, 0x70, 0x9e, 0x22, 0x25, 0xe1,
+  0x68, 0x37, 0xfb, 0x2c, 0xaf, 0x18, 0x8e, 0x88, 0x12, 0x6b, 0xe0, 0xbd,
+  0xf1, 0x6a, 0x74, 0xe9, 0xe1, 0x25, 0x01, 0x1d, 0x5d, 0xaa, 0xfc, 0xa5,
+  0x1b, 0x49, 0x58, 0x77, 0x69, 0xa5, 0x25, 0xa5, 0x93, 0x94, 0xf0, 0x8c,
+  0x0a, 0xae, 0x8d, 0xa4, 0xa2, 0x94, 0x10, 0x7a, 0x58, 0x87, 0xf3, 0x11,
+  0x88, 0x8d, 0xee, 0x9c, 0x37, 0x3a, 0x13, 0x3f, 0x93, 0xf0, 0x40, 0x73,
+  0xfd, 0x5b, 0x94, 0x2e, 0x0d, 0xe8, 0x20, 0xfc, 0x28, 0xa9, 0x1b, 0x89,
+  0x2e, 0xe0, 0x23, 0xd2, 0x76, 0x51, 0xcd, 0x17, 0x6e, 0x43, 0x1d, 0x48,
+  0x6c, 0x3b, 0x84, 0xfd, 0xce, 0xa1, 0x84, 0x12, 0x8c, 0x8a, 0xce, 0x5e,
+  0x03, 0xc9, 0x2b, 0xcb, 0xff, 0xe1, 0x29, 0xe8, 0x8f, 0xac, 0x3e, 0x66,
+  0x56, 0xbe, 0x40, 0x67, 0xe7, 0x19, 0xdf, 0x88, 0xfa, 0xce, 0x08, 0xf5,
+  0x5b, 0x18, 0xe4, 0x64, 0x3d, 0x09, 0xa2, 0x93, 0x7b, 0xf3, 0xb1, 0x68,
+  0x65, 0x16, 0x36, 0xaa, 0xac, 0xac, 0x3d, 0xaa, 0x96, 0xbc, 0xf3, 0x58,
+  0x68, 0x85, 0x34, 0x43, 0xd9, 0x66, 0x75, 0x8e, 0x70, 0x58, 0x78, 0xbd,
+  0x24, 0x66, 0xa9, 0x5f, 0xd5, 0x8a, 0x6b, 0x41, 0xe0, 0xf6, 0x3a, 0x09,
+  0x5a, 0xb4, 0x1f, 0xf3, 0x29, 0xec, 0xd7, 0x90, 0xbb, 0x28, 0x05, 0x75,
+  0xe9, 0xae, 0x02, 0x53, 0x6d, 0x8e, 0x59, 0x89, 0x0d, 0x1c, 0x20, 0x95,
+  0x97, 0x9a, 0xde, 0xa7, 0x04, 0xf6, 0x80, 0xde, 0x85, 0x69, 0xc1, 0x95,
+  0x86, 0x7a, 0x02, 0xf1, 0x9a, 0x3b, 0x57, 0xf3, 0xf4, 0x84, 0xff, 0x78,
+  0xad, 0x3a, 0x9b, 0xd6, 0x0d, 0x25, 0x56, 0x5d, 0xbb, 0xb0, 0x70, 0x16,
+  0x62, 0xe2, 0x90, 0x78, 0x9b, 0x42, 0x0e, 0x71, 0x1d, 0x41, 0x64, 0x13,
+  0xea, 0x8e, 0x8f, 0xf3, 0x69, 0xe7, 0x2b, 0xfa, 0x11, 0x46, 0x74, 0x72,
+  0x5f, 0xf0, 0x7d, 0xf2, 0xba, 0x83, 0xf2, 0xac, 0x37, 0xda, 0xb3, 0x2e,
+  0x5d, 0x78, 0x9e, 0x7d, 0x8c, 0x68, 0x9f, 0xfc, 0x5c, 0x7c, 0x11, 0x19,
+  0x15, 0x2d, 0x8a, 0xe6, 0x5c, 0x65, 0xab, 0x85, 0xf0, 0x4c, 0xf9, 0x09,
+  0x42, 0xc7, 0xf0, 0x27, 0x60, 0x97, 0xa7, 0x3a, 0x4b, 0xa3, 0x0e, 0xfb,
+  0xa6, 0xe0, 0x73, 0xf9, 0xac, 0xe1, 0xbb, 0xac, 0x39, 0x10, 0xea, 0x46,
+  0x6e, 0xa9, 0x4d, 0x7a, 0xa1, 0xe3, 0x47, 0x94, 0xde, 0x68, 0x64, 0x53,
+  0x69, 0xff, 0xad, 0x6f, 0x84, 0x48, 0x77, 0x2c, 0xbe, 0x9c, 0x2f, 0x19,
+  0xeb, 0x5d, 0x57, 0x5c, 0xb6, 0xeb, 0xd0, 0x1d, 0x15, 0x6e, 0x9d, 0x17,
+  0x5c, 0x11, 0x22, 0xdf, 0x28, 0x79, 0x57, 0x06, 0xe8, 0x93, 0xe5, 0xbc,
+  0x91, 0xca, 0x7b, 0xca, 0x4c, 0xe4, 0xdd, 0xb9, 0x4a, 0x8b, 0x4b, 0x46,
+  0x14, 0xf4, 0x06, 0x04, 0x89, 0x5b, 0x61, 0x68, 0xae, 0x3a, 0xd4, 0x97,
+  0x22, 0x32, 0xbb, 0x2e, 0x1e, 0xfa, 0xc1, 0xbe, 0xdd, 0x07, 0xe9, 0x94,
+  0x85, 0xf2, 0x14, 0xda, 0x88, 0xef, 0x00, 0x4b, 0x78, 0x93, 0x72, 0x2b,
+  0x5d, 0xed, 0x37, 0xef, 0x4c, 0x16, 0x3d, 0x28, 0x0a, 0xac, 0x85, 0x79,
+  0xd2, 0xc8, 0xdf, 0x49, 0xd9, 0xa9, 0xc6, 0x99, 0x9e, 0x5c, 0xde, 0x28,
+  0xd2, 0x6a, 0x00, 0x33, 0xdc, 0xb2, 0x47, 0x0e, 0xb3, 0x42, 0xbb, 0xa6,
+  0xca, 0x98, 0x1e, 0x8f, 0x0c, 0xc1, 0x56, 0x79, 0xd9, 0x1c, 0x0e, 0x34,
+  0xc4, 0x5b, 0xcf, 0x81, 0x5b, 0xcf, 0x0d, 0x28, 0xe5, 0xec, 0xd5, 0x78,
+  0xac, 0x74, 0xf2, 0x3a, 0x24, 0x09, 0xf1, 0x59, 0x12, 0x9a, 0x85, 0x02,
+  0x3a, 0x85, 0xaa, 0xa2, 0x8c, 0xd1, 0x49, 0x32, 0x38, 0x60, 0x9e, 0xf6,
+  0x86, 0x19, 0x73, 0x7c, 0xb9, 0x37, 0xad, 0x4d, 0x64, 0x0f, 0x76, 0x07,
+  0x05, 0xe4, 0xb3, 0x68, 0xba, 0x0a, 0xc7, 0x2b, 0x69, 0x9b, 0x51, 0x8e,
+  0xac, 0x3c, 0x9e, 0x74, 0x43, 0xc3, 0x77, 0xf2, 0x56, 0xcf, 0xc2, 0x83,
+  0x47, 0x91, 0x45, 0x7f, 0xcb, 0xab, 0x1a, 0xfc, 0x2b, 0x8b, 0xfe, 0x36,
+  0xb2, 0xe8, 0xc7, 0xf6, 0x5b, 0xfc, 0xa9, 0xc3, 0xc3, 0x67, 0x52, 0x55,
+  0xc1, 0x3e, 0x3a, 0x2a, 0xfa, 0xb7, 0x0c, 0x88, 0xbf, 0xc6, 0x2b, 0x36,
+  0x0f, 0x0e, 0xb9, 0xfe, 0x20, 0xfc, 0x96, 0x77, 0x79, 0xbd, 0x4f, 0x3d,
+  0x71, 0xcb, 0x32, 0xaa, 0x37, 0x8d, 0x47, 0x5a, 0x3d, 0xf3, 0x99, 0x80,
+  0xfd, 0xa8, 0x31, 0x47, 0x7a, 0xf8, 0x0d, 0x65, 0x50, 0x35, 0xf1, 0xd4,
+  0x5f, 0x9d, 0x86, 0xf7, 0x9d, 0xa7, 0xd6, 0x8d, 0xb2, 0x77, 0xa8, 0x21,
+  0xf4, 0x57, 0xe0, 0xc5, 0x8b, 0x6c, 0xc9, 0xfd, 0x1a, 0x32, 0x02, 0xeb,
+  0x71, 0x1e, 0x40, 0xae, 0xb9, 0x9b, 0x57, 0x29, 0xd0, 0x96, 0x17, 0xe9,
+  0x5d, 0x04, 0x6c, 0x4b, 0x3c, 0xc5, 0x6c, 0xae, 0x98, 0xfb, 0x79, 0x99,
+  0x15, 0x64, 0x29, 0x40, 0x11, 0x10, 0xb7, 0x19, 0xf9, 0x61, 0x11, 0x35,
+  0x9f, 0x5b, 0x57, 0xad, 0x7c, 0x35, 0x80, 0x03, 0xa8, 0xa5, 0x81, 0x21,
+  0xdf, 0x19, 0xd1, 0x12, 0xe2, 0xd8, 0x70, 0x07, 0xcf, 0xec, 0xbe, 0xd9,
+  0x93, 0x20, 0xcf, 0x16, 0x63, 0x84, 0x78, 0x5b, 0xa7, 0xcc, 0x44, 0x03,
+  0x02, 0xd2, 0x47, 0x07, 0x51, 0xba, 0x3c, 0xb4, 0x9a, 0x2b, 0x4f, 0x41,
+  0x3c, 0x60, 0x6e, 0x7c, 0x46, 0xbc, 0x4e, 0x00, 0x77, 0x47, 0xc9, 0x29,
+  0xbc, 0x70, 0x2d, 0x90, 0x71, 0xae, 0x04, 0x4a, 0x5d, 0xd1, 0x68, 0x9b,
+  0x70, 0x9f, 0x7b, 0x27, 0xac, 0xb3, 0xd2, 0xec, 0x97, 0x3d, 0x61, 0xb3,
+  0x0e, 0x82, 0x49, 0x7d, 0xcd, 0x59, 0x72, 0x7e, 0x74, 0x71, 0x8e, 0x40,
+  0x2f, 0x31, 0x80, 0x00, 0x24, 0x35, 0xad, 0x76, 0x2d, 0x48, 0x90, 0x70,
+  0x33, 0xa7, 0x87, 0x38, 0x06, 0xc1, 0xf8, 0x65, 0xf6, 0xbc, 0xf9, 0x9f,
+  0xfa, 0x1e, 0x57, 0xbf, 0x64, 0x5a, 0x6b, 0xe2, 0x42, 0x3a, 0x6d, 0x64,
+  0xb5, 0xc3, 0x43, 0x97, 0x85, 0x84, 0xde, 0xc6, 0x2c, 0xe5, 0x24, 0x93,
+  0x7c, 0x24, 0x49, 0x9b, 0x5a, 0x7d, 0xa1, 0xad, 0x04, 0xe8, 0x21, 0x4e,
+  0xc6, 0x2e, 0xab, 0x98, 0xde, 0x21, 0x9f, 0xb6, 0x0a, 0x80, 0x4c, 0xc2,
+  0x2f, 0x4c, 0xe0, 0x6a, 0x70, 0x8f, 0x83, 0x72, 0x0d, 0xe0, 0xe3, 0xfd,
+  0xfd, 0x30, 0x6f, 0x38, 0x9d, 0x18, 0xa6, 0x2a, 0xda, 0x9c, 0x54, 0xf5,
+  0xe0, 0x15, 0xf6, 0x9a, 0x42, 0xbd, 0xac, 0xc9, 0xd6, 0x18, 0xce, 0xc9,
+  0x8d, 0x49, 0x3b, 0x16, 0x1a, 0x15, 0x87, 0xcc, 0x63, 0xbe, 0x43, 0x99,
+  0x91, 0xec, 0x59, 0x9b, 0xb3, 0x70, 0x05, 0x92, 0xf6, 0xce, 0x4d, 0x35,
+  0xc9, 0x18, 0x35, 0xc1, 0xe2, 0xfd, 0x0e, 0x66, 0x16, 0xf0, 0xef, 0xc3,
+  0x27, 0x11, 0x8a, 0x48, 0xc6, 0x17, 0xa7, 0xe7, 0x8a, 0xbd, 0x1f, 0xca,
+  0x67, 0x64, 0x3e, 0xd0, 0x13, 0x16, 0x6a, 0x65, 0x10, 0x42, 0xee, 0xcc,
+  0x2c, 0x3e, 0x80, 0x85, 0x31, 0xf5, 0xbe, 0xca, 0x1c, 0x00, 0x2d, 0xf4,
+  0x64, 0x6d, 0xdf, 0x0a, 0x20, 0x80, 0x42, 0xf6, 0xea, 0xbd, 0xf4, 0x5e,
+  0xe2, 0x6b, 0x76, 0xca, 0xf7, 0x97, 0xeb, 0xd7, 0x89, 0x8e, 0xa4, 0x92,
+  0x9d, 0x10, 0x7f, 0x25, 0x1d, 0xd6, 0x76, 0xfa, 0xec, 0xd2, 0x22, 0x5f,
+  0xa2, 0x53, 0x07, 0xc9, 0xcc, 0x1c, 0x5e, 0x16, 0x69, 0x2d, 0x63, 0x74,
+  0x9b, 0x25, 0x3e, 0xc1, 0x90, 0xc5, 0x92, 0xd8, 0x94, 0xb2, 0x2f, 0x6c,
+  0x1a, 0xc0, 0xba, 0x97, 0x95, 0x82, 0xb4, 0x8a, 0xe0, 0x54, 0x63, 0xc1,
+  0xe9, 0xd9, 0x9e, 0xd4, 0x3f, 0x3b, 0x3d, 0xbf, 0x48, 0xac, 0xd0, 0xc7,
+  0x97, 0xf1, 0xa3, 0xce, 0x05, 0xa2, 0x96, 0x29, 0xf0, 0xd9, 0xb9, 0xb2,
+  0x8d, 0xc0, 0x21, 0x29, 0x36, 0x41, 0xd3, 0x19, 0x62, 0x80, 0x36, 0x7b,
+  0xb3, 0x92, 0xb1, 0x7c, 0x5c, 0xf8, 0x51, 0x50, 0xba, 0x20, 0x67, 0xfa,
+  0x90, 0xc1, 0x9c, 0x72, 0xfb, 0xe8, 0x20, 0x42, 0x19, 0x64, 0x45, 0x9f,
+  0x1f, 0x8d, 0x2f, 0x78, 0xc7, 0xe8, 0x6f, 0xc1, 0xbc, 0xb9, 0x40, 0x54,
+  0x7e, 0x18, 0x18, 0x2a, 0x96, 0x32, 0x28, 0x01, 0xcd, 0x58, 0x1b, 0x18,
+  0xdf, 0x16, 0xb8, 0x7b, 0x3b, 0xf6, 0xc8, 0xcb, 0x36, 0x04, 0xd7, 0x14,
+  0x3a, 0xc1, 0x05, 0xc7, 0x0f, 0xb6, 0xe4, 0x23, 0x5b, 0x46, 0x31, 0xe3,
+  0x0b, 0xd1, 0x82, 0x5f, 0x7f, 0xf4, 0xd8, 0xe3, 0x14, 0x24, 0xa7, 0x64,
+  0x80, 0x63, 0x6d, 0x93, 0x4b, 0x3f, 0x1c, 0x2a, 0xa9, 0x40, 0x58, 0x30,
+  0x51, 0xf0, 0x73, 0x6e, 0x9c, 0x27, 0x52, 0xa2, 0x7e, 0x62, 0x55, 0x05,
+  0x6f, 0x2a, 0xf4, 0x63, 0xcd, 0xf8, 0x81, 0xda, 0xd6, 0x21, 0xb9, 0x47,
+  0x4c, 0xe9, 0x7f, 0x36, 0x84, 0x6e, 0xb3, 0x16, 0x79, 0xe9, 0xbe, 0x5c,
+  0x30, 0xba, 0x56, 0x5e, 0xac, 0x33, 0xe8, 0x68, 0x69, 0xb5, 0xa0, 0x56,
+  0x0f, 0x86, 0x87, 0x54, 0x52, 0x40, 0x76, 0x53, 0xc4, 0x60, 0xa9, 0xbd,
+  0x6f, 0x88, 0xfc, 0x39, 0x3e, 0x39, 0x72, 0x27, 0xc5, 0x7d, 0x22, 0x70,
+  0x83, 0x9d, 0xae, 0x4f, 0xad, 0xed, 0xad, 0x98, 0x18, 0x25, 0x67, 0xd4,
+  0xb3, 0x1c, 0x7a, 0x53, 0xfd, 0x1f, 0x6e, 0x34, 0xbe, 0x24, 0xf0, 0xc0,
+  0x1b, 0xb1, 0x09, 0x33, 0x25, 0x2f, 0xcc, 0xc1, 0xe2, 0x27, 0xf4, 0x57,
+  0x0f, 0xd3, 0x3c, 0x58, 0xee, 0x73, 0xf7, 0x72, 0x6d, 0x96, 0x62, 0x0c,
+  0xf4, 0xee, 0x23, 0x8f, 0x85, 0xae, 0x8c, 0xf5, 0x8e, 0x21, 0x2c, 0x6f,
+  0xa6, 0xbb, 0x2c, 0xad, 0x62, 0x66, 0x3c, 0xc2, 0x5c, 0x9f, 0x69, 0xf1,
+  0x70, 0x6f, 0x28, 0x16, 0x06, 0xaf, 0x26, 0xb6, 0x81, 0x10, 0xa5, 0x09,
+  0x93, 0x22, 0x67, 0xc6, 0x2a, 0x88, 0xd3, 0x2e, 0x6c, 0xae, 0xbd, 0x0d,
+  0x03, 0x13, 0xaf, 0x9c, 0xe8, 0xb5, 0xa1, 0x95, 0x74, 0x37, 0xb7, 0xd3,
+  0x80, 0xfd, 0x31, 0x53, 0xa2, 0x25, 0x1b, 0x2b, 0xbf, 0x5a, 0xb3, 0x93,
+  0xfc, 0x64, 0x01, 0xbd, 0x23, 0xa7, 0x01, 0xc5, 0x03, 0x8c, 0x80, 0xf7,
+  0x95, 0xff, 0xc7, 0x4f, 0xdc, 0x50, 0x73, 0xaa, 0xe9, 0xb4, 0x63, 0x39,
+  0xde, 0x63, 0xbb, 0x48, 0x30, 0x02, 0x03, 0x1e, 0x13, 0x8b, 0x91, 0x9b,
+  0x75, 0x4f, 0x22, 0xe8, 0x6f, 0xfe, 0x9e, 0x3c, 0x13, 0xd3, 0x97, 0x6c,
+  0xdf, 0xe2, 0xce, 0xe5, 0xde, 0x4b, 0xd3, 0x6e, 0xf6, 0x9b, 0x71, 0xa3,
+  0x1a, 0xf9, 0x8d, 0x80, 0x30, 0x5e, 0x89, 0x5f, 0x86, 0x5a, 0x51, 0x05,
+  0x88, 0x8b, 0xeb, 0xa5, 0xe4, 0xf0, 0x7a, 0x5f, 0xfa, 0x5c, 0x3c, 0x19,
+  0x54, 0x79, 0x6e, 0xf1, 0x1a, 0x3d, 0x2e, 0x5a, 0xaa, 0xc5, 0x6c, 0x61,
+  0x8c, 0x0c, 0xf1, 0x20, 0xb7, 0xd4, 0xd6, 0xba, 0x87, 0x18, 0x7b, 0x84,
+  0x5d, 0x06, 0x51, 0x2c, 0xea, 0xae, 0x3a, 0x15, 0x4a, 0x0f, 0xfa, 0x8a,
+  0x36, 0x5c, 0x9e, 0xe3, 0x5f, 0x29, 0x40, 0x4a, 0xe8, 0x12, 0xaf, 0xb2,
+  0xbf, 0x41, 0x91, 0x74, 0xfd, 0x5a, 0x35, 0xa6, 0x9c, 0x16, 0xeb, 0xd4,
+  0xb3, 0xe5, 0x1f, 0x3f, 0x17, 0x0f, 0x95, 0xb8, 0x41, 0x28, 0xac, 0x5e,
+  0x64, 0x4d, 0x10, 0x5e, 0x7c, 0x72, 0x60, 0x7d, 0x95, 0x94, 0x31, 0x2b,
+  0x75, 0x20, 0x7e, 0xde, 0xac, 0x61, 0x6e, 0xe3, 0xf1, 0xd7, 0xc9, 0xbb,
+  0x37, 0x4f, 0x28, 0x9d, 0xe7, 0x32, 0xab, 0x56, 0x15, 0xa5, 0x70, 0x2a,
+  0x0d, 0x9f, 0x7e, 0xe3, 0x0d, 0x76, 0xe8, 0x1c, 0x9f, 0x22, 0x62, 0x73,
+  0xb9, 0xbd, 0x64, 0x2b, 0x98, 0xf3, 0xa3, 0xba, 0xe7, 0x4b, 0x45, 0x46,
+  0x60, 0xef, 0x17, 0xa0, 0x17, 0x04, 0xac, 0x8a, 0x95, 0x96, 0xcf, 0xba,
+  0x49, 0xe1, 0x2d, 0x06, 0xf6, 0xe4, 0x91, 0x63, 0x60, 0xd5, 0xdd, 0x8a,
+  0x3a, 0xab, 0x14, 0x97, 0x64, 0x17, 0x44, 0x6e, 0xd4, 0x13, 0x66, 0x9a,
+  0xaf, 0xf9, 0xde, 0x93, 0x12, 0x1b, 0xbe, 0x06, 0xf5, 0x1c, 0xfe, 0x52,
+  0xef, 0xbd, 0x27, 0xbe, 0x57, 0xa1, 0x96, 0xde, 0x68, 0xd2, 0x12, 0x03,
+  0x3a, 0x8a, 0xf7, 0xec, 0x53, 0xfb, 0x2c, 0x39, 0x8e, 0xf2, 0xc2, 0x6b,
+  0x61, 0xd4, 0xf3, 0x86, 0x28, 0xbf, 0x6a, 0x20, 0x68, 0x24, 0x87, 0x35,
+  0x1e, 0x6f, 0xef, 0xbd, 0x57, 0x9e, 0xb7, 0x9d, 0x26, 0xe8, 0x1f, 0x60,
+  0x49, 0x13, 0x8b, 0x42, 0x67, 0x59, 0xcf, 0xcd, 0xc2, 0x32, 0xfa, 0x8c,
+  0xd2, 0xa0, 0x5b, 0xe7, 0xa9, 0x4c, 0x30, 0xf3, 0x31, 0x44, 0xf4, 0xae,
+  0x33, 0xed, 0xbf, 0x7e, 0xd5, 0x57, 0x04, 0x04, 0x6a, 0xf7, 0x3e, 0x72,
+  0x20, 0x77, 0x86, 0xfa, 0x52, 0x5f, 0x16, 0xf9, 0x3f, 0x14, 0xbe, 0x80,
+  0x04, 0xb4, 0xb6, 0x9f, 0xf2, 0x1e, 0x3f, 0x14, 0x86, 0xc1, 0xbd, 0x87,
+  0xc1, 0x14, 0x29, 0x78, 0xea, 0x1e, 0x78, 0x24, 0x54, 0xcb, 0xdd, 0xe3,
+  0xa0, 0xfd, 0x53, 0x12, 0x3e, 0x42, 0xf7, 0x59, 0x2b, 0xad, 0xfe, 0xe9,
+  0x63, 0xd1, 0xb9, 0x54, 0x39, 0x26, 0xc9, 0x4b, 0x1b, 0xb1, 0x00, 0x24,
+  0x63, 0x97, 0x4d, 0x3f, 0x15, 0xb1, 0x27, 0x47, 0x29, 0xbd, 0xd6, 0x53,
+  0xd7, 0xcc, 0x8b, 0xfe, 0x7a, 0x93, 0x17, 0x92, 0xea, 0x1e, 0xbc, 0xfe,
+  0xb4, 0xc7, 0xfd, 0x58, 0xb3, 0xcc, 0x3c, 0x02, 0x2d, 0x79, 0xcf, 0x3f,
+  0xb3, 0x37, 0xc1, 0x03, 0xf7, 0x54, 0x20, 0xc3, 0x81, 0x0f, 0x58, 0xaa,
+  0x17, 0x49, 0xfc, 0x27, 0x99, 0x76, 0x3a, 0x88, 0x20, 0xcb, 0xcf, 0xed,
+  0xe7, 0x17, 0xe5, 0x65, 0xe2, 0x63, 0xb2, 0x3c, 0x65, 0x92, 0x7a, 0x8b,
+  0x76, 0x15, 0xce, 0x3a, 0x28, 0x92, 0x0b, 0xaf, 0x4c, 0xd6, 0x3d, 0xfd,
+  0x5c, 0x68, 0x43, 0xe5, 0xa5, 0x35, 0x56, 0xfb, 0xde, 0x78, 0xb6, 0xef,
+  0x2b, 0xab, 0x33, 0x8a, 0xca, 0x72, 0x19, 0x7f, 0xef, 0x0b, 0x4c, 0x19,
+  0xc7, 0x46, 0x8c, 0x5c, 0x1a, 0xa2, 0xc6, 0x33, 0x0e, 0xca, 0xd0, 0x3d,
+  0x76, 0xd8, 0x62, 0xba, 0x17, 0xbe, 0xfa, 0x94, 0x1c, 0xbf, 0xf1, 0x1e,
+  0x7c, 0xe4, 0x16, 0x98, 0x2e, 0x48, 0x1b, 0xb8, 0x63, 0x47, 0x55, 0x9d,
+  0xec, 0xd0, 0x5b, 0x1e, 0x66, 0xc9, 0x33, 0xa6, 0x8c, 0xf7, 0x25, 0x83,
+  0x6e, 0x61, 0xff, 0x83, 0x67, 0x98, 0x1c, 0x5e, 0x5f, 0x19, 0xa9, 0x36,
+  0x6d, 0x90, 0x13, 0x5a, 0x68, 0x84, 0xab, 0x7b, 0xf6, 0xcf, 0x9e, 0x6e,
+  0x78, 0x56, 0x84, 0x66, 0x6d, 0x45, 0xbd, 0xf7, 0xde, 0xb3, 0xf0, 0x9a,
+  0xab, 0x39, 0xa0, 0x55, 0x0a, 0x72, 0xd3, 0x92, 0x1d, 0x2a, 0x8f, 0xfe,
+  0x0f, 0xf5, 0x0c, 0x56, 0x84, 0x27, 0x58, 0xff, 0x87, 0x3f, 0xdf, 0xcf,
+  0xfd, 0x1a, 0x3e, 0xf6, 0x09, 0x56, 0x19, 0xc2, 0x04, 0xd3, 0x56, 0xbb,
+  0x08, 0x97, 0x21, 0x84, 0xdd, 0xf1, 0x46, 0xe0, 0x33, 0x37, 0x7a, 0xc4,
+  0xba, 0x70, 0x9c, 0x83, 0x0d, 0x40, 0xc1, 0x22, 0x98, 0xf9, 0xb8, 0x93,
+  0xc4, 0xf3, 0xc5, 0x0b, 0xe5, 0xf9, 0x50, 0xf7, 0x3b, 0xd7, 0xa0, 0xbe,
+  0x5a, 0xb3, 0xc5, 0x6d, 0x57, 0xe4, 0x1c, 0x6c, 0xde, 0x6b, 0x87, 0x8e,
+  0x7b, 0x89, 0xd8, 0xe7, 0x82, 0x93, 0xd7, 0x14, 0x05, 0x66, 0xb3, 0xdc,
+  0x36, 0x11, 0x80, 0x7b, 0xbc, 0x2a, 0xd9, 0x67, 0x48, 0x60, 0x1b, 0x3b,
+  0x69, 0x3c, 0x35, 0x53, 0x92, 0xc8, 0xbd, 0xcf, 0x88, 0x6a, 0x43, 0x29,
+  0x4e, 0xe6, 0x94, 0xae, 0xb2, 0xe9, 0x27, 0xbd, 0x32, 0x76, 0x8c, 0xc8,
+  0x5b, 0x8f, 0xed, 0xd6, 0x12, 0xf5, 0x9d, 0x9d, 0x1f, 0x75, 0x8d, 0x00,
+  0xf7, 0x28, 0x53, 0xcd, 0xf9, 0xc5, 0xf8, 0xec, 0x05, 0xcd, 0x97, 0xc3,
+  0x86, 0xe6, 0x42, 0xbc, 0x1e, 0x67, 0x7f, 0x97, 0x32, 0xb3, 0xda, 0x3d,
+  0xfd, 0xb4, 0xe7, 0xe9, 0xb1, 0x38, 0xf7, 0x8e, 0x81, 0xd4, 0x6c, 0xce,
+  0xc1, 0x7f, 0x89, 0x89, 0x66, 0x5d, 0xa8, 0x7f, 0x9f, 0x5d, 0x60, 0x34,
+  0x33, 0x70, 0x43, 0x0a, 0x2d, 0xbb, 0x87, 0x3f, 0x77, 0x9e, 0x9a, 0xab,
+  0x75, 0xf1, 0xc9, 0xea, 0x8b, 0x82, 0xa3, 0xa7, 0x07, 0xec, 0x5e, 0x78,
+  0xae, 0x57, 0xc3, 0xf3, 0x83, 0xda, 0xbc, 0xa7, 0x81, 0x78, 0x28, 0xc4,
+  0xf5, 0x28, 0xf1, 0x4e, 0xc3, 0x5f, 0xd7, 0xde, 0x1e, 0x3c, 0xdf, 0xb7,
+  0xe2, 0x57, 0x10, 0x79, 0x3e, 0x65, 0x77, 0x8e, 0xea, 0x34, 0xc7, 0x62,
+  0x95, 0x17, 0xe4, 0x82, 0x70, 0x8f, 0xb8, 0x01, 0x0e, 0x5a, 0x42, 0xa0,
+  0xab, 0x6e, 0xd4, 0x4d, 0xda, 0xac, 0x3d, 0x11, 0xf3, 0x9c, 0x69, 0x67,
+  0x4c, 0x51, 0xc7, 0xa5, 0xd0, 0x6b, 0x5e, 0xa8, 0xb7, 0xad, 0xe3, 0x42,
+  0xd3, 0x97, 0xbe, 0xff, 0x9e, 0xe5, 0x88, 0x05, 0x8b, 0x93, 0xd0, 0x95,
+  0x6d, 0xfe, 0x64, 0xf8, 0x2e, 0x03, 0x08, 0xd3, 0x15, 0x46, 0xc0, 0xa7,
+  0xca, 0xa8, 0x3d, 0xa5, 0xa2, 0xdf, 0xe0, 0xf2, 0xc4, 0xa2, 0xe7, 0x65,
+  0x21, 0x31, 0x5b, 0x4a, 0xde, 0x84, 0xe7, 0x93, 0xc1, 0xa6, 0xd9, 0x17,
+  0x66, 0x66, 0xf0, 0xea, 0xc3, 0xc5, 0xd7, 0xa7, 0xe7, 0xe3, 0x64, 0x8f,
+  0x4a, 0xdb, 0x2f, 0xce, 0x8f, 0xff, 0xfc, 0xe1, 0xc2, 0xfc, 0x53, 0x47,
+  0x7a, 0x93, 0x16, 0xb9, 0x91, 0x4e, 0x66, 0x39, 0x59, 0x61, 0x88, 0xe5,
+  0x52, 0x9b, 0x34, 0x31, 0x74, 0xb1, 0x91, 0xc7, 0x65, 0xa5, 0x88, 0x26,
+  0x94, 0x8f, 0x52, 0xca, 0x89, 0x33, 0xaa, 0x5f, 0xc1, 0x19, 0x7e, 0xa5,
+  0xb3, 0x9c, 0xf3, 0x4e, 0x51, 0xbe, 0xa6, 0xed, 0x24, 0x17, 0x5f, 0xbf,
+  0x7a, 0xff, 0xcd, 0x58, 0x3b, 0x78, 0x7c, 0xf7, 0xdd, 0x77, 0xdd, 0xe0,
+  0x2e, 0xf4, 0xd8, 0xab, 0xf4, 0xf6, 0x76, 0x54, 0x67, 0x9f, 0x7d, 0x36,
+  0x3e, 0x3a, 0x4a, 0x5e, 0x9d, 0x8c, 0x4f, 0x3f, 0x73, 0x38, 0x0e, 0x3b,
+  0x07, 0x84, 0x60, 0x75, 0x99, 0x35, 0xe6, 0x2f, 0x9f, 0x7d, 0xf6, 0xff,
+  0x01, 0xdb, 0xb6, 0x69, 0xbe, 0xc6, 0x8e, 0x02, 0x00,
+};
+#define BUF_SIZE 0x10000
+static voidpf zalloc_func(voidpf opaque, unsigned int items, unsigned int size)
+{
+  (void) opaque;
+  /* not a typo, keep it calloc() */
+  return (voidpf) calloc(items, size);
+}
+static void zfree_func(voidpf opaque, voidpf ptr)
+{
+  (void) opaque;
+  free(ptr);
+}
+/* Decompress and send to stdout a gzip-compressed buffer */
+void hugehelp(void)
+{
+  unsigned char* buf;
+  int status,headerlen;
+  z_stream z;
+
+  /* Make sure no gzip options are set */
+  if (hugehelpgz[3] & 0xfe)
+    return;
+
+  headerlen = 10;
+  memset(&z, 0, sizeof(z_stream));
+  z.zalloc = (alloc_func)zalloc_func;
+  z.zfree = (free_func)zfree_func;
+  z.avail_in = (unsigned int)(sizeof(hugehelpgz) - headerlen);
+  z.next_in = (unsigned char *)hugehelpgz + headerlen;
+
+  if (inflateInit2(&z, -MAX_WBITS) != Z_OK)
+    return;
+
+  buf = malloc(BUF_SIZE);
+  if (buf) {
+    while(1) {
+      z.avail_out = BUF_SIZE;
+      z.next_out = buf;
+      status = inflate(&z, Z_SYNC_FLUSH);
+      if (status == Z_OK || status == Z_STREAM_END) {
+        fwrite(buf, BUF_SIZE - z.avail_out, 1, stdout);
+        if (status == Z_STREAM_END)
+          break;
+      }
+      else
+        break;    /* Error */
+    }
+    free(buf);
+  }
+  inflateEnd(&z);
+}
+#else /* !USE_MANUAL */
+/* built-in manual is disabled, blank function */
+#include "tool_hugehelp.h"
+void hugehelp(void) {}
+#endif /* USE_MANUAL */
+#endif /* HAVE_LIBZ */
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <deque>
+#include <vector>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace fts3 {
+namespace common {
+
+/// Queue between two threads, with a limited number of elements, so a fast producer
+/// waits for the consumer instead of piling up work.
+/// push and pop are interruption points.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity): capacity(capacity), closed(false)
+    {
+    }
+
+    /// Wait until there is room, and push value
+    /// @return false if the queue has been closed, and value was not pushed
+    bool push(T &&value)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        while (!closed && elements.size() >= capacity) {
+            notFull.wait(lock);
+        }
+        if (closed) {
+            return false;
+        }
+        elements.push_back(std::move(value));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /// Wait until there is an element, and pop it into value
+    /// @return false if the queue has been closed and there is nothing left
+    bool pop(T &value)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        while (!closed && elements.empty()) {
+            notEmpty.wait(lock);
+        }
+        if (elements.empty()) {
+            return false;
+        }
+        value = std::move(elements.front());
+        elements.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    /// Wait until there is an element, and pop up to max elements, in order, at the end of values
+    /// @return false if the queue has been closed and there is nothing left
+    bool popMany(std::vector<T> &values, size_t max)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        while (!closed && elements.empty()) {
+            notEmpty.wait(lock);
+        }
+        if (elements.empty()) {
+            return false;
+        }
+        for (size_t i = 0; i < max && !elements.empty(); ++i) {
+            values.push_back(std::move(elements.front()));
+            elements.pop_front();
+        }
+        notFull.notify_all();
+        return true;
+    }
+
+    /// Wake up the waiting threads, and refuse new elements
+    void close()
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+    /// @return the number of elements waiting
+    size_t size()
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        return elements.size();
+    }
+
+private:
+    boost::mutex mutex;
+    boost::condition_variable notFull, notEmpty;
+    std::deque<T> elements;
+    size_t capacity;
+    bool closed;
+};
+
+}
+}
+
+#endif // BOUNDED_QUEUE_H
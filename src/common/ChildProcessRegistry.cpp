@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ChildProcessRegistry.h"
+#include "DaemonTools.h"
+#include "Logger.h"
+
+#include <cstring>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+
+// Older headers do not know about it, the number is the same for all architectures
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+
+namespace fts3 {
+namespace common {
+
+
+static int pidfdOpen(pid_t pid)
+{
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+}
+
+
+ChildProcessRegistry::ChildProcessRegistry(): epollFd(-1), wakeFd(-1), supported(false)
+{
+    int probe = pidfdOpen(getpid());
+    if (probe < 0) {
+        FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "pidfd not supported (" << strerror(errno)
+            << "), child processes will be counted scanning /proc" << commit;
+        return;
+    }
+    close(probe);
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = wakeFd;
+    if (epollFd < 0 || wakeFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) < 0) {
+        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Could not set up the child process reaper (" << strerror(errno)
+            << "), child processes will be counted scanning /proc" << commit;
+        return;
+    }
+
+    supported = true;
+    reaper = boost::thread(&ChildProcessRegistry::reap, this);
+}
+
+
+ChildProcessRegistry::~ChildProcessRegistry()
+{
+    if (supported) {
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) < 0) {
+            reaper.interrupt();
+        }
+        reaper.join();
+    }
+
+    for (auto i = byFd.begin(); i != byFd.end(); ++i) {
+        close(i->first);
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+    if (wakeFd >= 0) {
+        close(wakeFd);
+    }
+}
+
+
+bool ChildProcessRegistry::add(pid_t pid, const std::string &name)
+{
+    if (!supported) {
+        return false;
+    }
+
+    boost::mutex::scoped_lock lock(mutex);
+    return addLocked(pid, boost::filesystem::path(name).filename().string());
+}
+
+
+bool ChildProcessRegistry::addLocked(pid_t pid, const std::string &name)
+{
+    if (pids.count(pid)) {
+        return true;
+    }
+
+    int fd = pidfdOpen(pid);
+    if (fd < 0) {
+        // Already gone, so there is nothing to count
+        if (errno != ESRCH) {
+            FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Could not watch process " << pid << ": "
+                << strerror(errno) << ", " << name << " processes will be counted scanning /proc" << commit;
+            adopted.erase(name);
+        }
+        return false;
+    }
+
+    // Readable once the process exits
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Could not watch process " << pid << ": "
+            << strerror(errno) << ", " << name << " processes will be counted scanning /proc" << commit;
+        close(fd);
+        adopted.erase(name);
+        return false;
+    }
+
+    Entry &entry = byFd[fd];
+    entry.pid = pid;
+    entry.name = name;
+    pids.insert(pid);
+    ++counts[name];
+    return true;
+}
+
+
+int ChildProcessRegistry::count(const std::string &name)
+{
+    if (!supported) {
+        return countProcessesWithName(name);
+    }
+
+    boost::mutex::scoped_lock lock(mutex);
+
+    // Processes started before the registry existed, or that could not be watched when added
+    if (adopted.count(name) == 0) {
+        std::vector<pid_t> running;
+        try {
+            running = getProcessesWithName(name);
+        }
+        catch (const std::exception &e) {
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Could not adopt the running " << name
+                << " processes: " << e.what() << commit;
+            return -1;
+        }
+        adopted.insert(name);
+        for (auto i = running.begin(); i != running.end(); ++i) {
+            addLocked(*i, name);
+        }
+        // Some are still not watched, so the scan is the only reliable count
+        if (adopted.count(name) == 0) {
+            return static_cast<int>(running.size());
+        }
+    }
+
+    auto i = counts.find(name);
+    return i != counts.end() ? i->second : 0;
+}
+
+
+bool ChildProcessRegistry::isSupported() const
+{
+    return supported;
+}
+
+
+void ChildProcessRegistry::reap()
+{
+    struct epoll_event events[64];
+
+    while (true) {
+        int n = epoll_wait(epollFd, events, sizeof(events) / sizeof(events[0]), -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            FTS3_COMMON_LOGGER_NEWLOG(CRIT) << "Child process reaper failed: " << strerror(errno) << commit;
+            return;
+        }
+
+        boost::mutex::scoped_lock lock(mutex);
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wakeFd) {
+                return;
+            }
+
+            auto entry = byFd.find(fd);
+            if (entry == byFd.end()) {
+                continue;
+            }
+
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL);
+            close(fd);
+            pids.erase(entry->second.pid);
+            --counts[entry->second.name];
+            byFd.erase(entry);
+        }
+    }
+}
+
+} // namespace common
+} // namespace fts3
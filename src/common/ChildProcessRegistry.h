@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef CHILDPROCESSREGISTRY_H_
+#define CHILDPROCESSREGISTRY_H_
+
+#include <sys/types.h>
+
+#include <map>
+#include <set>
+#include <string>
+
+#include <boost/thread.hpp>
+
+#include "Singleton.h"
+
+
+namespace fts3 {
+namespace common {
+
+/// Keeps track of the processes spawned by this process, so how many of them are
+/// still running can be known without scanning /proc.
+///
+/// Each process is watched through a pidfd, and a reaper thread removes it from the registry
+/// when it exits. Processes are grouped by the name of their binary.
+/// The first time a name is queried, the processes already running with that name
+/// (i.e. left by a previous instance of the server) are adopted with a single /proc scan.
+///
+/// If the kernel does not support pidfds, count() falls back to countProcessesWithName.
+/// So it does when a running process could not be watched (i.e. out of file descriptors),
+/// until a later scan manages to watch all the processes with that name.
+class ChildProcessRegistry: public Singleton<ChildProcessRegistry>
+{
+public:
+    ChildProcessRegistry();
+    virtual ~ChildProcessRegistry();
+
+    /// Start tracking a process
+    /// @param pid  Process id. Must not have been reaped yet, so it can not have been reused
+    /// @param name Binary name. Only the base name is kept
+    /// @return false if the process can not be tracked (already gone, no pidfd support,
+    ///         or it could not be watched, and count() scans /proc for its name meanwhile)
+    bool add(pid_t pid, const std::string &name);
+
+    /// @return Number of tracked processes with the given name still running, < 0 on error
+    int count(const std::string &name);
+
+    /// @return true if processes are tracked through pidfds
+    bool isSupported() const;
+
+private:
+    struct Entry {
+        pid_t pid;
+        std::string name;
+    };
+
+    int epollFd;
+    int wakeFd;
+    bool supported;
+
+    boost::mutex mutex;
+    /// Tracked processes, indexed by their pidfd
+    std::map<int, Entry> byFd;
+    std::set<pid_t> pids;
+    std::map<std::string, int> counts;
+    /// Names for which running processes have already been adopted, and are all watched
+    std::set<std::string> adopted;
+
+    boost::thread reaper;
+
+    /// Caller must hold the mutex
+    bool addLocked(pid_t pid, const std::string &name);
+
+    /// Removes the exited processes, runs in the reaper thread
+    void reap();
+};
+
+} // namespace common
+} // namespace fts3
+
+#endif // CHILDPROCESSREGISTRY_H_
@@ -74,16 +74,17 @@ uid_t getGroupGid(const std::string& name)
 }
 
 
-int countProcessesWithName(const std::string& name)
+std::vector<pid_t> getProcessesWithName(const std::string& name)
 {
-    int count = 0;
+    std::vector<pid_t> pids;
 
     try {
         fs::directory_iterator end_itr;
         for (fs::directory_iterator itr("/proc"); itr != end_itr; ++itr) {
             char *endptr;
             errno = 0;
-            long pid = strtol(itr->path().filename().c_str(), &endptr, 10);
+            const std::string fileName = itr->path().filename().string();
+            long pid = strtol(fileName.c_str(), &endptr, 10);
             if (*endptr != '\0' || ((pid == LONG_MIN || pid == LONG_MAX) && errno == ERANGE))
                 continue;
 
@@ -97,7 +98,7 @@ int countProcessesWithName(const std::string& name)
                 cmdlineStream.getline(cmdName, sizeof(cmdName), '\0');
 
                 if (boost::ends_with(cmdName, name)) {
-                    ++count;
+                    pids.push_back(static_cast<pid_t>(pid));
                 }
             }
             catch (...) {
@@ -105,11 +106,22 @@ int countProcessesWithName(const std::string& name)
             }
         }
     }
+    catch (const std::exception &e) {
+        throw SystemError(std::string(__func__) + ": Caught exception " + e.what());
+    }
+
+    return pids;
+}
+
+
+int countProcessesWithName(const std::string& name)
+{
+    try {
+        return static_cast<int>(getProcessesWithName(name).size());
+    }
     catch (...) {
         return -1;
     }
-
-    return count;
 }
 
 
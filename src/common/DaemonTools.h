@@ -24,6 +24,7 @@
 
 #include <sys/types.h>
 #include <string>
+#include <vector>
 
 namespace fts3 {
 namespace common {
@@ -36,6 +37,10 @@ uid_t getUserUid(const std::string& name);
 /// Throws exception if not found, or on error
 gid_t getGroupGid(const std::string& name);
 
+/// Returns the pids of the processes with the given name, scanning /proc
+/// Throws SystemError on error
+std::vector<pid_t> getProcessesWithName(const std::string& name);
+
 /// Returns how many processes with the given name are running
 /// @return < 0 on error, number of processes with the given name otherwise
 int countProcessesWithName(const std::string& name);
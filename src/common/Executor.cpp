@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Executor.h"
+#include "Exceptions.h"
+#include "Logger.h"
+
+namespace fts3
+{
+namespace common
+{
+
+// Identity of the worker running on this thread
+static thread_local const Executor *currentExecutor = NULL;
+static thread_local int currentIndex = -1;
+
+
+Executor::Executor(size_t size): pending(0), sleeping(0), joining(false), interrupted(false), nextWorker(0)
+{
+    if (size == 0) {
+        size = 1;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        workers.emplace_back(new Worker);
+    }
+    for (size_t i = 0; i < size; ++i) {
+        threads.create_thread(std::bind(&Executor::run, this, static_cast<int>(i)));
+    }
+}
+
+
+Executor::~Executor()
+{
+    interrupt();
+    join();
+}
+
+
+void Executor::post(std::function<void()> func, Priority priority)
+{
+    if (joining || interrupted) {
+        throw SystemError("Executor: can not post new tasks after join or interrupt");
+    }
+
+    Task task;
+    task.func = std::move(func);
+    task.queued = std::chrono::steady_clock::now();
+
+    // Keep the work local when posted from one of our own workers
+    size_t index;
+    if (currentExecutor == this) {
+        index = currentIndex;
+    }
+    else {
+        index = nextWorker++ % workers.size();
+    }
+
+    ++pending;
+    {
+        boost::mutex::scoped_lock lock(workers[index]->mutex);
+        workers[index]->queues[priority].push_back(std::move(task));
+        ++workers[index]->submitted;
+    }
+
+    // Raced with interrupt, which may have missed this one
+    if (interrupted) {
+        drop();
+        return;
+    }
+
+    // A worker going to sleep registers itself before checking pending, so either it sees
+    // this task, or it is seen here
+    if (sleeping > 0) {
+        boost::mutex::scoped_lock lock(sleepMutex);
+        sleepCond.notify_one();
+    }
+}
+
+
+bool Executor::popFrom(Worker &worker, int priority, bool front, Task &task)
+{
+    boost::mutex::scoped_lock lock(worker.mutex);
+    std::deque<Task> &queue = worker.queues[priority];
+    if (queue.empty()) {
+        return false;
+    }
+    if (front) {
+        task = std::move(queue.front());
+        queue.pop_front();
+    }
+    else {
+        task = std::move(queue.back());
+        queue.pop_back();
+    }
+    --pending;
+    return true;
+}
+
+
+bool Executor::pop(int index, Task &task)
+{
+    const size_t nWorkers = workers.size();
+
+    for (int priority = PRIORITY_HIGH; priority <= PRIORITY_NORMAL; ++priority) {
+        // Own tasks first, in order
+        if (popFrom(*workers[index], priority, true, task)) {
+            return true;
+        }
+        // Then steal from the others, from the back
+        for (size_t i = 1; i < nWorkers; ++i) {
+            if (popFrom(*workers[(index + i) % nWorkers], priority, false, task)) {
+                workers[index]->steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+void Executor::execute(Worker &worker, Task &task)
+{
+    uint64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - task.queued).count();
+    worker.totalLatencyUs.fetch_add(latency, std::memory_order_relaxed);
+    if (latency > worker.maxLatencyUs.load(std::memory_order_relaxed)) {
+        worker.maxLatencyUs.store(latency, std::memory_order_relaxed);
+    }
+
+    try {
+        task.func();
+    }
+    catch (const boost::thread_interrupted&) {
+        worker.executed.fetch_add(1, std::memory_order_relaxed);
+        throw;
+    }
+    catch (const std::exception &e) {
+        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Executor: task failed with " << e.what() << commit;
+    }
+    catch (...) {
+        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Executor: task failed with an unknown exception" << commit;
+    }
+    worker.executed.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+void Executor::run(int index)
+{
+    currentExecutor = this;
+    currentIndex = index;
+
+    try {
+        while (!interrupted) {
+            Task task;
+            if (pop(index, task)) {
+                execute(*workers[index], task);
+                continue;
+            }
+
+            boost::mutex::scoped_lock lock(sleepMutex);
+            ++sleeping;
+            while (pending == 0 && !joining) {
+                sleepCond.wait(lock);
+            }
+            --sleeping;
+            if (pending == 0 && joining) {
+                break;
+            }
+        }
+    }
+    catch (const boost::thread_interrupted&) {
+        // Interrupted, leave
+    }
+
+    currentExecutor = NULL;
+    currentIndex = -1;
+}
+
+
+void Executor::drop()
+{
+    // Destroy the tasks outside the locks, their destructors may need to notify someone else
+    std::deque<Task> dropped;
+    for (auto i = workers.begin(); i != workers.end(); ++i) {
+        boost::mutex::scoped_lock lock((*i)->mutex);
+        for (int priority = PRIORITY_HIGH; priority <= PRIORITY_NORMAL; ++priority) {
+            std::deque<Task> &queue = (*i)->queues[priority];
+            pending -= queue.size();
+            std::move(queue.begin(), queue.end(), std::back_inserter(dropped));
+            queue.clear();
+        }
+    }
+    dropped.clear();
+}
+
+
+void Executor::interrupt()
+{
+    interrupted = true;
+    threads.interrupt_all();
+    drop();
+}
+
+
+void Executor::join()
+{
+    {
+        boost::mutex::scoped_lock lock(sleepMutex);
+        joining = true;
+    }
+    sleepCond.notify_all();
+    threads.join_all();
+}
+
+
+size_t Executor::size() const
+{
+    return workers.size();
+}
+
+
+Executor::Metrics Executor::getMetrics() const
+{
+    Metrics metrics;
+    uint64_t totalLatencyUs = 0, maxLatencyUs = 0;
+
+    metrics.queueDepth = pending;
+    for (auto i = workers.begin(); i != workers.end(); ++i) {
+        {
+            boost::mutex::scoped_lock lock((*i)->mutex);
+            metrics.submitted += (*i)->submitted;
+        }
+        metrics.executed += (*i)->executed;
+        metrics.steals += (*i)->steals;
+        totalLatencyUs += (*i)->totalLatencyUs;
+        maxLatencyUs = std::max<uint64_t>(maxLatencyUs, (*i)->maxLatencyUs);
+    }
+    if (metrics.executed > 0) {
+        metrics.avgLatencyMs = (totalLatencyUs / 1000.0) / metrics.executed;
+    }
+    metrics.maxLatencyMs = maxLatencyUs / 1000.0;
+    return metrics;
+}
+
+
+int Executor::currentWorker()
+{
+    return currentIndex;
+}
+
+} /* namespace common */
+} /* namespace fts3 */
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef EXECUTOR_H_
+#define EXECUTOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+
+namespace fts3
+{
+namespace common
+{
+
+/**
+ * Long-lived pool of worker threads with work stealing.
+ *
+ * Every worker owns a deque per priority. Tasks posted from outside are spread round-robin,
+ * tasks posted from a worker go into its own deque. A worker runs first from its own deque,
+ * and steals from the back of the others when it runs out, so a single producer does not
+ * serialize all the workers on the same lock.
+ * High priority tasks are always picked before normal ones, from any deque.
+ */
+class Executor: public boost::noncopyable
+{
+public:
+
+    enum Priority {
+        PRIORITY_HIGH = 0,
+        PRIORITY_NORMAL = 1
+    };
+
+    /// Snapshot of the counters of the executor
+    struct Metrics {
+        /// Tasks queued and not started yet
+        size_t queueDepth;
+        uint64_t submitted;
+        uint64_t executed;
+        /// Tasks taken from the deque of another worker
+        uint64_t steals;
+        /// Time spent queued, from post to start
+        double avgLatencyMs, maxLatencyMs;
+
+        Metrics(): queueDepth(0), submitted(0), executed(0), steals(0), avgLatencyMs(0), maxLatencyMs(0) {}
+    };
+
+    /**
+     * Constructor
+     *
+     * @param size : number of worker threads
+     */
+    explicit Executor(size_t size);
+
+    /// Destructor, interrupts and joins the workers
+    ~Executor();
+
+    /// Queue a task
+    void post(std::function<void()> task, Priority priority = PRIORITY_NORMAL);
+
+    /**
+     * Queue a callable and return a future for its result.
+     * Exceptions thrown by the callable are delivered through the future
+     */
+    template <typename F>
+    auto submit(F func, Priority priority = PRIORITY_NORMAL) -> std::future<decltype(func())>
+    {
+        typedef decltype(func()) Result;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(func));
+        std::future<Result> future = task->get_future();
+        post([task]() { (*task)(); }, priority);
+        return future;
+    }
+
+    /// Interrupt the workers, and drop the tasks not started yet
+    void interrupt();
+
+    /// Run the remaining tasks and stop the workers. No task can be posted afterwards
+    void join();
+
+    /// @return number of worker threads
+    size_t size() const;
+
+    Metrics getMetrics() const;
+
+    /// @return index of the calling thread within its executor, -1 if it is not a worker
+    static int currentWorker();
+
+private:
+    struct Task {
+        std::function<void()> func;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    // Counters are kept per worker so the workers do not compete for the same cache line
+    struct alignas(64) Worker {
+        boost::mutex mutex;
+        std::deque<Task> queues[2];
+        // Written by the producers, under mutex
+        uint64_t submitted;
+        // Written only by the worker itself
+        std::atomic<uint64_t> executed, steals, totalLatencyUs, maxLatencyUs;
+
+        Worker(): submitted(0), executed(0), steals(0), totalLatencyUs(0), maxLatencyUs(0) {}
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    boost::thread_group threads;
+
+    // Tasks queued, increased before the task is visible, so it may be ahead of the deques
+    std::atomic<size_t> pending;
+    // Idle workers wait on sleepCond. They are only notified when there is someone sleeping
+    boost::mutex sleepMutex;
+    boost::condition_variable sleepCond;
+    std::atomic<size_t> sleeping;
+    std::atomic<bool> joining;
+    std::atomic<bool> interrupted;
+
+    std::atomic<size_t> nextWorker;
+
+    void run(int index);
+    bool pop(int index, Task &task);
+    bool popFrom(Worker &worker, int priority, bool front, Task &task);
+    void execute(Worker &worker, Task &task);
+    void drop();
+};
+
+} /* namespace common */
+} /* namespace fts3 */
+
+#endif /* EXECUTOR_H_ */
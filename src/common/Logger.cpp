@@ -23,9 +23,15 @@
 #include "Logger.h"
 #include "Exceptions.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <fcntl.h>
 #include <fstream>
+#include <pthread.h>
+#include <vector>
 #include <boost/algorithm/string.hpp>
+#include <boost/thread.hpp>
 
 
 namespace fts3 {
@@ -38,13 +44,197 @@ Logger& theLogger()
     return *logger;
 }
 
+
+/// Lines queued by a single thread. Only that thread pushes, only the writer pops.
+struct LogRing
+{
+    static const size_t CAPACITY = 1024;
+
+    struct Slot {
+        uint64_t stamp;
+        std::string line;
+    };
+
+    Slot slots[CAPACITY];
+    /// Next slot to consume, updated by the writer
+    std::atomic<size_t> head;
+    /// Next slot to fill, updated by the owner thread
+    std::atomic<size_t> tail;
+    /// The owner thread is gone, the ring can be dropped once empty
+    std::atomic<bool> orphan;
+
+    LogRing(): head(0), tail(0), orphan(false) {}
+};
+
+
+/// Ring of the calling thread
+struct LogRingHolder
+{
+    const void *owner;
+    std::shared_ptr<LogRing> ring;
+
+    LogRingHolder(): owner(NULL) {}
+
+    ~LogRingHolder()
+    {
+        if (ring) {
+            ring->orphan = true;
+        }
+    }
+};
+
+static thread_local LogRingHolder localRing;
+
+
+/// Drains the rings of all the threads into the output in batches
+class Logger::AsyncWriter
+{
+public:
+    /// Interval between batches, unless a ring is filling up
+    static constexpr int WRITE_INTERVAL_MS = 20;
+
+    AsyncWriter(Logger &logger): logger(logger), stop(false)
+    {
+        thread = boost::thread(&AsyncWriter::run, this);
+    }
+
+    ~AsyncWriter()
+    {
+        {
+            boost::mutex::scoped_lock lock(wakeMutex);
+            stop = true;
+        }
+        wakeCond.notify_one();
+        thread.join();
+    }
+
+    void push(std::string &&line)
+    {
+        if (localRing.owner != this || !localRing.ring) {
+            localRing.owner = this;
+            localRing.ring = std::make_shared<LogRing>();
+            boost::mutex::scoped_lock lock(ringsMutex);
+            rings.push_back(localRing.ring);
+        }
+        LogRing &ring = *localRing.ring;
+
+        const size_t tail = ring.tail.load(std::memory_order_relaxed);
+        // Full, wait for the writer instead of losing lines
+        while (tail - ring.head.load(std::memory_order_acquire) >= LogRing::CAPACITY) {
+            wakeCond.notify_one();
+            boost::this_thread::yield();
+        }
+
+        LogRing::Slot &slot = ring.slots[tail % LogRing::CAPACITY];
+        slot.stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        slot.line = std::move(line);
+        ring.tail.store(tail + 1, std::memory_order_release);
+
+        if (tail + 1 - ring.head.load(std::memory_order_relaxed) >= LogRing::CAPACITY / 2) {
+            wakeCond.notify_one();
+        }
+    }
+
+    /// Write everything queued so far, ordered by the time the lines were committed
+    void drain()
+    {
+        boost::mutex::scoped_lock drainLock(drainMutex);
+
+        std::vector<std::shared_ptr<LogRing>> current;
+        {
+            boost::mutex::scoped_lock lock(ringsMutex);
+            current = rings;
+        }
+
+        std::vector<size_t> tails(current.size());
+        std::vector<const LogRing::Slot*> pending;
+        for (size_t i = 0; i < current.size(); ++i) {
+            LogRing &ring = *current[i];
+            const size_t head = ring.head.load(std::memory_order_relaxed);
+            tails[i] = ring.tail.load(std::memory_order_acquire);
+            for (size_t j = head; j != tails[i]; ++j) {
+                pending.push_back(&ring.slots[j % LogRing::CAPACITY]);
+            }
+        }
+        if (pending.empty()) {
+            return;
+        }
+
+        std::stable_sort(pending.begin(), pending.end(),
+            [](const LogRing::Slot *a, const LogRing::Slot *b) { return a->stamp < b->stamp; });
+
+        size_t size = 0;
+        for (auto i = pending.begin(); i != pending.end(); ++i) {
+            size += (*i)->line.size() + 1;
+        }
+        std::string batch;
+        batch.reserve(size);
+        for (auto i = pending.begin(); i != pending.end(); ++i) {
+            batch.append((*i)->line);
+            batch.push_back('\n');
+        }
+
+        // Give the slots back before writing
+        for (size_t i = 0; i < current.size(); ++i) {
+            current[i]->head.store(tails[i], std::memory_order_release);
+        }
+
+        logger.flushBatch(batch);
+
+        // Forget the rings of the threads that are gone
+        boost::mutex::scoped_lock lock(ringsMutex);
+        rings.erase(std::remove_if(rings.begin(), rings.end(), [](const std::shared_ptr<LogRing> &ring) {
+            return ring->orphan && ring->head == ring->tail;
+        }), rings.end());
+    }
+
+private:
+    Logger &logger;
+
+    boost::mutex ringsMutex;
+    std::vector<std::shared_ptr<LogRing>> rings;
+
+    /// Only one drain at a time, the rings have a single consumer
+    boost::mutex drainMutex;
+
+    boost::mutex wakeMutex;
+    boost::condition_variable wakeCond;
+    bool stop;
+
+    boost::thread thread;
+
+    void run()
+    {
+        while (true) {
+            {
+                boost::mutex::scoped_lock lock(wakeMutex);
+                if (!stop) {
+                    wakeCond.timed_wait(lock, boost::posix_time::milliseconds(WRITE_INTERVAL_MS));
+                }
+                if (stop) {
+                    break;
+                }
+            }
+            drain();
+        }
+        drain();
+    }
+};
+
+
 LoggerEntry::LoggerEntry(bool writeable): writeable(writeable)
 {
+    if (writeable) {
+        stream.reset(new std::ostringstream);
+    }
 }
 
 
-LoggerEntry::LoggerEntry(const LoggerEntry& le): stream(le.stream.str()), writeable(le.writeable)
+LoggerEntry::LoggerEntry(const LoggerEntry& le): writeable(le.writeable)
 {
+    if (writeable) {
+        stream.reset(new std::ostringstream(le.stream->str(), std::ios_base::out | std::ios_base::ate));
+    }
 }
 
 
@@ -87,7 +277,7 @@ Logger::LogLevel Logger::getLogLevel(const std::string& repr)
 }
 
 
-Logger::Logger(): _logLevel(DEBUG), _profiling(false), _separator("; "), _nCommits(0)
+Logger::Logger(): _logLevel(DEBUG), _profiling(false), _async(false), _separator("; "), _nCommits(0)
 {
     ostream = &std::cout;
     newLog(TRACE, __FILE__, __FUNCTION__, __LINE__) << "Logger created" << commit;
@@ -109,6 +299,12 @@ Logger & Logger::setLogLevel(LogLevel level)
     return *this;
 }
 
+
+Logger::LogLevel Logger::getCurrentLogLevel() const
+{
+    return _logLevel;
+}
+
 Logger & Logger::setProfiling(bool value)
 {
     newLog(INFO, __FILE__, __FUNCTION__, __LINE__)
@@ -119,6 +315,42 @@ Logger & Logger::setProfiling(bool value)
 }
 
 
+void Logger::disableAsyncOnFork()
+{
+    theLogger()._async = false;
+}
+
+
+void Logger::drainAsyncOnExit()
+{
+    theLogger().setAsync(false);
+}
+
+
+Logger & Logger::setAsync(bool value)
+{
+    newLog(INFO, __FILE__, __FUNCTION__, __LINE__)
+            << "Setting asynchronous logging to " << value
+            << commit;
+    if (value && !_asyncWriter) {
+        _asyncWriter.reset(new AsyncWriter(*this));
+        pthread_atfork(NULL, NULL, disableAsyncOnFork);
+        std::atexit(drainAsyncOnExit);
+    }
+    _async = value && _asyncWriter;
+    drainAsync();
+    return *this;
+}
+
+
+void Logger::drainAsync()
+{
+    if (_asyncWriter) {
+        _asyncWriter->drain();
+    }
+}
+
+
 void Logger::flush(const std::string &line)
 {
     boost::mutex::scoped_lock lock(outMutex);
@@ -131,12 +363,35 @@ void Logger::flush(const std::string &line)
 }
 
 
+void Logger::flushBatch(const std::string &lines)
+{
+    boost::mutex::scoped_lock lock(outMutex);
+    _nCommits++;
+    if (_nCommits >= NB_COMMITS_BEFORE_CHECK) {
+        _nCommits = 0;
+        checkFd();
+    }
+    ostream->write(lines.data(), lines.size());
+    ostream->flush();
+}
+
+
+void Logger::write(std::string &&line)
+{
+    if (_async) {
+        _asyncWriter->push(std::move(line));
+    }
+    else {
+        flush(line);
+    }
+}
+
+
 /// This method has to be thread safe!
 void LoggerEntry::_commit()
 {
     if (writeable) {
-        std::string line = stream.str();
-        theLogger().flush(line);
+        theLogger().write(stream->str());
     }
 }
 
@@ -150,8 +405,12 @@ LoggerEntry Logger::newLog(LogLevel level, const char* aFile,
     } else {
         can_write = (level >= this->_logLevel);
     }
-    LoggerEntry entry(can_write);
-    entry << logLevelStringRepresentation(level) << timestamp() << _separator;
+    // Nothing to format if it is not going to be written
+    if (!can_write) {
+        return LoggerEntry(false);
+    }
+    LoggerEntry entry(true);
+    entry << logLevelStringRepresentation(level) << cachedTimestamp() << _separator;
     if (level >= ERR && this->_logLevel <= DEBUG) {
         entry << aFile << _separator << aFunc << _separator << std::dec << aLineNo << _separator;
     }
@@ -174,6 +433,9 @@ static int createAndReopen(const std::string& path, FILE* stream)
 
 int Logger::redirect(const std::string& outPath, const std::string& errPath) throw()
 {
+    drainAsync();
+
+    boost::mutex::scoped_lock lock(outMutex);
     if (ostream != &std::cout) {
         delete ostream;
     }
@@ -209,6 +471,20 @@ std::string Logger::timestamp()
 }
 
 
+const std::string& Logger::cachedTimestamp()
+{
+    static thread_local time_t lastSecond = 0;
+    static thread_local std::string lastTimestamp;
+
+    time_t current = time(NULL);
+    if (current != lastSecond) {
+        lastSecond = current;
+        lastTimestamp = timestamp();
+    }
+    return lastTimestamp;
+}
+
+
 std::string Logger::logLevelStringRepresentation(LogLevel loglevel)
 {
     switch (loglevel) {
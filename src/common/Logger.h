@@ -24,7 +24,10 @@
 #ifndef LOGGER_H_
 #define LOGGER_H_
 
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <boost/thread/mutex.hpp>
 
 
@@ -39,7 +42,8 @@ private:
     friend class Logger;
     friend LoggerEntry& commit(LoggerEntry& entry);
 
-    std::stringstream stream;
+    /// Only allocated when the entry is going to be written
+    std::unique_ptr<std::ostringstream> stream;
     bool writeable;
 
     LoggerEntry(bool writeable);
@@ -64,7 +68,7 @@ public:
     {
         if (writeable)
         {
-            stream << aSrc;
+            *stream << aSrc;
         }
         return *this;
     }
@@ -101,9 +105,20 @@ public:
     /// Switch logging on. Log messages will be displayed.
     Logger& setLogLevel(LogLevel level);
 
+    /// @return the level set with setLogLevel
+    LogLevel getCurrentLogLevel() const;
+
     /// Set Profiling Logs On/Off
     Logger& setProfiling(bool value);
 
+    /// Asynchronous mode On/Off
+    /// When on, each thread queues its lines in its own buffer, and a background
+    /// thread writes them in batches. Switching it off writes whatever is pending.
+    Logger& setAsync(bool value);
+
+    /// In asynchronous mode, write now all the lines queued so far
+    void drainAsync();
+
     /// Start a new log message. But this is not the recommended way,
     /// use FTS3_COMMON_LOGGER_NEWLOG. It calls this method, but adds
     /// proper debug information. The integer LOGLEVEL template parameter
@@ -120,12 +135,18 @@ public:
 private:
     friend class LoggerEntry;
 
+    class AsyncWriter;
+
     /// Log level
     LogLevel _logLevel;
 
     /// Profiling On/Off
     bool _profiling;
 
+    /// Asynchronous mode On/Off
+    std::atomic<bool> _async;
+    std::unique_ptr<AsyncWriter> _asyncWriter;
+
     /// Separator for the logging
     std::string _separator;
 
@@ -139,9 +160,24 @@ private:
 
     void flush(const std::string &line);
 
+    /// Write a batch of lines, already terminated
+    void flushBatch(const std::string &lines);
+
+    /// Queue or write a line, depending on the mode
+    void write(std::string &&line);
+
+    /// The writer thread does not survive a fork, the child goes back to synchronous writes
+    static void disableAsyncOnFork();
+
+    /// Write the pending lines before exiting
+    static void drainAsyncOnExit();
+
     /// String representation of the timestamp
     static std::string timestamp();
 
+    /// Same as timestamp, but formatted only once per second and thread
+    static const std::string& cachedTimestamp();
+
     /// String representation of the log level
     static std::string logLevelStringRepresentation(LogLevel loglevel);
 
@@ -21,13 +21,16 @@
 #ifndef THREADPOOL_H_
 #define THREADPOOL_H_
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include <boost/thread.hpp>
-#include <boost/ptr_container/ptr_deque.hpp>
-#include <boost/ptr_container/ptr_vector.hpp>
-#include <boost/bind.hpp>
 #include <boost/any.hpp>
 #include <boost/optional.hpp>
 
+#include "Executor.h"
+
 namespace fts3
 {
 namespace common
@@ -35,6 +38,9 @@ namespace common
 
 /**
  * A generic thread-pool class
+ *
+ * The tasks run on an Executor, either owned by the pool or shared with other pools.
+ * When shared, join only waits for the tasks started through this pool.
  */
 template <typename TASK, typename INIT_FUNC = void (*)(boost::any&)>
 class ThreadPool
@@ -43,36 +49,30 @@ class ThreadPool
     typedef boost::optional<INIT_FUNC> init_func;
 
     /**
-     * A helper class that retrieves subsequent tasks from the queue
-     * and then executes them
+     * A task started by this pool.
+     * Notifies the pool when it is done with, whether it run or it was dropped
      */
-    struct ThreadPoolWorker
+    struct Job
     {
-    public:
+        Job(ThreadPool & pool, TASK *task) : t_pool(pool), task(task) {}
 
-        /// constructor
-        ThreadPoolWorker(ThreadPool & pool, init_func init_context) : t_pool(pool)
+        ~Job()
         {
-            if (init_context.is_initialized()) {
-                (*init_context)(thread_context);
-            }
+            task.reset();
+            t_pool.done();
         }
 
-        /// the run routine that retrieves subsequent tasks
-        /// from the queue and then executes them
         void run()
         {
-            while (!t_pool.interrupt_flag) {
-                std::unique_ptr<TASK> task(t_pool.next());
-                if (!task.get()) break;
-                task->run(thread_context);
+            if (t_pool.interrupt_flag) {
+                return;
             }
+            int worker = Executor::currentWorker();
+            task->run(t_pool.contexts[worker < 0 ? 0 : worker]);
         }
 
-        /// optional data, initialised by the 'init_context' parameter
-        boost::any thread_context;
-        /// reference to the thread pool object
         ThreadPool & t_pool;
+        std::unique_ptr<TASK> task;
     };
 
 public:
@@ -82,16 +82,21 @@ public:
      *
      * @param size : size of the thread pool
      */
-    ThreadPool(int size, init_func init_context = init_func()) : workers(size), interrupt_flag(false), join_flag(false)
+    ThreadPool(int size, init_func init_context = init_func()) :
+        executor(std::make_shared<Executor>(size)), owner(true), running(0), interrupt_flag(false)
     {
-        for (int i = 0; i < size; ++i) {
-            // create new worker
-            ThreadPoolWorker *worker = new ThreadPoolWorker(*this, init_context);
-            // take ownership of the memory
-            workers.push_back(worker);
-            // create new thread belonging to the right group
-            group.create_thread(boost::bind(&ThreadPoolWorker::run, worker));
-        }
+        init(init_context);
+    }
+
+    /**
+     * constructor
+     *
+     * @param executor : executor shared with other pools, it is not joined nor interrupted by this pool
+     */
+    ThreadPool(std::shared_ptr<Executor> executor, init_func init_context = init_func()) :
+        executor(executor), owner(false), running(0), interrupt_flag(false)
+    {
+        init(init_context);
     }
 
     /// destructor
@@ -107,43 +112,52 @@ public:
      * Please note that the thread-pool takes ownership of the pointer!
      *
      * @param t : task that will be executed
+     * @param priority : high priority tasks are picked before any normal one
      */
-    void start(TASK *t)
+    void start(TASK *t, Executor::Priority priority = Executor::PRIORITY_NORMAL)
     {
         {
-            // lock the queue
             boost::mutex::scoped_lock lock(mx);
-            tasks.push_back(t);
+            ++running;
         }
-        // notify waiting threads
-        cvar.notify_all();
+        std::shared_ptr<Job> job = std::make_shared<Job>(*this, t);
+        executor->post([job]() { job->run(); }, priority);
     }
 
     /// interrupt all the threads belonging to this thread pool
+    /// (only the tasks not started yet when the executor is shared)
     void interrupt()
     {
         interrupt_flag = true;
-        group.interrupt_all();
+        if (owner) {
+            executor->interrupt();
+        }
     }
 
     /// join all the threads within this thread pool
     void join()
     {
-        // lock the queue
         {
             boost::mutex::scoped_lock lock(mx);
-            join_flag = true;
+            while (running > 0) {
+                cvar.wait(lock);
+            }
+        }
+        if (owner) {
+            executor->join();
         }
-        // notify waiting threads
-        cvar.notify_all();
-        // join ...
-        group.join_all();
     }
 
     /// @return size of the thread pool
     size_t size()
     {
-        return group.size();
+        return executor->size();
+    }
+
+    /// @return metrics of the underlying executor
+    Executor::Metrics getMetrics()
+    {
+        return executor->getMetrics();
     }
 
     /**
@@ -159,12 +173,12 @@ public:
     template<class RET, template<class> class OPERATION>
     RET reduce(OPERATION<RET> op)
     {
-        typename boost::ptr_vector<ThreadPoolWorker>::iterator it;
+        typename std::vector<boost::any>::iterator it;
         RET init = RET();
 
-        for (it = workers.begin(); it != workers.end(); ++it) {
-            if (it->thread_context.empty()) continue;
-            init = op(init, boost::any_cast<RET>(it->thread_context));
+        for (it = contexts.begin(); it != contexts.end(); ++it) {
+            if (it->empty()) continue;
+            init = op(init, boost::any_cast<RET>(*it));
         }
 
         return init;
@@ -172,44 +186,42 @@ public:
 
 private:
 
-    /**
-     * Returns the next task in the queue
-     *
-     * @return next task in the queue
-     */
-    TASK* next()
+    /// initialise one context per worker thread
+    void init(init_func init_context)
     {
-        // lock the queue
-        boost::mutex::scoped_lock lock(mx);
-        // if the queue is empty wait until someone puts something inside
-        // (unless the join flag is raised)
-        while (tasks.empty() && !join_flag) {
-            cvar.wait(lock);
+        contexts.resize(executor->size());
+        if (init_context.is_initialized()) {
+            for (auto it = contexts.begin(); it != contexts.end(); ++it) {
+                (*init_context)(*it);
+            }
         }
-        // take the first element from the queue
-        typename boost::ptr_deque<TASK>::iterator it = tasks.begin();
-        // if the queue is empty return null
-        if (it == tasks.end()) {
-            return 0;
+    }
+
+    /// called once per task started, when it is finished or dropped
+    /// The pool may be destroyed as soon as join sees no task running, so
+    /// the counter is only touched, and the waiters notified, under the mutex
+    void done()
+    {
+        boost::mutex::scoped_lock lock(mx);
+        if (--running == 0) {
+            cvar.notify_all();
         }
-        // otherwise give up ownership of the object and return it
-        return tasks.release(it).release();
     }
 
-    /// group with worker threads
-    boost::thread_group group;
-    /// the mutex preventing access
+    /// the executor running the tasks
+    std::shared_ptr<Executor> executor;
+    /// true if the executor belongs to this pool
+    bool owner;
+    /// optional data of every worker thread, initialised by the 'init_context' parameter
+    std::vector<boost::any> contexts;
+    /// the mutex used to wait for the running tasks
     boost::mutex mx;
-    /// conditional variable preventing concurrent browsing and reconnecting
+    /// signaled when there are no tasks left
     boost::condition_variable cvar;
-    /// the queue itself
-    boost::ptr_deque<TASK> tasks;
-    /// pool of worker objects
-    boost::ptr_vector<ThreadPoolWorker> workers;
-    /// a flag indicating whether all threads should be stopped
-    bool interrupt_flag;
-    /// a flag indicating whether someone is joining us
-    bool join_flag;
+    /// tasks started and not finished yet, protected by mx
+    size_t running;
+    /// a flag indicating whether the remaining tasks should be dropped
+    std::atomic<bool> interrupt_flag;
 };
 
 } /* namespace common */
@@ -108,7 +108,7 @@ po::options_description ServerConfigReader::_defineConfigOptions()
     (
         "DbType,d",
         po::value<std::string>( &(_vars["DbType"]) )->default_value(FTS3_CONFIG_SERVERCONFIG_DBTYPE_DEFAULT),
-        "Database backend type. Allowed values: mysql"
+        "Database backend type. Allowed values: mysql, memory (synthetic load, for benchmarks)"
     )
 
     (
@@ -243,6 +243,11 @@ po::options_description ServerConfigReader::_defineConfigOptions()
         po::value<std::string>( &(_vars["Profiling"]) )->default_value("false"),
         "Enable or disable internal profiling logs"
     )
+    (
+        "AsyncLogging",
+        po::value<std::string>( &(_vars["AsyncLogging"]) )->default_value("false"),
+        "Write the server log from a background thread, in batches"
+    )
     (
         "UrlCopyProcessPingInterval",
         po::value<std::string>( &(_vars["UrlCopyProcessPingInterval"]) )->default_value("60"),
@@ -408,11 +413,106 @@ po::options_description ServerConfigReader::_defineConfigOptions()
         po::value<std::string>( &(_vars["SchedulingInterval"]) )->default_value("2"),
         "In seconds, how often to schedule new transfers"
     )
+    (
+        "EventDrivenScheduling",
+        po::value<std::string>( &(_vars["EventDrivenScheduling"]) )->default_value("true"),
+        "Schedule the links where transfers finish without waiting for the next scheduling interval"
+    )
+    (
+        "SchedulingWakeupSpacing",
+        po::value<std::string>( &(_vars["SchedulingWakeupSpacing"]) )->default_value("250"),
+        "In milliseconds, minimum time between two scheduling cycles triggered by finished transfers"
+    )
+    (
+        "PipelinedScheduling",
+        po::value<std::string>( &(_vars["PipelinedScheduling"]) )->default_value("true"),
+        "Fetch the next batch of transfers from the database while the previous one is being launched"
+    )
+    (
+        "BundleSizeThreshold",
+        po::value<std::string>( &(_vars["BundleSizeThreshold"]) )->default_value("0"),
+        "In bytes, files of the same job and link up to this size are run by a single url-copy. 0 to disable"
+    )
+    (
+        "BundleMaxFiles",
+        po::value<std::string>( &(_vars["BundleMaxFiles"]) )->default_value("100"),
+        "Maximum number of files run by a single url-copy when bundling small files"
+    )
+    (
+        "LinkCircuitBreaker",
+        po::value<std::string>( &(_vars["LinkCircuitBreaker"]) )->default_value("false"),
+        "Pause the links where most of the recent transfers failed with connection or storage errors"
+    )
+    (
+        "LinkCircuitBreakerWindow",
+        po::value<std::string>( &(_vars["LinkCircuitBreakerWindow"]) )->default_value("50"),
+        "Number of recent transfers considered by the link circuit breaker"
+    )
+    (
+        "LinkCircuitBreakerMinSamples",
+        po::value<std::string>( &(_vars["LinkCircuitBreakerMinSamples"]) )->default_value("20"),
+        "Minimum number of recent transfers before a link can be paused"
+    )
+    (
+        "LinkCircuitBreakerFailureRatio",
+        po::value<double>()->default_value(0.9),
+        "Fraction of the recent transfers failed with link errors that pauses the link"
+    )
+    (
+        "LinkCircuitBreakerBackoff",
+        po::value<std::string>( &(_vars["LinkCircuitBreakerBackoff"]) )->default_value("60"),
+        "In seconds, how long a link is paused the first time"
+    )
+    (
+        "LinkCircuitBreakerMaxBackoff",
+        po::value<std::string>( &(_vars["LinkCircuitBreakerMaxBackoff"]) )->default_value("1800"),
+        "In seconds, the pause doubles each time the probes fail, up to this"
+    )
+    (
+        "LinkCircuitBreakerProbes",
+        po::value<std::string>( &(_vars["LinkCircuitBreakerProbes"]) )->default_value("2"),
+        "Number of transfers let through at once to check if a paused link has recovered"
+    )
+    (
+        "ProgressFlushInterval",
+        po::value<std::string>( &(_vars["ProgressFlushInterval"]) )->default_value("5"),
+        "In seconds, how long the progress of the running transfers is coalesced before being written"
+    )
+    (
+        "ProgressFlushSize",
+        po::value<std::string>( &(_vars["ProgressFlushSize"]) )->default_value("1000"),
+        "Number of transfers with pending progress that triggers a write before the interval"
+    )
     (
         "MessagingConsumeInterval",
         po::value<std::string>( &(_vars["MessagingConsumeInterval"]) )->default_value("1"),
         "In seconds, how often to check for messages"
     )
+    (
+        "MessagingParseThreads",
+        po::value<std::string>( &(_vars["MessagingParseThreads"]) )->default_value("1"),
+        "Number of threads parsing large batches of consumed messages"
+    )
+    (
+        "MessagingShards",
+        po::value<std::string>( &(_vars["MessagingShards"]) )->default_value("0"),
+        "Number of threads applying the status messages, each taking the jobs hashed into it. 0 or 1 to apply them in the messaging thread"
+    )
+    (
+        "MessagingShardMaxBacklog",
+        po::value<std::string>( &(_vars["MessagingShardMaxBacklog"]) )->default_value("5000"),
+        "Status messages are left in the queue while a shard has this many pending"
+    )
+    (
+        "MessagingStatusBatchSize",
+        po::value<std::string>( &(_vars["MessagingStatusBatchSize"]) )->default_value("500"),
+        "Maximum number of status messages applied in the same database transaction. 0 to apply them one by one"
+    )
+    (
+        "MessagingBackend",
+        po::value<std::string>( &(_vars["MessagingBackend"]) )->default_value("dirq"),
+        "Storage of the inter-process messages: dirq (one file per message) or segment (append-only segment files)"
+    )
     (
         "ForceStartTransfersCheckInterval",
         po::value<std::string>( &(_vars["ForceStartTransfersCheckInterval"]) )->default_value("30"),
@@ -488,6 +588,36 @@ po::options_description ServerConfigReader::_defineConfigOptions()
         po::value<std::string>( &(_vars["UseFixedJobPriority"]) )->default_value("0"),
         "Configure the system to use a fixed Job Priority, by default it queries the system to honour the priorities specified by the users"
     )
+    (
+        "UseBulkScheduling",
+        po::value<std::string>( &(_vars["UseBulkScheduling"]) )->default_value("true"),
+        "Fetch the transfers ready to be scheduled for all the queues together, instead of querying queue by queue"
+    )
+    (
+        "UseSpawnHelper",
+        po::value<std::string>( &(_vars["UseSpawnHelper"]) )->default_value("true"),
+        "Spawn the url copy processes from a small helper process forked at startup, instead of forking the server"
+    )
+    (
+        "UrlCopyWorkers",
+        po::value<std::string>( &(_vars["UrlCopyWorkers"]) )->default_value("false"),
+        "Keep the url copy processes running after their transfer, to run more transfers of the same VO and credentials"
+    )
+    (
+        "UrlCopyWorkerMaxTransfers",
+        po::value<std::string>( &(_vars["UrlCopyWorkerMaxTransfers"]) )->default_value("100"),
+        "Transfers run by an url copy worker before it exits"
+    )
+    (
+        "UrlCopyWorkerMaxRss",
+        po::value<std::string>( &(_vars["UrlCopyWorkerMaxRss"]) )->default_value("512"),
+        "Resident memory, in MB, above which an url copy worker exits after its transfer"
+    )
+    (
+        "UrlCopyWorkerIdleTimeout",
+        po::value<std::string>( &(_vars["UrlCopyWorkerIdleTimeout"]) )->default_value("30"),
+        "Seconds an url copy worker waits for its next transfer before exiting"
+    )
     (
         "CancelUnusedMultihopFiles",
         po::value<std::string>( &(_vars["CancelUnusedMultihopFiles"]) )->default_value("false"),
@@ -641,6 +771,7 @@ void ServerConfigReader::storeValuesAsStrings ()
     storeAsString("OptimizerIncreaseStep");
     storeAsString("OptimizerAggressiveIncreaseStep");
     storeAsString("OptimizerDecreaseStep");
+    storeAsString<double>("LinkCircuitBreakerFailureRatio");
 }
 
 void ServerConfigReader::storeRoles ()
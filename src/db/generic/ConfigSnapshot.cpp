@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConfigSnapshot.h"
+
+
+const ConfigSnapshot::StorageEntry *ConfigSnapshot::findStorage(const std::string &storage) const
+{
+    auto i = storages.find(storage);
+    if (i == storages.end()) {
+        return NULL;
+    }
+    return &i->second;
+}
+
+
+// Same precedence as "WHERE vo_name IN (:vo, '*') OR vo_name IS NULL ORDER BY vo_name DESC LIMIT 1"
+const ConfigSnapshot::ServerEntry *ConfigSnapshot::findServerConfig(const std::string &voName) const
+{
+    auto i = serverConfigs.find(voName);
+    if (i != serverConfigs.end()) {
+        return &i->second;
+    }
+    i = serverConfigs.find("*");
+    if (i != serverConfigs.end()) {
+        return &i->second;
+    }
+    if (nullVoServerConfig) {
+        return &(*nullVoServerConfig);
+    }
+    return NULL;
+}
+
+
+StorageConfig ConfigSnapshot::getStorageConfig(const std::string &storage) const
+{
+    StorageConfig seConfig;
+
+    const StorageEntry *entry = findStorage(storage);
+    if (entry) {
+        seConfig = entry->config;
+    }
+    const StorageEntry *star = findStorage("*");
+    if (star) {
+        seConfig.merge(star->config);
+    }
+    return seConfig;
+}
+
+
+unsigned ConfigSnapshot::getDebugLevel(const std::string &source, const std::string &destination) const
+{
+    boost::optional<int> level;
+
+    const StorageEntry *entries[] = {findStorage(source), findStorage(destination)};
+    for (size_t i = 0; i < 2; ++i) {
+        if (entries[i] && entries[i]->debugLevel) {
+            if (!level || *level < *entries[i]->debugLevel) {
+                level = entries[i]->debugLevel;
+            }
+        }
+    }
+    if (level) {
+        return static_cast<unsigned>(*level);
+    }
+
+    const StorageEntry *star = findStorage("*");
+    if (star && star->debugLevel) {
+        return static_cast<unsigned>(*star->debugLevel);
+    }
+    return 0;
+}
+
+
+/// Both defined must agree, if only one is defined it decides, if none fallback to '*'
+static boost::tribool combineProtocolFlags(boost::tribool srcEnabled, boost::tribool dstEnabled,
+    boost::tribool starEnabled)
+{
+    if (boost::indeterminate(srcEnabled) && boost::indeterminate(dstEnabled)) {
+        return starEnabled;
+    }
+    else if (boost::indeterminate(srcEnabled)) {
+        return dstEnabled;
+    } else if (boost::indeterminate(dstEnabled)) {
+        return srcEnabled;
+    }
+    return srcEnabled && dstEnabled;
+}
+
+
+boost::tribool ConfigSnapshot::isProtocolUDT(const std::string &source, const std::string &destination) const
+{
+    const StorageEntry *src = findStorage(source);
+    const StorageEntry *dst = findStorage(destination);
+    const StorageEntry *star = findStorage("*");
+
+    return combineProtocolFlags(
+        src ? src->config.udt : boost::indeterminate,
+        dst ? dst->config.udt : boost::indeterminate,
+        star ? star->config.udt : boost::indeterminate);
+}
+
+
+boost::tribool ConfigSnapshot::isProtocolIPv6(const std::string &source, const std::string &destination) const
+{
+    const StorageEntry *src = findStorage(source);
+    const StorageEntry *dst = findStorage(destination);
+    const StorageEntry *star = findStorage("*");
+
+    return combineProtocolFlags(
+        src ? src->config.ipv6 : boost::indeterminate,
+        dst ? dst->config.ipv6 : boost::indeterminate,
+        star ? star->config.ipv6 : boost::indeterminate);
+}
+
+
+boost::tribool ConfigSnapshot::getSkipEvictionFlag(const std::string &source) const
+{
+    const StorageEntry *src = findStorage(source);
+    if (!src || boost::indeterminate(src->skipEviction)) {
+        return false;
+    }
+    return src->skipEviction;
+}
+
+
+CopyMode ConfigSnapshot::getCopyMode(const std::string &source, const std::string &destination) const
+{
+    auto tpcSupport = [this](const std::string &storage) -> std::string {
+        const StorageEntry *entry = findStorage(storage);
+        // If configuration is not found, or not recognized, assume that storages have full support for TPC
+        if (!entry) {
+            return "FULL";
+        }
+        const std::string &mode = entry->tpcSupport;
+        if (mode != "FULL" && mode != "PULL" && mode != "PUSH" && mode != "NONE") {
+            return "FULL";
+        }
+        return mode;
+    };
+
+    std::string srcTpcSupport = tpcSupport(source);
+    std::string dstTpcSupport = tpcSupport(destination);
+
+    bool srcCanPush = (srcTpcSupport == "FULL" || srcTpcSupport == "PUSH");
+    if (dstTpcSupport == "FULL" || dstTpcSupport == "PULL") {
+        return srcCanPush ? CopyMode::ANY : CopyMode::PULL;
+    }
+    return srcCanPush ? CopyMode::PUSH : CopyMode::STREAMING;
+}
+
+
+int ConfigSnapshot::getStreamsOptimization(const std::string &source, const std::string &destination) const
+{
+    const LinkKey candidates[] = {
+        LinkKey(source, destination), LinkKey(source, "*"), LinkKey("*", destination), LinkKey("*", "*")
+    };
+    for (size_t i = 0; i < 4; ++i) {
+        auto link = links.find(candidates[i]);
+        if (link != links.end() && link->second.nostreams) {
+            return *link->second.nostreams;
+        }
+    }
+
+    auto optimizer = optimizerStreams.find(candidates[0]);
+    if (optimizer != optimizerStreams.end()) {
+        return optimizer->second;
+    }
+    return 0;
+}
+
+
+bool ConfigSnapshot::getDisableDelegationFlag(const std::string &source, const std::string &destination) const
+{
+    const LinkKey candidates[] = {
+        LinkKey(source, destination), LinkKey(source, "*"), LinkKey("*", destination), LinkKey("*", "*")
+    };
+    for (size_t i = 0; i < 4; ++i) {
+        auto link = links.find(candidates[i]);
+        if (link != links.end() && link->second.noDelegation) {
+            return *link->second.noDelegation == "on";
+        }
+    }
+    return false;
+}
+
+
+std::string ConfigSnapshot::getThirdPartyTURL(const std::string &source, const std::string &destination) const
+{
+    const LinkKey candidates[] = {
+        LinkKey(source, destination), LinkKey(source, "*"), LinkKey("*", destination)
+    };
+    for (size_t i = 0; i < 3; ++i) {
+        auto link = links.find(candidates[i]);
+        if (link != links.end() && link->second.thirdPartyTurl) {
+            return *link->second.thirdPartyTurl;
+        }
+    }
+    return std::string();
+}
+
+
+int ConfigSnapshot::getGlobalTimeout(const std::string &voName) const
+{
+    const ServerEntry *entry = findServerConfig(voName);
+    return entry ? entry->globalTimeout : 0;
+}
+
+
+int ConfigSnapshot::getSecPerMb(const std::string &voName) const
+{
+    const ServerEntry *entry = findServerConfig(voName);
+    return entry ? entry->secPerMb : 0;
+}
+
+
+bool ConfigSnapshot::getDisableStreamingFlag(const std::string &voName) const
+{
+    const ServerEntry *entry = findServerConfig(voName);
+    return entry && entry->noStreaming && *entry->noStreaming == "on";
+}
+
+
+bool ConfigSnapshot::publishUserDn(const std::string &voName) const
+{
+    // No fallback to '*' here, same as the database query
+    auto i = serverConfigs.find(voName);
+    return i != serverConfigs.end() && i->second.showUserDn && *i->second.showUserDn == "on";
+}
+
+
+boost::optional<int> ConfigSnapshot::getRetry(const std::string &jobId) const
+{
+    auto job = jobs.find(jobId);
+    if (job == jobs.end()) {
+        return boost::none;
+    }
+
+    int nRetries = job->second.retry ? *job->second.retry : 0;
+    if (nRetries == 0) {
+        const ServerEntry *entry = findServerConfig(job->second.voName);
+        nRetries = entry ? entry->retry : 0;
+    }
+    else if (nRetries < 0) {
+        nRetries = -1;
+    }
+
+    // do not retry multiple replica jobs
+    if (nRetries > 0 &&
+        (job->second.jobType == Job::kTypeMultipleReplica || job->second.jobType == Job::kTypeMultiHop)) {
+        nRetries = 0;
+    }
+    return nRetries;
+}
+
+
+boost::optional<int> ConfigSnapshot::getRetryTimes(uint64_t fileId) const
+{
+    auto file = fileRetries.find(fileId);
+    if (file == fileRetries.end()) {
+        return boost::none;
+    }
+    return file->second;
+}
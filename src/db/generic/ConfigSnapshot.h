@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef CONFIGSNAPSHOT_H_
+#define CONFIGSNAPSHOT_H_
+
+#include <map>
+#include <string>
+#include <boost/logic/tribool.hpp>
+#include <boost/optional.hpp>
+
+#include "Job.h"
+#include "StorageConfig.h"
+#include "TransferFile.h"
+
+/// Copy of the storage, link and server configuration, taken once per scheduling cycle.
+/// The lookups follow the same precedence rules as their GenericDbIfce counterparts,
+/// but are resolved in memory, so the executors do not need to go to the database.
+class ConfigSnapshot
+{
+public:
+    /// Entry of t_se
+    struct StorageEntry {
+        StorageEntry(): skipEviction(boost::indeterminate) {}
+
+        StorageConfig config;
+        boost::optional<int> debugLevel;
+        boost::tribool skipEviction;
+        std::string tpcSupport;
+    };
+
+    /// Entry of t_link_config
+    struct LinkEntry {
+        boost::optional<int> nostreams;
+        boost::optional<std::string> noDelegation;
+        boost::optional<std::string> thirdPartyTurl;
+    };
+
+    /// Entry of t_server_config
+    struct ServerEntry {
+        ServerEntry(): retry(0), globalTimeout(0), secPerMb(0) {}
+
+        int retry;
+        int globalTimeout;
+        int secPerMb;
+        boost::optional<std::string> noStreaming;
+        boost::optional<std::string> showUserDn;
+    };
+
+    /// Retry configuration of a job, from t_job
+    struct JobEntry {
+        JobEntry(): jobType(Job::kTypeRegular) {}
+
+        boost::optional<int> retry;
+        std::string voName;
+        Job::JobType jobType;
+    };
+
+    typedef std::pair<std::string, std::string> LinkKey;
+
+    std::map<std::string, StorageEntry> storages;
+    std::map<LinkKey, LinkEntry> links;
+    std::map<LinkKey, int> optimizerStreams;
+    std::map<std::string, ServerEntry> serverConfigs;
+    boost::optional<ServerEntry> nullVoServerConfig;
+    std::map<std::string, JobEntry> jobs;
+    std::map<uint64_t, int> fileRetries;
+
+    /// See GenericDbIfce::getStorageConfig
+    StorageConfig getStorageConfig(const std::string &storage) const;
+
+    /// See GenericDbIfce::getDebugLevel
+    unsigned getDebugLevel(const std::string &source, const std::string &destination) const;
+
+    /// See GenericDbIfce::isProtocolUDT
+    boost::tribool isProtocolUDT(const std::string &source, const std::string &destination) const;
+
+    /// See GenericDbIfce::isProtocolIPv6
+    boost::tribool isProtocolIPv6(const std::string &source, const std::string &destination) const;
+
+    /// See GenericDbIfce::getSkipEvictionFlag
+    boost::tribool getSkipEvictionFlag(const std::string &source) const;
+
+    /// See GenericDbIfce::getCopyMode
+    CopyMode getCopyMode(const std::string &source, const std::string &destination) const;
+
+    /// See GenericDbIfce::getStreamsOptimization
+    int getStreamsOptimization(const std::string &source, const std::string &destination) const;
+
+    /// See GenericDbIfce::getDisableDelegationFlag
+    bool getDisableDelegationFlag(const std::string &source, const std::string &destination) const;
+
+    /// See GenericDbIfce::getThirdPartyTURL
+    std::string getThirdPartyTURL(const std::string &source, const std::string &destination) const;
+
+    /// See GenericDbIfce::getGlobalTimeout
+    int getGlobalTimeout(const std::string &voName) const;
+
+    /// See GenericDbIfce::getSecPerMb
+    int getSecPerMb(const std::string &voName) const;
+
+    /// See GenericDbIfce::getDisableStreamingFlag
+    bool getDisableStreamingFlag(const std::string &voName) const;
+
+    /// See GenericDbIfce::publishUserDn
+    bool publishUserDn(const std::string &voName) const;
+
+    /// See GenericDbIfce::getRetry
+    /// @return boost::none if the job was not part of the snapshot
+    boost::optional<int> getRetry(const std::string &jobId) const;
+
+    /// See GenericDbIfce::getRetryTimes
+    /// @return boost::none if the file was not part of the snapshot
+    boost::optional<int> getRetryTimes(uint64_t fileId) const;
+
+private:
+    const StorageEntry *findStorage(const std::string &storage) const;
+    const ServerEntry *findServerConfig(const std::string &voName) const;
+};
+
+#endif // CONFIGSNAPSHOT_H_
@@ -24,6 +24,7 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <queue>
 #include <set>
 #include <string>
@@ -36,6 +37,7 @@
 #include "StorageConfig.h"
 #include "ShareConfig.h"
 #include "CloudStorageAuth.h"
+#include "ConfigSnapshot.h"
 #include "TransferState.h"
 
 #include <boost/tuple/tuple.hpp>
@@ -45,6 +47,7 @@
 #include "Job.h"
 #include "MinFileStatus.h"
 #include "StagingOperation.h"
+#include "TerminalTransition.h"
 #include "ArchivingOperation.h"
 #include "QosTransitionOperation.h"
 #include "TransferFile.h"
@@ -103,6 +106,14 @@ public:
     virtual void getReadyTransfers(const std::vector<QueueId>& queues,
             std::map< std::string, std::list<TransferFile>>& files) = 0;
 
+    /// Get a list of transfers ready to go for the given queues
+    /// Same semantics as getReadyTransfers, but all queues are resolved together
+    /// with a bounded number of queries, instead of a set of queries per queue
+    /// @param queues       Queues for which to check (see getQueuesWithPending)
+    /// @param[out] files   A map where the key is the VO. The value is a list of transfers belonging to that VO
+    virtual void getReadyTransfersBulk(const std::vector<QueueId>& queues,
+            std::map< std::string, std::list<TransferFile>>& files) = 0;
+
     /// Update the status of a transfer
     /// @param jobId            The job ID
     /// @param fileId           The file ID
@@ -128,6 +139,25 @@ public:
     /// @note                   If jobId is empty, the pid will be used to decide which job to update
     virtual bool updateJobStatus(const std::string& jobId, const std::string& jobState) = 0;
 
+    /// Apply the file and job state changes of a set of status messages inside a single transaction.
+    /// Messages are applied in order, and each job state is evaluated once per requested state,
+    /// after all the file transitions of the batch
+    /// @param messages         Status messages, as received from fts_url_copy
+    /// @return                 One entry per message, in the same order, see updateTransferStatus
+    /// @note                   Either all the changes are committed, or none
+    virtual std::vector<boost::tuple<bool, std::string> > updateTransferStatusBatch(
+        const std::vector<fts3::events::Message>& messages) = 0;
+
+    /// Force a set of transfers into FAILED or CANCELED, and update their jobs accordingly,
+    /// inside a single transaction
+    /// @param transitions      The transfers to terminate
+    /// @param[out] states      State of the transfers that were changed, as left by the transaction,
+    ///                         so the state monitoring messages can be sent without querying again
+    /// @return                 One entry per transition, in the same order, see updateTransferStatus
+    /// @note                   Either all the changes are committed, or none
+    virtual std::vector<boost::tuple<bool, std::string> > terminateTransfers(
+        const std::vector<TerminalTransition>& transitions, std::vector<TransferState>& states) = 0;
+
     /// Get the credentials associated with the given delegation ID and user
     /// @param delegationId     Delegation ID. See insertCredentialCache
     /// @param userDn           The user's DN
@@ -195,6 +225,9 @@ public:
     /// Get the list of VO share configurations for the given link
     virtual std::vector<ShareConfig> getShareConfig(const std::string &source, const std::string &destination) = 0;
 
+    /// Get the VO share configurations of all the links at once, by source and destination
+    virtual std::map<std::pair<std::string, std::string>, std::vector<ShareConfig>> getShareConfigs() = 0;
+
     /// Returns how many retries there is configured for the given jobId
     virtual int getRetry(const std::string & jobId) = 0;
 
@@ -256,8 +289,9 @@ public:
     /// Update the state of a transfer inside a session reuse job
     virtual unsigned int updateFileStatusReuse(const TransferFile &file, const std::string &status) = 0;
 
-    /// Puts into requestIDs, jobs that have been cancelled, and for which the running fts_url_copy must be killed
-    virtual void getCancelJob(std::vector<int>& requestIDs) = 0;
+    /// Puts into requestIDs the pid and file id of the transfers that have been cancelled,
+    /// and for which the running fts_url_copy must be killed
+    virtual void getCancelJob(std::vector<std::pair<int, uint64_t>>& requestIDs) = 0;
 
     /// Returns list of transfers that need to be force started
     virtual std::list<TransferFile> getForceStartTransfers() = 0;
@@ -382,6 +416,12 @@ public:
 
     /// Get the configuration for a given storage
     virtual StorageConfig getStorageConfig(const std::string &storage) = 0;
+
+    /// Take a snapshot of the storage, link and server configuration, together with the retry
+    /// configuration of the given transfers, so they can be scheduled without further configuration queries
+    /// @param files    Transfers about to be scheduled, as returned by getReadyTransfers
+    virtual std::shared_ptr<const ConfigSnapshot> getConfigSnapshot(
+        const std::map< std::string, std::list<TransferFile>>& files) = 0;
 };
 
 #endif // GENERICDBIFCE_H_
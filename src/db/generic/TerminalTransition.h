@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TERMINALTRANSITION_H_
+#define TERMINALTRANSITION_H_
+
+#include <stdint.h>
+#include <string>
+
+
+/// A transfer to be forced into a terminal state by the server itself
+/// (stalled, timed out, or assigned to a dead host)
+struct TerminalTransition {
+    TerminalTransition(const std::string& jobId, uint64_t fileId, const std::string& state,
+        const std::string& reason, int processId = 0) :
+        jobId(jobId), fileId(fileId), state(state), reason(reason), processId(processId)
+    {
+    }
+
+    std::string jobId;
+    uint64_t fileId;
+    std::string state;  ///< FAILED or CANCELED
+    std::string reason;
+    int processId;
+};
+
+
+#endif //TERMINALTRANSITION_H_
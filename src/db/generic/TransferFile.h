@@ -97,10 +97,6 @@ public:
     {
     }
 
-    ~TransferFile()
-    {
-    }
-
     uint64_t fileId;
     int fileIndex;
     std::string jobId;
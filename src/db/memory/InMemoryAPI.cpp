@@ -0,0 +1,1180 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "common/Exceptions.h"
+#include "common/Logger.h"
+#include "db/generic/DbUtils.h"
+#include "InMemoryAPI.h"
+
+using namespace fts3::common;
+using namespace db;
+
+
+static bool isFinalFileState(const std::string &state)
+{
+    return state == "FINISHED" || state == "FAILED" || state == "CANCELED";
+}
+
+
+/// Optimizer view over the in-memory state
+class InMemoryAPI::OptimizerDataSource: public fts3::optimizer::OptimizerDataSource
+{
+public:
+    OptimizerDataSource(InMemoryAPI &db): db(db) {}
+
+    std::list<Pair> getActivePairs(void)
+    {
+        boost::mutex::scoped_lock lock(db.mutex);
+        std::set<LinkKey> links;
+        for (auto i = db.pending.begin(); i != db.pending.end(); ++i) {
+            links.insert(LinkKey(i->first.source, i->first.destination));
+        }
+        for (auto i = db.activePerLink.begin(); i != db.activePerLink.end(); ++i) {
+            if (i->second > 0) {
+                links.insert(i->first);
+            }
+        }
+        std::list<Pair> pairs;
+        for (auto i = links.begin(); i != links.end(); ++i) {
+            pairs.emplace_back(i->first, i->second);
+        }
+        return pairs;
+    }
+
+    OptimizerMode getOptimizerMode(const std::string &source, const std::string &dest)
+    {
+        boost::mutex::scoped_lock lock(db.mutex);
+        auto i = db.linkConfigs.find(LinkKey(source, dest));
+        if (i == db.linkConfigs.end()) {
+            return kOptimizerNormal;
+        }
+        return i->second.optimizerMode;
+    }
+
+    void getPairLimits(const Pair &pair, fts3::optimizer::Range *range, fts3::optimizer::StorageLimits *limits)
+    {
+        boost::mutex::scoped_lock lock(db.mutex);
+
+        auto source = db.storageConfigs.find(pair.source);
+        if (source != db.storageConfigs.end()) {
+            limits->source = source->second.outboundMaxActive;
+            limits->throughputSource = source->second.outboundMaxThroughput;
+        }
+        auto destination = db.storageConfigs.find(pair.destination);
+        if (destination != db.storageConfigs.end()) {
+            limits->destination = destination->second.inboundMaxActive;
+            limits->throughputDestination = destination->second.inboundMaxThroughput;
+        }
+
+        auto link = db.linkConfigs.find(LinkKey(pair.source, pair.destination));
+        if (link != db.linkConfigs.end()) {
+            range->min = link->second.minActive;
+            range->max = link->second.maxActive;
+            range->specific = true;
+        }
+    }
+
+    int getOptimizerValue(const Pair &pair)
+    {
+        boost::mutex::scoped_lock lock(db.mutex);
+        auto i = db.optimizerDecisions.find(LinkKey(pair.source, pair.destination));
+        return i == db.optimizerDecisions.end() ? 0 : i->second;
+    }
+
+    // There is no transfer history, so there is no throughput or success rate to report
+
+    void getThroughputInfo(const Pair &, const boost::posix_time::time_duration &,
+        double *throughput, double *filesizeAvg, double *filesizeStdDev)
+    {
+        *throughput = *filesizeAvg = *filesizeStdDev = 0;
+    }
+
+    time_t getAverageDuration(const Pair &, const boost::posix_time::time_duration &)
+    {
+        return 0;
+    }
+
+    double getSuccessRateForPair(const Pair &, const boost::posix_time::time_duration &, int *retryCount)
+    {
+        *retryCount = 0;
+        return 100;
+    }
+
+    int getActive(const Pair &pair)
+    {
+        boost::mutex::scoped_lock lock(db.mutex);
+        auto i = db.activePerLink.find(LinkKey(pair.source, pair.destination));
+        return i == db.activePerLink.end() ? 0 : i->second;
+    }
+
+    int getSubmitted(const Pair &pair)
+    {
+        boost::mutex::scoped_lock lock(db.mutex);
+        size_t submitted = 0;
+        for (auto i = db.pending.begin(); i != db.pending.end(); ++i) {
+            if (i->first.source == pair.source && i->first.destination == pair.destination) {
+                submitted += i->second.size();
+            }
+        }
+        return static_cast<int>(submitted);
+    }
+
+    double getThroughputAsSource(const std::string &)
+    {
+        return 0;
+    }
+
+    double getThroughputAsDestination(const std::string &)
+    {
+        return 0;
+    }
+
+    void storeOptimizerDecision(const Pair &pair, int activeDecision,
+        const fts3::optimizer::PairState &, int, const std::string &)
+    {
+        db.setOptimizerDecision(pair.source, pair.destination, activeDecision);
+    }
+
+    void storeOptimizerStreams(const Pair &pair, int streams)
+    {
+        boost::mutex::scoped_lock lock(db.mutex);
+        db.optimizerStreams[LinkKey(pair.source, pair.destination)] = streams;
+    }
+
+private:
+    InMemoryAPI &db;
+};
+
+
+InMemoryAPI::Seed InMemoryAPI::Seed::parse(const std::string &spec)
+{
+    Seed seed;
+    std::vector<std::string> entries;
+    boost::split(entries, spec, boost::is_any_of(";"), boost::token_compress_on);
+
+    try {
+        for (auto i = entries.begin(); i != entries.end(); ++i) {
+            std::string entry = boost::trim_copy(*i);
+            if (entry.empty()) {
+                continue;
+            }
+
+            size_t eq = entry.find('=');
+            if (eq == std::string::npos) {
+                throw UserError("Expected key=value, got " + entry);
+            }
+            std::string key = boost::trim_copy(entry.substr(0, eq));
+            std::string value = boost::trim_copy(entry.substr(eq + 1));
+
+            if (key == "jobs") {
+                seed.jobs = boost::lexical_cast<unsigned>(value);
+            }
+            else if (key == "files") {
+                seed.filesPerJob = boost::lexical_cast<unsigned>(value);
+            }
+            else if (key == "sources") {
+                seed.sources = std::max(1u, boost::lexical_cast<unsigned>(value));
+            }
+            else if (key == "destinations") {
+                seed.destinations = std::max(1u, boost::lexical_cast<unsigned>(value));
+            }
+            else if (key == "vos") {
+                seed.vos = std::max(1u, boost::lexical_cast<unsigned>(value));
+            }
+            else if (key == "shares") {
+                seed.shares = boost::lexical_cast<int>(value) != 0;
+            }
+            else if (key == "maxActive") {
+                seed.maxActive = boost::lexical_cast<int>(value);
+            }
+            else if (key == "priorities") {
+                seed.priorities = std::max(1, boost::lexical_cast<int>(value));
+            }
+            else {
+                throw UserError("Unknown key " + key);
+            }
+        }
+    }
+    catch (const boost::bad_lexical_cast &e) {
+        throw UserError(std::string(__func__) + ": Caught exception " + e.what());
+    }
+    return seed;
+}
+
+
+InMemoryAPI::InMemoryAPI(): nextFileId(1), nextJobId(1)
+{
+    char chname[255] = {0};
+    gethostname(chname, sizeof(chname));
+    hostname.assign(chname);
+
+    optimizerDataSource.reset(new OptimizerDataSource(*this));
+}
+
+
+InMemoryAPI::~InMemoryAPI()
+{
+}
+
+
+void InMemoryAPI::init(const std::string&, const std::string&, const std::string& connectString, int)
+{
+    try {
+        seed(Seed::parse(connectString));
+    }
+    catch (std::exception& e) {
+        throw UserError(std::string(__func__) + ": Caught exception " + e.what());
+    }
+    catch (...) {
+        throw UserError(std::string(__func__) + ": Caught exception ");
+    }
+}
+
+
+std::string InMemoryAPI::addJob(Job job, std::list<TransferFile> jobFiles)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return addJobLocked(job, jobFiles);
+}
+
+
+std::string InMemoryAPI::addJobLocked(Job &job, std::list<TransferFile> &jobFiles)
+{
+    if (job.jobId.empty()) {
+        std::ostringstream id;
+        id << "00000000-0000-0000-0000-" << std::setw(12) << std::setfill('0') << nextJobId++;
+        job.jobId = id.str();
+    }
+    if (job.jobState.empty()) {
+        job.jobState = "SUBMITTED";
+    }
+
+    int fileIndex = 0;
+    for (auto i = jobFiles.begin(); i != jobFiles.end(); ++i) {
+        FileEntry entry;
+        entry.file = *i;
+        entry.file.jobId = job.jobId;
+        entry.file.voName = job.voName;
+        entry.file.userDn = job.userDn;
+        entry.file.credId = job.credId;
+        entry.file.jobType = job.jobType;
+        entry.file.fileIndex = fileIndex++;
+        if (entry.file.fileId == 0) {
+            entry.file.fileId = nextFileId++;
+        }
+        else {
+            nextFileId = std::max(nextFileId, entry.file.fileId + 1);
+        }
+        entry.priority = job.priority;
+        entry.retry = 0;
+
+        std::string state = entry.file.fileState.empty() ? "SUBMITTED" : entry.file.fileState;
+        entry.file.fileState.clear();
+
+        FileEntry &stored = files[entry.file.fileId] = entry;
+        setFileState(stored, state);
+    }
+
+    jobs[job.jobId] = job;
+    return job.jobId;
+}
+
+
+void InMemoryAPI::seed(const Seed &seed)
+{
+    boost::mutex::scoped_lock lock(mutex);
+
+    std::vector<LinkKey> links;
+    for (unsigned s = 0; s < seed.sources; ++s) {
+        for (unsigned d = 0; d < seed.destinations; ++d) {
+            links.emplace_back("mock://source" + std::to_string(s),
+                "mock://destination" + std::to_string(d));
+        }
+    }
+
+    for (auto link = links.begin(); link != links.end(); ++link) {
+        if (seed.maxActive > 0) {
+            optimizerDecisions[*link] = seed.maxActive;
+        }
+        if (seed.shares) {
+            std::vector<ShareConfig> &shares = shareConfigs[*link];
+            for (unsigned vo = 0; vo < seed.vos; ++vo) {
+                ShareConfig share;
+                share.source = link->first;
+                share.destination = link->second;
+                share.vo = "vo" + std::to_string(vo);
+                share.weight = 1;
+                shares.push_back(share);
+            }
+        }
+    }
+
+    for (unsigned j = 0; j < seed.jobs; ++j) {
+        const LinkKey &link = links[j % links.size()];
+
+        Job job;
+        // Change VO once all the links got a job, so every link sees every VO
+        job.voName = "vo" + std::to_string((j / links.size()) % seed.vos);
+        job.userDn = "/DC=ch/DC=cern/CN=Synthetic User";
+        job.credId = "synthetic";
+        job.priority = 1 + (j % seed.priorities);
+        job.jobType = Job::kTypeRegular;
+        job.submitTime = time(NULL);
+        job.submitHost = hostname;
+
+        std::list<TransferFile> jobFiles;
+        for (unsigned f = 0; f < seed.filesPerJob; ++f) {
+            std::string path = "/synthetic/" + std::to_string(j) + "/" + std::to_string(f);
+            TransferFile file;
+            file.sourceSe = link.first;
+            file.destSe = link.second;
+            file.sourceSurl = link.first + path;
+            file.destSurl = link.second + path;
+            file.userFilesize = 1024 * 1024;
+            jobFiles.push_back(file);
+        }
+        addJobLocked(job, jobFiles);
+    }
+}
+
+
+void InMemoryAPI::setLinkConfig(const LinkConfig &config)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    linkConfigs[LinkKey(config.source, config.destination)] = config;
+}
+
+
+void InMemoryAPI::setShareConfig(const ShareConfig &config)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    std::vector<ShareConfig> &shares = shareConfigs[LinkKey(config.source, config.destination)];
+    for (auto i = shares.begin(); i != shares.end(); ++i) {
+        if (i->vo == config.vo) {
+            *i = config;
+            return;
+        }
+    }
+    shares.push_back(config);
+}
+
+
+void InMemoryAPI::setStorageConfig(const StorageConfig &config)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    storageConfigs[config.storage] = config;
+}
+
+
+void InMemoryAPI::setOptimizerDecision(const std::string &source, const std::string &destination, int active)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    optimizerDecisions[LinkKey(source, destination)] = active;
+}
+
+
+size_t InMemoryAPI::countFiles(const std::string &state)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    size_t count = 0;
+    for (auto i = files.begin(); i != files.end(); ++i) {
+        if (i->second.file.fileState == state) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+
+/// Change the state of a file keeping the pending queues and the active counters in sync
+void InMemoryAPI::setFileState(FileEntry &entry, const std::string &state)
+{
+    TransferFile &file = entry.file;
+    QueueKey queue = {file.sourceSe, file.destSe, file.voName};
+    LinkKey link(file.sourceSe, file.destSe);
+
+    if (file.fileState == "SUBMITTED") {
+        auto i = pending.find(queue);
+        if (i != pending.end()) {
+            i->second.erase(PendingKey(entry.priority, file.fileId));
+            if (i->second.empty()) {
+                pending.erase(i);
+            }
+        }
+    }
+    else if (file.fileState == "ACTIVE") {
+        --activePerLink[link];
+        --activePerQueue[queue];
+    }
+
+    file.fileState = state;
+
+    if (state == "SUBMITTED") {
+        pending[queue].insert(PendingKey(entry.priority, file.fileId));
+    }
+    else if (state == "ACTIVE") {
+        ++activePerLink[link];
+        ++activePerQueue[queue];
+    }
+}
+
+
+std::list<fts3::events::MessageUpdater> InMemoryAPI::getActiveInHost(const std::string &host)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    std::list<fts3::events::MessageUpdater> result;
+
+    if (host != hostname) {
+        return result;
+    }
+
+    for (auto i = files.begin(); i != files.end(); ++i) {
+        const TransferFile &file = i->second.file;
+        if (file.fileState == "ACTIVE" && file.pid > 0) {
+            fts3::events::MessageUpdater msg;
+            msg.set_job_id(file.jobId);
+            msg.set_file_id(file.fileId);
+            msg.set_process_id(file.pid);
+            msg.set_timestamp(millisecondsSinceEpoch());
+            result.push_back(msg);
+        }
+    }
+    return result;
+}
+
+
+void InMemoryAPI::getReadySessionReuseTransfers(const std::vector<QueueId>&,
+    std::map< std::string, std::queue< std::pair<std::string, std::list<TransferFile>>>>&)
+{
+    // Session reuse jobs are not modelled
+}
+
+
+void InMemoryAPI::getReadyTransfersLocked(const QueueId &queue,
+    std::map< std::string, std::list<TransferFile>>& result)
+{
+    auto pendingQueue = pending.find(QueueKey{queue.sourceSe, queue.destSe, queue.voName});
+    if (pendingQueue == pending.end()) {
+        return;
+    }
+
+    LinkKey link(queue.sourceSe, queue.destSe);
+    int filesNum = 10;
+
+    // How many can we run
+    auto decision = optimizerDecisions.find(link);
+    if (decision != optimizerDecisions.end() && decision->second > 0) {
+        filesNum = decision->second - activePerLink[link];
+        if (filesNum <= 0) {
+            return;
+        }
+    }
+
+    // Only the highest priority waiting for this queue, ordered by file id
+    const int maxPriority = pendingQueue->second.begin()->first;
+    for (auto i = pendingQueue->second.begin();
+         i != pendingQueue->second.end() && i->first == maxPriority && filesNum > 0;
+         ++i, --filesNum) {
+        const TransferFile &file = files[i->second].file;
+        result[file.voName].push_back(file);
+    }
+}
+
+
+void InMemoryAPI::getReadyTransfers(const std::vector<QueueId>& queues,
+    std::map< std::string, std::list<TransferFile>>& result)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    for (auto i = queues.begin(); i != queues.end(); ++i) {
+        getReadyTransfersLocked(*i, result);
+    }
+}
+
+
+void InMemoryAPI::getReadyTransfersBulk(const std::vector<QueueId>& queues,
+    std::map< std::string, std::list<TransferFile>>& result)
+{
+    // There is no round trip to save here
+    getReadyTransfers(queues, result);
+}
+
+
+InMemoryAPI::FileEntry *InMemoryAPI::findFile(const std::string &jobId, uint64_t fileId, int processId)
+{
+    if (jobId.empty() || fileId == 0) {
+        for (auto i = files.begin(); i != files.end(); ++i) {
+            if (i->second.file.pid == processId && i->second.file.fileState == "ACTIVE") {
+                return &i->second;
+            }
+        }
+        return NULL;
+    }
+
+    auto i = files.find(fileId);
+    if (i == files.end()) {
+        return NULL;
+    }
+    return &i->second;
+}
+
+
+boost::tuple<bool, std::string> InMemoryAPI::updateTransferStatusLocked(std::string jobId, uint64_t fileId,
+    const std::string &transferState, const std::string &errorReason, int processId, double filesize)
+{
+    FileEntry *entry = findFile(jobId, fileId, processId);
+    if (!entry) {
+        return boost::tuple<bool, std::string>(false, "");
+    }
+
+    const std::string storedState = entry->file.fileState;
+
+    // Same transitions as the MySQL backend
+    if (isFinalFileState(storedState)) {
+        return boost::tuple<bool, std::string>(false, storedState);
+    }
+    if (storedState == "ACTIVE" && transferState == "READY") {
+        return boost::tuple<bool, std::string>(false, storedState);
+    }
+    if (storedState == transferState && !(transferState == "READY" && processId != 0)) {
+        return boost::tuple<bool, std::string>(false, storedState);
+    }
+
+    setFileState(*entry, transferState);
+    entry->file.reason = errorReason;
+    entry->file.pid = processId;
+    if (transferState == "FINISHED") {
+        entry->file.filesize = filesize;
+    }
+    if (isFinalFileState(transferState)) {
+        entry->file.finishTime = time(NULL);
+    }
+    return boost::tuple<bool, std::string>(true, storedState);
+}
+
+
+boost::tuple<bool, std::string> InMemoryAPI::updateTransferStatus(const std::string& jobId, uint64_t fileId,
+    double, const std::string& transferState, const std::string& errorReason,
+    int processId, double filesize, double, bool, std::string)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return updateTransferStatusLocked(jobId, fileId, transferState, errorReason, processId, filesize);
+}
+
+
+bool InMemoryAPI::updateJobStatus(const std::string& jobId, const std::string& jobState)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return updateJobStatusLocked(jobId, jobState);
+}
+
+
+bool InMemoryAPI::updateJobStatusLocked(const std::string& jobId, const std::string& jobState)
+{
+    auto job = jobs.find(jobId);
+    if (job == jobs.end()) {
+        return false;
+    }
+
+    if (jobState == "ACTIVE") {
+        if (job->second.jobState == "SUBMITTED") {
+            job->second.jobState = "ACTIVE";
+        }
+        return true;
+    }
+
+    // The job is terminal only once all its files are
+    size_t total = 0, finished = 0, failed = 0, canceled = 0;
+    for (auto i = files.begin(); i != files.end(); ++i) {
+        const TransferFile &file = i->second.file;
+        if (file.jobId != jobId) {
+            continue;
+        }
+        ++total;
+        if (file.fileState == "FINISHED") {
+            ++finished;
+        }
+        else if (file.fileState == "FAILED") {
+            ++failed;
+        }
+        else if (file.fileState == "CANCELED") {
+            ++canceled;
+        }
+    }
+
+    if (finished + failed + canceled < total) {
+        return true;
+    }
+    if (finished == total) {
+        job->second.jobState = "FINISHED";
+    }
+    else if (canceled == total) {
+        job->second.jobState = "CANCELED";
+    }
+    else if (finished > 0) {
+        job->second.jobState = "FINISHEDDIRTY";
+    }
+    else {
+        job->second.jobState = "FAILED";
+    }
+    job->second.jobFinished = time(NULL);
+    return true;
+}
+
+
+std::vector<boost::tuple<bool, std::string> > InMemoryAPI::updateTransferStatusBatch(
+    const std::vector<fts3::events::Message>& messages)
+{
+    std::vector<boost::tuple<bool, std::string> > results;
+    results.reserve(messages.size());
+
+    boost::mutex::scoped_lock lock(mutex);
+    for (auto msg = messages.begin(); msg != messages.end(); ++msg) {
+        results.push_back(updateTransferStatusLocked(msg->job_id(), msg->file_id(),
+            msg->transfer_status(), msg->transfer_message(), msg->process_id(), msg->filesize()));
+    }
+    return results;
+}
+
+
+std::vector<boost::tuple<bool, std::string> > InMemoryAPI::terminateTransfers(
+    const std::vector<TerminalTransition>& transitions, std::vector<TransferState>& states)
+{
+    std::vector<boost::tuple<bool, std::string> > results;
+    results.reserve(transitions.size());
+
+    for (auto i = transitions.begin(); i != transitions.end(); ++i) {
+        if (i->state != "FAILED" && i->state != "CANCELED") {
+            throw UserError(std::string(__func__) + ": Not a terminal state " + i->state);
+        }
+    }
+
+    boost::mutex::scoped_lock lock(mutex);
+    for (auto i = transitions.begin(); i != transitions.end(); ++i) {
+        results.push_back(updateTransferStatusLocked(i->jobId, i->fileId, i->state, i->reason, i->processId, 0));
+    }
+    // Once per job, over the files as left by the batch
+    std::set<std::pair<std::string, std::string> > applied;
+    for (auto i = transitions.begin(); i != transitions.end(); ++i) {
+        if (applied.insert(std::make_pair(i->jobId, i->state)).second) {
+            updateJobStatusLocked(i->jobId, i->state);
+        }
+    }
+
+    for (size_t i = 0; i < transitions.size(); ++i) {
+        if (!results[i].get<0>()) {
+            continue;
+        }
+        auto file = files.find(transitions[i].fileId);
+        auto job = jobs.find(transitions[i].jobId);
+        if (file != files.end() && job != jobs.end()) {
+            states.push_back(getStateOfFileLocked(job->second, file->second));
+        }
+    }
+    return results;
+}
+
+
+boost::optional<UserCredential> InMemoryAPI::findCredential(const std::string&, const std::string&)
+{
+    return boost::optional<UserCredential>();
+}
+
+
+bool InMemoryAPI::isCredentialExpired(const std::string&, const std::string&)
+{
+    // There are no stored credentials
+    return true;
+}
+
+
+unsigned InMemoryAPI::getDebugLevel(const std::string& sourceStorage, const std::string& destStorage)
+{
+    return getConfigSnapshot({})->getDebugLevel(sourceStorage, destStorage);
+}
+
+
+fts3::optimizer::OptimizerDataSource* InMemoryAPI::getOptimizerDataSource()
+{
+    return optimizerDataSource.get();
+}
+
+
+bool InMemoryAPI::isTrAllowed(const std::string& sourceStorage, const std::string& destStorage, int &)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    LinkKey link(sourceStorage, destStorage);
+
+    int maxActive = DEFAULT_MIN_ACTIVE;
+    auto decision = optimizerDecisions.find(link);
+    if (decision != optimizerDecisions.end()) {
+        maxActive = decision->second;
+    }
+    return activePerLink[link] < maxActive;
+}
+
+
+bool InMemoryAPI::terminateReuseProcess(const std::string&, int, const std::string&, bool)
+{
+    return true;
+}
+
+
+void InMemoryAPI::reapStalledTransfers(std::vector<TransferFile>&)
+{
+}
+
+
+void InMemoryAPI::setPidForJob(const std::string& jobId, int pid)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    for (auto i = files.begin(); i != files.end(); ++i) {
+        if (i->second.file.jobId == jobId) {
+            i->second.file.pid = pid;
+        }
+    }
+}
+
+
+void InMemoryAPI::backup(int, long, long* nJobs, long* nFiles, long* nDeletions)
+{
+    *nJobs = *nFiles = *nDeletions = 0;
+}
+
+
+void InMemoryAPI::forkFailed(const std::string& jobId)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    for (auto i = files.begin(); i != files.end(); ++i) {
+        if (i->second.file.jobId == jobId && !isFinalFileState(i->second.file.fileState)) {
+            setFileState(i->second, "FAILED");
+            i->second.file.reason = "Transfer failed to fork, check fts3server.log for more details";
+        }
+    }
+}
+
+
+std::unique_ptr<LinkConfig> InMemoryAPI::getLinkConfig(const std::string &source, const std::string &destination)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    auto i = linkConfigs.find(LinkKey(source, destination));
+    if (i == linkConfigs.end()) {
+        return std::unique_ptr<LinkConfig>();
+    }
+    return std::unique_ptr<LinkConfig>(new LinkConfig(i->second));
+}
+
+
+std::vector<ShareConfig> InMemoryAPI::getShareConfig(const std::string &source, const std::string &destination)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    auto i = shareConfigs.find(LinkKey(source, destination));
+    if (i == shareConfigs.end()) {
+        return std::vector<ShareConfig>();
+    }
+    return i->second;
+}
+
+
+std::map<std::pair<std::string, std::string>, std::vector<ShareConfig>> InMemoryAPI::getShareConfigs()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return shareConfigs;
+}
+
+
+int InMemoryAPI::getRetry(const std::string&)
+{
+    return 0;
+}
+
+
+int InMemoryAPI::getRetryTimes(const std::string&, uint64_t fileId)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    auto i = files.find(fileId);
+    return i == files.end() ? 0 : i->second.retry;
+}
+
+
+void InMemoryAPI::setToFailOldQueuedJobs(std::vector<std::string>&)
+{
+}
+
+
+void InMemoryAPI::updateProtocol(const std::vector<fts3::events::Message>& messages)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    for (auto msg = messages.begin(); msg != messages.end(); ++msg) {
+        auto i = files.find(msg->file_id());
+        if (i == files.end()) {
+            continue;
+        }
+        std::ostringstream params;
+        params << "nostreams:" << msg->nostreams() << ",timeout:" << msg->timeout()
+            << ",buffersize:" << msg->buffersize();
+        i->second.file.internalFileParams = params.str();
+    }
+}
+
+
+void InMemoryAPI::updateProtocol(const fts3::events::Message& message)
+{
+    updateProtocol(std::vector<fts3::events::Message>{message});
+}
+
+
+TransferState InMemoryAPI::getStateOfFileLocked(const Job& job, const FileEntry& entry)
+{
+    const TransferFile &file = entry.file;
+
+    TransferState state;
+    state.job_id = file.jobId;
+    state.job_state = job.jobState;
+    state.vo_name = file.voName;
+    state.user_dn = file.userDn;
+    state.file_id = file.fileId;
+    state.file_state = file.fileState;
+    state.source_se = file.sourceSe;
+    state.dest_se = file.destSe;
+    state.source_url = file.sourceSurl;
+    state.dest_url = file.destSurl;
+    state.user_filesize = file.userFilesize;
+    state.retry_counter = entry.retry;
+    state.reason = file.reason;
+    state.submit_time = job.submitTime * 1000;
+    state.timestamp = millisecondsSinceEpoch();
+    return state;
+}
+
+
+std::vector<TransferState> InMemoryAPI::getStateOfTransfer(const std::string& jobId, uint64_t fileId)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    std::vector<TransferState> result;
+
+    auto job = jobs.find(jobId);
+    if (job == jobs.end()) {
+        return result;
+    }
+
+    for (auto i = files.begin(); i != files.end(); ++i) {
+        const TransferFile &file = i->second.file;
+        if (file.jobId != jobId || (fileId != 0 && file.fileId != fileId)) {
+            continue;
+        }
+
+        result.push_back(getStateOfFileLocked(job->second, i->second));
+    }
+    return result;
+}
+
+
+void InMemoryAPI::checkSanityState()
+{
+}
+
+
+void InMemoryAPI::multihopSanitySate()
+{
+}
+
+
+void InMemoryAPI::setRetryTransfer(const std::string&, uint64_t fileId, int retryNo,
+    const std::string& reason, const std::string&, int)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    auto i = files.find(fileId);
+    if (i == files.end()) {
+        return;
+    }
+    i->second.retry = retryNo;
+    i->second.file.reason = reason;
+    i->second.file.pid = 0;
+    setFileState(i->second, "SUBMITTED");
+}
+
+
+void InMemoryAPI::updateFileTransferProgressVector(const std::vector<fts3::events::MessageUpdater>&)
+{
+}
+
+
+void InMemoryAPI::transferLogFileVector(std::map<int, fts3::events::MessageLog>&)
+{
+}
+
+
+unsigned int InMemoryAPI::updateFileStatusReuse(const TransferFile&, const std::string&)
+{
+    return 0;
+}
+
+
+void InMemoryAPI::getCancelJob(std::vector<std::pair<int, uint64_t>>&)
+{
+}
+
+
+std::list<TransferFile> InMemoryAPI::getForceStartTransfers()
+{
+    return std::list<TransferFile>();
+}
+
+
+bool InMemoryAPI::getDrain()
+{
+    return false;
+}
+
+
+boost::tribool InMemoryAPI::isProtocolUDT(const std::string &sourceSe, const std::string &destSe)
+{
+    return getConfigSnapshot({})->isProtocolUDT(sourceSe, destSe);
+}
+
+
+boost::tribool InMemoryAPI::isProtocolIPv6(const std::string &sourceSe, const std::string &destSe)
+{
+    return getConfigSnapshot({})->isProtocolIPv6(sourceSe, destSe);
+}
+
+
+boost::tribool InMemoryAPI::getSkipEvictionFlag(const std::string &source)
+{
+    return getConfigSnapshot({})->getSkipEvictionFlag(source);
+}
+
+
+CopyMode InMemoryAPI::getCopyMode(const std::string &source, const std::string &destination)
+{
+    return getConfigSnapshot({})->getCopyMode(source, destination);
+}
+
+
+int InMemoryAPI::getStreamsOptimization(const std::string &sourceSe, const std::string &destSe)
+{
+    return getConfigSnapshot({})->getStreamsOptimization(sourceSe, destSe);
+}
+
+
+bool InMemoryAPI::getDisableDelegationFlag(const std::string &sourceSe, const std::string &destSe)
+{
+    return getConfigSnapshot({})->getDisableDelegationFlag(sourceSe, destSe);
+}
+
+
+std::string InMemoryAPI::getThirdPartyTURL(const std::string &sourceSe, const std::string &destSe)
+{
+    return getConfigSnapshot({})->getThirdPartyTURL(sourceSe, destSe);
+}
+
+
+int InMemoryAPI::getGlobalTimeout(const std::string &voName)
+{
+    return getConfigSnapshot({})->getGlobalTimeout(voName);
+}
+
+
+int InMemoryAPI::getSecPerMb(const std::string &voName)
+{
+    return getConfigSnapshot({})->getSecPerMb(voName);
+}
+
+
+bool InMemoryAPI::getDisableStreamingFlag(const std::string &voName)
+{
+    return getConfigSnapshot({})->getDisableStreamingFlag(voName);
+}
+
+
+void InMemoryAPI::getQueuesWithPending(std::vector<QueueId>& queues)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    for (auto i = pending.begin(); i != pending.end(); ++i) {
+        auto active = activePerQueue.find(i->first);
+        queues.emplace_back(i->first.source, i->first.destination, i->first.vo,
+            active == activePerQueue.end() ? 0 : active->second);
+    }
+}
+
+
+void InMemoryAPI::getQueuesWithSessionReusePending(std::vector<QueueId>&)
+{
+    // Session reuse jobs are not modelled
+}
+
+
+// Deletions, staging, archiving and QoS transitions are not modelled
+
+void InMemoryAPI::updateDeletionsState(const std::vector<MinFileStatus>&)
+{
+}
+
+
+void InMemoryAPI::getFilesForDeletion(std::vector<DeleteOperation>&)
+{
+}
+
+
+void InMemoryAPI::requeueStartedDeletes()
+{
+}
+
+
+void InMemoryAPI::updateStagingState(const std::vector<MinFileStatus>&)
+{
+}
+
+
+void InMemoryAPI::updateArchivingState(const std::vector<MinFileStatus>&)
+{
+}
+
+
+void InMemoryAPI::setArchivingStartTime(
+    const std::map< std::string, std::map<std::string, std::vector<uint64_t> > >&)
+{
+}
+
+
+void InMemoryAPI::updateBringOnlineToken(
+    const std::map< std::string, std::map<std::string, std::vector<uint64_t> > >&, const std::string&)
+{
+}
+
+
+void InMemoryAPI::getFilesForStaging(std::vector<StagingOperation>&)
+{
+}
+
+
+void InMemoryAPI::getFilesForArchiving(std::vector<ArchivingOperation>&)
+{
+}
+
+
+void InMemoryAPI::getFilesForQosTransition(std::vector<QosTransitionOperation>&, const std::string&, bool)
+{
+}
+
+
+bool InMemoryAPI::updateFileStateToQosRequestSubmitted(const std::string&, uint64_t)
+{
+    return false;
+}
+
+
+void InMemoryAPI::updateFileStateToQosTerminal(const std::string&, uint64_t, const std::string&,
+    const std::string&)
+{
+}
+
+
+void InMemoryAPI::getAlreadyStartedStaging(std::vector<StagingOperation>&)
+{
+}
+
+
+void InMemoryAPI::getAlreadyStartedArchiving(std::vector<ArchivingOperation>&)
+{
+}
+
+
+void InMemoryAPI::getStagingFilesForCanceling(std::set< std::pair<std::string, std::string> >&)
+{
+}
+
+
+void InMemoryAPI::getArchivingFilesForCanceling(std::set< std::pair<std::string, std::string> >&)
+{
+}
+
+
+bool InMemoryAPI::getCloudStorageCredentials(const std::string&, const std::string&, const std::string&,
+    CloudStorageAuth&)
+{
+    return false;
+}
+
+
+bool InMemoryAPI::publishUserDn(const std::string &vo)
+{
+    return getConfigSnapshot({})->publishUserDn(vo);
+}
+
+
+StorageConfig InMemoryAPI::getStorageConfig(const std::string &storage)
+{
+    return getConfigSnapshot({})->getStorageConfig(storage);
+}
+
+
+std::shared_ptr<const ConfigSnapshot> InMemoryAPI::getConfigSnapshot(
+    const std::map< std::string, std::list<TransferFile>>& transfers)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    std::shared_ptr<ConfigSnapshot> snapshot(new ConfigSnapshot);
+
+    for (auto i = storageConfigs.begin(); i != storageConfigs.end(); ++i) {
+        ConfigSnapshot::StorageEntry &entry = snapshot->storages[i->first];
+        entry.config = i->second;
+        entry.debugLevel = i->second.debugLevel;
+    }
+    for (auto i = linkConfigs.begin(); i != linkConfigs.end(); ++i) {
+        if (i->second.numberOfStreams > 0) {
+            snapshot->links[i->first].nostreams = i->second.numberOfStreams;
+        }
+    }
+    snapshot->optimizerStreams.insert(optimizerStreams.begin(), optimizerStreams.end());
+
+    for (auto vo = transfers.begin(); vo != transfers.end(); ++vo) {
+        for (auto i = vo->second.begin(); i != vo->second.end(); ++i) {
+            auto job = jobs.find(i->jobId);
+            if (job != jobs.end() && snapshot->jobs.count(i->jobId) == 0) {
+                ConfigSnapshot::JobEntry &entry = snapshot->jobs[i->jobId];
+                entry.voName = job->second.voName;
+                entry.jobType = job->second.jobType;
+            }
+            auto file = files.find(i->fileId);
+            if (file != files.end()) {
+                snapshot->fileRetries[i->fileId] = file->second.retry;
+            }
+        }
+    }
+
+    return snapshot;
+}
+
+
+// the class factories
+
+extern "C" GenericDbIfce* create()
+{
+    return new InMemoryAPI;
+}
+
+extern "C" void destroy(GenericDbIfce* p)
+{
+    if (p)
+        delete p;
+}
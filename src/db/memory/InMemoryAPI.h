@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <tuple>
+#include <boost/thread/mutex.hpp>
+
+#include "db/generic/GenericDbIfce.h"
+
+
+/// Database backend kept entirely in memory, selected with DbType=memory.
+/// It models only what the transfer scheduling path needs: jobs, files, link and share
+/// configuration, storage limits and the optimizer decisions. It is meant to drive the
+/// scheduler with synthetic load, without a database server.
+///
+/// The connect string seeds the synthetic load, as a list of key=value separated by ';'
+///     jobs            Number of jobs (0)
+///     files           Files per job (1)
+///     sources         Number of source storages (1)
+///     destinations    Number of destination storages (1)
+///     vos             Number of VOs (1)
+/// Jobs are spread round-robin over the links, and then over the VOs
+///     shares          If 1, configure an equal share for every VO on every link (0)
+///     maxActive       If > 0, store an optimizer decision for every link (0)
+///     priorities      Job priorities are spread between 1 and this value (1)
+class InMemoryAPI : public GenericDbIfce
+{
+public:
+    /// Parameters of the synthetic load. See the class description
+    struct Seed {
+        unsigned jobs, filesPerJob, sources, destinations, vos;
+        bool shares;
+        int maxActive;
+        int priorities;
+
+        Seed(): jobs(0), filesPerJob(1), sources(1), destinations(1), vos(1),
+            shares(false), maxActive(0), priorities(1) {}
+
+        /// Parse the key=value list from the connect string
+        static Seed parse(const std::string &spec);
+    };
+
+    InMemoryAPI();
+    virtual ~InMemoryAPI();
+
+    /// Add a job with its files. Job and file ids are assigned if empty
+    /// @return The job id
+    std::string addJob(Job job, std::list<TransferFile> files);
+
+    /// Generate synthetic load
+    void seed(const Seed &seed);
+
+    void setLinkConfig(const LinkConfig &config);
+    void setShareConfig(const ShareConfig &config);
+    void setStorageConfig(const StorageConfig &config);
+
+    /// Equivalent to the active column of t_optimizer
+    void setOptimizerDecision(const std::string &source, const std::string &destination, int active);
+
+    /// @return Number of files in the given state
+    size_t countFiles(const std::string &state);
+
+    /// Seeds from connectString. username, password and the number of connections are ignored
+    virtual void init(const std::string& username, const std::string& password,
+        const std::string& connectString, int nPooledConnections);
+
+    virtual std::list<fts3::events::MessageUpdater> getActiveInHost(const std::string &host);
+
+    virtual void getReadySessionReuseTransfers(const std::vector<QueueId>& queues,
+        std::map< std::string, std::queue< std::pair<std::string, std::list<TransferFile>>>>& files);
+
+    virtual void getReadyTransfers(const std::vector<QueueId>& queues,
+        std::map< std::string, std::list<TransferFile>>& files);
+
+    virtual void getReadyTransfersBulk(const std::vector<QueueId>& queues,
+        std::map< std::string, std::list<TransferFile>>& files);
+
+    virtual boost::tuple<bool, std::string> updateTransferStatus(const std::string& jobId, uint64_t fileId,
+        double throughput, const std::string& transferState, const std::string& errorReason,
+        int processId, double filesize, double duration, bool retry, std::string fileMetadata = "");
+
+    virtual bool updateJobStatus(const std::string& jobId, const std::string& jobState);
+
+    virtual std::vector<boost::tuple<bool, std::string> > updateTransferStatusBatch(
+        const std::vector<fts3::events::Message>& messages);
+
+    virtual std::vector<boost::tuple<bool, std::string> > terminateTransfers(
+        const std::vector<TerminalTransition>& transitions, std::vector<TransferState>& states);
+
+    virtual boost::optional<UserCredential> findCredential(const std::string& delegationId,
+        const std::string& userDn);
+
+    virtual bool isCredentialExpired(const std::string& delegationId, const std::string &userDn);
+
+    virtual unsigned getDebugLevel(const std::string& sourceStorage, const std::string& destStorage);
+
+    virtual fts3::optimizer::OptimizerDataSource* getOptimizerDataSource();
+
+    virtual bool isTrAllowed(const std::string& sourceStorage, const std::string& destStorage,
+        int &currentActive);
+
+    virtual bool terminateReuseProcess(const std::string & jobId, int pid, const std::string & message,
+        bool force = false);
+
+    virtual void reapStalledTransfers(std::vector<TransferFile>& transfers);
+
+    virtual void setPidForJob(const std::string& jobId, int pid);
+
+    virtual void backup(int intervalDays, long bulkSize, long* nJobs, long* nFiles, long* nDeletions);
+
+    virtual void forkFailed(const std::string& jobId);
+
+    virtual std::unique_ptr<LinkConfig> getLinkConfig(const std::string &source, const std::string &destination);
+
+    virtual std::vector<ShareConfig> getShareConfig(const std::string &source, const std::string &destination);
+
+    virtual std::map<std::pair<std::string, std::string>, std::vector<ShareConfig>> getShareConfigs();
+
+    virtual int getRetry(const std::string & jobId);
+
+    virtual int getRetryTimes(const std::string & jobId, uint64_t fileId);
+
+    virtual void setToFailOldQueuedJobs(std::vector<std::string>& jobs);
+
+    virtual void updateProtocol(const std::vector<fts3::events::Message>& messages);
+
+    virtual void updateProtocol(const fts3::events::Message& message);
+
+    virtual std::vector<TransferState> getStateOfTransfer(const std::string& jobId, uint64_t fileId);
+
+    virtual void checkSanityState();
+
+    virtual void multihopSanitySate();
+
+    virtual void setRetryTransfer(const std::string& jobId, uint64_t fileId, int retryNo,
+        const std::string& reason, const std::string& logFile, int errcode);
+
+    virtual void updateFileTransferProgressVector(const std::vector<fts3::events::MessageUpdater> &messages);
+
+    virtual void transferLogFileVector(std::map<int, fts3::events::MessageLog>& messagesLog);
+
+    virtual unsigned int updateFileStatusReuse(const TransferFile &file, const std::string &status);
+
+    virtual void getCancelJob(std::vector<std::pair<int, uint64_t>>& requestIDs);
+
+    virtual std::list<TransferFile> getForceStartTransfers();
+
+    virtual bool getDrain();
+
+    virtual boost::tribool isProtocolUDT(const std::string &sourceSe, const std::string &destSe);
+
+    virtual boost::tribool isProtocolIPv6(const std::string &sourceSe, const std::string &destSe);
+
+    virtual boost::tribool getSkipEvictionFlag(const std::string &source);
+
+    virtual CopyMode getCopyMode(const std::string &source, const std::string &destination);
+
+    virtual int getStreamsOptimization(const std::string &sourceSe, const std::string &destSe);
+
+    virtual bool getDisableDelegationFlag(const std::string &sourceSe, const std::string &destSe);
+
+    virtual std::string getThirdPartyTURL(const std::string &sourceSe, const std::string &destSE);
+
+    virtual int getGlobalTimeout(const std::string &voName);
+
+    virtual int getSecPerMb(const std::string &voName);
+
+    virtual bool getDisableStreamingFlag(const std::string &voName);
+
+    virtual void getQueuesWithPending(std::vector<QueueId>& queues);
+
+    virtual void getQueuesWithSessionReusePending(std::vector<QueueId>& queues);
+
+    virtual void updateDeletionsState(const std::vector<MinFileStatus>& delOpsStatus);
+
+    virtual void getFilesForDeletion(std::vector<DeleteOperation>& delOps);
+
+    virtual void requeueStartedDeletes();
+
+    virtual void updateStagingState(const std::vector<MinFileStatus>& stagingOpStatus);
+
+    virtual void updateArchivingState(const std::vector<MinFileStatus>& archivingOpStatus);
+
+    virtual void setArchivingStartTime(
+        const std::map< std::string, std::map<std::string, std::vector<uint64_t> > > &jobs);
+
+    virtual void updateBringOnlineToken(
+        const std::map< std::string, std::map<std::string, std::vector<uint64_t> > > &jobs,
+        const std::string &token);
+
+    virtual void getFilesForStaging(std::vector<StagingOperation> &stagingOps);
+
+    virtual void getFilesForArchiving(std::vector<ArchivingOperation> &archivingOps);
+
+    virtual void getFilesForQosTransition(std::vector<QosTransitionOperation> &qosTranstionOps,
+        const std::string &qosOp, bool matchHost = false);
+
+    virtual bool updateFileStateToQosRequestSubmitted(const std::string& jobId, uint64_t fileId);
+
+    virtual void updateFileStateToQosTerminal(const std::string& jobId, uint64_t fileId,
+        const std::string& fileState, const std::string& reason = "");
+
+    virtual void getAlreadyStartedStaging(std::vector<StagingOperation> &stagingOps);
+
+    virtual void getAlreadyStartedArchiving(std::vector<ArchivingOperation> &archivingOps);
+
+    virtual void getStagingFilesForCanceling(std::set< std::pair<std::string, std::string> >& files);
+
+    virtual void getArchivingFilesForCanceling(std::set< std::pair<std::string, std::string> >& files);
+
+    virtual bool getCloudStorageCredentials(const std::string& userDn, const std::string& voName,
+        const std::string& cloudName, CloudStorageAuth& auth);
+
+    virtual bool publishUserDn(const std::string &vo);
+
+    virtual StorageConfig getStorageConfig(const std::string &storage);
+
+    virtual std::shared_ptr<const ConfigSnapshot> getConfigSnapshot(
+        const std::map< std::string, std::list<TransferFile>>& files);
+
+private:
+    class OptimizerDataSource;
+    friend class OptimizerDataSource;
+
+    typedef std::pair<std::string, std::string> LinkKey;
+
+    struct QueueKey {
+        std::string source, destination, vo;
+
+        bool operator < (const QueueKey &b) const {
+            return std::tie(source, destination, vo) < std::tie(b.source, b.destination, b.vo);
+        }
+    };
+
+    /// Priority and file id of a submitted file
+    typedef std::pair<int, uint64_t> PendingKey;
+
+    /// Highest priority first, then by file id, as getReadyTransfers picks them
+    struct PendingOrder {
+        bool operator () (const PendingKey &a, const PendingKey &b) const {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        }
+    };
+
+    struct FileEntry {
+        TransferFile file;
+        int priority;
+        int retry;
+    };
+
+    boost::mutex mutex;
+    std::string hostname;
+    uint64_t nextFileId;
+    uint64_t nextJobId;
+
+    std::map<std::string, Job> jobs;
+    std::map<uint64_t, FileEntry> files;
+    /// SUBMITTED files per queue. Empty queues are removed
+    std::map<QueueKey, std::set<PendingKey, PendingOrder>> pending;
+    /// ACTIVE files per link and per queue, as counted by getActiveCount in the MySQL backend
+    std::map<LinkKey, int> activePerLink;
+    std::map<QueueKey, int> activePerQueue;
+
+    std::map<LinkKey, LinkConfig> linkConfigs;
+    std::map<LinkKey, std::vector<ShareConfig>> shareConfigs;
+    std::map<std::string, StorageConfig> storageConfigs;
+    std::map<LinkKey, int> optimizerDecisions;
+    std::map<LinkKey, int> optimizerStreams;
+
+    std::unique_ptr<fts3::optimizer::OptimizerDataSource> optimizerDataSource;
+
+    std::string addJobLocked(Job &job, std::list<TransferFile> &files);
+    void setFileState(FileEntry &entry, const std::string &state);
+    void getReadyTransfersLocked(const QueueId &queue, std::map< std::string, std::list<TransferFile>>& files);
+    boost::tuple<bool, std::string> updateTransferStatusLocked(std::string jobId, uint64_t fileId,
+        const std::string &transferState, const std::string &errorReason, int processId, double filesize);
+    bool updateJobStatusLocked(const std::string& jobId, const std::string& jobState);
+    TransferState getStateOfFileLocked(const Job& job, const FileEntry& entry);
+    FileEntry *findFile(const std::string &jobId, uint64_t fileId, int processId);
+};
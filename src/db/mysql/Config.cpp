@@ -29,6 +29,41 @@
 using namespace fts3::common;
 
 
+std::map<std::string, double> MySqlAPI::parseActivityShareConf(std::string activity_share_str)
+{
+    std::map<std::string, double> ret;
+
+    if (activity_share_str.empty()) return ret;
+
+    // remove the opening '[' and closing ']'
+    activity_share_str = activity_share_str.substr(1, activity_share_str.size() - 2);
+
+    // iterate over activity shares
+    boost::char_separator<char> sep(",");
+    boost::tokenizer< boost::char_separator<char> > tokens(activity_share_str, sep);
+    boost::tokenizer< boost::char_separator<char> >::iterator it;
+
+    static const boost::regex re("^\\s*\\{\\s*\"([ a-zA-Z0-9\\._-]+)\"\\s*:\\s*((0\\.)?\\d+)\\s*\\}\\s*$");
+    static const int ACTIVITY_NAME = 1;
+    static const int ACTIVITY_SHARE = 2;
+
+    for (it = tokens.begin(); it != tokens.end(); it++)
+    {
+        // parse single activity share
+        std::string str = *it;
+
+        boost::smatch what;
+        boost::regex_match(str, what, re, boost::match_extra);
+
+        std::string activity_name(what[ACTIVITY_NAME]);
+        boost::algorithm::to_lower(activity_name);
+        ret[activity_name] = boost::lexical_cast<double>(what[ACTIVITY_SHARE]);
+    }
+
+    return ret;
+}
+
+
 std::map<std::string, double> MySqlAPI::getActivityShareConf(soci::session& sql, std::string vo)
 {
 
@@ -48,32 +83,9 @@ std::map<std::string, double> MySqlAPI::getActivityShareConf(soci::session& sql,
             soci::into(activity_share_str, isNull)
             ;
 
-        if (isNull == soci::i_null || activity_share_str.empty()) return ret;
-
-        // remove the opening '[' and closing ']'
-        activity_share_str = activity_share_str.substr(1, activity_share_str.size() - 2);
+        if (isNull == soci::i_null) return ret;
 
-        // iterate over activity shares
-        boost::char_separator<char> sep(",");
-        boost::tokenizer< boost::char_separator<char> > tokens(activity_share_str, sep);
-        boost::tokenizer< boost::char_separator<char> >::iterator it;
-
-        static const boost::regex re("^\\s*\\{\\s*\"([ a-zA-Z0-9\\._-]+)\"\\s*:\\s*((0\\.)?\\d+)\\s*\\}\\s*$");
-        static const int ACTIVITY_NAME = 1;
-        static const int ACTIVITY_SHARE = 2;
-
-        for (it = tokens.begin(); it != tokens.end(); it++)
-        {
-            // parse single activity share
-            std::string str = *it;
-
-            boost::smatch what;
-            boost::regex_match(str, what, re, boost::match_extra);
-
-            std::string activity_name(what[ACTIVITY_NAME]);
-            boost::algorithm::to_lower(activity_name);
-            ret[activity_name] = boost::lexical_cast<double>(what[ACTIVITY_SHARE]);
-        }
+        ret = parseActivityShareConf(activity_share_str);
     }
     catch (std::exception& e)
     {
@@ -173,6 +185,32 @@ std::vector<ShareConfig> MySqlAPI::getShareConfig(const std::string &source, con
 }
 
 
+std::map<std::pair<std::string, std::string>, std::vector<ShareConfig>> MySqlAPI::getShareConfigs()
+{
+    soci::session sql(*connectionPool);
+
+    std::map<std::pair<std::string, std::string>, std::vector<ShareConfig>> cfg;
+    try
+    {
+        soci::rowset<ShareConfig> rs = (sql.prepare << "SELECT * FROM t_share_config");
+        for (soci::rowset<ShareConfig>::const_iterator i = rs.begin();
+             i != rs.end(); ++i)
+        {
+            cfg[std::make_pair(i->source, i->destination)].push_back(*i);
+        }
+    }
+    catch (std::exception& e)
+    {
+        throw UserError(std::string(__func__) + ": Caught exception " + e.what());
+    }
+    catch (...)
+    {
+        throw UserError(std::string(__func__) + ": Caught exception " );
+    }
+    return cfg;
+}
+
+
 int MySqlAPI::getRetry(const std::string & jobId)
 {
     soci::session sql(*connectionPool);
@@ -822,3 +860,159 @@ StorageConfig MySqlAPI::getStorageConfig(const std::string &storage)
 
     return seConfig;
 }
+
+
+// Upper bound of ids resolved by a single query when loading the retry configuration
+static const size_t SNAPSHOT_IDS_PER_QUERY = 500;
+
+
+std::shared_ptr<const ConfigSnapshot> MySqlAPI::getConfigSnapshot(
+    const std::map< std::string, std::list<TransferFile>>& files)
+{
+    soci::session sql(*connectionPool);
+    std::shared_ptr<ConfigSnapshot> snapshot(new ConfigSnapshot);
+
+    try
+    {
+        soci::rowset<soci::row> seRs = (sql.prepare <<
+            "SELECT storage, site, metadata, ipv6, udt, debug_level, "
+            "   inbound_max_active, outbound_max_active, inbound_max_throughput, outbound_max_throughput, "
+            "   skip_eviction, tpc_support "
+            "FROM t_se");
+        for (auto i = seRs.begin(); i != seRs.end(); ++i) {
+            ConfigSnapshot::StorageEntry entry;
+
+            entry.config.storage = i->get<std::string>("storage");
+            entry.config.site = i->get<std::string>("site", "");
+            entry.config.metadata = i->get<std::string>("metadata", "");
+            entry.config.ipv6 = i->get<boost::tribool>("ipv6", boost::indeterminate);
+            entry.config.udt = i->get<boost::tribool>("udt", boost::indeterminate);
+            entry.config.debugLevel = i->get<int>("debug_level", 0);
+            entry.config.inboundMaxActive = i->get<int>("inbound_max_active", 0);
+            entry.config.outboundMaxActive = i->get<int>("outbound_max_active", 0);
+            entry.config.inboundMaxThroughput = i->get<double>("inbound_max_throughput", 0.0);
+            entry.config.outboundMaxThroughput = i->get<double>("outbound_max_throughput", 0.0);
+
+            if (i->get_indicator("debug_level") != soci::i_null) {
+                entry.debugLevel = i->get<int>("debug_level");
+            }
+            if (i->get_indicator("skip_eviction") != soci::i_null) {
+                entry.skipEviction = (i->get<std::string>("skip_eviction") != "0");
+            }
+            entry.tpcSupport = i->get<std::string>("tpc_support", "");
+
+            snapshot->storages[entry.config.storage] = entry;
+        }
+
+        soci::rowset<soci::row> linkRs = (sql.prepare <<
+            "SELECT source_se, dest_se, nostreams, no_delegation, 3rd_party_turl FROM t_link_config");
+        for (auto i = linkRs.begin(); i != linkRs.end(); ++i) {
+            ConfigSnapshot::LinkEntry &entry = snapshot->links[ConfigSnapshot::LinkKey(
+                i->get<std::string>("source_se"), i->get<std::string>("dest_se"))];
+
+            if (i->get_indicator("nostreams") != soci::i_null) {
+                entry.nostreams = i->get<int>("nostreams");
+            }
+            if (i->get_indicator("no_delegation") != soci::i_null) {
+                entry.noDelegation = i->get<std::string>("no_delegation");
+            }
+            if (i->get_indicator("3rd_party_turl") != soci::i_null) {
+                entry.thirdPartyTurl = i->get<std::string>("3rd_party_turl");
+            }
+        }
+
+        soci::rowset<soci::row> optimizerRs = (sql.prepare <<
+            "SELECT source_se, dest_se, nostreams FROM t_optimizer WHERE nostreams IS NOT NULL");
+        for (auto i = optimizerRs.begin(); i != optimizerRs.end(); ++i) {
+            snapshot->optimizerStreams[ConfigSnapshot::LinkKey(
+                i->get<std::string>("source_se"), i->get<std::string>("dest_se"))] = i->get<int>("nostreams");
+        }
+
+        soci::rowset<soci::row> serverRs = (sql.prepare <<
+            "SELECT vo_name, retry, global_timeout, sec_per_mb, no_streaming, show_user_dn FROM t_server_config");
+        for (auto i = serverRs.begin(); i != serverRs.end(); ++i) {
+            ConfigSnapshot::ServerEntry entry;
+
+            entry.retry = i->get<int>("retry", 0);
+            entry.globalTimeout = i->get<int>("global_timeout", 0);
+            entry.secPerMb = i->get<int>("sec_per_mb", 0);
+            if (i->get_indicator("no_streaming") != soci::i_null) {
+                entry.noStreaming = i->get<std::string>("no_streaming");
+            }
+            if (i->get_indicator("show_user_dn") != soci::i_null) {
+                entry.showUserDn = i->get<std::string>("show_user_dn");
+            }
+
+            if (i->get_indicator("vo_name") == soci::i_null) {
+                snapshot->nullVoServerConfig = entry;
+            }
+            else {
+                // Keep the first match, as "LIMIT 1" would do
+                snapshot->serverConfigs.insert(std::make_pair(i->get<std::string>("vo_name"), entry));
+            }
+        }
+
+        // Retry configuration of the jobs and files about to be scheduled
+        std::set<std::string> jobIdSet;
+        std::vector<uint64_t> fileIds;
+        for (auto vo = files.begin(); vo != files.end(); ++vo) {
+            for (auto file = vo->second.begin(); file != vo->second.end(); ++file) {
+                jobIdSet.insert(file->jobId);
+                fileIds.push_back(file->fileId);
+            }
+        }
+
+        std::vector<std::string> jobIds(jobIdSet.begin(), jobIdSet.end());
+        for (size_t first = 0; first < jobIds.size(); first += SNAPSHOT_IDS_PER_QUERY) {
+            size_t last = std::min(first + SNAPSHOT_IDS_PER_QUERY, jobIds.size());
+
+            std::ostringstream query;
+            query << "SELECT job_id, retry, vo_name, job_type FROM t_job WHERE job_id IN (";
+            for (size_t i = first; i < last; ++i) {
+                query << (i > first ? ", " : "") << ":job_id" << i;
+            }
+            query << ")";
+
+            soci::details::prepare_temp_type prepared = (sql.prepare << query.str());
+            for (size_t i = first; i < last; ++i) {
+                prepared, soci::use(jobIds[i]);
+            }
+
+            soci::rowset<soci::row> jobRs(prepared);
+            for (auto i = jobRs.begin(); i != jobRs.end(); ++i) {
+                ConfigSnapshot::JobEntry &entry = snapshot->jobs[i->get<std::string>("job_id")];
+                if (i->get_indicator("retry") != soci::i_null) {
+                    entry.retry = i->get<int>("retry");
+                }
+                entry.voName = i->get<std::string>("vo_name", "");
+                entry.jobType = i->get<Job::JobType>("job_type", Job::kTypeRegular);
+            }
+        }
+
+        for (size_t first = 0; first < fileIds.size(); first += SNAPSHOT_IDS_PER_QUERY) {
+            size_t last = std::min(first + SNAPSHOT_IDS_PER_QUERY, fileIds.size());
+
+            std::ostringstream query;
+            query << "SELECT file_id, retry FROM t_file WHERE file_id IN (";
+            for (size_t i = first; i < last; ++i) {
+                query << (i > first ? ", " : "") << fileIds[i];
+            }
+            query << ")";
+
+            soci::rowset<soci::row> fileRs = (sql.prepare << query.str());
+            for (auto i = fileRs.begin(); i != fileRs.end(); ++i) {
+                snapshot->fileRetries[i->get<unsigned long long>("file_id")] = i->get<int>("retry", 0);
+            }
+        }
+    }
+    catch (std::exception& e)
+    {
+        throw UserError(std::string(__func__) + ": Caught exception " + e.what());
+    }
+    catch (...)
+    {
+        throw UserError(std::string(__func__) + ": Caught exception " );
+    }
+
+    return snapshot;
+}
@@ -24,6 +24,7 @@
 
 #include <map>
 #include <chrono>
+#include <tuple>
 #include <soci/mysql/soci-mysql.h>
 #include "MySqlAPI.h"
 #include "sociConversions.h"
@@ -135,7 +136,7 @@ static void getHostAndPort(const std::string& conn, std::string* host, int* port
 
 static void validateSchemaVersion(soci::connection_pool *connectionPool)
 {
-    static const unsigned expect[] = {8, 2};
+    static const unsigned expect[] = {8, 3};
     unsigned major, minor;
 
     soci::session sql(*connectionPool);
@@ -341,94 +342,111 @@ std::map<std::string, long long> MySqlAPI::getActivitiesInQueue(soci::session& s
 }
 
 
-//check if called by multiple threads
-
-std::map<std::string, int> MySqlAPI::getFilesNumPerActivity(soci::session& sql,
-        std::string src, std::string dst, std::string vo, int filesNum,
-        std::set<std::string> & defaultActivities)
+/// Split filesNum slots between the activities present in a queue, following the configured shares
+/// @param activityShares       Activity shares configured for the VO
+/// @param activitiesInQueue    How many files are queued per activity. Modified in place.
+/// @param filesNum             How many slots to distribute
+/// @param defaultActivities[out] Activities in the queue that fall back to the 'default' share
+static std::map<std::string, int> distributeFilesPerActivity(std::map<std::string, double> &activityShares,
+    std::map<std::string, long long> &activitiesInQueue, int filesNum,
+    std::set<std::string> &defaultActivities)
 {
     std::map<std::string, int> activityFilesNum;
 
-    try
+    // sum of all activity shares in the queue (needed for normalization)
+    double sum = 0.0;
+
+    std::map<std::string, long long>::iterator it;
+    for (it = activitiesInQueue.begin(); it != activitiesInQueue.end(); it++)
     {
-        // get activity shares configuration for given VO
-        std::map<std::string, double> activityShares = getActivityShareConf(sql, vo);
+        std::map<std::string, double>::iterator pos = activityShares.find(it->first);
+        if (pos != activityShares.end() && it->first != "default")
+        {
+            sum += pos->second;
+        }
+        else
+        {
+            // if the activity has not been defined it falls to default
+            defaultActivities.insert(it->first);
+        }
+    }
 
-        // if there is no configuration no assigment can be made
-        if (activityShares.empty()) return activityFilesNum;
+    // if default was used add it as well
+    if (!defaultActivities.empty())
+        sum += activityShares["default"];
 
-        // get the activities in the queue
-        std::map<std::string, long long> activitiesInQueue = getActivitiesInQueue(sql, src, dst, vo);
+    // assign slots to activities
+    for (int i = 0; i < filesNum; i++)
+    {
+        // if sum <= 0 there is nothing to assign
+        if (sum <= 0) break;
+        // a random number from (0, 1)
+        double r = ((double) thread_random() / (double)RAND_MAX);
 
-        // sum of all activity shares in the queue (needed for normalization)
-        double sum = 0.0;
+        FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << __func__ << ": Dice result: " << r << commit;
+
+        // interval corresponding to given activity
+        double interval = 0;
 
-        std::map<std::string, long long>::iterator it;
         for (it = activitiesInQueue.begin(); it != activitiesInQueue.end(); it++)
         {
-            std::map<std::string, double>::iterator pos = activityShares.find(it->first);
-            if (pos != activityShares.end() && it->first != "default")
-            {
-                sum += pos->second;
-            }
-            else
+            // if there are no more files for this activity continue
+            if (it->second <= 0) continue;
+            // get the activity name (if it was not defined use default)
+            std::string activity_name = defaultActivities.count(it->first) ? "default" : it->first;
+
+            // calculate the interval (normalize)
+            interval += activityShares[activity_name] / sum;
+
+            // if the slot has been assigned to the given activity ...
+
+            if (r < interval)
             {
-                // if the activity has not been defined it falls to default
-                defaultActivities.insert(it->first);
-            }
-        }
+                ++activityFilesNum[activity_name];
 
-        // if default was used add it as well
-        if (!defaultActivities.empty())
-            sum += activityShares["default"];
+                --it->second;
+                // if there are no more files for the given ativity remove it from the sum
+                if (it->second == 0)
+                {
+                    sum -= activityShares[activity_name];
+                }
+                break;
 
-        // assign slots to activities
-        for (int i = 0; i < filesNum; i++)
-        {
-            // if sum <= 0 there is nothing to assign
-            if (sum <= 0) break;
-            // a random number from (0, 1)
-            double r = ((double) thread_random() / (double)RAND_MAX);
+            }
+        }
+    }
 
-            FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << __func__ << ": Dice result: " << r << commit;
+    // Debug output
+    std::map<std::string, int>::const_iterator j;
+    for (j = activityFilesNum.begin(); j != activityFilesNum.end(); ++j)
+    {
+        FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << __func__ << ": " << j->first << " assigned " << j->second << commit;
+    }
 
-            // interval corresponding to given activity
-            double interval = 0;
+    return activityFilesNum;
+}
 
-            for (it = activitiesInQueue.begin(); it != activitiesInQueue.end(); it++)
-            {
-                // if there are no more files for this activity continue
-                if (it->second <= 0) continue;
-                // get the activity name (if it was not defined use default)
-                std::string activity_name = defaultActivities.count(it->first) ? "default" : it->first;
 
-                // calculate the interval (normalize)
-                interval += activityShares[activity_name] / sum;
+//check if called by multiple threads
 
-                // if the slot has been assigned to the given activity ...
+std::map<std::string, int> MySqlAPI::getFilesNumPerActivity(soci::session& sql,
+        std::string src, std::string dst, std::string vo, int filesNum,
+        std::set<std::string> & defaultActivities)
+{
+    std::map<std::string, int> activityFilesNum;
 
-                if (r < interval)
-                {
-                    ++activityFilesNum[activity_name];
+    try
+    {
+        // get activity shares configuration for given VO
+        std::map<std::string, double> activityShares = getActivityShareConf(sql, vo);
 
-                    --it->second;
-                    // if there are no more files for the given ativity remove it from the sum
-                    if (it->second == 0)
-                    {
-                        sum -= activityShares[activity_name];
-                    }
-                    break;
+        // if there is no configuration no assigment can be made
+        if (activityShares.empty()) return activityFilesNum;
 
-                }
-            }
-        }
+        // get the activities in the queue
+        std::map<std::string, long long> activitiesInQueue = getActivitiesInQueue(sql, src, dst, vo);
 
-        // Debug output
-        std::map<std::string, int>::const_iterator j;
-        for (j = activityFilesNum.begin(); j != activityFilesNum.end(); ++j)
-        {
-            FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << __func__ << ": " << j->first << " assigned " << j->second << commit;
-        }
+        activityFilesNum = distributeFilesPerActivity(activityShares, activitiesInQueue, filesNum, defaultActivities);
     }
     catch (std::exception& e)
     {
@@ -818,6 +836,361 @@ void MySqlAPI::getReadyTransfers(const std::vector<QueueId>& queues,
 }
 
 
+/// A (queue, activity) pair for which getReadyTransfersBulk picks candidates
+struct ReadyTransfersBucket
+{
+    ReadyTransfersBucket(const QueueId &queue, const std::string &activity, int maxPriority, int filesNum):
+        queue(queue), activity(activity), maxPriority(maxPriority), filesNum(filesNum)
+    {}
+
+    const QueueId &queue;
+    // Empty if the VO has no activity shares configured
+    std::string activity;
+    int maxPriority;
+    int filesNum;
+    std::list<TransferFile> files;
+};
+
+typedef std::pair<std::string, std::string> LinkKey;
+typedef std::tuple<std::string, std::string, std::string> QueueKey;
+
+// Upper bound of queue/activity buckets fetched by a single UNION statement
+static const size_t BULK_BUCKETS_PER_QUERY = 250;
+// Upper bound of job ids resolved by a single job metadata query
+static const size_t BULK_JOBS_PER_QUERY = 500;
+// Upper bound of files whose progress is written by a single UPDATE
+static const size_t BULK_PROGRESS_PER_QUERY = 500;
+
+
+/// Map the activity of a queued file to the bucket that would have picked it
+static std::string resolveActivityBucket(std::string activity, const std::map<std::string, double> &activityShares)
+{
+    boost::algorithm::to_lower(activity);
+    if (activity.empty() || activityShares.count(activity) == 0) {
+        return "default";
+    }
+    return activity;
+}
+
+
+void MySqlAPI::getReadyTransfersBulk(const std::vector<QueueId>& queues,
+        std::map<std::string, std::list<TransferFile> >& files)
+{
+    soci::session sql(*connectionPool);
+    time_t now = time(NULL);
+    int nQueries = 0;
+
+    try
+    {
+        // Running transfers per link
+        std::map<LinkKey, int> activeByLink;
+        soci::rowset<soci::row> activeRs = (sql.prepare <<
+            "SELECT source_se, dest_se, COUNT(*) AS active "
+            "FROM t_file "
+            "WHERE file_state = 'ACTIVE' "
+            "GROUP BY source_se, dest_se ORDER BY NULL");
+        ++nQueries;
+        for (auto i = activeRs.begin(); i != activeRs.end(); ++i) {
+            activeByLink[LinkKey(i->get<std::string>("source_se"), i->get<std::string>("dest_se"))] =
+                static_cast<int>(i->get<long long>("active"));
+        }
+
+        // Optimizer decision per link
+        std::map<LinkKey, int> maxActiveByLink;
+        soci::rowset<soci::row> optimizerRs = (sql.prepare <<
+            "SELECT source_se, dest_se, active FROM t_optimizer");
+        ++nQueries;
+        for (auto i = optimizerRs.begin(); i != optimizerRs.end(); ++i) {
+            if (i->get_indicator("active") != soci::i_null) {
+                maxActiveByLink[LinkKey(i->get<std::string>("source_se"), i->get<std::string>("dest_se"))] =
+                    i->get<int>("active");
+            }
+        }
+
+        // Highest priority waiting per queue
+        int fixedPriority = ServerConfig::instance().get<int> ("UseFixedJobPriority");
+        std::map<QueueKey, int> maxPriorityByQueue;
+        if (fixedPriority == 0) {
+            soci::rowset<soci::row> priorityRs = (sql.prepare <<
+                "SELECT vo_name, source_se, dest_se, MAX(priority) AS max_priority "
+                "FROM t_file "
+                "WHERE file_state = 'SUBMITTED' AND hashed_id BETWEEN :hStart AND :hEnd "
+                "GROUP BY vo_name, source_se, dest_se ORDER BY NULL",
+                soci::use(hashSegment.start), soci::use(hashSegment.end));
+            ++nQueries;
+            for (auto i = priorityRs.begin(); i != priorityRs.end(); ++i) {
+                if (i->get_indicator("max_priority") != soci::i_null) {
+                    maxPriorityByQueue[QueueKey(i->get<std::string>("source_se"), i->get<std::string>("dest_se"),
+                        i->get<std::string>("vo_name"))] = i->get<int>("max_priority");
+                }
+            }
+        }
+        else {
+            FTS3_COMMON_LOGGER_NEWLOG(WARNING) << __func__
+                << " Using fixed priority for Jobs."
+                << commit;
+        }
+
+        // Activity shares per VO
+        std::map<std::string, std::map<std::string, double>> activitySharesByVo;
+        soci::rowset<soci::row> sharesRs = (sql.prepare <<
+            "SELECT vo, activity_share FROM t_activity_share_config WHERE active = 'on'");
+        ++nQueries;
+        for (auto i = sharesRs.begin(); i != sharesRs.end(); ++i) {
+            if (i->get_indicator("activity_share") == soci::i_null) {
+                continue;
+            }
+            std::map<std::string, double> shares = parseActivityShareConf(i->get<std::string>("activity_share"));
+            if (!shares.empty()) {
+                activitySharesByVo[i->get<std::string>("vo")] = shares;
+            }
+        }
+
+        // Queued files per activity, only for VOs with activity shares
+        std::map<QueueKey, std::map<std::string, long long>> activitiesByQueue;
+        if (!activitySharesByVo.empty()) {
+            soci::rowset<soci::row> activitiesRs = (sql.prepare <<
+                " SELECT f.source_se, f.dest_se, f.vo_name, f.activity, "
+                "        COUNT(DISTINCT f.job_id, f.file_index) AS count "
+                " FROM t_file f "
+                "   INNER JOIN t_job j ON (f.job_id = j.job_id) "
+                "   INNER JOIN t_activity_share_config a ON (a.vo = f.vo_name AND a.active = 'on') "
+                " WHERE f.file_state = 'SUBMITTED' AND "
+                "   (f.hashed_id >= :hStart AND f.hashed_id <= :hEnd) AND "
+                "   (j.job_type = 'N' OR j.job_type = 'R' OR j.job_type IS NULL) "
+                " GROUP BY f.source_se, f.dest_se, f.vo_name, f.activity ORDER BY NULL",
+                soci::use(hashSegment.start), soci::use(hashSegment.end));
+            ++nQueries;
+            for (auto i = activitiesRs.begin(); i != activitiesRs.end(); ++i) {
+                std::string activityName = i->get<std::string>("activity", "");
+                boost::algorithm::to_lower(activityName);
+                if (activityName.empty()) {
+                    activityName = "default";
+                }
+                activitiesByQueue[QueueKey(i->get<std::string>("source_se"), i->get<std::string>("dest_se"),
+                    i->get<std::string>("vo_name"))][activityName] += i->get<long long>("count");
+            }
+        }
+
+        // Decide how many files to pick per queue and activity, with the same rules as getReadyTransfers
+        std::vector<ReadyTransfersBucket> buckets;
+        buckets.reserve(queues.size());
+
+        auto seed = std::chrono::system_clock::now().time_since_epoch().count();
+        auto random_engine = std::default_random_engine{seed};
+
+        for (auto it = queues.begin(); it != queues.end(); ++it)
+        {
+            LinkKey link(it->sourceSe, it->destSe);
+            QueueKey queueKey(it->sourceSe, it->destSe, it->voName);
+
+            int filesNum = 10;
+            auto maxActive = maxActiveByLink.find(link);
+            if (maxActive != maxActiveByLink.end() && maxActive->second > 0)
+            {
+                filesNum = maxActive->second - activeByLink[link];
+                if (filesNum <= 0) {
+                    continue;
+                }
+            }
+
+            int maxPriority = fixedPriority;
+            if (fixedPriority == 0) {
+                auto priority = maxPriorityByQueue.find(queueKey);
+                if (priority == maxPriorityByQueue.end()) {
+                    FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "NULL MAX(priority), skip entry" << commit;
+                    continue;
+                }
+                maxPriority = priority->second;
+            }
+
+            std::map<std::string, int> activityFilesNum;
+            std::set<std::string> defaultActivities;
+            auto activityShares = activitySharesByVo.find(it->voName);
+            if (activityShares != activitySharesByVo.end()) {
+                activityFilesNum = distributeFilesPerActivity(activityShares->second,
+                    activitiesByQueue[queueKey], filesNum, defaultActivities);
+            }
+
+            if (activityFilesNum.empty()) {
+                buckets.emplace_back(*it, "", maxPriority, filesNum);
+            }
+            else {
+                std::vector<std::pair<std::string, int>> vActivityFilesNum(activityFilesNum.begin(), activityFilesNum.end());
+                std::shuffle(vActivityFilesNum.begin(), vActivityFilesNum.end(), random_engine);
+
+                for (auto it_act = vActivityFilesNum.begin(); it_act != vActivityFilesNum.end(); ++it_act) {
+                    if (it_act->second > 0) {
+                        buckets.emplace_back(*it, it_act->first, maxPriority, it_act->second);
+                    }
+                }
+            }
+        }
+
+        struct tm tTime;
+        gmtime_r(&now, &tTime);
+
+        // Fetch the candidates for a set of buckets with a single UNION statement
+        std::set<std::string> multiReplicaOrHopJobs;
+        for (size_t first = 0; first < buckets.size(); first += BULK_BUCKETS_PER_QUERY)
+        {
+            size_t last = std::min(first + BULK_BUCKETS_PER_QUERY, buckets.size());
+            std::map<QueueKey, std::vector<ReadyTransfersBucket*>> bucketsByQueue;
+            std::ostringstream query;
+
+            for (size_t i = first; i < last; ++i) {
+                ReadyTransfersBucket &bucket = buckets[i];
+                bucketsByQueue[QueueKey(bucket.queue.sourceSe, bucket.queue.destSe, bucket.queue.voName)].push_back(&bucket);
+
+                if (i > first) {
+                    query << " UNION ALL ";
+                }
+                query << " (SELECT f.file_state, f.source_surl, f.dest_surl, f.job_id, j.vo_name, "
+                         "       f.file_id, j.overwrite_flag, j.archive_timeout, j.dst_file_report, "
+                         "       j.user_dn, j.cred_id, f.checksum, j.checksum_method, j.source_space_token, "
+                         "       j.space_token, j.copy_pin_lifetime, j.bring_online, "
+                         "       f.user_filesize, f.file_metadata, f.archive_metadata, j.job_metadata, "
+                         "       f.file_index, f.bringonline_token, f.scitag, "
+                         "       f.source_se, f.dest_se, f.selection_strategy, j.internal_job_params, j.job_type, "
+                         "       f.activity "
+                         " FROM t_file f USE INDEX(idx_link_state_vo), t_job j "
+                         " WHERE f.job_id = j.job_id AND f.file_state = 'SUBMITTED' AND "
+                         "     f.source_se = :source_se" << i << " AND f.dest_se = :dest_se" << i << " AND "
+                         "     f.vo_name = :vo_name" << i << " AND "
+                         "     (f.retry_timestamp IS NULL OR f.retry_timestamp < :tTime" << i << ") AND ";
+                if (bucket.activity.empty()) {
+                    query << "     j.job_type IN ('N', 'R', 'H') AND ";
+                }
+                else if (bucket.activity == "default") {
+                    // Activity names are validated by parseActivityShareConf, so they can be inlined
+                    query << "     j.job_type IN ('N', 'R') AND ";
+                    query << "     (f.activity IS NULL OR f.activity NOT IN ('default'";
+                    const std::map<std::string, double> &shares = activitySharesByVo[bucket.queue.voName];
+                    for (auto share = shares.begin(); share != shares.end(); ++share) {
+                        query << ", '" << share->first << "'";
+                    }
+                    query << ") OR f.activity = 'default') AND ";
+                }
+                else {
+                    query << "     j.job_type IN ('N', 'R') AND ";
+                    query << "     f.activity = :activity" << i << " AND ";
+                }
+                query << "     f.hashed_id BETWEEN :hStart" << i << " AND :hEnd" << i << " AND "
+                         "     j.priority = :maxPriority" << i <<
+                         " ORDER BY file_id ASC "
+                         " LIMIT :filesNum" << i << ")";
+            }
+
+            soci::details::prepare_temp_type prepared = (sql.prepare << query.str());
+            for (size_t i = first; i < last; ++i) {
+                ReadyTransfersBucket &bucket = buckets[i];
+                prepared, soci::use(bucket.queue.sourceSe), soci::use(bucket.queue.destSe),
+                    soci::use(bucket.queue.voName), soci::use(tTime);
+                if (!bucket.activity.empty() && bucket.activity != "default") {
+                    prepared, soci::use(bucket.activity);
+                }
+                prepared, soci::use(hashSegment.start), soci::use(hashSegment.end),
+                    soci::use(bucket.maxPriority), soci::use(bucket.filesNum);
+            }
+
+            soci::rowset<TransferFile> rs(prepared);
+            ++nQueries;
+
+            for (auto ti = rs.begin(); ti != rs.end(); ++ti)
+            {
+                TransferFile& tfile = *ti;
+
+                auto candidates = bucketsByQueue.find(QueueKey(tfile.sourceSe, tfile.destSe, tfile.voName));
+                if (candidates == bucketsByQueue.end()) {
+                    continue;
+                }
+
+                ReadyTransfersBucket *bucket = candidates->second.front();
+                if (!bucket->activity.empty()) {
+                    std::string activityName = resolveActivityBucket(tfile.activity,
+                        activitySharesByVo[bucket->queue.voName]);
+                    for (auto b = candidates->second.begin(); b != candidates->second.end(); ++b) {
+                        if ((*b)->activity == activityName) {
+                            bucket = *b;
+                            break;
+                        }
+                    }
+                }
+                tfile.activity = bucket->activity;
+
+                if (tfile.jobType == Job::kTypeMultipleReplica || tfile.jobType == Job::kTypeMultiHop) {
+                    multiReplicaOrHopJobs.insert(tfile.jobId);
+                }
+
+                bucket->files.push_back(tfile);
+            }
+        }
+
+        // Resolve last replica / last hop for all the jobs that need it
+        std::map<std::string, std::pair<bool, int>> jobInfo;
+        std::vector<std::string> jobIds(multiReplicaOrHopJobs.begin(), multiReplicaOrHopJobs.end());
+        for (size_t first = 0; first < jobIds.size(); first += BULK_JOBS_PER_QUERY)
+        {
+            size_t last = std::min(first + BULK_JOBS_PER_QUERY, jobIds.size());
+            std::ostringstream query;
+
+            query << "SELECT job_id, COUNT(*) AS total, "
+                     "  CAST(SUM(file_state <> 'NOT_USED') AS SIGNED) AS remain, "
+                     "  MAX(file_index) AS max_index "
+                     "FROM t_file WHERE job_id IN (";
+            for (size_t i = first; i < last; ++i) {
+                query << (i > first ? ", " : "") << ":job_id" << i;
+            }
+            query << ") GROUP BY job_id ORDER BY NULL";
+
+            soci::details::prepare_temp_type prepared = (sql.prepare << query.str());
+            for (size_t i = first; i < last; ++i) {
+                prepared, soci::use(jobIds[i]);
+            }
+
+            soci::rowset<soci::row> rs(prepared);
+            ++nQueries;
+
+            for (auto i = rs.begin(); i != rs.end(); ++i) {
+                jobInfo[i->get<std::string>("job_id")] = std::make_pair(
+                    i->get<long long>("total") == i->get<long long>("remain"),
+                    i->get<int>("max_index"));
+            }
+        }
+
+        for (auto bucket = buckets.begin(); bucket != buckets.end(); ++bucket)
+        {
+            for (auto ti = bucket->files.begin(); ti != bucket->files.end(); ++ti)
+            {
+                auto info = jobInfo.find(ti->jobId);
+                if (info != jobInfo.end()) {
+                    if (ti->jobType == Job::kTypeMultipleReplica) {
+                        ti->lastReplica = info->second.first ? 1 : 0;
+                    }
+                    if (ti->jobType == Job::kTypeMultiHop) {
+                        ti->lastHop = (info->second.second == ti->fileIndex) ? 1 : 0;
+                    }
+                }
+            }
+            files[bucket->queue.voName].splice(files[bucket->queue.voName].end(), bucket->files);
+        }
+
+        FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << __func__ << ": " << queues.size() << " queues resolved with "
+            << nQueries << " queries" << commit;
+    }
+    catch (std::exception& e)
+    {
+        files.clear();
+        throw UserError(std::string(__func__) + ": Caught exception " + e.what());
+    }
+    catch (...)
+    {
+        files.clear();
+        throw UserError(std::string(__func__) + ": Caught exception ");
+    }
+}
+
+
 /// Return how many free slots there are for the given pair
 /// @param visited Transfers not yet updated on the DB, but scheduled by the caller
 /// @param source_se Source storage
@@ -1208,6 +1581,151 @@ boost::tuple<bool, std::string>  MySqlAPI::updateTransferStatus(const std::strin
 }
 
 
+/// Transitions that must not be applied over the stored file state
+/// (terminal states, ACTIVE back to READY, or the same state twice)
+bool MySqlAPI::isFileStateTransitionAllowed(const std::string& storedState, const std::string& newFileState,
+        int processId)
+{
+    // If file is in terminal don't do anything
+    if (storedState == "FAILED" || storedState == "FINISHED" || storedState == "CANCELED") {
+        return false;
+    }
+
+    // If trying to go from ACTIVE back to READY, do nothing either
+    if (storedState == "ACTIVE" && newFileState == "READY") {
+        return false;
+    }
+
+    // If the file already in the same state, don't do anything either
+    // avoid 2 url-copy on the same file id to start ( condition processId==0)
+    if (storedState == newFileState) {
+        return newFileState == "READY" && processId != 0;
+    }
+
+    return true;
+}
+
+
+bool MySqlAPI::updateFileStateRow(soci::session& sql, const std::string& jobId, uint64_t fileId,
+        Job::JobType jobType, int archiveTimeout, const std::string& storedState, std::string& newFileState,
+        const std::string& transferMessage, int processId, double filesize, double duration, double throughput,
+        bool retry, const std::string& fileMetadata)
+{
+    time_t now = time(NULL);
+    struct tm tTime;
+    gmtime_r(&now, &tTime);
+
+    bool isStaging = (storedState == "STAGING");
+
+    soci::statement stmt(sql);
+    std::ostringstream query;
+
+    query << "UPDATE t_file SET "
+          "    file_state = :state, reason = :reason";
+    stmt.exchange(soci::use(newFileState, "state"));
+    stmt.exchange(soci::use(transferMessage, "reason"));
+
+    if (newFileState == "FINISHED" || newFileState == "FAILED" || newFileState == "CANCELED")
+    {
+        query << ", FINISH_TIME = :time1, DEST_SURL_UUID = NULL";
+        stmt.exchange(soci::use(tTime, "time1"));
+    }
+    if (newFileState == "ACTIVE" || newFileState == "READY")
+    {
+        query << ", START_TIME = :time1";
+        stmt.exchange(soci::use(tTime, "time1"));
+    }
+
+    query << ", transfer_Host = :hostname";
+    stmt.exchange(soci::use(hostname, "hostname"));
+
+    if (newFileState == "FINISHED")
+    {
+        query << ", transferred = :filesize";
+        stmt.exchange(soci::use(filesize, "filesize"));
+    }
+
+    if (newFileState == "FAILED" || newFileState == "CANCELED")
+    {
+        query << ", transferred = :transferred";
+        stmt.exchange(soci::use(0, "transferred"));
+    }
+
+    if (newFileState == "STAGING")
+    {
+        if (isStaging)
+        {
+            query << ", STAGING_FINISHED = :time1";
+            stmt.exchange(soci::use(tTime, "time1"));
+        }
+        else
+        {
+            query << ", STAGING_START = :time1";
+            stmt.exchange(soci::use(tTime, "time1"));
+        }
+    }
+
+    // Move the new state to ARCHIVING if the transfer completed and the archive timeout is set
+    if (newFileState == "FINISHED" && isArchivingTransfer(sql, jobId, jobType, archiveTimeout)) {
+        FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "Moving transfer " << jobId << " " << fileId
+                                         << " to ARCHIVING state" << commit;
+        newFileState = "ARCHIVING";
+    }
+
+    if (!fileMetadata.empty()) {
+        query << ", file_metadata = :file_metadata";
+        stmt.exchange(soci::use(fileMetadata, "file_metadata"));
+    }
+
+    query << "   , pid = :pid, filesize = :filesize, tx_duration = :duration, throughput = :throughput, current_failures = :current_failures "
+          "WHERE file_id = :fileId AND file_state = :oldState";
+    stmt.exchange(soci::use(processId, "pid"));
+    stmt.exchange(soci::use(filesize, "filesize"));
+    stmt.exchange(soci::use(duration, "duration"));
+    stmt.exchange(soci::use(throughput, "throughput"));
+    stmt.exchange(soci::use(static_cast<int>(retry), "current_failures"));
+    stmt.exchange(soci::use(fileId, "fileId"));
+    stmt.exchange(soci::use(storedState, "oldState"));
+    stmt.alloc();
+    stmt.prepare(query.str());
+    stmt.define_and_bind();
+
+    stmt.execute(true);
+
+    return get_affected_rows(sql) > 0;
+}
+
+
+void MySqlAPI::updateFileStateFollowUp(soci::session& sql, const std::string& jobId, uint64_t fileId,
+        Job::JobType jobType, const std::string& jobState, const std::string& newFileState,
+        const std::string& destSurlUuid, soci::indicator destSurlUuidInd)
+{
+    switch (jobType) {
+        // Multiple replica job, on failure, need to pick next option
+        case Job::kTypeMultipleReplica:
+            if ((jobState != "CANCELED" && jobState != "FAILED") &&
+                (newFileState == "FAILED" || newFileState == "CANCELED")) {
+                useFileReplica(sql, jobId, fileId, destSurlUuid, destSurlUuidInd);
+            }
+            break;
+        // For multihop jobs, on success enable next option
+        case Job::kTypeMultiHop:
+            if ((jobState != "CANCELED" && jobState != "FAILED") &&
+                (newFileState == "FINISHED")) {
+                useNextHop(sql, jobId);
+            }
+            else {
+                // need to remove all dest_surl_uuid from all jobs
+                setNullDestSURLMultiHop(sql, jobId);
+            }
+            break;
+        // Nothing special for other type of jobs
+        default:
+            break;
+    }
+}
+
+
 boost::tuple<bool, std::string>  MySqlAPI::updateFileTransferStatusInternal(soci::session& sql, double throughput,
         std::string jobId, uint64_t fileId,
         std::string newFileState, std::string transferMessage,
@@ -1227,10 +1745,6 @@ boost::tuple<bool, std::string>  MySqlAPI::updateFileTransferStatusInternal(soci
         int archiveTimeout = -1;
         Job::JobType jobType;
 
-        time_t now = time(NULL);
-        struct tm tTime;
-        gmtime_r(&now, &tTime);
-
         if(jobId.empty() || fileId == 0) {
             sql << "SELECT job_id, file_id FROM t_file WHERE pid=:pid AND file_state = 'ACTIVE' LIMIT 1 ",
                 soci::use(processId), soci::into(jobId), soci::into(fileId);
@@ -1251,161 +1765,180 @@ boost::tuple<bool, std::string>  MySqlAPI::updateFileTransferStatusInternal(soci
             archiveTimeout = std::atoi(archiveTimeoutStr.c_str());
         }
 
-        bool isStaging = (storedState == "STAGING");
-
-        // If file is in terminal don't do anything, just return
-        if(storedState == "FAILED" || storedState == "FINISHED" || storedState == "CANCELED" )
-        {
+        if (!isFileStateTransitionAllowed(storedState, newFileState, processId)) {
             sql.rollback();
             return boost::tuple<bool, std::string>(false, storedState);
         }
 
-        // If trying to go from ACTIVE back to READY, do nothing either
-        if (storedState == "ACTIVE" && newFileState == "READY") {
+        if (!updateFileStateRow(sql, jobId, fileId, jobType, archiveTimeout, storedState, newFileState,
+                transferMessage, processId, filesize, duration, throughput, retry, fileMetadata)) {
             sql.rollback();
             return boost::tuple<bool, std::string>(false, storedState);
         }
 
-        // If the file already in the same state, don't do anything either
-        // avoid 2 url-copy on the same file id to start ( condition processId==0)
-        if (storedState == newFileState) {
-            if (newFileState == "READY" && processId != 0) {}
-            else {
-                sql.rollback();
-                return boost::tuple<bool, std::string>(false, storedState);
-            }
-        }
+        sql.commit();
 
-        soci::statement stmt(sql);
-        std::ostringstream query;
+        sql.begin();
+        updateFileStateFollowUp(sql, jobId, fileId, jobType, jobState, newFileState, destSurlUuid, destSurlUuidInd);
+        sql.commit();
+    }
+    catch (std::exception& e)
+    {
+        sql.rollback();
+        throw UserError(std::string(__func__) + ": Caught exception " + e.what());
+    }
+    catch (...)
+    {
+        sql.rollback();
+        throw UserError(std::string(__func__) + ": Caught exception ");
+    }
+    return  boost::tuple<bool, std::string>(true, storedState);
+}
 
-        query << "UPDATE t_file SET "
-              "    file_state = :state, reason = :reason";
-        stmt.exchange(soci::use(newFileState, "state"));
-        stmt.exchange(soci::use(transferMessage, "reason"));
 
-        if (newFileState == "FINISHED" || newFileState == "FAILED" || newFileState == "CANCELED")
-        {
-            query << ", FINISH_TIME = :time1, DEST_SURL_UUID = NULL";
-            stmt.exchange(soci::use(tTime, "time1"));
-        }
-        if (newFileState == "ACTIVE" || newFileState == "READY")
-        {
-            query << ", START_TIME = :time1";
-            stmt.exchange(soci::use(tTime, "time1"));
-        }
+bool MySqlAPI::updateJobStatus(const std::string& jobId, const std::string& jobState)
+{
+    soci::session sql(*connectionPool);
+    return updateJobTransferStatusInternal(sql, jobId, jobState);
+}
 
-        query << ", transfer_Host = :hostname";
-        stmt.exchange(soci::use(hostname, "hostname"));
 
-        if (newFileState == "FINISHED")
-        {
-            query << ", transferred = :filesize";
-            stmt.exchange(soci::use(filesize, "filesize"));
-        }
+std::map<std::string, MySqlAPI::JobFileCounters> MySqlAPI::getJobFileCounters(soci::session& sql,
+        const std::vector<std::string>& jobIds)
+{
+    std::map<std::string, JobFileCounters> counters;
 
-        if (newFileState == "FAILED" || newFileState == "CANCELED")
-        {
-            query << ", transferred = :transferred";
-            stmt.exchange(soci::use(0, "transferred"));
+    // The t_file triggers count rows, which only match the counts per file_index
+    // when there are no replicas nor hops
+    for (size_t first = 0; first < jobIds.size(); first += BULK_JOBS_PER_QUERY)
+    {
+        size_t last = std::min(first + BULK_JOBS_PER_QUERY, jobIds.size());
+        std::ostringstream query;
+
+        query << "SELECT c.job_id, c.files, c.submitted, c.staging, c.archiving, c.finished, c.failed, c.canceled "
+                 "FROM t_job_counters c INNER JOIN t_job j ON (c.job_id = j.job_id) "
+                 "WHERE (j.job_type IS NULL OR j.job_type IN ('N', 'Y')) AND c.job_id IN (";
+        for (size_t i = first; i < last; ++i) {
+            query << (i > first ? ", " : "") << ":job_id" << i;
         }
+        query << ")";
 
-        if (newFileState == "STAGING")
-        {
-            if (isStaging)
-            {
-                query << ", STAGING_FINISHED = :time1";
-                stmt.exchange(soci::use(tTime, "time1"));
-            }
-            else
-            {
-                query << ", STAGING_START = :time1";
-                stmt.exchange(soci::use(tTime, "time1"));
-            }
+        soci::details::prepare_temp_type prepared = (sql.prepare << query.str());
+        for (size_t i = first; i < last; ++i) {
+            prepared, soci::use(jobIds[i]);
         }
-        
-        // Move the new state to ARCHIVING if the transfer completed and the archive timeout is set
-        if (newFileState == "FINISHED" && isArchivingTransfer(sql, jobId, jobType, archiveTimeout)) {
-            FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "Moving transfer " << jobId << " " << fileId
-                                             << " to ARCHIVING state" << commit;
-            newFileState = "ARCHIVING";
+
+        soci::rowset<soci::row> rs(prepared);
+        for (auto i = rs.begin(); i != rs.end(); ++i) {
+            JobFileCounters &entry = counters[i->get<std::string>("job_id")];
+            int files = i->get<int>("files");
+            int failed = i->get<int>("failed");
+            int canceled = i->get<int>("canceled");
+
+            entry.inJob = files;
+            entry.notCanceled = files - canceled;
+            entry.finished = i->get<int>("finished");
+            entry.staging = i->get<int>("staging");
+            entry.archiving = i->get<int>("archiving");
+            entry.notCanceledNorFailed = files - canceled - failed;
+            entry.submitted = i->get<int>("submitted");
         }
+    }
 
-        if (!fileMetadata.empty()) {
-            query << ", file_metadata = :file_metadata";
-            stmt.exchange(soci::use(fileMetadata, "file_metadata"));
+    std::vector<std::string> uncounted;
+    for (auto i = jobIds.begin(); i != jobIds.end(); ++i) {
+        if (counters.find(*i) == counters.end()) {
+            uncounted.push_back(*i);
         }
+    }
+    countJobFiles(sql, uncounted, counters);
 
-        query << "   , pid = :pid, filesize = :filesize, tx_duration = :duration, throughput = :throughput, current_failures = :current_failures "
-              "WHERE file_id = :fileId AND file_state = :oldState";
-        stmt.exchange(soci::use(processId, "pid"));
-        stmt.exchange(soci::use(filesize, "filesize"));
-        stmt.exchange(soci::use(duration, "duration"));
-        stmt.exchange(soci::use(throughput, "throughput"));
-        stmt.exchange(soci::use(static_cast<int>(retry), "current_failures"));
-        stmt.exchange(soci::use(fileId, "fileId"));
-        stmt.exchange(soci::use(storedState, "oldState"));
-        stmt.alloc();
-        stmt.prepare(query.str());
-        stmt.define_and_bind();
+    return counters;
+}
 
-        stmt.execute(true);
 
-        if (get_affected_rows(sql) == 0) {
-            sql.rollback();
-            return boost::tuple<bool, std::string>(false, storedState);
+void MySqlAPI::countJobFiles(soci::session& sql, const std::vector<std::string>& jobIds,
+        std::map<std::string, JobFileCounters>& counters)
+{
+    // A file is counted once per file_index, so replicas and hops of the same file are aggregated:
+    // it is canceled only if all replicas are CANCELED, failed only if all are CANCELED or FAILED,
+    // and finished if at least one replica is FINISHED
+    for (size_t first = 0; first < jobIds.size(); first += BULK_JOBS_PER_QUERY)
+    {
+        size_t last = std::min(first + BULK_JOBS_PER_QUERY, jobIds.size());
+        std::ostringstream query;
+
+        query << "SELECT job_id, "
+                 "  COUNT(DISTINCT file_index) AS in_job, "
+                 "  COUNT(DISTINCT CASE WHEN file_state <> 'CANCELED' THEN file_index END) AS not_canceled, "
+                 "  COUNT(DISTINCT CASE WHEN file_state = 'FINISHED' THEN file_index END) AS finished, "
+                 "  COUNT(DISTINCT CASE WHEN file_state IN ('STAGING', 'STARTED') THEN file_index END) AS staging, "
+                 "  COUNT(DISTINCT CASE WHEN file_state = 'ARCHIVING' THEN file_index END) AS archiving, "
+                 "  COUNT(DISTINCT CASE WHEN file_state NOT IN ('CANCELED', 'FAILED') THEN file_index END) AS not_canceled_failed, "
+                 "  CAST(SUM(file_state = 'SUBMITTED') AS SIGNED) AS submitted "
+                 "FROM t_file WHERE job_id IN (";
+        for (size_t i = first; i < last; ++i) {
+            query << (i > first ? ", " : "") << ":job_id" << i;
         }
+        query << ") GROUP BY job_id ORDER BY NULL";
 
-        sql.commit();
+        soci::details::prepare_temp_type prepared = (sql.prepare << query.str());
+        for (size_t i = first; i < last; ++i) {
+            prepared, soci::use(jobIds[i]);
+        }
 
-        switch (jobType) {
-            // Multiple replica job, on failure, need to pick next option
-            case Job::kTypeMultipleReplica:
-                if ((jobState != "CANCELED" && jobState != "FAILED") &&
-                    (newFileState == "FAILED" || newFileState == "CANCELED")) {
-                    sql.begin();
-                    useFileReplica(sql, jobId, fileId, destSurlUuid, destSurlUuidInd);
-                    sql.commit();
-                }
-                break;
-            // For multihop jobs, on success enable next option
-            case Job::kTypeMultiHop:
-                if ((jobState != "CANCELED" && jobState != "FAILED") &&
-                    (newFileState == "FINISHED")) {
-                    sql.begin();
-                    useNextHop(sql, jobId);
-                    sql.commit();
-                }
-                else {
-                    // need to remove all dest_surl_uuid from all jobs
-                    sql.begin();
-                    setNullDestSURLMultiHop(sql, jobId);
-                    sql.commit();
-                }
-                break;
-            // Nothing special for other type of jobs
-            default:
-                break;
+        soci::rowset<soci::row> rs(prepared);
+        for (auto i = rs.begin(); i != rs.end(); ++i) {
+            JobFileCounters &entry = counters[i->get<std::string>("job_id")];
+            entry.inJob = static_cast<int>(i->get<long long>("in_job"));
+            entry.notCanceled = static_cast<int>(i->get<long long>("not_canceled"));
+            entry.finished = static_cast<int>(i->get<long long>("finished"));
+            entry.staging = static_cast<int>(i->get<long long>("staging"));
+            entry.archiving = static_cast<int>(i->get<long long>("archiving"));
+            entry.notCanceledNorFailed = static_cast<int>(i->get<long long>("not_canceled_failed"));
+            entry.submitted = static_cast<int>(i->get<long long>("submitted"));
         }
     }
-    catch (std::exception& e)
-    {
-        sql.rollback();
-        throw UserError(std::string(__func__) + ": Caught exception " + e.what());
-    }
-    catch (...)
-    {
-        sql.rollback();
-        throw UserError(std::string(__func__) + ": Caught exception ");
-    }
-    return  boost::tuple<bool, std::string>(true, storedState);
 }
 
 
-bool MySqlAPI::updateJobStatus(const std::string& jobId, const std::string& jobState)
+bool MySqlAPI::resolveFinishedJobState(Job::JobType jobType, const JobFileCounters& counters,
+        std::string& state, std::string& reason)
 {
-    soci::session sql(*connectionPool);
-    return updateJobTransferStatusInternal(sql, jobId, jobState);
+    bool jobFinished = (counters.inJob == counters.terminal()) ||
+        (jobType == Job::kTypeMultiHop && counters.failed() + counters.canceled() > 0);
+
+    if (!jobFinished) {
+        return false;
+    }
+
+    reason = "One or more files failed. Please have a look at the details for more information";
+    if (counters.finished > 0 && counters.failed() > 0)
+    {
+        if (jobType == Job::kTypeMultiHop)
+            state = "FAILED";
+        else
+            state = "FINISHEDDIRTY";
+    }
+    else if(counters.inJob == counters.finished)
+    {
+        state = "FINISHED";
+        reason.clear();
+    }
+    else if(counters.failed() > 0)
+    {
+        state = "FAILED";
+    }
+    else if(counters.canceled() > 0)
+    {
+        state = "CANCELED";
+    }
+    else
+    {
+        state = "FAILED";
+        reason = "Inconsistent internal state!";
+    }
+    return true;
 }
 
 
@@ -1413,16 +1946,6 @@ bool MySqlAPI::updateJobTransferStatusInternal(soci::session& sql, std::string j
 {
     try
     {
-        int numberOfFilesInJob = 0;
-        int numberOfFilesCanceled = 0;
-        int numberOfFilesFinished = 0;
-        int numberOfFilesFailed = 0;
-        int numberOfStaging = 0;
-        int numberOfFilesArchiving = 0;
-
-        int numberOfFilesNotCanceled = 0;
-        int numberOfFilesNotCanceledNorFailed = 0;
-
         std::string currentState("");
         Job::JobType jobType;
         soci::indicator isNull = soci::i_ok;
@@ -1494,247 +2017,577 @@ bool MySqlAPI::updateJobTransferStatusInternal(soci::session& sql, std::string j
             sql <<  " SELECT source_se FROM t_file WHERE job_id=:job_id AND file_state='FINISHED' LIMIT 1 ", soci::use(jobId), soci::into(sourceSe);
         }
 
-        sql << " SELECT COUNT(DISTINCT file_index) "
-            " FROM t_file "
-            " WHERE job_id = :job_id ",
-            soci::use(jobId),
-            soci::into(numberOfFilesInJob);
+        JobFileCounters counters = getJobFileCounters(sql, std::vector<std::string>(1, jobId))[jobId];
 
-        sql << " SELECT COUNT(DISTINCT file_index) "
-            " FROM t_file "
-            " WHERE job_id = :jobId "
-            "   AND file_state <> 'CANCELED' ", // all the replicas have to be in CANCELED state in order to count a file as canceled
-            soci::use(jobId),                  // so if just one replica is in a different state it is enough to count it as not canceled
-            soci::into(numberOfFilesNotCanceled);
+        std::string finalState, reason;
+        bool jobFinished = resolveFinishedJobState(jobType, counters, finalState, reason);
+
+        if (jobFinished)
+        {
+            const std::string& state = finalState;
+
+            //re-execute here just in case
+            stmt1.execute(true);
+
+            if(currentState == state)
+                return true;
+
+            if(sourceSe.length() > 0)
+            {
+                sql.begin();
+                // Update job
+                soci::statement stmt6 = (
+                    sql.prepare << "UPDATE t_job SET "
+                    "    job_state = :state, job_finished = UTC_TIMESTAMP(), "
+                    "    reason = :reason, source_se = :sourceSe "
+                    "WHERE job_id = :jobId and job_state NOT IN ('FAILED','FINISHEDDIRTY','CANCELED','FINISHED')  ",
+                    soci::use(state, "state"), soci::use(reason, "reason"), soci::use(sourceSe, "sourceSe"),
+                    soci::use(jobId, "jobId"));
+                stmt6.execute(true);
+                sql.commit();
+            }
+            else
+            {
+                sql.begin();
+                // Update job
+                soci::statement stmt6 = (
+                    sql.prepare << "UPDATE t_job SET "
+                    "    job_state = :state, job_finished = UTC_TIMESTAMP(), "
+                    "    reason = :reason "
+                    "WHERE job_id = :jobId and job_state NOT IN ('FAILED','FINISHEDDIRTY','CANCELED','FINISHED')  ",
+                    soci::use(state, "state"), soci::use(reason, "reason"),
+                    soci::use(jobId, "jobId"));
+                stmt6.execute(true);
+                sql.commit();
+            }
+
+            // Behavior on finished multihop jobs
+            bool cancelUnusedMultihopFiles = ServerConfig::instance().get<bool>("CancelUnusedMultihopFiles");
+
+            if (cancelUnusedMultihopFiles && jobType == Job::kTypeMultiHop) {
+                sql.begin();
+                soci::statement stmt7 = (
+                    sql.prepare << "UPDATE t_file SET file_state = 'CANCELED' "
+                                   "WHERE job_id = :jobId and file_state = 'NOT_USED' ",
+                    soci::use(jobId));
+                stmt7.execute(true);
+                sql.commit();
+            }
+        }
+        // Job not finished yet
+        else
+        {
+            if (state == "ACTIVE" || state == "STAGING" || state == "SUBMITTED" || (currentState == "STAGING" && counters.staging == 0))
+            {
+                std::string newState = state;
+
+                //re-execute here just in case
+                stmt1.execute(true);
+
+                if(currentState == state)
+                    return true;
+
+                // Move from staging to SUBMITTED if the job is session reuse and there are none in staging
+                if (currentState == "STAGING" && counters.staging == 0) {
+                    newState = "SUBMITTED";
+                }
+
+                sql.begin();
+
+                soci::statement stmt8 = (
+                                            sql.prepare << "UPDATE t_job "
+                                            "SET job_state = :state "
+                                            "WHERE job_id = :jobId AND job_state NOT IN ('FINISHEDDIRTY','CANCELED','FINISHED','FAILED') ",
+                                            soci::use(newState, "state"), soci::use(jobId, "jobId"));
+                stmt8.execute(true);
+
+                sql.commit();
+            }
+            // all ongoing files are in archiving state
+            else if (counters.archiving > 0 &&
+                     (counters.inJob == counters.terminal() + counters.archiving)) {
+                // re-execute here just in case
+                stmt1.execute(true);
+
+                if (currentState == "ARCHIVING")
+                    return true;
+
+                sql.begin();
+
+                soci::statement stmt8 = (
+                    sql.prepare << "UPDATE t_job SET job_state = 'ARCHIVING' "
+                                   "WHERE job_id = :jobId and job_state NOT IN ('FAILED','FINISHEDDIRTY','CANCELED','FINISHED')",
+                            soci::use(jobId, "jobId"));
+                stmt8.execute(true);
+
+                sql.commit();
+            }
+        }
+    }
+    catch (std::exception& e)
+    {
+        sql.rollback();
+        throw UserError(std::string(__func__) + ": Caught exception " + e.what());
+    }
+    catch (...)
+    {
+        sql.rollback();
+        throw UserError(std::string(__func__) + ": Caught exception ");
+    }
+
+    return true;
+}
+
+
+void MySqlAPI::updateJobTransferStatusBatchInternal(soci::session& sql, const std::string& jobId,
+        const std::string& state, Job::JobType jobType, std::string& currentState, const JobFileCounters& counters)
+{
+    // Same decisions as updateJobTransferStatusInternal, but without opening transactions of its own,
+    // and keeping currentState up to date for the next transition of the same job in the batch
+    if (currentState == state)
+        return;
+
+    if (currentState == "STAGING" && state == "STARTED")
+        return;
+
+    std::string sourceSe;
+
+    if (jobType == Job::kTypeMultipleReplica && currentState == "ARCHIVING" && state == "FAILED") {
+        std::string reason = "Archive monitoring failed in a multiple replica job";
+
+        sql << " SELECT source_se FROM t_file WHERE job_id=:job_id AND file_state='FAILED' LIMIT 1 ",
+            soci::use(jobId), soci::into(sourceSe);
+
+        sql << "UPDATE t_job SET "
+               "    job_state = :state, job_finished = UTC_TIMESTAMP(), "
+               "    reason = :reason, source_se = :sourceSe "
+               "WHERE job_id = :jobId and job_state NOT IN ('FAILED','FINISHEDDIRTY','CANCELED','FINISHED')  ",
+            soci::use(state, "state"), soci::use(reason, "reason"),
+            soci::use(sourceSe, "sourceSe"), soci::use(jobId, "jobId");
+        if (get_affected_rows(sql) > 0) {
+            currentState = state;
+        }
+        return;
+    }
+
+    if (state == "ACTIVE" && jobType == Job::kTypeRegular)
+    {
+        sql << "UPDATE t_job "
+               "SET job_state = :state "
+               "WHERE job_id = :jobId AND job_state NOT IN ('ACTIVE','FINISHEDDIRTY','CANCELED','FINISHED','FAILED') ",
+            soci::use(state, "state"), soci::use(jobId, "jobId");
+        if (get_affected_rows(sql) > 0) {
+            currentState = state;
+        }
+        return;
+    }
+    else if ((state == "FINISHED" || state == "FAILED") && jobType == Job::kTypeRegular)
+    {
+        if (counters.submitted > 0)
+            return;
+    }
+    else if (state == "FINISHED" && jobType == Job::kTypeMultipleReplica)
+    {
+        sql << " SELECT source_se FROM t_file WHERE job_id=:job_id AND file_state='FINISHED' LIMIT 1 ",
+            soci::use(jobId), soci::into(sourceSe);
+    }
+
+    std::string finalState, reason;
+    if (resolveFinishedJobState(jobType, counters, finalState, reason))
+    {
+        if (currentState == finalState)
+            return;
+
+        if (sourceSe.length() > 0)
+        {
+            sql << "UPDATE t_job SET "
+                   "    job_state = :state, job_finished = UTC_TIMESTAMP(), "
+                   "    reason = :reason, source_se = :sourceSe "
+                   "WHERE job_id = :jobId and job_state NOT IN ('FAILED','FINISHEDDIRTY','CANCELED','FINISHED')  ",
+                soci::use(finalState, "state"), soci::use(reason, "reason"), soci::use(sourceSe, "sourceSe"),
+                soci::use(jobId, "jobId");
+        }
+        else
+        {
+            sql << "UPDATE t_job SET "
+                   "    job_state = :state, job_finished = UTC_TIMESTAMP(), "
+                   "    reason = :reason "
+                   "WHERE job_id = :jobId and job_state NOT IN ('FAILED','FINISHEDDIRTY','CANCELED','FINISHED')  ",
+                soci::use(finalState, "state"), soci::use(reason, "reason"),
+                soci::use(jobId, "jobId");
+        }
+        if (get_affected_rows(sql) > 0) {
+            currentState = finalState;
+        }
+
+        // Behavior on finished multihop jobs
+        bool cancelUnusedMultihopFiles = ServerConfig::instance().get<bool>("CancelUnusedMultihopFiles");
+
+        if (cancelUnusedMultihopFiles && jobType == Job::kTypeMultiHop) {
+            sql << "UPDATE t_file SET file_state = 'CANCELED' "
+                   "WHERE job_id = :jobId and file_state = 'NOT_USED' ",
+                soci::use(jobId);
+        }
+    }
+    // Job not finished yet
+    else if (state == "ACTIVE" || state == "STAGING" || state == "SUBMITTED" ||
+             (currentState == "STAGING" && counters.staging == 0))
+    {
+        std::string newState = state;
+
+        // Move from staging to SUBMITTED if the job is session reuse and there are none in staging
+        if (currentState == "STAGING" && counters.staging == 0) {
+            newState = "SUBMITTED";
+        }
+
+        sql << "UPDATE t_job "
+               "SET job_state = :state "
+               "WHERE job_id = :jobId AND job_state NOT IN ('FINISHEDDIRTY','CANCELED','FINISHED','FAILED') ",
+            soci::use(newState, "state"), soci::use(jobId, "jobId");
+        if (get_affected_rows(sql) > 0) {
+            currentState = newState;
+        }
+    }
+    // all ongoing files are in archiving state
+    else if (counters.archiving > 0 && (counters.inJob == counters.terminal() + counters.archiving))
+    {
+        if (currentState == "ARCHIVING")
+            return;
+
+        sql << "UPDATE t_job SET job_state = 'ARCHIVING' "
+               "WHERE job_id = :jobId and job_state NOT IN ('FAILED','FINISHEDDIRTY','CANCELED','FINISHED')",
+            soci::use(jobId, "jobId");
+        if (get_affected_rows(sql) > 0) {
+            currentState = "ARCHIVING";
+        }
+    }
+}
+
+
+/// t_job fields needed to apply a batch of status messages
+struct BatchJobEntry {
+    BatchJobEntry(): jobType(Job::kTypeRegular), archiveTimeout(-1) {}
+
+    Job::JobType jobType;
+    std::string state;
+    int archiveTimeout;
+};
+
+/// t_file fields needed to apply a batch of status messages
+struct BatchFileEntry {
+    BatchFileEntry(): destSurlUuidInd(soci::i_null) {}
+
+    std::string state;
+    std::string destSurlUuid;
+    soci::indicator destSurlUuidInd;
+};
+
+
+std::vector<boost::tuple<bool, std::string> > MySqlAPI::updateTransferStatusBatch(
+        const std::vector<fts3::events::Message>& messages)
+{
+    std::vector<boost::tuple<bool, std::string> > results;
+    if (messages.empty()) {
+        return results;
+    }
+
+    soci::session sql(*connectionPool);
+
+    try
+    {
+        sql.begin();
+        results = updateTransferStatusBatchInternal(sql, messages);
+        sql.commit();
+    }
+    catch (std::exception& e)
+    {
+        sql.rollback();
+        throw UserError(std::string(__func__) + ": Caught exception " + e.what());
+    }
+    catch (...)
+    {
+        sql.rollback();
+        throw UserError(std::string(__func__) + ": Caught exception ");
+    }
+
+    return results;
+}
+
+
+std::vector<boost::tuple<bool, std::string> > MySqlAPI::terminateTransfers(
+        const std::vector<TerminalTransition>& transitions, std::vector<TransferState>& states)
+{
+    std::vector<boost::tuple<bool, std::string> > results;
+    if (transitions.empty()) {
+        return results;
+    }
 
+    soci::session sql(*connectionPool);
 
-        // number of files that were canceled
-        numberOfFilesCanceled = numberOfFilesInJob - numberOfFilesNotCanceled;
+    try
+    {
+        sql.begin();
+        results = terminateTransfersInternal(sql, transitions, states);
+        sql.commit();
+    }
+    catch (std::exception& e)
+    {
+        sql.rollback();
+        throw UserError(std::string(__func__) + ": Caught exception " + e.what());
+    }
+    catch (...)
+    {
+        sql.rollback();
+        throw UserError(std::string(__func__) + ": Caught exception ");
+    }
 
-        // number of files that were finished
-        sql << " SELECT COUNT(DISTINCT file_index) "
-            " FROM t_file "
-            " WHERE job_id = :jobId "
-            "   AND file_state = 'FINISHED' ", // at least one replica has to be in FINISH state in order to count the file as finished
-            soci::use(jobId),
-            soci::into(numberOfFilesFinished);
+    return results;
+}
 
-        // number of files still staging
-        sql << " SELECT COUNT(DISTINCT file_index) "
-            " FROM t_file "
-            " WHERE job_id = :jobId "
-            "   AND file_state IN ('STAGING', 'STARTED') ",
-            soci::use(jobId),
-            soci::into(numberOfStaging);
 
-        // number of files archiving
-        sql << " SELECT COUNT(DISTINCT file_index) "
-            " FROM t_file "
-            " WHERE job_id = :jobId "
-            "   AND file_state = 'ARCHIVING' ",
-            soci::use(jobId),
-            soci::into(numberOfFilesArchiving);
+std::vector<boost::tuple<bool, std::string> > MySqlAPI::terminateTransfersInternal(soci::session& sql,
+        const std::vector<TerminalTransition>& transitions, std::vector<TransferState>& states)
+{
+    // Same path as the status messages sent by fts_url_copy
+    std::vector<fts3::events::Message> messages;
+    messages.reserve(transitions.size());
+    for (auto i = transitions.begin(); i != transitions.end(); ++i) {
+        if (i->state != "FAILED" && i->state != "CANCELED") {
+            throw UserError(std::string(__func__) + ": Not a terminal state " + i->state);
+        }
+        fts3::events::Message msg;
+        msg.set_job_id(i->jobId);
+        msg.set_file_id(i->fileId);
+        msg.set_transfer_status(i->state);
+        msg.set_transfer_message(i->reason);
+        msg.set_process_id(i->processId);
+        messages.emplace_back(msg);
+    }
 
-        // number of files that were not canceled nor failed
-        sql << " SELECT COUNT(DISTINCT file_index) "
-            " FROM t_file "
-            " WHERE job_id = :jobId "
-            "   AND file_state <> 'CANCELED' " // for not canceled files see above
-            "   AND file_state <> 'FAILED' ",  // all the replicas have to be either in CANCELED or FAILED state in order to count
-            soci::use(jobId),                 // a files as failed so if just one replica is not in CANCEL neither in FAILED state
-            soci::into(numberOfFilesNotCanceledNorFailed);
+    std::vector<boost::tuple<bool, std::string> > results = updateTransferStatusBatchInternal(sql, messages);
 
-        // number of files that failed
-        numberOfFilesFailed = numberOfFilesInJob - numberOfFilesNotCanceledNorFailed - numberOfFilesCanceled;
+    std::vector<uint64_t> fileIds;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].get<0>()) {
+            fileIds.push_back(transitions[i].fileId);
+        }
+    }
+    getStateOfTransfersInternal(sql, fileIds, states);
 
-        // aggregated number of files in terminal states (FINISHED, FAILED and CANCELED)
-        int numberOfFilesTerminal = numberOfFilesCanceled + numberOfFilesFailed + numberOfFilesFinished;
+    return results;
+}
 
-        bool jobFinished = (numberOfFilesInJob == numberOfFilesTerminal) ||
-            (jobType == Job::kTypeMultiHop && numberOfFilesFailed + numberOfFilesCanceled > 0);
 
-        if (jobFinished)
-        {
-            std::string state;
-            std::string reason = "One or more files failed. Please have a look at the details for more information";
-            if (numberOfFilesFinished > 0 && numberOfFilesFailed > 0)
-            {
-                if (jobType == Job::kTypeMultiHop)
-                    state = "FAILED";
-                else
-                    state = "FINISHEDDIRTY";
-            }
-            else if(numberOfFilesInJob == numberOfFilesFinished)
-            {
-                state = "FINISHED";
-                reason.clear();
-            }
-            else if(numberOfFilesFailed > 0)
-            {
-                state = "FAILED";
-            }
-            else if(numberOfFilesCanceled > 0)
-            {
-                state = "CANCELED";
-            }
-            else
-            {
-                state = "FAILED";
-                reason = "Inconsistent internal state!";
-            }
+std::vector<boost::tuple<bool, std::string> > MySqlAPI::updateTransferStatusBatchInternal(soci::session& sql,
+        const std::vector<fts3::events::Message>& messages)
+{
+    std::vector<boost::tuple<bool, std::string> > results;
+    results.reserve(messages.size());
 
-            //re-execute here just in case
-            stmt1.execute(true);
+    // Messages sent before the transfer was identified only carry the pid of fts_url_copy
+    std::vector<std::pair<std::string, uint64_t> > transfers;
+    transfers.reserve(messages.size());
 
-            if(currentState == state)
-                return true;
+    for (auto msg = messages.begin(); msg != messages.end(); ++msg) {
+        std::string jobId = msg->job_id();
+        uint64_t fileId = msg->file_id();
 
-            if(sourceSe.length() > 0)
-            {
-                sql.begin();
-                // Update job
-                soci::statement stmt6 = (
-                    sql.prepare << "UPDATE t_job SET "
-                    "    job_state = :state, job_finished = UTC_TIMESTAMP(), "
-                    "    reason = :reason, source_se = :sourceSe "
-                    "WHERE job_id = :jobId and job_state NOT IN ('FAILED','FINISHEDDIRTY','CANCELED','FINISHED')  ",
-                    soci::use(state, "state"), soci::use(reason, "reason"), soci::use(sourceSe, "sourceSe"),
-                    soci::use(jobId, "jobId"));
-                stmt6.execute(true);
-                sql.commit();
+        if (jobId.empty() || fileId == 0) {
+            int processId = msg->process_id();
+            sql << "SELECT job_id, file_id FROM t_file WHERE pid=:pid AND file_state = 'ACTIVE' LIMIT 1 ",
+                soci::use(processId), soci::into(jobId), soci::into(fileId);
+        }
+        transfers.push_back(std::make_pair(jobId, fileId));
+    }
+
+    std::vector<std::string> jobIds;
+    std::set<uint64_t> fileIds;
+    {
+        std::set<std::string> seen;
+        for (auto i = transfers.begin(); i != transfers.end(); ++i) {
+            if (!i->first.empty() && seen.insert(i->first).second) {
+                jobIds.push_back(i->first);
             }
-            else
-            {
-                sql.begin();
-                // Update job
-                soci::statement stmt6 = (
-                    sql.prepare << "UPDATE t_job SET "
-                    "    job_state = :state, job_finished = UTC_TIMESTAMP(), "
-                    "    reason = :reason "
-                    "WHERE job_id = :jobId and job_state NOT IN ('FAILED','FINISHEDDIRTY','CANCELED','FINISHED')  ",
-                    soci::use(state, "state"), soci::use(reason, "reason"),
-                    soci::use(jobId, "jobId"));
-                stmt6.execute(true);
-                sql.commit();
+            if (i->second > 0) {
+                fileIds.insert(i->second);
             }
+        }
+    }
 
-            // Behavior on finished multihop jobs
-            bool cancelUnusedMultihopFiles = ServerConfig::instance().get<bool>("CancelUnusedMultihopFiles");
+    // Current state of the jobs and files touched by the batch
+    std::map<std::string, BatchJobEntry> jobs;
+    for (size_t first = 0; first < jobIds.size(); first += BULK_JOBS_PER_QUERY)
+    {
+        size_t last = std::min(first + BULK_JOBS_PER_QUERY, jobIds.size());
+        std::ostringstream query;
 
-            if (cancelUnusedMultihopFiles && jobType == Job::kTypeMultiHop) {
-                sql.begin();
-                soci::statement stmt7 = (
-                    sql.prepare << "UPDATE t_file SET file_state = 'CANCELED' "
-                                   "WHERE job_id = :jobId and file_state = 'NOT_USED' ",
-                    soci::use(jobId));
-                stmt7.execute(true);
-                sql.commit();
-            }
+        query << "SELECT job_id, job_type, job_state, archive_timeout FROM t_job WHERE job_id IN (";
+        for (size_t i = first; i < last; ++i) {
+            query << (i > first ? ", " : "") << ":job_id" << i;
         }
-        // Job not finished yet
-        else
-        {
-            if (state == "ACTIVE" || state == "STAGING" || state == "SUBMITTED" || (currentState == "STAGING" && numberOfStaging == 0))
-            {
-                std::string newState = state;
-
-                //re-execute here just in case
-                stmt1.execute(true);
+        query << ")";
 
-                if(currentState == state)
-                    return true;
+        soci::details::prepare_temp_type prepared = (sql.prepare << query.str());
+        for (size_t i = first; i < last; ++i) {
+            prepared, soci::use(jobIds[i]);
+        }
 
-                // Move from staging to SUBMITTED if the job is session reuse and there are none in staging
-                if (currentState == "STAGING" && numberOfStaging == 0) {
-                    newState = "SUBMITTED";
-                }
+        soci::rowset<soci::row> rs(prepared);
+        for (auto i = rs.begin(); i != rs.end(); ++i) {
+            BatchJobEntry &entry = jobs[i->get<std::string>("job_id")];
+            entry.jobType = i->get<Job::JobType>("job_type", Job::kTypeRegular);
+            entry.state = i->get<std::string>("job_state");
+            entry.archiveTimeout = i->get<int>("archive_timeout", -1);
+        }
+    }
 
-                sql.begin();
+    std::map<uint64_t, BatchFileEntry> files;
+    for (auto first = fileIds.begin(); first != fileIds.end();)
+    {
+        std::ostringstream query;
+        query << "SELECT file_id, file_state, dest_surl_uuid FROM t_file WHERE file_id IN (";
 
-                soci::statement stmt8 = (
-                                            sql.prepare << "UPDATE t_job "
-                                            "SET job_state = :state "
-                                            "WHERE job_id = :jobId AND job_state NOT IN ('FINISHEDDIRTY','CANCELED','FINISHED','FAILED') ",
-                                            soci::use(newState, "state"), soci::use(jobId, "jobId"));
-                stmt8.execute(true);
+        size_t count = 0;
+        for (; first != fileIds.end() && count < BULK_JOBS_PER_QUERY; ++first, ++count) {
+            query << (count > 0 ? ", " : "") << *first;
+        }
+        query << ")";
 
-                sql.commit();
+        soci::rowset<soci::row> rs = (sql.prepare << query.str());
+        for (auto i = rs.begin(); i != rs.end(); ++i) {
+            BatchFileEntry &entry = files[i->get<unsigned long long>("file_id")];
+            entry.state = i->get<std::string>("file_state");
+            entry.destSurlUuidInd = i->get_indicator("dest_surl_uuid");
+            if (entry.destSurlUuidInd == soci::i_ok) {
+                entry.destSurlUuid = i->get<std::string>("dest_surl_uuid");
             }
-            // all ongoing files are in archiving state
-            else if (numberOfFilesArchiving > 0 &&
-                     (numberOfFilesInJob == numberOfFilesTerminal + numberOfFilesArchiving)) {
-                // re-execute here just in case
-                stmt1.execute(true);
+        }
+    }
 
-                if (currentState == "ARCHIVING")
-                    return true;
+    // File transitions, in the order the messages were received
+    for (size_t i = 0; i < messages.size(); ++i)
+    {
+        const fts3::events::Message &msg = messages[i];
+        const std::string &jobId = transfers[i].first;
+        uint64_t fileId = transfers[i].second;
 
-                sql.begin();
+        auto file = files.find(fileId);
+        auto job = jobs.find(jobId);
+        if (file == files.end() || job == jobs.end()) {
+            results.push_back(boost::tuple<bool, std::string>(false, std::string()));
+            continue;
+        }
 
-                soci::statement stmt8 = (
-                    sql.prepare << "UPDATE t_job SET job_state = 'ARCHIVING' "
-                                   "WHERE job_id = :jobId and job_state NOT IN ('FAILED','FINISHEDDIRTY','CANCELED','FINISHED')",
-                            soci::use(jobId, "jobId"));
-                stmt8.execute(true);
+        std::string storedState = file->second.state;
+        std::string newFileState = msg.transfer_status();
 
-                sql.commit();
-            }
+        if (!isFileStateTransitionAllowed(storedState, newFileState, msg.process_id()) ||
+            !updateFileStateRow(sql, jobId, fileId, job->second.jobType, job->second.archiveTimeout,
+                storedState, newFileState, msg.transfer_message(), msg.process_id(), msg.filesize(),
+                msg.time_in_secs(), msg.throughput(), msg.retry(), msg.file_metadata())) {
+            results.push_back(boost::tuple<bool, std::string>(false, storedState));
+            continue;
         }
+
+        file->second.state = newFileState;
+        updateFileStateFollowUp(sql, jobId, fileId, job->second.jobType, job->second.state, newFileState,
+            file->second.destSurlUuid, file->second.destSurlUuidInd);
+
+        results.push_back(boost::tuple<bool, std::string>(true, newFileState));
     }
-    catch (std::exception& e)
-    {
-        sql.rollback();
-        throw UserError(std::string(__func__) + ": Caught exception " + e.what());
-    }
-    catch (...)
+
+    // Job transitions, evaluated once per job and requested state, over the files as left by the batch
+    std::map<std::string, JobFileCounters> counters = getJobFileCounters(sql, jobIds);
+    std::set<std::pair<std::string, std::string> > applied;
+
+    for (size_t i = 0; i < messages.size(); ++i)
     {
-        sql.rollback();
-        throw UserError(std::string(__func__) + ": Caught exception ");
+        const std::string &jobId = transfers[i].first;
+        const std::string &state = messages[i].transfer_status();
+
+        auto job = jobs.find(jobId);
+        if (job == jobs.end() || !applied.insert(std::make_pair(jobId, state)).second) {
+            continue;
+        }
+
+        updateJobTransferStatusBatchInternal(sql, jobId, state, job->second.jobType, job->second.state,
+            counters[jobId]);
     }
 
-    return true;
+    return results;
 }
 
 
 void MySqlAPI::updateFileTransferProgressVector(const std::vector<fts3::events::MessageUpdater>& messages)
 {
-    soci::session sql(*connectionPool);
+    // Only the most recent progress of each active transfer is worth writing
+    std::map<uint64_t, const fts3::events::MessageUpdater*> latest;
+    for (auto iter = messages.begin(); iter != messages.end(); ++iter)
+    {
+        if (iter->file_id() == 0 || iter->transfer_status() != "ACTIVE" || iter->throughput() <= 0.0) {
+            continue;
+        }
+        const fts3::events::MessageUpdater *&entry = latest[iter->file_id()];
+        if (entry == NULL || entry->timestamp() <= iter->timestamp()) {
+            entry = &(*iter);
+        }
+    }
 
-    try
+    if (latest.empty()) {
+        return;
+    }
+
+    std::vector<uint64_t> fileIds;
+    std::vector<double> throughputs, transferred;
+    fileIds.reserve(latest.size());
+    throughputs.reserve(latest.size());
+    transferred.reserve(latest.size());
+    for (auto iter = latest.begin(); iter != latest.end(); ++iter)
     {
-        double throughput = 0.0;
-        double transferred = 0.0;
-        uint64_t file_id = 0;
-        std::string file_state;
+        fileIds.push_back(iter->first);
+        throughputs.push_back(iter->second->throughput());
+        transferred.push_back(static_cast<double>(iter->second->transferred()));
+    }
 
-        soci::statement stmt = (sql.prepare << "UPDATE t_file SET throughput = :throughput, transferred = :transferred WHERE file_id = :fileId ",
-                                soci::use(throughput), soci::use(transferred), soci::use(file_id));
+    soci::session sql(*connectionPool);
 
+    try
+    {
         sql.begin();
 
-        for (auto iter = messages.begin(); iter != messages.end(); ++iter)
+        for (size_t first = 0; first < fileIds.size(); first += BULK_PROGRESS_PER_QUERY)
         {
-            throughput = 0.0;
-            transferred = 0.0;
-            file_id = 0;
-            file_state = "";
+            size_t last = std::min(first + BULK_PROGRESS_PER_QUERY, fileIds.size());
+            std::ostringstream query;
 
-            if ((*iter).file_id() > 0)
-            {
-                file_state = (*iter).transfer_status();
-
-                if(file_state == "ACTIVE")
-                {
-                    file_id = (*iter).file_id();
+            query << "UPDATE t_file SET throughput = CASE file_id";
+            for (size_t i = first; i < last; ++i) {
+                query << " WHEN :id_t" << i << " THEN :throughput" << i;
+            }
+            query << " END, transferred = CASE file_id";
+            for (size_t i = first; i < last; ++i) {
+                query << " WHEN :id_b" << i << " THEN :transferred" << i;
+            }
+            query << " END WHERE file_id IN (";
+            for (size_t i = first; i < last; ++i) {
+                query << (i > first ? ", " : "") << ":file_id" << i;
+            }
+            // A late flush must not overwrite what the final state left
+            query << ") AND file_state = 'ACTIVE'";
 
-                    if((*iter).throughput() > 0.0 && file_id > 0 )
-                    {
-                        throughput = (*iter).throughput();
-                        transferred = (*iter).transferred();
-                        stmt.execute(true);
-                    }
-                }
+            soci::details::prepare_temp_type prepared = (sql.prepare << query.str());
+            for (size_t i = first; i < last; ++i) {
+                prepared, soci::use(fileIds[i]), soci::use(throughputs[i]);
+            }
+            for (size_t i = first; i < last; ++i) {
+                prepared, soci::use(fileIds[i]), soci::use(transferred[i]);
             }
+            for (size_t i = first; i < last; ++i) {
+                prepared, soci::use(fileIds[i]);
+            }
+
+            soci::statement stmt(prepared);
+            stmt.execute(true);
         }
 
         sql.commit();
@@ -1752,7 +2605,7 @@ void MySqlAPI::updateFileTransferProgressVector(const std::vector<fts3::events::
 }
 
 
-void MySqlAPI::getCancelJob(std::vector<int>& requestIDs)
+void MySqlAPI::getCancelJob(std::vector<std::pair<int, uint64_t>>& requestIDs)
 {
     soci::session sql(*connectionPool);
     int pid = 0;
@@ -1778,7 +2631,7 @@ void MySqlAPI::getCancelJob(std::vector<int>& requestIDs)
             file_id = row.get<unsigned long long>("file_id");
 
             if(pid > 0)
-                requestIDs.push_back(pid);
+                requestIDs.emplace_back(pid, file_id);
 
             stmt1.execute(true);
         }
@@ -2568,9 +3421,63 @@ std::vector<TransferState> MySqlAPI::getStateOfDeleteInternal(soci::session& sql
 }
 
 
-std::vector<TransferState> MySqlAPI::getStateOfTransferInternal(soci::session& sql, const std::string& jobId, uint64_t fileId)
+/// Columns selected by getStateOfTransferInternal and getStateOfTransfersInternal
+static TransferState getTransferStateFromRow(const soci::row& row)
 {
     TransferState ret;
+    struct tm aux_tm;
+
+    ret.job_id = row.get<std::string>("job_id");
+    ret.job_state = row.get<std::string>("job_state");
+    ret.vo_name = row.get<std::string>("vo_name");
+    ret.job_metadata = row.get<std::string>("job_metadata","");
+    ret.retry_max = row.get<int>("retry_max",0);
+    ret.user_filesize = row.get<long long>("user_filesize", 0);
+    ret.file_id = row.get<unsigned long long>("file_id");
+    ret.file_state = row.get<std::string>("file_state");
+    ret.reason = row.get<std::string>("reason", "");
+    ret.timestamp = millisecondsSinceEpoch();
+    aux_tm = row.get<struct tm>("submit_time");
+    ret.submit_time = (timegm(&aux_tm) * 1000);
+
+    if (row.get_indicator("staging_start") == soci::i_ok) {
+        aux_tm = row.get<struct tm>("staging_start");
+        ret.staging_start = (timegm(&aux_tm) * 1000);
+    }
+    if (row.get_indicator("staging_finished") == soci::i_ok) {
+        aux_tm = row.get<struct tm>("staging_finished");
+        ret.staging_finished = (timegm(&aux_tm) * 1000);
+    }
+
+    if(ret.staging_start != 0)
+        ret.staging = true;
+
+    if (row.get_indicator("archive_start_time") == soci::i_ok) {
+        aux_tm = row.get<struct tm>("archive_start_time");
+        ret.archiving_start = (timegm(&aux_tm) * 1000);
+    }
+    if (row.get_indicator("archive_finish_time") == soci::i_ok) {
+        aux_tm = row.get<struct tm>("archive_finish_time");
+        ret.archiving_finished = (timegm(&aux_tm) * 1000);
+    }
+
+    if(ret.archiving_start != 0)
+        ret.archiving = true;
+
+    ret.retry_counter = row.get<int>("retry_counter",0);
+    ret.file_metadata = row.get<std::string>("file_metadata","");
+    ret.source_se = row.get<std::string>("source_se");
+    ret.dest_se = row.get<std::string>("dest_se");
+    ret.user_dn = row.get<std::string>("user_dn","");
+    ret.source_url = row.get<std::string>("source_surl","");
+    ret.dest_url = row.get<std::string>("dest_surl","");
+
+    return ret;
+}
+
+
+std::vector<TransferState> MySqlAPI::getStateOfTransferInternal(soci::session& sql, const std::string& jobId, uint64_t fileId)
+{
     std::vector<TransferState> temp;
 
     try
@@ -2607,63 +3514,12 @@ std::vector<TransferState> MySqlAPI::getStateOfTransferInternal(soci::session& s
 
 
 
-        soci::rowset<soci::row>::const_iterator it;
-
-        struct tm aux_tm;
-        for (it = rs.begin(); it != rs.end(); ++it)
+        for (auto it = rs.begin(); it != rs.end(); ++it)
         {
-            ret.job_id = it->get<std::string>("job_id");
-            ret.job_state = it->get<std::string>("job_state");
-            ret.vo_name = it->get<std::string>("vo_name");
-            ret.job_metadata = it->get<std::string>("job_metadata","");
-            ret.retry_max = it->get<int>("retry_max",0);
-            ret.user_filesize = it->get<long long>("user_filesize", 0);
-            ret.file_id = it->get<unsigned long long>("file_id");
-            ret.file_state = it->get<std::string>("file_state");
-            ret.reason = it->get<std::string>("reason", "");
-            ret.timestamp = millisecondsSinceEpoch();
-            aux_tm = it->get<struct tm>("submit_time");
-            ret.submit_time = (timegm(&aux_tm) * 1000);
-
-            if (it->get_indicator("staging_start") == soci::i_ok) {
-                aux_tm = it->get<struct tm>("staging_start");
-                ret.staging_start = (timegm(&aux_tm) * 1000);
-            }
-            if (it->get_indicator("staging_finished") == soci::i_ok) {
-                aux_tm = it->get<struct tm>("staging_finished");
-                ret.staging_finished = (timegm(&aux_tm) * 1000);
-            }
-
-            if(ret.staging_start != 0)
-                ret.staging = true;
-
-            if (it->get_indicator("archive_start_time") == soci::i_ok) {
-                aux_tm = it->get<struct tm>("archive_start_time");
-                ret.archiving_start = (timegm(&aux_tm) * 1000);
+            TransferState ret = getTransferStateFromRow(*it);
+            if (!publishUserDnInternal(sql, ret.vo_name)) {
+                ret.user_dn.clear();
             }
-            if (it->get_indicator("archive_finish_time") == soci::i_ok) {
-                aux_tm = it->get<struct tm>("archive_finish_time");
-                ret.archiving_finished = (timegm(&aux_tm) * 1000);
-            }
-
-            if(ret.archiving_start != 0)
-                ret.archiving = true;
-
-            ret.retry_counter = it->get<int>("retry_counter",0);
-            ret.file_metadata = it->get<std::string>("file_metadata","");
-            ret.source_se = it->get<std::string>("source_se");
-            ret.dest_se = it->get<std::string>("dest_se");
-
-            bool publishUserDn = publishUserDnInternal(sql, ret.vo_name);
-            if(!publishUserDn)
-                ret.user_dn = std::string("");
-            else
-                ret.user_dn = it->get<std::string>("user_dn","");
-
-
-            ret.source_url = it->get<std::string>("source_surl","");
-            ret.dest_url = it->get<std::string>("dest_surl","");
-
             temp.push_back(ret);
         }
     }
@@ -2680,6 +3536,47 @@ std::vector<TransferState> MySqlAPI::getStateOfTransferInternal(soci::session& s
 
 }
 
+void MySqlAPI::getStateOfTransfersInternal(soci::session& sql, const std::vector<uint64_t>& fileIds,
+    std::vector<TransferState>& states)
+{
+    std::map<std::string, bool> publishUserDn;
+
+    for (size_t first = 0; first < fileIds.size(); first += BULK_JOBS_PER_QUERY)
+    {
+        size_t last = std::min(first + BULK_JOBS_PER_QUERY, fileIds.size());
+        std::ostringstream query;
+
+        query << " SELECT "
+                 "  j.user_dn, j.submit_time, j.job_id, j.job_state, j.vo_name, "
+                 "  j.job_metadata, j.retry AS retry_max, f.file_id, "
+                 "  f.file_state, f.retry AS retry_counter, f.user_filesize, f.file_metadata, f.reason, "
+                 "  f.source_se, f.dest_se, f.start_time, f.source_surl, f.dest_surl, "
+                 "  f.staging_start, f.staging_finished, f.archive_start_time, f.archive_finish_time "
+                 " FROM t_file f INNER JOIN t_job j ON (f.job_id = j.job_id) "
+                 " WHERE f.file_id IN (";
+        for (size_t i = first; i < last; ++i) {
+            query << (i > first ? ", " : "") << fileIds[i];
+        }
+        query << ")";
+
+        soci::rowset<soci::row> rs = (sql.prepare << query.str());
+        for (auto it = rs.begin(); it != rs.end(); ++it)
+        {
+            TransferState ret = getTransferStateFromRow(*it);
+
+            auto publish = publishUserDn.find(ret.vo_name);
+            if (publish == publishUserDn.end()) {
+                publish = publishUserDn.emplace(ret.vo_name, publishUserDnInternal(sql, ret.vo_name)).first;
+            }
+            if (!publish->second) {
+                ret.user_dn.clear();
+            }
+            states.push_back(ret);
+        }
+    }
+}
+
+
 std::vector<TransferState> MySqlAPI::getStateOfTransfer(const std::string& jobId, uint64_t fileId)
 {
     soci::session sql(*connectionPool);
@@ -3483,6 +4380,9 @@ void MySqlAPI::getFilesForDeletion(std::vector<DeleteOperation>& delOps)
                 }
             }
         }
+
+        // The consumer is gone by the next run, so what it read must be committed now
+        consumer.commit();
     }
     catch (std::exception& e)
     {
@@ -63,6 +63,14 @@ public:
     virtual void getReadyTransfers(const std::vector<QueueId>& queues,
         std::map< std::string, std::list<TransferFile>>& files);
 
+    /// Get a list of transfers ready to go for the given queues
+    /// Same semantics as getReadyTransfers, but all queues are resolved together
+    /// with a bounded number of queries, instead of a set of queries per queue
+    /// @param queues       Queues for which to check (see getQueuesWithPending)
+    /// @param[out] files   A map where the key is the VO. The value is a list of transfers belonging to that VO
+    virtual void getReadyTransfersBulk(const std::vector<QueueId>& queues,
+        std::map< std::string, std::list<TransferFile>>& files);
+
     /// Update the status of a transfer
     /// @param jobId            The job ID
     /// @param fileId           The file ID
@@ -87,6 +95,19 @@ public:
     /// @param jobState         The job state
     virtual bool updateJobStatus(const std::string& jobId, const std::string& jobState);
 
+    /// Apply the file and job state changes of a set of status messages inside a single transaction
+    /// @param messages         Status messages, as received from fts_url_copy
+    /// @return                 One entry per message, see updateTransferStatus
+    virtual std::vector<boost::tuple<bool, std::string> > updateTransferStatusBatch(
+        const std::vector<fts3::events::Message>& messages);
+
+    /// Force a set of transfers into FAILED or CANCELED inside a single transaction
+    /// @param transitions      The transfers to terminate
+    /// @param[out] states      State of the transfers that were changed
+    /// @return                 One entry per transition, see updateTransferStatus
+    virtual std::vector<boost::tuple<bool, std::string> > terminateTransfers(
+        const std::vector<TerminalTransition>& transitions, std::vector<TransferState>& states);
+
     /// Get the credentials associated with the given delegation ID and user
     /// @param delegationId     Delegation ID. See insertCredentialCache
     /// @param userDn           The user's DN
@@ -153,6 +174,9 @@ public:
     /// Get the list of VO share configurations for the given link
     virtual std::vector<ShareConfig> getShareConfig(const std::string &source, const std::string &destination);
 
+    /// Get the VO share configurations of all the links at once, by source and destination
+    virtual std::map<std::pair<std::string, std::string>, std::vector<ShareConfig>> getShareConfigs();
+
     /// Returns how many retries there is configured for the given jobId
     virtual int getRetry(const std::string & jobId);
 
@@ -209,7 +233,7 @@ public:
     virtual unsigned int updateFileStatusReuse(const TransferFile &file, const std::string &status);
 
     /// Puts into requestIDs, jobs that have been cancelled, and for which the running fts_url_copy must be killed
-    virtual void getCancelJob(std::vector<int>& requestIDs);
+    virtual void getCancelJob(std::vector<std::pair<int, uint64_t>>& requestIDs);
 
     /// Returns list of transfers that need to be force started
     virtual std::list<TransferFile> getForceStartTransfers();
@@ -335,6 +359,12 @@ public:
     /// Get the configuration for a given storage
     virtual StorageConfig getStorageConfig(const std::string &storage);
 
+    /// Take a snapshot of the storage, link and server configuration, together with the retry
+    /// configuration of the given transfers, so they can be scheduled without further configuration queries
+    /// @param files    Transfers about to be scheduled, as returned by getReadyTransfers
+    virtual std::shared_ptr<const ConfigSnapshot> getConfigSnapshot(
+        const std::map< std::string, std::list<TransferFile>>& files);
+
 private:
     size_t                poolSize;
     soci::connection_pool* connectionPool;
@@ -354,6 +384,8 @@ private:
 
     std::map<std::string, double> getActivityShareConf(soci::session& sql, std::string vo);
 
+    static std::map<std::string, double> parseActivityShareConf(std::string activityShareStr);
+
     void updateArchivingStateInternal(soci::session& sql, const std::vector<MinFileStatus> &archivingOpsStatus);
 
     void updateDeletionsStateInternal(soci::session& sql, const std::vector<MinFileStatus> &delOpsStatus);
@@ -365,8 +397,58 @@ private:
         std::string newFileState, std::string transferMessage, int processId, double filesize, double duration, bool retry,
         std::string fileMetadata = "");
 
+    static bool isFileStateTransitionAllowed(const std::string& storedState, const std::string& newFileState,
+        int processId);
+
+    bool updateFileStateRow(soci::session& sql, const std::string& jobId, uint64_t fileId,
+        Job::JobType jobType, int archiveTimeout, const std::string& storedState, std::string& newFileState,
+        const std::string& transferMessage, int processId, double filesize, double duration, double throughput,
+        bool retry, const std::string& fileMetadata);
+
+    void updateFileStateFollowUp(soci::session& sql, const std::string& jobId, uint64_t fileId,
+        Job::JobType jobType, const std::string& jobState, const std::string& newFileState,
+        const std::string& destSurlUuid, soci::indicator destSurlUuidInd);
+
+    /// Number of distinct files (file_index) of a job in each relevant state
+    struct JobFileCounters {
+        JobFileCounters(): inJob(0), notCanceled(0), finished(0), staging(0), archiving(0),
+            notCanceledNorFailed(0), submitted(0) {}
+
+        int inJob;
+        int notCanceled;
+        int finished;
+        int staging;
+        int archiving;
+        int notCanceledNorFailed;
+        int submitted;
+
+        int canceled() const { return inJob - notCanceled; }
+        int failed() const { return inJob - notCanceledNorFailed - canceled(); }
+        int terminal() const { return canceled() + failed() + finished; }
+    };
+
+    /// Read from t_job_counters when the job has one file per file_index, counted from t_file otherwise
+    static std::map<std::string, JobFileCounters> getJobFileCounters(soci::session& sql,
+        const std::vector<std::string>& jobIds);
+
+    static void countJobFiles(soci::session& sql, const std::vector<std::string>& jobIds,
+        std::map<std::string, JobFileCounters>& counters);
+
+    static bool resolveFinishedJobState(Job::JobType jobType, const JobFileCounters& counters,
+        std::string& state, std::string& reason);
+
     bool updateJobTransferStatusInternal(soci::session& sql, std::string jobId, const std::string& state);
 
+    std::vector<boost::tuple<bool, std::string> > updateTransferStatusBatchInternal(soci::session& sql,
+        const std::vector<fts3::events::Message>& messages);
+
+    /// Same as terminateTransfers, inside the transaction already open in sql
+    std::vector<boost::tuple<bool, std::string> > terminateTransfersInternal(soci::session& sql,
+        const std::vector<TerminalTransition>& transitions, std::vector<TransferState>& states);
+
+    void updateJobTransferStatusBatchInternal(soci::session& sql, const std::string& jobId,
+        const std::string& state, Job::JobType jobType, std::string& currentState, const JobFileCounters& counters);
+
     bool resetForRetryStaging(soci::session& sql, uint64_t fileId, const std::string & jobId, bool retry, int& times);
 
     bool resetForRetryDelete(soci::session& sql, uint64_t fileId, const std::string & jobId, bool retry);
@@ -375,6 +457,9 @@ private:
 
     std::vector<TransferState> getStateOfTransferInternal(soci::session& sql, const std::string& jobId, uint64_t fileId);
 
+    void getStateOfTransfersInternal(soci::session& sql, const std::vector<uint64_t>& fileIds,
+        std::vector<TransferState>& states);
+
     std::vector<TransferState> getStateOfDeleteInternal(soci::session& sql, const std::string& jobId, uint64_t fileId);
 
     void useFileReplica(soci::session& sql, std::string jobId, uint64_t fileId, std::string destSurlUuid, soci::indicator destSurlUuidInd);
@@ -405,6 +490,8 @@ private:
     void fixEmptyJob(soci::session &sql, const std::string &jobId);
     void fixNonTerminalJob(soci::session &sql, const std::string &jobId,
         uint64_t filesInJob, uint64_t cancelCount, uint64_t finishedCount, uint64_t failedCount);
+    void fixJobCounters(soci::session &sql, const std::string &jobId,
+        long long filesInJob, std::map<std::string, long long> &stateCount);
 
     std::vector<std::string> getVos(void);
     void cancelExpiredJobsForVo(std::vector<std::string>& jobs, int maxTime, const std::string &vo);
@@ -18,7 +18,10 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <numeric>
+#include <set>
+#include <sstream>
 #include "MySqlAPI.h"
 #include "db/generic/DbUtils.h"
 #include "common/Exceptions.h"
@@ -96,12 +99,180 @@ static int getCountInState(soci::session &sql, const Pair &pair, const std::stri
 }
 
 
+// Bytes transferred within a time window, and statistics on the file sizes
+class ThroughputAccumulator {
+private:
+    time_t now, windowStart;
+    int64_t totalBytes;
+    uint64_t nFiles;
+    // Running mean and sum of squared deviations of the file size (Welford)
+    double filesizeMean, filesizeM2;
+
+public:
+    ThroughputAccumulator(time_t now, time_t windowStart): now(now), windowStart(windowStart),
+        totalBytes(0), nFiles(0), filesizeMean(0), filesizeM2(0)
+    {
+    }
+
+    time_t getWindowStart() const {
+        return windowStart;
+    }
+
+    void add(struct tm starttm, struct tm endtm, long long transferred, long long filesize)
+    {
+        time_t start = timegm(&starttm);
+        time_t end = timegm(&endtm);
+        time_t periodInWindow = 0;
+        double bytesInWindow = 0;
+
+        // Not finish information
+        if (endtm.tm_year <= 0) {
+            periodInWindow = now - std::max(start, windowStart);
+            long duration = now - start;
+            if (duration > 0) {
+                bytesInWindow = double(transferred / duration) * periodInWindow;
+            }
+        }
+        // Finished
+        else {
+            periodInWindow = end - std::max(start, windowStart);
+            long duration = end - start;
+            if (duration > 0 && filesize > 0) {
+                bytesInWindow = double(filesize / duration) * periodInWindow;
+            }
+            else if (duration <= 0) {
+                bytesInWindow = filesize;
+            }
+        }
+
+        totalBytes += bytesInWindow;
+        if (filesize > 0) {
+            ++nFiles;
+            double delta = filesize - filesizeMean;
+            filesizeMean += delta / nFiles;
+            filesizeM2 += delta * (filesize - filesizeMean);
+        }
+    }
+
+    void get(const boost::posix_time::time_duration &interval,
+        double *throughput, double *filesizeAvg, double *filesizeStdDev) const
+    {
+        *throughput = totalBytes / interval.total_seconds();
+        *filesizeAvg = *filesizeStdDev = 0;
+        if (nFiles > 0) {
+            *filesizeAvg = filesizeMean;
+            *filesizeStdDev = sqrt(filesizeM2 / nFiles);
+        }
+    }
+};
+
+
+// Success counters of a pair within a time window
+struct SuccessCounters {
+    int64_t nFinished, nFailed, nRetries;
+
+    SuccessCounters(): nFinished(0), nFailed(0), nRetries(0) {}
+
+    double getSuccessRate(int *retryCount) const {
+        *retryCount = static_cast<int>(nRetries);
+        // Round up efficiency
+        int64_t nTotal = nFinished + nFailed;
+        if (nTotal > 0) {
+            return ceil((nFinished * 100.0) / nTotal);
+        }
+        // If there are no terminal, use 100% success rate rather than 0 to avoid
+        // the optimizer stepping back
+        else {
+            return 100.0;
+        }
+    }
+};
+
+
+// Optimizer inputs of a pair, fetched in bulk
+struct PrefetchedPair {
+    int optimizerValue;
+    time_t avgDuration;
+    int active, submitted;
+    // Keyed by the time frame, in seconds
+    std::map<long, ThroughputAccumulator> throughput;
+    std::map<long, SuccessCounters> success;
+
+    PrefetchedPair(): optimizerValue(0), avgDuration(0), active(0), submitted(0) {}
+};
+
+
+// Storage limits as stored in t_se
+struct PrefetchedStorage {
+    double inboundThroughput, outboundThroughput;
+    int inboundActive, outboundActive;
+};
+
+
+// Link configuration as stored in t_link_config
+struct PrefetchedLink {
+    bool hasRange;
+    int minActive, maxActive;
+    OptimizerMode optimizerMode;
+};
+
+
 class MySqlOptimizerDataSource: public OptimizerDataSource {
 private:
     soci::session sql;
 
+    bool prefetched;
+    long avgDurationWindow;
+    std::map<Pair, PrefetchedPair> pairs;
+    std::map<std::string, PrefetchedStorage> storages;
+    std::map<Pair, PrefetchedLink> links;
+    std::map<std::string, double> throughputAsSource, throughputAsDestination;
+
+    PrefetchedPair *findPrefetched(const Pair &pair) {
+        if (!prefetched) {
+            return NULL;
+        }
+        auto i = pairs.find(pair);
+        if (i == pairs.end()) {
+            return NULL;
+        }
+        return &i->second;
+    }
+
+    // Same precedence as the UNION ... LIMIT 1 queries on t_link_config
+    const PrefetchedLink *findLink(const Pair &pair, bool *specific) {
+        const Pair candidates[] = {
+            Pair(pair.source, pair.destination), Pair(pair.source, "*"), Pair("*", pair.destination), Pair("*", "*")
+        };
+        for (size_t i = 0; i < 4; ++i) {
+            auto link = links.find(candidates[i]);
+            if (link != links.end()) {
+                *specific = (i < 3);
+                return &link->second;
+            }
+        }
+        return NULL;
+    }
+
+    const PrefetchedStorage *findStorage(const std::string &storage) {
+        auto i = storages.find(storage);
+        if (i == storages.end()) {
+            i = storages.find("*");
+        }
+        if (i == storages.end()) {
+            return NULL;
+        }
+        return &i->second;
+    }
+
+    void prefetchConfiguration();
+    void prefetchQueues();
+    void prefetchSuccess(const std::vector<long> &windows);
+    void prefetchThroughput(const std::vector<long> &windows);
+
 public:
-    MySqlOptimizerDataSource(soci::connection_pool* connectionPool): sql(*connectionPool)
+    MySqlOptimizerDataSource(soci::connection_pool* connectionPool): sql(*connectionPool),
+        prefetched(false), avgDurationWindow(0)
     {
     }
 
@@ -126,12 +297,64 @@ public:
         return result;
     }
 
+    void prefetch(const std::list<Pair> &activePairs,
+        const std::vector<boost::posix_time::time_duration> &timeFrames)
+    {
+        dropPrefetched();
+
+        std::vector<long> windows;
+        for (auto i = timeFrames.begin(); i != timeFrames.end(); ++i) {
+            windows.push_back(i->total_seconds());
+        }
+        if (windows.empty()) {
+            return;
+        }
+        std::sort(windows.begin(), windows.end());
+
+        for (auto i = activePairs.begin(); i != activePairs.end(); ++i) {
+            pairs[*i];
+        }
+
+        try {
+            prefetchConfiguration();
+            prefetchQueues();
+            prefetchSuccess(windows);
+            prefetchThroughput(windows);
+        }
+        catch (...) {
+            dropPrefetched();
+            throw;
+        }
+
+        avgDurationWindow = windows.back();
+        prefetched = true;
+    }
+
+    void dropPrefetched(void) {
+        prefetched = false;
+        avgDurationWindow = 0;
+        pairs.clear();
+        storages.clear();
+        links.clear();
+        throughputAsSource.clear();
+        throughputAsDestination.clear();
+    }
 
     OptimizerMode getOptimizerMode(const std::string &source, const std::string &dest) {
+        if (prefetched) {
+            bool specific;
+            const PrefetchedLink *link = findLink(Pair(source, dest), &specific);
+            return link ? link->optimizerMode : kOptimizerConservative;
+        }
         return getOptimizerModeInner(sql, source, dest);
     }
 
     void getPairLimits(const Pair &pair, Range *range, StorageLimits *limits) {
+        if (prefetched) {
+            getPrefetchedPairLimits(pair, range, limits);
+            return;
+        }
+
         soci::indicator nullIndicator;
 
         limits->source = limits->destination = 0;
@@ -172,7 +395,42 @@ public:
         }
     }
 
+    void getPrefetchedPairLimits(const Pair &pair, Range *range, StorageLimits *limits) {
+        limits->source = limits->destination = 0;
+        limits->throughputSource = 0;
+        limits->throughputDestination = 0;
+
+        const PrefetchedStorage *source = findStorage(pair.source);
+        if (source) {
+            limits->throughputSource = source->outboundThroughput;
+            limits->source = source->outboundActive;
+        }
+        const PrefetchedStorage *destination = findStorage(pair.destination);
+        if (destination) {
+            limits->throughputDestination = destination->inboundThroughput;
+            limits->destination = destination->inboundActive;
+        }
+
+        bool specific = false;
+        const PrefetchedLink *link = findLink(pair, &specific);
+        if (link) {
+            range->specific = specific;
+            if (link->hasRange) {
+                range->min = link->minActive;
+                range->max = link->maxActive;
+            }
+            else {
+                range->min = range->max = 0;
+            }
+        }
+    }
+
     int getOptimizerValue(const Pair &pair) {
+        PrefetchedPair *entry = findPrefetched(pair);
+        if (entry) {
+            return entry->optimizerValue;
+        }
+
         soci::indicator isCurrentNull;
         int currentActive = 0;
 
@@ -192,10 +450,17 @@ public:
     {
         static struct tm nulltm = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
-        *throughput = *filesizeAvg = *filesizeStdDev = 0;
+        PrefetchedPair *entry = findPrefetched(pair);
+        if (entry) {
+            auto window = entry->throughput.find(interval.total_seconds());
+            if (window != entry->throughput.end()) {
+                window->second.get(interval, throughput, filesizeAvg, filesizeStdDev);
+                return;
+            }
+        }
 
         time_t now = time(NULL);
-        time_t windowStart = now - interval.total_seconds();
+        ThroughputAccumulator accumulator(now, now - interval.total_seconds());
 
         soci::rowset<soci::row> transfers = (sql.prepare <<
         "SELECT start_time, finish_time, transferred, filesize "
@@ -211,64 +476,20 @@ public:
         soci::use(pair.source, "sourceSe"), soci::use(pair.destination, "destSe"),
         soci::use(interval.total_seconds(), "interval"));
 
-        int64_t totalBytes = 0;
-        std::vector<int64_t> filesizes;
-
         for (auto j = transfers.begin(); j != transfers.end(); ++j) {
-            auto transferred = j->get<long long>("transferred", 0.0);
-            auto filesize = j->get<long long>("filesize", 0.0);
-            auto starttm = j->get<struct tm>("start_time");
-            auto endtm = j->get<struct tm>("finish_time", nulltm);
-
-            time_t start = timegm(&starttm);
-            time_t end = timegm(&endtm);
-            time_t periodInWindow = 0;
-            double bytesInWindow = 0;
-
-            // Not finish information
-            if (endtm.tm_year <= 0) {
-                periodInWindow = now - std::max(start, windowStart);
-                long duration = now - start;
-                if (duration > 0) {
-                    bytesInWindow = double(transferred / duration) * periodInWindow;
-                }
-            }
-            // Finished
-            else {
-                periodInWindow = end - std::max(start, windowStart);
-                long duration = end - start;
-                if (duration > 0 && filesize > 0) {
-                    bytesInWindow = double(filesize / duration) * periodInWindow;
-                }
-                else if (duration <= 0) {
-                    bytesInWindow = filesize;
-                }
-            }
-
-            totalBytes += bytesInWindow;
-            if (filesize > 0) {
-                filesizes.push_back(filesize);
-            }
+            accumulator.add(j->get<struct tm>("start_time"), j->get<struct tm>("finish_time", nulltm),
+                j->get<long long>("transferred", 0.0), j->get<long long>("filesize", 0.0));
         }
 
-        *throughput = totalBytes / interval.total_seconds();
-        // Statistics on the file size
-        if (!filesizes.empty()) {
-            for (auto i = filesizes.begin(); i != filesizes.end(); ++i) {
-                *filesizeAvg += *i;
-            }
-            *filesizeAvg /= filesizes.size();
-
-            double deviations = 0.0;
-            for (auto i = filesizes.begin(); i != filesizes.end(); ++i) {
-                deviations += pow(*filesizeAvg - *i, 2);
-
-            }
-            *filesizeStdDev = sqrt(deviations / filesizes.size());
-        }
+        accumulator.get(interval, throughput, filesizeAvg, filesizeStdDev);
     }
 
     time_t getAverageDuration(const Pair &pair, const boost::posix_time::time_duration &interval) {
+        PrefetchedPair *entry = findPrefetched(pair);
+        if (entry && interval.total_seconds() == avgDurationWindow) {
+            return entry->avgDuration;
+        }
+
         double avgDuration = 0.0;
         soci::indicator isNullAvg = soci::i_ok;
 
@@ -284,6 +505,14 @@ public:
 
     double getSuccessRateForPair(const Pair &pair, const boost::posix_time::time_duration &interval,
         int *retryCount) {
+        PrefetchedPair *entry = findPrefetched(pair);
+        if (entry) {
+            auto window = entry->success.find(interval.total_seconds());
+            if (window != entry->success.end()) {
+                return window->second.getSuccessRate(retryCount);
+            }
+        }
+
         soci::rowset<soci::row> rs = (sql.prepare <<
             "SELECT file_state, retry, current_failures AS recoverable FROM t_file USE INDEX(idx_finish_time)"
             " WHERE "
@@ -332,14 +561,27 @@ public:
     }
 
     int getActive(const Pair &pair) {
+        PrefetchedPair *entry = findPrefetched(pair);
+        if (entry) {
+            return entry->active;
+        }
         return getCountInState(sql, pair, "ACTIVE");
     }
 
     int getSubmitted(const Pair &pair) {
+        PrefetchedPair *entry = findPrefetched(pair);
+        if (entry) {
+            return entry->submitted;
+        }
         return getCountInState(sql, pair, "SUBMITTED");
     }
 
     double getThroughputAsSource(const std::string &se) {
+        if (prefetched) {
+            auto i = throughputAsSource.find(se);
+            return (i != throughputAsSource.end()) ? i->second : 0;
+        }
+
         double throughput = 0;
         soci::indicator isNull;
 
@@ -352,6 +594,11 @@ public:
     }
 
     double getThroughputAsDestination(const std::string &se) {
+        if (prefetched) {
+            auto i = throughputAsDestination.find(se);
+            return (i != throughputAsDestination.end()) ? i->second : 0;
+        }
+
         double throughput = 0;
         soci::indicator isNull;
 
@@ -366,6 +613,11 @@ public:
         const PairState &newState, int diff, const std::string &rationale) {
 
         setNewOptimizerValue(sql, pair, activeDecision, newState.ema);
+
+        PrefetchedPair *entry = findPrefetched(pair);
+        if (entry) {
+            entry->optimizerValue = activeDecision;
+        }
         updateOptimizerEvolution(sql, pair, activeDecision, diff, rationale, newState);
     }
 
@@ -383,6 +635,187 @@ public:
 };
 
 
+// Storage limits, link configuration and current optimizer values. These tables are small,
+// so they are loaded whole and resolved in memory
+void MySqlOptimizerDataSource::prefetchConfiguration()
+{
+    soci::rowset<soci::row> seRows = (sql.prepare <<
+        "SELECT storage, inbound_max_throughput, inbound_max_active, outbound_max_throughput, outbound_max_active "
+        "FROM t_se");
+    for (auto i = seRows.begin(); i != seRows.end(); ++i) {
+        PrefetchedStorage &storage = storages[i->get<std::string>("storage")];
+        storage.inboundThroughput = i->get<double>("inbound_max_throughput", 0);
+        storage.inboundActive = i->get<int>("inbound_max_active", 0);
+        storage.outboundThroughput = i->get<double>("outbound_max_throughput", 0);
+        storage.outboundActive = i->get<int>("outbound_max_active", 0);
+    }
+
+    soci::rowset<soci::row> linkRows = (sql.prepare <<
+        "SELECT source_se, dest_se, min_active, max_active, optimizer_mode FROM t_link_config");
+    for (auto i = linkRows.begin(); i != linkRows.end(); ++i) {
+        PrefetchedLink &link = links[Pair(i->get<std::string>("source_se"), i->get<std::string>("dest_se"))];
+        link.hasRange = (i->get_indicator("min_active") != soci::i_null &&
+            i->get_indicator("max_active") != soci::i_null);
+        link.minActive = i->get<int>("min_active", 0);
+        link.maxActive = i->get<int>("max_active", 0);
+        link.optimizerMode = i->get<OptimizerMode>("optimizer_mode");
+    }
+
+    soci::rowset<soci::row> optimizerRows = (sql.prepare <<
+        "SELECT source_se, dest_se, active FROM t_optimizer");
+    for (auto i = optimizerRows.begin(); i != optimizerRows.end(); ++i) {
+        auto entry = pairs.find(Pair(i->get<std::string>("source_se"), i->get<std::string>("dest_se")));
+        if (entry != pairs.end()) {
+            entry->second.optimizerValue = i->get<int>("active", 0);
+        }
+    }
+}
+
+
+// Queued and active transfers per pair, and the current throughput per storage
+void MySqlOptimizerDataSource::prefetchQueues()
+{
+    soci::rowset<soci::row> rs = (sql.prepare <<
+        "SELECT source_se, dest_se, file_state, COUNT(*) AS count, SUM(throughput) AS throughput "
+        "FROM t_file "
+        "WHERE file_state IN ('ACTIVE', 'SUBMITTED') "
+        "GROUP BY source_se, dest_se, file_state "
+        "ORDER BY NULL");
+
+    for (auto i = rs.begin(); i != rs.end(); ++i) {
+        const std::string source = i->get<std::string>("source_se");
+        const std::string destination = i->get<std::string>("dest_se");
+        const std::string state = i->get<std::string>("file_state");
+        const int count = static_cast<int>(i->get<long long>("count"));
+
+        if (state == "ACTIVE") {
+            double throughput = i->get<double>("throughput", 0);
+            throughputAsSource[source] += throughput;
+            throughputAsDestination[destination] += throughput;
+        }
+
+        auto entry = pairs.find(Pair(source, destination));
+        if (entry == pairs.end()) {
+            continue;
+        }
+        if (state == "ACTIVE") {
+            entry->second.active = count;
+        }
+        else {
+            entry->second.submitted = count;
+        }
+    }
+}
+
+
+// Success rate and retries for each time frame, and the average duration over the longest one,
+// all from a single pass over the transfers terminated within the longest time frame
+void MySqlOptimizerDataSource::prefetchSuccess(const std::vector<long> &windows)
+{
+    const long longest = windows.back();
+
+    std::ostringstream query;
+    query << "SELECT source_se, dest_se";
+    for (size_t i = 0; i < windows.size(); ++i) {
+        std::ostringstream inWindow;
+        inWindow << "finish_time > (UTC_TIMESTAMP() - INTERVAL " << windows[i] << " SECOND)";
+
+        query
+            << ", CAST(SUM(CASE WHEN " << inWindow.str()
+            << " AND file_state IN ('FINISHED', 'ARCHIVING') THEN 1 ELSE 0 END) AS SIGNED) AS finished_" << i
+            // Recoverable FAILED, or SUBMITTED with a retry set
+            << ", CAST(SUM(CASE WHEN " << inWindow.str()
+            << " AND ((file_state = 'FAILED' AND current_failures <> 0) OR (file_state = 'SUBMITTED' AND retry <> 0))"
+            << " THEN 1 ELSE 0 END) AS SIGNED) AS failed_" << i
+            << ", CAST(SUM(CASE WHEN " << inWindow.str()
+            << " AND file_state = 'SUBMITTED' THEN COALESCE(retry, 0) ELSE 0 END) AS SIGNED) AS retries_" << i;
+    }
+    query
+        << ", AVG(CASE WHEN file_state IN ('FINISHED', 'ARCHIVING') AND tx_duration > 0 THEN tx_duration END)"
+        << " AS avg_duration"
+        << " FROM t_file USE INDEX(idx_finish_time)"
+        << " WHERE finish_time > (UTC_TIMESTAMP() - INTERVAL " << longest << " SECOND)"
+        << "    AND file_state <> 'NOT_USED'"
+        << " GROUP BY source_se, dest_se"
+        << " ORDER BY NULL";
+
+    soci::rowset<soci::row> rs = (sql.prepare << query.str());
+    for (auto i = rs.begin(); i != rs.end(); ++i) {
+        auto entry = pairs.find(Pair(i->get<std::string>("source_se"), i->get<std::string>("dest_se")));
+        if (entry == pairs.end()) {
+            continue;
+        }
+
+        for (size_t w = 0; w < windows.size(); ++w) {
+            const std::string suffix = std::to_string(w);
+            SuccessCounters &counters = entry->second.success[windows[w]];
+            counters.nFinished = i->get<long long>("finished_" + suffix, 0);
+            counters.nFailed = i->get<long long>("failed_" + suffix, 0);
+            counters.nRetries = i->get<long long>("retries_" + suffix, 0);
+        }
+        entry->second.avgDuration = i->get<double>("avg_duration", 0.0);
+    }
+
+    // Pairs without terminal transfers
+    for (auto entry = pairs.begin(); entry != pairs.end(); ++entry) {
+        for (auto w = windows.begin(); w != windows.end(); ++w) {
+            entry->second.success[*w];
+        }
+    }
+}
+
+
+// Throughput and file size statistics for each time frame, from a single pass over the active
+// transfers and those finished within the longest time frame
+void MySqlOptimizerDataSource::prefetchThroughput(const std::vector<long> &windows)
+{
+    static struct tm nulltm = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+    const long longest = windows.back();
+    const time_t now = time(NULL);
+
+    for (auto entry = pairs.begin(); entry != pairs.end(); ++entry) {
+        for (auto w = windows.begin(); w != windows.end(); ++w) {
+            entry->second.throughput.insert(std::make_pair(*w, ThroughputAccumulator(now, now - *w)));
+        }
+    }
+
+    soci::rowset<soci::row> transfers = (sql.prepare <<
+        "SELECT source_se, dest_se, start_time, finish_time, transferred, filesize "
+        " FROM t_file "
+        " WHERE file_state = 'ACTIVE' "
+        "UNION ALL "
+        "SELECT source_se, dest_se, start_time, finish_time, transferred, filesize "
+        " FROM t_file USE INDEX(idx_finish_time)"
+        " WHERE "
+        "   file_state IN ('FINISHED', 'ARCHIVING') AND finish_time >= (UTC_TIMESTAMP() - INTERVAL :interval SECOND)",
+        soci::use(longest, "interval"));
+
+    for (auto j = transfers.begin(); j != transfers.end(); ++j) {
+        auto entry = pairs.find(Pair(j->get<std::string>("source_se"), j->get<std::string>("dest_se")));
+        if (entry == pairs.end()) {
+            continue;
+        }
+
+        auto starttm = j->get<struct tm>("start_time");
+        auto endtm = j->get<struct tm>("finish_time", nulltm);
+        auto transferred = j->get<long long>("transferred", 0.0);
+        auto filesize = j->get<long long>("filesize", 0.0);
+
+        struct tm endCopy = endtm;
+        time_t end = timegm(&endCopy);
+
+        for (auto w = entry->second.throughput.begin(); w != entry->second.throughput.end(); ++w) {
+            // Finished before this time frame
+            if (endtm.tm_year > 0 && end < w->second.getWindowStart()) {
+                continue;
+            }
+            w->second.add(starttm, endtm, transferred, filesize);
+        }
+    }
+}
+
+
 OptimizerDataSource *MySqlAPI::getOptimizerDataSource()
 {
     return new MySqlOptimizerDataSource(connectionPool);
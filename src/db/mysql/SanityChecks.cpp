@@ -89,6 +89,45 @@ void MySqlAPI::fixNonTerminalJob(soci::session &sql, const std::string &jobId,
 }
 
 
+/// Recount the files of the job into t_job_counters if the counters do not match stateCount,
+/// which must come from the same transaction
+void MySqlAPI::fixJobCounters(soci::session &sql, const std::string &jobId,
+    long long filesInJob, std::map<std::string, long long> &stateCount)
+{
+    int files = 0, submitted = 0, staging = 0, archiving = 0, finished = 0, failed = 0, canceled = 0;
+    sql << "SELECT files, submitted, staging, archiving, finished, failed, canceled "
+        "FROM t_job_counters WHERE job_id = :jobId",
+        soci::use(jobId),
+        soci::into(files), soci::into(submitted), soci::into(staging), soci::into(archiving),
+        soci::into(finished), soci::into(failed), soci::into(canceled);
+
+    if (sql.got_data() &&
+        files == filesInJob &&
+        submitted == stateCount["SUBMITTED"] &&
+        staging == stateCount["STAGING"] + stateCount["STARTED"] &&
+        archiving == stateCount["ARCHIVING"] &&
+        finished == stateCount["FINISHED"] &&
+        failed == stateCount["FAILED"] &&
+        canceled == stateCount["CANCELED"]) {
+        return;
+    }
+
+    // Locking read, so transitions committed meanwhile are not lost
+    sql << "INSERT INTO t_job_counters (job_id, files, submitted, staging, archiving, finished, failed, canceled) "
+        "SELECT job_id, COUNT(*), SUM(file_state = 'SUBMITTED'), SUM(file_state IN ('STAGING', 'STARTED')), "
+        "   SUM(file_state = 'ARCHIVING'), SUM(file_state = 'FINISHED'), SUM(file_state = 'FAILED'), "
+        "   SUM(file_state = 'CANCELED') "
+        "FROM t_file WHERE job_id = :jobId GROUP BY job_id "
+        "ON DUPLICATE KEY UPDATE "
+        "   files = VALUES(files), submitted = VALUES(submitted), staging = VALUES(staging), "
+        "   archiving = VALUES(archiving), finished = VALUES(finished), failed = VALUES(failed), "
+        "   canceled = VALUES(canceled)",
+        soci::use(jobId);
+
+    logInconsistency(jobId, "The file counters did not match the files of the job");
+}
+
+
 /// Search for jobs in non terminal state for which all transfers are in terminal
 void MySqlAPI::fixJobNonTerminallAllFilesTerminal(soci::session &sql)
 {
@@ -126,6 +165,11 @@ void MySqlAPI::fixJobNonTerminallAllFilesTerminal(soci::session &sql)
             filesInJob += count;
         }
 
+        // Only these are resolved from the counters, see getJobFileCounters
+        if (jobType == Job::kTypeRegular || jobType == Job::kTypeSessionReuse) {
+            fixJobCounters(sql, jobId, filesInJob, stateCount);
+        }
+
         // Fix empty jobs
         if (filesInJob == 0) {
             fixEmptyJob(sql, jobId);
@@ -256,24 +300,32 @@ void MySqlAPI::recoverFromDeadHosts(soci::session &sql)
                 "   AND transfer_host = :transferHost ",
                 soci::use(deadHost)
         );
+        const std::string errorMessage = "Transfer has been forced-canceled because host " + deadHost +
+                                         " is offline and the transfer is still assigned to it";
+
+        std::vector<TerminalTransition> transitions;
         for (auto active = transfersActiveInHost.begin(); active != transfersActiveInHost.end(); ++active) {
             uint64_t fileId = active->get<unsigned long long>("file_id");
             const std::string jobId = active->get<std::string>("job_id");
-            const std::string errorMessage = "Transfer has been forced-canceled because host " + deadHost +
-                                             " is offline and the transfer is still assigned to it";
 
-            updateFileTransferStatusInternal(sql, 0.0, jobId, fileId, "CANCELED", errorMessage, 0, 0, 0, false);
-            updateJobTransferStatusInternal(sql, jobId, "CANCELED");
+            transitions.emplace_back(jobId, fileId, "CANCELED", errorMessage);
 
             FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Canceling assigned transfer " << jobId << " / " << fileId
                << commit;
+        }
 
-            //send state monitoring message for the state transition
-            const std::vector<TransferState> files = getStateOfTransferInternal(sql, jobId, fileId);
-            for (auto it = files.begin(); it != files.end(); ++it) {
-                TransferState tmp = (*it);
-                MsgIfce::getInstance()->SendTransferStatusChange(producer, tmp);
-            }
+        if (transitions.empty()) {
+            continue;
+        }
+
+        std::vector<TransferState> states;
+        sql.begin();
+        terminateTransfersInternal(sql, transitions, states);
+        sql.commit();
+
+        //send state monitoring message for the state transition
+        for (auto it = states.begin(); it != states.end(); ++it) {
+            MsgIfce::getInstance()->SendTransferStatusChange(producer, *it);
         }
     }
 }
@@ -0,0 +1,73 @@
+--
+-- FTS3 Schema 8.3.0
+-- Per job file counters, kept up to date by triggers on "t_file"
+--
+
+CREATE TABLE `t_job_counters` (
+  `job_id` char(36) NOT NULL,
+  `files` int NOT NULL DEFAULT '0',
+  `submitted` int NOT NULL DEFAULT '0',
+  `staging` int NOT NULL DEFAULT '0',
+  `archiving` int NOT NULL DEFAULT '0',
+  `finished` int NOT NULL DEFAULT '0',
+  `failed` int NOT NULL DEFAULT '0',
+  `canceled` int NOT NULL DEFAULT '0',
+  PRIMARY KEY (`job_id`),
+  CONSTRAINT `t_job_counters_fk` FOREIGN KEY (`job_id`) REFERENCES `t_job` (`job_id`) ON DELETE CASCADE ON UPDATE RESTRICT
+) ENGINE=InnoDB DEFAULT CHARSET=latin1;
+
+DELIMITER ;;
+CREATE TRIGGER `t_file_counters_insert` AFTER INSERT ON `t_file` FOR EACH ROW
+BEGIN
+  INSERT INTO t_job_counters (job_id, files, submitted, staging, archiving, finished, failed, canceled)
+  VALUES (NEW.job_id, 1, NEW.file_state = 'SUBMITTED', NEW.file_state IN ('STAGING', 'STARTED'),
+    NEW.file_state = 'ARCHIVING', NEW.file_state = 'FINISHED', NEW.file_state = 'FAILED',
+    NEW.file_state = 'CANCELED')
+  ON DUPLICATE KEY UPDATE
+    files = files + 1,
+    submitted = submitted + VALUES(submitted),
+    staging = staging + VALUES(staging),
+    archiving = archiving + VALUES(archiving),
+    finished = finished + VALUES(finished),
+    failed = failed + VALUES(failed),
+    canceled = canceled + VALUES(canceled);
+END ;;
+CREATE TRIGGER `t_file_counters_update` AFTER UPDATE ON `t_file` FOR EACH ROW
+BEGIN
+  IF NEW.file_state <> OLD.file_state THEN
+    UPDATE t_job_counters SET
+      submitted = submitted + (NEW.file_state = 'SUBMITTED') - (OLD.file_state = 'SUBMITTED'),
+      staging = staging + (NEW.file_state IN ('STAGING', 'STARTED')) - (OLD.file_state IN ('STAGING', 'STARTED')),
+      archiving = archiving + (NEW.file_state = 'ARCHIVING') - (OLD.file_state = 'ARCHIVING'),
+      finished = finished + (NEW.file_state = 'FINISHED') - (OLD.file_state = 'FINISHED'),
+      failed = failed + (NEW.file_state = 'FAILED') - (OLD.file_state = 'FAILED'),
+      canceled = canceled + (NEW.file_state = 'CANCELED') - (OLD.file_state = 'CANCELED')
+    WHERE job_id = NEW.job_id;
+  END IF;
+END ;;
+CREATE TRIGGER `t_file_counters_delete` AFTER DELETE ON `t_file` FOR EACH ROW
+BEGIN
+  UPDATE t_job_counters SET
+    files = files - 1,
+    submitted = submitted - (OLD.file_state = 'SUBMITTED'),
+    staging = staging - (OLD.file_state IN ('STAGING', 'STARTED')),
+    archiving = archiving - (OLD.file_state = 'ARCHIVING'),
+    finished = finished - (OLD.file_state = 'FINISHED'),
+    failed = failed - (OLD.file_state = 'FAILED'),
+    canceled = canceled - (OLD.file_state = 'CANCELED')
+  WHERE job_id = OLD.job_id;
+END ;;
+DELIMITER ;
+
+-- Jobs submitted before the triggers existed. The sanity checks fix the
+-- ones that changed while this runs
+INSERT IGNORE INTO t_job_counters (job_id, files, submitted, staging, archiving, finished, failed, canceled)
+  SELECT f.job_id, COUNT(*), SUM(f.file_state = 'SUBMITTED'), SUM(f.file_state IN ('STAGING', 'STARTED')),
+    SUM(f.file_state = 'ARCHIVING'), SUM(f.file_state = 'FINISHED'), SUM(f.file_state = 'FAILED'),
+    SUM(f.file_state = 'CANCELED')
+  FROM t_file f INNER JOIN t_job j ON (f.job_id = j.job_id)
+  WHERE j.job_finished IS NULL
+  GROUP BY f.job_id;
+
+INSERT INTO t_schema_vers (major, minor, patch, message)
+VALUES (8, 3, 0, 'Per job file counters');
@@ -0,0 +1,13 @@
+--
+-- Script to downgrade from FTS3 Schema 8.3.0 to the previous schema (8.2.0)
+--
+
+DROP TRIGGER IF EXISTS `t_file_counters_insert`;
+DROP TRIGGER IF EXISTS `t_file_counters_update`;
+DROP TRIGGER IF EXISTS `t_file_counters_delete`;
+
+DROP TABLE IF EXISTS `t_job_counters`;
+
+-- Update schema version number
+DELETE FROM t_schema_vers WHERE major = 8 AND minor = 3 AND patch = 0;
+UPDATE t_schema_vers SET message = 'Downgrade from 8.3.0' WHERE major = 8 AND minor = 2 AND patch = 0;
@@ -346,6 +346,10 @@ std::string MsgIfce::SendOptimizer(Producer &producer, const OptimizerInfo &opt_
     message["connections"] = json::Number(opt_info.connections);
     message["rationale"] = json::String(opt_info.rationale);
 
+    message["circuit_breaker"] = json::String(opt_info.circuitBreaker);
+    message["link_error_rate"] = json::Number(opt_info.linkErrorRate);
+    message["circuit_retry_at"] = json::Number(opt_info.circuitRetryAt);
+
     std::ostringstream stream;
 
     stream << "OP ";
@@ -150,6 +150,11 @@ public:
     int connections;
 
     std::string rationale;
+
+    // Link circuit breaker, see LinkCircuitBreaker
+    std::string circuitBreaker;
+    double linkErrorRate;
+    time_t circuitRetryAt;
 };
 
 class MsgIfce
@@ -0,0 +1,538 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SegmentQueue.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+
+#include "common/Exceptions.h"
+#include "common/Logger.h"
+
+namespace fs = boost::filesystem;
+
+
+static const uint32_t FRAME_MAGIC = 0x46545333; // "FTS3"
+static const size_t FRAME_HEADER_SIZE = 12;
+static const uint32_t FRAME_MAX_PAYLOAD = 64 * 1024 * 1024;
+static const size_t READ_CHUNK_SIZE = 1024 * 1024;
+static const char SEGMENT_SUFFIX[] = ".seg";
+
+
+static void throwErrno(const std::string &what, const std::string &path, int errnum)
+{
+    char buffer[128] = {0};
+    std::ostringstream msg;
+    msg << what << " " << path << " (" << strerror_r(errnum, buffer, sizeof(buffer)) << ")";
+    throw fts3::common::SystemError(msg.str());
+}
+
+
+static void encodeUint32(char *buffer, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        buffer[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+
+static uint32_t decodeUint32(const char *buffer)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(buffer[i])) << (8 * i);
+    }
+    return value;
+}
+
+
+static uint32_t checksum(const char *data, size_t length)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(data, length);
+    return crc.checksum();
+}
+
+
+enum FrameStatus {
+    FRAME_OK,
+    FRAME_INCOMPLETE,
+    FRAME_CORRUPTED
+};
+
+
+/// Validate the frame starting at buffer[pos]
+static FrameStatus checkFrame(const std::string &buffer, size_t pos, uint32_t *length)
+{
+    if (buffer.size() - pos < FRAME_HEADER_SIZE) {
+        return FRAME_INCOMPLETE;
+    }
+    const char *header = buffer.data() + pos;
+    if (decodeUint32(header) != FRAME_MAGIC) {
+        return FRAME_CORRUPTED;
+    }
+    *length = decodeUint32(header + 4);
+    if (*length > FRAME_MAX_PAYLOAD) {
+        return FRAME_CORRUPTED;
+    }
+    if (buffer.size() - pos - FRAME_HEADER_SIZE < *length) {
+        return FRAME_INCOMPLETE;
+    }
+    if (checksum(header + FRAME_HEADER_SIZE, *length) != decodeUint32(header + 8)) {
+        return FRAME_CORRUPTED;
+    }
+    return FRAME_OK;
+}
+
+
+/// Find the next frame after a corrupted one
+/// @return The position of the next candidate frame, or where to continue looking if there is none
+static size_t resync(const std::string &buffer, size_t pos, bool atEnd)
+{
+    char magic[4];
+    encodeUint32(magic, FRAME_MAGIC);
+
+    for (size_t next = buffer.find(magic, pos + 1, 4); next != std::string::npos;
+         next = buffer.find(magic, next + 1, 4)) {
+        uint32_t length;
+        if (checkFrame(buffer, next, &length) != FRAME_CORRUPTED) {
+            return next;
+        }
+    }
+
+    // The last bytes may be the beginning of the magic of a frame not read yet
+    if (atEnd || buffer.size() < pos + 4) {
+        return buffer.size();
+    }
+    return std::max(pos + 1, buffer.size() - 3);
+}
+
+
+/// Holds a flock for the lifetime of the object
+class FileLock {
+public:
+    FileLock(int fd, int operation, const std::string &path): fd(fd) {
+        while (flock(fd, operation) < 0) {
+            if (errno != EINTR) {
+                throwErrno("Could not lock", path, errno);
+            }
+        }
+    }
+
+    ~FileLock() {
+        flock(fd, LOCK_UN);
+    }
+
+private:
+    int fd;
+};
+
+
+SegmentQueue::SegmentQueue(const std::string &path, const std::string &consumer, uint64_t segmentSize):
+    path(path), consumer(consumer), segmentSize(segmentSize), lockFd(-1),
+    writeSeq(0), writeFd(-1), offsetLoaded(false), readSeq(0), readPos(0),
+    committedSeq(0), committedPos(0)
+{
+    boost::system::error_code error;
+    fs::create_directories(path, error);
+    if (error) {
+        throw fts3::common::SystemError("Could not create segment queue " + path + " (" + error.message() + ")");
+    }
+
+    std::string lockPath = path + "/.lock";
+    lockFd = open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (lockFd < 0) {
+        throwErrno("Could not open", lockPath, errno);
+    }
+}
+
+
+SegmentQueue::~SegmentQueue()
+{
+    if (writeFd >= 0) {
+        close(writeFd);
+    }
+    if (lockFd >= 0) {
+        close(lockFd);
+    }
+}
+
+
+std::string SegmentQueue::segmentPath(uint64_t seq) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%020llu%s", static_cast<unsigned long long>(seq), SEGMENT_SUFFIX);
+    return path + "/" + name;
+}
+
+
+std::string SegmentQueue::offsetPath(const std::string &consumerName) const
+{
+    return path + "/.offset." + consumerName;
+}
+
+
+/// The head (last segment) is kept in the lock file, so it is known without listing the directory
+/// Must be called with the lock held
+uint64_t SegmentQueue::readHead()
+{
+    char buffer[8];
+    ssize_t nread = pread(lockFd, buffer, sizeof(buffer), 0);
+    if (nread < 0) {
+        throwErrno("Could not read the head of", path, errno);
+    }
+    if (nread != sizeof(buffer)) {
+        // First use, or lock file lost: recover the head from the existing segments
+        std::vector<uint64_t> segments = listSegments();
+        return segments.empty() ? 0 : segments.back();
+    }
+    return static_cast<uint64_t>(decodeUint32(buffer)) |
+        (static_cast<uint64_t>(decodeUint32(buffer + 4)) << 32);
+}
+
+
+/// Must be called with the exclusive lock held
+void SegmentQueue::writeHead(uint64_t seq)
+{
+    char buffer[8];
+    encodeUint32(buffer, static_cast<uint32_t>(seq & 0xFFFFFFFF));
+    encodeUint32(buffer + 4, static_cast<uint32_t>(seq >> 32));
+    if (pwrite(lockFd, buffer, sizeof(buffer), 0) != sizeof(buffer)) {
+        throwErrno("Could not write the head of", path, errno);
+    }
+}
+
+
+std::vector<uint64_t> SegmentQueue::listSegments() const
+{
+    std::vector<uint64_t> segments;
+    for (fs::directory_iterator i(path); i != fs::directory_iterator(); ++i) {
+        const std::string name = i->path().filename().string();
+        if (name.size() > sizeof(SEGMENT_SUFFIX) - 1 &&
+            name.compare(name.size() - sizeof(SEGMENT_SUFFIX) + 1, std::string::npos, SEGMENT_SUFFIX) == 0) {
+            segments.push_back(strtoull(name.c_str(), NULL, 10));
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+
+void SegmentQueue::append(const std::string &payload)
+{
+    if (payload.size() > FRAME_MAX_PAYLOAD) {
+        throw fts3::common::SystemError("Message too big for the segment queue " + path);
+    }
+
+    std::string frame(FRAME_HEADER_SIZE, '\0');
+    encodeUint32(&frame[0], FRAME_MAGIC);
+    encodeUint32(&frame[4], static_cast<uint32_t>(payload.size()));
+    encodeUint32(&frame[8], checksum(payload.data(), payload.size()));
+    frame.append(payload);
+
+    FileLock lock(lockFd, LOCK_EX, path);
+
+    uint64_t head = readHead();
+    if (writeFd < 0 || writeSeq != head) {
+        if (writeFd >= 0) {
+            close(writeFd);
+        }
+        writeSeq = head;
+        std::string segment = segmentPath(writeSeq);
+        writeFd = open(segment.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (writeFd < 0) {
+            throwErrno("Could not open", segment, errno);
+        }
+        writeHead(writeSeq);
+    }
+
+    struct stat st;
+    if (fstat(writeFd, &st) < 0) {
+        throwErrno("Could not stat", segmentPath(writeSeq), errno);
+    }
+
+    // Roll to a new segment
+    if (static_cast<uint64_t>(st.st_size) >= segmentSize) {
+        close(writeFd);
+        ++writeSeq;
+        std::string segment = segmentPath(writeSeq);
+        writeFd = open(segment.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (writeFd < 0) {
+            throwErrno("Could not open", segment, errno);
+        }
+        writeHead(writeSeq);
+        st.st_size = 0;
+    }
+
+    ssize_t written;
+    do {
+        written = write(writeFd, frame.data(), frame.size());
+    } while (written < 0 && errno == EINTR);
+
+    if (written != static_cast<ssize_t>(frame.size())) {
+        int errnum = (written < 0) ? errno : ENOSPC;
+        // Do not leave half a frame behind
+        if (ftruncate(writeFd, st.st_size) < 0) {
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Could not remove partial frame from " << segmentPath(writeSeq)
+                << fts3::common::commit;
+        }
+        throwErrno("Could not append to", segmentPath(writeSeq), errnum);
+    }
+}
+
+
+void SegmentQueue::loadOffset()
+{
+    std::string offsetFile = offsetPath(consumer);
+    FILE *fd = fopen(offsetFile.c_str(), "r");
+    if (fd) {
+        unsigned long long seq = 0, pos = 0;
+        int nread = fscanf(fd, "%llu %llu", &seq, &pos);
+        fclose(fd);
+        if (nread == 2) {
+            readSeq = committedSeq = seq;
+            readPos = committedPos = pos;
+            offsetLoaded = true;
+            return;
+        }
+        FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Invalid offset file " << offsetFile
+            << ", starting from the oldest segment" << fts3::common::commit;
+    }
+
+    // New consumer, start from the oldest segment still there
+    std::vector<uint64_t> segments = listSegments();
+    readSeq = committedSeq = segments.empty() ? 0 : segments.front();
+    readPos = committedPos = 0;
+    offsetLoaded = true;
+}
+
+
+/// The new offset is written into a temporary file, and renamed over the previous one,
+/// so a crash leaves either the old or the new offset, never a mix
+void SegmentQueue::commitOffset()
+{
+    std::string offsetFile = offsetPath(consumer);
+    std::string tmpFile = offsetFile + ".tmp";
+
+    FILE *fd = fopen(tmpFile.c_str(), "w");
+    if (!fd) {
+        throwErrno("Could not open", tmpFile, errno);
+    }
+    fprintf(fd, "%llu %llu\n", static_cast<unsigned long long>(readSeq), static_cast<unsigned long long>(readPos));
+    if (fclose(fd) != 0) {
+        throwErrno("Could not write", tmpFile, errno);
+    }
+    if (rename(tmpFile.c_str(), offsetFile.c_str()) < 0) {
+        throwErrno("Could not commit", offsetFile, errno);
+    }
+}
+
+
+unsigned SegmentQueue::consumeSegment(uint64_t head, unsigned limit, std::vector<std::string> &payloads,
+    bool *exhausted)
+{
+    *exhausted = false;
+
+    std::string segment = segmentPath(readSeq);
+    int fd = open(segment.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            *exhausted = true;
+            return 0;
+        }
+        throwErrno("Could not open", segment, errno);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        int errnum = errno;
+        close(fd);
+        throwErrno("Could not stat", segment, errnum);
+    }
+    const uint64_t size = st.st_size;
+
+    unsigned count = 0;
+    size_t wanted = READ_CHUNK_SIZE;
+    std::string buffer;
+
+    while (count < limit) {
+        if (readPos >= size) {
+            *exhausted = true;
+            break;
+        }
+
+        buffer.resize(std::min<uint64_t>(size - readPos, std::max(READ_CHUNK_SIZE, wanted)));
+        size_t total = 0;
+        while (total < buffer.size()) {
+            ssize_t nread = pread(fd, &buffer[total], buffer.size() - total, readPos + total);
+            if (nread < 0 && errno == EINTR) {
+                continue;
+            }
+            if (nread <= 0) {
+                int errnum = (nread < 0) ? errno : EIO;
+                close(fd);
+                throwErrno("Could not read", segment, errnum);
+            }
+            total += nread;
+        }
+
+        const bool atEnd = (readPos + buffer.size() == size);
+        bool truncated = false;
+        size_t pos = 0;
+        wanted = READ_CHUNK_SIZE;
+
+        while (count < limit) {
+            uint32_t length = 0;
+            FrameStatus status = checkFrame(buffer, pos, &length);
+
+            if (status == FRAME_OK) {
+                payloads.emplace_back(buffer, pos + FRAME_HEADER_SIZE, length);
+                pos += FRAME_HEADER_SIZE + length;
+                ++count;
+            }
+            else if (status == FRAME_INCOMPLETE && !atEnd) {
+                // Read again from here, with enough room for the whole frame
+                if (buffer.size() - pos >= FRAME_HEADER_SIZE) {
+                    wanted = FRAME_HEADER_SIZE + length;
+                }
+                break;
+            }
+            else if (status == FRAME_INCOMPLETE) {
+                // Producers are locked out, so nothing is going to complete this frame.
+                // If a frame follows, the producers moved on after a torn write: skip it
+                size_t next = resync(buffer, pos, atEnd);
+                if (next < buffer.size()) {
+                    FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Torn frame in " << segment
+                        << " at " << readPos + pos << ", skipping" << fts3::common::commit;
+                    pos = next;
+                    continue;
+                }
+                truncated = (pos < buffer.size());
+                break;
+            }
+            else {
+                FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Corrupted frame in " << segment
+                    << " at " << readPos + pos << ", skipping" << fts3::common::commit;
+                pos = resync(buffer, pos, atEnd);
+            }
+        }
+        readPos += pos;
+
+        if (truncated) {
+            // Producers are locked out, so this is a frame cut by a crash.
+            // If the segment is not the last one, nothing will be appended after it
+            if (readSeq < head) {
+                FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Discarding " << size - readPos
+                    << " trailing bytes from " << segment << fts3::common::commit;
+                *exhausted = true;
+            }
+            break;
+        }
+    }
+
+    close(fd);
+    return count;
+}
+
+
+void SegmentQueue::consume(unsigned limit, std::vector<std::string> &payloads)
+{
+    // Producers can not write while we hold the lock, so a frame incomplete at the end
+    // of a segment is a leftover from a crash, not a write in progress
+    FileLock lock(lockFd, LOCK_SH, path);
+
+    if (!offsetLoaded) {
+        loadOffset();
+    }
+
+    const uint64_t head = readHead();
+    unsigned count = 0;
+
+    while (count < limit) {
+        bool exhausted = false;
+        count += consumeSegment(head, limit - count, payloads, &exhausted);
+
+        if (exhausted && readSeq < head) {
+            ++readSeq;
+            readPos = 0;
+        }
+        else {
+            break;
+        }
+    }
+}
+
+
+void SegmentQueue::commit()
+{
+    if (!offsetLoaded || (readSeq == committedSeq && readPos == committedPos)) {
+        return;
+    }
+    commitOffset();
+    committedSeq = readSeq;
+    committedPos = readPos;
+}
+
+
+void SegmentQueue::purge()
+{
+    FileLock lock(lockFd, LOCK_EX, path);
+
+    uint64_t head = readHead();
+    uint64_t minSeq = head;
+    bool anyConsumer = false;
+
+    for (fs::directory_iterator i(path); i != fs::directory_iterator(); ++i) {
+        const std::string name = i->path().filename().string();
+        if (name.compare(0, 8, ".offset.") != 0 || name.find(".tmp") != std::string::npos) {
+            continue;
+        }
+        FILE *fd = fopen(i->path().string().c_str(), "r");
+        if (!fd) {
+            continue;
+        }
+        unsigned long long seq = 0, pos = 0;
+        if (fscanf(fd, "%llu %llu", &seq, &pos) == 2) {
+            minSeq = std::min<uint64_t>(minSeq, seq);
+            anyConsumer = true;
+        }
+        fclose(fd);
+    }
+
+    if (!anyConsumer) {
+        return;
+    }
+
+    std::vector<uint64_t> segments = listSegments();
+    for (auto seq = segments.begin(); seq != segments.end() && *seq < minSeq; ++seq) {
+        std::string segment = segmentPath(*seq);
+        if (unlink(segment.c_str()) < 0 && errno != ENOENT) {
+            char buffer[128] = {0};
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Could not purge " << segment << " ("
+                << strerror_r(errno, buffer, sizeof(buffer)) << ")" << fts3::common::commit;
+        }
+    }
+}
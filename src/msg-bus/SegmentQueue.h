@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef SEGMENTQUEUE_H
+#define SEGMENTQUEUE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/// Message queue stored as a sequence of append-only segment files.
+///
+/// Each message is written as a single frame
+///     [magic:4][length:4][crc32:4][payload:length]
+/// with a single write(2), while holding an exclusive lock on the queue, so several
+/// processes can produce into the same queue.
+/// Each consumer keeps its own commit offset (segment, position), replaced atomically
+/// when the consumer commits what it has processed. Messages read but not committed are
+/// delivered again after a restart, so delivery is at-least-once.
+/// A torn frame left by a crash is detected by its checksum, or by a length running past
+/// the frames written after it, and skipped by looking for the next valid frame.
+class SegmentQueue {
+public:
+    /// Default size after which producers roll to a new segment
+    static const uint64_t DEFAULT_SEGMENT_SIZE = 16 * 1024 * 1024;
+
+    /// Constructor
+    /// @param path         Directory of the queue. Created if it does not exist
+    /// @param consumer     Name of the consumer, used to store the commit offset
+    /// @param segmentSize  Size after which a new segment is started
+    SegmentQueue(const std::string &path, const std::string &consumer = "default",
+        uint64_t segmentSize = DEFAULT_SEGMENT_SIZE);
+
+    ~SegmentQueue();
+
+    SegmentQueue(const SegmentQueue&) = delete;
+    SegmentQueue& operator = (const SegmentQueue&) = delete;
+
+    /// Append a message to the queue
+    /// @throws SystemError If the message could not be written. Nothing is left in the segment then
+    void append(const std::string &payload);
+
+    /// Read up to limit messages after the last message read by this consumer.
+    /// The commit offset is not moved until commit is called
+    /// @throws SystemError If the queue could not be read
+    void consume(unsigned limit, std::vector<std::string> &payloads);
+
+    /// Store the position after the last message read as the commit offset of this consumer.
+    /// To be called once the messages have been processed
+    /// @throws SystemError If the offset could not be written
+    void commit();
+
+    /// Remove the segments already consumed by all the known consumers
+    void purge();
+
+    const std::string &getPath(void) const {
+        return path;
+    }
+
+private:
+    std::string path;
+    std::string consumer;
+    uint64_t segmentSize;
+
+    int lockFd;
+
+    // Segment currently open for writing
+    uint64_t writeSeq;
+    int writeFd;
+
+    // Read position and commit offset of this consumer
+    bool offsetLoaded;
+    uint64_t readSeq;
+    uint64_t readPos;
+    uint64_t committedSeq;
+    uint64_t committedPos;
+
+    std::string segmentPath(uint64_t seq) const;
+    std::string offsetPath(const std::string &consumerName) const;
+
+    uint64_t readHead();
+    void writeHead(uint64_t seq);
+
+    std::vector<uint64_t> listSegments() const;
+
+    void loadOffset();
+    void commitOffset();
+
+    unsigned consumeSegment(uint64_t head, unsigned limit, std::vector<std::string> &payloads, bool *exhausted);
+};
+
+#endif // SEGMENTQUEUE_H
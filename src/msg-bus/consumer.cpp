@@ -18,17 +18,33 @@
  * limitations under the License.
  */
 
-#include <fstream>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/thread.hpp>
+
 #include "common/Logger.h"
 #include "consumer.h"
 #include "DirQ.h"
+#include "SegmentQueue.h"
 
 
 Consumer::Consumer(const std::string &baseDir, unsigned limit):
-    baseDir(baseDir), limit(limit),
+    baseDir(baseDir), limit(limit), parseThreads(1),
     monitoringQueue(new DirQ(baseDir + "/monitoring")), statusQueue(new DirQ(baseDir + "/status")),
     stalledQueue(new DirQ(baseDir + "/stalled")), logQueue(new DirQ(baseDir + "/logs")),
-    stagingQueue(new DirQ(baseDir + "/staging")), deletionQueue(new DirQ(baseDir + "/deletion"))
+    stagingQueue(new DirQ(baseDir + "/staging")), deletionQueue(new DirQ(baseDir + "/deletion")),
+    monitoringSegments(new SegmentQueue(baseDir + "/segments/monitoring")),
+    statusSegments(new SegmentQueue(baseDir + "/segments/status")),
+    stalledSegments(new SegmentQueue(baseDir + "/segments/stalled")),
+    logSegments(new SegmentQueue(baseDir + "/segments/logs")),
+    stagingSegments(new SegmentQueue(baseDir + "/segments/staging")),
+    deletionSegments(new SegmentQueue(baseDir + "/segments/deletion"))
 {
 }
 
@@ -38,36 +54,107 @@ Consumer::~Consumer()
 }
 
 
-template <typename MSG>
-static int genericConsumer(std::unique_ptr<DirQ> &dirq, unsigned limit, std::vector<MSG> &messages)
+void Consumer::setParseThreads(unsigned threads)
+{
+    parseThreads = std::max(1u, threads);
+}
+
+
+/// Read up to limit serialized messages from the segment queue.
+/// The caller comes back for more only once it is done with the previous batch,
+/// so that is when the previous batch is committed
+static int segmentConsumer(std::unique_ptr<SegmentQueue> &segments, unsigned limit,
+    std::vector<std::string> &payloads)
 {
-    MSG event;
+    try {
+        segments->commit();
+        segments->consume(limit, payloads);
+    }
+    catch (const std::exception &ex) {
+        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Failed to consume messages: " << ex.what() << fts3::common::commit;
+        return -1;
+    }
+    return 0;
+}
+
+
+/// Position of a message within the read buffer
+typedef std::pair<size_t, size_t> Slice;
+
+/// Below this, parsing in several threads costs more than it saves
+static const size_t MIN_MESSAGES_PER_PARSER = 512;
+
 
+/// Append the content of the file to the buffer
+static bool readEntry(const char *path, std::string &buffer, Slice &slice)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return false;
+    }
+
+    slice.first = buffer.size();
+    buffer.resize(slice.first + st.st_size);
+
+    size_t done = 0;
+    while (done < static_cast<size_t>(st.st_size)) {
+        ssize_t nread = pread(fd, &buffer[slice.first + done], st.st_size - done, done);
+        if (nread < 0 && errno == EINTR) {
+            continue;
+        }
+        if (nread <= 0) {
+            break;
+        }
+        done += nread;
+    }
+    close(fd);
+
+    slice.second = done;
+    buffer.resize(slice.first + done);
+    return done == static_cast<size_t>(st.st_size);
+}
+
+
+/// Read up to limit entries from the dirq into the buffer, and remove them once all have been read.
+/// Entries that could not be read are unlocked and left in the queue
+/// @param iterated Set to the number of entries looked at, including those locked by someone else
+static int dirqConsumer(std::unique_ptr<DirQ> &dirq, unsigned limit, std::string &buffer,
+    std::vector<Slice> &slices, unsigned &iterated)
+{
+    std::vector<std::string> consumed;
     const char *error = NULL;
     dirq_clear_error(*dirq);
 
-    unsigned i = 0;
-    for (auto iter = dirq_first(*dirq); iter != NULL && i < limit; iter = dirq_next(*dirq), ++i) {
+    buffer.clear();
+    iterated = 0;
+    for (auto iter = dirq_first(*dirq); iter != NULL && iterated < limit; iter = dirq_next(*dirq), ++iterated) {
         if (dirq_lock(*dirq, iter, 0) == 0) {
             const char *path = dirq_get_path(*dirq, iter);
 
-            try {
-                std::ifstream fstream(path);
-                event.ParseFromIstream(&fstream);
+            Slice slice;
+            if (readEntry(path, buffer, slice)) {
+                slices.push_back(slice);
+                consumed.emplace_back(iter);
             }
-            catch (const std::exception &ex) {
+            else {
+                // Leave it in the queue, so the next pass tries again
+                char errbuf[128] = {0};
                 FTS3_COMMON_LOGGER_NEWLOG(ERR)
-                    << "Could not load message from " << path << " (" << ex.what() << ")"
+                    << "Could not load message from " << path << " (" << strerror_r(errno, errbuf, sizeof(errbuf)) << ")"
                     << fts3::common::commit;
-            }
-
-            messages.emplace_back(event);
-            if (dirq_remove(*dirq, iter) < 0) {
-                error = dirq_get_errstr(*dirq);
-                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Failed to remove message from queue (" << path << "): "
-                    << error
-                    << fts3::common::commit;
-                dirq_clear_error(*dirq);
+                if (dirq_unlock(*dirq, iter, 0) < 0) {
+                    FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Failed to unlock message ("
+                        << dirq_get_path(*dirq, iter) << "): "
+                        << dirq_get_errstr(*dirq)
+                        << fts3::common::commit;
+                    dirq_clear_error(*dirq);
+                }
             }
         }
     }
@@ -75,118 +162,155 @@ static int genericConsumer(std::unique_ptr<DirQ> &dirq, unsigned limit, std::vec
     error = dirq_get_errstr(*dirq);
     if (error) {
         FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Failed to consume messages: " << error << fts3::common::commit;
-        return -1;
     }
 
-    return 0;
+    // The content is in memory, so the entries can go
+    for (auto name = consumed.begin(); name != consumed.end(); ++name) {
+        if (dirq_remove(*dirq, name->c_str()) < 0) {
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Failed to remove message from queue ("
+                << dirq_get_path(*dirq, name->c_str()) << "): "
+                << dirq_get_errstr(*dirq)
+                << fts3::common::commit;
+            dirq_clear_error(*dirq);
+        }
+    }
+
+    return error ? -1 : 0;
 }
 
 
-int Consumer::runConsumerStatus(std::vector<fts3::events::Message> &messages)
+/// Parse the messages held by the buffer, at the end of messages and in the same order.
+/// What can not be parsed is logged and skipped
+template <typename MSG>
+static void parseMessages(const std::string &buffer, const std::vector<Slice> &slices, unsigned parseThreads,
+    const std::string &queuePath, std::vector<MSG> &messages)
 {
-    return genericConsumer<fts3::events::Message>(statusQueue, limit, messages);
-}
+    const size_t base = messages.size();
+    messages.resize(base + slices.size());
+    std::vector<char> parsed(slices.size(), 0);
+
+    auto parseRange = [&buffer, &slices, &messages, &parsed, base](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            parsed[i] = messages[base + i].ParseFromArray(buffer.data() + slices[i].first,
+                static_cast<int>(slices[i].second));
+        }
+    };
 
+    size_t nParsers = std::min<size_t>(std::max(1u, parseThreads), slices.size() / MIN_MESSAGES_PER_PARSER);
+    if (nParsers <= 1) {
+        parseRange(0, slices.size());
+    }
+    else {
+        size_t chunk = (slices.size() + nParsers - 1) / nParsers;
+        boost::thread_group parsers;
+        for (size_t first = chunk; first < slices.size(); first += chunk) {
+            parsers.create_thread(std::bind(parseRange, first, std::min(first + chunk, slices.size())));
+        }
+        parseRange(0, chunk);
+        parsers.join_all();
+    }
 
-int Consumer::runConsumerStall(std::vector<fts3::events::MessageUpdater> &messages)
-{
-    return genericConsumer<fts3::events::MessageUpdater>(stalledQueue, limit, messages);
+    size_t kept = base;
+    for (size_t i = 0; i < slices.size(); ++i) {
+        if (!parsed[i]) {
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Could not parse message from " << queuePath
+                << fts3::common::commit;
+            continue;
+        }
+        if (kept != base + i) {
+            messages[kept].Swap(&messages[base + i]);
+        }
+        ++kept;
+    }
+    messages.resize(kept);
 }
 
 
-int Consumer::runConsumerLog(std::map<int, fts3::events::MessageLog> &messages)
+template <typename MSG>
+static int genericConsumer(std::unique_ptr<DirQ> &dirq, std::unique_ptr<SegmentQueue> &segments,
+    unsigned limit, unsigned parseThreads, std::string &buffer, std::vector<MSG> &messages)
 {
-    fts3::events::MessageLog buffer;
-
-    const char *error = NULL;
-    dirq_clear_error(*logQueue);
-
+    std::vector<Slice> slices;
     unsigned i = 0;
-    for (auto iter = dirq_first(*logQueue); iter != NULL && i < limit; iter = dirq_next(*logQueue), ++i) {
-        if (dirq_lock(*logQueue, iter, 0) == 0) {
-            const char *path = dirq_get_path(*logQueue, iter);
 
-            try {
-                std::ifstream fstream(path);
-                buffer.ParseFromIstream(&fstream);
-            }
-            catch (const std::exception &ex) {
-                FTS3_COMMON_LOGGER_NEWLOG(ERR)
-                << "Could not load message from " << path << " (" << ex.what() << ")"
-                << fts3::common::commit;
-            }
+    int ret = dirqConsumer(dirq, limit, buffer, slices, i);
+    parseMessages(buffer, slices, parseThreads, dirq->getPath(), messages);
+    if (ret != 0) {
+        return ret;
+    }
 
-            messages[buffer.file_id()] = buffer;
-            if (dirq_remove(*logQueue, iter) < 0) {
-                error = dirq_get_errstr(*logQueue);
-                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Failed to remove message from queue (" << path << "): "
-                    << error
+    if (i < limit) {
+        std::vector<std::string> payloads;
+        if (segmentConsumer(segments, limit - i, payloads) != 0) {
+            return -1;
+        }
+        for (auto payload = payloads.begin(); payload != payloads.end(); ++payload) {
+            messages.emplace_back();
+            if (!messages.back().ParseFromString(*payload)) {
+                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Could not parse message from " << segments->getPath()
                     << fts3::common::commit;
-                dirq_clear_error(*logQueue);
+                messages.pop_back();
             }
         }
     }
 
-    error = dirq_get_errstr(*logQueue);
-    if (error) {
-        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Failed to consume messages: " << error << fts3::common::commit;
-        return -1;
+    return 0;
+}
+
+
+int Consumer::runConsumerStatus(std::vector<fts3::events::Message> &messages)
+{
+    return genericConsumer<fts3::events::Message>(statusQueue, statusSegments, limit, parseThreads, readBuffer, messages);
+}
+
+
+int Consumer::runConsumerStall(std::vector<fts3::events::MessageUpdater> &messages)
+{
+    return genericConsumer<fts3::events::MessageUpdater>(stalledQueue, stalledSegments, limit, parseThreads, readBuffer, messages);
+}
+
+
+int Consumer::runConsumerLog(std::map<int, fts3::events::MessageLog> &messages)
+{
+    std::vector<fts3::events::MessageLog> logs;
+    int ret = genericConsumer<fts3::events::MessageLog>(logQueue, logSegments, limit, parseThreads, readBuffer, logs);
+
+    // Only the last log path of a file matters
+    for (auto log = logs.begin(); log != logs.end(); ++log) {
+        messages[log->file_id()].Swap(&(*log));
     }
 
-    return 0;
+    return ret;
 }
 
 
 int Consumer::runConsumerDeletions(std::vector<fts3::events::MessageBringonline> &messages)
 {
-    return genericConsumer<fts3::events::MessageBringonline>(deletionQueue, limit, messages);
+    return genericConsumer<fts3::events::MessageBringonline>(deletionQueue, deletionSegments, limit, parseThreads, readBuffer, messages);
 }
 
 
 int Consumer::runConsumerStaging(std::vector<fts3::events::MessageBringonline> &messages)
 {
-    return genericConsumer<fts3::events::MessageBringonline>(stagingQueue, limit, messages);
+    return genericConsumer<fts3::events::MessageBringonline>(stagingQueue, stagingSegments, limit, parseThreads, readBuffer, messages);
 }
 
 
 int Consumer::runConsumerMonitoring(std::vector<std::string> &messages)
 {
-    std::string content;
-
-    const char *error = NULL;
-    dirq_clear_error(*monitoringQueue);
-
+    std::vector<Slice> slices;
     unsigned i = 0;
-    for (auto iter = dirq_first(*monitoringQueue); iter != NULL && i < limit; iter = dirq_next(*monitoringQueue), ++i) {
-        if (dirq_lock(*monitoringQueue, iter, 0) == 0) {
-            const char *path = dirq_get_path(*monitoringQueue, iter);
-
-            try {
-                std::ifstream fstream(path);
-                content.assign((std::istreambuf_iterator<char>(fstream)), std::istreambuf_iterator<char>());
-                messages.emplace_back(content);
-            }
-            catch (const std::exception &ex) {
-                FTS3_COMMON_LOGGER_NEWLOG(ERR)
-                << "Could not load message from " << path << " (" << ex.what() << ")"
-                << fts3::common::commit;
-            }
-
 
-            if (dirq_remove(*monitoringQueue, iter) < 0) {
-                error = dirq_get_errstr(*monitoringQueue);
-                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Failed to remove message from queue (" << path << "): "
-                    << error
-                    << fts3::common::commit;
-                dirq_clear_error(*monitoringQueue);
-            }
-        }
+    int ret = dirqConsumer(monitoringQueue, limit, readBuffer, slices, i);
+    for (auto slice = slices.begin(); slice != slices.end(); ++slice) {
+        messages.emplace_back(readBuffer, slice->first, slice->second);
+    }
+    if (ret != 0) {
+        return ret;
     }
 
-    error = dirq_get_errstr(*monitoringQueue);
-    if (error) {
-        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Failed to consume messages: " << error << fts3::common::commit;
-        return -1;
+    if (i < limit) {
+        return segmentConsumer(monitoringSegments, limit - i, messages);
     }
 
     return 0;
@@ -203,6 +327,47 @@ static void _purge(DirQ *dq)
 }
 
 
+static void _purge(SegmentQueue *segments)
+{
+    try {
+        segments->purge();
+    }
+    catch (const std::exception &ex) {
+        FTS3_COMMON_LOGGER_NEWLOG(ERR)
+            << "Could not purge " << segments->getPath() << " (" << ex.what() << ")"
+            << fts3::common::commit;
+    }
+}
+
+
+static int _commit(SegmentQueue *segments)
+{
+    try {
+        segments->commit();
+    }
+    catch (const std::exception &ex) {
+        FTS3_COMMON_LOGGER_NEWLOG(ERR)
+            << "Could not commit " << segments->getPath() << " (" << ex.what() << ")"
+            << fts3::common::commit;
+        return -1;
+    }
+    return 0;
+}
+
+
+int Consumer::commit()
+{
+    int ret = 0;
+    ret |= _commit(monitoringSegments.get());
+    ret |= _commit(statusSegments.get());
+    ret |= _commit(stalledSegments.get());
+    ret |= _commit(logSegments.get());
+    ret |= _commit(stagingSegments.get());
+    ret |= _commit(deletionSegments.get());
+    return ret;
+}
+
+
 void Consumer::purgeAll()
 {
     _purge(monitoringQueue.get());
@@ -211,4 +376,11 @@ void Consumer::purgeAll()
     _purge(logQueue.get());
     _purge(stagingQueue.get());
     _purge(deletionQueue.get());
+
+    _purge(monitoringSegments.get());
+    _purge(statusSegments.get());
+    _purge(stalledSegments.get());
+    _purge(logSegments.get());
+    _purge(stagingSegments.get());
+    _purge(deletionSegments.get());
 }
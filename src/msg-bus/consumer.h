@@ -29,25 +29,43 @@
 #include "events.h"
 
 struct DirQ;
+class SegmentQueue;
 
 class Consumer
 {
 private:
     std::string baseDir;
     unsigned limit;
+    unsigned parseThreads;
+    /// Holds the content of the dirq entries being consumed, reused between calls
+    std::string readBuffer;
     std::unique_ptr<DirQ> monitoringQueue;
     std::unique_ptr<DirQ> statusQueue;
     std::unique_ptr<DirQ> stalledQueue;
     std::unique_ptr<DirQ> logQueue;
     std::unique_ptr<DirQ> stagingQueue;
     std::unique_ptr<DirQ> deletionQueue;
+    std::unique_ptr<SegmentQueue> monitoringSegments;
+    std::unique_ptr<SegmentQueue> statusSegments;
+    std::unique_ptr<SegmentQueue> stalledSegments;
+    std::unique_ptr<SegmentQueue> logSegments;
+    std::unique_ptr<SegmentQueue> stagingSegments;
+    std::unique_ptr<SegmentQueue> deletionSegments;
 
 public:
 
+    /// Messages are read from both backends, see MsgBusBackend
+    /// Messages read from the segment backend are committed on the next call to the same
+    /// runConsumer method, so a batch still being processed when the process dies is delivered again.
+    /// Messages of the dirq backend are removed as soon as they are read
     Consumer(const std::string &baseDir, unsigned limit = 10000);
 
     ~Consumer();
 
+    /// Parse the messages read from the dirq backend with up to this many threads.
+    /// Only large batches are split, 1 by default
+    void setParseThreads(unsigned threads);
+
     int runConsumerStatus(std::vector<fts3::events::Message> &messages);
 
     int runConsumerStall(std::vector<fts3::events::MessageUpdater> &messages);
@@ -60,6 +78,12 @@ public:
 
     int runConsumerMonitoring(std::vector<std::string> &messages);
 
+    /// Commit the messages read so far from the segment backend, so they are not delivered again.
+    /// Short lived consumers must call it once the messages have been handed off,
+    /// as there is no next call to commit them
+    /// @return 0 on success, -1 if any of the queues could not be committed
+    int commit();
+
     void purgeAll();
 };
 
@@ -24,15 +24,63 @@
 #include <glib.h>
 #include <boost/thread/tss.hpp>
 #include "DirQ.h"
+#include "SegmentQueue.h"
 
 #include "common/Logger.h"
 
 
-Producer::Producer(const std::string &baseDir): baseDir(baseDir),
-    monitoringQueue(new DirQ(baseDir + "/monitoring")), statusQueue(new DirQ(baseDir + "/status")),
-    stalledQueue(new DirQ(baseDir + "/stalled")), logQueue(new DirQ(baseDir + "/logs")),
-    deletionQueue(new DirQ(baseDir + "/deletion")), stagingQueue(new DirQ(baseDir + "/staging"))
+static const char BACKEND_FILE[] = "/msg-bus.backend";
+static const char SEGMENT_BACKEND[] = "segment";
+
+
+void setMsgBusBackend(const std::string &baseDir, MsgBusBackend backend)
 {
+    std::string path = baseDir + BACKEND_FILE;
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath.c_str(), std::ios::trunc);
+        out << (backend == MsgBusBackend::SEGMENT ? SEGMENT_BACKEND : "dirq") << std::endl;
+        if (!out) {
+            throw fts3::common::SystemError("Could not write " + tmpPath);
+        }
+    }
+    boost::filesystem::rename(tmpPath, path);
+}
+
+
+MsgBusBackend getMsgBusBackend(const std::string &baseDir)
+{
+    std::ifstream in((baseDir + BACKEND_FILE).c_str());
+    std::string backend;
+    if (in >> backend && backend == SEGMENT_BACKEND) {
+        return MsgBusBackend::SEGMENT;
+    }
+    return MsgBusBackend::DIRQ;
+}
+
+
+Producer::Producer(const std::string &baseDir): Producer(baseDir, getMsgBusBackend(baseDir))
+{
+}
+
+
+Producer::Producer(const std::string &baseDir, MsgBusBackend backend): baseDir(baseDir), backend(backend)
+{
+    if (backend == MsgBusBackend::SEGMENT) {
+        monitoringSegments.reset(new SegmentQueue(baseDir + "/segments/monitoring"));
+        statusSegments.reset(new SegmentQueue(baseDir + "/segments/status"));
+        logSegments.reset(new SegmentQueue(baseDir + "/segments/logs"));
+        deletionSegments.reset(new SegmentQueue(baseDir + "/segments/deletion"));
+        stagingSegments.reset(new SegmentQueue(baseDir + "/segments/staging"));
+    }
+    else {
+        monitoringQueue.reset(new DirQ(baseDir + "/monitoring"));
+        statusQueue.reset(new DirQ(baseDir + "/status"));
+        stalledQueue.reset(new DirQ(baseDir + "/stalled"));
+        logQueue.reset(new DirQ(baseDir + "/logs"));
+        deletionQueue.reset(new DirQ(baseDir + "/deletion"));
+        stagingQueue.reset(new DirQ(baseDir + "/staging"));
+    }
 }
 
 
@@ -60,9 +108,21 @@ static int producerDirqW(dirq_t, char *buffer, size_t length)
 }
 
 
-static int writeMessage(std::unique_ptr<DirQ> &dirqHandle, const google::protobuf::Message &msg)
+static int writeMessage(std::unique_ptr<DirQ> &dirqHandle, std::unique_ptr<SegmentQueue> &segments,
+    const std::string &serialized)
 {
-    populateBuffer(msg.SerializeAsString());
+    if (segments) {
+        try {
+            segments->append(serialized);
+        }
+        catch (const std::exception &ex) {
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Failed to write message: " << ex.what() << fts3::common::commit;
+            return -1;
+        }
+        return 0;
+    }
+
+    populateBuffer(serialized);
     if (dirq_add(*dirqHandle, producerDirqW) == NULL) {
         return dirq_get_errcode(*dirqHandle);
     }
@@ -73,33 +133,28 @@ static int writeMessage(std::unique_ptr<DirQ> &dirqHandle, const google::protobu
 
 int Producer::runProducerStatus(const fts3::events::Message &msg)
 {
-    return writeMessage(statusQueue, msg);
+    return writeMessage(statusQueue, statusSegments, msg.SerializeAsString());
 }
 
 
 int Producer::runProducerLog(const fts3::events::MessageLog &msg)
 {
-    return writeMessage(logQueue, msg);
+    return writeMessage(logQueue, logSegments, msg.SerializeAsString());
 }
 
 int Producer::runProducerDeletions(const fts3::events::MessageBringonline &msg)
 {
-    return writeMessage(deletionQueue, msg);
+    return writeMessage(deletionQueue, deletionSegments, msg.SerializeAsString());
 }
 
 
 int Producer::runProducerStaging(const fts3::events::MessageBringonline &msg)
 {
-    return writeMessage(stagingQueue, msg);
+    return writeMessage(stagingQueue, stagingSegments, msg.SerializeAsString());
 }
 
 
 int Producer::runProducerMonitoring(const std::string &serialized)
 {
-    populateBuffer(serialized);
-    if (dirq_add(*monitoringQueue, producerDirqW) == NULL) {
-        return dirq_get_errcode(*monitoringQueue);
-    }
-
-    return 0;
+    return writeMessage(monitoringQueue, monitoringSegments, serialized);
 }
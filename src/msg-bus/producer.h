@@ -27,20 +27,44 @@
 #include "events.h"
 
 struct DirQ;
+class SegmentQueue;
+
+/// Storage used by the producers
+enum class MsgBusBackend {
+    DIRQ,       ///< One file per message
+    SEGMENT     ///< Messages appended to segment files, see SegmentQueue
+};
+
+/// Make the producers writing into baseDir use the given backend.
+/// Consumers always read from both, so messages written before the change are not lost
+void setMsgBusBackend(const std::string &baseDir, MsgBusBackend backend);
+
+/// Backend configured for baseDir. DIRQ if none has been set
+MsgBusBackend getMsgBusBackend(const std::string &baseDir);
+
 
 class Producer {
 private:
     std::string baseDir;
+    MsgBusBackend backend;
     std::unique_ptr<DirQ> monitoringQueue;
     std::unique_ptr<DirQ> statusQueue;
     std::unique_ptr<DirQ> stalledQueue;
     std::unique_ptr<DirQ> logQueue;
     std::unique_ptr<DirQ> deletionQueue;
     std::unique_ptr<DirQ> stagingQueue;
+    std::unique_ptr<SegmentQueue> monitoringSegments;
+    std::unique_ptr<SegmentQueue> statusSegments;
+    std::unique_ptr<SegmentQueue> logSegments;
+    std::unique_ptr<SegmentQueue> deletionSegments;
+    std::unique_ptr<SegmentQueue> stagingSegments;
 
 public:
+    /// Use the backend configured for baseDir
     Producer(const std::string &baseDir);
 
+    Producer(const std::string &baseDir, MsgBusBackend backend);
+
     ~Producer();
 
     int runProducerStatus(const fts3::events::Message &msg);
@@ -91,6 +91,14 @@ public:
         return wait_until > now;
     }
 
+    /**
+     * @return : the time at which the task stops waiting
+     */
+    time_t getWaitUntil() const
+    {
+        return wait_until;
+    }
+
     static void cancel(const std::set<std::pair<std::string, std::string> > &urls)
         {
             if (urls.empty()) return;
@@ -87,6 +87,14 @@ public:
         return wait_until > now;
     }
 
+    /**
+     * @return : the time at which the task stops waiting
+     */
+    time_t getWaitUntil() const
+    {
+        return wait_until;
+    }
+
 private:
 
     /**
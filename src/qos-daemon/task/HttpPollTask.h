@@ -95,6 +95,14 @@ public:
         return wait_until > now;
     }
 
+    /**
+     * @return : the time at which the task stops waiting
+     */
+    time_t getWaitUntil() const
+    {
+        return wait_until;
+    }
+
 private:
     /// checks if the bring online task was cancelled and removes those URLs that were from the context
     void handle_canceled();
@@ -22,7 +22,10 @@
 #ifndef WAITINGROOM_H_
 #define WAITINGROOM_H_
 
-#include <boost/ptr_container/ptr_list.hpp> // think about using a lockfree queue
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include <boost/thread.hpp>
 
 #include "common/ThreadPool.h"
@@ -32,16 +35,36 @@
 
 /**
  * A waiting room for task that will be executed in a while
+ *
+ * Tasks are kept in a min-heap ordered by the time they are due, so the
+ * waiting thread sleeps until the earliest deadline, or until a task with
+ * an earlier one is added, instead of scanning the whole room periodically.
+ *
+ * TASK must provide getWaitUntil(), the time at which it stops waiting.
  */
 template<typename TASK, typename BASE = Gfal2Task>
 class WaitingRoom
 {
 public:
 
+    /**
+     * Snapshot of the waiting room state
+     */
+    struct Metrics {
+        /// number of tasks waiting
+        size_t size;
+        /// number of tasks handed to the thread pool so far
+        uint64_t dispatched;
+        /// average and maximum delay between the deadline and the dispatch, in milliseconds
+        double avgLagMs, maxLagMs;
+
+        Metrics(): size(0), dispatched(0), avgLagMs(0), maxLagMs(0) {}
+    };
+
     /**
      * Default constructor
      */
-    WaitingRoom(): pool(NULL) {}
+    WaitingRoom(): pool(NULL), sequence(0), dispatched(0), totalLagMs(0), maxLagMs(0) {}
 
 
     /**
@@ -52,7 +75,13 @@ public:
     void add(TASK* task)
     {
         boost::mutex::scoped_lock lock(m);
-        tasks.push_back(task);
+        Entry entry(task->getWaitUntil(), sequence++, task);
+        bool earliest = tasks.empty() || entry.deadline < tasks.front().deadline;
+        tasks.push_back(entry);
+        std::push_heap(tasks.begin(), tasks.end(), Later());
+        // only wake up the waiting thread if it has to sleep less
+        if (earliest)
+            cv.notify_one();
     }
 
     /**
@@ -60,15 +89,41 @@ public:
      *
      * @param pool : the thread-pool that will be used to start tasks
      */
-    void attach(ThreadPool<BASE>& pool)
+    void attach(fts3::common::ThreadPool<BASE>& pool)
     {
         this->pool = &pool;
     }
 
+    /**
+     * @return : number of tasks waiting
+     */
+    size_t size()
+    {
+        boost::mutex::scoped_lock lock(m);
+        return tasks.size();
+    }
+
+    /**
+     * @return : size of the room and dispatch lag
+     */
+    Metrics getMetrics()
+    {
+        boost::mutex::scoped_lock lock(m);
+        Metrics metrics;
+        metrics.size = tasks.size();
+        metrics.dispatched = dispatched;
+        metrics.avgLagMs = dispatched ? totalLagMs / dispatched : 0;
+        metrics.maxLagMs = maxLagMs;
+        return metrics;
+    }
+
     /**
      * Destructor
      */
-    virtual ~WaitingRoom() {}
+    virtual ~WaitingRoom()
+    {
+        clear();
+    }
 
     /**
      * This routine is executed in a separate thread
@@ -87,12 +142,50 @@ private:
      */
     WaitingRoom& operator=(WaitingRoom const &) = delete;
 
-    /// the queue with tasks that are waiting
-    boost::ptr_list<TASK> tasks;
+    /**
+     * A waiting task, owned by the room
+     */
+    struct Entry {
+        time_t deadline;
+        uint64_t seq;
+        TASK *task;
+
+        Entry(time_t deadline, uint64_t seq, TASK *task): deadline(deadline), seq(seq), task(task) {}
+    };
+
+    /**
+     * Heap order: the earliest deadline on top, FIFO for the same deadline
+     */
+    struct Later {
+        bool operator () (const Entry &a, const Entry &b) const {
+            return a.deadline > b.deadline || (a.deadline == b.deadline && a.seq > b.seq);
+        }
+    };
+
+    /**
+     * Deletes the tasks left in the room
+     */
+    void clear()
+    {
+        boost::mutex::scoped_lock lock(m);
+        for (auto it = tasks.begin(); it != tasks.end(); ++it)
+            delete it->task;
+        tasks.clear();
+    }
+
+    /// the heap with tasks that are waiting
+    std::vector<Entry> tasks;
     /// the mutex preventing concurrent access
     boost::mutex m;
+    /// signaled when a task with an earlier deadline is added
+    boost::condition_variable cv;
     /// the threadpool items are waiting for
-    ThreadPool<BASE> * pool;
+    fts3::common::ThreadPool<BASE> * pool;
+    /// insertion order, to break ties between deadlines
+    uint64_t sequence;
+    /// dispatch metrics
+    uint64_t dispatched;
+    double totalLagMs, maxLagMs;
 };
 
 template <typename TASK, typename BASE>
@@ -102,25 +195,38 @@ void WaitingRoom<TASK, BASE>::run()
 
     while (!boost::this_thread::interruption_requested()) {
         try {
-            boost::this_thread::sleep(boost::posix_time::seconds(1));
-
-            // lock the mutex
-            boost::mutex::scoped_lock lock(this->m);
-            // get current time
-            time_t now = time(NULL);
-            // iterate over all all tasks
-            typename boost::ptr_list<TASK>::iterator it, next = this->tasks.begin();
-            while ((it = next) != this->tasks.end()) {
-                if (boost::this_thread::interruption_requested())
-                    return;
-                // next item to check
-                ++next;
-                // if the time has not yet come for the task simply continue
-                if (it->waiting(now))
-                    continue;
-                // otherwise start the task
-                this->pool->start(this->tasks.release(it).release());
+            // owned here until the pool takes them, so they are not leaked if starting one throws
+            std::vector<std::unique_ptr<TASK>> due;
+            {
+                boost::mutex::scoped_lock lock(this->m);
+                // sleep until the earliest task is due, waits are interruption points
+                while (this->tasks.empty() || this->tasks.front().deadline > time(NULL)) {
+                    if (this->tasks.empty())
+                        this->cv.wait(lock);
+                    else
+                        this->cv.timed_wait(lock, boost::posix_time::from_time_t(this->tasks.front().deadline));
+                }
+
+                boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+                time_t nowSec = time(NULL);
+                // take every task whose time has come
+                while (!this->tasks.empty() && this->tasks.front().deadline <= nowSec) {
+                    std::pop_heap(this->tasks.begin(), this->tasks.end(), Later());
+                    const Entry &entry = this->tasks.back();
+
+                    double lag = (now - boost::posix_time::from_time_t(entry.deadline)).total_milliseconds();
+                    ++this->dispatched;
+                    this->totalLagMs += lag;
+                    this->maxLagMs = std::max(this->maxLagMs, lag);
+
+                    due.emplace_back(entry.task);
+                    this->tasks.pop_back();
+                }
             }
+
+            // start the tasks without holding the lock, so add() is not blocked meanwhile
+            for (auto it = due.begin(); it != due.end(); ++it)
+                this->pool->start(it->release());
         }
         catch (const boost::thread_interrupted&) {
             FTS3_COMMON_LOGGER_NEWLOG(INFO) << "WaitingRoom interruption requested" << commit;
@@ -134,7 +240,11 @@ void WaitingRoom<TASK, BASE>::run()
         }
     }
 
-    tasks.clear();
+    Metrics metrics = getMetrics();
+    FTS3_COMMON_LOGGER_NEWLOG(INFO) << "WaitingRoom dispatched " << metrics.dispatched
+        << " tasks with an average lag of " << metrics.avgLagMs << " ms" << commit;
+
+    clear();
     FTS3_COMMON_LOGGER_NEWLOG(INFO) << "WaitingRoom exiting" << commit;
 }
 
@@ -89,11 +89,14 @@ void Server::start()
         boost::this_thread::sleep(boost::posix_time::seconds(12));
     }
 
+    executor = std::make_shared<fts3::common::Executor>(
+        config::ServerConfig::instance().get<int>("InternalThreadPool"));
+
     addService(new OptimizerService(heartBeatService));
-    addService(new TransfersService);
-    addService(new ReuseTransfersService);
+    addService(new TransfersService(executor));
+    addService(new ReuseTransfersService(executor));
     addService(new SupervisorService);
-    addService(new ForceStartTransfersService(heartBeatService));
+    addService(new ForceStartTransfersService(heartBeatService, executor));
 }
 
 
@@ -107,6 +110,9 @@ void Server::stop()
 {
     FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Request to stop the server" << fts3::common::commit;
     systemThreads.interrupt_all();
+    if (executor) {
+        executor->interrupt();
+    }
 }
 
 } // end namespace server
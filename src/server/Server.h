@@ -25,6 +25,7 @@
 #include <boost/noncopyable.hpp>
 #include <boost/thread.hpp>
 
+#include "common/Executor.h"
 #include "common/Singleton.h"
 #include "services/BaseService.h"
 
@@ -52,6 +53,8 @@ public:
 private:
     boost::thread_group systemThreads;
     std::vector<std::shared_ptr<BaseService>> services;
+    /// Worker threads shared by the services that spawn transfers
+    std::shared_ptr<fts3::common::Executor> executor;
 
     void addService(BaseService *service);
 };
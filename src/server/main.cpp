@@ -32,6 +32,9 @@
 #include "common/Logger.h"
 #include "common/panic.h"
 #include "db/generic/SingleDbInstance.h"
+#include "msg-bus/producer.h"
+#include "services/transfers/SpawnHelper.h"
+#include "services/transfers/UrlCopyWorkerPool.h"
 
 #include "Server.h"
 
@@ -79,6 +82,9 @@ static void shutdownCallback(int signum, void*)
         default:
             break;
     }
+
+    // Do not leave anything queued if the process is about to be killed
+    theLogger().drainAsync();
 }
 
 /// Main body of the FTS3 server
@@ -98,8 +104,19 @@ static void doServer(void)
             throw SystemError(msg.str());
         }
     }
+    // Fork the url-copy launcher now, before the server starts its services and grows.
+    // After the redirection, so the url-copy processes inherit the same stdout and stderr
+    if (ServerConfig::instance().get<bool>("UseSpawnHelper")) {
+        SpawnHelper::instance().start();
+    }
+    if (ServerConfig::instance().get<bool>("UrlCopyWorkers")) {
+        UrlCopyWorkerPool::instance().start(
+            ServerConfig::instance().get<std::string>("MessagingDirectory") + "/url-copy-workers.sock");
+    }
+
     theLogger().setLogLevel(Logger::getLogLevel(ServerConfig::instance().get<std::string>("LogLevel")));
     theLogger().setProfiling(ServerConfig::instance().get<bool>("Profiling"));
+    theLogger().setAsync(ServerConfig::instance().get<bool>("AsyncLogging"));
 
     FTS3_COMMON_LOGGER_NEWLOG(INFO)<< "Starting server..." << commit;
 
@@ -110,6 +127,9 @@ static void doServer(void)
 
     Server::instance().wait();
 
+    // Idle url-copy workers exit once disconnected
+    UrlCopyWorkerPool::instance().stop();
+
     FTS3_COMMON_LOGGER_NEWLOG(INFO)<< "Server stopped" << commit;
 
     exit(0);
@@ -181,6 +201,19 @@ static void runEnvironmentChecks()
     checkPath(monDir + "/status", R_OK | W_OK, fs::directory_file);
     checkPath(monDir + "/stalled", R_OK | W_OK, fs::directory_file);
     checkPath(monDir + "/logs", R_OK | W_OK, fs::directory_file);
+
+    // Producers in other processes (i.e. fts_url_copy) pick the backend from the messaging directory
+    std::string msgBackend = ServerConfig::instance().get<std::string>("MessagingBackend");
+    if (msgBackend == "segment") {
+        setMsgBusBackend(monDir, MsgBusBackend::SEGMENT);
+    }
+    else if (msgBackend == "dirq") {
+        setMsgBusBackend(monDir, MsgBusBackend::DIRQ);
+    }
+    else {
+        throw SystemError("Unknown MessagingBackend " + msgBackend + " (expected dirq or segment)");
+    }
+    FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Messaging backend: " << msgBackend << commit;
 }
 
 
@@ -99,19 +99,45 @@ void Optimizer::run(void)
         // See FTS-1094
         pairs.sort();
 
+        prefetchPairs(pairs);
         for (auto i = pairs.begin(); i != pairs.end(); ++i) {
             runOptimizerForPair(*i);
         }
+        dataSource->dropPrefetched();
     }
     catch (std::exception &e) {
+        dataSource->dropPrefetched();
         throw SystemError(std::string(__func__) + ": Caught exception " + e.what());
     }
     catch (...) {
+        dataSource->dropPrefetched();
         throw SystemError(std::string(__func__) + ": Caught exception ");
     }
 }
 
 
+void Optimizer::prefetchPairs(const std::list<Pair> &pairs)
+{
+    const std::vector<boost::posix_time::time_duration> timeFrames = {
+        boost::posix_time::seconds(SHORT_TIME_FRAME),
+        boost::posix_time::seconds(MEDIUM_TIME_FRAME),
+        boost::posix_time::seconds(LONG_TIME_FRAME)
+    };
+
+    boost::timer::cpu_timer timer;
+    try {
+        dataSource->prefetch(pairs, timeFrames);
+        FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "Optimizer prefetched " << pairs.size() << " pairs"
+            << " (" << timer.elapsed().wall / 1000000 << "ms)" << commit;
+    }
+    catch (const std::exception &e) {
+        // Not fatal, the pairs will be queried one by one
+        dataSource->dropPrefetched();
+        FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Optimizer could not prefetch the pairs: " << e.what() << commit;
+    }
+}
+
+
 void Optimizer::runOptimizerForPair(const Pair &pair)
 {
     OptimizerMode optMode = dataSource->getOptimizerMode(pair.source, pair.destination);
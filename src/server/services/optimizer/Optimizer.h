@@ -24,6 +24,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -90,6 +91,16 @@ public:
     // Return a list of pairs with active or submitted transfers
     virtual std::list<Pair> getActivePairs(void) = 0;
 
+    // Fetch in bulk what the calls below need for all the given pairs and time frames,
+    // so a run does not issue a set of queries per pair. The prefetched values are used until
+    // dropPrefetched is called. Pairs or time frames not prefetched are still queried one by one.
+    // Optional, the default does nothing.
+    virtual void prefetch(const std::list<Pair> &,
+        const std::vector<boost::posix_time::time_duration> &) {}
+
+    // Forget the prefetched values
+    virtual void dropPrefetched(void) {}
+
     // Return the optimizer configuration value
     virtual OptimizerMode getOptimizerMode(const std::string &source, const std::string &dest) = 0;
 
@@ -157,6 +168,9 @@ protected:
     // Stores into rangeActiveMin and rangeActiveMax the working range for the optimizer
     void getOptimizerWorkingRange(const Pair &pair, Range *range, StorageLimits *limits);
 
+    // Fetch in bulk the inputs of all the pairs about to be optimized
+    void prefetchPairs(const std::list<Pair> &pairs);
+
     // Updates decision
     void setOptimizerDecision(const Pair &pair, int decision, const PairState &current,
         int diff, const std::string &rationale, boost::timer::cpu_times elapsed);
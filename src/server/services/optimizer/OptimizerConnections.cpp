@@ -43,13 +43,13 @@ static inline double exponentialMovingAverage(double sample, double alpha, doubl
 static boost::posix_time::time_duration calculateTimeFrame(time_t avgDuration)
 {
     if(avgDuration > 0 && avgDuration < 30) {
-        return boost::posix_time::minutes(5);
+        return boost::posix_time::seconds(SHORT_TIME_FRAME);
     }
     else if(avgDuration > 30 && avgDuration < 900) {
-        return boost::posix_time::minutes(15);
+        return boost::posix_time::seconds(MEDIUM_TIME_FRAME);
     }
     else {
-        return boost::posix_time::minutes(30);
+        return boost::posix_time::seconds(LONG_TIME_FRAME);
     }
 }
 
@@ -178,7 +178,7 @@ bool Optimizer::optimizeConnectionsForPair(OptimizerMode optMode, const Pair &pa
     // Initialize current state
     PairState current;
     current.timestamp = time(NULL);
-    current.avgDuration = dataSource->getAverageDuration(pair, boost::posix_time::minutes(30));
+    current.avgDuration = dataSource->getAverageDuration(pair, boost::posix_time::seconds(LONG_TIME_FRAME));
 
     boost::posix_time::time_duration timeFrame = calculateTimeFrame(current.avgDuration);
 
@@ -24,6 +24,7 @@
 #include "Optimizer.h"
 
 #include "db/generic/SingleDbInstance.h"
+#include "server/services/transfers/LinkCircuitBreaker.h"
 
 
 namespace fts3 {
@@ -72,6 +73,11 @@ public:
         msg.connections = decision;
         msg.rationale = rationale;
 
+        LinkCircuitBreaker::Status breaker = LinkCircuitBreaker::instance().getStatus(pair.source, pair.destination);
+        msg.circuitBreaker = LinkCircuitBreaker::stateName(breaker.state);
+        msg.linkErrorRate = breaker.failureRatio;
+        msg.circuitRetryAt = breaker.retryAt;
+
         MsgIfce::getInstance()->SendOptimizer(msgProducer, msg);
     }
 };
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BundledTransfers.h"
+
+
+namespace fts3 {
+namespace server {
+
+
+void BundledTransfers::add(int pid, const std::vector<uint64_t> &fileIds)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    // A reused pid belongs to a new process
+    files[pid] = std::set<uint64_t>(fileIds.begin(), fileIds.end());
+}
+
+
+bool BundledTransfers::contains(int pid, uint64_t fileId)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    auto process = files.find(pid);
+    return process != files.end() && process->second.count(fileId) > 0;
+}
+
+
+bool BundledTransfers::release(int pid, uint64_t fileId)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    auto process = files.find(pid);
+    if (process == files.end() || process->second.erase(fileId) == 0) {
+        return false;
+    }
+    if (process->second.empty()) {
+        files.erase(process);
+    }
+    return true;
+}
+
+
+size_t BundledTransfers::size()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    size_t count = 0;
+    for (auto process = files.begin(); process != files.end(); ++process) {
+        count += process->second.size();
+    }
+    return count;
+}
+
+} // end namespace server
+} // end namespace fts3
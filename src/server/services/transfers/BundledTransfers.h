@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef BUNDLEDTRANSFERS_H_
+#define BUNDLEDTRANSFERS_H_
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include "common/Singleton.h"
+
+
+namespace fts3 {
+namespace server {
+
+/// Files run by a bundled url-copy, by pid of the url-copy.
+///
+/// FileTransferExecutor records the files of a bundle once it is spawned, and each file
+/// is forgotten when its final status is applied. Only for these files a CANCELED
+/// status can come from the cancellation of another file of the same process.
+class BundledTransfers: public fts3::common::Singleton<BundledTransfers>
+{
+public:
+    /// Record the files run by the url-copy pid
+    void add(int pid, const std::vector<uint64_t> &fileIds);
+
+    /// @return true if the file is run by the bundled url-copy pid
+    bool contains(int pid, uint64_t fileId);
+
+    /// Forget the file
+    /// @return true if it was run by the bundled url-copy pid
+    bool release(int pid, uint64_t fileId);
+
+    /// @return number of files recorded
+    size_t size();
+
+private:
+    boost::mutex mutex;
+    std::map<int, std::set<uint64_t>> files;
+};
+
+} // end namespace server
+} // end namespace fts3
+
+#endif // BUNDLEDTRANSFERS_H_
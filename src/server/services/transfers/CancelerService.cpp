@@ -22,13 +22,17 @@
 
 #include <signal.h>
 
+#include <set>
+
 #include <boost/filesystem.hpp>
 
 #include "common/Logger.h"
 #include "config/ServerConfig.h"
 #include "server/DrainMode.h"
+#include "SchedulerWakeup.h"
 #include "SingleTrStateInstance.h"
 #include "ThreadSafeList.h"
+#include "UrlCopyWorkerPool.h"
 
 
 using namespace fts3::common;
@@ -38,6 +42,20 @@ using fts3::config::ServerConfig;
 namespace fts3 {
 namespace server {
 
+
+/// A url-copy worker keeps its pid across transfers, so the pid of a transfer
+/// may now be running another one
+/// @return true if the process can be signaled on behalf of the file
+static bool stillRunsTransfer(int pid, uint64_t fileId)
+{
+    if (UrlCopyWorkerPool::instance().runsTransfer(pid, fileId)) {
+        return true;
+    }
+    FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Not killing pid " << pid << " for file " << fileId
+        << ", the url-copy worker has moved on to another transfer" << commit;
+    return false;
+}
+
 extern time_t stallRecords;
 
 
@@ -51,9 +69,30 @@ CancelerService::~CancelerService()
 }
 
 
+void CancelerService::terminateTransfers(const std::vector<TerminalTransition>& transitions,
+    const std::string& alreadyTerminated)
+{
+    if (transitions.empty()) {
+        return;
+    }
+
+    std::vector<TransferState> states;
+    std::vector<boost::tuple<bool, std::string> > updated =
+        DBSingleton::instance().getDBObjectInstance()->terminateTransfers(transitions, states);
+
+    for (size_t i = 0; i < updated.size(); ++i) {
+        if (!updated[i].get<0>()) {
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << alreadyTerminated
+                << transitions[i].jobId << "/" << transitions[i].fileId << " " << updated[i].get<1>() << commit;
+        }
+    }
+
+    SingleTrStateInstance::instance().sendStateMessages(states);
+}
+
+
 void CancelerService::markAsStalled()
 {
-    auto db = DBSingleton::instance().getDBObjectInstance();
     const boost::posix_time::seconds timeout(ServerConfig::instance().get<int>("CheckStalledTimeout"));
 
     std::vector<fts3::events::MessageUpdater> messages;
@@ -77,37 +116,34 @@ void CancelerService::markAsStalled()
                 << ". Probably stalled";
         }
 
+        std::vector<TerminalTransition> transitions;
+        transitions.reserve(messages.size());
+
         for (auto i = messages.begin(); i != messages.end(); ++i) {
             // Make sure we don't kill ourselves
-            if (i->process_id()) {
+            if (i->process_id() && stillRunsTransfer(i->process_id(), i->file_id())) {
                 kill(i->process_id(), SIGKILL);
             }
-            boost::tuple<bool, std::string> updated = db->updateTransferStatus(i->job_id(), i->file_id(), 0,
-                "FAILED", reason.str(), i->process_id(),
-                0, 0, false);
-            db->updateJobStatus(i->job_id(), "FAILED");
-
-            if (updated.get<0>()) {
-                SingleTrStateInstance::instance().sendStateMessage(i->job_id(), i->file_id());
-            }
-            else {
-                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Tried to mark as stalled, but already terminated: "
-                    << i->job_id() << "/" << i->file_id() << " "  << updated.get<1>() << commit;
-            }
+            transitions.emplace_back(i->job_id(), i->file_id(), "FAILED", reason.str(), i->process_id());
         }
+
+        terminateTransfers(transitions, "Tried to mark as stalled, but already terminated: ");
         ThreadSafeList::get_instance().deleteMsg(messages);
+        // The watch list does not know the links
+        SchedulerWakeup::instance().notifyAll();
     }
 }
 
 
 void CancelerService::killCanceledByUser()
 {
-    std::vector<int> requestIDs;
+    std::vector<std::pair<int, uint64_t>> requestIDs;
     DBSingleton::instance().getDBObjectInstance()->getCancelJob(requestIDs);
     if (!requestIDs.empty())
     {
         FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "Killing transfers canceled by the user" << commit;
         killRunningJob(requestIDs);
+        SchedulerWakeup::instance().notifyAll();
     }
 }
 
@@ -137,24 +173,24 @@ void CancelerService::applyActiveTimeouts()
     db->reapStalledTransfers(stalled);
 
     std::vector<fts3::events::MessageUpdater> messages;
+    std::vector<TerminalTransition> transitions;
 
     for (auto i = stalled.begin(); i != stalled.end(); ++i) {
         if (i->pid > 0) {
-            FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Killing pid:" << i->pid
-                << ", jobid:" << i->jobId << ", fileid:" << i->fileId
-                << " because it was stalled" << commit;
-            kill(i->pid, SIGKILL);
+            if (stillRunsTransfer(i->pid, i->fileId)) {
+                FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Killing pid:" << i->pid
+                    << ", jobid:" << i->jobId << ", fileid:" << i->fileId
+                    << " because it was stalled" << commit;
+                kill(i->pid, SIGKILL);
+            }
         }
         else {
             FTS3_COMMON_LOGGER_NEWLOG(WARNING)
                 << "Killing jobid:" << i->jobId << ", fileid:" << i->fileId
                 << " because it was stalled (no pid available!)" << commit;
         }
-        db->updateTransferStatus(i->jobId, i->fileId, 0.0,
-            "FAILED", "Transfer has been forced-killed because it was stalled",
-            i->pid, 0, 0, false);
-        db->updateJobStatus(i->jobId, "FAILED");
-        SingleTrStateInstance::instance().sendStateMessage(i->jobId, i->fileId);
+        transitions.emplace_back(i->jobId, i->fileId, "FAILED",
+            "Transfer has been forced-killed because it was stalled", i->pid);
 
         fts3::events::MessageUpdater msg;
         msg.set_job_id(i->jobId);
@@ -162,7 +198,13 @@ void CancelerService::applyActiveTimeouts()
 
         messages.emplace_back(msg);
     }
+
+    terminateTransfers(transitions, "Tried to apply the active timeout, but already terminated: ");
     ThreadSafeList::get_instance().deleteMsg(messages);
+
+    for (auto i = stalled.begin(); i != stalled.end(); ++i) {
+        SchedulerWakeup::instance().notify(i->sourceSe, i->destSe);
+    }
 }
 
 
@@ -270,10 +312,20 @@ void CancelerService::runService()
 }
 
 
-void CancelerService::killRunningJob(const std::vector<int>& pids)
+void CancelerService::killRunningJob(const std::vector<std::pair<int, uint64_t>>& transfers)
 {
     int sigKillDelay = ServerConfig::instance().get<int>("SigKillDelay");
 
+    std::set<int> pids;
+    for (auto iter = transfers.begin(); iter != transfers.end(); ++iter) {
+        if (stillRunsTransfer(iter->first, iter->second)) {
+            pids.insert(iter->first);
+        }
+    }
+    if (pids.empty()) {
+        return;
+    }
+
     for (auto iter = pids.begin(); iter != pids.end(); ++iter)
     {
         int pid = *iter;
@@ -22,9 +22,11 @@
 #ifndef CANCELERSERVICE_H_
 #define CANCELERSERVICE_H_
 
+#include <string>
 #include <vector>
 
 #include "../BaseService.h"
+#include "db/generic/TerminalTransition.h"
 
 
 namespace fts3 {
@@ -43,7 +45,13 @@ public:
     virtual void runService();
 
 private:
-    void killRunningJob(const std::vector<int>& pids);
+    /// Fail or cancel the transfers in a single transaction, then send their state messages
+    /// @param alreadyTerminated    Logged before the transfers that were already in a terminal state
+    void terminateTransfers(const std::vector<TerminalTransition>& transitions,
+        const std::string& alreadyTerminated);
+    /// Kill the url-copy processes of the canceled transfers
+    /// @param transfers    Pid and file id of each transfer
+    void killRunningJob(const std::vector<std::pair<int, uint64_t>>& transfers);
     void markAsStalled();
     void killCanceledByUser();
     void applyQueueTimeouts();
@@ -47,11 +47,15 @@
 #include <sys/socket.h>
 
 #include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/join.hpp>
 #include <boost/algorithm/string/split.hpp>
 
 #include "db/generic/SingleDbInstance.h"
+#include "common/ChildProcessRegistry.h"
 #include "common/Logger.h"
 #include "ExecuteProcess.h"
+#include "SpawnHelper.h"
+#include "UrlCopyWorkerPool.h"
 #include "common/Exceptions.h"
 
 
@@ -59,21 +63,95 @@ using namespace fts3::common;
 using namespace db;
 
 
+static ExecuteProcess::Launcher launcher;
+
+
+/// Track a spawned process for the slot accounting. The registry logs why a running
+/// process could not be watched, and counts the processes of its binary scanning /proc
+static void trackProcess(pid_t pid, const std::string &app)
+{
+    if (!ChildProcessRegistry::instance().add(pid, app) && ChildProcessRegistry::instance().isSupported()) {
+        FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "Process " << pid << " of " << app
+            << " is not tracked by the registry" << commit;
+    }
+}
+
+
 ExecuteProcess::ExecuteProcess(const std::string &app, const std::string &arguments)
-    : pid(0), m_app(app), m_arguments(arguments)
+    : pid(0), m_app(app), m_arguments(arguments), m_fileId(0)
+{
+    boost::split(m_argv, m_arguments, boost::is_any_of(" "));
+}
+
+
+ExecuteProcess::ExecuteProcess(const std::string &app, const std::vector<std::string> &arguments)
+    : pid(0), m_app(app), m_arguments(boost::algorithm::join(arguments, " ")), m_argv(arguments), m_fileId(0)
 {
 }
 
+
 int ExecuteProcess::executeProcessShell(std::string &forkMessage)
 {
-    return execProcessShell(forkMessage);
+    if (launcher) {
+        return launcher(m_app, m_arguments, pid, forkMessage);
+    }
+    if (!m_workerKey.empty()) {
+        pid_t worker = 0;
+        if (fts3::server::UrlCopyWorkerPool::instance().dispatch(m_workerKey, m_fileId, m_argv, worker)) {
+            pid = worker;
+            return 0;
+        }
+    }
+
+    int ret;
+    if (fts3::server::SpawnHelper::instance().isRunning()) {
+        ret = spawnProcess(forkMessage);
+    }
+    else {
+        ret = execProcessShell(forkMessage);
+    }
+    if (ret == 0 && pid > 0) {
+        fts3::server::UrlCopyWorkerPool::instance().forget(pid);
+    }
+    return ret;
+}
+
+
+int ExecuteProcess::spawnProcess(std::string &forkMessage)
+{
+    int error = 0;
+    try {
+        pid_t spawned = 0;
+        error = fts3::server::SpawnHelper::instance().spawn(m_app, m_argv, spawned);
+        pid = spawned;
+    }
+    catch (const std::exception &e) {
+        FTS3_COMMON_LOGGER_NEWLOG(WARNING) << e.what() << ". Falling back to fork" << commit;
+        return execProcessShell(forkMessage);
+    }
+
+    if (error) {
+        forkMessage = "Child process failed to execute: " + std::string(strerror(error));
+        FTS3_COMMON_LOGGER_NEWLOG(ERR) << forkMessage << commit;
+        return -1;
+    }
+
+    // Not a child of this process, but it can be watched all the same
+    trackProcess(pid, m_app);
+    return 0;
+}
+
+
+void ExecuteProcess::setLauncher(Launcher l)
+{
+    launcher = l;
 }
 
 // argsHolder is used to keep the argument pointers alive
 // for as long as needed
 void ExecuteProcess::getArgv(std::list<std::string> &argsHolder, size_t *argc, char ***argv)
 {
-    boost::split(argsHolder, m_arguments, boost::is_any_of(" "));
+    argsHolder.assign(m_argv.begin(), m_argv.end());
 
     *argc = argsHolder.size() + 2; // Need place for the binary and the NULL
     *argv = new char *[*argc];
@@ -164,6 +242,10 @@ int ExecuteProcess::execProcessShell(std::string &forkMessage)
     }
 
     // Parent process
+    // Track the child for the slot accounting. If exec fails, it is seen exiting as any other,
+    // and if it is already gone it is simply not counted
+    trackProcess(pid, m_app);
+
     // Close writing end of the pipe, and wait and see if we got an error from
     // the child
     close(pipefds[1]);
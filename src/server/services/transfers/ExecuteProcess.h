@@ -20,16 +20,43 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <list>
 #include <string>
 #include <map>
+#include <vector>
 
 
 class ExecuteProcess
 {
 public:
+    /// Replaces fork/exec, i.e. for benchmarks or tests.
+    /// Must set pid, and return -1 on failure, as executeProcessShell
+    typedef std::function<int (const std::string& app, const std::string& arguments,
+        int& pid, std::string& forkMessage)> Launcher;
+
+    /// arguments is split on spaces
     ExecuteProcess(const std::string& app, const std::string& arguments);
+    /// One entry per argument, without the binary itself
+    ExecuteProcess(const std::string& app, const std::vector<std::string>& arguments);
+
+    /// Hands the transfer to an idle url-copy worker with the given key if there is one.
+    /// Otherwise spawns through the SpawnHelper when it is running, or forks
     int executeProcessShell(std::string& forkMessage);
 
+    /// Isolation key for the url-copy worker pool. Empty to always start a new process
+    /// @param fileId   File of the transfer, tracked by the pool while a worker runs it
+    void setWorkerKey(const std::string& key, uint64_t fileId)
+    {
+        m_workerKey = key;
+        m_fileId = fileId;
+    }
+
+    /// Install a launcher used instead of fork/exec by all the instances.
+    /// An empty launcher restores the default. Not thread safe, set it before scheduling starts
+    static void setLauncher(Launcher launcher);
+
     inline int getPid()
     {
         return pid;
@@ -43,4 +70,9 @@ private:
     int pid;
     std::string m_app;
     std::string m_arguments;
+    std::vector<std::string> m_argv;
+    std::string m_workerKey;
+    uint64_t m_fileId;
+
+    int spawnProcess(std::string& forkMessage);
 };
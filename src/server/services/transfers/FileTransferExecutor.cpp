@@ -19,6 +19,7 @@
  */
 
 #include "FileTransferExecutor.h"
+#include "BundledTransfers.h"
 
 #include "common/Logger.h"
 #include "ExecuteProcess.h"
@@ -28,7 +29,10 @@
 #include "CloudStorageConfig.h"
 #include "ThreadSafeList.h"
 #include "UrlCopyCmd.h"
+#include "UrlCopyWorkerPool.h"
+#include <fstream>
 #include <iostream>
+#include <unistd.h>
 
 #define BOOST_SPIRIT_THREADSAFE
 #include <boost/property_tree/ptree.hpp>
@@ -45,7 +49,8 @@ namespace server
 
 FileTransferExecutor::FileTransferExecutor(TransferFile &tf,
     bool monitoringMsg, std::string infosys,
-    std::string ftsHostName, std::string proxy, std::string logDir, std::string msgDir) :
+    std::string ftsHostName, std::string proxy, std::string logDir, std::string msgDir,
+    std::shared_ptr<const ConfigSnapshot> config) :
     tf(tf),
     monitoringMsg(monitoringMsg),
     infosys(infosys),
@@ -53,6 +58,25 @@ FileTransferExecutor::FileTransferExecutor(TransferFile &tf,
     proxy(proxy),
     logsDir(logDir),
     msgDir(msgDir),
+    config(config),
+    db(DBSingleton::instance().getDBObjectInstance())
+{
+}
+
+
+FileTransferExecutor::FileTransferExecutor(std::vector<TransferFile> &&bundle,
+    bool monitoringMsg, std::string infosys,
+    std::string ftsHostName, std::string proxy, std::string logDir, std::string msgDir,
+    std::shared_ptr<const ConfigSnapshot> config) :
+    tf(bundle.front()),
+    bundle(std::move(bundle)),
+    monitoringMsg(monitoringMsg),
+    infosys(infosys),
+    ftsHostName(ftsHostName),
+    proxy(proxy),
+    logsDir(logDir),
+    msgDir(msgDir),
+    config(config),
     db(DBSingleton::instance().getDBObjectInstance())
 {
 }
@@ -80,144 +104,211 @@ std::string FileTransferExecutor::getAuthMethod(const std::string& jobMetadata)
     return "null";
 }
 
-void FileTransferExecutor::run(boost::any & ctx)
+std::string FileTransferExecutor::getBundleKey(const TransferFile& tf, int64_t sizeThreshold,
+    const ConfigSnapshot& config)
 {
-    if (ctx.empty()) {
-        ctx = 0;
+    // Multiple replica, multihop and session reuse jobs already drive url_copy their own way
+    if (sizeThreshold <= 0 || tf.jobType != Job::kTypeRegular || tf.archiveTimeout > 0) {
+        return std::string();
+    }
+    if (tf.userFilesize <= 0 || tf.userFilesize > sizeThreshold) {
+        return std::string();
+    }
+    // Retries are counted per file, so only first attempts share a process
+    boost::optional<int> retryTimes = config.getRetryTimes(tf.fileId);
+    if (!retryTimes || *retryTimes != 0) {
+        return std::string();
+    }
+    // Token issuers are loaded into the gfal2 context of the process
+    if (tf.fileMetadata.find("-issuer") != std::string::npos) {
+        return std::string();
     }
 
-    int &scheduled = boost::any_cast<int &>(ctx);
+    // Cancellation kills the process, so never mix jobs.
+    // The other files of the bundle are requeued, see MessageProcessingService::requeueIfCanceledAlongside
+    std::ostringstream key;
+    key << tf.jobId << '\n' << tf.sourceSe << '\n' << tf.destSe << '\n'
+        << tf.voName << '\n' << tf.userDn << '\n' << tf.credId << '\n'
+        << tf.overwriteFlag << '\n' << tf.checksumMode << '\n'
+        << tf.sourceSpaceToken << '\n' << tf.destinationSpaceToken << '\n'
+        << tf.internalFileParams << '\n' << tf.activity;
+    return key.str();
+}
 
-    //stop forking when a signal is received to avoid deadlocks
-    if (tf.fileId == 0 || boost::this_thread::interruption_requested()) {
-        return;
+
+void FileTransferExecutor::prepareCommand(const TransferFile& file, bool isBundle, int currentActive,
+    UrlCopyCmd& cmdBuilder)
+{
+    int secPerMB = config->getSecPerMb(file.voName);
+    if (secPerMB > 0) {
+        cmdBuilder.setSecondsPerMB(secPerMB);
     }
 
-    try {
-        // if the pair was already checked and not scheduled skip it
-        if (notScheduled.count(make_pair(tf.sourceSe, tf.destSe))) {
-            return;
-        }
+    TransferFile::ProtocolParameters protocolParams = file.getProtocolParameters();
 
-        // check if manual config exist for this pair and vo
-        std::vector< std::shared_ptr<ShareConfig> > cfgs;
+    if (file.internalFileParams.empty()) {
+        protocolParams.nostreams = config->getStreamsOptimization(file.sourceSe, file.destSe);
+        protocolParams.timeout = config->getGlobalTimeout(file.voName);
+        protocolParams.ipv6 = config->isProtocolIPv6(file.sourceSe, file.destSe);
+        protocolParams.udt = config->isProtocolUDT(file.sourceSe, file.destSe);
+        //protocolParams.buffersize
+    }
 
-        int currentActive = 0;
-        // Set to READY state when true
-        if (db->isTrAllowed(tf.sourceSe, tf.destSe, currentActive))
-        {
-            UrlCopyCmd cmdBuilder;
+    cmdBuilder.setFromProtocol(protocolParams);
 
-            int secPerMB = db->getSecPerMb(tf.voName);
-            if (secPerMB > 0) {
-                cmdBuilder.setSecondsPerMB(secPerMB);
-            }
+    // Update from the transfer
+    cmdBuilder.setFromTransfer(file, isBundle, config->publishUserDn(file.voName), msgDir);
 
-            TransferFile::ProtocolParameters protocolParams = tf.getProtocolParameters();
+    // OAuth credentials
+    std::string cloudConfigFile;
+    std::string authMethod = FileTransferExecutor::getAuthMethod(file.jobMetadata);
 
-            if (tf.internalFileParams.empty()) {
-                protocolParams.nostreams = db->getStreamsOptimization(tf.sourceSe, tf.destSe);
-                protocolParams.timeout = db->getGlobalTimeout(tf.voName);
-                protocolParams.ipv6 = db->isProtocolIPv6(tf.sourceSe, tf.destSe);
-                protocolParams.udt = db->isProtocolUDT(tf.sourceSe, tf.destSe);
-                //protocolParams.buffersize
-            }
+    cmdBuilder.setAuthMethod(authMethod);
+    cloudConfigFile = generateCloudStorageConfigFile(db, file);
 
-            cmdBuilder.setFromProtocol(protocolParams);
+    if ("oauth2" == authMethod) {
+        cloudConfigFile = generateOAuthConfigFile(db, file, cloudConfigFile);
+    }
 
-            // Update from the transfer
-            cmdBuilder.setFromTransfer(tf, false, db->publishUserDn(tf.voName), msgDir);
+    if (!cloudConfigFile.empty()) {
+        cmdBuilder.setOAuthFile(cloudConfigFile);
+    }
 
-            // OAuth credentials
-            std::string cloudConfigFile;
-            std::string authMethod = FileTransferExecutor::getAuthMethod(tf.jobMetadata);
+    // Retrieve SE-issued tokens flag
+    cmdBuilder.setRetrieveSEToken(fts3::config::ServerConfig::instance().get<bool>("RetrieveSEToken"));
 
-            cmdBuilder.setAuthMethod(authMethod);
-            cloudConfigFile = generateCloudStorageConfigFile(db, tf);
+    // Debug level
+    cmdBuilder.setDebugLevel(config->getDebugLevel(file.sourceSe, file.destSe));
 
-            if ("oauth2" == authMethod) {
-                cloudConfigFile = generateOAuthConfigFile(db, tf, cloudConfigFile);
-            }
+    // Disable delegation (according to link config)
+    cmdBuilder.setDisableDelegation(config->getDisableDelegationFlag(file.sourceSe, file.destSe));
 
-            if (!cloudConfigFile.empty()) {
-                cmdBuilder.setOAuthFile(cloudConfigFile);
-            }
+    // Get SRM 3rd party TURL (according to link config)
+    auto thirdPartyTURL = config->getThirdPartyTURL(file.sourceSe, file.destSe);
+    if (!thirdPartyTURL.empty()) {
+        cmdBuilder.setThirdPartyTURL(thirdPartyTURL);
+    }
 
-            // Retrieve SE-issued tokens flag
-            cmdBuilder.setRetrieveSEToken(fts3::config::ServerConfig::instance().get<bool>("RetrieveSEToken"));
+    // Disable streaming via local transfers (according to global config)
+    cmdBuilder.setDisableStreaming(config->getDisableStreamingFlag(file.voName));
 
-            // Debug level
-            cmdBuilder.setDebugLevel(db->getDebugLevel(tf.sourceSe, tf.destSe));
+    // Enable monitoring
+    cmdBuilder.setMonitoring(monitoringMsg, msgDir);
 
-            // Disable delegation (according to link config)
-            cmdBuilder.setDisableDelegation(db->getDisableDelegationFlag(tf.sourceSe, tf.destSe));
+    // Set UrlCopyProcess ping interval (in seconds)
+    cmdBuilder.setPingInterval(fts3::config::ServerConfig::instance().get<int>("UrlCopyProcessPingInterval"));
 
-            // Get SRM 3rd party TURL (according to link config)
-            auto thirdPartyTURL = db->getThirdPartyTURL(tf.sourceSe, tf.destSe);
-            if (!thirdPartyTURL.empty()) {
-                cmdBuilder.setThirdPartyTURL(thirdPartyTURL);
-            }
+    // Proxy
+    if (!proxy.empty()) {
+        cmdBuilder.setProxy(proxy);
+    }
 
-            // Disable streaming via local transfers (according to global config)
-            cmdBuilder.setDisableStreaming(db->getDisableStreamingFlag(tf.voName));
+    // Info system
+    if (!infosys.empty()) {
+        cmdBuilder.setInfosystem(infosys);
+    }
 
-            // Enable monitoring
-            cmdBuilder.setMonitoring(monitoringMsg, msgDir);
+    // UDT and IPv6
+    cmdBuilder.setUDT(config->isProtocolUDT(file.sourceSe, file.destSe));
+    if (!cmdBuilder.isIPv6Explicit()) {
+        cmdBuilder.setIPv6(config->isProtocolIPv6(file.sourceSe, file.destSe));
+    }
 
-            // Set UrlCopyProcess ping interval (in seconds)
-            cmdBuilder.setPingInterval(fts3::config::ServerConfig::instance().get<int>("UrlCopyProcessPingInterval"));
+    // Disable source file eviction from disk buffer (according to SE config)
+    cmdBuilder.setSkipEvict(config->getSkipEvictionFlag(file.sourceSe));
 
-            // Proxy
-            if (!proxy.empty()) {
-                cmdBuilder.setProxy(proxy);
-            }
+    // Set TPC mode (according to SE config)
+    cmdBuilder.setCopyMode(config->getCopyMode(file.sourceSe, file.destSe));
 
-            // Info system
-            if (!infosys.empty()) {
-                cmdBuilder.setInfosystem(infosys);
-            }
+    // FTS3 host name
+    cmdBuilder.setFTSName(ftsHostName);
 
-            // UDT and IPv6
-            cmdBuilder.setUDT(db->isProtocolUDT(tf.sourceSe, tf.destSe));
-            if (!cmdBuilder.isIPv6Explicit()) {
-                cmdBuilder.setIPv6(db->isProtocolIPv6(tf.sourceSe, tf.destSe));
-            }
+    // Pass the number of active transfers for this link to url_copy
+    cmdBuilder.setNumberOfActive(currentActive);
 
-            // Disable source file eviction from disk buffer (according to SE config)
-            cmdBuilder.setSkipEvict(db->getSkipEvictionFlag(tf.sourceSe));
+    // Number of retries and maximum number allowed
+    boost::optional<int> retryTimesSnapshot = config->getRetryTimes(file.fileId);
+    int retry_times = retryTimesSnapshot ? *retryTimesSnapshot : db->getRetryTimes(file.jobId, file.fileId);
+    cmdBuilder.setNumberOfRetries(retry_times < 0 ? 0 : retry_times);
 
-            // Set TPC mode (according to SE config)
-            cmdBuilder.setCopyMode(db->getCopyMode(tf.sourceSe, tf.destSe));
+    if ((retry_times > 0) && (file.overwriteFlag == "R")) {
+        cmdBuilder.setOverwrite(true);
+    }
 
-            // FTS3 host name
-            cmdBuilder.setFTSName(ftsHostName);
+    // If is multihop job, file is not the final destination and overwriteFlag is "M" => enable overwrite
+    if (file.jobType == Job::kTypeMultiHop && !file.lastHop && file.overwriteFlag == "M") {
+        cmdBuilder.setOverwrite(true);
+    }
 
-            // Pass the number of active transfers for this link to url_copy
-            cmdBuilder.setNumberOfActive(currentActive);
+    boost::optional<int> retryMaxSnapshot = config->getRetry(file.jobId);
+    int retry_max = retryMaxSnapshot ? *retryMaxSnapshot : db->getRetry(file.jobId);
+    cmdBuilder.setMaxNumberOfRetries(retry_max < 0 ? 0 : retry_max);
 
-            // Number of retries and maximum number allowed
-            int retry_times = db->getRetryTimes(tf.jobId, tf.fileId);
-            cmdBuilder.setNumberOfRetries(retry_times < 0 ? 0 : retry_times);
+    // Log directory
+    cmdBuilder.setLogDir(logsDir);
+}
 
-            if ((retry_times > 0) && (tf.overwriteFlag == "R")) {
-                cmdBuilder.setOverwrite(true);
-            }
 
-            // If is multihop job, file is not the final destination and overwriteFlag is "M" => enable overwrite
-            if (tf.jobType == Job::kTypeMultiHop && !tf.lastHop && tf.overwriteFlag == "M") {
-                cmdBuilder.setOverwrite(true);
-            }
+void FileTransferExecutor::run(boost::any & ctx)
+{
+    if (ctx.empty()) {
+        ctx = 0;
+    }
+
+    int &scheduled = boost::any_cast<int &>(ctx);
+
+    //stop forking when a signal is received to avoid deadlocks
+    if (boost::this_thread::interruption_requested()) {
+        return;
+    }
 
-            int retry_max = db->getRetry(tf.jobId);
-            cmdBuilder.setMaxNumberOfRetries(retry_max < 0 ? 0 : retry_max);
+    if (!bundle.empty()) {
+        try {
+            runBundle(scheduled);
+        }
+        catch (std::exception &e) {
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Process thread exception " << e.what() << commit;
+        }
+        catch (...) {
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Process thread exception unknown" << commit;
+        }
+        return;
+    }
 
-            // Log directory
-            cmdBuilder.setLogDir(logsDir);
+    if (tf.fileId == 0) {
+        return;
+    }
+
+    try {
+        // if the pair was already checked and not scheduled skip it
+        if (notScheduled.count(make_pair(tf.sourceSe, tf.destSe))) {
+            return;
+        }
+
+        int currentActive = 0;
+        // Set to READY state when true
+        if (db->isTrAllowed(tf.sourceSe, tf.destSe, currentActive))
+        {
+            UrlCopyCmd cmdBuilder;
+            prepareCommand(tf, false, currentActive, cmdBuilder);
+
+            // Let the process take more transfers of the same kind once done
+            std::string workerKey;
+            if (UrlCopyWorkerPool::instance().isRunning()) {
+                workerKey = cmdBuilder.getWorkerKey();
+            }
+            if (!workerKey.empty()) {
+                config::ServerConfig &serverConfig = config::ServerConfig::instance();
+                cmdBuilder.setWorker(UrlCopyWorkerPool::instance().getSocketPath(), workerKey,
+                    serverConfig.get<unsigned>("UrlCopyWorkerMaxTransfers"),
+                    serverConfig.get<unsigned>("UrlCopyWorkerMaxRss"),
+                    serverConfig.get<unsigned>("UrlCopyWorkerIdleTimeout"));
+            }
 
             // Build the parameters
-            std::string params = cmdBuilder.generateParameters();
             FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Transfer params: " << cmdBuilder << commit;
-            ExecuteProcess pr(UrlCopyCmd::Program, params);
+            ExecuteProcess pr(UrlCopyCmd::Program, cmdBuilder.getArguments());
+            pr.setWorkerKey(workerKey, tf.fileId);
 
             // check again here if the server has stopped - just in case
             if(boost::this_thread::interruption_requested()) {
@@ -303,5 +394,136 @@ void FileTransferExecutor::run(boost::any & ctx)
     }
 }
 
+
+/// Status message for every file of the bundle
+static std::vector<events::Message> bundleStatus(const std::vector<TransferFile> &files,
+    const std::string &state, const std::string &reason, int pid)
+{
+    std::vector<events::Message> messages;
+    messages.reserve(files.size());
+    for (auto file = files.begin(); file != files.end(); ++file) {
+        events::Message msg;
+        msg.set_job_id(file->jobId);
+        msg.set_file_id(file->fileId);
+        msg.set_transfer_status(state);
+        msg.set_transfer_message(reason);
+        msg.set_process_id(pid);
+        messages.push_back(msg);
+    }
+    return messages;
+}
+
+
+std::vector<TransferFile> FileTransferExecutor::claimBundle(GenericDbIfce& db, std::vector<TransferFile>& bundle)
+{
+    std::vector<boost::tuple<bool, std::string> > updated =
+        db.updateTransferStatusBatch(bundleStatus(bundle, "READY", "", 0));
+
+    std::vector<TransferFile> claimed;
+    claimed.reserve(bundle.size());
+    for (size_t i = 0; i < bundle.size(); ++i) {
+        if (i < updated.size() && updated[i].get<0>()) {
+            claimed.push_back(std::move(bundle[i]));
+        }
+        else {
+            FTS3_COMMON_LOGGER_NEWLOG(WARNING)
+                << "Transfer " << bundle[i].jobId << " " << bundle[i].fileId
+                << " not updated. Probably picked by another node" << commit;
+        }
+    }
+    bundle.clear();
+    return claimed;
+}
+
+
+void FileTransferExecutor::runBundle(int &scheduled)
+{
+    const TransferFile &first = bundle.front();
+
+    int currentActive = 0;
+    if (!db->isTrAllowed(first.sourceSe, first.destSe, currentActive)) {
+        return;
+    }
+
+    UrlCopyCmd cmdBuilder;
+    prepareCommand(first, true, currentActive, cmdBuilder);
+
+    // The file named after the job is taken by session reuse
+    const std::string bulkFile = msgDir + "/bundle-" + std::to_string(first.fileId);
+    cmdBuilder.setBulkFile(bulkFile);
+
+    FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Transfer params: " << cmdBuilder << commit;
+    ExecuteProcess pr(UrlCopyCmd::Program, cmdBuilder.getArguments());
+
+    if (boost::this_thread::interruption_requested()) {
+        return;
+    }
+
+    std::vector<TransferFile> claimed = claimBundle(*db, bundle);
+    if (claimed.empty()) {
+        return;
+    }
+
+    const std::string jobId = claimed.front().jobId;
+    db->updateJobStatus(jobId, "ACTIVE");
+    scheduled += claimed.size();
+
+    std::ofstream fout(bulkFile.c_str(), std::ios::out);
+    std::vector<events::Message> protoMsgs;
+    for (auto file = claimed.begin(); file != claimed.end(); ++file) {
+        fout << UrlCopyCmd::getBulkFileLine(*file) << std::endl;
+
+        // Update protocol parameters (specially interested on nostreams)
+        events::Message protoMsg;
+        protoMsg.set_transfer_status("UPDATE");
+        protoMsg.set_file_id(file->fileId);
+        protoMsg.set_buffersize(cmdBuilder.getBuffersize());
+        protoMsg.set_nostreams(cmdBuilder.getNoStreams());
+        protoMsg.set_timeout(cmdBuilder.getTimeout());
+        protoMsgs.push_back(protoMsg);
+    }
+    fout.close();
+    db->updateProtocol(protoMsgs);
+
+    // Spawn the fts_url_copy
+    bool failed = false;
+    std::string forkMessage;
+    if (fout.fail() || -1 == pr.executeProcessShell(forkMessage)) {
+        failed = true;
+        db->updateTransferStatusBatch(bundleStatus(claimed, "FAILED",
+            "Transfer failed to fork, check fts3server.log for more details", (int) pr.getPid()));
+        db->updateJobStatus(jobId, "FAILED");
+        unlink(bulkFile.c_str());
+
+        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Transfer bundle failed to fork " << forkMessage << "   " << jobId
+            << "  " << claimed.size() << " files" << commit;
+    }
+    else {
+        db->updateTransferStatusBatch(bundleStatus(claimed, "READY", "", pr.getPid()));
+
+        std::vector<uint64_t> fileIds;
+        for (auto file = claimed.begin(); file != claimed.end(); ++file) {
+            fileIds.push_back(file->fileId);
+        }
+        BundledTransfers::instance().add(pr.getPid(), fileIds);
+
+        FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Bundled " << claimed.size() << " files of " << jobId
+            << " into url_copy " << pr.getPid() << commit;
+    }
+
+    // Send current state, and watch every file of the bundle
+    for (auto file = claimed.begin(); file != claimed.end(); ++file) {
+        SingleTrStateInstance::instance().sendStateMessage(file->jobId, file->fileId);
+        if (!failed) {
+            fts3::events::MessageUpdater msg;
+            msg.set_job_id(file->jobId);
+            msg.set_file_id(file->fileId);
+            msg.set_process_id(pr.getPid());
+            msg.set_timestamp(millisecondsSinceEpoch());
+            ThreadSafeList::get_instance().push_back(msg);
+        }
+    }
+}
+
 } /* namespace server */
 } /* namespace fts3 */
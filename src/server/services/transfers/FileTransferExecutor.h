@@ -27,9 +27,12 @@
 #include "db/generic/SingleDbInstance.h"
 
 #include "TransferFileHandler.h"
+#include "UrlCopyCmd.h"
 
+#include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace fts3
 {
@@ -61,10 +64,19 @@ public:
      * @param monitoringMsg - is true if monitoring messages are in use
      * @param infosys - information system host
      * @param ftsHostName - hostname of the machine hosting FTS3
+     * @param config - configuration snapshot taken for this scheduling cycle
      */
     FileTransferExecutor(TransferFile& tf,
         bool monitoringMsg, std::string infosys, std::string ftsHostName, std::string proxy,
-        std::string logDir, std::string msgDir);
+        std::string logDir, std::string msgDir, std::shared_ptr<const ConfigSnapshot> config);
+
+    /**
+     * Constructor for a bundle of small files run by a single url_copy.
+     * All files must share the same bundle key, see getBundleKey.
+     */
+    FileTransferExecutor(std::vector<TransferFile>&& bundle,
+        bool monitoringMsg, std::string infosys, std::string ftsHostName, std::string proxy,
+        std::string logDir, std::string msgDir, std::shared_ptr<const ConfigSnapshot> config);
 
     /**
      * Destructor.
@@ -78,6 +90,23 @@ public:
      */
     virtual void run(boost::any &);
 
+    /**
+     * Files with the same key can be run together by one url_copy
+     *
+     * @param sizeThreshold - files bigger than this are never bundled
+     * @return an empty string if the file can not be bundled
+     */
+    static std::string getBundleKey(const TransferFile& tf, int64_t sizeThreshold,
+        const ConfigSnapshot& config);
+
+    /**
+     * Mark all the files of a bundle as READY, in one go
+     *
+     * @param bundle - the files to claim, left empty
+     * @return the files claimed, without those picked by another node
+     */
+    static std::vector<TransferFile> claimBundle(GenericDbIfce& db, std::vector<TransferFile>& bundle);
+
 private:
 
     /// pairs that were already checked and were not scheduled
@@ -85,6 +114,7 @@ private:
 
     /// variables from process_service_handler
     TransferFile tf;
+    std::vector<TransferFile> bundle;
     bool monitoringMsg;
     std::string infosys;
     std::string ftsHostName;
@@ -92,11 +122,20 @@ private:
     std::string logsDir;
     std::string msgDir;
 
+    // Configuration shared by all the executors of the same cycle
+    std::shared_ptr<const ConfigSnapshot> config;
+
     // DB interface
     GenericDbIfce* db;
 
     // method to retrieve auth method used
     std::string getAuthMethod(const std::string& jobMetadata);
+
+    // fill the url_copy parameters shared by single and bundled runs
+    void prepareCommand(const TransferFile& file, bool isBundle, int currentActive, UrlCopyCmd& cmdBuilder);
+
+    // spawn one url_copy for all the files of the bundle
+    void runBundle(int &scheduled);
 };
 
 } /* namespace server */
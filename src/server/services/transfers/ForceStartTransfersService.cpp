@@ -16,7 +16,7 @@
 
 #include "common/Logger.h"
 #include "common/ThreadPool.h"
-#include "common/DaemonTools.h"
+#include "common/ChildProcessRegistry.h"
 
 #include "config/ServerConfig.h"
 #include "cred/DelegCred.h"
@@ -35,10 +35,10 @@ using namespace fts3::common;
 namespace fts3 {
 namespace server {
 
-ForceStartTransfersService::ForceStartTransfersService(HeartBeat *beat) : BaseService("ForceStartTransfersService"), beat(beat) {
+ForceStartTransfersService::ForceStartTransfersService(HeartBeat *beat, std::shared_ptr<Executor> executor) :
+    BaseService("ForceStartTransfersService"), executor(executor), beat(beat) {
     logDir = config::ServerConfig::instance().get<std::string>("TransferLogDirectory");
     msgDir = config::ServerConfig::instance().get<std::string>("MessagingDirectory");
-    execPoolSize = config::ServerConfig::instance().get<int>("InternalThreadPool");
     ftsHostName = config::ServerConfig::instance().get<std::string>("Alias");
     infosys = config::ServerConfig::instance().get<std::string>("Infosys");
 
@@ -50,7 +50,7 @@ void ForceStartTransfersService::forceRunJobs() {
 
     // Bail out as soon as possible if there are too many fts_url_copy processes
     int maxUrlCopy = config::ServerConfig::instance().get<int>("MaxUrlCopyProcesses");
-    int urlCopyCount = countProcessesWithName("fts_url_copy");
+    int urlCopyCount = ChildProcessRegistry::instance().count("fts_url_copy");
     int availableUrlCopySlots = maxUrlCopy - urlCopyCount;
 
     if (availableUrlCopySlots <= 0) {
@@ -59,7 +59,7 @@ void ForceStartTransfersService::forceRunJobs() {
         return;
     }
 
-    ThreadPool<FileTransferExecutor> execPool(execPoolSize);
+    ThreadPool<FileTransferExecutor> execPool(executor);
 
     try {
         auto tfs = db::DBSingleton::instance().getDBObjectInstance()->getForceStartTransfers();
@@ -68,6 +68,10 @@ void ForceStartTransfersService::forceRunJobs() {
             return;
         }
 
+        std::map<std::string, std::list<TransferFile>> voQueues;
+        voQueues[std::string()] = tfs;
+        auto configSnapshot = db::DBSingleton::instance().getDBObjectInstance()->getConfigSnapshot(voQueues);
+
         std::map<std::pair<std::string, std::string>, std::string> proxies;
 
         for (auto& tf: tfs) {
@@ -87,8 +91,10 @@ void ForceStartTransfersService::forceRunJobs() {
             }
 
             FileTransferExecutor *exec = new FileTransferExecutor(tf, monitoringMessages, infosys, ftsHostName,
-                                                                  proxies[proxy_key], logDir, msgDir);
-            execPool.start(exec);
+                                                                  proxies[proxy_key], logDir, msgDir,
+                                                                  configSnapshot);
+            // Forced transfers go ahead of the ones queued by the regular scheduler
+            execPool.start(exec, Executor::PRIORITY_HIGH);
 
             if (--availableUrlCopySlots <= 0) {
                 FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Reached limitation of MaxUrlCopyProcesses (ForceStartTransfers)"
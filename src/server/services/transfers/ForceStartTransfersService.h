@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <memory>
+
+#include "common/Executor.h"
 #include "services/BaseService.h"
 #include "services/heartbeat/HeartBeat.h"
 
@@ -25,14 +28,14 @@ namespace server {
 class ForceStartTransfersService: public BaseService
 {
 public:
-    ForceStartTransfersService(HeartBeat *beat);
+    ForceStartTransfersService(HeartBeat *beat, std::shared_ptr<fts3::common::Executor> executor);
     virtual void runService();
 
 protected:
     std::string ftsHostName;
     std::string infosys;
     bool monitoringMessages;
-    int execPoolSize;
+    std::shared_ptr<fts3::common::Executor> executor;
     std::string logDir;
     std::string msgDir;
     boost::posix_time::time_duration pollInterval;
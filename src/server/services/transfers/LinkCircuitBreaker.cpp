@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <algorithm>
+
+#include "LinkCircuitBreaker.h"
+#include "common/Logger.h"
+
+using namespace fts3::common;
+
+
+namespace fts3 {
+namespace server {
+
+
+static bool findSubstring(const std::string &stack, const char *needles[])
+{
+    for (size_t i = 0; needles[i] != NULL; ++i) {
+        if (stack.find(needles[i]) != std::string::npos)
+            return true;
+    }
+    return false;
+}
+
+
+LinkCircuitBreaker::LinkCircuitBreaker(): enabled(false), lastPrune(0)
+{
+}
+
+
+LinkCircuitBreaker::~LinkCircuitBreaker()
+{
+}
+
+
+void LinkCircuitBreaker::enable(const Settings &newSettings)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    enabled = true;
+    settings = newSettings;
+    settings.window = std::max(1u, settings.window);
+    settings.probes = std::max(1u, settings.probes);
+    settings.backoff = std::max<time_t>(1, settings.backoff);
+    settings.maxBackoff = std::max(settings.backoff, settings.maxBackoff);
+}
+
+
+bool LinkCircuitBreaker::isEnabled()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return enabled;
+}
+
+
+bool LinkCircuitBreaker::isLinkError(int errcode, const std::string &message)
+{
+    // Errors about the file itself, whatever the code says
+    const char *msg_file_error[] = {
+        "No such file or directory",
+        "File exists",
+        "file exists",
+        "checksum do not match",
+        "CHECKSUM MISMATCH",
+        "SRM_INVALID_PATH",
+        "The source file is not ONLINE",
+        "proxy expired",
+        "The certificate has expired",
+        NULL
+    };
+
+    if (findSubstring(message, msg_file_error))
+        return false;
+
+    // Errors about the storage or the network in between
+    const char *msg_link_error[] = {
+        "Connection refused",
+        "Connection timed out",
+        "Connection reset by peer",
+        "No route to host",
+        "Network is unreachable",
+        "Name or service not known",
+        "Could not resolve host",
+        "Service Unavailable",
+        "SRM_NO_FREE_SPACE",
+        "No space left on device",
+        NULL
+    };
+
+    if (findSubstring(message, msg_link_error))
+        return true;
+
+    switch (errcode) {
+        case ECONNREFUSED:  // Connection refused
+        case ECONNRESET:    // Connection reset by peer
+        case ECONNABORTED:  // Connection aborted
+        case EHOSTUNREACH:  // No route to host
+        case EHOSTDOWN:     // Host is down
+        case ENETUNREACH:   // Network is unreachable
+        case ENETDOWN:      // Network is down
+        case ETIMEDOUT:     // Connection timed out
+        case ECOMM:         // Communication error on send
+        case ENOSPC:        // No space left on device
+            return true;
+    }
+
+    return false;
+}
+
+
+const char *LinkCircuitBreaker::stateName(State state)
+{
+    switch (state) {
+        case OPEN:
+            return "open";
+        case HALF_OPEN:
+            return "half-open";
+        default:
+            return "closed";
+    }
+}
+
+
+void LinkCircuitBreaker::open(const Link &link, LinkState &linkState, time_t backoff, time_t now)
+{
+    linkState.state = OPEN;
+    linkState.backoff = std::min(backoff, settings.maxBackoff);
+    linkState.retryAt = now + linkState.backoff;
+    linkState.probesInFlight = 0;
+
+    FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Circuit breaker open for " << link.first << " => " << link.second
+        << ": " << linkState.failures << " of the last " << linkState.outcomes.size()
+        << " transfers failed with link errors. Paused for " << linkState.backoff << " seconds"
+        << commit;
+}
+
+
+void LinkCircuitBreaker::close(const Link &link, LinkState &linkState)
+{
+    linkState.state = CLOSED;
+    linkState.outcomes.clear();
+    linkState.failures = 0;
+    linkState.backoff = 0;
+    linkState.retryAt = 0;
+    linkState.probesInFlight = 0;
+
+    FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Circuit breaker closed for " << link.first << " => " << link.second
+        << commit;
+}
+
+
+void LinkCircuitBreaker::expireBackoff(LinkState &linkState, time_t now)
+{
+    if (linkState.state == OPEN && now >= linkState.retryAt) {
+        linkState.state = HALF_OPEN;
+        linkState.probesInFlight = 0;
+    }
+}
+
+
+/// Drop the closed links idle for longer than the maximum backoff, checked at most once
+/// per maximum backoff. They hold no more than a stale window, so the map does not grow
+/// with every link ever seen
+void LinkCircuitBreaker::prune(time_t now)
+{
+    if (now - lastPrune < settings.maxBackoff) {
+        return;
+    }
+    lastPrune = now;
+
+    for (auto i = links.begin(); i != links.end();) {
+        if (i->second.state == CLOSED && now - i->second.lastRecord >= settings.maxBackoff) {
+            i = links.erase(i);
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+
+void LinkCircuitBreaker::record(const std::string &sourceSe, const std::string &destSe,
+    const std::string &transferState, int errcode, const std::string &message, time_t now)
+{
+    if (transferState != "FINISHED" && transferState != "FAILED") {
+        return;
+    }
+    bool linkError = (transferState == "FAILED" && isLinkError(errcode, message));
+
+    boost::mutex::scoped_lock lock(mutex);
+    if (!enabled) {
+        return;
+    }
+
+    prune(now);
+
+    Link link(sourceSe, destSe);
+    LinkState &linkState = links[link];
+    linkState.lastRecord = now;
+    expireBackoff(linkState, now);
+
+    switch (linkState.state) {
+        case CLOSED:
+            linkState.outcomes.push_back(linkError);
+            linkState.failures += linkError;
+            while (linkState.outcomes.size() > settings.window) {
+                linkState.failures -= linkState.outcomes.front();
+                linkState.outcomes.pop_front();
+            }
+            if (linkState.outcomes.size() >= settings.minSamples &&
+                linkState.failures >= settings.failureRatio * linkState.outcomes.size()) {
+                open(link, linkState, settings.backoff, now);
+            }
+            break;
+        case HALF_OPEN:
+            // Could also be a transfer started before opening, which is as good as a probe
+            if (linkError) {
+                open(link, linkState, linkState.backoff * 2, now);
+            }
+            else {
+                close(link, linkState);
+            }
+            break;
+        case OPEN:
+            // Started before opening
+            break;
+    }
+}
+
+
+bool LinkCircuitBreaker::isOpen(const std::string &sourceSe, const std::string &destSe, time_t now)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    auto i = links.find(Link(sourceSe, destSe));
+    if (i == links.end()) {
+        return false;
+    }
+    expireBackoff(i->second, now);
+    return i->second.state == OPEN;
+}
+
+
+bool LinkCircuitBreaker::allow(const std::string &sourceSe, const std::string &destSe, time_t now)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    auto i = links.find(Link(sourceSe, destSe));
+    if (i == links.end()) {
+        return true;
+    }
+
+    LinkState &linkState = i->second;
+    expireBackoff(linkState, now);
+
+    switch (linkState.state) {
+        case CLOSED:
+            return true;
+        case OPEN:
+            return false;
+        case HALF_OPEN:
+            // Probes that never report back, i.e. picked by another node, do not block the link
+            if (linkState.probesInFlight > 0 && now - linkState.lastProbe >= linkState.backoff) {
+                linkState.probesInFlight = 0;
+            }
+            if (linkState.probesInFlight >= settings.probes) {
+                return false;
+            }
+            ++linkState.probesInFlight;
+            linkState.lastProbe = now;
+            return true;
+    }
+    return true;
+}
+
+
+LinkCircuitBreaker::Status LinkCircuitBreaker::getStatus(const std::string &sourceSe, const std::string &destSe,
+    time_t now)
+{
+    Status status;
+
+    boost::mutex::scoped_lock lock(mutex);
+    auto i = links.find(Link(sourceSe, destSe));
+    if (i == links.end()) {
+        return status;
+    }
+
+    expireBackoff(i->second, now);
+    status.state = i->second.state;
+    status.samples = i->second.outcomes.size();
+    if (status.samples > 0) {
+        status.failureRatio = static_cast<double>(i->second.failures) / status.samples;
+    }
+    if (status.state == OPEN) {
+        status.retryAt = i->second.retryAt;
+    }
+    return status;
+}
+
+
+size_t LinkCircuitBreaker::size()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return links.size();
+}
+
+} // namespace server
+} // namespace fts3
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef LINKCIRCUITBREAKER_H_
+#define LINKCIRCUITBREAKER_H_
+
+#include <ctime>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+
+#include <boost/thread.hpp>
+
+#include "common/Singleton.h"
+
+
+namespace fts3 {
+namespace server {
+
+/// Stops scheduling transfers on links that keep failing for reasons unrelated to the files.
+///
+/// MessageProcessingService records the terminal state of the transfers. When enough of the
+/// recent transfers of a link failed with a link error (see isLinkError), the breaker opens
+/// and the TransfersService does not schedule the link until the backoff expires. Then only
+/// a few probe transfers go through: if one of them fails with a link error the breaker opens
+/// again for twice as long, otherwise it closes.
+///
+/// The state is kept per node, fed by the transfers the node itself runs. Closed links
+/// that did not report anything for longer than the maximum backoff are forgotten.
+class LinkCircuitBreaker: public fts3::common::Singleton<LinkCircuitBreaker>
+{
+public:
+    /// Source and destination storage
+    typedef std::pair<std::string, std::string> Link;
+
+    enum State {
+        CLOSED,     ///< Scheduled normally
+        OPEN,       ///< Not scheduled until the backoff expires
+        HALF_OPEN   ///< Only probe transfers are scheduled
+    };
+
+    struct Settings {
+        unsigned window;        ///< Number of recent transfers considered
+        unsigned minSamples;    ///< Do not open with less transfers than these
+        double failureRatio;    ///< Open when this fraction of the window failed with link errors
+        time_t backoff;         ///< First pause, in seconds
+        time_t maxBackoff;      ///< The pause doubles with each failed probe up to this
+        unsigned probes;        ///< Transfers let through at once when half open
+
+        Settings(): window(50), minSamples(20), failureRatio(0.9), backoff(60), maxBackoff(1800), probes(2)
+        {}
+    };
+
+    struct Status {
+        State state;
+        unsigned samples;       ///< Transfers in the window
+        double failureRatio;    ///< Fraction of them that failed with link errors
+        time_t retryAt;         ///< When open, when the probes start
+
+        Status(): state(CLOSED), samples(0), failureRatio(0), retryAt(0)
+        {}
+    };
+
+    LinkCircuitBreaker();
+    virtual ~LinkCircuitBreaker();
+
+    /// Nothing is recorded, and all links are closed, until enabled
+    void enable(const Settings &settings);
+
+    /// @return true if enabled
+    bool isEnabled();
+
+    /// @return true if the error means the link, rather than the file, is broken
+    static bool isLinkError(int errcode, const std::string &message);
+
+    /// @return a printable name for the state
+    static const char *stateName(State state);
+
+    /// Record the terminal state of a transfer. CANCELED is ignored
+    void record(const std::string &sourceSe, const std::string &destSe, const std::string &transferState,
+        int errcode, const std::string &message, time_t now = time(NULL));
+
+    /// @return true if nothing can be scheduled on the link, so there is no point fetching its files
+    bool isOpen(const std::string &sourceSe, const std::string &destSe, time_t now = time(NULL));
+
+    /// Ask for permission to start a transfer on the link.
+    /// When half open, each granted permission is a probe
+    bool allow(const std::string &sourceSe, const std::string &destSe, time_t now = time(NULL));
+
+    Status getStatus(const std::string &sourceSe, const std::string &destSe, time_t now = time(NULL));
+
+    /// @return number of links with some state kept
+    size_t size();
+
+private:
+    struct LinkState {
+        State state;
+        std::deque<bool> outcomes;  ///< true for link errors
+        unsigned failures;
+        time_t backoff;
+        time_t retryAt;
+        unsigned probesInFlight;
+        time_t lastProbe;
+        time_t lastRecord;
+
+        LinkState(): state(CLOSED), failures(0), backoff(0), retryAt(0), probesInFlight(0), lastProbe(0),
+            lastRecord(0)
+        {}
+    };
+
+    boost::mutex mutex;
+    bool enabled;
+    Settings settings;
+    std::map<Link, LinkState> links;
+    time_t lastPrune;
+
+    void open(const Link &link, LinkState &linkState, time_t backoff, time_t now);
+    void close(const Link &link, LinkState &linkState);
+    void expireBackoff(LinkState &linkState, time_t now);
+    void prune(time_t now);
+};
+
+} // namespace server
+} // namespace fts3
+
+#endif // LINKCIRCUITBREAKER_H_
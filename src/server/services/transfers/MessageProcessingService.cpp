@@ -21,13 +21,22 @@
 #include "MessageProcessingService.h"
 
 #include <glib.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
 #include <boost/filesystem.hpp>
 
 #include "common/Exceptions.h"
 #include "config/ServerConfig.h"
 #include "common/Logger.h"
 #include "db/generic/SingleDbInstance.h"
+#include "BundledTransfers.h"
+#include "LinkCircuitBreaker.h"
+#include "ProgressWriter.h"
+#include "SchedulerWakeup.h"
 #include "SingleTrStateInstance.h"
+#include "StatusBatch.h"
 #include "ThreadSafeList.h"
 
 
@@ -41,16 +50,143 @@ namespace server {
 extern time_t updateRecords;
 
 
+MessageProcessingService::Shard::Shard(const std::string &messagingDirectory):
+    producer(messagingDirectory), queue(std::numeric_limits<size_t>::max()), inProgress(0), processed(0)
+{
+}
+
+
 MessageProcessingService::MessageProcessingService(): BaseService("MessageProcessingService"),
     consumer(ServerConfig::instance().get<std::string>("MessagingDirectory")),
     producer(ServerConfig::instance().get<std::string>("MessagingDirectory"))
 {
     messages.reserve(600);
+    statusBatchSize = ServerConfig::instance().get<unsigned>("MessagingStatusBatchSize");
+    consumer.setParseThreads(ServerConfig::instance().get<unsigned>("MessagingParseThreads"));
+
+    unsigned nShards = ServerConfig::instance().get<unsigned>("MessagingShards");
+    shardMaxBacklog = std::max(1u, ServerConfig::instance().get<unsigned>("MessagingShardMaxBacklog"));
+    if (nShards > 1) {
+        for (unsigned i = 0; i < nShards; ++i) {
+            shards.emplace_back(new Shard(ServerConfig::instance().get<std::string>("MessagingDirectory")));
+        }
+    }
 }
 
 
 MessageProcessingService::~MessageProcessingService()
 {
+    stopShards();
+}
+
+
+size_t MessageProcessingService::getShardIndex(const fts3::events::Message &msg, size_t nShards)
+{
+    if (msg.job_id().empty()) {
+        return std::hash<int>()(msg.process_id()) % nShards;
+    }
+    return std::hash<std::string>()(msg.job_id()) % nShards;
+}
+
+
+std::vector<MessageProcessingService::ShardMetrics> MessageProcessingService::getShardMetrics()
+{
+    std::vector<ShardMetrics> metrics;
+    for (auto shard = shards.begin(); shard != shards.end(); ++shard) {
+        ShardMetrics shardMetrics;
+        shardMetrics.backlog = (*shard)->queue.size() + (*shard)->inProgress;
+        shardMetrics.processed = (*shard)->processed;
+        metrics.push_back(shardMetrics);
+    }
+    return metrics;
+}
+
+
+bool MessageProcessingService::shardsFull()
+{
+    for (auto shard = shards.begin(); shard != shards.end(); ++shard) {
+        if ((*shard)->queue.size() + (*shard)->inProgress >= shardMaxBacklog) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void MessageProcessingService::dispatchToShards(std::vector<fts3::events::Message>& messages)
+{
+    for (auto iter = messages.begin(); iter != messages.end(); ++iter) {
+        Shard &shard = *shards[getShardIndex(*iter, shards.size())];
+        fts3::events::Message msg(*iter);
+        if (!shard.queue.push(std::move(msg))) {
+            producer.runProducerStatus(*iter);
+        }
+    }
+}
+
+
+void MessageProcessingService::runShard(Shard &shard)
+{
+    std::vector<fts3::events::Message> batch;
+
+    try {
+        while (shard.queue.popMany(batch, shardMaxBacklog)) {
+            shard.inProgress = batch.size();
+            if (boost::this_thread::interruption_requested()) {
+                break;
+            }
+
+            // An exception must not end the thread, nor the server with it
+            try {
+                handleOtherMessages(batch, shard.producer);
+                handleUpdateMessages(batch, shard.producer);
+
+                // If interrupted meanwhile, the batch has been dumped already
+                if (!boost::this_thread::interruption_requested()) {
+                    shard.processed += batch.size();
+                }
+            }
+            catch (const boost::thread_interrupted&) {
+                throw;
+            }
+            catch (const std::exception& e) {
+                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message shard thrown exception: " << e.what() << commit;
+                dumpMessages(batch, shard.producer);
+            }
+            catch (...) {
+                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message shard thrown unhandled exception" << commit;
+                dumpMessages(batch, shard.producer);
+            }
+            shard.inProgress = 0;
+            batch.clear();
+        }
+    }
+    catch (const boost::thread_interrupted&) {
+        // pass
+    }
+
+    // Whatever is left is consumed again on the next start
+    shard.queue.close();
+    shard.queue.popMany(batch, std::numeric_limits<size_t>::max());
+    if (!batch.empty()) {
+        dumpMessages(batch, shard.producer);
+    }
+    shard.inProgress = 0;
+}
+
+
+void MessageProcessingService::stopShards()
+{
+    for (auto thread = shardThreads.begin(); thread != shardThreads.end(); ++thread) {
+        thread->interrupt();
+    }
+    for (auto shard = shards.begin(); shard != shards.end(); ++shard) {
+        (*shard)->queue.close();
+    }
+    for (auto thread = shardThreads.begin(); thread != shardThreads.end(); ++thread) {
+        thread->join();
+    }
+    shardThreads.clear();
 }
 
 
@@ -60,6 +196,15 @@ void MessageProcessingService::runService()
 
     auto msgCheckInterval = config::ServerConfig::instance().get<boost::posix_time::time_duration>("MessagingConsumeInterval");
 
+    for (auto shard = shards.begin(); shard != shards.end(); ++shard) {
+        Shard *shardPtr = shard->get();
+        shardThreads.emplace_back([this, shardPtr]() { runShard(*shardPtr); });
+    }
+    if (!shards.empty()) {
+        FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Applying the status messages with " << shards.size() << " shards" << commit;
+    }
+    time_t lastShardReport = time(0);
+
     while (!boost::this_thread::interruption_requested())
     {
         updateRecords = time(0);
@@ -82,8 +227,12 @@ void MessageProcessingService::runService()
                 continue;
             }
 
-            // update statuses
-            if (consumer.runConsumerStatus(messages) != 0)
+            // update statuses, unless the shards are still busy with the previous ones
+            if (!shards.empty() && shardsFull())
+            {
+                FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "Message shards full, status messages left in the queue" << commit;
+            }
+            else if (consumer.runConsumerStatus(messages) != 0)
             {
                 char buffer[128] = {0};
                 FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Could not get the status messages:" << strerror_r(errno, buffer, sizeof(buffer)) << commit;
@@ -92,11 +241,28 @@ void MessageProcessingService::runService()
 
             if (!messages.empty())
             {
-                handleOtherMessages(messages);
-                handleUpdateMessages(messages);
+                if (shards.empty()) {
+                    handleOtherMessages(messages, producer);
+                    handleUpdateMessages(messages, producer);
+                }
+                else {
+                    dispatchToShards(messages);
+                }
                 messages.clear();
             }
 
+            if (!shards.empty() && time(0) - lastShardReport >= 60)
+            {
+                std::vector<ShardMetrics> metrics = getShardMetrics();
+                for (size_t i = 0; i < metrics.size(); ++i) {
+                    FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Message shard " << i
+                        << " backlog=" << metrics[i].backlog
+                        << " processed=" << metrics[i].processed
+                        << commit;
+                }
+                lastShardReport = time(0);
+            }
+
             // update log file path
             if (consumer.runConsumerLog(messagesLog) != 0)
             {
@@ -132,12 +298,13 @@ void MessageProcessingService::runService()
                         << "\nThroughput: " << (*iterUpdater).throughput()
                         << "\nTransferred: " << (*iterUpdater).transferred()
                         << commit;
-                    ThreadSafeList::get_instance().updateMsg(*iterUpdater);
                 }
+                ThreadSafeList::get_instance().updateMsg(messagesUpdater);
 
-                db::DBSingleton::instance().getDBObjectInstance()->updateFileTransferProgressVector(messagesUpdater);
+                ProgressWriter::instance().add(messagesUpdater);
                 messagesUpdater.clear();
             }
+            ProgressWriter::instance().flushIfDue();
         }
         catch (const std::exception& e) {
             FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message queue thrown exception: " << e.what() << commit;
@@ -150,10 +317,12 @@ void MessageProcessingService::runService()
 
         boost::this_thread::sleep(msgCheckInterval);
     }
+
+    stopShards();
 }
 
 
-void MessageProcessingService::performUpdateMessageDbChange(const fts3::events::Message& msg)
+void MessageProcessingService::performUpdateMessageDbChange(const fts3::events::Message& msg, Producer& producer)
 {
     try
     {
@@ -196,113 +365,157 @@ void MessageProcessingService::performUpdateMessageDbChange(const fts3::events::
 }
 
 
-void MessageProcessingService::performOtherMessageDbChange(const fts3::events::Message& msg)
+bool MessageProcessingService::prepareOtherMessage(const fts3::events::Message& msg,
+    std::map<std::string, int>& retryCache)
 {
-    try
-    {
-        // do not process UPDATE messages
-        if (msg.transfer_status().compare("UPDATE") == 0)
-            return;
+    FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Job id: " << msg.job_id()
+                                    << "\nFile id: " << msg.file_id()
+                                    << "\nPid: " << msg.process_id()
+                                    << "\nState: " << msg.transfer_status()
+                                    << "\nSource: " << msg.source_se()
+                                    << "\nDest: " << msg.dest_se() << commit;
+
+    if (msg.transfer_status().compare("FINISHED") == 0) {
+        FTS3_COMMON_LOGGER_NEWLOG(PROF) << "[profiling:transfer]"
+                                        << " file_id=" << msg.file_id()
+                                        << " timestamp=" << msg.gfal_perf_timestamp() / 1000
+                                        << " inst_throughput=" << msg.instantaneous_throughput()
+                                        << " dif_transferred=" << msg.transferred_since_last_ping()
+                                        << " source_se=" << msg.source_se()
+                                        << " dest_se=" << msg.dest_se()
+                                        << commit;
+    }
 
-        FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Job id: " << msg.job_id()
-                                        << "\nFile id: " << msg.file_id()
-                                        << "\nPid: " << msg.process_id()
-                                        << "\nState: " << msg.transfer_status()
-                                        << "\nSource: " << msg.source_se()
-                                        << "\nDest: " << msg.dest_se() << commit;
-
-        if (msg.transfer_status().compare("FINISHED") == 0) {
-            FTS3_COMMON_LOGGER_NEWLOG(PROF) << "[profiling:transfer]"
-                                            << " file_id=" << msg.file_id()
-                                            << " timestamp=" << msg.gfal_perf_timestamp() / 1000
-                                            << " inst_throughput=" << msg.instantaneous_throughput()
-                                            << " dif_transferred=" << msg.transferred_since_last_ping()
-                                            << " source_se=" << msg.source_se()
-                                            << " dest_se=" << msg.dest_se()
-                                            << commit;
-        }
 
+    if (msg.transfer_status().compare("FINISHED") == 0 ||
+        msg.transfer_status().compare("FAILED") == 0 ||
+        msg.transfer_status().compare("CANCELED") == 0)
+    {
+        FTS3_COMMON_LOGGER_NEWLOG(INFO)
+            << "Removing job from monitoring list " << msg.job_id() << " " << msg.file_id()
+            << commit;
+        ThreadSafeList::get_instance().removeFinishedTr(msg.job_id(), msg.file_id());
+        ProgressWriter::instance().discard(msg.file_id());
+    }
 
-        if (msg.transfer_status().compare("FINISHED") == 0 ||
-            msg.transfer_status().compare("FAILED") == 0 ||
-            msg.transfer_status().compare("CANCELED") == 0)
-        {
-            FTS3_COMMON_LOGGER_NEWLOG(INFO)
-                << "Removing job from monitoring list " << msg.job_id() << " " << msg.file_id()
-                << commit;
-            ThreadSafeList::get_instance().removeFinishedTr(msg.job_id(), msg.file_id());
+    if (msg.transfer_status().compare("CANCELED") == 0) {
+        if (requeueIfCanceledAlongside(*db::DBSingleton::instance().getDBObjectInstance(), msg)) {
+            return false;
         }
+    }
+    else if (msg.transfer_status().compare("FINISHED") == 0 || msg.transfer_status().compare("FAILED") == 0) {
+        BundledTransfers::instance().release(msg.process_id(), msg.file_id());
+    }
 
-        if (msg.transfer_status().compare("FAILED") == 0)
+    if (msg.transfer_status().compare("FAILED") == 0)
+    {
+        try
         {
-            try
+            // multiple replica files belonging to a job will not be retried
+            auto cached = retryCache.find(msg.job_id());
+            if (cached == retryCache.end()) {
+                cached = retryCache.insert(std::make_pair(msg.job_id(),
+                    db::DBSingleton::instance().getDBObjectInstance()->getRetry(msg.job_id()))).first;
+            }
+            int retry = cached->second;
+
+            if (msg.retry() == true && retry > 0 && msg.file_id() > 0)
             {
-                // multiple replica files belonging to a job will not be retried
-                int retry = db::DBSingleton::instance().getDBObjectInstance()->getRetry(msg.job_id());
+                int retryTimes = db::DBSingleton::instance().getDBObjectInstance()->getRetryTimes(msg.job_id(), msg.file_id());
 
-                if (msg.retry() == true && retry > 0 && msg.file_id() > 0)
+                if (retryTimes <= retry - 1)
                 {
-                    int retryTimes = db::DBSingleton::instance().getDBObjectInstance()->getRetryTimes(msg.job_id(), msg.file_id());
-
-                    if (retryTimes <= retry - 1)
-                    {
-                        db::DBSingleton::instance().getDBObjectInstance()->setRetryTransfer(
-                            msg.job_id(), msg.file_id(), retryTimes + 1,
-                            msg.transfer_message(), msg.log_path(), msg.errcode());
-                        return;
-                    }
+                    db::DBSingleton::instance().getDBObjectInstance()->setRetryTransfer(
+                        msg.job_id(), msg.file_id(), retryTimes + 1,
+                        msg.transfer_message(), msg.log_path(), msg.errcode());
+                    return false;
                 }
             }
-            catch (std::exception& e)
-            {
-                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message queue performOtherMessageDbChange throw exception when set retry " << e.what() << commit;
-            }
-            catch (...)
-            {
-                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message queue performOtherMessageDbChange throw exception when set retry " << commit;
-            }
         }
-
-        // session reuse process died or terminated unexpected. Terminate all files of a given job
-        if (isUnrecoverableErrorMessage(msg.transfer_message()))
+        catch (std::exception& e)
         {
-            db::DBSingleton::instance().getDBObjectInstance()->terminateReuseProcess(
-                msg.job_id(), msg.process_id(), msg.transfer_message());
-        }
-
-        // update file and job state
-        boost::tuple<bool, std::string> updated = db::DBSingleton::instance()
-            .getDBObjectInstance()->updateTransferStatus(
-                msg.job_id(), msg.file_id(), msg.throughput(), msg.transfer_status(),
-                msg.transfer_message(), msg.process_id(), msg.filesize(), msg.time_in_secs(), msg.retry(),
-                msg.file_metadata());
-
-        db::DBSingleton::instance().getDBObjectInstance()->updateJobStatus(
-            msg.job_id(), msg.transfer_status());
-
-        if (!updated.get<0>() && msg.transfer_status() != "CANCELED") {
-            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Entry in the database not updated for "
-                << msg.job_id() << " " << msg.file_id()
-                << ". Probably already in a different terminal state. Tried to set "
-                << msg.transfer_status() << " over " << updated.get<1>() << commit;
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message queue performOtherMessageDbChange throw exception when set retry " << e.what() << commit;
         }
-        else if (!msg.job_id().empty() && msg.file_id() > 0) {
-            SingleTrStateInstance::instance().sendStateMessage(msg.job_id(), msg.file_id());
+        catch (...)
+        {
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message queue performOtherMessageDbChange throw exception when set retry " << commit;
         }
     }
-    catch (const std::exception& e)
+
+    // session reuse process died or terminated unexpected. Terminate all files of a given job
+    if (isUnrecoverableErrorMessage(msg.transfer_message()))
     {
-        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message queue performOtherMessageDbChange throw exception " << e.what() << commit;
+        db::DBSingleton::instance().getDBObjectInstance()->terminateReuseProcess(
+            msg.job_id(), msg.process_id(), msg.transfer_message());
+    }
 
-        // Encountered unexpected DB error. Terminate all files of a given job
-        if (isUnrecoverableErrorMessage(e.what())) {
-            FTS3_COMMON_LOGGER_NEWLOG(CRIT) << "Attempted database change with invalid values: " << e.what() << commit;
-            db::DBSingleton::instance().getDBObjectInstance()->terminateReuseProcess(
-                    msg.job_id(), msg.process_id(), "Database change failed due to invalid values", true);
+    return true;
+}
+
+
+void MessageProcessingService::applyOtherMessage(const fts3::events::Message& msg)
+{
+    // update file and job state
+    boost::tuple<bool, std::string> updated = db::DBSingleton::instance()
+        .getDBObjectInstance()->updateTransferStatus(
+            msg.job_id(), msg.file_id(), msg.throughput(), msg.transfer_status(),
+            msg.transfer_message(), msg.process_id(), msg.filesize(), msg.time_in_secs(), msg.retry(),
+            msg.file_metadata());
+
+    db::DBSingleton::instance().getDBObjectInstance()->updateJobStatus(
+        msg.job_id(), msg.transfer_status());
+
+    reportStatusUpdate(msg, updated);
+}
+
+
+void MessageProcessingService::reportStatusUpdate(const fts3::events::Message& msg,
+    const boost::tuple<bool, std::string>& updated)
+{
+    if (!updated.get<0>() && msg.transfer_status() != "CANCELED") {
+        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Entry in the database not updated for "
+            << msg.job_id() << " " << msg.file_id()
+            << ". Probably already in a different terminal state. Tried to set "
+            << msg.transfer_status() << " over " << updated.get<1>() << commit;
+    }
+    else if (!msg.job_id().empty() && msg.file_id() > 0) {
+        SingleTrStateInstance::instance().sendStateMessage(msg.job_id(), msg.file_id());
+    }
+}
+
+
+void MessageProcessingService::recoverFailedDbChange(const fts3::events::Message& msg, const std::string& error,
+    Producer& producer)
+{
+    // Encountered unexpected DB error. Terminate all files of a given job
+    if (isUnrecoverableErrorMessage(error)) {
+        FTS3_COMMON_LOGGER_NEWLOG(CRIT) << "Attempted database change with invalid values: " << error << commit;
+        db::DBSingleton::instance().getDBObjectInstance()->terminateReuseProcess(
+                msg.job_id(), msg.process_id(), "Database change failed due to invalid values", true);
+        return;
+    }
+
+    producer.runProducerStatus(msg);
+}
+
+
+void MessageProcessingService::performOtherMessageDbChange(const fts3::events::Message& msg, Producer& producer)
+{
+    try
+    {
+        // do not process UPDATE messages
+        if (msg.transfer_status().compare("UPDATE") == 0)
             return;
-        }
 
-        producer.runProducerStatus(msg);
+        std::map<std::string, int> retryCache;
+        if (prepareOtherMessage(msg, retryCache)) {
+            applyOtherMessage(msg);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message queue performOtherMessageDbChange throw exception " << e.what() << commit;
+        recoverFailedDbChange(msg, e.what(), producer);
     }
     catch (...)
     {
@@ -312,7 +525,76 @@ void MessageProcessingService::performOtherMessageDbChange(const fts3::events::M
 }
 
 
-void MessageProcessingService::handleUpdateMessages(const std::vector<fts3::events::Message>& messages)
+void MessageProcessingService::performOtherMessagesBatchDbChange(std::vector<fts3::events::Message>& batch,
+    Producer& producer)
+{
+    // Keep the messages of the same job together, so they are applied in the same transaction
+    std::stable_sort(batch.begin(), batch.end(),
+        [](const fts3::events::Message& a, const fts3::events::Message& b) {
+            return a.job_id() < b.job_id();
+        });
+
+    auto first = batch.begin();
+    while (first != batch.end())
+    {
+        auto last = first;
+        size_t count = 0;
+        while (last != batch.end() && (count < statusBatchSize || last->job_id() == (last - 1)->job_id())) {
+            ++last;
+            ++count;
+        }
+
+        std::vector<fts3::events::Message> chunk(first, last);
+        std::vector<boost::tuple<bool, std::string> > results;
+
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            results = db::DBSingleton::instance().getDBObjectInstance()->updateTransferStatusBatch(chunk);
+        }
+        catch (const std::exception& e)
+        {
+            // Nothing was committed, so fallback to one by one to isolate the offending messages
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Batch status update failed, applying the "
+                << chunk.size() << " messages one by one: " << e.what() << commit;
+
+            for (auto msg = chunk.begin(); msg != chunk.end(); ++msg) {
+                try {
+                    applyOtherMessage(*msg);
+                }
+                catch (const std::exception& e) {
+                    FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message queue performOtherMessageDbChange throw exception " << e.what() << commit;
+                    recoverFailedDbChange(*msg, e.what(), producer);
+                }
+                catch (...) {
+                    FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message queue performOtherMessageDbChange throw exception" << commit;
+                    producer.runProducerStatus(*msg);
+                }
+            }
+            first = last;
+            continue;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        FTS3_COMMON_LOGGER_NEWLOG(INFO) << "DBtime=\"MessageProcessingService\" "
+                                        << "func=\"performOtherMessagesBatchDbChange\" "
+                                        << "DBcall=\"updateTransferStatusBatch\" "
+                                        << "messages=\"" << chunk.size() << "\" "
+                                        << "time_ms=\"" << elapsed << "\""
+                                        << commit;
+
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            reportStatusUpdate(chunk[i], results[i]);
+        }
+
+        first = last;
+    }
+}
+
+
+void MessageProcessingService::handleUpdateMessages(const std::vector<fts3::events::Message>& messages,
+    Producer& producer)
 {
     for (auto iter = messages.begin(); iter != messages.end(); ++iter)
     {
@@ -320,13 +602,13 @@ void MessageProcessingService::handleUpdateMessages(const std::vector<fts3::even
         {
             if (boost::this_thread::interruption_requested())
             {
-                dumpMessages();
+                dumpMessages(messages, producer);
                 return;
             }
 
             if ((*iter).transfer_status().compare("UPDATE") == 0)
             {
-                performUpdateMessageDbChange(*iter);
+                performUpdateMessageDbChange(*iter, producer);
             }
         }
         catch (const boost::filesystem::filesystem_error& e)
@@ -345,9 +627,30 @@ void MessageProcessingService::handleUpdateMessages(const std::vector<fts3::even
 }
 
 
-void MessageProcessingService::handleOtherMessages(const std::vector<fts3::events::Message>& messages)
+void MessageProcessingService::handleOtherMessages(const std::vector<fts3::events::Message>& messages,
+    Producer& producer)
 {
     fts3::events::MessageUpdater msgUpdater;
+    std::map<std::string, int> retryCache;
+
+    StatusBatch batch(
+        [this, &producer](std::vector<fts3::events::Message>& pending) {
+            performOtherMessagesBatchDbChange(pending, producer);
+        },
+        [this, &producer, &retryCache](const fts3::events::Message& msg) {
+            try {
+                return prepareOtherMessage(msg, retryCache);
+            }
+            catch (const std::exception& e) {
+                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message queue performOtherMessageDbChange throw exception " << e.what() << commit;
+                recoverFailedDbChange(msg, e.what(), producer);
+            }
+            catch (...) {
+                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Message queue performOtherMessageDbChange throw exception" << commit;
+                producer.runProducerStatus(msg);
+            }
+            return false;
+        });
 
     for (auto iter = messages.begin(); iter != messages.end(); ++iter)
     {
@@ -355,7 +658,7 @@ void MessageProcessingService::handleOtherMessages(const std::vector<fts3::event
         {
             if (boost::this_thread::interruption_requested())
             {
-                dumpMessages();
+                dumpMessages(messages, producer);
                 return;
             }
 
@@ -370,7 +673,12 @@ void MessageProcessingService::handleOtherMessages(const std::vector<fts3::event
 
             if ((*iter).transfer_status().compare("UPDATE") != 0)
             {
-                performOtherMessageDbChange(*iter);
+                if (statusBatchSize == 0) {
+                    performOtherMessageDbChange(*iter, producer);
+                }
+                else {
+                    batch.add(*iter);
+                }
             }
         }
         catch (const boost::filesystem::filesystem_error& e)
@@ -386,18 +694,28 @@ void MessageProcessingService::handleOtherMessages(const std::vector<fts3::event
             FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Caught exception " << commit;
         }
     }
+
+    batch.flush();
+
+    // The slots of the terminated transfers are free now
+    for (auto iter = messages.begin(); iter != messages.end(); ++iter)
+    {
+        if (iter->transfer_status() == "FINISHED" || iter->transfer_status() == "FAILED" ||
+            iter->transfer_status() == "CANCELED") {
+            LinkCircuitBreaker::instance().record(iter->source_se(), iter->dest_se(),
+                iter->transfer_status(), iter->errcode(), iter->transfer_message());
+            SchedulerWakeup::instance().notify(iter->source_se(), iter->dest_se());
+        }
+    }
 }
 
 
 void MessageProcessingService::dumpMessages()
 {
+    dumpMessages(messages, producer);
+
     try
     {
-        for (auto iter = messages.begin(); iter != messages.end(); ++iter)
-        {
-            producer.runProducerStatus(*iter);
-        }
-
         for (auto iterLog = messagesLog.begin(); iterLog != messagesLog.end(); ++iterLog)
         {
             auto messageLog = (*iterLog).second;
@@ -411,6 +729,22 @@ void MessageProcessingService::dumpMessages()
 }
 
 
+void MessageProcessingService::dumpMessages(const std::vector<fts3::events::Message>& messages, Producer& producer)
+{
+    try
+    {
+        for (auto iter = messages.begin(); iter != messages.end(); ++iter)
+        {
+            producer.runProducerStatus(*iter);
+        }
+    }
+    catch (const boost::filesystem::filesystem_error& e)
+    {
+        FTS3_COMMON_LOGGER_NEWLOG(CRIT) << "Caught exception while dumping messages: " << e.what() << commit;
+    }
+}
+
+
 bool MessageProcessingService::isUnrecoverableErrorMessage(const std::string& errmsg)
 {
     return errmsg.find("Transfer terminate handler called") != std::string::npos ||
@@ -422,5 +756,31 @@ bool MessageProcessingService::isUnrecoverableErrorMessage(const std::string& er
            errmsg.find("Out of range value") != std::string::npos;
 }
 
+
+bool MessageProcessingService::requeueIfCanceledAlongside(GenericDbIfce& db, const fts3::events::Message& msg)
+{
+    if (msg.transfer_status() != "CANCELED" || msg.job_id().empty() || msg.file_id() == 0) {
+        return false;
+    }
+    // Only a bundled url-copy runs files other than the one canceled
+    if (!BundledTransfers::instance().release(msg.process_id(), msg.file_id())) {
+        return false;
+    }
+
+    // The user cancellation marks the file as CANCELED before killing the process
+    std::vector<TransferState> states = db.getStateOfTransfer(msg.job_id(), msg.file_id());
+    if (states.empty() || (states[0].file_state != "READY" && states[0].file_state != "ACTIVE")) {
+        return false;
+    }
+
+    FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Requeuing " << msg.job_id() << " " << msg.file_id()
+        << ", its url-copy " << msg.process_id() << " was canceled along with another file" << commit;
+
+    // Not a failure of the transfer, so it does not count as an attempt
+    db.setRetryTransfer(msg.job_id(), msg.file_id(), db.getRetryTimes(msg.job_id(), msg.file_id()),
+        "Requeued, the url-copy was canceled along with another file", msg.log_path(), msg.errcode());
+    return true;
+}
+
 } // end namespace server
 } // end namespace fts3
@@ -22,8 +22,15 @@
 #ifndef PROCESSQUEUE_H_
 #define PROCESSQUEUE_H_
 
+#include <atomic>
+#include <map>
+#include <memory>
 #include <vector>
+#include <boost/thread.hpp>
+#include <boost/tuple/tuple.hpp>
 
+#include "common/BoundedQueue.h"
+#include "db/generic/GenericDbIfce.h"
 #include "msg-bus/consumer.h"
 #include "msg-bus/producer.h"
 #include "../BaseService.h"
@@ -34,7 +41,24 @@ namespace server {
 
 class MessageProcessingService: public BaseService
 {
+public:
+    struct ShardMetrics {
+        size_t backlog;         ///< Status messages queued or being applied
+        uint64_t processed;     ///< Status messages applied so far
+    };
+
 private:
+    /// Applies, in its own thread, the status messages hashed into it.
+    /// Messages of the same job always go to the same shard, so they are applied in order
+    struct Shard {
+        Producer producer;
+        fts3::common::BoundedQueue<fts3::events::Message> queue;
+        std::atomic<size_t> inProgress;
+        std::atomic<uint64_t> processed;
+
+        Shard(const std::string &messagingDirectory);
+    };
+
     std::vector<fts3::events::Message> messages;
     std::map<int, fts3::events::MessageLog> messagesLog;
     std::vector<fts3::events::MessageUpdater> messagesUpdater;
@@ -42,6 +66,15 @@ private:
     Consumer consumer;
     Producer producer;
 
+    /// Maximum number of status messages applied in one transaction, 0 disables batching
+    unsigned statusBatchSize;
+
+    /// Empty when the status messages are applied by the service thread
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<boost::thread> shardThreads;
+    /// No status message is consumed while a shard has this many pending
+    size_t shardMaxBacklog;
+
 public:
 
     /// Constructor
@@ -52,25 +85,75 @@ public:
 
     virtual void runService();
 
+    /// @return the backlog of each shard, empty when not sharded
+    std::vector<ShardMetrics> getShardMetrics();
+
+    /// Return whether an error message cannot be recovered from
+    static bool isUnrecoverableErrorMessage(const std::string& errmsg);
+
+    /// Canceling a file kills its url-copy, and the other files run by the same process
+    /// are reported as canceled too. Those were not canceled by the user, and are still
+    /// running as far as the database knows: put them back in the queue.
+    /// Only files recorded in BundledTransfers for the pid of the message are considered.
+    /// @return true if the file was requeued, so the message must not be applied
+    static bool requeueIfCanceledAlongside(GenericDbIfce& db, const fts3::events::Message& msg);
+
+    /// @return the shard the message goes to. Messages are hashed by job, so those of a transfer
+    ///         keep their order. Messages without a job id are hashed by the pid of their url-copy
+    ///         instead, so they do not all pile up into the same shard.
+    static size_t getShardIndex(const fts3::events::Message &msg, size_t nShards);
+
 private:
+    /// Queue the consumed status messages into the shards of their jobs
+    void dispatchToShards(std::vector<fts3::events::Message>& messages);
+
+    /// @return true if any shard has too many messages pending to consume more
+    bool shardsFull();
+
+    /// Apply the status messages of a shard until interrupted
+    void runShard(Shard &shard);
+
+    /// Stop the shards, writing back onto disk what they did not apply
+    void stopShards();
+
     /// Handle only messages whose message state is UPDATE.
     /// These messages are usually sent to update certain fields such as filesize.
-    void handleUpdateMessages(const std::vector<fts3::events::Message>& messages);
+    /// @param producer Where the messages that could not be applied are written back
+    void handleUpdateMessages(const std::vector<fts3::events::Message>& messages, Producer& producer);
 
     /// Handle all messages except for UPDATE ones.
     /// Normally, these messages change the file and job status.
-    void handleOtherMessages(const std::vector<fts3::events::Message>& messages);
+    void handleOtherMessages(const std::vector<fts3::events::Message>& messages, Producer& producer);
 
     /// Perform the database change associated with an UPDATE type message
-    void performUpdateMessageDbChange(const fts3::events::Message& msg);
+    void performUpdateMessageDbChange(const fts3::events::Message& msg, Producer& producer);
     /// Perform the database change associated with a non-UPDATE type message
-    void performOtherMessageDbChange(const fts3::events::Message& msg);
+    void performOtherMessageDbChange(const fts3::events::Message& msg, Producer& producer);
+
+    /// Perform the database changes associated with a set of non-UPDATE type messages,
+    /// grouped by job, and applied in transactions of up to statusBatchSize messages
+    void performOtherMessagesBatchDbChange(std::vector<fts3::events::Message>& batch, Producer& producer);
+
+    /// Steps of a non-UPDATE type message that precede the state change: monitoring list, retries
+    /// and terminated processes
+    /// @param retryCache   Number of retries per job, shared by the messages of the same batch
+    /// @return             false if the message has been fully handled (i.e. the transfer is retried)
+    bool prepareOtherMessage(const fts3::events::Message& msg, std::map<std::string, int>& retryCache);
+
+    /// Apply the file and job state change of a non-UPDATE type message
+    void applyOtherMessage(const fts3::events::Message& msg);
+
+    /// Log a rejected state change, or notify the state change otherwise
+    void reportStatusUpdate(const fts3::events::Message& msg, const boost::tuple<bool, std::string>& updated);
+
+    /// Requeue a message that failed to be applied, unless the failure can not be recovered from
+    void recoverFailedDbChange(const fts3::events::Message& msg, const std::string& error, Producer& producer);
 
     /// Dump the messages and messages logs onto disk
     void dumpMessages();
 
-    /// Return whether an error message cannot be recovered from
-    bool isUnrecoverableErrorMessage(const std::string& errmsg);
+    /// Dump the status messages onto disk
+    void dumpMessages(const std::vector<fts3::events::Message>& messages, Producer& producer);
 };
 
 } // end namespace server
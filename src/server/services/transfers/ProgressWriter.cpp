@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ProgressWriter.h"
+#include "common/Logger.h"
+#include "config/ServerConfig.h"
+#include "db/generic/SingleDbInstance.h"
+
+using namespace fts3::common;
+
+
+namespace fts3 {
+namespace server {
+
+
+static void writeToDatabase(const std::vector<fts3::events::MessageUpdater> &messages)
+{
+    db::DBSingleton::instance().getDBObjectInstance()->updateFileTransferProgressVector(messages);
+}
+
+
+ProgressWriter::ProgressWriter(): sink(writeToDatabase), flushSize(0), metrics{0, 0, 0}
+{
+    configure(
+        boost::posix_time::seconds(config::ServerConfig::instance().get<int>("ProgressFlushInterval")),
+        config::ServerConfig::instance().get<unsigned>("ProgressFlushSize"));
+}
+
+
+ProgressWriter::ProgressWriter(const Sink &sink): sink(sink), flushSize(0), metrics{0, 0, 0}
+{
+}
+
+
+ProgressWriter::~ProgressWriter()
+{
+}
+
+
+void ProgressWriter::configure(const boost::posix_time::time_duration &newFlushInterval, size_t newFlushSize)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    flushInterval = newFlushInterval;
+    flushSize = newFlushSize;
+}
+
+
+void ProgressWriter::merge(const fts3::events::MessageUpdater &message)
+{
+    auto i = pending.find(message.file_id());
+    if (i == pending.end()) {
+        pending.emplace(message.file_id(), message);
+    }
+    else if (i->second.timestamp() <= message.timestamp()) {
+        i->second = message;
+    }
+}
+
+
+void ProgressWriter::add(const std::vector<fts3::events::MessageUpdater> &messages,
+    const boost::posix_time::ptime &now)
+{
+    bool due = false;
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        for (auto i = messages.begin(); i != messages.end(); ++i) {
+            // Same filter the database applies, so nothing useless is kept around
+            if (i->file_id() == 0 || i->transfer_status() != "ACTIVE" || i->throughput() <= 0.0) {
+                continue;
+            }
+            merge(*i);
+            ++metrics.received;
+        }
+
+        if (lastFlush.is_not_a_date_time()) {
+            lastFlush = now;
+        }
+        due = !pending.empty() && (
+            (flushSize > 0 && pending.size() >= flushSize) || now - lastFlush >= flushInterval);
+    }
+
+    if (due) {
+        flush(now);
+    }
+}
+
+
+void ProgressWriter::flushIfDue(const boost::posix_time::ptime &now)
+{
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        if (pending.empty() || lastFlush.is_not_a_date_time() || now - lastFlush < flushInterval) {
+            return;
+        }
+    }
+    flush(now);
+}
+
+
+void ProgressWriter::flush(const boost::posix_time::ptime &now)
+{
+    boost::mutex::scoped_lock flushLock(flushMutex);
+
+    std::map<uint64_t, fts3::events::MessageUpdater> batch;
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        batch.swap(pending);
+        lastFlush = now;
+    }
+
+    if (batch.empty()) {
+        return;
+    }
+
+    std::vector<fts3::events::MessageUpdater> messages;
+    messages.reserve(batch.size());
+    for (auto i = batch.begin(); i != batch.end(); ++i) {
+        messages.emplace_back(std::move(i->second));
+    }
+
+    try {
+        sink(messages);
+    }
+    catch (...) {
+        boost::mutex::scoped_lock lock(mutex);
+        for (auto i = messages.begin(); i != messages.end(); ++i) {
+            merge(*i);
+        }
+        throw;
+    }
+
+    boost::mutex::scoped_lock lock(mutex);
+    metrics.written += messages.size();
+    ++metrics.flushes;
+
+    FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "Wrote the progress of " << messages.size() << " transfers" << commit;
+}
+
+
+void ProgressWriter::discard(uint64_t fileId)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    pending.erase(fileId);
+}
+
+
+size_t ProgressWriter::pendingSize()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return pending.size();
+}
+
+
+ProgressWriter::Metrics ProgressWriter::getMetrics()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return metrics;
+}
+
+} // namespace server
+} // namespace fts3
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef PROGRESSWRITER_H_
+#define PROGRESSWRITER_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread.hpp>
+
+#include "common/Singleton.h"
+#include "msg-bus/events.h"
+
+
+namespace fts3 {
+namespace server {
+
+/// Writes the progress of the running transfers into the database.
+///
+/// MessageProcessingService and SupervisorService add the progress messages sent by url-copy.
+/// Only the newest message of each file is kept until the next flush, so the number of rows
+/// written depends on the number of active transfers, not on how often they report.
+/// A flush happens when the flush interval has elapsed, or as soon as the number of
+/// files pending reaches the flush size.
+class ProgressWriter: public fts3::common::Singleton<ProgressWriter>
+{
+public:
+    /// Receives the pending messages, one per file
+    typedef std::function<void(const std::vector<fts3::events::MessageUpdater>&)> Sink;
+
+    struct Metrics {
+        uint64_t received;  ///< Progress messages added
+        uint64_t written;   ///< Messages passed to the sink
+        uint64_t flushes;
+    };
+
+    /// Writes into the database, configured from the server configuration
+    ProgressWriter();
+
+    /// Writes into the given sink. Flushes on every call to add until configured
+    explicit ProgressWriter(const Sink &sink);
+
+    virtual ~ProgressWriter();
+
+    /// @param flushInterval    Maximum time a message waits before being written
+    /// @param flushSize        Number of files pending that triggers a flush. 0 for no limit
+    void configure(const boost::posix_time::time_duration &flushInterval, size_t flushSize);
+
+    /// Keep the progress messages of active transfers, replacing any older message
+    /// of the same file, then flush if the size or time trigger is reached
+    void add(const std::vector<fts3::events::MessageUpdater> &messages,
+        const boost::posix_time::ptime &now = boost::posix_time::microsec_clock::universal_time());
+
+    /// Flush if the flush interval has elapsed since the last one
+    void flushIfDue(const boost::posix_time::ptime &now = boost::posix_time::microsec_clock::universal_time());
+
+    /// Write everything pending. If the sink throws, the messages are kept for the next flush
+    /// unless newer ones arrived meanwhile, and the exception is propagated
+    void flush(const boost::posix_time::ptime &now = boost::posix_time::microsec_clock::universal_time());
+
+    /// Forget the progress not yet written of a transfer that is done
+    void discard(uint64_t fileId);
+
+    /// @return number of files with progress not yet written
+    size_t pendingSize();
+
+    Metrics getMetrics();
+
+private:
+    Sink sink;
+
+    /// Protects the pending messages, the settings and the metrics
+    boost::mutex mutex;
+    /// Serializes flushes, so an older message can not overwrite a newer one
+    boost::mutex flushMutex;
+
+    boost::posix_time::time_duration flushInterval;
+    size_t flushSize;
+    boost::posix_time::ptime lastFlush;
+
+    std::map<uint64_t, fts3::events::MessageUpdater> pending;
+    Metrics metrics;
+
+    /// Keeps the message if it is newer than the pending one of the same file. Needs mutex
+    void merge(const fts3::events::MessageUpdater &message);
+};
+
+} // namespace server
+} // namespace fts3
+
+#endif // PROGRESSWRITER_H_
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RecentLaunches.h"
+
+
+namespace fts3 {
+namespace server {
+
+
+void RecentLaunches::Launched::add(const TransferFile &tf)
+{
+    fileIds.insert(tf.fileId);
+    ++bySource[tf.sourceSe];
+    ++byDestination[tf.destSe];
+}
+
+
+void RecentLaunches::expire(uint64_t batchSeq)
+{
+    while (!launches.empty() && launches.front().first < batchSeq) {
+        launches.pop_front();
+    }
+}
+
+
+void RecentLaunches::record(Launched &&launched, uint64_t doneAtSeq)
+{
+    if (!launched.fileIds.empty()) {
+        launches.emplace_back(doneAtSeq, std::move(launched));
+    }
+}
+
+
+std::set<uint64_t> RecentLaunches::apply(std::map<std::string, int> &slotsLeftForSource,
+    std::map<std::string, int> &slotsLeftForDestination) const
+{
+    std::set<uint64_t> fileIds;
+    for (auto i = launches.begin(); i != launches.end(); ++i) {
+        const Launched &launched = i->second;
+        fileIds.insert(launched.fileIds.begin(), launched.fileIds.end());
+        for (auto se = launched.bySource.begin(); se != launched.bySource.end(); ++se) {
+            slotsLeftForSource[se->first] -= se->second;
+        }
+        for (auto se = launched.byDestination.begin(); se != launched.byDestination.end(); ++se) {
+            slotsLeftForDestination[se->first] -= se->second;
+        }
+    }
+    return fileIds;
+}
+
+} // namespace server
+} // namespace fts3
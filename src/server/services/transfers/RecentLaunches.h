@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef RECENTLAUNCHES_H_
+#define RECENTLAUNCHES_H_
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+
+#include "db/generic/TransferFile.h"
+
+
+namespace fts3 {
+namespace server {
+
+/// Transfers launched by the dispatched batches, which the batches fetched meanwhile
+/// may still see as pending, and whose slots they may still see as free
+class RecentLaunches
+{
+public:
+    /// Files started by a dispatched batch
+    struct Launched {
+        std::set<uint64_t> fileIds;
+        std::map<std::string, int> bySource, byDestination;
+
+        void add(const TransferFile &tf);
+    };
+
+    /// Forget the launches that finished before the fetch of this batch started
+    void expire(uint64_t batchSeq);
+
+    /// Remember a launch
+    /// @param doneAtSeq Number of fetches started when the launch finished
+    void record(Launched &&launched, uint64_t doneAtSeq);
+
+    /// Take the slots used by the launches from the ones left
+    /// @return The files launched, which must not be launched again
+    std::set<uint64_t> apply(std::map<std::string, int> &slotsLeftForSource,
+        std::map<std::string, int> &slotsLeftForDestination) const;
+
+    size_t size() const {
+        return launches.size();
+    }
+
+private:
+    std::deque<std::pair<uint64_t, Launched>> launches;
+};
+
+} // namespace server
+} // namespace fts3
+
+#endif // RECENTLAUNCHES_H_
@@ -22,7 +22,7 @@
 
 #include <fstream>
 
-#include "common/DaemonTools.h"
+#include "common/ChildProcessRegistry.h"
 #include "config/ServerConfig.h"
 #include "cred/DelegCred.h"
 #include "ExecuteProcess.h"
@@ -44,7 +44,7 @@ namespace server {
 extern time_t retrieveRecords;
 
 
-ReuseTransfersService::ReuseTransfersService()
+ReuseTransfersService::ReuseTransfersService(std::shared_ptr<Executor> executor): TransfersService(executor)
 {
     setServiceName("ReuseTransfersService");
 }
@@ -113,42 +113,11 @@ std::map<uint64_t, std::string> ReuseTransfersService::generateJobFile(
 {
     std::vector<std::string> urls;
     std::map<uint64_t, std::string> fileIds;
-    std::ostringstream line;
 
     for (auto it = files.begin(); it != files.end(); ++it)
     {
         fileIds.insert(std::make_pair(it->fileId, it->jobId));
-
-        std::string fileMetadata = UrlCopyCmd::prepareMetadataString(
-                it->fileMetadata);
-        if (fileMetadata.empty())
-            fileMetadata = "x";
-
-        std::string archiveMetadata = UrlCopyCmd::prepareMetadataString(
-                it->transferMetadata);
-        if (archiveMetadata.empty())
-            archiveMetadata = "x";
-
-        std::string bringOnlineToken = it->bringOnlineToken;
-        if (bringOnlineToken.empty())
-            bringOnlineToken = "x";
-
-        std::string checksum = it->checksum;
-        if (checksum.empty())
-            checksum = "x";
-
-        line << std::fixed
-             << it->fileId << " "
-             << it->sourceSurl << " "
-             << it->destSurl << " "
-             << checksum << " "
-             << boost::lexical_cast<long long>(it->userFilesize) << " "
-             << fileMetadata << " "
-             << archiveMetadata << " "
-             << bringOnlineToken << " "
-             << it->scitag;
-        urls.push_back(line.str());
-        line.str(std::string());
+        urls.push_back(UrlCopyCmd::getBulkFileLine(*it));
     }
 
     writeJobFile(jobId, urls);
@@ -321,9 +290,8 @@ void ReuseTransfersService::startUrlCopy(std::string const & job_id, std::list<T
     cmdBuilder.setMaxNumberOfRetries(retry_max < 0 ? 0 : retry_max);
 
     // Log and run
-    std::string params = cmdBuilder.generateParameters();
     FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Transfer params: " << cmdBuilder << commit;
-    ExecuteProcess pr(cmd, params);
+    ExecuteProcess pr(cmd, cmdBuilder.getArguments());
 
     // Check if fork failed , check if execvp failed
     std::string forkMessage;
@@ -414,7 +382,7 @@ void ReuseTransfersService::executeUrlcopy()
 {
     // Bail out as soon as possible if there are too many url-copy processes
     int maxUrlCopy = config::ServerConfig::instance().get<int>("MaxUrlCopyProcesses");
-    int urlCopyCount = countProcessesWithName("fts_url_copy");
+    int urlCopyCount = ChildProcessRegistry::instance().count("fts_url_copy");
     int availableUrlCopySlots = maxUrlCopy - urlCopyCount;
 
     if (availableUrlCopySlots <= 0) {
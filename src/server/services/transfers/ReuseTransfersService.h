@@ -33,7 +33,7 @@ namespace server {
 class ReuseTransfersService: public TransfersService
 {
 public:
-    ReuseTransfersService();
+    ReuseTransfersService(std::shared_ptr<fts3::common::Executor> executor);
     virtual void runService();
 
 protected:
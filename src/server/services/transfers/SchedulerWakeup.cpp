@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SchedulerWakeup.h"
+
+using boost::posix_time::ptime;
+using boost::posix_time::microsec_clock;
+
+
+namespace fts3 {
+namespace server {
+
+
+SchedulerWakeup::SchedulerWakeup(): enabled(false), pendingAny(false)
+{
+    metrics.notifications = 0;
+    metrics.wakeups = 0;
+}
+
+
+SchedulerWakeup::~SchedulerWakeup()
+{
+}
+
+
+void SchedulerWakeup::enable(const boost::posix_time::time_duration &spacing)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    enabled = true;
+    minSpacing = spacing;
+}
+
+
+bool SchedulerWakeup::isEnabled()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return enabled;
+}
+
+
+void SchedulerWakeup::notify(const std::string &sourceSe, const std::string &destSe)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    if (!enabled) {
+        return;
+    }
+    pendingLinks.insert(Link(sourceSe, destSe));
+    ++metrics.notifications;
+    cond.notify_all();
+}
+
+
+void SchedulerWakeup::notifyAll()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    if (!enabled) {
+        return;
+    }
+    pendingAny = true;
+    ++metrics.notifications;
+    cond.notify_all();
+}
+
+
+SchedulerWakeup::Reason SchedulerWakeup::waitUntil(const ptime &deadline, std::set<Link> &links)
+{
+    boost::mutex::scoped_lock lock(mutex);
+
+    ptime now = microsec_clock::universal_time();
+    while (now < deadline) {
+        if (pendingAny || !pendingLinks.empty()) {
+            // Let more notifications accumulate if the last wakeup was too recent
+            ptime earliest = lastWakeup.is_not_a_date_time() ? now : lastWakeup + minSpacing;
+            if (now >= earliest) {
+                Reason reason = pendingAny ? ANY_LINK : LINKS;
+                links.clear();
+                links.swap(pendingLinks);
+                pendingAny = false;
+                lastWakeup = now;
+                ++metrics.wakeups;
+                return reason;
+            }
+            cond.timed_wait(lock, std::min(earliest, deadline));
+        }
+        else {
+            cond.timed_wait(lock, deadline);
+        }
+        now = microsec_clock::universal_time();
+    }
+
+    pendingLinks.clear();
+    pendingAny = false;
+    lastWakeup = now;
+    return DEADLINE;
+}
+
+
+SchedulerWakeup::Metrics SchedulerWakeup::getMetrics()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return metrics;
+}
+
+} // namespace server
+} // namespace fts3
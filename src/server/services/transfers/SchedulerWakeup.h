@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef SCHEDULERWAKEUP_H_
+#define SCHEDULERWAKEUP_H_
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread.hpp>
+
+#include "common/Singleton.h"
+
+
+namespace fts3 {
+namespace server {
+
+/// Tells the TransfersService that transfer slots have been freed, so it does not have to
+/// wait for its next cycle to use them.
+///
+/// MessageProcessingService notifies the links of the transfers that reached a terminal state,
+/// CancelerService the ones it kills. Notifications are coalesced: the scheduler receives
+/// every link notified since its last wakeup at once, and it is not woken up more often
+/// than the configured minimum spacing.
+class SchedulerWakeup: public fts3::common::Singleton<SchedulerWakeup>
+{
+public:
+    /// Source and destination storage
+    typedef std::pair<std::string, std::string> Link;
+
+    enum Reason {
+        DEADLINE,   ///< Nothing was notified before the deadline
+        LINKS,      ///< Slots were freed on the returned links
+        ANY_LINK    ///< Slots were freed, but on unknown links
+    };
+
+    struct Metrics {
+        uint64_t notifications;
+        uint64_t wakeups;
+    };
+
+    SchedulerWakeup();
+    virtual ~SchedulerWakeup();
+
+    /// Notifications are ignored until enabled
+    /// @param minSpacing   Minimum time between two wakeups
+    void enable(const boost::posix_time::time_duration &minSpacing);
+
+    /// @return true if enabled
+    bool isEnabled();
+
+    /// Slots have been freed on the link
+    void notify(const std::string &sourceSe, const std::string &destSe);
+
+    /// Slots have been freed on links that are not known
+    void notifyAll();
+
+    /// Wait until the deadline, or until something is notified. Interruption point
+    /// @param deadline When to give up, in universal time
+    /// @param links    Set to the notified links, if the reason is LINKS
+    /// @return why it returned. A DEADLINE discards the pending notifications,
+    ///         since a full scheduling cycle follows
+    Reason waitUntil(const boost::posix_time::ptime &deadline, std::set<Link> &links);
+
+    Metrics getMetrics();
+
+private:
+    boost::mutex mutex;
+    boost::condition_variable cond;
+
+    bool enabled;
+    boost::posix_time::time_duration minSpacing;
+    boost::posix_time::ptime lastWakeup;
+
+    std::set<Link> pendingLinks;
+    bool pendingAny;
+    Metrics metrics;
+};
+
+} // namespace server
+} // namespace fts3
+
+#endif // SCHEDULERWAKEUP_H_
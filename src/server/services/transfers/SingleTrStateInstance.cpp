@@ -80,3 +80,23 @@ void SingleTrStateInstance::sendStateMessage(const std::string& jobId, uint64_t
         FTS3_COMMON_LOGGER_NEWLOG (ERR) << "Failed saving transfer state " << commit;
     }
 }
+
+
+void SingleTrStateInstance::sendStateMessages(const std::vector<TransferState>& states)
+{
+    if (!monitoringMessages || states.empty())
+        return;
+
+    if (!producer.get()) {
+        producer.reset(new Producer(ServerConfig::instance().get<std::string>("MessagingDirectory")));
+    }
+
+    for (auto it = states.begin(); it != states.end(); ++it) {
+        try {
+            MsgIfce::getInstance()->SendTransferStatusChange(*producer, *it);
+        }
+        catch (std::exception &ex) {
+            FTS3_COMMON_LOGGER_NEWLOG (ERR) << "Failed sending transfer state, " << ex.what() << commit;
+        }
+    }
+}
@@ -58,6 +58,10 @@ public:
 
     void sendStateMessage(const std::string& jobId, uint64_t fileId);
 
+    /// Send the state messages of transfers already read from the database,
+    /// i.e. as returned by terminateTransfers
+    void sendStateMessages(const std::vector<TransferState>& states);
+
 private:
     SingleTrStateInstance(); // Private so that it can  not be called
 
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SpawnHelper.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <paths.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "common/Exceptions.h"
+#include "common/Logger.h"
+
+// Older headers do not know about it, the number is the same for all architectures
+#ifndef SYS_close_range
+#define SYS_close_range 436
+#endif
+
+extern char **environ;
+
+using namespace fts3::common;
+
+
+namespace fts3 {
+namespace server {
+
+/// Requests larger than this are refused, url-copy command lines are a few KB
+static const size_t MAX_REQUEST_SIZE = 128 * 1024;
+
+/// Descriptor of the socket inside the helper
+static const int HELPER_FD = 3;
+
+/// Answer to a spawn request
+struct SpawnReply {
+    int32_t pid;
+    int32_t error;
+};
+
+
+/// Close every descriptor from first on
+static void closeFrom(int first)
+{
+    if (syscall(SYS_close_range, first, ~0U, 0) == 0) {
+        return;
+    }
+    long maxfd = sysconf(_SC_OPEN_MAX);
+    for (int fd = first; fd < maxfd; ++fd) {
+        close(fd);
+    }
+}
+
+
+/// Spawn the process described by the request, a sequence of NUL terminated strings:
+/// the binary, and then its arguments
+static int spawnRequest(char *request, size_t size, pid_t &pid)
+{
+    if (size == 0 || request[size - 1] != '\0') {
+        return EINVAL;
+    }
+
+    std::vector<char*> argv;
+    for (char *arg = request; arg < request + size; arg += strlen(arg) + 1) {
+        argv.push_back(arg);
+    }
+    argv.push_back(NULL);
+
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+
+    sigset_t noSignals;
+    sigemptyset(&noSignals);
+    posix_spawnattr_setsigmask(&attr, &noSignals);
+
+    short flags = POSIX_SPAWN_SETSIGMASK;
+#ifdef POSIX_SPAWN_SETSID
+    flags |= POSIX_SPAWN_SETSID;
+#endif
+    posix_spawnattr_setflags(&attr, flags);
+
+    int error = posix_spawnp(&pid, argv[0], NULL, &attr, argv.data(), environ);
+    posix_spawnattr_destroy(&attr);
+    return error;
+}
+
+
+/// Body of the helper process. It does not log, since the logger state is not safe to use
+/// after forking a threaded process. It exits when the server closes its end of the socket
+static void serve(int sock) __attribute__((noreturn));
+
+static void serve(int sock)
+{
+    if (sock != HELPER_FD) {
+        dup2(sock, HELPER_FD);
+    }
+    // Nothing else from the server is kept open, and the socket is not inherited by the children
+    closeFrom(HELPER_FD + 1);
+    fcntl(HELPER_FD, F_SETFD, FD_CLOEXEC);
+
+    // Same working directory as the fork path, which does not fail either if it can not be changed
+    if (chdir(_PATH_TMP) != 0) {
+        errno = 0;
+    }
+
+    // Same dispositions as the fork path: the children are reaped automatically,
+    // and both SIGCHLD and SIGPIPE stay ignored in the url-copy processes
+    for (int sig = 1; sig < NSIG; ++sig) {
+        signal(sig, SIG_DFL);
+    }
+    signal(SIGCHLD, SIG_IGN);
+    signal(SIGPIPE, SIG_IGN);
+
+    sigset_t noSignals;
+    sigemptyset(&noSignals);
+    sigprocmask(SIG_SETMASK, &noSignals, NULL);
+
+    std::vector<char> buffer(MAX_REQUEST_SIZE);
+    while (true) {
+        ssize_t size = recv(HELPER_FD, buffer.data(), buffer.size(), MSG_TRUNC);
+        if (size < 0 && errno == EINTR) {
+            continue;
+        }
+        if (size <= 0) {
+            _exit(size == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        SpawnReply reply = {-1, 0};
+        if (static_cast<size_t>(size) > buffer.size()) {
+            reply.error = E2BIG;
+        }
+        else {
+            pid_t pid = -1;
+            reply.error = spawnRequest(buffer.data(), size, pid);
+            reply.pid = pid;
+        }
+
+        if (send(HELPER_FD, &reply, sizeof(reply), MSG_NOSIGNAL) != sizeof(reply)) {
+            _exit(EXIT_FAILURE);
+        }
+    }
+}
+
+
+SpawnHelper::SpawnHelper(): sock(-1), helperPid(0)
+{
+}
+
+
+SpawnHelper::~SpawnHelper()
+{
+    stop();
+}
+
+
+void SpawnHelper::start()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    if (sock >= 0) {
+        return;
+    }
+
+    // Sequenced packets keep the boundaries between requests
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) < 0) {
+        throw SystemError(std::string(__func__) + ": Could not create the socket pair: " + strerror(errno));
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        throw SystemError(std::string(__func__) + ": Could not fork the spawn helper: " + strerror(errno));
+    }
+    else if (pid == 0) {
+        close(fds[0]);
+        serve(fds[1]);
+    }
+
+    close(fds[1]);
+    sock = fds[0];
+    helperPid = pid;
+
+    FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Spawn helper started with pid " << helperPid << commit;
+}
+
+
+void SpawnHelper::stop()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    stopLocked();
+}
+
+
+void SpawnHelper::stopLocked()
+{
+    if (sock < 0) {
+        return;
+    }
+
+    // The helper exits once it sees the socket closed
+    close(sock);
+    sock = -1;
+    waitpid(helperPid, NULL, 0);
+    helperPid = 0;
+}
+
+
+bool SpawnHelper::isRunning()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return sock >= 0;
+}
+
+
+pid_t SpawnHelper::getPid()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return helperPid;
+}
+
+
+int SpawnHelper::spawn(const std::string &app, const std::vector<std::string> &args, pid_t &pid)
+{
+    std::string request(app);
+    request.push_back('\0');
+    for (auto arg = args.begin(); arg != args.end(); ++arg) {
+        request.append(*arg);
+        request.push_back('\0');
+    }
+    if (request.size() > MAX_REQUEST_SIZE) {
+        return E2BIG;
+    }
+
+    // One request at a time, the helper answers them in order
+    boost::mutex::scoped_lock lock(mutex);
+    if (sock < 0) {
+        throw SystemError(std::string(__func__) + ": The spawn helper is not running");
+    }
+
+    ssize_t sent;
+    do {
+        sent = send(sock, request.data(), request.size(), MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+
+    SpawnReply reply;
+    ssize_t received = -1;
+    if (sent == static_cast<ssize_t>(request.size())) {
+        do {
+            received = recv(sock, &reply, sizeof(reply), 0);
+        } while (received < 0 && errno == EINTR);
+    }
+
+    if (received != sizeof(reply)) {
+        std::string reason = received == 0 ? "connection closed" : strerror(errno);
+        stopLocked();
+        throw SystemError(std::string(__func__) + ": Lost the spawn helper: " + reason);
+    }
+
+    pid = reply.pid;
+    return reply.error;
+}
+
+} // namespace server
+} // namespace fts3
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef SPAWNHELPER_H_
+#define SPAWNHELPER_H_
+
+#include <sys/types.h>
+
+#include <string>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include "common/Singleton.h"
+
+
+namespace fts3 {
+namespace server {
+
+/// Small process forked when the server starts, while its footprint is still small,
+/// that spawns the url-copy processes on behalf of the server.
+///
+/// Forking the server itself for every transfer copies its page tables, and the child
+/// has to close every descriptor up to the limit. The helper has no threads and only
+/// the descriptors it needs, and spawns with posix_spawn.
+///
+/// Requests go through a Unix socket. Each one carries the binary and its arguments,
+/// and is answered with the pid of the new process, or the errno of the failure.
+/// The spawned processes start in their own session, in /tmp, as the fork path does.
+class SpawnHelper: public fts3::common::Singleton<SpawnHelper>
+{
+public:
+    SpawnHelper();
+    virtual ~SpawnHelper();
+
+    /// Fork the helper. Call it early, before the server starts its threads and grows
+    /// Throws SystemError on failure
+    void start();
+
+    /// Stop the helper. Processes already spawned keep running
+    void stop();
+
+    /// @return true if the helper is running
+    bool isRunning();
+
+    /// @return pid of the helper, 0 if not running
+    pid_t getPid();
+
+    /// Spawn a process through the helper
+    /// Throws SystemError if the helper can not be reached. It is then stopped
+    /// @param app   The binary, looked up in the PATH
+    /// @param args  The arguments, without the binary itself
+    /// @param pid   Set to the pid of the new process
+    /// @return 0 on success, the errno of the failure otherwise
+    int spawn(const std::string &app, const std::vector<std::string> &args, pid_t &pid);
+
+private:
+    boost::mutex mutex;
+    int sock;
+    pid_t helperPid;
+
+    void stopLocked();
+};
+
+} // namespace server
+} // namespace fts3
+
+#endif // SPAWNHELPER_H_
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StatusBatch.h"
+#include "BundledTransfers.h"
+#include "MessageProcessingService.h"
+
+
+namespace fts3 {
+namespace server {
+
+
+StatusBatch::StatusBatch(const Apply &apply, const Prepare &prepare): apply(apply), prepare(prepare)
+{
+}
+
+
+bool StatusBatch::preparationChangesDatabase(const fts3::events::Message &msg)
+{
+    // Retries and requeues, see MessageProcessingService::prepareOtherMessage
+    return msg.transfer_status() == "FAILED" ||
+        (msg.transfer_status() == "CANCELED" && BundledTransfers::instance().contains(msg.process_id(), msg.file_id())) ||
+        MessageProcessingService::isUnrecoverableErrorMessage(msg.transfer_message());
+}
+
+
+void StatusBatch::add(const fts3::events::Message &msg)
+{
+    // Without a job id, the change is done by pid, and may hit any job
+    if (preparationChangesDatabase(msg) && (msg.job_id().empty() ? !messages.empty() : jobs.count(msg.job_id()) > 0)) {
+        flush();
+    }
+
+    if (prepare(msg)) {
+        messages.push_back(msg);
+        jobs.insert(msg.job_id());
+    }
+}
+
+
+void StatusBatch::flush()
+{
+    if (messages.empty()) {
+        return;
+    }
+
+    std::vector<fts3::events::Message> pending;
+    pending.swap(messages);
+    jobs.clear();
+
+    apply(pending);
+}
+
+} // namespace server
+} // namespace fts3
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef STATUSBATCH_H_
+#define STATUSBATCH_H_
+
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "msg-bus/events.h"
+
+
+namespace fts3 {
+namespace server {
+
+/// Status messages waiting to be applied together, in a single transaction.
+///
+/// Preparing a message may change the database right away: a failed transfer is reset for retry,
+/// a dead reuse process fails its whole job. Those changes must land after the messages of the
+/// same job already waiting, or the state they set would be overwritten when the batch is applied.
+/// So the pending messages of the job are applied before preparing such a message.
+class StatusBatch
+{
+public:
+    /// Applies the messages, in order
+    typedef std::function<void(std::vector<fts3::events::Message>&)> Apply;
+
+    /// Runs the steps that precede the state change of a message
+    /// @return false if the message has been fully handled, and must not be applied
+    typedef std::function<bool(const fts3::events::Message&)> Prepare;
+
+    StatusBatch(const Apply &apply, const Prepare &prepare);
+
+    /// @return true if preparing the message may change the database
+    static bool preparationChangesDatabase(const fts3::events::Message &msg);
+
+    /// Prepare the message, and keep it for the next flush unless fully handled
+    void add(const fts3::events::Message &msg);
+
+    /// Apply everything pending
+    void flush();
+
+    size_t size() const {
+        return messages.size();
+    }
+
+private:
+    Apply apply;
+    Prepare prepare;
+
+    std::vector<fts3::events::Message> messages;
+    std::set<std::string> jobs;
+};
+
+} // namespace server
+} // namespace fts3
+
+#endif // STATUSBATCH_H_
@@ -15,8 +15,9 @@
  */
 
 #include "SupervisorService.h"
+#include "common/Uri.h"
 #include "config/ServerConfig.h"
-#include "db/generic/SingleDbInstance.h"
+#include "ProgressWriter.h"
 #include "ThreadSafeList.h"
 #include <msg-bus/events.h>
 
@@ -38,54 +39,100 @@ SupervisorService::SupervisorService(): BaseService("SupervisorService"),
 }
 
 
+/// How long to wait for pings before checking for interruptions and pending progress
+static const long PING_POLL_TIMEOUT_MS = 1000;
+
+const size_t SupervisorService::MAX_PINGS_PER_BATCH;
+
+
+/// Storage name sent by url-copy, or parsed from the url if it is too old to send it
+static std::string getSeName(const std::string &seName, const std::string &surl)
+{
+    if (!seName.empty()) {
+        return seName;
+    }
+    return Uri::parse(surl).getSeName();
+}
+
+
+size_t SupervisorService::receivePings(std::vector<fts3::events::MessageUpdater> &pings, long timeoutMs)
+{
+    zmq::pollitem_t items[] = {{static_cast<void*>(zmqPingSocket), 0, ZMQ_POLLIN, 0}};
+    if (zmq::poll(items, 1, timeoutMs) <= 0 || !(items[0].revents & ZMQ_POLLIN)) {
+        return 0;
+    }
+
+    size_t received = 0;
+    zmq::message_t message;
+    for (size_t i = 0; i < MAX_PINGS_PER_BATCH && zmqPingSocket.recv(&message, ZMQ_NOBLOCK); ++i) {
+        pings.emplace_back();
+        if (!pings.back().ParseFromArray(message.data(), message.size())) {
+            pings.pop_back();
+            continue;
+        }
+        ++received;
+    }
+    return received;
+}
+
+
+void SupervisorService::handlePings(const std::vector<fts3::events::MessageUpdater> &pings)
+{
+    for (auto event = pings.begin(); event != pings.end(); ++event) {
+        FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "Process Updater Monitor"
+                                         << " job_id=" << event->job_id()
+                                         << " file_id=" << event->file_id()
+                                         << " pid=" << event->process_id()
+                                         << " timestamp=" << event->timestamp()
+                                         << " throughput=" << event->throughput()
+                                         << " transferred=" << event->transferred()
+                                         << commit;
+
+        FTS3_COMMON_LOGGER_NEWLOG(PROF) << "[profiling:transfer]"
+                                        << " file_id=" << event->file_id()
+                                        << " timestamp=" << event->gfal_perf_timestamp() / 1000
+                                        << " inst_throughput=" << event->instantaneous_throughput()
+                                        << " dif_transferred=" << event->transferred_since_last_ping()
+                                        << " source_se=" << getSeName(event->source_se(), event->source_surl())
+                                        << " dest_se=" << getSeName(event->dest_se(), event->dest_surl())
+                                        << commit;
+    }
+
+    ThreadSafeList::get_instance().updateMsg(pings);
+    ProgressWriter::instance().add(pings);
+}
+
+
 void SupervisorService::runService()
 {
-    while (!boost::this_thread::interruption_requested()) {
-        std::vector<fts3::events::MessageUpdater> events;
-        zmq::message_t message;
+    std::vector<fts3::events::MessageUpdater> pings;
+    pings.reserve(MAX_PINGS_PER_BATCH);
 
+    while (!boost::this_thread::interruption_requested()) {
         try {
-            boost::this_thread::sleep(boost::posix_time::seconds(1));
-
-            while (zmqPingSocket.recv(&message, ZMQ_NOBLOCK)) {
-                fts3::events::MessageUpdater event;
-                if (!event.ParseFromArray(message.data(), message.size())) {
-                    continue;
-                }
-                events.emplace_back(event);
-
-                FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Process Updater Monitor"
-                                                << "\nJob id: " << event.job_id()
-                                                << "\nFile id: " << event.file_id()
-                                                << "\nPid: " << event.process_id()
-                                                << "\nTimestamp: " << event.timestamp()
-                                                << "\nThroughput: " << event.throughput()
-                                                << "\nTransferred: " << event.transferred()
-                                                << commit;
-
-                FTS3_COMMON_LOGGER_NEWLOG(PROF) << "[profiling:transfer]"
-                                                << " file_id=" << event.file_id()
-                                                << " timestamp=" << event.gfal_perf_timestamp() / 1000
-                                                << " inst_throughput=" << event.instantaneous_throughput()
-                                                << " dif_transferred=" << event.transferred_since_last_ping()
-                                                << " source_se=" << Uri::parse(event.source_surl()).getSeName()
-                                                << " dest_se=" << Uri::parse(event.dest_surl()).getSeName()
-                                                << commit;
-
-                ThreadSafeList::get_instance().updateMsg(event);
-            }
+            // Woken up as soon as pings arrive
+            receivePings(pings, PING_POLL_TIMEOUT_MS);
+            boost::this_thread::interruption_point();
 
-            if (!events.empty()) {
-                db::DBSingleton::instance().getDBObjectInstance()->updateFileTransferProgressVector(events);
-                events.clear();
+            if (!pings.empty()) {
+                handlePings(pings);
+                pings.clear();
             }
+            ProgressWriter::instance().flushIfDue();
         }
         catch (const boost::thread_interrupted&) {
             FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Thread interruption requested" << commit;
+            try {
+                ProgressWriter::instance().flush();
+            }
+            catch (const std::exception &error) {
+                FTS3_COMMON_LOGGER_NEWLOG(ERR) << error.what() << commit;
+            }
             break;
         }
         catch (const std::exception &error) {
             FTS3_COMMON_LOGGER_NEWLOG(ERR) << error.what() << commit;
+            pings.clear();
         }
     }
 }
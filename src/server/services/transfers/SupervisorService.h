@@ -18,7 +18,9 @@
 #define FTS3_SUPERVISORSERVICE_H
 
 #include "../BaseService.h"
+#include <vector>
 #include <zmq.hpp>
+#include <msg-bus/events.h>
 
 namespace fts3 {
 namespace server {
@@ -39,6 +41,16 @@ public:
 
     /// Service code
     void runService();
+
+    /// Wait up to timeoutMs for pings, then receive the pending ones, at most MAX_PINGS_PER_BATCH
+    /// @return number of pings appended
+    size_t receivePings(std::vector<fts3::events::MessageUpdater> &pings, long timeoutMs);
+
+    /// Mark the transfers as alive, and queue their progress to be written
+    void handlePings(const std::vector<fts3::events::MessageUpdater> &pings);
+
+    /// Upper bound of pings received and handled at once
+    static const size_t MAX_PINGS_PER_BATCH = 1000;
 };
 
 }
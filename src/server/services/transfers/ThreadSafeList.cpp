@@ -18,8 +18,6 @@
  * limitations under the License.
  */
 
-#include <iostream>
-#include <ctime>
 #include <common/Exceptions.h>
 
 #include "common/Logger.h"
@@ -28,6 +26,17 @@
 
 using fts3::common::SystemError;
 
+typedef boost::unique_lock<boost::timed_mutex> WatchListLock;
+
+
+/// Wait up to 10 seconds for the lock
+static void acquire(WatchListLock &lock, const char *func)
+{
+    if (!lock.timed_lock(boost::posix_time::seconds(10))) {
+        throw SystemError(std::string(func) + ": Mutex timeout expired");
+    }
+}
+
 
 ThreadSafeList::ThreadSafeList()
 {
@@ -41,21 +50,42 @@ ThreadSafeList::~ThreadSafeList()
 
 void ThreadSafeList::push_back(fts3::events::MessageUpdater &msg)
 {
-    if (!_mutex.timed_lock(boost::posix_time::seconds(10))) {
-        throw SystemError(std::string(__func__) + ": Mutex timeout expired");
+    Entry entry;
+    entry.jobId = msg.job_id();
+    entry.fileId = msg.file_id();
+    entry.pid = msg.process_id();
+    entry.timestamp = msg.timestamp();
+    // Read /proc before locking
+    entry.pidStartTime = (entry.pid > 0) ? fts3::common::getPidStartime(entry.pid) : 0;
+    entry.msg = msg;
+
+    WatchListLock lock(_mutex, boost::defer_lock);
+    acquire(lock, __func__);
+
+    auto &byTransfer = m_list.get<ByTransfer>();
+    auto iter = byTransfer.find(boost::make_tuple(entry.jobId, entry.fileId));
+    if (iter != byTransfer.end()) {
+        byTransfer.replace(iter, entry);
+    }
+    else {
+        byTransfer.insert(entry);
     }
-    m_list.push_back(msg);
-    _mutex.unlock();
 }
 
 
 void ThreadSafeList::clear()
 {
-    if (!_mutex.timed_lock(boost::posix_time::seconds(10))) {
-        throw SystemError(std::string(__func__) + ": Mutex timeout expired");
-    }
+    WatchListLock lock(_mutex, boost::defer_lock);
+    acquire(lock, __func__);
     m_list.clear();
-    _mutex.unlock();
+}
+
+
+size_t ThreadSafeList::size() const
+{
+    WatchListLock lock(_mutex, boost::defer_lock);
+    acquire(lock, __func__);
+    return m_list.size();
 }
 
 
@@ -64,110 +94,90 @@ void ThreadSafeList::checkExpiredMsg(std::vector<fts3::events::MessageUpdater> &
 {
     static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
 
-    if (!_mutex.timed_lock(boost::posix_time::seconds(10))) {
-        throw SystemError(std::string(__func__) + ": Mutex timeout expired");
+    auto nowTime = boost::posix_time::microsec_clock::universal_time();
+    auto oldest = nowTime - timeout;
+    if (oldest <= epoch) {
+        return;
     }
+    uint64_t oldestTimestamp = (oldest - epoch).total_milliseconds();
 
-    try {
-        for (auto iter = m_list.begin(); iter != m_list.end(); ++iter) {
-            auto nowTime = boost::posix_time::microsec_clock::universal_time();
-            auto lastMsgTime = epoch + boost::posix_time::milliseconds(iter->timestamp());
+    WatchListLock lock(_mutex, boost::defer_lock);
+    acquire(lock, __func__);
 
-            auto age = nowTime - lastMsgTime;
+    // Sorted by timestamp, so stop on the first one still alive
+    auto &byTimestamp = m_list.get<ByTimestamp>();
+    auto end = byTimestamp.lower_bound(oldestTimestamp);
+    for (auto iter = byTimestamp.begin(); iter != end; ++iter) {
+        messages.push_back(iter->msg);
+    }
+}
 
-            if (age > timeout) {
-                messages.push_back(*iter);
-            }
+
+void ThreadSafeList::updateUnlocked(const fts3::events::MessageUpdater &msg)
+{
+    auto &byPid = m_list.get<ByPid>();
+    auto range = byPid.equal_range(msg.process_id());
+
+    for (auto iter = range.first; iter != range.second; ++iter) {
+        if (iter->pidStartTime > 0 && msg.timestamp() >= iter->pidStartTime) {
+            // The timestamp is not part of the pid index, so the range remains valid
+            byPid.modify(iter, [&msg](Entry &entry) {
+                entry.timestamp = msg.timestamp();
+                entry.msg.set_timestamp(msg.timestamp());
+            });
+        }
+        else if (iter->pidStartTime > 0) {
+            FTS3_COMMON_LOGGER_NEWLOG(WARNING)
+                << "Found a matching pid, but start time is more recent than last known message"
+                << "(" << iter->pidStartTime << " vs " << msg.timestamp() << " for " << msg.process_id() << ")"
+                << fts3::common::commit;
         }
     }
-    catch (...) {
-        _mutex.unlock();
-        throw;
-    }
-    _mutex.unlock();
 }
 
 
 void ThreadSafeList::updateMsg(fts3::events::MessageUpdater &msg)
 {
-    if (!_mutex.timed_lock(boost::posix_time::seconds(10))) {
-        throw SystemError(std::string(__func__) + ": Mutex timeout expired");
-    }
+    WatchListLock lock(_mutex, boost::defer_lock);
+    acquire(lock, __func__);
+    updateUnlocked(msg);
+}
 
-    try {
-        std::list<fts3::events::MessageUpdater>::iterator iter;
-        uint64_t pidStartTime = fts3::common::getPidStartime(msg.process_id());
-        for (iter = m_list.begin(); iter != m_list.end(); ++iter) {
-
-            if (msg.process_id() == iter->process_id()) {
-                if (pidStartTime > 0 && msg.timestamp() >= pidStartTime) {
-                    iter->set_timestamp(msg.timestamp());
-                }
-                else if (pidStartTime > 0) {
-                    FTS3_COMMON_LOGGER_NEWLOG(WARNING)
-                        << "Found a matching pid, but start time is more recent than last known message"
-                        << "(" << pidStartTime << " vs " << msg.timestamp() << " for " << msg.process_id() << ")"
-                        << fts3::common::commit;
-                }
-            }
-        }
+
+void ThreadSafeList::updateMsg(const std::vector<fts3::events::MessageUpdater> &messages)
+{
+    WatchListLock lock(_mutex, boost::defer_lock);
+    acquire(lock, __func__);
+    for (auto iter = messages.begin(); iter != messages.end(); ++iter) {
+        updateUnlocked(*iter);
     }
-    catch (...) {
-        _mutex.unlock();
-        throw;
+}
+
+
+void ThreadSafeList::eraseUnlocked(const std::string &jobId, uint64_t fileId)
+{
+    auto &byTransfer = m_list.get<ByTransfer>();
+    auto iter = byTransfer.find(boost::make_tuple(jobId, fileId));
+    if (iter != byTransfer.end()) {
+        byTransfer.erase(iter);
     }
-    _mutex.unlock();
 }
 
 
 void ThreadSafeList::deleteMsg(std::vector<fts3::events::MessageUpdater> &messages)
 {
-    if (!_mutex.timed_lock(boost::posix_time::seconds(10))) {
-        throw SystemError(std::string(__func__) + ": Mutex timeout expired");
-    }
+    WatchListLock lock(_mutex, boost::defer_lock);
+    acquire(lock, __func__);
 
-    try {
-        std::list<fts3::events::MessageUpdater>::iterator i = m_list.begin();
-        for (auto iter = messages.begin(); iter != messages.end(); ++iter) {
-            i = m_list.begin();
-            while (i != m_list.end()) {
-                if ((*iter).file_id() == i->file_id() && (*iter).job_id().compare(i->job_id()) == 0) {
-                    m_list.erase(i++);
-                }
-                else {
-                    ++i;
-                }
-            }
-        }
+    for (auto iter = messages.begin(); iter != messages.end(); ++iter) {
+        eraseUnlocked(iter->job_id(), iter->file_id());
     }
-    catch (...) {
-        _mutex.unlock();
-        throw;
-    }
-    _mutex.unlock();
 }
 
 
 void ThreadSafeList::removeFinishedTr(std::string job_id, uint64_t file_id)
 {
-    if (!_mutex.timed_lock(boost::posix_time::seconds(10))) {
-        throw SystemError(std::string(__func__) + ": Mutex timeout expired");
-    }
-
-    try {
-        std::list<fts3::events::MessageUpdater>::iterator i = m_list.begin();
-        while (i != m_list.end()) {
-            if (file_id == i->file_id() && job_id == i->job_id()) {
-                m_list.erase(i++);
-            }
-            else {
-                ++i;
-            }
-        }
-    }
-    catch (...) {
-        _mutex.unlock();
-        throw;
-    }
-    _mutex.unlock();
+    WatchListLock lock(_mutex, boost::defer_lock);
+    acquire(lock, __func__);
+    eraseUnlocked(job_id, file_id);
 }
@@ -21,13 +21,21 @@
 #ifndef THREADSAFELIST_H_
 #define THREADSAFELIST_H_
 
-#include <list>
 #include <vector>
 #include <string>
 #include <boost/thread.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
 #include "msg-bus/events.h"
 
 
+/// Watch list of the running transfers, used to detect the stalled ones.
+/// Entries are indexed by (job_id, file_id), by pid, and by the timestamp of the last ping,
+/// so pings and removals do not depend on the number of transfers, and
+/// the expiration check only visits the expired entries.
 class ThreadSafeList
 {
 public:
@@ -40,17 +48,62 @@ public:
     ThreadSafeList();
     ~ThreadSafeList();
 
+    /// Register a transfer. If (job_id, file_id) is already watched, the entry is replaced.
+    /// The start time of the process is read here and kept for validating later pings
     void push_back(fts3::events::MessageUpdater &msg);
     void clear();
+    /// Refresh the timestamp of all the transfers run by msg.process_id()
     void updateMsg(fts3::events::MessageUpdater &msg);
+    /// Same as updateMsg, but takes the lock only once for all the messages
+    void updateMsg(const std::vector<fts3::events::MessageUpdater> &messages);
     void checkExpiredMsg(std::vector<fts3::events::MessageUpdater>& messages,
         boost::posix_time::time_duration timeout);
     void deleteMsg(std::vector<fts3::events::MessageUpdater>& messages);
     void removeFinishedTr(std::string job_id, uint64_t file_id);
+    size_t size() const;
 
 private:
-    std::list<fts3::events::MessageUpdater> m_list;
-    mutable boost::recursive_timed_mutex _mutex;
+    struct Entry {
+        std::string jobId;
+        uint64_t fileId;
+        int pid;
+        uint64_t timestamp;
+        // Start time of the process, 0 if it was already gone when registered
+        uint64_t pidStartTime;
+        fts3::events::MessageUpdater msg;
+    };
+
+    struct ByTransfer {};
+    struct ByPid {};
+    struct ByTimestamp {};
+
+    typedef boost::multi_index_container<
+        Entry,
+        boost::multi_index::indexed_by<
+            boost::multi_index::hashed_unique<
+                boost::multi_index::tag<ByTransfer>,
+                boost::multi_index::composite_key<
+                    Entry,
+                    boost::multi_index::member<Entry, std::string, &Entry::jobId>,
+                    boost::multi_index::member<Entry, uint64_t, &Entry::fileId>
+                >
+            >,
+            boost::multi_index::hashed_non_unique<
+                boost::multi_index::tag<ByPid>,
+                boost::multi_index::member<Entry, int, &Entry::pid>
+            >,
+            boost::multi_index::ordered_non_unique<
+                boost::multi_index::tag<ByTimestamp>,
+                boost::multi_index::member<Entry, uint64_t, &Entry::timestamp>
+            >
+        >
+    > WatchList;
+
+    WatchList m_list;
+    mutable boost::timed_mutex _mutex;
+
+    void updateUnlocked(const fts3::events::MessageUpdater &msg);
+    void eraseUnlocked(const std::string &jobId, uint64_t fileId);
 };
 
 #endif /*THREADSAFELIST_H_*/
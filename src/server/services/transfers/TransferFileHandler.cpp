@@ -20,234 +20,180 @@
 
 #include "TransferFileHandler.h"
 
+#include <algorithm>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace fts3
 {
 namespace server
 {
 
-std::map< std::string, std::set<std::string> >& TransferFileHandler::getMapFromCache(std::map< std::string, std::list<TransferFile> >& files, GET_MAP_OPTS opt)
-{
-    if (init_cache.empty())
-        {
-            init_cache.resize(4); // there are four maps
-
-            std::map<std::string, std::list<TransferFile> >::iterator it_v;
-
-            std::map< std::string, std::set<FileIndex> > unique;
-
-            // iterate over all VOs
-            for (it_v = files.begin(); it_v != files.end(); ++it_v)
-                {
-                    // the vo name
-                    std::string vo = it_v->first;
-                    // unique vo names
-                    vos.insert(vo);
-                    // ref to the list of files (for the given VO)
-                    std::list<TransferFile>& tfs = it_v->second;
-                    std::list<TransferFile>::iterator it_tf;
-                    // iterate over all files in a given VO
-                    for (it_tf = tfs.begin(); it_tf != tfs.end(); ++it_tf)
-                        {
-
-                            TransferFile tmp = *it_tf;
-
-                            init_cache[SOURCE_TO_DESTINATIONS][tmp.sourceSe].insert(tmp.destSe);
-                            init_cache[SOURCE_TO_VOS][tmp.sourceSe].insert(tmp.voName);
-                            init_cache[DESTINATION_TO_SOURCES][tmp.destSe].insert(tmp.sourceSe);
-                            init_cache[DESTINATION_TO_VOS][tmp.destSe].insert(tmp.voName);
-
-                            // create index (job ID + file index)
-                            FileIndex index((*it_tf).jobId, tmp.fileIndex);
-                            // file index to files mapping
-                            fileIndexToFiles[index].push_back(tmp);
-                            // check if the mapping for the VO already exists
-                            if (!unique[vo].count(index))
-                                {
-                                    // if not creat it
-                                    unique[vo].insert(index);
-                                    voToFileIndexes[it_v->first][make_pair(tmp.sourceSe, tmp.destSe)].push_back(index);
-                                }
-                        }
-
-                    nextPairForVo[it_v->first] = voToFileIndexes[it_v->first].begin();
-                }
-        }
-
-    return init_cache[opt];
-}
+namespace {
 
+/// Source and destination storages, viewed from the file they belong to
+typedef std::pair<std::string_view, std::string_view> LinkKey;
 
-TransferFileHandler::TransferFileHandler(std::map< std::string, std::list<TransferFile> >& files) :
-    sourceToDestinations(getMapFromCache(files, SOURCE_TO_DESTINATIONS)),
-    sourceToVos(getMapFromCache(files, SOURCE_TO_VOS)),
-    destinationToSources(getMapFromCache(files, DESTINATION_TO_SOURCES)),
-    destinationToVos(getMapFromCache(files, DESTINATION_TO_VOS))
+struct LinkKeyHash
 {
-    init_cache.clear();
-}
+    size_t operator()(const LinkKey &link) const
+    {
+        std::hash<std::string_view> hash;
+        return hash(link.first) * 31 + hash(link.second);
+    }
+};
 
-TransferFileHandler::~TransferFileHandler()
-{
-    std::map< FileIndex, std::list<TransferFile> >::iterator it;
-    for (it = fileIndexToFiles.begin(); it != fileIndexToFiles.end(); ++it)
-        {
-            freeList(it->second);
-        }
-}
+/// Job id and file index, shared by the replicas of a file
+typedef std::pair<std::string_view, int> ReplicaKey;
 
-boost::optional<TransferFile> TransferFileHandler::get(std::string vo)
+struct ReplicaKeyHash
 {
-    // get the index of the next File in turn for the VO
-    boost::optional<FileIndex> index = getIndex(vo);
-    // if the index exists return the file
-    if (index) return getFile(*index);
-
-    return boost::optional<TransferFile>();
-}
+    size_t operator()(const ReplicaKey &replica) const
+    {
+        return std::hash<std::string_view>()(replica.first) * 31 + replica.second;
+    }
+};
 
-boost::optional< std::pair<std::string, std::string> > TransferFileHandler::getNextPair(std::string vo)
+/// A file to hand out, before being grouped
+struct Entry
 {
-    // if there are no pairs for the given VO ...
-    if (voToFileIndexes[vo].empty()) return boost::optional< std::pair<std::string, std::string> >();
+    uint32_t vo;
+    uint32_t link;
+    TransferFile *file;
+};
 
-    // if it is the end wrap around
-    if (nextPairForVo[vo] == voToFileIndexes[vo].end()) nextPairForVo[vo] = voToFileIndexes[vo].begin();
-
-    // get the iterator
-    std::map< std::pair<std::string, std::string>, std::list<FileIndex> >::iterator ret = nextPairForVo[vo];
-
-    // set the next pair
-    nextPairForVo[vo]++;
-
-    return ret->first;
 }
 
-boost::optional<FileIndex> TransferFileHandler::getIndex(std::string vo)
-{
-    // find the item
-    std::map<std::string, std::map< std::pair<std::string, std::string>, std::list<FileIndex> > >::iterator it =
-        voToFileIndexes.find(vo);
-
-    // if the VO has no mapping or no files are assigned to the VO ...
-    if (it == voToFileIndexes.end() || it->second.empty()) return boost::optional<FileIndex>();
-
-    boost::optional< std::pair<std::string, std::string> > src_dst = getNextPair(vo);
 
-    if (!src_dst.is_initialized()) return boost::optional<FileIndex>();
+TransferFileHandler::TransferFileHandler(std::map< std::string, std::list<TransferFile> >& filesByVo) :
+    remaining(0)
+{
+    size_t total = 0;
+    for (auto it_v = filesByVo.begin(); it_v != filesByVo.end(); ++it_v) {
+        total += it_v->second.size();
+    }
 
-    // get the index value
-    FileIndex index = it->second[*src_dst].front();
-    it->second[*src_dst].pop_front();
+    std::vector<Entry> entries;
+    entries.reserve(total);
 
-    // if there are no more values assigned to either VO or pair remove it from respective mapping
-    if (it->second[*src_dst].empty())
-        {
-            it->second.erase(*src_dst);
+    // Keys point into the files, which do not move once spliced
+    std::vector<LinkKey> links;
+    std::unordered_map<LinkKey, uint32_t, LinkKeyHash> linkIds;
+    std::unordered_set<ReplicaKey, ReplicaKeyHash> replicas;
+    replicas.reserve(total);
 
-            if (it->second.empty())
-                {
-                    voToFileIndexes.erase(it);
-                }
-        }
+    // The map is sorted, and so is vos
+    for (auto it_v = filesByVo.begin(); it_v != filesByVo.end(); ++it_v) {
+        uint32_t vo = static_cast<uint32_t>(vos.size());
+        vos.push_back(it_v->first);
 
-    return index;
-}
+        auto it_tf = it_v->second.begin();
+        files.splice(files.end(), it_v->second);
 
-boost::optional<TransferFile> TransferFileHandler::getFile(FileIndex index)
-{
-    boost::optional<TransferFile> ret;
+        for (; it_tf != files.end(); ++it_tf) {
+            TransferFile &file = *it_tf;
 
-    // if there's no mapping for this index ..
-    if (fileIndexToFiles.find(index) == fileIndexToFiles.end()) return ret;
+            // Only the first replica is handed out
+            if (!replicas.emplace(file.jobId, file.fileIndex).second) {
+                continue;
+            }
 
-    if (!fileIndexToFiles[index].empty())
-        {
-            // get the first in the list
-            ret = fileIndexToFiles[index].front();
-            // remove it from the list
-            fileIndexToFiles[index].pop_front();
+            auto linkId = linkIds.emplace(LinkKey(file.sourceSe, file.destSe), links.size());
+            if (linkId.second) {
+                links.push_back(linkId.first->first);
+            }
+            entries.push_back(Entry{vo, linkId.first->second, &file});
+        }
+    }
+
+    // Links take turns in source and destination order
+    std::vector<uint32_t> sortedLinks(links.size());
+    std::iota(sortedLinks.begin(), sortedLinks.end(), 0);
+    std::sort(sortedLinks.begin(), sortedLinks.end(), [&links](uint32_t a, uint32_t b) {
+        return links[a] < links[b];
+    });
+    std::vector<uint32_t> linkRank(links.size());
+    for (size_t i = 0; i < sortedLinks.size(); ++i) {
+        linkRank[sortedLinks[i]] = static_cast<uint32_t>(i);
+    }
+
+    // Group by VO and link, keeping the order of the files within a link
+    std::stable_sort(entries.begin(), entries.end(), [&linkRank](const Entry &a, const Entry &b) {
+        return a.vo < b.vo || (a.vo == b.vo && linkRank[a.link] < linkRank[b.link]);
+    });
+
+    voQueues.resize(vos.size());
+    order.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        VoQueue &voQueue = voQueues[entries[i].vo];
+        if (i == 0 || entries[i].vo != entries[i - 1].vo || entries[i].link != entries[i - 1].link) {
+            LinkQueue linkQueue = {static_cast<uint32_t>(i), static_cast<uint32_t>(i)};
+            voQueue.links.push_back(linkQueue);
         }
+        order.push_back(entries[i].file);
+        ++voQueue.links.back().end;
+    }
 
-    return ret;
+    remaining = static_cast<int>(order.size());
 }
 
-void TransferFileHandler::freeList(std::list<TransferFile>& l)
-{
-    l.clear();
-}
 
-std::set<std::string>::iterator TransferFileHandler::begin()
+TransferFileHandler::~TransferFileHandler()
 {
-    return vos.begin();
 }
 
-std::set<std::string>::iterator TransferFileHandler::end()
-{
-    return vos.end();
-}
 
-bool TransferFileHandler::empty()
+boost::optional<TransferFile> TransferFileHandler::get(const std::string &vo)
 {
-    return voToFileIndexes.empty();
-}
+    auto it_v = std::lower_bound(vos.begin(), vos.end(), vo);
+    if (it_v == vos.end() || *it_v != vo) {
+        return boost::optional<TransferFile>();
+    }
+    VoQueue &voQueue = voQueues[it_v - vos.begin()];
 
-const std::set<std::string> TransferFileHandler::getSources(std::string se) const
-{
-    std::map< std::string, std::set<std::string> >::const_iterator it = destinationToSources.find(se);
-    if (it != destinationToSources.end())
-        {
-            return it->second;
+    while (true) {
+        // Drop the exhausted links once per round, so the others keep their turn
+        if (voQueue.cursor >= voQueue.links.size()) {
+            voQueue.links.erase(std::remove_if(voQueue.links.begin(), voQueue.links.end(),
+                [](const LinkQueue &link) { return link.next == link.end; }), voQueue.links.end());
+            voQueue.cursor = 0;
+            if (voQueue.links.empty()) {
+                return boost::optional<TransferFile>();
+            }
         }
 
-    return std::set<std::string>();
-}
-
-const std::set<std::string> TransferFileHandler::getDestinations(std::string se) const
-{
-    std::map< std::string, std::set<std::string> >::const_iterator it = sourceToDestinations.find(se);
-    if (it != sourceToDestinations.end())
-        {
-            return it->second;
+        LinkQueue &link = voQueue.links[voQueue.cursor++];
+        if (link.next < link.end) {
+            --remaining;
+            return boost::optional<TransferFile>(std::move(*order[link.next++]));
         }
-
-    return std::set<std::string>();
+    }
 }
 
 
-const std::set<std::string> TransferFileHandler::getSourcesVos(std::string se) const
+std::vector<std::string>::const_iterator TransferFileHandler::begin() const
 {
-    std::map< std::string, std::set<std::string> >::const_iterator it = destinationToVos.find(se);
-    if (it != destinationToVos.end())
-        {
-            return it->second;
-        }
-
-    return std::set<std::string>();
+    return vos.begin();
 }
 
-const std::set<std::string> TransferFileHandler::getDestinationsVos(std::string se) const
-{
-    std::map< std::string, std::set<std::string> >::const_iterator it = sourceToVos.find(se);
-    if (it != sourceToVos.end())
-        {
-            return it->second;
-        }
 
-    return std::set<std::string>();
+std::vector<std::string>::const_iterator TransferFileHandler::end() const
+{
+    return vos.end();
 }
 
-int TransferFileHandler::size()
-{
-    int sum = 0;
 
-    std::map< std::string, std::map< std::pair<std::string, std::string>, std::list<FileIndex> > >::iterator iout;
-    std::map< std::pair<std::string, std::string>, std::list<FileIndex> >::iterator iin;
+bool TransferFileHandler::empty() const
+{
+    return remaining == 0;
+}
 
-    for (iout = voToFileIndexes.begin(); iout != voToFileIndexes.end(); iout++)
-        for (iin = iout->second.begin(); iin != iout->second.end(); iin++)
-            sum += (unsigned int) iin->second.size();
 
-    return sum;
+int TransferFileHandler::size() const
+{
+    return remaining;
 }
 
 } /* namespace cli */
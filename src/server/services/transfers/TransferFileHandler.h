@@ -24,10 +24,11 @@
 
 #include "db/generic/SingleDbInstance.h"
 
+#include <cstdint>
 #include <list>
 #include <map>
-#include <set>
 #include <string>
+#include <vector>
 
 #include <boost/optional.hpp>
 
@@ -38,74 +39,61 @@ namespace server
 
 using namespace db;
 
-typedef std::pair<std::string, int> FileIndex;
-
+/// Hands out the transfers of a scheduling cycle: for each VO, one file per link in turn.
+///
+/// The files are spliced out of the given lists, and the queues only hold pointers to them,
+/// in one flat vector, so nothing is copied and get() moves the file out.
+/// Files of the same job and file index are replicas, and only the first one is handed out.
+/// Not thread safe: it is meant to be drained by the thread that created it.
 class TransferFileHandler
 {
-
-    enum GET_MAP_OPTS
-    {
-        SOURCE_TO_DESTINATIONS,
-        SOURCE_TO_VOS,
-        DESTINATION_TO_SOURCES,
-        DESTINATION_TO_VOS
-    };
-
 public:
 
+    /// @param files Files by VO. The lists are left empty
     TransferFileHandler(std::map< std::string, std::list<TransferFile> >& files);
     virtual ~TransferFileHandler();
 
-    boost::optional<TransferFile> get(std::string vo);
-
-    std::set<std::string>::iterator begin();
-    std::set<std::string>::iterator end();
+    /// @return the next file of the VO, or none if the VO has nothing left
+    boost::optional<TransferFile> get(const std::string &vo);
 
-    bool empty();
+    std::vector<std::string>::const_iterator begin() const;
+    std::vector<std::string>::const_iterator end() const;
 
-    int size();
+    bool empty() const;
 
-    const std::set<std::string> getSources(std::string se) const;
-    const std::set<std::string> getDestinations(std::string se) const;
-
-    const std::set<std::string> getSourcesVos(std::string se) const;
-    const std::set<std::string> getDestinationsVos(std::string se) const;
+    int size() const;
 
 private:
 
-    boost::optional<TransferFile> getFile(FileIndex index);
-
-    boost::optional<FileIndex> getIndex(std::string vo);
-
-    boost::optional< std::pair<std::string, std::string> > getNextPair(std::string vo);
-
-    std::map< std::string, std::set<std::string> >& getMapFromCache(std::map< std::string, std::list<TransferFile> >& files, GET_MAP_OPTS opt);
-
-    // maps file indexes to file replicas
-    std::map< FileIndex, std::list<TransferFile> > fileIndexToFiles;
-
-    // maps VOs to file indexes
-    // file indexes are organized in map: source-destination pair is mapped to file indexes
-    std::map< std::string, std::map< std::pair<std::string, std::string>, std::list<FileIndex> > > voToFileIndexes;
+    /// Files of a link still to be handed out, as a range of order
+    struct LinkQueue
+    {
+        uint32_t next;
+        uint32_t end;
+    };
 
-    std::set<std::string> vos;
+    /// Links of a VO, in source and destination order
+    struct VoQueue
+    {
+        VoQueue(): cursor(0) {}
 
-    void freeList(std::list<TransferFile>& l);
+        std::vector<LinkQueue> links;
+        /// Next link in turn
+        size_t cursor;
+    };
 
-    /// mutex that ensures thread safety
-    boost::mutex m;
+    /// All the files of the cycle
+    std::list<TransferFile> files;
 
-    /// next pair in given VO queue
-    std::map< std::string, std::map< std::pair<std::string, std::string>, std::list<FileIndex> >::iterator > nextPairForVo;
+    /// Files to hand out, grouped by VO and link
+    std::vector<TransferFile*> order;
 
-    /// cache for the following maps
-    std::vector< std::map< std::string, std::set<std::string> > > init_cache;
+    /// Sorted VO names, and their queues at the same position
+    std::vector<std::string> vos;
+    std::vector<VoQueue> voQueues;
 
-    /// outgoing/incoming transfers/vo for a given SE
-    const std::map< std::string, std::set<std::string> > sourceToDestinations;
-    const std::map< std::string, std::set<std::string> > sourceToVos;
-    const std::map< std::string, std::set<std::string> > destinationToSources;
-    const std::map< std::string, std::set<std::string> > destinationToVos;
+    /// Files not handed out yet
+    int remaining;
 };
 
 } /* namespace cli */
@@ -22,7 +22,7 @@
 #include "VoShares.h"
 
 #include "config/ServerConfig.h"
-#include "common/DaemonTools.h"
+#include "common/ChildProcessRegistry.h"
 #include "common/ThreadPool.h"
 
 #include "cred/DelegCred.h"
@@ -33,9 +33,11 @@
 
 #include "TransferFileHandler.h"
 #include "FileTransferExecutor.h"
+#include "LinkCircuitBreaker.h"
 
 #include <msg-bus/producer.h>
 
+#include <algorithm>
 #include <ctime>
 
 using namespace fts3::common;
@@ -47,18 +49,49 @@ namespace server {
 extern time_t retrieveRecords;
 
 
-TransfersService::TransfersService(): BaseService("TransfersService")
+/// Milliseconds elapsed since begin, which is moved to now
+static double msSince(SchedulingBatch::Clock::time_point &begin)
+{
+    SchedulingBatch::Clock::time_point now = SchedulingBatch::Clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(now - begin).count();
+    begin = now;
+    return elapsed;
+}
+
+
+TransfersService::TransfersService(std::shared_ptr<Executor> executor): BaseService("TransfersService"),
+    executor(executor), fetchSeq(0), batches(1)
 {
     cmd = "fts_url_copy";
 
     logDir = config::ServerConfig::instance().get<std::string>("TransferLogDirectory");
     msgDir = config::ServerConfig::instance().get<std::string>("MessagingDirectory");
-    execPoolSize = config::ServerConfig::instance().get<int>("InternalThreadPool");
     ftsHostName = config::ServerConfig::instance().get<std::string>("Alias");
     infosys = config::ServerConfig::instance().get<std::string>("Infosys");
 
     monitoringMessages = config::ServerConfig::instance().get<bool>("MonitoringMessaging");
+    bulkScheduling = config::ServerConfig::instance().get<bool>("UseBulkScheduling");
     schedulingInterval = config::ServerConfig::instance().get<boost::posix_time::time_duration>("SchedulingInterval");
+    pipelinedScheduling = config::ServerConfig::instance().get<bool>("PipelinedScheduling");
+    bundleSizeThreshold = config::ServerConfig::instance().get<int64_t>("BundleSizeThreshold");
+    bundleMaxFiles = std::max(1u, config::ServerConfig::instance().get<unsigned>("BundleMaxFiles"));
+
+    if (config::ServerConfig::instance().get<bool>("LinkCircuitBreaker")) {
+        LinkCircuitBreaker::Settings breaker;
+        breaker.window = config::ServerConfig::instance().get<unsigned>("LinkCircuitBreakerWindow");
+        breaker.minSamples = config::ServerConfig::instance().get<unsigned>("LinkCircuitBreakerMinSamples");
+        breaker.failureRatio = config::ServerConfig::instance().get<double>("LinkCircuitBreakerFailureRatio");
+        breaker.backoff = config::ServerConfig::instance().get<time_t>("LinkCircuitBreakerBackoff");
+        breaker.maxBackoff = config::ServerConfig::instance().get<time_t>("LinkCircuitBreakerMaxBackoff");
+        breaker.probes = config::ServerConfig::instance().get<unsigned>("LinkCircuitBreakerProbes");
+        LinkCircuitBreaker::instance().enable(breaker);
+    }
+
+    eventDrivenScheduling = config::ServerConfig::instance().get<bool>("EventDrivenScheduling");
+    if (eventDrivenScheduling) {
+        SchedulerWakeup::instance().enable(boost::posix_time::milliseconds(
+            config::ServerConfig::instance().get<int>("SchedulingWakeupSpacing")));
+    }
 }
 
 
@@ -69,13 +102,35 @@ TransfersService::~TransfersService()
 
 void TransfersService::runService()
 {
+    // Assignment and launch happen in the background, while the next batch is fetched
+    boost::thread dispatcher;
+    if (pipelinedScheduling) {
+        dispatcher = boost::thread(&TransfersService::dispatchBatches, this);
+    }
+
+    boost::posix_time::ptime nextCycle = boost::posix_time::microsec_clock::universal_time() + schedulingInterval;
+
     while (!boost::this_thread::interruption_requested())
     {
         retrieveRecords = time(0);
 
         try
         {
-            boost::this_thread::sleep(schedulingInterval);
+            // Full cycles every SchedulingInterval, and in between, incremental ones
+            // for the links where transfers have just finished
+            std::set<SchedulerWakeup::Link> links;
+            SchedulerWakeup::Reason reason = SchedulerWakeup::DEADLINE;
+            if (eventDrivenScheduling) {
+                reason = SchedulerWakeup::instance().waitUntil(nextCycle, links);
+            }
+            else {
+                boost::this_thread::sleep(schedulingInterval);
+            }
+
+            if (reason != SchedulerWakeup::LINKS) {
+                nextCycle = boost::posix_time::microsec_clock::universal_time() + schedulingInterval;
+                links.clear();
+            }
 
             if (DrainMode::instance())
             {
@@ -84,7 +139,21 @@ void TransfersService::runService()
                 continue;
             }
 
-            executeUrlcopy();
+            if (!links.empty()) {
+                FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "Slots freed on " << links.size()
+                    << " links, scheduling them now" << commit;
+            }
+
+            if (!pipelinedScheduling) {
+                executeUrlcopy(links);
+                continue;
+            }
+
+            // Waits here while the dispatcher is busy with the previous batch
+            SchedulingBatch batch;
+            if (fetchBatch(links, batch)) {
+                batches.push(std::move(batch));
+            }
         }
         catch (boost::thread_interrupted&)
         {
@@ -100,61 +169,123 @@ void TransfersService::runService()
             FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Exception in TransfersService!" << commit;
         }
     }
+
+    batches.close();
+    if (dispatcher.joinable()) {
+        dispatcher.interrupt();
+        dispatcher.join();
+    }
 }
 
 
-void TransfersService::getFiles(const std::vector<QueueId>& queues, int availableUrlCopySlots)
+void TransfersService::dispatchBatches()
 {
-    auto db = DBSingleton::instance().getDBObjectInstance();
-
-    ThreadPool<FileTransferExecutor> execPool(execPoolSize);
-    std::map<std::string, int> slotsLeftForSource, slotsLeftForDestination;
-    for (auto i = queues.begin(); i != queues.end(); ++i) {
-        // To reduce queries, fill in one go limits as source and as destination
-        if (slotsLeftForDestination.count(i->destSe) == 0) {
-            StorageConfig seConfig = db->getStorageConfig(i->destSe);
-            slotsLeftForDestination[i->destSe] = seConfig.inboundMaxActive>0?seConfig.inboundMaxActive:60;
-            slotsLeftForSource[i->destSe] = seConfig.outboundMaxActive>0?seConfig.outboundMaxActive:60;
-        }
-        if (slotsLeftForSource.count(i->sourceSe) == 0) {
-            StorageConfig seConfig = db->getStorageConfig(i->sourceSe);
-            slotsLeftForDestination[i->sourceSe] = seConfig.inboundMaxActive>0?seConfig.inboundMaxActive:60;
-            slotsLeftForSource[i->sourceSe] = seConfig.outboundMaxActive>0?seConfig.outboundMaxActive:60;
+    try {
+        SchedulingBatch batch;
+        while (batches.pop(batch)) {
+            SchedulingBatch::Clock::time_point fetched = batch.fetched;
+            batch.waitMs = msSince(fetched);
+            try {
+                dispatchBatch(batch);
+            }
+            catch (const boost::thread_interrupted&) {
+                throw;
+            }
+            catch (const std::exception& e) {
+                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Exception in TransfersService dispatcher " << e.what() << commit;
+            }
+            catch (...) {
+                FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Exception in TransfersService dispatcher!" << commit;
+            }
         }
-        // Once it is filled, decrement
-        slotsLeftForDestination[i->destSe] -= i->activeCount;
-        slotsLeftForSource[i->sourceSe] -= i->activeCount;
     }
+    catch (const boost::thread_interrupted&) {
+        FTS3_COMMON_LOGGER_NEWLOG(INFO) << "TransfersService dispatcher interrupted" << commit;
+    }
+}
 
-    try
-    {
-        if (queues.empty())
-            return;
 
-        // now get files to be scheduled
-        std::map<std::string, std::list<TransferFile> > voQueues;
+void TransfersService::dispatchBatch(SchedulingBatch &batch)
+{
+    SchedulingBatch::Clock::time_point start = SchedulingBatch::Clock::now();
 
+    // Only the launches that finished after this batch was fetched can be missing from it
+    recentlyLaunched.expire(batch.seq);
 
-        time_t start = time(0);
-        db->getReadyTransfers(queues, voQueues);
-        time_t end =time(0);
-        FTS3_COMMON_LOGGER_NEWLOG(INFO) << "DBtime=\"TransfersService\" "
-                                        << "func=\"getFiles\" "
-                                        << "DBcall=\"getReadyTransfers\" " 
-                                        << "time=\"" << end - start << "\"" 
-                                        << commit;
+    int maxUrlCopy = config::ServerConfig::instance().get<int>("MaxUrlCopyProcesses");
+    int availableUrlCopySlots = maxUrlCopy - ChildProcessRegistry::instance().count("fts_url_copy");
+    if (availableUrlCopySlots <= 0) {
+        FTS3_COMMON_LOGGER_NEWLOG(WARNING)
+            << "Reached limitation of MaxUrlCopyProcesses"
+            << commit;
+        return;
+    }
 
-        if (voQueues.empty())
-            return;
+    ThreadPool<FileTransferExecutor> execPool(executor);
+    RecentLaunches::Launched launched;
+
+    // However this returns, wait for the executors, and remember what they started:
+    // the next batches may have been fetched before these were marked as started
+    struct LaunchGuard {
+        ThreadPool<FileTransferExecutor> &execPool;
+        RecentLaunches::Launched &launched;
+        RecentLaunches &recentlyLaunched;
+        std::atomic<uint64_t> &fetchSeq;
+
+        ~LaunchGuard() {
+            boost::this_thread::disable_interruption noInterruption;
+            execPool.join();
+            recentlyLaunched.record(std::move(launched), fetchSeq);
+        }
+    } launchGuard = {execPool, launched, recentlyLaunched, fetchSeq};
+
+    try
+    {
+        std::shared_ptr<const ConfigSnapshot> configSnapshot = batch.configSnapshot;
+
+        std::map<std::string, int> slotsLeftForSource, slotsLeftForDestination;
+        for (auto i = batch.queues.begin(); i != batch.queues.end(); ++i) {
+            // To reduce queries, fill in one go limits as source and as destination
+            if (slotsLeftForDestination.count(i->destSe) == 0) {
+                StorageConfig seConfig = configSnapshot->getStorageConfig(i->destSe);
+                slotsLeftForDestination[i->destSe] = seConfig.inboundMaxActive>0?seConfig.inboundMaxActive:60;
+                slotsLeftForSource[i->destSe] = seConfig.outboundMaxActive>0?seConfig.outboundMaxActive:60;
+            }
+            if (slotsLeftForSource.count(i->sourceSe) == 0) {
+                StorageConfig seConfig = configSnapshot->getStorageConfig(i->sourceSe);
+                slotsLeftForDestination[i->sourceSe] = seConfig.inboundMaxActive>0?seConfig.inboundMaxActive:60;
+                slotsLeftForSource[i->sourceSe] = seConfig.outboundMaxActive>0?seConfig.outboundMaxActive:60;
+            }
+            // Once it is filled, decrement
+            slotsLeftForDestination[i->destSe] -= i->activeCount;
+            slotsLeftForSource[i->sourceSe] -= i->activeCount;
+        }
+
+        // Neither are the transfers launched meanwhile
+        std::set<uint64_t> launchedMeanwhile = recentlyLaunched.apply(slotsLeftForSource, slotsLeftForDestination);
 
         // Count of scheduled transfers for activity
         std::map<std::string, int> scheduledByActivity;
 
         // create transfer-file handler
-        TransferFileHandler tfh(voQueues);
+        TransferFileHandler tfh(batch.voQueues);
 
         std::map<std::pair<std::string, std::string>, std::string> proxies;
 
+        // Small files waiting to be run together, see FileTransferExecutor::getBundleKey
+        std::map<std::string, std::vector<TransferFile>> bundles;
+        auto startBundle = [&](std::vector<TransferFile> &&bundle) {
+            std::string &proxy = proxies[std::make_pair(bundle.front().credId, bundle.front().userDn)];
+            if (bundle.size() == 1) {
+                execPool.start(new FileTransferExecutor(bundle.front(),
+                    monitoringMessages, infosys, ftsHostName, proxy, logDir, msgDir, configSnapshot));
+            }
+            else {
+                execPool.start(new FileTransferExecutor(std::move(bundle),
+                    monitoringMessages, infosys, ftsHostName, proxy, logDir, msgDir, configSnapshot));
+            }
+        };
+
         // loop until all files have been served
         int initial_size = tfh.size();
 
@@ -181,6 +312,9 @@ void TransfersService::getFiles(const std::vector<QueueId>& queues, int availabl
                 if (tf.fileId == 0 || tf.userDn.empty() || tf.credId.empty())
                     continue;
 
+                if (launchedMeanwhile.count(tf.fileId))
+                    continue;
+
                 if (!scheduledByActivity.count(tf.activity)) {
                     scheduledByActivity[tf.activity] = 0;
                 }
@@ -189,7 +323,9 @@ void TransfersService::getFiles(const std::vector<QueueId>& queues, int availabl
 
                 if (proxies.find(proxy_key) == proxies.end())
                 {
+                    SchedulingBatch::Clock::time_point proxyStart = SchedulingBatch::Clock::now();
                     proxies[proxy_key] = DelegCred::getProxyFile(tf.userDn, tf.credId);
+                    batch.proxiesMs += msSince(proxyStart);
                 }
 
                 if (slotsLeftForDestination[tf.destSe] <= 0) {
@@ -207,21 +343,49 @@ void TransfersService::getFiles(const std::vector<QueueId>& queues, int availabl
                             << commit;
                         warningPrintedSrc.insert(tf.sourceSe);
                     }
+                }
+                else if (!LinkCircuitBreaker::instance().allow(tf.sourceSe, tf.destSe)) {
+                    // Paused, or enough probes already running
+                    continue;
                 } else {
                     // Increment scheduled transfers by activity
                     scheduledByActivity[tf.activity]++;
 
+                    launched.add(tf);
+
+                    --slotsLeftForDestination[tf.destSe];
+                    --slotsLeftForSource[tf.sourceSe];
+
+                    // Only the first file of a bundle takes a url_copy slot
+                    std::string bundleKey = FileTransferExecutor::getBundleKey(tf, bundleSizeThreshold,
+                        *configSnapshot);
+                    if (!bundleKey.empty()) {
+                        std::vector<TransferFile> &bundle = bundles[bundleKey];
+                        if (bundle.empty()) {
+                            --availableUrlCopySlots;
+                        }
+                        bundle.push_back(std::move(tf));
+                        if (bundle.size() >= bundleMaxFiles) {
+                            startBundle(std::move(bundle));
+                            bundles.erase(bundleKey);
+                        }
+                        continue;
+                    }
+
                     FileTransferExecutor *exec = new FileTransferExecutor(tf,
                         monitoringMessages, infosys, ftsHostName,
-                        proxies[proxy_key], logDir, msgDir);
+                        proxies[proxy_key], logDir, msgDir, configSnapshot);
 
                     execPool.start(exec);
                     --availableUrlCopySlots;
-                    --slotsLeftForDestination[tf.destSe];
-                    --slotsLeftForSource[tf.sourceSe];
                 }
             }
         }
+        for (auto bundle = bundles.begin(); bundle != bundles.end(); ++bundle) {
+            startBundle(std::move(bundle->second));
+        }
+        bundles.clear();
+        batch.assignMs = msSince(start);
 
         if (availableUrlCopySlots <= 0 && !tfh.empty()) {
             FTS3_COMMON_LOGGER_NEWLOG(WARNING)
@@ -231,10 +395,33 @@ void TransfersService::getFiles(const std::vector<QueueId>& queues, int availabl
 
         // wait for all the workers to finish
         execPool.join();
+        batch.launchMs = msSince(start);
+
         int scheduled = execPool.reduce(std::plus<int>());
         FTS3_COMMON_LOGGER_NEWLOG(INFO) <<"Threadpool processed: " << initial_size
                 << " files (" << scheduled << " have been scheduled)" << commit;
 
+        FTS3_COMMON_LOGGER_NEWLOG(INFO) << "SchedulingTime=\"TransfersService\" "
+                                        << "batch=\"" << batch.seq << "\" "
+                                        << "links=\"" << (batch.allLinks ? "all" : "freed") << "\" "
+                                        << "queues=\"" << batch.queues.size() << "\" "
+                                        << "files=\"" << initial_size << "\" "
+                                        << "scheduled=\"" << scheduled << "\" "
+                                        << "fetch_queues_ms=\"" << batch.queuesMs << "\" "
+                                        << "fetch_files_ms=\"" << batch.filesMs << "\" "
+                                        << "fetch_config_ms=\"" << batch.configMs << "\" "
+                                        << "wait_ms=\"" << batch.waitMs << "\" "
+                                        << "assign_ms=\"" << batch.assignMs << "\" "
+                                        << "proxies_ms=\"" << batch.proxiesMs << "\" "
+                                        << "launch_ms=\"" << batch.launchMs << "\""
+                                        << commit;
+
+        Executor::Metrics metrics = execPool.getMetrics();
+        FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "Executor queued=" << metrics.queueDepth
+                << " executed=" << metrics.executed << " steals=" << metrics.steals
+                << " avgLatencyMs=" << metrics.avgLatencyMs << " maxLatencyMs=" << metrics.maxLatencyMs
+                << commit;
+
         if (scheduled > 0) {
             std::ostringstream out;
 
@@ -249,13 +436,13 @@ void TransfersService::getFiles(const std::vector<QueueId>& queues, int availabl
         }
     }
     catch (const boost::thread_interrupted&) {
-        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Interruption requested in TransfersService:getFiles" << commit;
+        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Interruption requested in TransfersService:dispatchBatch" << commit;
         execPool.interrupt();
-        execPool.join();
+        throw;
     }
     catch (std::exception& e)
     {
-        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Exception in TransfersService:getFiles " << e.what() << commit;
+        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Exception in TransfersService:dispatchBatch " << e.what() << commit;
     }
     catch (...)
     {
@@ -296,60 +483,91 @@ static void failUnschedulable(const std::vector<QueueId> &unschedulable)
 }
 
 
-void TransfersService::executeUrlcopy()
+/// Keep only the queues of the given links
+static void filterLinks(std::vector<QueueId> &queues, const std::set<SchedulerWakeup::Link> &links)
+{
+    queues.erase(std::remove_if(queues.begin(), queues.end(),
+        [&links](const QueueId &queue) {
+            return links.count(SchedulerWakeup::Link(queue.sourceSe, queue.destSe)) == 0;
+        }), queues.end());
+}
+
+
+static void filterOpenCircuits(std::vector<QueueId> &queues)
 {
-    std::vector<QueueId> queues, unschedulable;
-    boost::thread_group g;
+    LinkCircuitBreaker &breaker = LinkCircuitBreaker::instance();
+    queues.erase(std::remove_if(queues.begin(), queues.end(),
+        [&breaker](const QueueId &queue) {
+            return breaker.isOpen(queue.sourceSe, queue.destSe);
+        }), queues.end());
+}
+
 
+bool TransfersService::fetchBatch(const std::set<SchedulerWakeup::Link> &links, SchedulingBatch &batch)
+{
     // Bail out as soon as possible if there are too many url-copy processes
     int maxUrlCopy = config::ServerConfig::instance().get<int>("MaxUrlCopyProcesses");
-    int urlCopyCount = countProcessesWithName("fts_url_copy");
+    int urlCopyCount = ChildProcessRegistry::instance().count("fts_url_copy");
     int availableUrlCopySlots = maxUrlCopy - urlCopyCount;
 
     if (availableUrlCopySlots <= 0) {
         FTS3_COMMON_LOGGER_NEWLOG(WARNING)
             << "Reached limitation of MaxUrlCopyProcesses"
             << commit;
-        return;
+        return false;
     }
 
-    try {
-      time_t start = time(0); //std::chrono::system_clock::now();
-        DBSingleton::instance().getDBObjectInstance()->getQueuesWithPending(queues);
-        // Breaking determinism. See FTS-704 for an explanation.
-        std::random_shuffle(queues.begin(), queues.end());
-        // Apply VO shares at this level. Basically, if more than one VO is used the same link,
-        // pick one each time according to their respective weights
-        queues = applyVoShares(queues, unschedulable);
-        // Fail all that are unschedulable
-        failUnschedulable(unschedulable);
-
-        if (queues.empty()) {
-            return;
-        }
-        getFiles(queues, availableUrlCopySlots);
-        time_t end = time(0); //std::chrono::system_clock::now();
-        FTS3_COMMON_LOGGER_NEWLOG(INFO) << "DBtime=\"TransfersService\" "
-                                        << "func=\"executeUrlcopy\" "
-                                        << "DBcall=\"getQueuesWithPending\" " 
-                                        << "time=\"" << end - start << "\"" 
-                                        << commit;
+    auto db = DBSingleton::instance().getDBObjectInstance();
+    batch.seq = ++fetchSeq;
+    batch.allLinks = links.empty();
+    SchedulingBatch::Clock::time_point start = SchedulingBatch::Clock::now();
+
+    std::vector<QueueId> unschedulable;
+    db->getQueuesWithPending(batch.queues);
+    if (!links.empty()) {
+        filterLinks(batch.queues, links);
     }
-    catch (const boost::thread_interrupted&) {
-        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Interruption requested in TransfersService" << commit;
-        g.interrupt_all();
-        g.join_all();
-        throw;
+    // Do not even fetch the files of the links that are paused
+    filterOpenCircuits(batch.queues);
+    // Breaking determinism. See FTS-704 for an explanation.
+    std::random_shuffle(batch.queues.begin(), batch.queues.end());
+    // Apply VO shares at this level. Basically, if more than one VO is used the same link,
+    // pick one each time according to their respective weights
+    batch.queues = applyVoShares(batch.queues, unschedulable);
+    // Fail all that are unschedulable
+    failUnschedulable(unschedulable);
+    batch.queuesMs = msSince(start);
+
+    if (batch.queues.empty()) {
+        return false;
     }
-    catch (std::exception& e)
-    {
-        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Exception in TransfersService " << e.what() << commit;
-        throw;
+
+    // now get files to be scheduled
+    if (bulkScheduling) {
+        db->getReadyTransfersBulk(batch.queues, batch.voQueues);
     }
-    catch (...)
-    {
-        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Exception in TransfersService!" << commit;
-        throw;
+    else {
+        db->getReadyTransfers(batch.queues, batch.voQueues);
+    }
+    batch.filesMs = msSince(start);
+
+    if (batch.voQueues.empty()) {
+        return false;
+    }
+
+    // Configuration shared by all the executors of this batch
+    batch.configSnapshot = db->getConfigSnapshot(batch.voQueues);
+    batch.configMs = msSince(start);
+    batch.fetched = start;
+    return true;
+}
+
+
+void TransfersService::executeUrlcopy(const std::set<SchedulerWakeup::Link> &links)
+{
+    SchedulingBatch batch;
+    if (fetchBatch(links, batch)) {
+        dispatchBatch(batch);
     }
 }
 
@@ -22,22 +22,62 @@
 #ifndef PROCESSSERVICE_H_
 #define PROCESSSERVICE_H_
 
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
+#include "common/BoundedQueue.h"
+#include "common/Executor.h"
+#include "db/generic/ConfigSnapshot.h"
 #include "db/generic/QueueId.h"
+#include "db/generic/TransferFile.h"
 #include "../BaseService.h"
+#include "RecentLaunches.h"
+#include "SchedulerWakeup.h"
 
 
 namespace fts3 {
 namespace server {
 
 
+/// Pending transfers fetched from the database, waiting to be assigned and launched
+struct SchedulingBatch
+{
+    typedef std::chrono::steady_clock Clock;
+
+    /// Order of the fetch. Launches finished after the fetch started are not reflected in it
+    uint64_t seq;
+    bool allLinks;
+    std::vector<QueueId> queues;
+    std::map<std::string, std::list<TransferFile> > voQueues;
+    std::shared_ptr<const ConfigSnapshot> configSnapshot;
+
+    /// Time spent in each stage of the pipeline, in milliseconds
+    double queuesMs, filesMs, configMs, waitMs, assignMs, proxiesMs, launchMs;
+    Clock::time_point fetched;
+
+    SchedulingBatch(): seq(0), allLinks(true),
+        queuesMs(0), filesMs(0), configMs(0), waitMs(0), assignMs(0), proxiesMs(0), launchMs(0) {}
+};
+
+
+/// Schedules the pending transfers as a pipeline:
+///     fetch:    queues with pending transfers, VO shares, files and configuration from the database
+///     assign:   round-robin between VOs within the storage limits, proxies
+///     launch:   FileTransferExecutor tasks, which spawn the url-copy processes
+/// The fetch runs in the service thread, the assignment and the launch in a dispatcher thread,
+/// so the fetch of the next batch overlaps with the launch of the current one.
 class TransfersService: public BaseService
 {
 public:
     /// Constructor
-    TransfersService();
+    /// @param executor Runs the FileTransferExecutor tasks, shared with the other services
+    TransfersService(std::shared_ptr<fts3::common::Executor> executor);
 
     /// Destructor
     virtual ~TransfersService();
@@ -48,14 +88,39 @@ protected:
     std::string ftsHostName;
     std::string infosys;
     bool monitoringMessages;
-    int execPoolSize;
+    bool bulkScheduling;
+    std::shared_ptr<fts3::common::Executor> executor;
     std::string cmd;
     std::string logDir;
     std::string msgDir;
     boost::posix_time::time_duration schedulingInterval;
+    bool eventDrivenScheduling;
+    bool pipelinedScheduling;
+    int64_t bundleSizeThreshold;
+    unsigned bundleMaxFiles;
+
+    /// Schedule the pending transfers, fetch and launch one after the other
+    /// @param links Only for these links, all of them if empty
+    void executeUrlcopy(const std::set<SchedulerWakeup::Link> &links = std::set<SchedulerWakeup::Link>());
+
+    /// Fetch stage
+    /// @return false if there is nothing to launch
+    bool fetchBatch(const std::set<SchedulerWakeup::Link> &links, SchedulingBatch &batch);
+
+    /// Assign and launch stages. Returns once all the executors are done
+    void dispatchBatch(SchedulingBatch &batch);
+
+private:
+    /// Number of fetches started
+    std::atomic<uint64_t> fetchSeq;
+
+    /// Launches that may not be reflected yet in the batches waiting in the pipeline
+    RecentLaunches recentlyLaunched;
+
+    fts3::common::BoundedQueue<SchedulingBatch> batches;
 
-    void getFiles(const std::vector<QueueId>& queues, int availableUrlCopySlots);
-    void executeUrlcopy();
+    /// Dispatcher thread body
+    void dispatchBatches();
 };
 
 } // end namespace server
@@ -26,6 +26,8 @@
 #include <cajun/json/elements.h>
 #include <cajun/json/reader.h>
 #include <boost/algorithm/string/replace.hpp>
+#include <boost/lexical_cast.hpp>
+#include <sstream>
 
 namespace fts3 {
 namespace server {
@@ -46,6 +48,39 @@ std::string UrlCopyCmd::prepareMetadataString(const std::string &text)
 }
 
 
+std::string UrlCopyCmd::getBulkFileLine(const TransferFile &transfer)
+{
+    std::string fileMetadata = prepareMetadataString(transfer.fileMetadata);
+    if (fileMetadata.empty())
+        fileMetadata = "x";
+
+    std::string archiveMetadata = prepareMetadataString(transfer.transferMetadata);
+    if (archiveMetadata.empty())
+        archiveMetadata = "x";
+
+    std::string bringOnlineToken = transfer.bringOnlineToken;
+    if (bringOnlineToken.empty())
+        bringOnlineToken = "x";
+
+    std::string checksum = transfer.checksum;
+    if (checksum.empty())
+        checksum = "x";
+
+    std::ostringstream line;
+    line << std::fixed
+         << transfer.fileId << " "
+         << transfer.sourceSurl << " "
+         << transfer.destSurl << " "
+         << checksum << " "
+         << boost::lexical_cast<long long>(transfer.userFilesize) << " "
+         << fileMetadata << " "
+         << archiveMetadata << " "
+         << bringOnlineToken << " "
+         << transfer.scitag;
+    return line.str();
+}
+
+
 void UrlCopyCmd::setFlag(const std::string &key, bool set)
 {
     options.erase(key);
@@ -84,6 +119,69 @@ std::string UrlCopyCmd::generateParameters(void)
 }
 
 
+std::vector<std::string> UrlCopyCmd::getArguments(void)
+{
+    std::vector<std::string> args;
+    args.reserve(flags.size() + 2 * options.size());
+
+    for (auto flag = flags.begin(); flag != flags.end(); ++flag) {
+        args.push_back("--" + *flag);
+    }
+
+    for (auto option = options.begin(); option != options.end(); ++option) {
+        args.push_back("--" + option->first);
+        args.push_back(option->second);
+    }
+    return args;
+}
+
+
+std::string UrlCopyCmd::getWorkerKey(void)
+{
+    // Credentials loaded into the gfal2 context, or several transfers for the same process
+    static const char *exclusive[] = {
+        "reuse", "bulk-file", "oauth", "auth-method", "retrieve-se-token",
+        "source-issuer", "dest-issuer"
+    };
+    // Kept by the process, or set into the gfal2 context and not reset between transfers
+    static const char *shared[] = {
+        "vo", "user-dn", "proxy", "infosystem", "3rd-party-turl", "copy-mode", "debug",
+        "udt", "ipv4", "ipv6", "disable-fallback", "logDir", "msgDir", "monitoring", "ping-interval"
+    };
+
+    for (auto key: exclusive) {
+        if (options.count(key) || std::find(flags.begin(), flags.end(), key) != flags.end()) {
+            return std::string();
+        }
+    }
+
+    std::ostringstream workerKey;
+    for (auto key: shared) {
+        workerKey << key << '=';
+        auto option = options.find(key);
+        if (option != options.end()) {
+            workerKey << option->second;
+        }
+        else if (std::find(flags.begin(), flags.end(), key) != flags.end()) {
+            workerKey << "1";
+        }
+        workerKey << ';';
+    }
+    return workerKey.str();
+}
+
+
+void UrlCopyCmd::setWorker(const std::string &socketPath, const std::string &key,
+    unsigned maxTransfers, unsigned maxRssMb, unsigned idleTimeout)
+{
+    setOption("worker-socket", socketPath);
+    setOption("worker-key", key);
+    setOption("worker-max-transfers", maxTransfers);
+    setOption("worker-max-rss", maxRssMb);
+    setOption("worker-idle-timeout", idleTimeout);
+}
+
+
 void UrlCopyCmd::setLogDir(const std::string &path)
 {
     setOption("logDir", path);
@@ -309,6 +407,12 @@ void UrlCopyCmd::setFromTransfer(const TransferFile &transfer,
 }
 
 
+void UrlCopyCmd::setBulkFile(const std::string &path)
+{
+    setOption("bulk-file", path);
+}
+
+
 void UrlCopyCmd::setFromProtocol(const TransferFile::ProtocolParameters &protocol)
 {
     if (protocol.nostreams > 0) {
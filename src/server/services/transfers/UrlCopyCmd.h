@@ -24,6 +24,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "db/generic/TransferFile.h"
 
@@ -50,10 +51,20 @@ private:
 public:
     static const std::string Program;
     static std::string prepareMetadataString(const std::string& text);
+    /// Line describing the transfer inside a bulk file, see setBulkFile
+    static std::string getBulkFileLine(const TransferFile& transfer);
 
     UrlCopyCmd();
 
     std::string generateParameters(void);
+    /// Same parameters as generateParameters, one entry per argument
+    std::vector<std::string> getArguments(void);
+    /// Transfers with the same key can run one after the other on the same url-copy worker:
+    /// same VO and credentials, and same process-wide gfal2 configuration.
+    /// Empty if the transfer must run on a process of its own (session reuse, tokens)
+    std::string getWorkerKey(void);
+    void setWorker(const std::string& socketPath, const std::string& key,
+        unsigned maxTransfers, unsigned maxRssMb, unsigned idleTimeout);
 
     void setLogDir(const std::string&);
     void setMonitoring(bool, const std::string&);
@@ -74,6 +85,8 @@ public:
     void setRetrieveSEToken(bool);
 
     void setFromTransfer(const TransferFile&, bool isMultiple, bool publishUserDn, const std::string &msgDir);
+    /// Read the transfers from this file instead of the one named after the job
+    void setBulkFile(const std::string&);
 
     void setFromProtocol(const TransferFile::ProtocolParameters& protocol);
     void setSecondsPerMB(long);
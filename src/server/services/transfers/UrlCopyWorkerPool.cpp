@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "UrlCopyWorkerPool.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "common/Exceptions.h"
+#include "common/Logger.h"
+
+using namespace fts3::common;
+
+
+namespace fts3 {
+namespace server {
+
+/// The worker must acknowledge a transfer within this time, in seconds
+static const int ACK_TIMEOUT = 5;
+
+/// Isolation keys are a few hundred bytes
+static const size_t MAX_KEY_SIZE = 64 * 1024;
+
+
+UrlCopyWorkerPool::UrlCopyWorkerPool(): listenFd(-1), nIdle(0)
+{
+}
+
+
+UrlCopyWorkerPool::~UrlCopyWorkerPool()
+{
+    stop();
+}
+
+
+void UrlCopyWorkerPool::start(const std::string &path)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    if (listenFd >= 0) {
+        return;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        throw SystemError(std::string(__func__) + ": Socket path too long: " + path);
+    }
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw SystemError(std::string(__func__) + ": Could not create the socket: " + strerror(errno));
+    }
+
+    // Left behind by a previous run
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 128) < 0) {
+        std::string reason = strerror(errno);
+        close(fd);
+        throw SystemError(std::string(__func__) + ": Could not listen on " + path + ": " + reason);
+    }
+
+    listenFd = fd;
+    socketPath = path;
+    acceptor = boost::thread(&UrlCopyWorkerPool::acceptWorkers, this);
+
+    FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Url-copy worker pool listening on " << path << commit;
+}
+
+
+void UrlCopyWorkerPool::stop()
+{
+    acceptor.interrupt();
+    acceptor.join();
+
+    boost::mutex::scoped_lock lock(mutex);
+    if (listenFd < 0) {
+        return;
+    }
+
+    close(listenFd);
+    listenFd = -1;
+    unlink(socketPath.c_str());
+
+    for (auto i = idle.begin(); i != idle.end(); ++i) {
+        for (auto worker = i->second.begin(); worker != i->second.end(); ++worker) {
+            close(worker->fd);
+        }
+    }
+    idle.clear();
+    nIdle = 0;
+    assigned.clear();
+}
+
+
+bool UrlCopyWorkerPool::isRunning()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return listenFd >= 0;
+}
+
+
+std::string UrlCopyWorkerPool::getSocketPath()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return socketPath;
+}
+
+
+size_t UrlCopyWorkerPool::idleCount()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return nIdle;
+}
+
+
+bool UrlCopyWorkerPool::dispatch(const std::string &key, uint64_t fileId, const std::vector<std::string> &args,
+    pid_t &pid)
+{
+    std::string request;
+    for (auto arg = args.begin(); arg != args.end(); ++arg) {
+        request.append(*arg);
+        request.push_back('\0');
+    }
+
+    while (true) {
+        Worker worker;
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            auto i = idle.find(key);
+            if (i == idle.end()) {
+                return false;
+            }
+            // Most recently used first, so the surplus ones reach their idle timeout
+            worker = i->second.back();
+            i->second.pop_back();
+            if (i->second.empty()) {
+                idle.erase(i);
+            }
+            --nIdle;
+        }
+
+        char ack = 0;
+        bool accepted = send(worker.fd, request.data(), request.size(), MSG_NOSIGNAL) ==
+            static_cast<ssize_t>(request.size()) && recv(worker.fd, &ack, 1, 0) == 1;
+        close(worker.fd);
+
+        if (accepted) {
+            boost::mutex::scoped_lock lock(mutex);
+            assigned[worker.pid] = fileId;
+            pid = worker.pid;
+            return true;
+        }
+
+        // It may have reached its idle timeout meanwhile, try with the next one
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            assigned.erase(worker.pid);
+        }
+        FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "Url-copy worker " << worker.pid << " did not take the transfer" << commit;
+    }
+}
+
+
+bool UrlCopyWorkerPool::runsTransfer(pid_t pid, uint64_t fileId)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    auto worker = assigned.find(pid);
+    return worker == assigned.end() || worker->second == fileId;
+}
+
+
+void UrlCopyWorkerPool::forget(pid_t pid)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    assigned.erase(pid);
+}
+
+
+void UrlCopyWorkerPool::purgeClosed()
+{
+    // Idle workers do not send anything after their key, so a readable socket means it has been closed
+    boost::mutex::scoped_lock lock(mutex);
+    for (auto i = idle.begin(); i != idle.end();) {
+        for (auto worker = i->second.begin(); worker != i->second.end();) {
+            struct pollfd workerPoll = {worker->fd, POLLIN, 0};
+            if (poll(&workerPoll, 1, 0) != 0) {
+                close(worker->fd);
+                assigned.erase(worker->pid);
+                worker = i->second.erase(worker);
+                --nIdle;
+            }
+            else {
+                ++worker;
+            }
+        }
+        if (i->second.empty()) {
+            i = idle.erase(i);
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+
+void UrlCopyWorkerPool::acceptWorkers()
+{
+    std::vector<char> key(MAX_KEY_SIZE);
+    time_t lastPurge = time(NULL);
+
+    while (!boost::this_thread::interruption_requested()) {
+        struct pollfd listenPoll = {listenFd, POLLIN, 0};
+        int ready = poll(&listenPoll, 1, 1000);
+        boost::this_thread::interruption_point();
+
+        if (ready < 0 && errno != EINTR) {
+            FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Url-copy worker pool failed to poll: " << strerror(errno) << commit;
+            return;
+        }
+
+        // Forget the workers that reached their idle timeout
+        if (time(NULL) != lastPurge) {
+            purgeClosed();
+            lastPurge = time(NULL);
+        }
+
+        if (ready <= 0) {
+            continue;
+        }
+
+        int fd = accept4(listenFd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+
+        struct ucred credentials;
+        socklen_t credentialsSize = sizeof(credentials);
+        if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &credentialsSize) < 0) {
+            close(fd);
+            continue;
+        }
+
+        // Only url-copy processes run by the server may be given transfers
+        if (credentials.uid != getuid()) {
+            FTS3_COMMON_LOGGER_NEWLOG(WARNING) << "Url-copy worker pool rejected a connection from pid "
+                << credentials.pid << " with uid " << credentials.uid << commit;
+            close(fd);
+            continue;
+        }
+
+        struct timeval timeout = {ACK_TIMEOUT, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        ssize_t keySize = recv(fd, key.data(), key.size(), 0);
+        if (keySize <= 0) {
+            close(fd);
+            continue;
+        }
+
+        boost::mutex::scoped_lock lock(mutex);
+        Worker worker = {fd, credentials.pid};
+        idle[std::string(key.data(), keySize)].push_back(worker);
+        ++nIdle;
+        assigned[credentials.pid] = 0;
+    }
+}
+
+} // namespace server
+} // namespace fts3
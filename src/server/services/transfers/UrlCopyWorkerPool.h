@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef URLCOPYWORKERPOOL_H_
+#define URLCOPYWORKERPOOL_H_
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include "common/Singleton.h"
+
+
+namespace fts3 {
+namespace server {
+
+/// Idle fts_url_copy processes waiting for their next transfer.
+///
+/// A url-copy started with --worker-socket runs the transfer from its command line
+/// as usual, and then connects to this pool to announce itself as idle, with its
+/// isolation key (see UrlCopyCmd::getWorkerKey). A new transfer with the same key is handed
+/// to it instead of spawning a new process, so it skips the gfal2 initialization, the proxy
+/// loading and the message bus and ping socket setup.
+///
+/// The workers exit by themselves after a number of transfers, when their memory grows
+/// beyond a limit, or if they stay idle for too long.
+///
+/// A worker keeps its pid from one transfer to the next, so the pool tracks which file each
+/// known worker runs. A signal meant for a file must not reach the worker once it moved on.
+///
+/// The protocol runs over a SOCK_SEQPACKET Unix socket, one connection per idle period:
+///     worker -> pool  the isolation key
+///     pool -> worker  the arguments of the transfer, as NUL separated strings
+///     worker -> pool  one byte, the transfer has been accepted
+class UrlCopyWorkerPool: public fts3::common::Singleton<UrlCopyWorkerPool>
+{
+public:
+    UrlCopyWorkerPool();
+    virtual ~UrlCopyWorkerPool();
+
+    /// Start listening on the given path. Throws SystemError on failure
+    void start(const std::string &socketPath);
+
+    /// Stop listening, and disconnect the idle workers, which then exit
+    void stop();
+
+    /// @return true if the pool is accepting workers
+    bool isRunning();
+
+    /// @return the path of the socket
+    std::string getSocketPath();
+
+    /// @return the number of idle workers
+    size_t idleCount();
+
+    /// Hand a transfer to an idle worker with the given key
+    /// @param key      Isolation key of the transfer
+    /// @param fileId   File of the transfer
+    /// @param args     The url-copy arguments of the transfer
+    /// @param pid      Set to the pid of the worker that took it
+    /// @return false if no idle worker took it, so a new process has to be spawned
+    bool dispatch(const std::string &key, uint64_t fileId, const std::vector<std::string> &args, pid_t &pid);
+
+    /// @return false if pid is a worker of the pool that is idle, or runs another file.
+    ///         Any other pid, i.e. a process still on the transfer it was started with, runs it
+    bool runsTransfer(pid_t pid, uint64_t fileId);
+
+    /// A new process got this pid, so the worker that had it is gone
+    void forget(pid_t pid);
+
+private:
+    struct Worker {
+        int fd;
+        pid_t pid;
+    };
+
+    boost::mutex mutex;
+    int listenFd;
+    std::string socketPath;
+    std::map<std::string, std::deque<Worker>> idle;
+    size_t nIdle;
+    /// File run by each worker known to the pool, 0 while idle
+    std::map<pid_t, uint64_t> assigned;
+    boost::thread acceptor;
+
+    /// Accepts the workers announcing themselves, runs in its own thread
+    void acceptWorkers();
+
+    /// Drops the idle workers that have disconnected
+    void purgeClosed();
+};
+
+} // namespace server
+} // namespace fts3
+
+#endif // URLCOPYWORKERPOOL_H_
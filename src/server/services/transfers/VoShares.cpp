@@ -15,34 +15,38 @@
  */
 
 #include "VoShares.h"
+
+#include <algorithm>
+
 #include "db/generic/SingleDbInstance.h"
-#include <boost/random/mersenne_twister.hpp>
-#include <boost/random/discrete_distribution.hpp>
 #include <common/Logger.h>
 
 using namespace db;
 using namespace fts3::common;
 
-boost::mt19937 generator;
-
 namespace fts3 {
 namespace server {
 
 
+VoShareScheduler::VoShareScheduler(): lastPrune(time(NULL))
+{
+}
+
+
 /**
- * Given the pair, a list of vos for the pair, and a list of weights for VOs, pick one
- * based on those weights.
+ * Given the pair, a list of vos for the pair, and a list of weights for VOs, pick the one
+ * the furthest behind its share.
  * @note If a VO is not on the map, it will fallback to 'public', if it is there
  * @note If the weight for a VO/public is 0, it will never be picked!
  */
-boost::optional<QueueId> selectQueueForPair(const Pair &pair,
+boost::optional<QueueId> VoShareScheduler::select(const Pair &pair,
     const std::vector<std::pair<std::string, unsigned>> &vos,
     const std::map<std::string, double> &weights,
     std::vector<QueueId> &unschedulable)
 {
     // Weights per position in vos vector
     std::vector<double> finalWeights(vos.size());
-    int unschedulableCount = 0;
+    size_t unschedulableCount = 0;
 
     // Get the public (catchall weight)
     // If there is no config, this is the only weight!
@@ -88,14 +92,87 @@ boost::optional<QueueId> selectQueueForPair(const Pair &pair,
         return boost::optional<QueueId>();
     }
 
-    // And pick one at random
-    boost::random::discrete_distribution<> dist(finalWeights);
-    int chosen = dist(generator);
+    boost::mutex::scoped_lock lock(mutex);
+
+    const time_t now = time(NULL);
+    if (now - lastPrune > PRUNE_AFTER) {
+        lastPrune = now;
+        for (auto i = links.begin(); i != links.end();) {
+            if (now - i->second.lastSeen > PRUNE_AFTER) {
+                i = links.erase(i);
+            }
+            else {
+                ++i;
+            }
+        }
+    }
+
+    LinkState &state = links[pair];
+    state.lastSeen = now;
+
+    // Strides are in picks, so they do not depend on the scale of the weights
+    double totalWeight = 0;
+    for (size_t i = 0; i < vos.size(); ++i) {
+        if (finalWeights[i] > 0) {
+            totalWeight += finalWeights[i];
+        }
+    }
+
+    // The one that would be done first with its next pick goes next.
+    // Ties go by name, since the order of vos is random
+    std::map<std::string, double> pass;
+    int chosen = -1;
+    double chosenFinish = 0;
+    for (size_t i = 0; i < vos.size(); ++i) {
+        if (finalWeights[i] <= 0) {
+            continue;
+        }
+        auto previous = state.pass.find(vos[i].first);
+        double start = state.virtualTime;
+        if (previous != state.pass.end() && previous->second > start) {
+            start = previous->second;
+        }
+        pass[vos[i].first] = start;
+
+        double finish = start + totalWeight / finalWeights[i];
+        if (chosen < 0 || finish < chosenFinish ||
+            (finish == chosenFinish && vos[i].first < vos[chosen].first)) {
+            chosen = static_cast<int>(i);
+            chosenFinish = finish;
+        }
+    }
+
+    // VOs not waiting are forgotten, and will start from the one the furthest behind
+    pass[vos[chosen].first] = chosenFinish;
+    state.virtualTime = chosenFinish;
+    for (auto i = pass.begin(); i != pass.end(); ++i) {
+        state.virtualTime = std::min(state.virtualTime, i->second);
+    }
+    state.pass.swap(pass);
+
     return QueueId(pair.source, pair.destination, vos[chosen].first, vos[chosen].second);
 }
 
 
-std::vector<QueueId> applyVoShares(const std::vector<QueueId> queues, std::vector<QueueId> &unschedulable)
+size_t VoShareScheduler::size()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    return links.size();
+}
+
+
+boost::optional<QueueId> selectQueueForPair(const Pair &pair,
+    const std::vector<std::pair<std::string, unsigned>> &vos,
+    const std::map<std::string, double> &weights,
+    std::vector<QueueId> &unschedulable)
+{
+    return VoShareScheduler::instance().select(pair, vos, weights, unschedulable);
+}
+
+
+std::vector<QueueId> applyVoShares(const std::vector<QueueId> &queues,
+    const std::map<std::pair<std::string, std::string>, std::vector<ShareConfig>> &shares,
+    std::vector<QueueId> &unschedulable)
 {
     // Vo list for each pair
     std::map<Pair, std::vector<std::pair<std::string, unsigned>>> vosPerPair;
@@ -109,11 +186,13 @@ std::vector<QueueId> applyVoShares(const std::vector<QueueId> queues, std::vecto
     for (auto j = vosPerPair.begin(); j != vosPerPair.end(); ++j) {
         const Pair &p = j->first;
         const std::vector<std::pair<std::string, unsigned>> &vos = j->second;
-        std::vector<ShareConfig> shares = DBSingleton::instance().getDBObjectInstance()->getShareConfig(p.source, p.destination);
 
         std::map<std::string, double> weights;
-        for (auto k = shares.begin(); k != shares.end(); ++k) {
-            weights[k->vo] = k->weight;
+        auto linkShares = shares.find(std::make_pair(p.source, p.destination));
+        if (linkShares != shares.end()) {
+            for (auto k = linkShares->second.begin(); k != linkShares->second.end(); ++k) {
+                weights[k->vo] = k->weight;
+            }
         }
 
         boost::optional<QueueId> chosen = selectQueueForPair(p, vos, weights, unschedulable);
@@ -134,5 +213,14 @@ std::vector<QueueId> applyVoShares(const std::vector<QueueId> queues, std::vecto
     return result;
 }
 
+
+std::vector<QueueId> applyVoShares(const std::vector<QueueId> queues, std::vector<QueueId> &unschedulable)
+{
+    if (queues.empty()) {
+        return queues;
+    }
+    return applyVoShares(queues, DBSingleton::instance().getDBObjectInstance()->getShareConfigs(), unschedulable);
+}
+
+}
 }
-}
\ No newline at end of file
@@ -17,32 +17,93 @@
 #ifndef VOSHARES_H
 #define VOSHARES_H
 
+#include <ctime>
 #include <vector>
 #include <db/generic/Pair.h>
 #include <map>
 #include <db/generic/QueueId.h>
+#include <db/generic/ShareConfig.h>
 #include <boost/optional.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "common/Singleton.h"
 
 
 namespace fts3 {
 namespace server {
 
+/**
+ * Stride scheduler of the VOs sharing a link.
+ *
+ * Every time a VO is picked for a link, it moves forward by the inverse of its share,
+ * and the VO that would be the least advanced after its next pick goes next. Over n picks,
+ * each VO gets n * weight / total weights of them, off by less than two.
+ * The position of each VO is kept between scheduling cycles. A VO that was not waiting
+ * starts from the position of the waiting VO the furthest behind, so it does not accumulate
+ * credit while idle.
+ */
+class VoShareScheduler: public fts3::common::Singleton<VoShareScheduler>
+{
+public:
+    /// Forget the state of links not seen for this many seconds
+    static const time_t PRUNE_AFTER = 3600;
+
+    VoShareScheduler();
+
+    /**
+     * Select a single QueueId for a pair, given a list of waiting VOs and the configured shares
+     * @param pair Source => Destination pair
+     * @param vos  List of VO waiting for this link
+     * @param weights Map with the weights given for the VOs. 'public' is split among those not explictly configured.
+     * @param unschedulable If there is no share for a given link/vo combination, it will be put here
+     * @return One single link/vo combination, the one the furthest behind its share
+     */
+    boost::optional<QueueId> select(const Pair &pair,
+        const std::vector<std::pair<std::string, unsigned>> &vos,
+        const std::map<std::string, double> &weights,
+        std::vector<QueueId> &unschedulable);
+
+    /// Number of links with a state
+    size_t size();
+
+private:
+    struct LinkState {
+        LinkState(): virtualTime(0), lastSeen(0) {}
+
+        /// Position of each VO
+        std::map<std::string, double> pass;
+        /// Lowest position of the VOs waiting at the last pick, where the new ones start
+        double virtualTime;
+        /// When the link was last seen
+        time_t lastSeen;
+    };
+
+    boost::mutex mutex;
+    std::map<Pair, LinkState> links;
+    time_t lastPrune;
+};
+
 /**
  * Apply VO shares if required.
  * @param queues Set of queues with queued transfers
  * @param unschedulable Set of queues that are impossible to schedule, due to empty shares
  * @return A set of queues where there is only one per unique source/dest.
  *         Filtering is applied according to the configured relative weights.
+ * @note The share configuration of all the links is loaded with a single query
  */
 std::vector<QueueId> applyVoShares(const std::vector<QueueId> queues, std::vector<QueueId> &unschedulable);
 
+/**
+ * Same as applyVoShares, with the share configuration already loaded
+ * @param shares Share configuration by source and destination, as returned by getShareConfigs
+ */
+std::vector<QueueId> applyVoShares(const std::vector<QueueId> &queues,
+    const std::map<std::pair<std::string, std::string>, std::vector<ShareConfig>> &shares,
+    std::vector<QueueId> &unschedulable);
+
 /**
  * Select a single QueueId for a pair, given a list of waiting VOs and the configured shares
- * @param pair Source => Destination pair
- * @param vos  List of VO waiting for this link
- * @param weights Map with the weights given for the VOs. 'public' is split among those not explictly configured.
- * @param unschedulable If there is no share for a given link/vo combination, it will be put here
- * @return One single link/vo combination, with the probability given by the weights
+ * @see VoShareScheduler::select
  */
 boost::optional<QueueId> selectQueueForPair(const Pair &pair,
     const std::vector<std::pair<std::string, unsigned>> &vos,
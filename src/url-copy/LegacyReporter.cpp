@@ -31,6 +31,12 @@ LegacyReporter::LegacyReporter(const UrlCopyOpts &opts): producer(opts.msgDir),
 }
 
 
+void LegacyReporter::setOptions(const UrlCopyOpts &opts)
+{
+    this->opts = opts;
+}
+
+
 void LegacyReporter::sendTransferStart(const Transfer &transfer, Gfal2TransferParams&)
 {
     // Log file
@@ -378,6 +384,8 @@ void LegacyReporter::sendPing(Transfer &transfer)
     ping.set_transfer_status("ACTIVE");
     ping.set_source_surl(transfer.source.fullUri);
     ping.set_dest_surl(transfer.destination.fullUri);
+    ping.set_source_se(transfer.source.getSeName());
+    ping.set_dest_se(transfer.destination.getSeName());
     ping.set_process_id(getpid());
     ping.set_throughput(transfer.averageThroughput / 1024.0);
     ping.set_instantaneous_throughput(transfer.instantaneousThroughput / 1024.0);
@@ -31,6 +31,10 @@ private:
 public:
     LegacyReporter(const UrlCopyOpts &opts);
 
+    /// Report the following transfers with these options. Used by the workers, which keep
+    /// the message producer and the ping socket between transfers
+    void setOptions(const UrlCopyOpts &opts);
+
     virtual void sendTransferStart(const Transfer&, Gfal2TransferParams&);
 
     virtual void sendProtocol(const Transfer&, Gfal2TransferParams&);
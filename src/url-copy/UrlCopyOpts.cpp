@@ -96,6 +96,12 @@ const option UrlCopyOpts::long_options[] =
     {"logDir",            required_argument, 0, 900},
     {"msgDir",            required_argument, 0, 901},
 
+    {"worker-socket",     required_argument, 0, 1000},
+    {"worker-key",        required_argument, 0, 1001},
+    {"worker-max-transfers", required_argument, 0, 1002},
+    {"worker-max-rss",    required_argument, 0, 1003},
+    {"worker-idle-timeout", required_argument, 0, 1004},
+
     {"help",              no_argument,       0, 0},
     {"debug",             required_argument, 0, 1},
     {"stderr",            no_argument,       0, 2},
@@ -203,7 +209,8 @@ UrlCopyOpts::UrlCopyOpts():
         timeout(0), enableUdt(false), enableIpv6(boost::indeterminate), addSecPerMb(0), noStreaming(false),
         skipEvict(false), enableMonitoring(false), active(0), pingInterval(60), retry(0), retryMax(0),
         logDir("/var/log/fts3"), msgDir("/var/lib/fts3"),
-        debugLevel(0), logToStderr(false)
+        debugLevel(0), logToStderr(false),
+        workerMaxTransfers(100), workerMaxRss(512), workerIdleTimeout(30)
 {
 }
 
@@ -226,6 +233,9 @@ void UrlCopyOpts::parse(int argc, char * const argv[])
     int opt;
     Transfer referenceTransfer;
 
+    // Full reinitialization of getopt, workers parse the options of each transfer
+    optind = 0;
+
     try {
         while ((opt = getopt_long_only(argc, argv, short_options, long_options, NULL)) > -1) {
             switch (opt) {
@@ -430,6 +440,22 @@ void UrlCopyOpts::parse(int argc, char * const argv[])
                     msgDir = boost::lexical_cast<std::string>(optarg);
                     break;
 
+                case 1000:
+                    workerSocket = optarg;
+                    break;
+                case 1001:
+                    workerKey = optarg;
+                    break;
+                case 1002:
+                    workerMaxTransfers = boost::lexical_cast<unsigned>(optarg);
+                    break;
+                case 1003:
+                    workerMaxRss = boost::lexical_cast<unsigned>(optarg);
+                    break;
+                case 1004:
+                    workerIdleTimeout = boost::lexical_cast<unsigned>(optarg);
+                    break;
+
                 default:
                     usage(argv[0]);
             }
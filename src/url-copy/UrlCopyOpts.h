@@ -87,6 +87,13 @@ public:
     unsigned debugLevel;
     bool     logToStderr;
 
+    // Worker mode, see UrlCopyWorkerPool
+    std::string workerSocket;
+    std::string workerKey;
+    unsigned workerMaxTransfers;
+    unsigned workerMaxRss;
+    unsigned workerIdleTimeout;
+
     Transfer::TransferList transfers;
 
 private:
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "WorkerChannel.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+
+#include "common/Logger.h"
+
+using fts3::common::commit;
+
+/// Same limit as the server side, url-copy command lines are a few KB
+static const size_t MAX_REQUEST_SIZE = 128 * 1024;
+
+
+/// Connect to the pool and send the key
+/// @return the connected socket, or -1
+static int announce(const std::string &socketPath, const std::string &key)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Worker socket path too long: " << socketPath << commit;
+        return -1;
+    }
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        FTS3_COMMON_LOGGER_NEWLOG(ERR) << "Could not create the worker socket: " << strerror(errno) << commit;
+        return -1;
+    }
+
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        send(fd, key.data(), key.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(key.size())) {
+        FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Could not reach the worker pool: " << strerror(errno) << commit;
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+bool waitForTransfer(const std::string &socketPath, const std::string &key, unsigned idleTimeout,
+    const std::atomic<bool> &stop, std::vector<std::string> &args)
+{
+    int fd = announce(socketPath, key);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Wake up every second to check if the worker has been asked to stop
+    const time_t deadline = time(NULL) + idleTimeout;
+    int ready = 0;
+    while (ready == 0 && !stop && time(NULL) < deadline) {
+        struct pollfd channelPoll = {fd, POLLIN, 0};
+        ready = poll(&channelPoll, 1, 1000);
+        if (ready < 0 && errno == EINTR) {
+            ready = 0;
+        }
+    }
+
+    std::vector<char> request(MAX_REQUEST_SIZE);
+    ssize_t size = -1;
+    if (ready > 0 && !stop) {
+        size = recv(fd, request.data(), request.size(), 0);
+    }
+
+    // Closed by the server, which is stopping, or the transfer is not valid
+    if (size <= 0 || request[size - 1] != '\0') {
+        close(fd);
+        return false;
+    }
+
+    // From now on the server counts on this process
+    const char ack = 1;
+    bool accepted = send(fd, &ack, sizeof(ack), MSG_NOSIGNAL) == sizeof(ack);
+    close(fd);
+    if (!accepted) {
+        return false;
+    }
+
+    args.clear();
+    for (const char *arg = request.data(); arg < request.data() + size; arg += strlen(arg) + 1) {
+        args.push_back(arg);
+    }
+    return true;
+}
+
+
+unsigned getResidentMemoryMb()
+{
+    unsigned long totalPages = 0, residentPages = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> totalPages >> residentPages;
+    return (residentPages * sysconf(_SC_PAGESIZE)) / (1024 * 1024);
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WORKERCHANNEL_H
+#define WORKERCHANNEL_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+
+/// Announce this process as idle to the server worker pool, and wait for the next transfer
+/// @param socketPath   Socket of the worker pool
+/// @param key          Isolation key, only transfers with the same key are received
+/// @param idleTimeout  Seconds to wait for a transfer
+/// @param stop         Give up waiting as soon as it is set
+/// @param args         Set to the command line options of the transfer
+/// @return false if no transfer was received
+bool waitForTransfer(const std::string &socketPath, const std::string &key, unsigned idleTimeout,
+    const std::atomic<bool> &stop, std::vector<std::string> &args);
+
+/// @return the resident memory of this process, in MB
+unsigned getResidentMemoryMb();
+
+#endif // WORKERCHANNEL_H
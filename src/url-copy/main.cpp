@@ -21,12 +21,17 @@
 #include "UrlCopyOpts.h"
 #include "UrlCopyProcess.h"
 #include "LegacyReporter.h"
+#include "WorkerChannel.h"
 
+#include <atomic>
 #include <cstdlib>
 
 using fts3::common::commit;
 namespace panic = fts3::common::panic;
 
+/// Set on SIGINT or SIGTERM, workers do not take more transfers afterwards
+static std::atomic<bool> stopRequested(false);
+
 
 /// Signal handler
 static void signalCallback(int signum, void *udata)
@@ -52,6 +57,7 @@ static void signalCallback(int signum, void *udata)
             break;
         // Termination signal. The process can continue once the cancellation has been triggered.
         case SIGINT: case SIGTERM:
+            stopRequested = true;
             if (urlCopyProcess) {
                 urlCopyProcess->cancel();
             }
@@ -70,6 +76,58 @@ void clearEnvironment()
 }
 
 
+/// Keep running transfers with the same isolation key, handed by the server worker pool,
+/// until the limits set in the first options are reached
+static void runWorker(const UrlCopyOpts &firstOpts, LegacyReporter &reporter)
+{
+    std::vector<std::string> args;
+
+    for (unsigned done = 1; done < firstOpts.workerMaxTransfers && !stopRequested; ++done) {
+        unsigned rss = getResidentMemoryMb();
+        if (firstOpts.workerMaxRss && rss > firstOpts.workerMaxRss) {
+            FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Worker memory grew to " << rss << " MB, exiting" << commit;
+            break;
+        }
+
+        if (!waitForTransfer(firstOpts.workerSocket, firstOpts.workerKey, firstOpts.workerIdleTimeout,
+            stopRequested, args)) {
+            break;
+        }
+
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>("fts_url_copy"));
+        for (auto arg = args.begin(); arg != args.end(); ++arg) {
+            argv.push_back(const_cast<char*>(arg->c_str()));
+        }
+        argv.push_back(NULL);
+
+        UrlCopyOpts opts;
+        opts.parse(argv.size() - 1, argv.data());
+        // Some transfers raise the gfal2 log level
+        setupLogging(opts.debugLevel);
+        reporter.setOptions(opts);
+
+        // A new gfal2 context each time, so no setting is carried over from the previous transfer
+        UrlCopyProcess urlCopyProcess(opts, reporter);
+        panic::setup_signal_handlers(signalCallback, &urlCopyProcess);
+
+        // Taken just as the termination signal arrived
+        if (stopRequested) {
+            urlCopyProcess.cancel();
+        }
+
+        try {
+            urlCopyProcess.run();
+        }
+        catch (const std::exception &e) {
+            urlCopyProcess.panic(e.what());
+        }
+
+        panic::setup_signal_handlers(signalCallback, NULL);
+    }
+}
+
+
 int main(int argc, char *argv[])
 {
     if (getuid() == 0 || geteuid() == 0) {
@@ -101,5 +159,10 @@ int main(int argc, char *argv[])
         urlCopyProcess.panic(e.what());
     }
 
+    if (!opts.workerSocket.empty()) {
+        panic::setup_signal_handlers(signalCallback, NULL);
+        runWorker(opts, reporter);
+    }
+
     return 0;
 }
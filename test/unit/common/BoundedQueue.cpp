@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+#include <boost/thread.hpp>
+
+#include <memory>
+
+#include "common/BoundedQueue.h"
+
+using namespace fts3::common;
+
+
+BOOST_AUTO_TEST_SUITE(common)
+BOOST_AUTO_TEST_SUITE(BoundedQueueTest)
+
+
+BOOST_AUTO_TEST_CASE(order)
+{
+    BoundedQueue<std::unique_ptr<int>> queue(3);
+    for (int i = 0; i < 3; ++i) {
+        BOOST_CHECK(queue.push(std::unique_ptr<int>(new int(i))));
+    }
+    BOOST_CHECK_EQUAL(queue.size(), 3);
+
+    std::unique_ptr<int> value;
+    for (int i = 0; i < 3; ++i) {
+        BOOST_CHECK(queue.pop(value));
+        BOOST_CHECK_EQUAL(*value, i);
+    }
+    BOOST_CHECK_EQUAL(queue.size(), 0);
+}
+
+
+/// Several elements are taken at once, without waiting for more
+BOOST_AUTO_TEST_CASE(popMany)
+{
+    BoundedQueue<int> queue(5);
+    for (int i = 0; i < 5; ++i) {
+        BOOST_CHECK(queue.push(int(i)));
+    }
+
+    std::vector<int> values;
+    BOOST_CHECK(queue.popMany(values, 3));
+    BOOST_CHECK_EQUAL(values.size(), 3);
+    BOOST_CHECK(queue.popMany(values, 3));
+    BOOST_CHECK_EQUAL(values.size(), 5);
+    for (int i = 0; i < 5; ++i) {
+        BOOST_CHECK_EQUAL(values[i], i);
+    }
+    BOOST_CHECK_EQUAL(queue.size(), 0);
+
+    queue.close();
+    BOOST_CHECK(!queue.popMany(values, 3));
+    BOOST_CHECK_EQUAL(values.size(), 5);
+}
+
+
+/// The producer waits for the consumer once the queue is full
+BOOST_AUTO_TEST_CASE(backPressure)
+{
+    BoundedQueue<int> queue(1);
+    BOOST_CHECK(queue.push(1));
+
+    bool pushed = false;
+    boost::thread producer([&queue, &pushed]() {
+        pushed = queue.push(2);
+    });
+
+    boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+    BOOST_CHECK_EQUAL(queue.size(), 1);
+
+    int value = 0;
+    BOOST_CHECK(queue.pop(value));
+    BOOST_CHECK_EQUAL(value, 1);
+    producer.join();
+    BOOST_CHECK(pushed);
+    BOOST_CHECK(queue.pop(value));
+    BOOST_CHECK_EQUAL(value, 2);
+}
+
+
+/// Closing wakes up the consumer, after it gets what is left
+BOOST_AUTO_TEST_CASE(close)
+{
+    BoundedQueue<int> queue(2);
+    BOOST_CHECK(queue.push(1));
+
+    queue.close();
+    BOOST_CHECK(!queue.push(2));
+
+    int value = 0;
+    BOOST_CHECK(queue.pop(value));
+    BOOST_CHECK_EQUAL(value, 1);
+    BOOST_CHECK(!queue.pop(value));
+
+    BoundedQueue<int> empty(1);
+    bool popped = true;
+    boost::thread consumer([&empty, &popped]() {
+        int value;
+        popped = empty.pop(value);
+    });
+    boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+    empty.close();
+    consumer.join();
+    BOOST_CHECK(!popped);
+}
+
+
+BOOST_AUTO_TEST_CASE(interrupt)
+{
+    BoundedQueue<int> queue(1);
+    bool interrupted = false;
+    boost::thread consumer([&queue, &interrupted]() {
+        try {
+            int value;
+            queue.pop(value);
+        }
+        catch (const boost::thread_interrupted&) {
+            interrupted = true;
+        }
+    });
+    consumer.interrupt();
+    consumer.join();
+    BOOST_CHECK(interrupted);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+#include <boost/thread.hpp>
+
+#include "common/ChildProcessRegistry.h"
+#include "common/DaemonTools.h"
+
+using namespace fts3::common;
+
+
+BOOST_AUTO_TEST_SUITE(common)
+BOOST_AUTO_TEST_SUITE(ChildProcessRegistryTest)
+
+
+static pid_t spawnSleep()
+{
+    pid_t pid = fork();
+    if (pid == 0) {
+        execlp("sleep", "sleep", "60", NULL);
+        _exit(EXIT_FAILURE);
+    }
+    return pid;
+}
+
+
+/// The reaper runs asynchronously, give it some time
+static int waitForCount(ChildProcessRegistry &registry, const std::string &name, int expected)
+{
+    int count = registry.count(name);
+    for (int i = 0; i < 50 && count != expected; ++i) {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+        count = registry.count(name);
+    }
+    return count;
+}
+
+
+BOOST_AUTO_TEST_CASE(trackChildren)
+{
+    ChildProcessRegistry registry;
+    if (!registry.isSupported()) {
+        BOOST_TEST_MESSAGE("pidfd not supported, skipping");
+        return;
+    }
+
+    // Started before being queried, adopted from /proc
+    pid_t adopted = spawnSleep();
+    boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+    const int before = countProcessesWithName("sleep");
+    BOOST_CHECK_EQUAL(registry.count("sleep"), before);
+
+    pid_t children[3];
+    for (int i = 0; i < 3; ++i) {
+        children[i] = spawnSleep();
+        BOOST_CHECK(registry.add(children[i], "/usr/bin/sleep"));
+    }
+    // Added twice, counted once
+    BOOST_CHECK(registry.add(children[0], "sleep"));
+    BOOST_CHECK_EQUAL(registry.count("sleep"), before + 3);
+    BOOST_CHECK_EQUAL(registry.count("unlikely_binary_name"), 0);
+
+    kill(adopted, SIGKILL);
+    kill(children[0], SIGKILL);
+    waitpid(adopted, NULL, 0);
+    waitpid(children[0], NULL, 0);
+    BOOST_CHECK_EQUAL(waitForCount(registry, "sleep", before + 1), before + 1);
+
+    for (int i = 1; i < 3; ++i) {
+        kill(children[i], SIGKILL);
+        waitpid(children[i], NULL, 0);
+    }
+    BOOST_CHECK_EQUAL(waitForCount(registry, "sleep", before - 1), before - 1);
+
+    // Gone processes can not be tracked
+    BOOST_CHECK(!registry.add(children[0], "sleep"));
+}
+
+
+
+/// A process that can not be watched is still counted
+BOOST_AUTO_TEST_CASE(untrackedChild)
+{
+    ChildProcessRegistry registry;
+    if (!registry.isSupported()) {
+        BOOST_TEST_MESSAGE("pidfd not supported, skipping");
+        return;
+    }
+
+    const int before = registry.count("sleep");
+    pid_t child = spawnSleep();
+
+    // Out of file descriptors
+    struct rlimit limits;
+    BOOST_REQUIRE(getrlimit(RLIMIT_NOFILE, &limits) == 0);
+    struct rlimit none = limits;
+    none.rlim_cur = 0;
+    BOOST_REQUIRE(setrlimit(RLIMIT_NOFILE, &none) == 0);
+    const bool added = registry.add(child, "sleep");
+    BOOST_REQUIRE(setrlimit(RLIMIT_NOFILE, &limits) == 0);
+
+    BOOST_CHECK(!added);
+    BOOST_CHECK_EQUAL(registry.count("sleep"), before + 1);
+
+    kill(child, SIGKILL);
+    waitpid(child, NULL, 0);
+    BOOST_CHECK_EQUAL(waitForCount(registry, "sleep", before), before);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
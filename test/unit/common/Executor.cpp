@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+#include "common/Exceptions.h"
+#include "common/Executor.h"
+#include "common/ThreadPool.h"
+
+using fts3::common::Executor;
+using fts3::common::ThreadPool;
+
+
+BOOST_AUTO_TEST_SUITE(common)
+BOOST_AUTO_TEST_SUITE(ExecutorTest)
+
+
+BOOST_AUTO_TEST_CASE (ExecutorFuture)
+{
+    Executor executor(2);
+
+    std::future<int> answer = executor.submit([]() { return 42; });
+    std::future<int> failure = executor.submit([]() -> int { throw std::runtime_error("expected"); });
+
+    BOOST_CHECK_EQUAL(42, answer.get());
+    BOOST_CHECK_THROW(failure.get(), std::runtime_error);
+
+    executor.join();
+    Executor::Metrics metrics = executor.getMetrics();
+    BOOST_CHECK_EQUAL(2, metrics.submitted);
+    BOOST_CHECK_EQUAL(2, metrics.executed);
+    BOOST_CHECK_EQUAL(0, metrics.queueDepth);
+}
+
+
+BOOST_AUTO_TEST_CASE (ExecutorPriority)
+{
+    Executor executor(1);
+
+    // Keep the only worker busy until everything is queued
+    boost::mutex gate;
+    boost::unique_lock<boost::mutex> closed(gate);
+    executor.post([&gate]() { boost::mutex::scoped_lock lock(gate); });
+
+    std::vector<int> order;
+    for (int i = 0; i < 3; ++i) {
+        executor.post([&order, i]() { order.push_back(i); });
+    }
+    executor.post([&order]() { order.push_back(100); }, Executor::PRIORITY_HIGH);
+
+    closed.unlock();
+    executor.join();
+
+    BOOST_REQUIRE_EQUAL(4, order.size());
+    BOOST_CHECK_EQUAL(100, order[0]);
+    BOOST_CHECK_EQUAL(0, order[1]);
+    BOOST_CHECK_EQUAL(2, order[3]);
+}
+
+
+BOOST_AUTO_TEST_CASE (ExecutorSteal)
+{
+    Executor executor(4);
+
+    // All the work is posted from a single worker into its own deque, the others must steal it
+    std::atomic<int> done(0);
+    executor.submit([&executor, &done]() {
+        for (int i = 0; i < 100; ++i) {
+            executor.post([&done]() {
+                boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+                ++done;
+            });
+        }
+    }).get();
+
+    executor.join();
+    BOOST_CHECK_EQUAL(100, done);
+    BOOST_CHECK_GT(executor.getMetrics().steals, 0);
+}
+
+
+BOOST_AUTO_TEST_CASE (ExecutorInterrupt)
+{
+    Executor executor(1);
+    executor.post([]() {
+        while (true) {
+            boost::this_thread::interruption_point();
+        }
+    });
+    std::future<int> dropped = executor.submit([]() { return 1; });
+
+    executor.interrupt();
+    executor.join();
+
+    // Tasks not started are dropped, and can not be posted anymore
+    BOOST_CHECK_THROW(dropped.get(), std::future_error);
+    BOOST_CHECK_THROW(executor.post([]() {}), fts3::common::SystemError);
+}
+
+
+struct CountTask
+{
+    CountTask(std::atomic<int> &counter) : counter(counter) {}
+
+    void run(boost::any &)
+    {
+        ++counter;
+    }
+
+    std::atomic<int> &counter;
+};
+
+
+BOOST_AUTO_TEST_CASE (ThreadPoolSharedExecutor)
+{
+    std::shared_ptr<Executor> executor = std::make_shared<Executor>(3);
+    std::atomic<int> first(0), second(0);
+
+    // Pools sharing an executor only wait for their own tasks, and leave it running
+    for (int cycle = 0; cycle < 5; ++cycle) {
+        ThreadPool<CountTask> a(executor), b(executor);
+        BOOST_CHECK_EQUAL(3, a.size());
+        for (int i = 0; i < 10; ++i) {
+            a.start(new CountTask(first));
+            b.start(new CountTask(second), Executor::PRIORITY_HIGH);
+        }
+        a.join();
+        BOOST_CHECK_EQUAL(10 * (cycle + 1), first);
+        b.join();
+        BOOST_CHECK_EQUAL(10 * (cycle + 1), second);
+    }
+
+    BOOST_CHECK_EQUAL(100, executor->getMetrics().executed);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -17,6 +17,7 @@
 #include <boost/test/unit_test_suite.hpp>
 #include <boost/test/test_tools.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
 #include <fstream>
 
 #include "common/Logger.h"
@@ -45,6 +46,7 @@ BOOST_AUTO_TEST_CASE(logLevel)
 {
     fts3::common::Logger &logger = fts3::common::theLogger();
     logger.setLogLevel(fts3::common::Logger::WARNING);
+    BOOST_CHECK_EQUAL(logger.getCurrentLogLevel(), fts3::common::Logger::WARNING);
 
     LoggerTestHelper helper;
     FTS3_COMMON_LOGGER_NEWLOG(WARNING) << helper << fts3::common::commit;
@@ -60,6 +62,7 @@ BOOST_AUTO_TEST_CASE(logLevel)
     BOOST_CHECK_EQUAL(helper.counter, 2);
 
     logger.setLogLevel(fts3::common::Logger::DEBUG);
+    BOOST_CHECK_EQUAL(logger.getCurrentLogLevel(), fts3::common::Logger::DEBUG);
     FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << helper << fts3::common::commit;
     BOOST_CHECK_EQUAL(helper.counter, 3);
 }
@@ -123,5 +126,52 @@ BOOST_AUTO_TEST_CASE(redirect)
 }
 
 
+BOOST_AUTO_TEST_CASE(async)
+{
+    const std::string logPath("/tmp/fts3tests-async.log");
+    boost::filesystem::remove(logPath);
+
+    fts3::common::Logger &logger = fts3::common::theLogger();
+    BOOST_CHECK_EQUAL(logger.redirect(logPath, ""), 0);
+    logger.setLogLevel(fts3::common::Logger::INFO);
+    logger.setAsync(true);
+
+    const int nThreads = 4, nLines = 5000;
+    boost::thread_group threads;
+    for (int t = 0; t < nThreads; ++t) {
+        threads.create_thread([t]() {
+            for (int i = 0; i < nLines; ++i) {
+                FTS3_COMMON_LOGGER_NEWLOG(INFO) << "THREAD " << t << " LINE " << i << fts3::common::commit;
+                FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "FILTERED" << fts3::common::commit;
+            }
+        });
+    }
+    threads.join_all();
+    logger.setAsync(false);
+
+    // All the lines are there, in order for each thread
+    std::ifstream read(logPath);
+    std::vector<int> next(nThreads, 0);
+    std::string line;
+    bool ordered = true, filtered = false;
+    while (std::getline(read, line)) {
+        int t, i;
+        size_t pos = line.find("THREAD ");
+        if (pos != std::string::npos && sscanf(line.c_str() + pos, "THREAD %d LINE %d", &t, &i) == 2) {
+            ordered = ordered && (next[t] == i);
+            next[t] = i + 1;
+        }
+        filtered = filtered || line.find("FILTERED") != std::string::npos;
+    }
+    BOOST_CHECK(ordered);
+    BOOST_CHECK(!filtered);
+    for (int t = 0; t < nThreads; ++t) {
+        BOOST_CHECK_EQUAL(next[t], nLines);
+    }
+
+    BOOST_CHECK_NO_THROW(boost::filesystem::remove(logPath));
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
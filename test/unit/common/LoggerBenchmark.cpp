@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+
+#include "common/Logger.h"
+
+using fts3::common::Logger;
+using fts3::common::commit;
+
+
+BOOST_AUTO_TEST_SUITE(common)
+BOOST_AUTO_TEST_SUITE(LoggerBenchmark)
+
+
+/// Lines logged by each thread, can be changed with FTS3_LOGGER_BENCHMARK_LINES
+static int benchmarkLines()
+{
+    const char *env = getenv("FTS3_LOGGER_BENCHMARK_LINES");
+    return env ? atoi(env) : 20000;
+}
+
+
+/// Log from nThreads threads, as the supervisor does for every ping, and return lines/s.
+/// Half of the lines are below the log level
+static double logConcurrently(int nThreads, int nLines)
+{
+    boost::thread_group threads;
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < nThreads; ++t) {
+        threads.create_thread([t, nLines]() {
+            for (int i = 0; i < nLines; ++i) {
+                FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Got ping from " << t
+                    << " job_id=" << "1906cc40-b915-11e5-9a03-02163e006dd0"
+                    << " file_id=" << i << commit;
+                FTS3_COMMON_LOGGER_NEWLOG(DEBUG) << "Filtered out " << i << commit;
+            }
+        });
+    }
+    threads.join_all();
+    fts3::common::theLogger().drainAsync();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return (2.0 * nThreads * nLines) / elapsed;
+}
+
+
+BOOST_AUTO_TEST_CASE (contention)
+{
+    const std::string logPath("/tmp/fts3tests-benchmark.log");
+    const int nLines = benchmarkLines();
+    const int nThreads[] = {1, 8, 32};
+    int expected = 0;
+
+    Logger &logger = fts3::common::theLogger();
+    BOOST_CHECK_EQUAL(logger.redirect(logPath, ""), 0);
+    logger.setLogLevel(Logger::INFO);
+
+    for (size_t i = 0; i < sizeof(nThreads) / sizeof(int); ++i) {
+        logger.setAsync(false);
+        double sync = logConcurrently(nThreads[i], nLines);
+
+        logger.setAsync(true);
+        double async = logConcurrently(nThreads[i], nLines);
+        logger.setAsync(false);
+
+        BOOST_TEST_MESSAGE("[logger] " << nThreads[i] << " threads: synchronous " << sync
+            << " lines/s, asynchronous " << async << " lines/s");
+        expected += 2 * nThreads[i] * nLines;
+    }
+
+    // Nothing lost on the way, and nothing below the log level written
+    std::ifstream log(logPath);
+    std::string line;
+    int pings = 0, filtered = 0;
+    while (std::getline(log, line)) {
+        if (line.find("Got ping from") != std::string::npos) {
+            ++pings;
+        }
+        else if (line.find("Filtered out") != std::string::npos) {
+            ++filtered;
+        }
+    }
+    BOOST_CHECK_EQUAL(expected, pings);
+    BOOST_CHECK_EQUAL(0, filtered);
+
+    boost::filesystem::remove(logPath);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
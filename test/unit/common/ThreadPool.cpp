@@ -22,6 +22,7 @@
 #include <boost/test/test_tools.hpp>
 
 #include <boost/any.hpp>
+#include <atomic>
 
 #include "common/ThreadPool.h"
 
@@ -242,5 +243,36 @@ BOOST_AUTO_TEST_CASE (ThreadPoolReduce)
 }
 
 
+struct CountTask
+{
+    CountTask(std::atomic<int> & count) : count(count) {}
+
+    void run(boost::any const &)
+    {
+        ++count;
+    }
+
+    std::atomic<int> & count;
+};
+
+
+/// Short-lived pools on a shared executor, destroyed right after join,
+/// as done by TransfersService::dispatchBatch
+BOOST_AUTO_TEST_CASE (ThreadPoolSharedJoinDestroy)
+{
+    std::shared_ptr<fts3::common::Executor> executor = std::make_shared<fts3::common::Executor>(4);
+    std::atomic<int> count(0);
+
+    for (int cycle = 0; cycle < 1000; ++cycle) {
+        ThreadPool<CountTask> tp(executor);
+        for (int i = 0; i < 8; ++i) {
+            tp.start(new CountTask(count));
+        }
+        tp.join();
+        BOOST_REQUIRE_EQUAL((cycle + 1) * 8, count);
+    }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <boost/ptr_container/ptr_deque.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+#include "common/ThreadPool.h"
+
+using fts3::common::Executor;
+using fts3::common::ThreadPool;
+
+
+BOOST_AUTO_TEST_SUITE(common)
+BOOST_AUTO_TEST_SUITE(ThreadPoolBenchmark)
+
+
+/// The thread pool as it was before being backed by Executor:
+/// a single queue and lock, and every start wakes up all the workers
+template <typename TASK>
+class LegacyThreadPool
+{
+    struct Worker
+    {
+        Worker(LegacyThreadPool &pool) : pool(pool) {}
+
+        void run()
+        {
+            while (!pool.interruptFlag) {
+                std::unique_ptr<TASK> task(pool.next());
+                if (!task.get()) break;
+                task->run(context);
+            }
+        }
+
+        boost::any context;
+        LegacyThreadPool &pool;
+    };
+
+public:
+    LegacyThreadPool(int size) : interruptFlag(false), joinFlag(false)
+    {
+        for (int i = 0; i < size; ++i) {
+            Worker *worker = new Worker(*this);
+            workers.push_back(worker);
+            group.create_thread(boost::bind(&Worker::run, worker));
+        }
+    }
+
+    void start(TASK *t)
+    {
+        {
+            boost::mutex::scoped_lock lock(mx);
+            tasks.push_back(t);
+        }
+        cvar.notify_all();
+    }
+
+    void join()
+    {
+        {
+            boost::mutex::scoped_lock lock(mx);
+            joinFlag = true;
+        }
+        cvar.notify_all();
+        group.join_all();
+    }
+
+private:
+    TASK* next()
+    {
+        boost::mutex::scoped_lock lock(mx);
+        while (tasks.empty() && !joinFlag) {
+            cvar.wait(lock);
+        }
+        typename boost::ptr_deque<TASK>::iterator it = tasks.begin();
+        if (it == tasks.end()) {
+            return 0;
+        }
+        return tasks.release(it).release();
+    }
+
+    boost::thread_group group;
+    boost::mutex mx;
+    boost::condition_variable cvar;
+    boost::ptr_deque<TASK> tasks;
+    boost::ptr_vector<Worker> workers;
+    bool interruptFlag;
+    bool joinFlag;
+};
+
+
+/// Short task, similar in size to preparing the arguments of a url-copy process
+struct WorkTask
+{
+    WorkTask(std::atomic<uint64_t> &sink) : sink(sink) {}
+
+    void run(boost::any &)
+    {
+        uint64_t acc = 0;
+        for (int i = 0; i < 2000; ++i) {
+            acc += i * i;
+        }
+        sink += acc;
+    }
+
+    std::atomic<uint64_t> &sink;
+};
+
+
+/// Number of scheduling cycles, can be changed with FTS3_THREADPOOL_BENCHMARK_CYCLES
+static int benchmarkCycles()
+{
+    const char *env = getenv("FTS3_THREADPOOL_BENCHMARK_CYCLES");
+    return env ? atoi(env) : 500;
+}
+
+
+/// Mimics TransfersService::dispatchBatch: every cycle starts a batch of tasks and waits for them
+BOOST_AUTO_TEST_CASE (schedulingCycles)
+{
+    const int poolSize = 20;
+    const int cycles = benchmarkCycles();
+    const int tasksPerCycle = 200;
+    std::atomic<uint64_t> sink(0);
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int cycle = 0; cycle < cycles; ++cycle) {
+        LegacyThreadPool<WorkTask> pool(poolSize);
+        for (int i = 0; i < tasksPerCycle; ++i) {
+            pool.start(new WorkTask(sink));
+        }
+        pool.join();
+    }
+    double legacy = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::shared_ptr<Executor> executor = std::make_shared<Executor>(poolSize);
+    begin = std::chrono::steady_clock::now();
+    for (int cycle = 0; cycle < cycles; ++cycle) {
+        ThreadPool<WorkTask> pool(executor);
+        for (int i = 0; i < tasksPerCycle; ++i) {
+            pool.start(new WorkTask(sink));
+        }
+        pool.join();
+    }
+    double shared = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    Executor::Metrics metrics = executor->getMetrics();
+    BOOST_CHECK_EQUAL(cycles * tasksPerCycle, metrics.executed);
+
+    const double total = cycles * tasksPerCycle;
+    BOOST_TEST_MESSAGE("[thread pool] " << cycles << " cycles of " << tasksPerCycle << " tasks, "
+        << poolSize << " threads: legacy " << total / legacy << " tasks/s, executor "
+        << total / shared << " tasks/s (steals " << metrics.steals
+        << ", avg latency " << metrics.avgLatencyMs << " ms, max " << metrics.maxLatencyMs << " ms)");
+}
+
+
+/// Several producers feeding the same pool, as the QoS fetchers and waiting rooms do
+BOOST_AUTO_TEST_CASE (concurrentProducers)
+{
+    const int poolSize = 10;
+    const int producers = 6;
+    const int tasksPerProducer = benchmarkCycles() * 40;
+    std::atomic<uint64_t> sink(0);
+
+    auto produce = [&](std::function<void()> startOne) {
+        boost::thread_group group;
+        for (int p = 0; p < producers; ++p) {
+            group.create_thread([&]() {
+                for (int i = 0; i < tasksPerProducer; ++i) {
+                    startOne();
+                }
+            });
+        }
+        group.join_all();
+    };
+
+    auto begin = std::chrono::steady_clock::now();
+    {
+        LegacyThreadPool<WorkTask> pool(poolSize);
+        produce([&]() { pool.start(new WorkTask(sink)); });
+        pool.join();
+    }
+    double legacy = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    begin = std::chrono::steady_clock::now();
+    {
+        ThreadPool<WorkTask> pool(poolSize);
+        produce([&]() { pool.start(new WorkTask(sink)); });
+        pool.join();
+    }
+    double current = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    // Every task run once, by both pools
+    const uint64_t perTask = 1999ull * 2000 * 3999 / 6;
+    BOOST_CHECK_EQUAL(2 * perTask * producers * tasksPerProducer, sink);
+
+    const double total = producers * tasksPerProducer;
+    BOOST_TEST_MESSAGE("[thread pool] " << producers << " producers, " << poolSize << " threads: legacy "
+        << total / legacy << " tasks/s, executor " << total / current << " tasks/s");
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include "common/Exceptions.h"
+#include "db/memory/InMemoryAPI.h"
+
+BOOST_AUTO_TEST_SUITE(db)
+BOOST_AUTO_TEST_SUITE(InMemoryAPITest)
+
+
+BOOST_AUTO_TEST_CASE (InMemorySeed)
+{
+    InMemoryAPI::Seed seed = InMemoryAPI::Seed::parse("jobs=12; files=3;sources=2;destinations=3;vos=2;shares=1");
+    BOOST_CHECK_EQUAL(12, seed.jobs);
+    BOOST_CHECK_EQUAL(3, seed.filesPerJob);
+    BOOST_CHECK_EQUAL(2, seed.sources);
+    BOOST_CHECK_EQUAL(3, seed.destinations);
+    BOOST_CHECK_EQUAL(2, seed.vos);
+    BOOST_CHECK(seed.shares);
+    BOOST_CHECK_EQUAL(0, seed.maxActive);
+
+    BOOST_CHECK_THROW(InMemoryAPI::Seed::parse("jobs"), fts3::common::UserError);
+    BOOST_CHECK_THROW(InMemoryAPI::Seed::parse("tables=1"), fts3::common::UserError);
+    BOOST_CHECK_THROW(InMemoryAPI::Seed::parse("jobs=many"), fts3::common::UserError);
+
+    InMemoryAPI db;
+    db.init("", "", "jobs=12; files=3;sources=2;destinations=3;vos=2;shares=1", 1);
+    BOOST_CHECK_EQUAL(36, db.countFiles("SUBMITTED"));
+
+    // Every link gets two jobs, one per VO
+    std::vector<QueueId> queues;
+    db.getQueuesWithPending(queues);
+    BOOST_CHECK_EQUAL(12, queues.size());
+
+    std::vector<ShareConfig> shares = db.getShareConfig("mock://source0", "mock://destination0");
+    BOOST_CHECK_EQUAL(2, shares.size());
+
+    // All the links at once
+    auto allShares = db.getShareConfigs();
+    BOOST_CHECK_EQUAL(6, allShares.size());
+    BOOST_CHECK_EQUAL(2, allShares[std::make_pair("mock://source0", "mock://destination0")].size());
+}
+
+
+BOOST_AUTO_TEST_CASE (InMemoryReadyTransfers)
+{
+    InMemoryAPI db;
+
+    Job low, high;
+    low.voName = high.voName = "dteam";
+    low.priority = 1;
+    high.priority = 5;
+
+    std::list<TransferFile> files(15);
+    for (auto i = files.begin(); i != files.end(); ++i) {
+        i->sourceSe = "mock://a";
+        i->destSe = "mock://b";
+    }
+    std::string lowId = db.addJob(low, files);
+    std::string highId = db.addJob(high, std::list<TransferFile>(files.begin(), std::next(files.begin(), 3)));
+
+    std::vector<QueueId> queues;
+    db.getQueuesWithPending(queues);
+    BOOST_REQUIRE_EQUAL(1, queues.size());
+    BOOST_CHECK_EQUAL("dteam", queues[0].voName);
+
+    // Only the highest priority is picked
+    std::map<std::string, std::list<TransferFile>> ready;
+    db.getReadyTransfers(queues, ready);
+    BOOST_REQUIRE_EQUAL(3, ready["dteam"].size());
+    BOOST_CHECK_EQUAL(highId, ready["dteam"].front().jobId);
+
+    for (auto i = ready["dteam"].begin(); i != ready["dteam"].end(); ++i) {
+        BOOST_CHECK(db.updateTransferStatus(i->jobId, i->fileId, 0, "FINISHED", "", 0, 0, 0, false).get<0>());
+    }
+    db.updateJobStatus(highId, "FINISHED");
+    BOOST_CHECK_EQUAL("FINISHED", db.getStateOfTransfer(highId, 0).front().job_state);
+
+    // Then 10 by default, in file id order
+    ready.clear();
+    db.getReadyTransfers(queues, ready);
+    BOOST_REQUIRE_EQUAL(10, ready["dteam"].size());
+    BOOST_CHECK_EQUAL(lowId, ready["dteam"].front().jobId);
+    BOOST_CHECK_LT(ready["dteam"].front().fileId, ready["dteam"].back().fileId);
+
+    // Or as many as the optimizer allows
+    db.setOptimizerDecision("mock://a", "mock://b", 4);
+    const TransferFile &first = ready["dteam"].front();
+    BOOST_CHECK(db.updateTransferStatus(first.jobId, first.fileId, 0, "ACTIVE", "", 1234, 0, 0, false).get<0>());
+
+    int currentActive = 0;
+    BOOST_CHECK(db.isTrAllowed("mock://a", "mock://b", currentActive));
+
+    ready.clear();
+    db.getReadyTransfers(queues, ready);
+    BOOST_CHECK_EQUAL(3, ready["dteam"].size());
+}
+
+
+BOOST_AUTO_TEST_CASE (InMemoryTransitions)
+{
+    InMemoryAPI db;
+
+    Job job;
+    job.voName = "dteam";
+    std::list<TransferFile> files(1);
+    files.front().sourceSe = "mock://a";
+    files.front().destSe = "mock://b";
+    std::string jobId = db.addJob(job, files);
+
+    uint64_t fileId = db.getStateOfTransfer(jobId, 0).front().file_id;
+
+    // Found by pid when the message does not carry the ids
+    BOOST_CHECK(db.updateTransferStatus(jobId, fileId, 0, "ACTIVE", "", 42, 0, 0, false).get<0>());
+    BOOST_CHECK(!db.updateTransferStatus(jobId, fileId, 0, "READY", "", 42, 0, 0, false).get<0>());
+    BOOST_CHECK(db.updateTransferStatus("", 0, 0, "FAILED", "expected", 42, 0, 0, false).get<0>());
+    BOOST_CHECK_EQUAL(1, db.countFiles("FAILED"));
+
+    // Terminal states are final
+    boost::tuple<bool, std::string> result = db.updateTransferStatus(jobId, fileId, 0, "FINISHED", "", 0, 0, 0, false);
+    BOOST_CHECK(!result.get<0>());
+    BOOST_CHECK_EQUAL("FAILED", result.get<1>());
+
+    // Unless it is retried
+    db.setRetryTransfer(jobId, fileId, 1, "retry", "", 0);
+    BOOST_CHECK_EQUAL(1, db.countFiles("SUBMITTED"));
+    BOOST_CHECK_EQUAL(1, db.getRetryTimes(jobId, fileId));
+
+    std::vector<QueueId> queues;
+    db.getQueuesWithPending(queues);
+    BOOST_CHECK_EQUAL(1, queues.size());
+}
+
+
+BOOST_AUTO_TEST_CASE (InMemoryTerminateTransfers)
+{
+    InMemoryAPI db;
+
+    Job job;
+    job.voName = "dteam";
+    std::list<TransferFile> files(2);
+    for (auto i = files.begin(); i != files.end(); ++i) {
+        i->sourceSe = "mock://a";
+        i->destSe = "mock://b";
+    }
+    std::string jobId = db.addJob(job, files);
+
+    std::vector<TransferState> before = db.getStateOfTransfer(jobId, 0);
+    BOOST_REQUIRE_EQUAL(2, before.size());
+    uint64_t first = before[0].file_id, second = before[1].file_id;
+
+    BOOST_CHECK(db.updateTransferStatus(jobId, first, 0, "ACTIVE", "", 42, 0, 0, false).get<0>());
+    BOOST_CHECK(db.updateTransferStatus(jobId, second, 0, "FINISHED", "", 43, 0, 0, false).get<0>());
+
+    std::vector<TerminalTransition> transitions;
+    transitions.emplace_back(jobId, first, "FAILED", "stalled", 42);
+    transitions.emplace_back(jobId, second, "FAILED", "stalled", 43);
+
+    // Only what was changed is returned, with the job state as left by the batch
+    std::vector<TransferState> states;
+    std::vector<boost::tuple<bool, std::string> > results = db.terminateTransfers(transitions, states);
+    BOOST_REQUIRE_EQUAL(2, results.size());
+    BOOST_CHECK(results[0].get<0>());
+    BOOST_CHECK(!results[1].get<0>());
+    BOOST_CHECK_EQUAL("FINISHED", results[1].get<1>());
+
+    BOOST_REQUIRE_EQUAL(1, states.size());
+    BOOST_CHECK_EQUAL(first, states[0].file_id);
+    BOOST_CHECK_EQUAL("FAILED", states[0].file_state);
+    BOOST_CHECK_EQUAL("stalled", states[0].reason);
+    BOOST_CHECK_EQUAL("FINISHEDDIRTY", states[0].job_state);
+
+    transitions.clear();
+    transitions.emplace_back(jobId, first, "ACTIVE", "", 0);
+    BOOST_CHECK_THROW(db.terminateTransfers(transitions, states), fts3::common::UserError);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -118,6 +118,51 @@ BOOST_FIXTURE_TEST_CASE (simpleStatus, MsgBusFixture)
 }
 
 
+BOOST_FIXTURE_TEST_CASE (unreadableStatusKept, MsgBusFixture)
+{
+    Producer producer(TEST_PATH, MsgBusBackend::DIRQ);
+    Consumer consumer(TEST_PATH);
+
+    Message original;
+    original.set_job_id("1906cc40-b915-11e5-9a03-02163e006dd0");
+    original.set_transfer_status("ACTIVE");
+    original.set_source_se("mock://source/file");
+    original.set_dest_se("mock://source/file2");
+    original.set_file_id(42);
+    original.set_process_id(1234);
+
+    BOOST_CHECK_EQUAL(0, producer.runProducerStatus(original));
+
+    boost::filesystem::path entry;
+    for (boost::filesystem::recursive_directory_iterator i(TEST_PATH + "/status"), end; i != end; ++i) {
+        if (boost::filesystem::is_regular_file(i->path())) {
+            entry = i->path();
+        }
+    }
+    BOOST_REQUIRE(!entry.empty());
+
+    // Replace the entry with a dangling link, so it can be locked but not read
+    const std::string content = TEST_PATH + "/content";
+    boost::filesystem::rename(entry, content + ".hidden");
+    boost::filesystem::create_symlink(content, entry);
+
+    std::vector<Message> statuses;
+    BOOST_CHECK_EQUAL(0, consumer.runConsumerStatus(statuses));
+    BOOST_CHECK_EQUAL(0, statuses.size());
+    BOOST_CHECK(boost::filesystem::is_symlink(entry));
+
+    // Once readable, the next pass gets it
+    boost::filesystem::rename(content + ".hidden", content);
+    BOOST_CHECK_EQUAL(0, consumer.runConsumerStatus(statuses));
+    BOOST_REQUIRE_EQUAL(1, statuses.size());
+    BOOST_CHECK_EQUAL(statuses[0], original);
+
+    statuses.clear();
+    BOOST_CHECK_EQUAL(0, consumer.runConsumerStatus(statuses));
+    BOOST_CHECK_EQUAL(0, statuses.size());
+}
+
+
 BOOST_FIXTURE_TEST_CASE (simpleMonitoring, MsgBusFixture)
 {
     Producer producer(TEST_PATH);
@@ -218,6 +263,35 @@ BOOST_FIXTURE_TEST_CASE (simpleDeletion, MsgBusFixture)
 }
 
 
+BOOST_FIXTURE_TEST_CASE (shortLivedConsumerCommits, MsgBusFixture)
+{
+    Producer producer(TEST_PATH, MsgBusBackend::SEGMENT);
+
+    MessageBringonline original;
+    original.set_job_id("1906cc40-b915-11e5-9a03-02163e006dd0");
+    original.set_file_id(44);
+    original.set_transfer_status("FAILED");
+    original.set_transfer_message("Could not open because of reasons");
+
+    BOOST_CHECK_EQUAL(0, producer.runProducerDeletions(original));
+
+    // As the deletion path does: a new consumer each run
+    std::vector<MessageBringonline> statuses;
+    {
+        Consumer consumer(TEST_PATH);
+        BOOST_CHECK_EQUAL(0, consumer.runConsumerDeletions(statuses));
+        BOOST_REQUIRE_EQUAL(1, statuses.size());
+        BOOST_CHECK_EQUAL(statuses[0], original);
+        BOOST_CHECK_EQUAL(0, consumer.commit());
+    }
+
+    // The next one must not get it again
+    statuses.clear();
+    Consumer consumer(TEST_PATH);
+    BOOST_CHECK_EQUAL(0, consumer.runConsumerDeletions(statuses));
+    BOOST_CHECK_EQUAL(0, statuses.size());
+}
+
 BOOST_FIXTURE_TEST_CASE (simpleStaging, MsgBusFixture)
 {
     Producer producer(TEST_PATH);
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+
+#include "msg-bus/consumer.h"
+#include "msg-bus/DirQ.h"
+#include "msg-bus/producer.h"
+
+namespace fs = boost::filesystem;
+
+
+BOOST_AUTO_TEST_SUITE(MsgBusBenchmark)
+
+
+/// Number of messages, can be raised with FTS3_MSGBUS_BENCHMARK_MESSAGES
+static unsigned benchmarkSize()
+{
+    const char *env = getenv("FTS3_MSGBUS_BENCHMARK_MESSAGES");
+    return env ? static_cast<unsigned>(atoi(env)) : 5000;
+}
+
+
+static fts3::events::Message sampleStatus(unsigned i)
+{
+    fts3::events::Message msg;
+    msg.set_job_id("1906cc40-b915-11e5-9a03-02163e006dd0");
+    msg.set_file_id(i);
+    msg.set_transfer_status("FINISHED");
+    msg.set_transfer_message("");
+    msg.set_source_se("gsiftp://source.cern.ch");
+    msg.set_dest_se("gsiftp://destination.cern.ch");
+    msg.set_process_id(1234);
+    msg.set_time_in_secs(55);
+    msg.set_filesize(1048576);
+    msg.set_throughput(12.5);
+    msg.set_timestamp(1500000000000);
+    return msg;
+}
+
+
+/// Produce and consume the same number of status messages, and report the throughput of each side
+static void runBenchmark(const std::string &name, MsgBusBackend backend)
+{
+    const std::string path = "/tmp/MsgBusBenchmark";
+    fs::remove_all(path);
+    fs::create_directories(path);
+
+    const unsigned nMessages = benchmarkSize();
+    Producer producer(path, backend);
+    Consumer consumer(path, nMessages);
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < nMessages; ++i) {
+        BOOST_REQUIRE_EQUAL(0, producer.runProducerStatus(sampleStatus(i)));
+    }
+    auto produced = std::chrono::steady_clock::now();
+
+    std::vector<fts3::events::Message> messages;
+    messages.reserve(nMessages);
+    BOOST_REQUIRE_EQUAL(0, consumer.runConsumerStatus(messages));
+    auto consumed = std::chrono::steady_clock::now();
+
+    BOOST_CHECK_EQUAL(nMessages, messages.size());
+
+    double produceSec = std::chrono::duration<double>(produced - start).count();
+    double consumeSec = std::chrono::duration<double>(consumed - produced).count();
+
+    BOOST_TEST_MESSAGE("[" << name << "] " << nMessages << " messages: "
+        << "produce " << nMessages / produceSec << " msg/s, "
+        << "consume " << nMessages / consumeSec << " msg/s");
+
+    fs::remove_all(path);
+}
+
+
+/// How the dirq entries were consumed before reading them into a single buffer:
+/// one ifstream per entry, parsed into a temporary, copied, then removed
+static int legacyDirqConsumer(DirQ &dirq, unsigned limit, std::vector<fts3::events::Message> &messages)
+{
+    fts3::events::Message event;
+    dirq_clear_error(dirq);
+
+    unsigned i = 0;
+    for (auto iter = dirq_first(dirq); iter != NULL && i < limit; iter = dirq_next(dirq), ++i) {
+        if (dirq_lock(dirq, iter, 0) == 0) {
+            std::ifstream fstream(dirq_get_path(dirq, iter));
+            event.ParseFromIstream(&fstream);
+            messages.emplace_back(event);
+            if (dirq_remove(dirq, iter) < 0) {
+                return -1;
+            }
+        }
+    }
+    return dirq_get_errstr(dirq) ? -1 : 0;
+}
+
+
+/// Fill the status dirq, and consume it with the given function
+template <typename CONSUME>
+static double consumeRate(const std::string &path, unsigned nMessages, CONSUME consume)
+{
+    fs::remove_all(path);
+    fs::create_directories(path);
+
+    Producer producer(path, MsgBusBackend::DIRQ);
+    for (unsigned i = 0; i < nMessages; ++i) {
+        BOOST_REQUIRE_EQUAL(0, producer.runProducerStatus(sampleStatus(i)));
+    }
+
+    std::vector<fts3::events::Message> messages;
+    messages.reserve(nMessages);
+
+    auto start = std::chrono::steady_clock::now();
+    BOOST_REQUIRE_EQUAL(0, consume(messages));
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    BOOST_REQUIRE_EQUAL(nMessages, messages.size());
+    std::set<uint64_t> fileIds;
+    for (auto msg = messages.begin(); msg != messages.end(); ++msg) {
+        BOOST_CHECK_EQUAL(msg->transfer_status(), "FINISHED");
+        fileIds.insert(msg->file_id());
+    }
+    BOOST_CHECK_EQUAL(nMessages, fileIds.size());
+
+    fs::remove_all(path);
+    return nMessages / elapsed;
+}
+
+
+/// Consume the dirq the legacy way, then through a buffer, then parsing in several threads
+BOOST_AUTO_TEST_CASE (dirqConsumerPaths)
+{
+    const std::string path = "/tmp/MsgBusBenchmark";
+    const unsigned nMessages = benchmarkSize();
+
+    double legacy = consumeRate(path, nMessages, [&path, nMessages](std::vector<fts3::events::Message> &messages) {
+        DirQ dirq(path + "/status");
+        return legacyDirqConsumer(dirq, nMessages, messages);
+    });
+
+    double buffered = consumeRate(path, nMessages, [&path, nMessages](std::vector<fts3::events::Message> &messages) {
+        Consumer consumer(path, nMessages);
+        return consumer.runConsumerStatus(messages);
+    });
+
+    double parallel = consumeRate(path, nMessages, [&path, nMessages](std::vector<fts3::events::Message> &messages) {
+        Consumer consumer(path, nMessages);
+        consumer.setParseThreads(4);
+        return consumer.runConsumerStatus(messages);
+    });
+
+    BOOST_TEST_MESSAGE("[dirq consumer] " << nMessages << " messages: "
+        << "legacy " << legacy << " msg/s, "
+        << "buffered " << buffered << " msg/s, "
+        << "4 parsers " << parallel << " msg/s");
+}
+
+
+BOOST_AUTO_TEST_CASE (dirqThroughput)
+{
+    runBenchmark("dirq", MsgBusBackend::DIRQ);
+}
+
+
+BOOST_AUTO_TEST_CASE (segmentThroughput)
+{
+    runBenchmark("segment", MsgBusBackend::SEGMENT);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
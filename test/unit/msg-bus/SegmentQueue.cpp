@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+#include <boost/filesystem.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "msg-bus/SegmentQueue.h"
+#include "msg-bus/consumer.h"
+#include "msg-bus/producer.h"
+
+namespace fs = boost::filesystem;
+
+
+BOOST_AUTO_TEST_SUITE(SegmentQueueTest)
+
+
+class SegmentQueueFixture {
+protected:
+    static const std::string TEST_PATH;
+
+    std::vector<std::string> segments() {
+        std::vector<std::string> files;
+        for (fs::directory_iterator i(TEST_PATH); i != fs::directory_iterator(); ++i) {
+            if (i->path().extension() == ".seg") {
+                files.push_back(i->path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    void appendRaw(const std::string &file, const char *data, size_t size) {
+        int fd = open(file.c_str(), O_WRONLY | O_APPEND);
+        BOOST_REQUIRE(fd >= 0);
+        BOOST_REQUIRE_EQUAL(size, write(fd, data, size));
+        close(fd);
+    }
+
+public:
+    SegmentQueueFixture() {
+        fs::remove_all(TEST_PATH);
+    }
+
+    ~SegmentQueueFixture() {
+        fs::remove_all(TEST_PATH);
+    }
+};
+
+const std::string SegmentQueueFixture::TEST_PATH("/tmp/SegmentQueueTest");
+
+
+BOOST_FIXTURE_TEST_CASE (appendAndConsume, SegmentQueueFixture)
+{
+    SegmentQueue queue(TEST_PATH);
+
+    queue.append("first");
+    queue.append(std::string("with\0zero", 9));
+    queue.append("");
+
+    std::vector<std::string> payloads;
+    queue.consume(10, payloads);
+    BOOST_REQUIRE_EQUAL(3, payloads.size());
+    BOOST_CHECK_EQUAL("first", payloads[0]);
+    BOOST_CHECK_EQUAL(std::string("with\0zero", 9), payloads[1]);
+    BOOST_CHECK_EQUAL("", payloads[2]);
+
+    payloads.clear();
+    queue.consume(10, payloads);
+    BOOST_CHECK_EQUAL(0, payloads.size());
+}
+
+
+BOOST_FIXTURE_TEST_CASE (offsetPerConsumer, SegmentQueueFixture)
+{
+    {
+        SegmentQueue producer(TEST_PATH);
+        for (int i = 0; i < 10; ++i) {
+            producer.append(std::to_string(i));
+        }
+    }
+
+    // The committed offset survives the consumer
+    {
+        SegmentQueue consumer(TEST_PATH, "a");
+        std::vector<std::string> payloads;
+        consumer.consume(4, payloads);
+        BOOST_CHECK_EQUAL(4, payloads.size());
+        consumer.commit();
+    }
+    // What was read but not committed is delivered again
+    {
+        SegmentQueue consumer(TEST_PATH, "a");
+        std::vector<std::string> payloads;
+        consumer.consume(3, payloads);
+        BOOST_REQUIRE_EQUAL(3, payloads.size());
+        BOOST_CHECK_EQUAL("4", payloads.front());
+
+        // but not to the same consumer
+        payloads.clear();
+        consumer.consume(1, payloads);
+        BOOST_REQUIRE_EQUAL(1, payloads.size());
+        BOOST_CHECK_EQUAL("7", payloads.front());
+    }
+    {
+        SegmentQueue consumer(TEST_PATH, "a");
+        std::vector<std::string> payloads;
+        consumer.consume(100, payloads);
+        BOOST_REQUIRE_EQUAL(6, payloads.size());
+        BOOST_CHECK_EQUAL("4", payloads.front());
+        BOOST_CHECK_EQUAL("9", payloads.back());
+    }
+
+    // Another consumer has its own
+    SegmentQueue other(TEST_PATH, "b");
+    std::vector<std::string> payloads;
+    other.consume(100, payloads);
+    BOOST_CHECK_EQUAL(10, payloads.size());
+}
+
+
+BOOST_FIXTURE_TEST_CASE (rollAndPurge, SegmentQueueFixture)
+{
+    SegmentQueue queue(TEST_PATH, "default", 64);
+    for (int i = 0; i < 20; ++i) {
+        queue.append("message number " + std::to_string(i));
+    }
+    BOOST_CHECK_GT(segments().size(), 5);
+
+    std::vector<std::string> payloads;
+    queue.consume(15, payloads);
+    BOOST_REQUIRE_EQUAL(15, payloads.size());
+    BOOST_CHECK_EQUAL("message number 14", payloads.back());
+
+    // Nothing goes away until committed
+    const size_t nSegments = segments().size();
+    queue.purge();
+    BOOST_CHECK_EQUAL(nSegments, segments().size());
+
+    // Then only the segments already consumed
+    queue.commit();
+    queue.purge();
+    BOOST_CHECK_LT(segments().size(), nSegments);
+    payloads.clear();
+    queue.consume(100, payloads);
+    BOOST_REQUIRE_EQUAL(5, payloads.size());
+    BOOST_CHECK_EQUAL("message number 15", payloads.front());
+
+    queue.commit();
+    queue.purge();
+    BOOST_CHECK_EQUAL(1, segments().size());
+}
+
+
+BOOST_FIXTURE_TEST_CASE (recoverTornFrame, SegmentQueueFixture)
+{
+    SegmentQueue queue(TEST_PATH);
+    queue.append("before");
+
+    // Leftover of a producer killed in the middle of a write: magic, length, but not all the payload
+    const char torn[] = {0x33, 0x53, 0x54, 0x46, 100, 0, 0, 0, 1, 2, 3, 4, 'x', 'y'};
+    appendRaw(segments().back(), torn, sizeof(torn));
+
+    std::vector<std::string> payloads;
+    queue.consume(10, payloads);
+    BOOST_REQUIRE_EQUAL(1, payloads.size());
+    BOOST_CHECK_EQUAL("before", payloads[0]);
+
+    // Messages written after the torn frame are not lost
+    for (int i = 0; i < 10; ++i) {
+        queue.append("after " + std::to_string(i));
+    }
+    payloads.clear();
+    queue.consume(100, payloads);
+    BOOST_REQUIRE_EQUAL(10, payloads.size());
+    BOOST_CHECK_EQUAL("after 0", payloads.front());
+    BOOST_CHECK_EQUAL("after 9", payloads.back());
+}
+
+
+BOOST_FIXTURE_TEST_CASE (tornFrameBeyondEnd, SegmentQueueFixture)
+{
+    SegmentQueue queue(TEST_PATH);
+    queue.append("before");
+
+    // The length of the torn frame runs past everything written after it
+    const char torn[] = {0x33, 0x53, 0x54, 0x46, 0, 0x10, 0, 0, 1, 2, 3, 4, 'x', 'y'};
+    appendRaw(segments().back(), torn, sizeof(torn));
+    for (int i = 0; i < 3; ++i) {
+        queue.append("after " + std::to_string(i));
+    }
+
+    std::vector<std::string> payloads;
+    queue.consume(10, payloads);
+    BOOST_REQUIRE_EQUAL(4, payloads.size());
+    BOOST_CHECK_EQUAL("before", payloads[0]);
+    BOOST_CHECK_EQUAL("after 0", payloads[1]);
+    BOOST_CHECK_EQUAL("after 2", payloads[3]);
+
+    // The torn frame is not read again
+    queue.append("last");
+    payloads.clear();
+    queue.consume(10, payloads);
+    BOOST_REQUIRE_EQUAL(1, payloads.size());
+    BOOST_CHECK_EQUAL("last", payloads[0]);
+}
+
+BOOST_FIXTURE_TEST_CASE (bigMessage, SegmentQueueFixture)
+{
+    SegmentQueue queue(TEST_PATH);
+
+    std::string big(3 * 1024 * 1024, 'x');
+    queue.append(big);
+    queue.append("small");
+
+    std::vector<std::string> payloads;
+    queue.consume(10, payloads);
+    BOOST_REQUIRE_EQUAL(2, payloads.size());
+    BOOST_CHECK(payloads[0] == big);
+    BOOST_CHECK_EQUAL("small", payloads[1]);
+}
+
+
+BOOST_FIXTURE_TEST_CASE (backendSelection, SegmentQueueFixture)
+{
+    fs::create_directories(TEST_PATH);
+    BOOST_CHECK(MsgBusBackend::DIRQ == getMsgBusBackend(TEST_PATH));
+
+    setMsgBusBackend(TEST_PATH, MsgBusBackend::SEGMENT);
+    BOOST_CHECK(MsgBusBackend::SEGMENT == getMsgBusBackend(TEST_PATH));
+
+    Producer producer(TEST_PATH);
+    Consumer consumer(TEST_PATH);
+
+    fts3::events::Message original;
+    original.set_job_id("1906cc40-b915-11e5-9a03-02163e006dd0");
+    original.set_file_id(42);
+    original.set_transfer_status("FINISHED");
+    original.set_source_se("mock://source");
+    original.set_dest_se("mock://destination");
+    original.set_process_id(1234);
+    BOOST_CHECK_EQUAL(0, producer.runProducerStatus(original));
+
+    BOOST_CHECK(fs::exists(TEST_PATH + "/segments/status/00000000000000000000.seg"));
+
+    std::vector<fts3::events::Message> statuses;
+    BOOST_CHECK_EQUAL(0, consumer.runConsumerStatus(statuses));
+    BOOST_REQUIRE_EQUAL(1, statuses.size());
+    BOOST_CHECK_EQUAL(original.SerializeAsString(), statuses[0].SerializeAsString());
+
+    // Not committed until the consumer comes back for more
+    {
+        Consumer restarted(TEST_PATH);
+        statuses.clear();
+        BOOST_CHECK_EQUAL(0, restarted.runConsumerStatus(statuses));
+        BOOST_CHECK_EQUAL(1, statuses.size());
+    }
+    statuses.clear();
+    BOOST_CHECK_EQUAL(0, consumer.runConsumerStatus(statuses));
+    BOOST_CHECK_EQUAL(0, statuses.size());
+    {
+        Consumer restarted(TEST_PATH);
+        statuses.clear();
+        BOOST_CHECK_EQUAL(0, restarted.runConsumerStatus(statuses));
+        BOOST_CHECK_EQUAL(0, statuses.size());
+    }
+
+    setMsgBusBackend(TEST_PATH, MsgBusBackend::DIRQ);
+    BOOST_CHECK(MsgBusBackend::DIRQ == getMsgBusBackend(TEST_PATH));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <boost/any.hpp>
+#include <boost/thread.hpp>
+
+#include "common/Logger.h"
+#include "common/ThreadPool.h"
+
+using namespace fts3::common;
+
+#include "qos-daemon/task/WaitingRoom.h"
+
+
+BOOST_AUTO_TEST_SUITE(qos)
+BOOST_AUTO_TEST_SUITE(WaitingRoomTest)
+
+
+/// Records the order in which the tasks run
+struct OrderedTask
+{
+    OrderedTask(int id, time_t waitUntil, std::vector<int> &order, boost::mutex &m):
+        id(id), waitUntil(waitUntil), order(order), m(m) {}
+
+    virtual ~OrderedTask() {}
+
+    virtual void run(const boost::any &)
+    {
+        boost::mutex::scoped_lock lock(m);
+        order.push_back(id);
+    }
+
+    time_t getWaitUntil() const
+    {
+        return waitUntil;
+    }
+
+    int id;
+    time_t waitUntil;
+    std::vector<int> &order;
+    boost::mutex &m;
+};
+
+
+BOOST_AUTO_TEST_CASE (WaitingRoomDeadlineOrder)
+{
+    std::vector<int> order;
+    boost::mutex m;
+
+    ThreadPool<OrderedTask> pool(1);
+    WaitingRoom<OrderedTask, OrderedTask> room;
+    room.attach(pool);
+
+    // Added out of order, due tasks go first, same deadline keeps insertion order
+    time_t now = time(NULL);
+    room.add(new OrderedTask(3, now + 1, order, m));
+    room.add(new OrderedTask(1, now - 10, order, m));
+    room.add(new OrderedTask(2, now - 10, order, m));
+    room.add(new OrderedTask(4, now + 3600, order, m));
+    BOOST_CHECK_EQUAL(4, room.size());
+
+    boost::thread thread(&WaitingRoom<OrderedTask, OrderedTask>::run, &room);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(2500));
+
+    // A task added with an earlier deadline wakes up the room
+    room.add(new OrderedTask(5, time(NULL) - 1, order, m));
+    boost::this_thread::sleep(boost::posix_time::milliseconds(500));
+
+    thread.interrupt();
+    thread.join();
+    pool.join();
+
+    std::vector<int> expected = {1, 2, 3, 5};
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), order.begin(), order.end());
+
+    WaitingRoom<OrderedTask, OrderedTask>::Metrics metrics = room.getMetrics();
+    BOOST_CHECK_EQUAL(4, metrics.dispatched);
+    BOOST_CHECK_GE(metrics.maxLagMs, 10000);
+    // The one far in the future is dropped on exit
+    BOOST_CHECK_EQUAL(0, metrics.size);
+}
+
+
+
+/// Counts the tasks deleted
+struct CountedTask
+{
+    CountedTask(time_t waitUntil, int &deleted): waitUntil(waitUntil), deleted(deleted) {}
+
+    virtual ~CountedTask()
+    {
+        ++deleted;
+    }
+
+    virtual void run(const boost::any &) {}
+
+    time_t getWaitUntil() const
+    {
+        return waitUntil;
+    }
+
+    time_t waitUntil;
+    int &deleted;
+};
+
+
+BOOST_AUTO_TEST_CASE (WaitingRoomStartThrows)
+{
+    int deleted = 0;
+
+    // An interrupted pool refuses new tasks
+    ThreadPool<CountedTask> pool(1);
+    pool.interrupt();
+
+    WaitingRoom<CountedTask, CountedTask> room;
+    room.attach(pool);
+
+    time_t now = time(NULL);
+    for (int i = 0; i < 3; ++i) {
+        room.add(new CountedTask(now - 1, deleted));
+    }
+
+    boost::thread thread(&WaitingRoom<CountedTask, CountedTask>::run, &room);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(500));
+    thread.interrupt();
+    thread.join();
+
+    // None of the due tasks is leaked when the first one can not be started
+    BOOST_CHECK_EQUAL(0, room.size());
+    BOOST_CHECK_EQUAL(3, deleted);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
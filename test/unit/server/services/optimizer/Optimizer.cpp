@@ -611,6 +611,70 @@ BOOST_FIXTURE_TEST_CASE (optimizerMaxStreams, BaseOptimizerFixture)
     BOOST_CHECK_LE(streamsRegistry[pair], maxNumberOfStreams);
 }
 
+// Records the bulk prefetch requested by run()
+class OptimizerPrefetchFixture: public BaseOptimizerFixture {
+protected:
+    std::list<Pair> prefetchedPairs;
+    std::vector<boost::posix_time::time_duration> prefetchedTimeFrames;
+    int prefetchCount, dropCount;
+    bool failPrefetch;
+
+public:
+    OptimizerPrefetchFixture(): prefetchCount(0), dropCount(0), failPrefetch(false) {
+    }
+
+    void prefetch(const std::list<Pair> &pairs, const std::vector<boost::posix_time::time_duration> &timeFrames) {
+        ++prefetchCount;
+        if (failPrefetch) {
+            throw std::runtime_error("Mock prefetch failure");
+        }
+        prefetchedPairs = pairs;
+        prefetchedTimeFrames = timeFrames;
+    }
+
+    void dropPrefetched(void) {
+        ++dropCount;
+    }
+};
+
+// A run prefetches all the active pairs at once, and releases them when done
+BOOST_FIXTURE_TEST_CASE (optimizerPrefetch, OptimizerPrefetchFixture)
+{
+    const Pair pair1("mock://dpm.cern.ch", "mock://dcache.desy.de");
+    const Pair pair2("mock://eos.cern.ch", "mock://dcache.desy.de");
+
+    populateTransfers(pair1, "ACTIVE", 10);
+    populateTransfers(pair2, "SUBMITTED", 10);
+
+    run();
+
+    BOOST_CHECK_EQUAL(1, prefetchCount);
+    BOOST_CHECK_GE(dropCount, 1);
+    BOOST_REQUIRE_EQUAL(2, prefetchedPairs.size());
+    BOOST_CHECK_EQUAL(pair1.source, prefetchedPairs.front().source);
+    BOOST_CHECK_EQUAL(pair2.source, prefetchedPairs.back().source);
+
+    BOOST_REQUIRE_EQUAL(3, prefetchedTimeFrames.size());
+    BOOST_CHECK_EQUAL(SHORT_TIME_FRAME, prefetchedTimeFrames[0].total_seconds());
+    BOOST_CHECK_EQUAL(LONG_TIME_FRAME, prefetchedTimeFrames[2].total_seconds());
+
+    BOOST_CHECK(getLastEntry(pair1) != NULL);
+    BOOST_CHECK(getLastEntry(pair2) != NULL);
+}
+
+// If the prefetch fails, the pairs are still optimized
+BOOST_FIXTURE_TEST_CASE (optimizerPrefetchFailure, OptimizerPrefetchFixture)
+{
+    const Pair pair("mock://dpm.cern.ch", "mock://dcache.desy.de");
+    populateTransfers(pair, "ACTIVE", 10);
+
+    failPrefetch = true;
+    run();
+
+    BOOST_CHECK_EQUAL(1, prefetchCount);
+    BOOST_CHECK(getLastEntry(pair) != NULL);
+}
+
 // NOTE: I am not sure it is worth to add more tests. At the end, we will basically be
 //       writing tests that set the parameters to fit the implementation at the time.
 //       They do not prove that the optimizer optimizes.
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include "db/memory/InMemoryAPI.h"
+#include "server/services/transfers/BundledTransfers.h"
+#include "server/services/transfers/FileTransferExecutor.h"
+#include "server/services/transfers/MessageProcessingService.h"
+#include "server/services/transfers/StatusBatch.h"
+
+using fts3::server::BundledTransfers;
+using fts3::server::FileTransferExecutor;
+using fts3::server::MessageProcessingService;
+using fts3::server::StatusBatch;
+
+
+static TransferFile makeSmallFile(uint64_t fileId, const std::string &jobId)
+{
+    TransferFile tf;
+    tf.fileId = fileId;
+    tf.jobId = jobId;
+    tf.jobType = Job::kTypeRegular;
+    tf.voName = "dteam";
+    tf.sourceSe = "mock://a";
+    tf.destSe = "mock://b";
+    tf.userFilesize = 1024;
+    return tf;
+}
+
+
+/// Adds a job with nFiles files, and returns them as the scheduler would
+static std::vector<TransferFile> addJob(InMemoryAPI &db, size_t nFiles)
+{
+    Job job;
+    job.voName = "dteam";
+    std::list<TransferFile> files(nFiles);
+    for (auto i = files.begin(); i != files.end(); ++i) {
+        i->sourceSe = "mock://a";
+        i->destSe = "mock://b";
+    }
+    std::string jobId = db.addJob(job, files);
+
+    std::vector<TransferFile> added;
+    std::vector<TransferState> states = db.getStateOfTransfer(jobId, 0);
+    for (auto i = states.begin(); i != states.end(); ++i) {
+        added.push_back(makeSmallFile(i->file_id, jobId));
+    }
+    return added;
+}
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(FileTransferExecutorTest)
+
+
+BOOST_AUTO_TEST_CASE (bundleKey)
+{
+    ConfigSnapshot config;
+    config.fileRetries[1] = 0;
+    config.fileRetries[2] = 0;
+    config.fileRetries[3] = 0;
+    config.fileRetries[4] = 1;
+
+    TransferFile first = makeSmallFile(1, "job1");
+    TransferFile second = makeSmallFile(2, "job1");
+    TransferFile otherJob = makeSmallFile(3, "job2");
+
+    std::string key = FileTransferExecutor::getBundleKey(first, 4096, config);
+    BOOST_CHECK(!key.empty());
+    BOOST_CHECK_EQUAL(key, FileTransferExecutor::getBundleKey(second, 4096, config));
+    BOOST_CHECK_NE(key, FileTransferExecutor::getBundleKey(otherJob, 4096, config));
+
+    // Disabled
+    BOOST_CHECK(FileTransferExecutor::getBundleKey(first, 0, config).empty());
+    // Too big, or size unknown
+    BOOST_CHECK(FileTransferExecutor::getBundleKey(first, 512, config).empty());
+    second.userFilesize = 0;
+    BOOST_CHECK(FileTransferExecutor::getBundleKey(second, 4096, config).empty());
+    // Retried, or not in the snapshot
+    BOOST_CHECK(FileTransferExecutor::getBundleKey(makeSmallFile(4, "job1"), 4096, config).empty());
+    BOOST_CHECK(FileTransferExecutor::getBundleKey(makeSmallFile(5, "job1"), 4096, config).empty());
+
+    // Jobs that drive url_copy their own way
+    TransferFile multihop = makeSmallFile(1, "job1");
+    multihop.jobType = Job::kTypeMultiHop;
+    BOOST_CHECK(FileTransferExecutor::getBundleKey(multihop, 4096, config).empty());
+    TransferFile archiving = makeSmallFile(1, "job1");
+    archiving.archiveTimeout = 60;
+    BOOST_CHECK(FileTransferExecutor::getBundleKey(archiving, 4096, config).empty());
+    TransferFile token = makeSmallFile(1, "job1");
+    token.fileMetadata = "{\"auth-issuer\": \"https://iam\"}";
+    BOOST_CHECK(FileTransferExecutor::getBundleKey(token, 4096, config).empty());
+}
+
+
+/// Only the files not picked by another node are run by the bundle
+BOOST_AUTO_TEST_CASE (claimBundle)
+{
+    InMemoryAPI db;
+    std::vector<TransferFile> bundle = addJob(db, 3);
+    const uint64_t taken = bundle[1].fileId;
+
+    // Another node got there first
+    BOOST_CHECK(db.updateTransferStatus(bundle[1].jobId, taken, 0, "READY", "", 0, 0, 0, false).get<0>());
+
+    std::vector<TransferFile> claimed = FileTransferExecutor::claimBundle(db, bundle);
+    BOOST_CHECK(bundle.empty());
+    BOOST_REQUIRE_EQUAL(2, claimed.size());
+    BOOST_CHECK_NE(taken, claimed[0].fileId);
+    BOOST_CHECK_NE(taken, claimed[1].fileId);
+
+    for (auto file = claimed.begin(); file != claimed.end(); ++file) {
+        BOOST_CHECK_EQUAL("READY", db.getStateOfTransfer(file->jobId, file->fileId).at(0).file_state);
+    }
+
+    // Nothing left to claim
+    std::vector<TransferFile> again = addJob(db, 0);
+    BOOST_CHECK(FileTransferExecutor::claimBundle(db, again).empty());
+}
+
+
+/// Canceling a file of a bundle requeues the others, instead of canceling them too
+BOOST_AUTO_TEST_CASE (cancelOneOfBundle)
+{
+    InMemoryAPI db;
+    std::vector<TransferFile> bundle = addJob(db, 3);
+    const std::string jobId = bundle[0].jobId;
+    std::vector<uint64_t> fileIds;
+    for (auto file = bundle.begin(); file != bundle.end(); ++file) {
+        BOOST_CHECK(db.updateTransferStatus(jobId, file->fileId, 0, "ACTIVE", "", 42, 0, 0, false).get<0>());
+        fileIds.push_back(file->fileId);
+    }
+    BundledTransfers::instance().add(42, fileIds);
+
+    // The user cancels the first one, and the whole process is killed
+    BOOST_CHECK(db.updateTransferStatus(jobId, bundle[0].fileId, 0, "CANCELED", "", 42, 0, 0, false).get<0>());
+
+    fts3::events::Message msg;
+    msg.set_job_id(jobId);
+    msg.set_process_id(42);
+    msg.set_transfer_status("CANCELED");
+
+    msg.set_file_id(bundle[0].fileId);
+    BOOST_CHECK(StatusBatch::preparationChangesDatabase(msg));
+    BOOST_CHECK(!MessageProcessingService::requeueIfCanceledAlongside(db, msg));
+    for (size_t i = 1; i < bundle.size(); ++i) {
+        msg.set_file_id(bundle[i].fileId);
+        BOOST_CHECK(MessageProcessingService::requeueIfCanceledAlongside(db, msg));
+        BOOST_CHECK_EQUAL("SUBMITTED", db.getStateOfTransfer(jobId, bundle[i].fileId).at(0).file_state);
+        BOOST_CHECK_EQUAL(0, db.getRetryTimes(jobId, bundle[i].fileId));
+    }
+    BOOST_CHECK_EQUAL("CANCELED", db.getStateOfTransfer(jobId, bundle[0].fileId).at(0).file_state);
+    BOOST_CHECK_EQUAL(0, BundledTransfers::instance().size());
+
+    // Other states are left to the usual processing
+    msg.set_transfer_status("FAILED");
+    BOOST_CHECK(!MessageProcessingService::requeueIfCanceledAlongside(db, msg));
+}
+
+
+BOOST_AUTO_TEST_CASE (cancelNotBundled)
+{
+    InMemoryAPI db;
+    std::vector<TransferFile> files = addJob(db, 2);
+    const std::string jobId = files[0].jobId;
+    BOOST_CHECK(db.updateTransferStatus(jobId, files[0].fileId, 0, "ACTIVE", "", 43, 0, 0, false).get<0>());
+    BOOST_CHECK(db.updateTransferStatus(jobId, files[1].fileId, 0, "ACTIVE", "", 44, 0, 0, false).get<0>());
+
+    // A url-copy stopped on its own reports CANCELED while the file is still active
+    fts3::events::Message msg;
+    msg.set_job_id(jobId);
+    msg.set_file_id(files[0].fileId);
+    msg.set_process_id(43);
+    msg.set_transfer_status("CANCELED");
+
+    BOOST_CHECK(!StatusBatch::preparationChangesDatabase(msg));
+    BOOST_CHECK(!MessageProcessingService::requeueIfCanceledAlongside(db, msg));
+    BOOST_CHECK_EQUAL("ACTIVE", db.getStateOfTransfer(jobId, files[0].fileId).at(0).file_state);
+
+    // Nor is a file that was not part of the bundle run by its pid
+    BundledTransfers::instance().add(44, std::vector<uint64_t>(1, files[0].fileId));
+    msg.set_file_id(files[1].fileId);
+    msg.set_process_id(44);
+    BOOST_CHECK(!MessageProcessingService::requeueIfCanceledAlongside(db, msg));
+    BOOST_CHECK_EQUAL("ACTIVE", db.getStateOfTransfer(jobId, files[1].fileId).at(0).file_state);
+
+    BOOST_CHECK(BundledTransfers::instance().release(44, files[0].fileId));
+    BOOST_CHECK_EQUAL(0, BundledTransfers::instance().size());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
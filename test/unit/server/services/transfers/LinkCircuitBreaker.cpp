@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <errno.h>
+
+#include "server/services/transfers/LinkCircuitBreaker.h"
+
+using fts3::server::LinkCircuitBreaker;
+
+
+static const std::string SOURCE("gsiftp://source.cern.ch");
+static const std::string DEST("davs://destination.example.org");
+
+
+/// Window of 10, opens with 8 link errors out of 10, 60 seconds of backoff
+static LinkCircuitBreaker::Settings testSettings()
+{
+    LinkCircuitBreaker::Settings settings;
+    settings.window = 10;
+    settings.minSamples = 10;
+    settings.failureRatio = 0.8;
+    settings.backoff = 60;
+    settings.maxBackoff = 200;
+    settings.probes = 2;
+    return settings;
+}
+
+
+static void failConnection(LinkCircuitBreaker &breaker, int count, time_t now)
+{
+    for (int i = 0; i < count; ++i) {
+        breaker.record(SOURCE, DEST, "FAILED", ECONNREFUSED, "Connection refused", now);
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(LinkCircuitBreakerTest)
+
+
+BOOST_AUTO_TEST_CASE (classify)
+{
+    BOOST_CHECK(LinkCircuitBreaker::isLinkError(ECONNREFUSED, ""));
+    BOOST_CHECK(LinkCircuitBreaker::isLinkError(EIO, "Could not resolve host: destination.example.org"));
+    BOOST_CHECK(LinkCircuitBreaker::isLinkError(ENOSPC, "No space left on device"));
+    BOOST_CHECK(!LinkCircuitBreaker::isLinkError(ENOENT, "No such file or directory"));
+    BOOST_CHECK(!LinkCircuitBreaker::isLinkError(EEXIST, "Destination file exists and overwrite is not enabled"));
+    BOOST_CHECK(!LinkCircuitBreaker::isLinkError(EIO, "checksum do not match"));
+    // The message wins over the code
+    BOOST_CHECK(!LinkCircuitBreaker::isLinkError(ETIMEDOUT, "No such file or directory"));
+}
+
+
+BOOST_AUTO_TEST_CASE (disabled)
+{
+    LinkCircuitBreaker breaker;
+    failConnection(breaker, 100, 1000);
+
+    BOOST_CHECK(!breaker.isOpen(SOURCE, DEST, 1000));
+    BOOST_CHECK(breaker.allow(SOURCE, DEST, 1000));
+    BOOST_CHECK_EQUAL(LinkCircuitBreaker::CLOSED, breaker.getStatus(SOURCE, DEST, 1000).state);
+}
+
+
+/// File errors, and too few samples, do not open the breaker
+BOOST_AUTO_TEST_CASE (fileErrors)
+{
+    LinkCircuitBreaker breaker;
+    breaker.enable(testSettings());
+
+    failConnection(breaker, 7, 1000);
+    BOOST_CHECK(!breaker.isOpen(SOURCE, DEST, 1000));
+
+    for (int i = 0; i < 10; ++i) {
+        breaker.record(SOURCE, DEST, "FAILED", ENOENT, "No such file or directory", 1000);
+    }
+    BOOST_CHECK(!breaker.isOpen(SOURCE, DEST, 1000));
+    BOOST_CHECK_EQUAL(10, breaker.getStatus(SOURCE, DEST, 1000).samples);
+    BOOST_CHECK_EQUAL(0, breaker.getStatus(SOURCE, DEST, 1000).failureRatio);
+
+    // Cancellations are not an outcome of the link
+    for (int i = 0; i < 10; ++i) {
+        breaker.record(SOURCE, DEST, "CANCELED", ECANCELED, "Transfer canceled", 1000);
+    }
+    BOOST_CHECK_EQUAL(10, breaker.getStatus(SOURCE, DEST, 1000).samples);
+}
+
+
+BOOST_AUTO_TEST_CASE (openProbeClose)
+{
+    LinkCircuitBreaker breaker;
+    breaker.enable(testSettings());
+
+    breaker.record(SOURCE, DEST, "FINISHED", 0, "", 1000);
+    breaker.record(SOURCE, DEST, "FINISHED", 0, "", 1000);
+    failConnection(breaker, 8, 1000);
+
+    BOOST_CHECK(breaker.isOpen(SOURCE, DEST, 1000));
+    BOOST_CHECK(!breaker.allow(SOURCE, DEST, 1059));
+    BOOST_CHECK(!breaker.isOpen("mock://other", DEST, 1000));
+
+    LinkCircuitBreaker::Status status = breaker.getStatus(SOURCE, DEST, 1000);
+    BOOST_CHECK_EQUAL(LinkCircuitBreaker::OPEN, status.state);
+    BOOST_CHECK_EQUAL(1060, status.retryAt);
+    BOOST_CHECK_CLOSE(0.8, status.failureRatio, 0.001);
+
+    // Backoff expired, only two probes go through
+    BOOST_CHECK(!breaker.isOpen(SOURCE, DEST, 1060));
+    BOOST_CHECK(breaker.allow(SOURCE, DEST, 1060));
+    BOOST_CHECK(breaker.allow(SOURCE, DEST, 1060));
+    BOOST_CHECK(!breaker.allow(SOURCE, DEST, 1061));
+    BOOST_CHECK_EQUAL(LinkCircuitBreaker::HALF_OPEN, breaker.getStatus(SOURCE, DEST, 1061).state);
+
+    // Probes that never report back do not block the link forever
+    BOOST_CHECK(breaker.allow(SOURCE, DEST, 1120));
+
+    // A probe succeeds
+    breaker.record(SOURCE, DEST, "FINISHED", 0, "", 1125);
+    BOOST_CHECK_EQUAL(LinkCircuitBreaker::CLOSED, breaker.getStatus(SOURCE, DEST, 1125).state);
+    BOOST_CHECK_EQUAL(0, breaker.getStatus(SOURCE, DEST, 1125).samples);
+    BOOST_CHECK(breaker.allow(SOURCE, DEST, 1125));
+}
+
+
+/// Each failed probe doubles the pause, up to the maximum
+BOOST_AUTO_TEST_CASE (backoff)
+{
+    LinkCircuitBreaker breaker;
+    breaker.enable(testSettings());
+
+    failConnection(breaker, 10, 1000);
+    BOOST_CHECK_EQUAL(1060, breaker.getStatus(SOURCE, DEST, 1000).retryAt);
+
+    BOOST_CHECK(breaker.allow(SOURCE, DEST, 1060));
+    failConnection(breaker, 1, 1070);
+    BOOST_CHECK_EQUAL(1070 + 120, breaker.getStatus(SOURCE, DEST, 1070).retryAt);
+
+    BOOST_CHECK(breaker.allow(SOURCE, DEST, 1190));
+    failConnection(breaker, 1, 1200);
+    BOOST_CHECK_EQUAL(1200 + 200, breaker.getStatus(SOURCE, DEST, 1200).retryAt);
+
+    // Results of transfers started before opening are ignored
+    breaker.record(SOURCE, DEST, "FINISHED", 0, "", 1300);
+    BOOST_CHECK(breaker.isOpen(SOURCE, DEST, 1300));
+}
+
+
+
+/// Closed links idle for longer than the maximum backoff are forgotten, open ones are kept
+BOOST_AUTO_TEST_CASE (pruneIdle)
+{
+    LinkCircuitBreaker breaker;
+    breaker.enable(testSettings());
+
+    failConnection(breaker, 10, 1000);
+    for (int i = 0; i < 5; ++i) {
+        breaker.record(SOURCE, DEST + std::to_string(i), "FINISHED", 0, "", 1000);
+    }
+    breaker.record(SOURCE, "davs://busy.example.org", "FINISHED", 0, "", 1150);
+    BOOST_CHECK_EQUAL(7, breaker.size());
+
+    // Not idle long enough yet
+    breaker.record(SOURCE, "davs://busy.example.org", "FINISHED", 0, "", 1199);
+    BOOST_CHECK_EQUAL(7, breaker.size());
+
+    breaker.record(SOURCE, "davs://busy.example.org", "FINISHED", 0, "", 1200);
+    BOOST_CHECK_EQUAL(2, breaker.size());
+    BOOST_CHECK_EQUAL(LinkCircuitBreaker::HALF_OPEN, breaker.getStatus(SOURCE, DEST, 1200).state);
+    BOOST_CHECK_EQUAL(3, breaker.getStatus(SOURCE, "davs://busy.example.org", 1200).samples);
+    BOOST_CHECK_EQUAL(0, breaker.getStatus(SOURCE, DEST + "0", 1200).samples);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
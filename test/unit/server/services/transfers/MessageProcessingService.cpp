@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <set>
+
+#include "server/services/transfers/MessageProcessingService.h"
+
+using fts3::server::MessageProcessingService;
+
+
+static fts3::events::Message makeStatus(const std::string &jobId, uint64_t fileId, int pid,
+    const std::string &state)
+{
+    fts3::events::Message msg;
+    msg.set_job_id(jobId);
+    msg.set_file_id(fileId);
+    msg.set_process_id(pid);
+    msg.set_transfer_status(state);
+    return msg;
+}
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(MessageProcessingServiceTest)
+
+
+BOOST_AUTO_TEST_CASE (transferOrderKept)
+{
+    const size_t nShards = 4;
+    const char *states[] = {"READY", "ACTIVE", "FAILED"};
+
+    // Interleave the messages of several transfers, as the consumer would see them.
+    // The pid changes on each message, as with a retry run by another url-copy
+    std::vector<fts3::events::Message> consumed;
+    for (int state = 0; state < 3; ++state) {
+        for (uint64_t fileId = 1; fileId <= 20; ++fileId) {
+            std::string jobId = "job" + std::to_string(fileId % 7);
+            consumed.push_back(makeStatus(jobId, fileId, 1000 + state * 100 + fileId, states[state]));
+        }
+    }
+
+    std::vector<std::vector<fts3::events::Message>> shards(nShards);
+    for (auto msg = consumed.begin(); msg != consumed.end(); ++msg) {
+        size_t index = MessageProcessingService::getShardIndex(*msg, nShards);
+        BOOST_REQUIRE(index < nShards);
+        shards[index].push_back(*msg);
+    }
+
+    // Each transfer is in a single shard, with its messages in the order they were consumed
+    for (uint64_t fileId = 1; fileId <= 20; ++fileId) {
+        size_t found = 0;
+        for (auto shard = shards.begin(); shard != shards.end(); ++shard) {
+            std::vector<std::string> seen;
+            for (auto msg = shard->begin(); msg != shard->end(); ++msg) {
+                if (msg->file_id() == fileId) {
+                    seen.push_back(msg->transfer_status());
+                }
+            }
+            if (!seen.empty()) {
+                ++found;
+                BOOST_CHECK_EQUAL(seen.size(), 3);
+                BOOST_CHECK_EQUAL_COLLECTIONS(seen.begin(), seen.end(), states, states + 3);
+            }
+        }
+        BOOST_CHECK_EQUAL(found, 1);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE (pidOnlySpread)
+{
+    const size_t nShards = 4;
+
+    std::set<size_t> used;
+    for (int pid = 1000; pid < 1100; ++pid) {
+        fts3::events::Message msg = makeStatus("", 0, pid, "FAILED");
+        size_t index = MessageProcessingService::getShardIndex(msg, nShards);
+        BOOST_REQUIRE(index < nShards);
+        // The same url-copy always goes to the same shard
+        BOOST_CHECK_EQUAL(index, MessageProcessingService::getShardIndex(msg, nShards));
+        used.insert(index);
+    }
+
+    BOOST_CHECK_EQUAL(used.size(), nShards);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <stdexcept>
+
+#include "server/services/transfers/ProgressWriter.h"
+
+using fts3::server::ProgressWriter;
+using fts3::events::MessageUpdater;
+using namespace boost::posix_time;
+
+
+static MessageUpdater progress(uint64_t fileId, uint64_t timestamp, double throughput,
+    const std::string &state = "ACTIVE")
+{
+    MessageUpdater msg;
+    msg.set_job_id("5a8c3e9e-1b2c-11ee-b5f4-fa163e000001");
+    msg.set_file_id(fileId);
+    msg.set_timestamp(timestamp);
+    msg.set_transfer_status(state);
+    msg.set_throughput(throughput);
+    msg.set_transferred(timestamp * 1024);
+    return msg;
+}
+
+
+/// Remembers what would have been written
+struct SinkMock {
+    std::vector<std::vector<MessageUpdater>> batches;
+    bool fail;
+
+    SinkMock(): fail(false) {}
+
+    ProgressWriter::Sink sink() {
+        return [this](const std::vector<MessageUpdater> &messages) {
+            if (fail) {
+                throw std::runtime_error("Database unavailable");
+            }
+            batches.push_back(messages);
+        };
+    }
+};
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(ProgressWriterTest)
+
+
+/// Not configured, every batch is written right away
+BOOST_AUTO_TEST_CASE (unconfigured)
+{
+    SinkMock mock;
+    ProgressWriter writer(mock.sink());
+
+    writer.add({progress(1, 10, 5.0), progress(2, 10, 5.0)});
+    BOOST_CHECK_EQUAL(mock.batches.size(), 1);
+    BOOST_CHECK_EQUAL(mock.batches[0].size(), 2);
+    BOOST_CHECK_EQUAL(writer.pendingSize(), 0);
+}
+
+
+/// Only the newest progress of each active transfer is written
+BOOST_AUTO_TEST_CASE (coalesce)
+{
+    SinkMock mock;
+    ProgressWriter writer(mock.sink());
+    writer.configure(seconds(5), 0);
+
+    ptime start = microsec_clock::universal_time();
+    writer.add({progress(1, 10, 5.0), progress(2, 10, 5.0), progress(1, 12, 7.0)}, start);
+    writer.add({progress(1, 11, 6.0), progress(3, 10, 0.0), progress(4, 10, 5.0, "FINISHED")}, start + seconds(1));
+    writer.add({progress(0, 10, 5.0), progress(2, 13, 8.0)}, start + seconds(2));
+
+    writer.flushIfDue(start + seconds(4));
+    BOOST_CHECK(mock.batches.empty());
+    BOOST_CHECK_EQUAL(writer.pendingSize(), 2);
+
+    writer.flushIfDue(start + seconds(5));
+    BOOST_REQUIRE_EQUAL(mock.batches.size(), 1);
+    BOOST_REQUIRE_EQUAL(mock.batches[0].size(), 2);
+    BOOST_CHECK_EQUAL(mock.batches[0][0].file_id(), 1);
+    BOOST_CHECK_EQUAL(mock.batches[0][0].timestamp(), 12);
+    BOOST_CHECK_EQUAL(mock.batches[0][0].throughput(), 7.0);
+    BOOST_CHECK_EQUAL(mock.batches[0][1].file_id(), 2);
+    BOOST_CHECK_EQUAL(mock.batches[0][1].timestamp(), 13);
+
+    ProgressWriter::Metrics metrics = writer.getMetrics();
+    BOOST_CHECK_EQUAL(metrics.received, 5);
+    BOOST_CHECK_EQUAL(metrics.written, 2);
+    BOOST_CHECK_EQUAL(metrics.flushes, 1);
+
+    // Nothing pending, nothing written
+    writer.flushIfDue(start + seconds(20));
+    BOOST_CHECK_EQUAL(mock.batches.size(), 1);
+}
+
+
+/// Too many transfers pending are written before the interval
+BOOST_AUTO_TEST_CASE (sizeTrigger)
+{
+    SinkMock mock;
+    ProgressWriter writer(mock.sink());
+    writer.configure(seconds(60), 3);
+
+    ptime start = microsec_clock::universal_time();
+    writer.add({progress(1, 10, 5.0), progress(2, 10, 5.0)}, start);
+    writer.add({progress(2, 11, 5.0)}, start);
+    BOOST_CHECK(mock.batches.empty());
+
+    writer.add({progress(3, 10, 5.0)}, start);
+    BOOST_REQUIRE_EQUAL(mock.batches.size(), 1);
+    BOOST_CHECK_EQUAL(mock.batches[0].size(), 3);
+    BOOST_CHECK_EQUAL(writer.pendingSize(), 0);
+}
+
+
+/// The progress of a transfer that is done is not written anymore
+BOOST_AUTO_TEST_CASE (discard)
+{
+    SinkMock mock;
+    ProgressWriter writer(mock.sink());
+    writer.configure(seconds(5), 0);
+
+    ptime start = microsec_clock::universal_time();
+    writer.add({progress(1, 10, 5.0), progress(2, 10, 5.0)}, start);
+    writer.discard(1);
+    writer.discard(3);
+    BOOST_CHECK_EQUAL(writer.pendingSize(), 1);
+
+    writer.flushIfDue(start + seconds(5));
+    BOOST_REQUIRE_EQUAL(mock.batches.size(), 1);
+    BOOST_REQUIRE_EQUAL(mock.batches[0].size(), 1);
+    BOOST_CHECK_EQUAL(mock.batches[0][0].file_id(), 2);
+}
+
+
+/// What could not be written is kept, unless superseded
+BOOST_AUTO_TEST_CASE (sinkFailure)
+{
+    SinkMock mock;
+    ProgressWriter writer(mock.sink());
+    writer.configure(seconds(5), 0);
+
+    ptime start = microsec_clock::universal_time();
+    writer.add({progress(1, 10, 5.0), progress(2, 10, 5.0)}, start);
+
+    mock.fail = true;
+    BOOST_CHECK_THROW(writer.flush(start + seconds(5)), std::runtime_error);
+    BOOST_CHECK_EQUAL(writer.pendingSize(), 2);
+
+    writer.add({progress(1, 20, 9.0)}, start + seconds(6));
+    mock.fail = false;
+    writer.flush(start + seconds(7));
+
+    BOOST_REQUIRE_EQUAL(mock.batches.size(), 1);
+    BOOST_REQUIRE_EQUAL(mock.batches[0].size(), 2);
+    BOOST_CHECK_EQUAL(mock.batches[0][0].timestamp(), 20);
+    BOOST_CHECK_EQUAL(mock.batches[0][1].timestamp(), 10);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include "server/services/transfers/RecentLaunches.h"
+
+using fts3::server::RecentLaunches;
+
+
+static TransferFile makeFile(uint64_t fileId, const std::string &source, const std::string &destination)
+{
+    TransferFile tf;
+    tf.fileId = fileId;
+    tf.sourceSe = source;
+    tf.destSe = destination;
+    return tf;
+}
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(RecentLaunchesTest)
+
+
+/// A batch fetched before a launch finished skips its files, and counts its slots as used
+BOOST_AUTO_TEST_CASE (launchedMeanwhile)
+{
+    RecentLaunches recent;
+
+    RecentLaunches::Launched launched;
+    launched.add(makeFile(1, "mock://a", "mock://b"));
+    launched.add(makeFile(2, "mock://a", "mock://c"));
+    // Batches 1 to 3 were fetched when it finished
+    recent.record(std::move(launched), 3);
+
+    // Nothing started, nothing to remember
+    recent.record(RecentLaunches::Launched(), 3);
+    BOOST_CHECK_EQUAL(1, recent.size());
+
+    RecentLaunches::Launched other;
+    other.add(makeFile(3, "mock://d", "mock://b"));
+    recent.record(std::move(other), 5);
+
+    recent.expire(3);
+    BOOST_CHECK_EQUAL(2, recent.size());
+
+    std::map<std::string, int> slotsLeftForSource, slotsLeftForDestination;
+    slotsLeftForSource["mock://a"] = 10;
+    slotsLeftForDestination["mock://b"] = 10;
+    std::set<uint64_t> skipped = recent.apply(slotsLeftForSource, slotsLeftForDestination);
+
+    std::set<uint64_t> expected = {1, 2, 3};
+    BOOST_CHECK_EQUAL_COLLECTIONS(skipped.begin(), skipped.end(), expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL(8, slotsLeftForSource["mock://a"]);
+    BOOST_CHECK_EQUAL(-1, slotsLeftForSource["mock://d"]);
+    BOOST_CHECK_EQUAL(8, slotsLeftForDestination["mock://b"]);
+    BOOST_CHECK_EQUAL(-1, slotsLeftForDestination["mock://c"]);
+}
+
+
+/// A batch fetched after a launch finished already sees its files as active
+BOOST_AUTO_TEST_CASE (expired)
+{
+    RecentLaunches recent;
+
+    RecentLaunches::Launched first, second;
+    first.add(makeFile(1, "mock://a", "mock://b"));
+    second.add(makeFile(2, "mock://a", "mock://b"));
+    recent.record(std::move(first), 3);
+    recent.record(std::move(second), 4);
+
+    recent.expire(4);
+    BOOST_CHECK_EQUAL(1, recent.size());
+
+    std::map<std::string, int> slotsLeftForSource, slotsLeftForDestination;
+    std::set<uint64_t> skipped = recent.apply(slotsLeftForSource, slotsLeftForDestination);
+    BOOST_CHECK_EQUAL(1, skipped.size());
+    BOOST_CHECK_EQUAL(1, skipped.count(2));
+    BOOST_CHECK_EQUAL(-1, slotsLeftForSource["mock://a"]);
+
+    recent.expire(5);
+    BOOST_CHECK_EQUAL(0, recent.size());
+    BOOST_CHECK(recent.apply(slotsLeftForSource, slotsLeftForDestination).empty());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+
+#include "common/Exceptions.h"
+#include "common/Logger.h"
+#include "common/ThreadPool.h"
+#include "config/ServerConfig.h"
+#include "db/generic/SingleDbInstance.h"
+#include "server/services/transfers/ExecuteProcess.h"
+#include "server/services/transfers/FileTransferExecutor.h"
+#include "server/services/transfers/TransferFileHandler.h"
+#include "server/services/transfers/TransfersService.h"
+#include "server/services/transfers/VoShares.h"
+
+using namespace fts3::common;
+using namespace fts3::server;
+using fts3::config::ServerConfig;
+using db::DBSingleton;
+
+typedef std::chrono::steady_clock Clock;
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(SchedulerBenchmark)
+
+
+/// Jobs seeded for each run, can be changed with FTS3_SCHEDULER_BENCHMARK_JOBS
+static int benchmarkJobs()
+{
+    const char *env = getenv("FTS3_SCHEDULER_BENCHMARK_JOBS");
+    return env ? atoi(env) : 2000;
+}
+
+
+static std::string seedSpec()
+{
+    return "jobs=" + std::to_string(benchmarkJobs()) +
+        ";files=5;sources=10;destinations=10;vos=3;shares=1;maxActive=50";
+}
+
+
+/// Point the server configuration to the in-memory backend
+/// @return false if the plugin can not be loaded
+static bool setUp(const boost::filesystem::path &workDir)
+{
+    boost::filesystem::create_directories(workDir / "messages");
+    boost::filesystem::create_directories(workDir / "logs");
+
+    const std::string configPath = (workDir / "fts3config").string();
+    std::ofstream config(configPath);
+    config << "SiteName=benchmark" << std::endl
+        << "DbType=memory" << std::endl
+        << "MessagingDirectory=" << (workDir / "messages").string() << std::endl
+        << "TransferLogDirectory=" << (workDir / "logs").string() << std::endl
+        << "MonitoringMessaging=false" << std::endl
+        << "UseBulkScheduling=true" << std::endl
+        << "MaxUrlCopyProcesses=1000" << std::endl;
+    config.close();
+
+    const char *argv[] = {"fts_server", "-f", configPath.c_str()};
+    ServerConfig::instance().read(3, const_cast<char**>(argv));
+
+    try {
+        DBSingleton::instance();
+    }
+    catch (const BaseException &e) {
+        BOOST_TEST_MESSAGE("[scheduler] Skipped, the in-memory backend is not on the loader path: "
+            << e.what());
+        return false;
+    }
+    return true;
+}
+
+
+/// Does not spawn anything, only counts
+static std::atomic<uint64_t> launched(0);
+
+static int noopLauncher(const std::string&, const std::string&, int &pid, std::string&)
+{
+    pid = static_cast<int>(++launched);
+    return 0;
+}
+
+
+/// Accumulated time per phase of the scheduling cycle, in seconds
+struct Phases {
+    double queues, shares, ready, snapshot, executors;
+
+    Phases(): queues(0), shares(0), ready(0), snapshot(0), executors(0) {}
+};
+
+
+static double since(Clock::time_point &begin)
+{
+    Clock::time_point now = Clock::now();
+    double elapsed = std::chrono::duration<double>(now - begin).count();
+    begin = now;
+    return elapsed;
+}
+
+
+/// Same steps as TransfersService::fetchBatch and dispatchBatch, timed separately.
+/// Storage slots and proxies are left out, they do not touch the database
+/// @return false when there is nothing left to schedule
+static bool timedCycle(std::shared_ptr<Executor> executor, const std::string &workDir, Phases &phases)
+{
+    auto db = DBSingleton::instance().getDBObjectInstance();
+    Clock::time_point begin = Clock::now();
+
+    std::vector<QueueId> queues, unschedulable;
+    db->getQueuesWithPending(queues);
+    phases.queues += since(begin);
+
+    queues = applyVoShares(queues, unschedulable);
+    phases.shares += since(begin);
+    if (queues.empty()) {
+        return false;
+    }
+
+    std::map<std::string, std::list<TransferFile>> voQueues;
+    db->getReadyTransfersBulk(queues, voQueues);
+    phases.ready += since(begin);
+
+    std::shared_ptr<const ConfigSnapshot> snapshot = db->getConfigSnapshot(voQueues);
+    TransferFileHandler tfh(voQueues);
+    phases.snapshot += since(begin);
+
+    ThreadPool<FileTransferExecutor> execPool(executor);
+    while (!tfh.empty()) {
+        for (auto vo = tfh.begin(); vo != tfh.end(); ++vo) {
+            boost::optional<TransferFile> tf = tfh.get(*vo);
+            if (tf) {
+                execPool.start(new FileTransferExecutor(*tf, false, "", "localhost", "",
+                    workDir + "/logs", workDir + "/messages", snapshot));
+            }
+        }
+    }
+    execPool.join();
+    phases.executors += since(begin);
+    return true;
+}
+
+
+/// Exposes a full scheduling cycle
+class BenchmarkTransfersService: public TransfersService
+{
+public:
+    BenchmarkTransfersService(std::shared_ptr<Executor> executor): TransfersService(executor) {}
+
+    void cycle()
+    {
+        executeUrlcopy();
+    }
+};
+
+
+BOOST_AUTO_TEST_CASE (schedulingThroughput)
+{
+    const boost::filesystem::path workDir("/tmp/fts3tests-scheduler-benchmark");
+    const int maxCycles = 1000;
+
+    // The cycles log every transfer
+    theLogger().setLogLevel(Logger::ERR);
+
+    if (!setUp(workDir)) {
+        theLogger().setLogLevel(Logger::DEBUG);
+        return;
+    }
+
+    auto db = DBSingleton::instance().getDBObjectInstance();
+    std::shared_ptr<Executor> executor = std::make_shared<Executor>(
+        ServerConfig::instance().get<int>("InternalThreadPool"));
+    ExecuteProcess::setLauncher(noopLauncher);
+
+    // Phase by phase
+    db->init("", "", seedSpec(), 1);
+    Phases phases;
+    int cycles = 0;
+    launched = 0;
+    Clock::time_point begin = Clock::now();
+    while (cycles < maxCycles && timedCycle(executor, workDir.string(), phases)) {
+        ++cycles;
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+    const uint64_t phased = launched;
+
+    BOOST_CHECK_EQUAL(benchmarkJobs() * 5, phased);
+
+    BOOST_TEST_MESSAGE("[scheduler] " << phased << " files in " << cycles << " cycles: "
+        << phased / elapsed << " files/s");
+    BOOST_TEST_MESSAGE("[scheduler] per cycle: getQueuesWithPending " << 1000 * phases.queues / cycles << " ms"
+        << ", applyVoShares " << 1000 * phases.shares / cycles << " ms"
+        << ", getReadyTransfersBulk " << 1000 * phases.ready / cycles << " ms"
+        << ", getConfigSnapshot " << 1000 * phases.snapshot / cycles << " ms"
+        << ", executors " << 1000 * phases.executors / cycles << " ms");
+
+    // Through the service itself
+    db->init("", "", seedSpec(), 1);
+    BenchmarkTransfersService service(executor);
+    cycles = 0;
+    launched = 0;
+    begin = Clock::now();
+    std::vector<QueueId> queues;
+    do {
+        service.cycle();
+        queues.clear();
+        db->getQueuesWithPending(queues);
+    } while (++cycles < maxCycles && !queues.empty());
+    elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    BOOST_CHECK_EQUAL(benchmarkJobs() * 5, launched);
+    BOOST_TEST_MESSAGE("[scheduler] TransfersService: " << launched << " files in " << cycles << " cycles: "
+        << launched / elapsed << " files/s, " << 1000 * elapsed / cycles << " ms per cycle");
+
+    ExecuteProcess::setLauncher(ExecuteProcess::Launcher());
+    executor->join();
+    theLogger().setLogLevel(Logger::DEBUG);
+    boost::filesystem::remove_all(workDir);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
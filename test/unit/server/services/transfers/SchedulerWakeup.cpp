@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <boost/thread.hpp>
+
+#include "server/services/transfers/SchedulerWakeup.h"
+
+using fts3::server::SchedulerWakeup;
+using namespace boost::posix_time;
+
+
+static ptime now()
+{
+    return microsec_clock::universal_time();
+}
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(SchedulerWakeupTest)
+
+
+BOOST_AUTO_TEST_CASE (disabled)
+{
+    SchedulerWakeup wakeup;
+    std::set<SchedulerWakeup::Link> links;
+
+    wakeup.notify("mock://a", "mock://b");
+    BOOST_CHECK_EQUAL(SchedulerWakeup::DEADLINE, wakeup.waitUntil(now() + milliseconds(50), links));
+    BOOST_CHECK_EQUAL(0, wakeup.getMetrics().notifications);
+}
+
+
+/// Notifications that arrive together are handled in one wakeup
+BOOST_AUTO_TEST_CASE (coalesce)
+{
+    SchedulerWakeup wakeup;
+    wakeup.enable(milliseconds(0));
+
+    wakeup.notify("mock://a", "mock://b");
+    wakeup.notify("mock://a", "mock://b");
+    wakeup.notify("mock://a", "mock://c");
+
+    std::set<SchedulerWakeup::Link> links;
+    BOOST_CHECK_EQUAL(SchedulerWakeup::LINKS, wakeup.waitUntil(now() + seconds(10), links));
+    BOOST_CHECK_EQUAL(2, links.size());
+    BOOST_CHECK(links.count(SchedulerWakeup::Link("mock://a", "mock://c")));
+
+    SchedulerWakeup::Metrics metrics = wakeup.getMetrics();
+    BOOST_CHECK_EQUAL(3, metrics.notifications);
+    BOOST_CHECK_EQUAL(1, metrics.wakeups);
+
+    // Unknown links turn into a full cycle
+    wakeup.notify("mock://a", "mock://b");
+    wakeup.notifyAll();
+    BOOST_CHECK_EQUAL(SchedulerWakeup::ANY_LINK, wakeup.waitUntil(now() + seconds(10), links));
+}
+
+
+/// Bursts do not wake the scheduler up more often than the spacing
+BOOST_AUTO_TEST_CASE (spacing)
+{
+    SchedulerWakeup wakeup;
+    wakeup.enable(milliseconds(200));
+    std::set<SchedulerWakeup::Link> links;
+
+    wakeup.notify("mock://a", "mock://b");
+    BOOST_CHECK_EQUAL(SchedulerWakeup::LINKS, wakeup.waitUntil(now() + seconds(10), links));
+
+    ptime first = now();
+    wakeup.notify("mock://a", "mock://c");
+    BOOST_CHECK_EQUAL(SchedulerWakeup::LINKS, wakeup.waitUntil(now() + seconds(10), links));
+    BOOST_CHECK_GE((now() - first).total_milliseconds(), 190);
+
+    // The deadline comes first, the pending notifications are left to the full cycle
+    wakeup.notify("mock://a", "mock://d");
+    BOOST_CHECK_EQUAL(SchedulerWakeup::DEADLINE, wakeup.waitUntil(now() + milliseconds(50), links));
+    BOOST_CHECK_EQUAL(SchedulerWakeup::DEADLINE, wakeup.waitUntil(now() + milliseconds(300), links));
+}
+
+
+/// A waiting scheduler is woken up right away
+BOOST_AUTO_TEST_CASE (wakeupFromThread)
+{
+    SchedulerWakeup wakeup;
+    wakeup.enable(milliseconds(0));
+
+    boost::thread notifier([&wakeup]() {
+        boost::this_thread::sleep(milliseconds(50));
+        wakeup.notify("mock://a", "mock://b");
+    });
+
+    ptime start = now();
+    std::set<SchedulerWakeup::Link> links;
+    BOOST_CHECK_EQUAL(SchedulerWakeup::LINKS, wakeup.waitUntil(start + seconds(10), links));
+    BOOST_CHECK_LT((now() - start).total_milliseconds(), 5000);
+    BOOST_CHECK_EQUAL(1, links.size());
+
+    notifier.join();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <signal.h>
+#include <sys/resource.h>
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "common/Exceptions.h"
+#include "common/Logger.h"
+#include "server/services/transfers/ExecuteProcess.h"
+#include "server/services/transfers/SpawnHelper.h"
+
+using namespace fts3::common;
+using fts3::server::SpawnHelper;
+
+typedef std::chrono::steady_clock Clock;
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(SpawnBenchmark)
+
+
+/// Processes spawned by each path, can be changed with FTS3_SPAWN_BENCHMARK_COUNT
+static int spawnCount()
+{
+    const char *env = getenv("FTS3_SPAWN_BENCHMARK_COUNT");
+    return env ? atoi(env) : 200;
+}
+
+
+/// Memory touched by the "server" before spawning, can be changed with FTS3_SPAWN_BENCHMARK_MB
+static size_t ballastMb()
+{
+    const char *env = getenv("FTS3_SPAWN_BENCHMARK_MB");
+    return env ? atoi(env) : 256;
+}
+
+
+/// @return spawns per second, or 0 if any failed
+static double spawnRate(int count)
+{
+    const std::vector<std::string> args = {"--transfer-id", "benchmark", "--source", "mock://a/file"};
+
+    Clock::time_point begin = Clock::now();
+    for (int i = 0; i < count; ++i) {
+        ExecuteProcess process("true", args);
+        std::string forkMessage;
+        if (process.executeProcessShell(forkMessage) != 0) {
+            BOOST_ERROR("Failed to spawn: " << forkMessage);
+            return 0;
+        }
+    }
+    return count / std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+
+BOOST_AUTO_TEST_CASE (spawnThroughput)
+{
+    const int count = spawnCount();
+    struct rlimit nofile;
+    getrlimit(RLIMIT_NOFILE, &nofile);
+
+    theLogger().setLogLevel(Logger::WARNING);
+
+    // The helper is forked while this process is still small
+    SpawnHelper::instance().start();
+    BOOST_REQUIRE(SpawnHelper::instance().isRunning());
+
+    std::vector<char> ballast(ballastMb() * 1024 * 1024);
+    memset(ballast.data(), 1, ballast.size());
+
+    double helperRate = spawnRate(count);
+
+    // Back to forking this process
+    SpawnHelper::instance().stop();
+    BOOST_REQUIRE(!SpawnHelper::instance().isRunning());
+    double forkRate = spawnRate(count);
+
+    BOOST_TEST_MESSAGE("[spawn] " << count << " processes, " << ballastMb() << " MB resident, "
+        << nofile.rlim_cur << " descriptors limit");
+    BOOST_TEST_MESSAGE("[spawn] fork path: " << forkRate << " spawns/s");
+    BOOST_TEST_MESSAGE("[spawn] spawn helper: " << helperRate << " spawns/s");
+
+    BOOST_CHECK_GT(helperRate, 0);
+    BOOST_CHECK_GT(forkRate, 0);
+
+    theLogger().setLogLevel(Logger::DEBUG);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
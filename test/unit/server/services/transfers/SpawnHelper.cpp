@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <signal.h>
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include "common/Exceptions.h"
+#include "server/services/transfers/SpawnHelper.h"
+
+using fts3::common::SystemError;
+using fts3::server::SpawnHelper;
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(SpawnHelperTest)
+
+
+/// A binary that does not exist is reported, and the helper keeps serving
+BOOST_AUTO_TEST_CASE (spawnFailure)
+{
+    SpawnHelper::instance().start();
+
+    pid_t pid = 0;
+    BOOST_CHECK_EQUAL(ENOENT, SpawnHelper::instance().spawn("/fake/path/really/unlikely", {}, pid));
+    BOOST_CHECK_EQUAL(0, SpawnHelper::instance().spawn("true", {"a", "b"}, pid));
+    BOOST_CHECK_GT(pid, 0);
+
+    const pid_t helper = SpawnHelper::instance().getPid();
+    SpawnHelper::instance().stop();
+    BOOST_CHECK_NE(0, kill(helper, 0));
+    BOOST_CHECK_THROW(SpawnHelper::instance().spawn("true", {}, pid), SystemError);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
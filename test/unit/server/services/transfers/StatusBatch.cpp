@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include "db/memory/InMemoryAPI.h"
+#include "server/services/transfers/StatusBatch.h"
+
+using fts3::server::StatusBatch;
+
+
+static fts3::events::Message makeMessage(const std::string &jobId, uint64_t fileId,
+    const std::string &status, int pid, bool retry)
+{
+    fts3::events::Message msg;
+    msg.set_job_id(jobId);
+    msg.set_file_id(fileId);
+    msg.set_transfer_status(status);
+    msg.set_process_id(pid);
+    msg.set_retry(retry);
+    return msg;
+}
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(StatusBatchTest)
+
+
+BOOST_AUTO_TEST_CASE (ActiveThenRetry)
+{
+    InMemoryAPI db;
+
+    Job job;
+    job.voName = "dteam";
+    std::list<TransferFile> files(2);
+    for (auto i = files.begin(); i != files.end(); ++i) {
+        i->sourceSe = "mock://a";
+        i->destSe = "mock://b";
+    }
+    std::string jobId = db.addJob(job, files);
+    std::string otherId = db.addJob(job, std::list<TransferFile>(1, files.front()));
+
+    std::vector<TransferState> states = db.getStateOfTransfer(jobId, 0);
+    BOOST_REQUIRE_EQUAL(2, states.size());
+    uint64_t fileId = states[0].file_id;
+    uint64_t siblingId = states[1].file_id;
+    uint64_t otherFileId = db.getStateOfTransfer(otherId, 0).at(0).file_id;
+
+    std::vector<size_t> flushes;
+    StatusBatch batch(
+        [&db, &flushes](std::vector<fts3::events::Message> &pending) {
+            flushes.push_back(pending.size());
+            db.updateTransferStatusBatch(pending);
+        },
+        // Same as the retry path of the message processing: the file is reset right away
+        [&db](const fts3::events::Message &msg) {
+            if (msg.transfer_status() == "FAILED" && msg.retry()) {
+                int retry = db.getRetryTimes(msg.job_id(), msg.file_id()) + 1;
+                db.setRetryTransfer(msg.job_id(), msg.file_id(), retry, "retry", "", 0);
+                return false;
+            }
+            return true;
+        });
+
+    // The other job is not affected by the failure, so it stays in the batch
+    batch.add(makeMessage(otherId, otherFileId, "ACTIVE", 41, false));
+    batch.add(makeMessage(jobId, fileId, "ACTIVE", 42, false));
+    batch.add(makeMessage(jobId, siblingId, "ACTIVE", 43, false));
+    BOOST_CHECK_EQUAL(3, batch.size());
+
+    batch.add(makeMessage(jobId, fileId, "FAILED", 42, true));
+    BOOST_REQUIRE_EQUAL(1, flushes.size());
+    BOOST_CHECK_EQUAL(3, flushes[0]);
+    BOOST_CHECK_EQUAL(0, batch.size());
+
+    batch.add(makeMessage(otherId, otherFileId, "FINISHED", 41, false));
+    batch.flush();
+    BOOST_CHECK_EQUAL(2, flushes.size());
+
+    // The retry is not undone by the ACTIVE that came before it
+    states = db.getStateOfTransfer(jobId, fileId);
+    BOOST_REQUIRE_EQUAL(1, states.size());
+    BOOST_CHECK_EQUAL("SUBMITTED", states[0].file_state);
+    BOOST_CHECK_EQUAL(1, db.getRetryTimes(jobId, fileId));
+
+    BOOST_CHECK_EQUAL("ACTIVE", db.getStateOfTransfer(jobId, siblingId).at(0).file_state);
+    BOOST_CHECK_EQUAL("FINISHED", db.getStateOfTransfer(otherId, otherFileId).at(0).file_state);
+}
+
+
+BOOST_AUTO_TEST_CASE (NoFlushForOtherJobs)
+{
+    std::vector<size_t> flushes;
+    StatusBatch batch(
+        [&flushes](std::vector<fts3::events::Message> &pending) {
+            flushes.push_back(pending.size());
+        },
+        [](const fts3::events::Message &msg) {
+            return !(msg.transfer_status() == "FAILED" && msg.retry());
+        });
+
+    batch.add(makeMessage("a", 1, "ACTIVE", 1, false));
+    batch.add(makeMessage("b", 2, "FAILED", 2, true));
+    batch.add(makeMessage("b", 3, "FAILED", 3, false));
+    BOOST_CHECK(flushes.empty());
+    BOOST_CHECK_EQUAL(2, batch.size());
+
+    // Without job id, the change may hit any job
+    batch.add(makeMessage("", 0, "FAILED", 4, false));
+    BOOST_REQUIRE_EQUAL(1, flushes.size());
+    BOOST_CHECK_EQUAL(2, flushes[0]);
+
+    batch.flush();
+    BOOST_CHECK_EQUAL(2, flushes.size());
+    BOOST_CHECK_EQUAL(1, flushes[1]);
+
+    // Nothing left, nothing applied
+    batch.flush();
+    BOOST_CHECK_EQUAL(2, flushes.size());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
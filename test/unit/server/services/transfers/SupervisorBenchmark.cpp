@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include "common/Exceptions.h"
+#include "common/Logger.h"
+#include "common/Uri.h"
+#include "config/ServerConfig.h"
+#include "db/generic/SingleDbInstance.h"
+#include "server/services/transfers/ProgressWriter.h"
+#include "server/services/transfers/SupervisorService.h"
+#include "server/services/transfers/ThreadSafeList.h"
+
+using namespace fts3::common;
+using namespace fts3::server;
+using fts3::config::ServerConfig;
+using db::DBSingleton;
+
+typedef std::chrono::steady_clock Clock;
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(SupervisorBenchmark)
+
+
+/// Active transfers, each sending one ping, can be changed with FTS3_SUPERVISOR_BENCHMARK_TRANSFERS
+static int benchmarkTransfers()
+{
+    const char *env = getenv("FTS3_SUPERVISOR_BENCHMARK_TRANSFERS");
+    return env ? atoi(env) : 20000;
+}
+
+
+/// Point the server configuration to the in-memory backend
+/// @return false if the plugin can not be loaded
+static bool setUp(const boost::filesystem::path &workDir)
+{
+    boost::filesystem::remove_all(workDir);
+    boost::filesystem::create_directories(workDir / "messages");
+
+    const std::string configPath = (workDir / "fts3config").string();
+    std::ofstream config(configPath);
+    config << "SiteName=benchmark" << std::endl
+        << "DbType=memory" << std::endl
+        << "MessagingDirectory=" << (workDir / "messages").string() << std::endl
+        << "MonitoringMessaging=false" << std::endl;
+    config.close();
+
+    const char *argv[] = {"fts_server", "-f", configPath.c_str()};
+    ServerConfig::instance().read(3, const_cast<char**>(argv));
+
+    try {
+        DBSingleton::instance();
+    }
+    catch (const BaseException &e) {
+        BOOST_TEST_MESSAGE("[supervisor] Skipped, the in-memory backend is not on the loader path: "
+            << e.what());
+        return false;
+    }
+    return true;
+}
+
+
+/// Pids that do not exist, so the watch list entries are found but never refreshed
+static const int FIRST_PID = 5000000;
+
+
+static fts3::events::MessageUpdater ping(int i, bool withSeNames)
+{
+    fts3::events::MessageUpdater msg;
+    msg.set_timestamp(1500000000000 + i);
+    msg.set_job_id("1906cc40-b915-11e5-9a03-02163e" + std::to_string(100000 + i / 10));
+    msg.set_file_id(i + 1);
+    msg.set_transfer_status("ACTIVE");
+    msg.set_source_surl("gsiftp://source-" + std::to_string(i % 50) + ".cern.ch/data/path/file." + std::to_string(i));
+    msg.set_dest_surl("davs://destination-" + std::to_string(i % 70) + ".example.org/path/file." + std::to_string(i));
+    msg.set_source_turl("gsiftp:://fake");
+    msg.set_dest_turl("gsiftp:://fake");
+    msg.set_process_id(FIRST_PID + i);
+    msg.set_throughput(1024.0);
+    msg.set_transferred(1048576);
+    msg.set_instantaneous_throughput(1024.0);
+    msg.set_gfal_perf_timestamp(1500000000000);
+    msg.set_transferred_since_last_ping(1024);
+    if (withSeNames) {
+        msg.set_source_se(Uri::parse(msg.source_surl()).getSeName());
+        msg.set_dest_se(Uri::parse(msg.dest_surl()).getSeName());
+    }
+    return msg;
+}
+
+
+/// Register the transfers in the watch list, as the executors do
+static void fillWatchList(int nTransfers)
+{
+    ThreadSafeList::get_instance().clear();
+    for (int i = 0; i < nTransfers; ++i) {
+        fts3::events::MessageUpdater msg = ping(i, false);
+        ThreadSafeList::get_instance().push_back(msg);
+    }
+}
+
+
+/// How the pings were handled before: urls parsed for every ping, one row written per ping
+static void legacyHandlePings(std::vector<fts3::events::MessageUpdater> &events)
+{
+    for (auto event = events.begin(); event != events.end(); ++event) {
+        FTS3_COMMON_LOGGER_NEWLOG(INFO) << "Process Updater Monitor"
+                                        << "\nJob id: " << event->job_id()
+                                        << "\nFile id: " << event->file_id()
+                                        << "\nPid: " << event->process_id()
+                                        << "\nTimestamp: " << event->timestamp()
+                                        << "\nThroughput: " << event->throughput()
+                                        << "\nTransferred: " << event->transferred()
+                                        << commit;
+
+        FTS3_COMMON_LOGGER_NEWLOG(PROF) << "[profiling:transfer]"
+                                        << " file_id=" << event->file_id()
+                                        << " timestamp=" << event->gfal_perf_timestamp() / 1000
+                                        << " inst_throughput=" << event->instantaneous_throughput()
+                                        << " dif_transferred=" << event->transferred_since_last_ping()
+                                        << " source_se=" << Uri::parse(event->source_surl()).getSeName()
+                                        << " dest_se=" << Uri::parse(event->dest_surl()).getSeName()
+                                        << commit;
+    }
+    ThreadSafeList::get_instance().updateMsg(events);
+    DBSingleton::instance().getDBObjectInstance()->updateFileTransferProgressVector(events);
+}
+
+
+/// Handling only, in batches as received from the socket.
+/// The progress queued by handlePings is flushed within the timing, as the legacy path writes it too
+BOOST_AUTO_TEST_CASE (pingHandling)
+{
+    const boost::filesystem::path workDir("/tmp/fts3tests-supervisor-benchmark");
+    const int nTransfers = benchmarkTransfers();
+
+    // Every ping logs a line otherwise
+    theLogger().setLogLevel(Logger::ERR);
+    if (!setUp(workDir)) {
+        theLogger().setLogLevel(Logger::DEBUG);
+        return;
+    }
+    fillWatchList(nTransfers);
+
+    std::vector<std::vector<fts3::events::MessageUpdater>> legacyBatches, batches;
+    for (int first = 0; first < nTransfers; first += SupervisorService::MAX_PINGS_PER_BATCH) {
+        legacyBatches.emplace_back();
+        batches.emplace_back();
+        for (int i = first; i < nTransfers && i < first + static_cast<int>(SupervisorService::MAX_PINGS_PER_BATCH); ++i) {
+            legacyBatches.back().push_back(ping(i, false));
+            batches.back().push_back(ping(i, true));
+        }
+    }
+
+    Clock::time_point begin = Clock::now();
+    for (auto batch = legacyBatches.begin(); batch != legacyBatches.end(); ++batch) {
+        legacyHandlePings(*batch);
+    }
+    double legacy = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    SupervisorService service;
+    begin = Clock::now();
+    for (auto batch = batches.begin(); batch != batches.end(); ++batch) {
+        service.handlePings(*batch);
+    }
+    ProgressWriter::instance().flush();
+    double current = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    BOOST_CHECK_EQUAL(ProgressWriter::instance().pendingSize(), 0);
+    BOOST_TEST_MESSAGE("[supervisor] " << nTransfers << " pings handled: legacy "
+        << nTransfers / legacy << " pings/s, current " << nTransfers / current << " pings/s");
+
+    ThreadSafeList::get_instance().clear();
+    boost::filesystem::remove_all(workDir);
+    theLogger().setLogLevel(Logger::DEBUG);
+}
+
+
+/// From url-copy to the watch list, through the ping socket
+BOOST_AUTO_TEST_CASE (pingThroughput)
+{
+    const boost::filesystem::path workDir("/tmp/fts3tests-supervisor-benchmark");
+    const int nTransfers = benchmarkTransfers();
+
+    theLogger().setLogLevel(Logger::ERR);
+    if (!setUp(workDir)) {
+        theLogger().setLogLevel(Logger::DEBUG);
+        return;
+    }
+    fillWatchList(nTransfers);
+
+    SupervisorService service;
+
+    // Same socket options as url-copy, except nothing is dropped
+    zmq::context_t context(1);
+    zmq::socket_t publisher(context, ZMQ_PUB);
+    int hwm = 0;
+    publisher.setsockopt(ZMQ_SNDHWM, &hwm, sizeof(hwm));
+    publisher.connect(("ipc://" + (workDir / "messages" / "url_copy-ping.ipc").string()).c_str());
+    // Let the subscription reach the publisher
+    boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+
+    std::vector<std::string> serialized;
+    for (int i = 0; i < nTransfers; ++i) {
+        serialized.push_back(ping(i, true).SerializeAsString());
+    }
+
+    Clock::time_point begin = Clock::now();
+    boost::thread sender([&publisher, &serialized]() {
+        for (auto payload = serialized.begin(); payload != serialized.end(); ++payload) {
+            zmq::message_t message(payload->size());
+            memcpy(message.data(), payload->data(), payload->size());
+            publisher.send(message, 0);
+        }
+    });
+
+    int received = 0;
+    std::vector<fts3::events::MessageUpdater> pings;
+    Clock::time_point deadline = begin + std::chrono::seconds(30);
+    while (received < nTransfers && Clock::now() < deadline) {
+        received += service.receivePings(pings, 100);
+        if (!pings.empty()) {
+            service.handlePings(pings);
+            pings.clear();
+        }
+    }
+    ProgressWriter::instance().flush();
+    double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+    sender.join();
+
+    BOOST_CHECK_GT(received, 0);
+    BOOST_TEST_MESSAGE("[supervisor] " << received << " of " << nTransfers << " pings received and handled: "
+        << received / elapsed << " pings/s");
+
+    ThreadSafeList::get_instance().clear();
+    boost::filesystem::remove_all(workDir);
+    theLogger().setLogLevel(Logger::DEBUG);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
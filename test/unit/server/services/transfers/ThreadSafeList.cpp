@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <unistd.h>
+
+#include "server/services/transfers/ThreadSafeList.h"
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(ThreadSafeListTestSuite)
+
+
+static uint64_t nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
+static fts3::events::MessageUpdater makeUpdater(const std::string &jobId, uint64_t fileId, int pid, uint64_t timestamp)
+{
+    fts3::events::MessageUpdater msg;
+    msg.set_job_id(jobId);
+    msg.set_file_id(fileId);
+    msg.set_process_id(pid);
+    msg.set_timestamp(timestamp);
+    return msg;
+}
+
+
+struct WatchListFixture {
+    ThreadSafeList list;
+};
+
+
+BOOST_FIXTURE_TEST_CASE (pingRefreshesByPid, WatchListFixture)
+{
+    const uint64_t old = nowMs() - 3600 * 1000;
+    auto msg = makeUpdater("job-a", 1, getpid(), old);
+    list.push_back(msg);
+    msg = makeUpdater("job-b", 2, getpid() + 1, old);
+    list.push_back(msg);
+
+    std::vector<fts3::events::MessageUpdater> expired;
+    list.checkExpiredMsg(expired, boost::posix_time::seconds(60));
+    BOOST_CHECK_EQUAL(2, expired.size());
+
+    // Only the transfer run by this process is refreshed
+    auto ping = makeUpdater("job-a", 1, getpid(), nowMs());
+    list.updateMsg(ping);
+
+    expired.clear();
+    list.checkExpiredMsg(expired, boost::posix_time::seconds(60));
+    BOOST_REQUIRE_EQUAL(1, expired.size());
+    BOOST_CHECK_EQUAL("job-b", expired[0].job_id());
+}
+
+
+BOOST_FIXTURE_TEST_CASE (pingOlderThanProcess, WatchListFixture)
+{
+    auto msg = makeUpdater("job-a", 1, getpid(), 1000);
+    list.push_back(msg);
+
+    // A message older than the process start time is not accepted
+    auto ping = makeUpdater("job-a", 1, getpid(), 2000);
+    list.updateMsg(ping);
+
+    std::vector<fts3::events::MessageUpdater> expired;
+    list.checkExpiredMsg(expired, boost::posix_time::seconds(60));
+    BOOST_REQUIRE_EQUAL(1, expired.size());
+    BOOST_CHECK_EQUAL(1000, expired[0].timestamp());
+}
+
+
+BOOST_FIXTURE_TEST_CASE (replaceAndRemove, WatchListFixture)
+{
+    const uint64_t old = nowMs() - 3600 * 1000;
+    auto msg = makeUpdater("job-a", 1, getpid(), old);
+    list.push_back(msg);
+    list.push_back(msg);
+    msg = makeUpdater("job-a", 2, getpid(), old);
+    list.push_back(msg);
+    msg = makeUpdater("job-b", 1, getpid(), old);
+    list.push_back(msg);
+    BOOST_CHECK_EQUAL(3, list.size());
+
+    list.removeFinishedTr("job-a", 2);
+    BOOST_CHECK_EQUAL(2, list.size());
+
+    std::vector<fts3::events::MessageUpdater> toDelete;
+    toDelete.push_back(makeUpdater("job-b", 1, 0, 0));
+    toDelete.push_back(makeUpdater("job-c", 1, 0, 0));
+    list.deleteMsg(toDelete);
+    BOOST_CHECK_EQUAL(1, list.size());
+
+    std::vector<fts3::events::MessageUpdater> expired;
+    list.checkExpiredMsg(expired, boost::posix_time::seconds(60));
+    BOOST_REQUIRE_EQUAL(1, expired.size());
+    BOOST_CHECK_EQUAL("job-a", expired[0].job_id());
+    BOOST_CHECK_EQUAL(1, expired[0].file_id());
+}
+
+
+/// Pings, registration/removal and the stall check running concurrently, as
+/// the supervisor, the message processing and the canceler threads do
+BOOST_FIXTURE_TEST_CASE (concurrentAccess, WatchListFixture)
+{
+    const unsigned nTransfers = 1000;
+
+    const uint64_t start = nowMs();
+    for (unsigned i = 0; i < nTransfers; ++i) {
+        auto msg = makeUpdater("job-" + std::to_string(i % 100), i, getpid(), start);
+        list.push_back(msg);
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> unexpected(0);
+
+    boost::thread pinger([&]() {
+        std::vector<fts3::events::MessageUpdater> batch;
+        for (unsigned i = 0; i < 5000; ++i) {
+            batch.push_back(makeUpdater("", 0, getpid(), nowMs()));
+            if (batch.size() == 50) {
+                list.updateMsg(batch);
+                batch.clear();
+            }
+        }
+    });
+
+    boost::thread registerer([&]() {
+        for (unsigned next = nTransfers; !done; ++next) {
+            auto msg = makeUpdater("job-new", next, getpid(), nowMs());
+            list.push_back(msg);
+            list.removeFinishedTr("job-new", next);
+        }
+    });
+
+    boost::thread checker([&]() {
+        while (!done) {
+            std::vector<fts3::events::MessageUpdater> expired;
+            list.checkExpiredMsg(expired, boost::posix_time::seconds(60));
+            unexpected += expired.size();
+        }
+    });
+
+    pinger.join();
+    done = true;
+    registerer.join();
+    checker.join();
+
+    BOOST_CHECK_EQUAL(0, unexpected);
+    BOOST_CHECK_EQUAL(nTransfers, list.size());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
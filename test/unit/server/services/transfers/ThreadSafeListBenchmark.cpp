@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "server/services/transfers/ThreadSafeList.h"
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(ThreadSafeListBenchmark)
+
+
+static uint64_t nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
+static fts3::events::MessageUpdater makeUpdater(const std::string &jobId, uint64_t fileId, int pid, uint64_t timestamp)
+{
+    fts3::events::MessageUpdater msg;
+    msg.set_job_id(jobId);
+    msg.set_file_id(fileId);
+    msg.set_process_id(pid);
+    msg.set_timestamp(timestamp);
+    return msg;
+}
+
+
+/// Number of watched transfers, can be changed with FTS3_WATCHLIST_BENCHMARK_TRANSFERS
+static unsigned benchmarkSize()
+{
+    const char *env = getenv("FTS3_WATCHLIST_BENCHMARK_TRANSFERS");
+    return env ? static_cast<unsigned>(atoi(env)) : 20000;
+}
+
+
+/// Pingers, registration/removal and the stall check running concurrently, as
+/// the supervisor, the message processing and the canceler threads do
+BOOST_AUTO_TEST_CASE (concurrency)
+{
+    ThreadSafeList list;
+    const unsigned nTransfers = benchmarkSize();
+    const unsigned nProcesses = std::min(nTransfers, 256u);
+    const unsigned nPingers = 4;
+    const unsigned pingsPerThread = 100000;
+
+    // Pings are only accepted from live processes
+    std::vector<pid_t> children;
+    for (unsigned i = 0; i < nProcesses; ++i) {
+        pid_t pid = fork();
+        BOOST_REQUIRE(pid >= 0);
+        if (pid == 0) {
+            pause();
+            _exit(0);
+        }
+        children.push_back(pid);
+    }
+
+    const uint64_t start = nowMs();
+    for (unsigned i = 0; i < nTransfers; ++i) {
+        auto msg = makeUpdater("job-" + std::to_string(i % 1000), i, children[i % nProcesses], start);
+        list.push_back(msg);
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> churn(0), checks(0), unexpected(0);
+
+    auto begin = std::chrono::steady_clock::now();
+
+    std::vector<boost::thread*> pingers;
+    for (unsigned t = 0; t < nPingers; ++t) {
+        pingers.push_back(new boost::thread([&, t]() {
+            std::vector<fts3::events::MessageUpdater> batch;
+            for (unsigned i = 0; i < pingsPerThread; ++i) {
+                unsigned transfer = (i * nPingers + t) % nTransfers;
+                batch.push_back(makeUpdater("", 0, children[transfer % nProcesses], nowMs()));
+                if (batch.size() == 50) {
+                    list.updateMsg(batch);
+                    batch.clear();
+                }
+            }
+            list.updateMsg(batch);
+        }));
+    }
+
+    boost::thread registerer([&]() {
+        unsigned next = nTransfers;
+        while (!done) {
+            auto msg = makeUpdater("job-new", next, children[next % nProcesses], nowMs());
+            list.push_back(msg);
+            list.removeFinishedTr("job-new", next);
+            ++next;
+            ++churn;
+        }
+    });
+
+    boost::thread checker([&]() {
+        while (!done) {
+            std::vector<fts3::events::MessageUpdater> expired;
+            list.checkExpiredMsg(expired, boost::posix_time::seconds(60));
+            unexpected += expired.size();
+            ++checks;
+        }
+    });
+
+    for (auto i = pingers.begin(); i != pingers.end(); ++i) {
+        (*i)->join();
+        delete *i;
+    }
+    auto end = std::chrono::steady_clock::now();
+    done = true;
+    registerer.join();
+    checker.join();
+
+    for (auto i = children.begin(); i != children.end(); ++i) {
+        kill(*i, SIGKILL);
+        waitpid(*i, NULL, 0);
+    }
+
+    BOOST_CHECK_EQUAL(0, unexpected);
+    BOOST_CHECK_EQUAL(nTransfers, list.size());
+
+    double elapsed = std::chrono::duration<double>(end - begin).count();
+    BOOST_TEST_MESSAGE("[watch list] " << nTransfers << " transfers, " << nPingers << " pingers: "
+        << (nPingers * pingsPerThread) / elapsed << " pings/s, "
+        << churn / elapsed << " register+remove/s, "
+        << checks / elapsed << " stall checks/s");
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
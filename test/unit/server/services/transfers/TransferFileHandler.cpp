@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include "server/services/transfers/TransferFileHandler.h"
+
+using fts3::server::TransferFileHandler;
+
+
+static TransferFile makeFile(uint64_t fileId, const std::string &vo, const std::string &jobId, int fileIndex,
+    const std::string &source, const std::string &destination)
+{
+    TransferFile tf;
+    tf.fileId = fileId;
+    tf.voName = vo;
+    tf.jobId = jobId;
+    tf.fileIndex = fileIndex;
+    tf.sourceSe = source;
+    tf.destSe = destination;
+    return tf;
+}
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(TransferFileHandlerTest)
+
+
+/// One file per link in turn for each VO, and a single replica per file index
+BOOST_AUTO_TEST_CASE (roundRobin)
+{
+    std::map<std::string, std::list<TransferFile>> input;
+    input["atlas"].push_back(makeFile(1, "atlas", "job1", 0, "mock://a", "mock://b"));
+    input["atlas"].push_back(makeFile(2, "atlas", "job1", 1, "mock://a", "mock://b"));
+    input["atlas"].push_back(makeFile(3, "atlas", "job2", 0, "mock://a", "mock://c"));
+    input["atlas"].push_back(makeFile(5, "atlas", "job1", 0, "mock://d", "mock://b"));
+    input["cms"].push_back(makeFile(4, "cms", "job3", 0, "mock://a", "mock://b"));
+
+    TransferFileHandler handler(input);
+    BOOST_CHECK_EQUAL(handler.size(), 4);
+    BOOST_CHECK(input["atlas"].empty());
+    BOOST_CHECK(input["cms"].empty());
+
+    std::vector<uint64_t> order;
+    while (!handler.empty()) {
+        for (auto vo = handler.begin(); vo != handler.end(); ++vo) {
+            boost::optional<TransferFile> tf = handler.get(*vo);
+            if (tf) {
+                order.push_back(tf->fileId);
+            }
+        }
+    }
+
+    std::vector<uint64_t> expected = {1, 4, 3, 2};
+    BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL(handler.size(), 0);
+    BOOST_CHECK(!handler.get("atlas"));
+}
+
+
+BOOST_AUTO_TEST_CASE (unknownVo)
+{
+    std::map<std::string, std::list<TransferFile>> input;
+    input["atlas"].push_back(makeFile(1, "atlas", "job1", 0, "mock://a", "mock://b"));
+    TransferFileHandler handler(input);
+
+    BOOST_CHECK(!handler.get("unknown"));
+    BOOST_CHECK_EQUAL(handler.size(), 1);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <boost/thread/mutex.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <set>
+
+#include "server/services/transfers/TransferFileHandler.h"
+
+using fts3::server::TransferFileHandler;
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_AUTO_TEST_SUITE(TransferFileHandlerBenchmark)
+
+
+/// The handler as it was before using flat storage: nested maps keyed by strings,
+/// and files copied out under a lock
+class LegacyTransferFileHandler
+{
+    typedef std::pair<std::string, int> FileIndex;
+    typedef std::pair<std::string, std::string> Link;
+    typedef std::map<Link, std::list<FileIndex>> LinkQueues;
+
+public:
+    LegacyTransferFileHandler(std::map<std::string, std::list<TransferFile>> &files)
+    {
+        std::map<std::string, std::set<FileIndex>> unique;
+        for (auto vo = files.begin(); vo != files.end(); ++vo) {
+            vos.insert(vo->first);
+            for (auto tf = vo->second.begin(); tf != vo->second.end(); ++tf) {
+                FileIndex index(tf->jobId, tf->fileIndex);
+                fileIndexToFiles[index].push_back(*tf);
+                if (unique[vo->first].insert(index).second) {
+                    voToFileIndexes[vo->first][Link(tf->sourceSe, tf->destSe)].push_back(index);
+                }
+            }
+            nextPairForVo[vo->first] = voToFileIndexes[vo->first].begin();
+        }
+    }
+
+    boost::optional<TransferFile> get(std::string vo)
+    {
+        boost::mutex::scoped_lock lock(m);
+
+        auto it = voToFileIndexes.find(vo);
+        if (it == voToFileIndexes.end() || it->second.empty()) {
+            return boost::optional<TransferFile>();
+        }
+        if (nextPairForVo[vo] == it->second.end()) {
+            nextPairForVo[vo] = it->second.begin();
+        }
+        Link link = (nextPairForVo[vo]++)->first;
+
+        FileIndex index = it->second[link].front();
+        it->second[link].pop_front();
+        if (it->second[link].empty()) {
+            it->second.erase(link);
+            if (it->second.empty()) {
+                voToFileIndexes.erase(it);
+            }
+        }
+
+        boost::optional<TransferFile> ret = fileIndexToFiles[index].front();
+        fileIndexToFiles[index].pop_front();
+        return ret;
+    }
+
+    std::set<std::string>::iterator begin() { return vos.begin(); }
+    std::set<std::string>::iterator end() { return vos.end(); }
+    bool empty() { return voToFileIndexes.empty(); }
+
+private:
+    std::map<FileIndex, std::list<TransferFile>> fileIndexToFiles;
+    std::map<std::string, LinkQueues> voToFileIndexes;
+    std::map<std::string, LinkQueues::iterator> nextPairForVo;
+    std::set<std::string> vos;
+    boost::mutex m;
+};
+
+
+/// Number of queued files, can be changed with FTS3_TFH_BENCHMARK_FILES
+static int benchmarkFiles()
+{
+    const char *env = getenv("FTS3_TFH_BENCHMARK_FILES");
+    return env ? atoi(env) : 100000;
+}
+
+
+/// Files spread over links and VOs as getReadyTransfers returns them,
+/// with a few multi-replica jobs
+static std::map<std::string, std::list<TransferFile>> generateFiles(int nFiles, int nLinks, int nVos)
+{
+    std::map<std::string, std::list<TransferFile>> voQueues;
+    for (int i = 0; i < nFiles; ++i) {
+        TransferFile tf;
+        int link = (i * 7919) % nLinks;
+        tf.fileId = i + 1;
+        tf.voName = "vo" + std::to_string((i / 10) % nVos);
+        tf.jobId = "5a8c3e9e-1b2c-11ee-b5f4-fa163e" + std::to_string(100000 + i / 10);
+        tf.fileIndex = (i % 50 == 0 && i > 0) ? (i - 1) % 10 : i % 10;
+        tf.sourceSe = "gsiftp://source-" + std::to_string(link / 100) + ".cern.ch";
+        tf.destSe = "davs://destination-" + std::to_string(link % 100) + ".example.org";
+        tf.sourceSurl = tf.sourceSe + "/data/path/to/some/dataset/file." + std::to_string(i);
+        tf.destSurl = tf.destSe + "/storage/path/to/some/dataset/file." + std::to_string(i);
+        tf.userDn = "/DC=ch/DC=cern/OU=Organic Units/OU=Users/CN=user";
+        tf.credId = "0123456789abcdef";
+        tf.activity = "default";
+        tf.internalFileParams = "nostreams:1,timeout:3600,buffersize:0,strict";
+        tf.checksum = "adler32:12345678";
+        voQueues[tf.voName].push_back(tf);
+    }
+    return voQueues;
+}
+
+
+/// Drains the handler as TransfersService::dispatchBatch does
+template <typename HANDLER>
+static std::vector<uint64_t> drain(HANDLER &handler)
+{
+    std::vector<uint64_t> fileIds;
+    while (!handler.empty()) {
+        for (auto vo = handler.begin(); vo != handler.end(); ++vo) {
+            boost::optional<TransferFile> tf = handler.get(*vo);
+            if (tf) {
+                fileIds.push_back(tf->fileId);
+            }
+        }
+    }
+    return fileIds;
+}
+
+
+BOOST_AUTO_TEST_CASE (roundRobin)
+{
+    const int nFiles = benchmarkFiles();
+    const int nLinks = 5000;
+
+    std::map<std::string, std::list<TransferFile>> legacyInput = generateFiles(nFiles, nLinks, 5);
+    std::map<std::string, std::list<TransferFile>> input = legacyInput;
+
+    auto begin = std::chrono::steady_clock::now();
+    LegacyTransferFileHandler legacyHandler(legacyInput);
+    std::vector<uint64_t> legacyOrder = drain(legacyHandler);
+    double legacy = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    begin = std::chrono::steady_clock::now();
+    TransferFileHandler handler(input);
+    const int queued = handler.size();
+    std::vector<uint64_t> order = drain(handler);
+    double flat = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    // Same files, in the same order, replicas included
+    BOOST_CHECK_EQUAL(queued, static_cast<int>(order.size()));
+    BOOST_CHECK_LT(queued, nFiles);
+    BOOST_CHECK_EQUAL(handler.size(), 0);
+    BOOST_CHECK_EQUAL_COLLECTIONS(legacyOrder.begin(), legacyOrder.end(), order.begin(), order.end());
+
+    BOOST_TEST_MESSAGE("[transfer file handler] " << nFiles << " files over " << nLinks << " links: legacy "
+        << legacy << " ms, flat " << flat << " ms");
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
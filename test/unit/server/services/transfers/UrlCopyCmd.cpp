@@ -16,6 +16,8 @@
 
 #include <boost/test/unit_test_suite.hpp>
 #include <boost/test/test_tools.hpp>
+#include <boost/algorithm/string/join.hpp>
+#include <algorithm>
 
 #include "server/services/transfers/UrlCopyCmd.h"
 
@@ -49,5 +51,77 @@ BOOST_AUTO_TEST_CASE (TestIpFlags)
     BOOST_CHECK_EQUAL(params.find("ipv6"), std::string::npos);
 }
 
+/**
+ * Test the argument vector matches the parameter string
+ */
+BOOST_AUTO_TEST_CASE (TestArguments)
+{
+    UrlCopyCmd cmd;
+    cmd.setIPv6(true);
+    cmd.setLogDir("/var/log/fts3");
+    cmd.setDebugLevel(2);
+
+    std::vector<std::string> args = cmd.getArguments();
+    std::vector<std::string> expected = {"--ipv6", "--debug", "2", "--logDir", "/var/log/fts3"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(args.begin(), args.end(), expected.begin(), expected.end());
+
+    BOOST_CHECK_EQUAL(cmd.generateParameters(), " " + boost::algorithm::join(args, " "));
+}
+
+
+BOOST_AUTO_TEST_CASE (TestWorkerKey)
+{
+    UrlCopyCmd first, second;
+    first.setProxy("/tmp/x509up_h1");
+    first.setNumberOfRetries(0);
+    second.setProxy("/tmp/x509up_h1");
+    second.setNumberOfRetries(2);
+
+    // Different transfers, same credentials
+    BOOST_CHECK(!first.getWorkerKey().empty());
+    BOOST_CHECK_EQUAL(first.getWorkerKey(), second.getWorkerKey());
+
+    // Different credentials
+    second.setProxy("/tmp/x509up_h2");
+    BOOST_CHECK_NE(first.getWorkerKey(), second.getWorkerKey());
+
+    // Tokens are loaded into the gfal2 context, so the process is not reused
+    second.setProxy("/tmp/x509up_h1");
+    second.setOAuthFile("/tmp/oauth");
+    BOOST_CHECK(second.getWorkerKey().empty());
+
+    first.setWorker("/var/lib/fts3/url-copy-workers.sock", first.getWorkerKey(), 100, 512, 30);
+    std::vector<std::string> args = first.getArguments();
+    BOOST_CHECK(std::find(args.begin(), args.end(), "--worker-socket") != args.end());
+}
+
+
+BOOST_AUTO_TEST_CASE (TestBulkFile)
+{
+    TransferFile tf;
+    tf.jobId = "1b2c3d4e-0000-11ee-b5f4-fa163e000001";
+    tf.fileId = 42;
+    tf.sourceSurl = "davs://source.cern.ch/path/file";
+    tf.destSurl = "davs://destination.example.org/path/file";
+    tf.userFilesize = 1024;
+    tf.scitag = 65;
+
+    // Empty fields are marked with an x
+    BOOST_CHECK_EQUAL(UrlCopyCmd::getBulkFileLine(tf),
+        "42 davs://source.cern.ch/path/file davs://destination.example.org/path/file x 1024 x x x 65");
+
+    // The per file options are left to the bulk file
+    UrlCopyCmd cmd;
+    cmd.setFromTransfer(tf, true, false, "/var/lib/fts3");
+    cmd.setBulkFile("/var/lib/fts3/bundle-42");
+
+    std::vector<std::string> args = cmd.getArguments();
+    auto bulkFile = std::find(args.begin(), args.end(), "--bulk-file");
+    BOOST_REQUIRE(bulkFile != args.end());
+    BOOST_CHECK_EQUAL(*(bulkFile + 1), "/var/lib/fts3/bundle-42");
+    BOOST_CHECK(std::find(args.begin(), args.end(), "--file-id") == args.end());
+    BOOST_CHECK(cmd.getWorkerKey().empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
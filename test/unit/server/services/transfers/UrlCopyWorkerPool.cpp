@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) CERN 2024
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include "common/Logger.h"
+#include "server/services/transfers/UrlCopyWorkerPool.h"
+
+using namespace fts3::common;
+using fts3::server::UrlCopyWorkerPool;
+
+
+/// Stands for an idle fts_url_copy: announces itself, and keeps what it receives
+class FakeWorker {
+public:
+    int fd;
+    std::vector<std::string> args;
+
+    FakeWorker(const std::string &path, const std::string &key): fd(-1)
+    {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+        fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+        BOOST_REQUIRE(connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0);
+        BOOST_REQUIRE(send(fd, key.data(), key.size(), 0) == static_cast<ssize_t>(key.size()));
+    }
+
+    ~FakeWorker()
+    {
+        disconnect();
+    }
+
+    /// Wait for a transfer, and take it
+    bool take()
+    {
+        std::vector<char> buffer(4096);
+        ssize_t size = recv(fd, buffer.data(), buffer.size(), 0);
+        if (size <= 0) {
+            return false;
+        }
+        for (const char *arg = buffer.data(); arg < buffer.data() + size; arg += strlen(arg) + 1) {
+            args.push_back(arg);
+        }
+        const char ack = 1;
+        return send(fd, &ack, 1, 0) == 1;
+    }
+
+    void disconnect()
+    {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+};
+
+
+/// The workers are accepted in the background
+static void waitForIdle(UrlCopyWorkerPool &pool, size_t expected)
+{
+    for (int i = 0; i < 500 && pool.idleCount() != expected; ++i) {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    }
+    BOOST_REQUIRE_EQUAL(pool.idleCount(), expected);
+}
+
+
+struct PoolFixture {
+    UrlCopyWorkerPool pool;
+    std::string path;
+
+    PoolFixture()
+    {
+        char tmp[] = "/tmp/fts-worker-pool-XXXXXX";
+        BOOST_REQUIRE(mkdtemp(tmp) != NULL);
+        path = std::string(tmp) + "/workers.sock";
+        pool.start(path);
+    }
+
+    ~PoolFixture()
+    {
+        pool.stop();
+        rmdir(path.substr(0, path.rfind('/')).c_str());
+    }
+};
+
+
+BOOST_AUTO_TEST_SUITE(server)
+BOOST_FIXTURE_TEST_SUITE(UrlCopyWorkerPoolTest, PoolFixture)
+
+
+BOOST_AUTO_TEST_CASE (noWorkers)
+{
+    pid_t pid = 0;
+    BOOST_CHECK(pool.isRunning());
+    BOOST_CHECK_EQUAL(pool.getSocketPath(), path);
+    BOOST_CHECK(!pool.dispatch("vo=dteam;", 0, {"--job-id", "a"}, pid));
+}
+
+
+BOOST_AUTO_TEST_CASE (dispatchByKey)
+{
+    FakeWorker worker(path, "vo=dteam;");
+    waitForIdle(pool, 1);
+
+    pid_t pid = 0;
+    BOOST_CHECK(!pool.dispatch("vo=atlas;", 0, {"--job-id", "a"}, pid));
+
+    bool taken = false;
+    boost::thread taker([&worker, &taken]() { taken = worker.take(); });
+    BOOST_CHECK(pool.dispatch("vo=dteam;", 1, {"--job-id", "b", "--file-id", "1"}, pid));
+    taker.join();
+
+    BOOST_CHECK(taken);
+    BOOST_CHECK_EQUAL(pid, getpid());
+    BOOST_CHECK_EQUAL(pool.idleCount(), 0);
+
+    std::vector<std::string> expected = {"--job-id", "b", "--file-id", "1"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(worker.args.begin(), worker.args.end(), expected.begin(), expected.end());
+}
+
+
+/// A worker keeps its pid, so a signal for a file it no longer runs must not reach it
+BOOST_AUTO_TEST_CASE (tracksTransfer)
+{
+    // Not a worker of the pool: runs the transfer it was started with
+    BOOST_CHECK(pool.runsTransfer(getpid(), 1));
+
+    FakeWorker worker(path, "vo=dteam;");
+    waitForIdle(pool, 1);
+    BOOST_CHECK(!pool.runsTransfer(getpid(), 1));
+
+    pid_t pid = 0;
+    boost::thread taker([&worker]() { worker.take(); });
+    BOOST_CHECK(pool.dispatch("vo=dteam;", 2, {"--job-id", "b", "--file-id", "2"}, pid));
+    taker.join();
+
+    BOOST_CHECK(pool.runsTransfer(pid, 2));
+    BOOST_CHECK(!pool.runsTransfer(pid, 1));
+
+    // The pid is given to a new process
+    pool.forget(pid);
+    BOOST_CHECK(pool.runsTransfer(pid, 1));
+}
+
+/// Workers that reach their idle timeout are not handed transfers
+BOOST_AUTO_TEST_CASE (workerGone)
+{
+    FakeWorker gone(path, "vo=dteam;");
+    waitForIdle(pool, 1);
+    gone.disconnect();
+
+    pid_t pid = 0;
+    BOOST_CHECK(!pool.dispatch("vo=dteam;", 0, {"--job-id", "c"}, pid));
+    BOOST_CHECK_EQUAL(pool.idleCount(), 0);
+
+    // Or are forgotten in the background
+    FakeWorker expired(path, "vo=dteam;");
+    waitForIdle(pool, 1);
+    expired.disconnect();
+    waitForIdle(pool, 0);
+}
+
+
+/// Idle workers see the connection closed when the pool stops
+BOOST_AUTO_TEST_CASE (stopDisconnects)
+{
+    FakeWorker worker(path, "vo=dteam;");
+    waitForIdle(pool, 1);
+
+    pool.stop();
+    BOOST_CHECK(!pool.isRunning());
+    BOOST_CHECK(!worker.take());
+    BOOST_CHECK_NE(0, access(path.c_str(), F_OK));
+}
+
+
+/// Connections from another user are closed, and never handed transfers
+BOOST_AUTO_TEST_CASE (otherUserRejected)
+{
+    if (getuid() != 0) {
+        BOOST_TEST_MESSAGE("Skipped, connecting as another user needs to run as root");
+        return;
+    }
+
+    chmod(path.substr(0, path.rfind('/')).c_str(), 0755);
+    chmod(path.c_str(), 0777);
+
+    pid_t child = fork();
+    BOOST_REQUIRE(child >= 0);
+    if (child == 0) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+        int fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+        if (setuid(65534) != 0 || connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+            _exit(2);
+        }
+        // The pool may have closed the connection already
+        send(fd, "vo=dteam;", 9, MSG_NOSIGNAL);
+        char buffer[64];
+        _exit(recv(fd, buffer, sizeof(buffer), 0) > 0 ? 1 : 0);
+    }
+
+    int status = 0;
+    BOOST_REQUIRE_EQUAL(child, waitpid(child, &status, 0));
+    BOOST_CHECK(WIFEXITED(status));
+    BOOST_CHECK_EQUAL(0, WEXITSTATUS(status));
+    BOOST_CHECK_EQUAL(pool.idleCount(), 0);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
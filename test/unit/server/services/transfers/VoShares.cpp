@@ -17,6 +17,10 @@
 #include <boost/test/unit_test_suite.hpp>
 #include <boost/test/test_tools.hpp>
 
+#include <algorithm>
+#include <cmath>
+
+#include "common/Logger.h"
 #include "server/services/transfers/VoShares.h"
 
 using namespace fts3::server;
@@ -178,5 +182,142 @@ BOOST_AUTO_TEST_CASE (TestShareRespected)
     BOOST_CHECK_GT(count["cms"], count["dteam"]);
 }
 
+/**
+ * The picks follow the weights within less than two picks, and not only in the long run:
+ * every window of ten picks is close to the configured split
+ */
+BOOST_AUTO_TEST_CASE (TestStrideConverges)
+{
+    const unsigned NRuns = 1000;
+
+    std::vector<std::pair<std::string, unsigned>> vos{{"dteam", 0}, {"cms", 0}, {"atlas", 0}};
+    std::map<std::string, double> weights;
+    weights["atlas"] = 60;
+    weights["cms"]   = 30;
+    weights["dteam"] = 10;
+
+    VoShareScheduler scheduler;
+    std::vector<std::string> picks;
+    std::map<std::string, int> count;
+
+    for (unsigned i = 0; i < NRuns; ++i) {
+        std::vector<QueueId> unschedulable;
+        boost::optional<QueueId> scheduled = scheduler.select(pair, vos, weights, unschedulable);
+        BOOST_REQUIRE(scheduled);
+        picks.push_back(scheduled->voName);
+        count[scheduled->voName]++;
+
+        // Never two picks or more away from the share
+        for (auto w = weights.begin(); w != weights.end(); ++w) {
+            double expected = (i + 1) * w->second / 100.0;
+            BOOST_CHECK_LT(std::abs(count[w->first] - expected), 2.0);
+        }
+    }
+
+    BOOST_CHECK_EQUAL(600, count["atlas"]);
+    BOOST_CHECK_EQUAL(300, count["cms"]);
+    BOOST_CHECK_EQUAL(100, count["dteam"]);
+
+    for (size_t begin = 0; begin + 10 <= picks.size(); ++begin) {
+        int atlas = std::count(picks.begin() + begin, picks.begin() + begin + 10, "atlas");
+        BOOST_CHECK(atlas >= 5 && atlas <= 7);
+    }
+}
+
+/**
+ * The same sequence comes out of the same state
+ */
+BOOST_AUTO_TEST_CASE (TestStrideDeterministic)
+{
+    std::vector<std::pair<std::string, unsigned>> vos{{"atlas", 0}, {"cms", 0}, {"lhcb", 0}};
+    std::vector<std::pair<std::string, unsigned>> shuffled{{"lhcb", 0}, {"atlas", 0}, {"cms", 0}};
+    std::map<std::string, double> weights;
+
+    VoShareScheduler first, second;
+    for (int i = 0; i < 30; ++i) {
+        std::vector<QueueId> unschedulable;
+        boost::optional<QueueId> a = first.select(pair, vos, weights, unschedulable);
+        boost::optional<QueueId> b = second.select(pair, shuffled, weights, unschedulable);
+        BOOST_REQUIRE(a && b);
+        BOOST_CHECK_EQUAL(a->voName, b->voName);
+    }
+}
+
+/**
+ * A VO that was not waiting does not get to catch up when it comes back
+ */
+BOOST_AUTO_TEST_CASE (TestStrideNoIdleCredit)
+{
+    std::vector<std::pair<std::string, unsigned>> both{{"atlas", 0}, {"cms", 0}};
+    std::vector<std::pair<std::string, unsigned>> atlasOnly{{"atlas", 0}};
+    std::map<std::string, double> weights;
+    weights["atlas"] = 50;
+    weights["cms"]   = 50;
+
+    VoShareScheduler scheduler;
+    std::vector<QueueId> unschedulable;
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK_EQUAL("atlas", scheduler.select(pair, atlasOnly, weights, unschedulable)->voName);
+    }
+
+    std::map<std::string, int> count;
+    for (int i = 0; i < 10; ++i) {
+        count[scheduler.select(pair, both, weights, unschedulable)->voName]++;
+    }
+    BOOST_CHECK_EQUAL(5, count["atlas"]);
+    BOOST_CHECK_EQUAL(5, count["cms"]);
+    BOOST_CHECK(unschedulable.empty());
+}
+
+/**
+ * Scheduling cycles over many links, with the shares loaded once.
+ * Each VO gets its share of the picks on every link
+ */
+BOOST_AUTO_TEST_CASE (TestSharesSimulation)
+{
+    const int NLinks = 500;
+    const int NCycles = 100;
+
+    std::map<std::pair<std::string, std::string>, std::vector<ShareConfig>> shares;
+    std::vector<QueueId> queues;
+    for (int l = 0; l < NLinks; ++l) {
+        std::string source = "mock://source" + std::to_string(l % 25);
+        std::string destination = "mock://destination" + std::to_string(l / 25);
+
+        const char *vos[] = {"atlas", "cms", "dteam"};
+        const int weight[] = {70, 20, 10};
+        for (int v = 0; v < 3; ++v) {
+            ShareConfig share;
+            share.source = source;
+            share.destination = destination;
+            share.vo = vos[v];
+            share.weight = weight[v];
+            shares[std::make_pair(source, destination)].push_back(share);
+            queues.emplace_back(source, destination, vos[v], 0);
+        }
+    }
+
+    // Every pick is logged
+    fts3::common::Logger &logger = fts3::common::theLogger();
+    const fts3::common::Logger::LogLevel logLevel = logger.getCurrentLogLevel();
+    logger.setLogLevel(fts3::common::Logger::ERR);
+
+    std::map<std::string, int> count;
+    for (int c = 0; c < NCycles; ++c) {
+        std::vector<QueueId> unschedulable;
+        std::vector<QueueId> result = applyVoShares(queues, shares, unschedulable);
+        BOOST_CHECK_EQUAL(NLinks, result.size());
+        BOOST_CHECK(unschedulable.empty());
+        for (auto i = result.begin(); i != result.end(); ++i) {
+            count[i->voName]++;
+        }
+    }
+    logger.setLogLevel(logLevel);
+
+    BOOST_CHECK_EQUAL(NLinks * 70, count["atlas"]);
+    BOOST_CHECK_EQUAL(NLinks * 20, count["cms"]);
+    BOOST_CHECK_EQUAL(NLinks * 10, count["dteam"]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()